@@ -0,0 +1,117 @@
+## @file
+# Compare the compression ratio and time of the BaseTools compressors.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+CompressBenchmark
+'''
+from __future__ import print_function
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+#
+# Globals for help information
+#
+__prog__        = 'CompressBenchmark'
+__copyright__   = 'Copyright (c) 2026, Intel Corporation. All rights reserved.'
+__description__ = 'Compress files with the BaseTools compressors and report ratio and time.\n'
+
+#
+# The configurations to compare: name, tool, encode options, decode options
+#
+Configurations = [
+    ('LZMA',            'LzmaCompress',   ['-e', '-q', '--threads', '1'], ['-d', '-q']),
+    ('LZMA MT',         'LzmaCompress',   ['-e', '-q', '--threads', '2'], ['-d', '-q']),
+    ('LZMA F86',        'LzmaCompress',   ['-e', '-q', '--f86', '--threads', '1'], ['-d', '-q', '--f86']),
+    ('LZMA F86 MT',     'LzmaCompress',   ['-e', '-q', '--f86', '--threads', '2'], ['-d', '-q', '--f86']),
+    ('Brotli',          'BrotliCompress', ['-e'], ['-d']),
+    ('Tiano',           'TianoCompress',  ['-e', '-q'], ['-d', '-q']),
+]
+
+def FindTool (Name, ToolPath):
+    if ToolPath:
+        Path = os.path.join (ToolPath, Name)
+        if os.path.isfile (Path) or os.path.isfile (Path + '.exe'):
+            return Path
+        return None
+    return shutil.which (Name)
+
+def RunTool (Command):
+    Start = time.perf_counter ()
+    Result = subprocess.run (Command, stdout = subprocess.DEVNULL, stderr = subprocess.PIPE)
+    Elapsed = time.perf_counter () - Start
+    if Result.returncode != 0:
+        raise RuntimeError ('{Command} failed: {Error}'.format (Command = ' '.join (Command), Error = Result.stderr.decode (errors = 'replace').strip ()))
+    return Elapsed
+
+def Benchmark (Tool, EncodeOptions, DecodeOptions, InputFile, TempDir, Repeat):
+    Compressed = os.path.join (TempDir, 'compressed')
+    Decompressed = os.path.join (TempDir, 'decompressed')
+    EncodeTime = min (RunTool ([Tool] + EncodeOptions + ['-o', Compressed, InputFile]) for Index in range (Repeat))
+    DecodeTime = min (RunTool ([Tool] + DecodeOptions + ['-o', Decompressed, Compressed]) for Index in range (Repeat))
+    with open (InputFile, 'rb') as File:
+        Original = File.read ()
+    with open (Decompressed, 'rb') as File:
+        if File.read () != Original:
+            raise RuntimeError ('{Tool}: decompressed data does not match {File}'.format (Tool = Tool, File = InputFile))
+    return os.path.getsize (Compressed), EncodeTime, DecodeTime
+
+if __name__ == '__main__':
+    #
+    # Create command line argument parser object
+    #
+    parser = argparse.ArgumentParser (prog = __prog__,
+                                      description = __description__ + __copyright__,
+                                      conflict_handler = 'resolve')
+    parser.add_argument ("InputFileList", nargs = '+',
+                         help = "Files to compress, for example FV images.")
+    parser.add_argument ("-p", "--tool-path", dest = 'ToolPath',
+                         help = "Directory of the compression tools. Default: search PATH.")
+    parser.add_argument ("-r", "--repeat", dest = 'Repeat', type = int, default = 1,
+                         help = "Run each tool REPEAT times and report the fastest run. Default: 1.")
+    parser.add_argument ("-c", "--config", dest = 'ConfigList', action = 'append',
+                         choices = [Config[0] for Config in Configurations],
+                         help = "Benchmark only the given configuration. Can be given more than once.")
+
+    #
+    # Parse command line arguments
+    #
+    args = parser.parse_args ()
+
+    print ('{File:<32} {Config:<14} {Size:>12} {Ratio:>7} {Encode:>10} {Decode:>10}'.format (
+             File = 'File', Config = 'Config', Size = 'Size', Ratio = 'Ratio', Encode = 'Encode(s)', Decode = 'Decode(s)'))
+    Status = 0
+    TempDir = tempfile.mkdtemp (prefix = 'CompressBenchmark')
+    try:
+        for InputFile in args.InputFileList:
+            InputSize = os.path.getsize (InputFile)
+            if InputSize == 0:
+                print ('{File}: skipped, the file is empty'.format (File = InputFile), file = sys.stderr)
+                continue
+            for Name, ToolName, EncodeOptions, DecodeOptions in Configurations:
+                if args.ConfigList and Name not in args.ConfigList:
+                    continue
+                Tool = FindTool (ToolName, args.ToolPath)
+                if Tool is None:
+                    continue
+                try:
+                    Size, EncodeTime, DecodeTime = Benchmark (Tool, EncodeOptions, DecodeOptions, InputFile, TempDir, max (args.Repeat, 1))
+                except RuntimeError as Error:
+                    print (Error, file = sys.stderr)
+                    Status = 1
+                    continue
+                print ('{File:<32} {Config:<14} {Size:>12} {Ratio:>6.2f}% {Encode:>10.3f} {Decode:>10.3f}'.format (
+                         File = os.path.basename (InputFile)[-32:], Config = Name, Size = Size,
+                         Ratio = Size * 100.0 / InputSize, Encode = EncodeTime, Decode = DecodeTime))
+    finally:
+        shutil.rmtree (TempDir, ignore_errors = True)
+    sys.exit (Status)
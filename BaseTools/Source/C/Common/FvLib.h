@@ -62,6 +62,17 @@ GetSectionByType (
   OUT EFI_FILE_SECTION_POINTER    *Section
   )
 ;
+
+EFI_STATUS
+SearchSectionByType (
+  IN EFI_FILE_SECTION_POINTER     FirstSection,
+  IN UINT8                        *SearchEnd,
+  IN EFI_SECTION_TYPE             SectionType,
+  IN OUT UINTN                    *StartIndex,
+  IN UINTN                        Instance,
+  OUT EFI_FILE_SECTION_POINTER    *Section
+  )
+;
 //
 // will not parse compressed sections
 //
@@ -6,11 +6,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
+#ifndef __GNUC__
+#define RUNTIME_FUNCTION  _WINNT_DUP_RUNTIME_FUNCTION
+#include <windows.h>
+#undef RUNTIME_FUNCTION
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include <assert.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include "CommonLib.h"
+#include "EfiUtilityMsgs.h"
 #include "MemoryFile.h"
 
 
@@ -201,6 +212,250 @@ ReadMemoryFileLine (
   return OutputString;
 }
 
+/**
+  Maps a file into memory for reading. The mapping is private, changes
+  made to the image are not written back to the file.
+
+  @param FileName           Name of the file to map.
+  @param MappedFile         The mapped file.
+
+  @retval EFI_SUCCESS            The file is mapped.
+  @retval EFI_ABORTED            The file can't be opened or read.
+  @retval EFI_OUT_OF_RESOURCES   No memory to hold the file image.
+**/
+EFI_STATUS
+MapFileForRead (
+  IN  CHAR8        *FileName,
+  OUT MAPPED_FILE  *MappedFile
+  )
+{
+  FILE  *InputFile;
+
+  memset (MappedFile, 0, sizeof (*MappedFile));
+  MappedFile->FileName = FileName;
+
+#ifndef __GNUC__
+  {
+    HANDLE         FileHandle;
+    HANDLE         MappingHandle;
+    LARGE_INTEGER  FileSize;
+
+    FileHandle = CreateFileA (LongFilePath (FileName), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (FileHandle == INVALID_HANDLE_VALUE) {
+      Error (NULL, 0, 0001, "Error opening file", FileName);
+      return EFI_ABORTED;
+    }
+    if (GetFileSizeEx (FileHandle, &FileSize) && FileSize.QuadPart != 0) {
+      MappingHandle = CreateFileMappingA (FileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+      if (MappingHandle != NULL) {
+        MappedFile->FileImage = MapViewOfFile (MappingHandle, FILE_MAP_COPY, 0, 0, 0);
+        if (MappedFile->FileImage != NULL) {
+          MappedFile->FileSize      = (UINTN) FileSize.QuadPart;
+          MappedFile->Mapped        = TRUE;
+          MappedFile->FileHandle    = FileHandle;
+          MappedFile->MappingHandle = MappingHandle;
+          return EFI_SUCCESS;
+        }
+        CloseHandle (MappingHandle);
+      }
+    }
+    CloseHandle (FileHandle);
+  }
+#else
+  {
+    int          Fd;
+    struct stat  Stat;
+    VOID         *Image;
+
+    Fd = open (LongFilePath (FileName), O_RDONLY);
+    if (Fd < 0) {
+      Error (NULL, 0, 0001, "Error opening file", FileName);
+      return EFI_ABORTED;
+    }
+    if (fstat (Fd, &Stat) == 0 && Stat.st_size != 0) {
+      Image = mmap (NULL, (size_t) Stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, Fd, 0);
+      if (Image != MAP_FAILED) {
+        close (Fd);
+        MappedFile->FileImage = Image;
+        MappedFile->FileSize  = (UINTN) Stat.st_size;
+        MappedFile->Mapped    = TRUE;
+        return EFI_SUCCESS;
+      }
+    }
+    close (Fd);
+  }
+#endif
+
+  //
+  // The file can't be mapped, read it into a buffer instead.
+  //
+  InputFile = fopen (LongFilePath (FileName), "rb");
+  if (InputFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", FileName);
+    return EFI_ABORTED;
+  }
+  MappedFile->FileSize  = _filelength (fileno (InputFile));
+  MappedFile->FileImage = malloc (MappedFile->FileSize + 1);
+  if (MappedFile->FileImage == NULL) {
+    fclose (InputFile);
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (fread (MappedFile->FileImage, 1, MappedFile->FileSize, InputFile) != MappedFile->FileSize) {
+    fclose (InputFile);
+    free (MappedFile->FileImage);
+    MappedFile->FileImage = NULL;
+    Error (NULL, 0, 0004, "Error reading file", FileName);
+    return EFI_ABORTED;
+  }
+  fclose (InputFile);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Creates a file of the given size and maps it into memory for writing.
+  The content of the image is undefined until it is written.
+
+  @param FileName           Name of the file to create.
+  @param FileSize           Size of the file.
+  @param MappedFile         The mapped file.
+
+  @retval EFI_SUCCESS            The file is mapped.
+  @retval EFI_ABORTED            The file can't be created.
+  @retval EFI_OUT_OF_RESOURCES   No memory to hold the file image.
+**/
+EFI_STATUS
+MapFileForWrite (
+  IN  CHAR8        *FileName,
+  IN  UINTN        FileSize,
+  OUT MAPPED_FILE  *MappedFile
+  )
+{
+  memset (MappedFile, 0, sizeof (*MappedFile));
+  MappedFile->FileName = FileName;
+  MappedFile->FileSize = FileSize;
+  MappedFile->Writable = TRUE;
+
+#ifndef __GNUC__
+  {
+    HANDLE         FileHandle;
+    HANDLE         MappingHandle;
+    LARGE_INTEGER  Size;
+
+    FileHandle = CreateFileA (LongFilePath (FileName), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (FileHandle == INVALID_HANDLE_VALUE) {
+      Error (NULL, 0, 0001, "Error opening file", FileName);
+      return EFI_ABORTED;
+    }
+    Size.QuadPart = FileSize;
+    if (FileSize != 0) {
+      MappingHandle = CreateFileMappingA (FileHandle, NULL, PAGE_READWRITE, Size.HighPart, Size.LowPart, NULL);
+      if (MappingHandle != NULL) {
+        MappedFile->FileImage = MapViewOfFile (MappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+        if (MappedFile->FileImage != NULL) {
+          MappedFile->Mapped        = TRUE;
+          MappedFile->FileHandle    = FileHandle;
+          MappedFile->MappingHandle = MappingHandle;
+          return EFI_SUCCESS;
+        }
+        CloseHandle (MappingHandle);
+      }
+    }
+    CloseHandle (FileHandle);
+  }
+#else
+  {
+    int   Fd;
+    VOID  *Image;
+
+    Fd = open (LongFilePath (FileName), O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (Fd < 0) {
+      Error (NULL, 0, 0001, "Error opening file", FileName);
+      return EFI_ABORTED;
+    }
+    if (FileSize != 0 && ftruncate (Fd, (off_t) FileSize) == 0) {
+      Image = mmap (NULL, FileSize, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+      if (Image != MAP_FAILED) {
+        close (Fd);
+        MappedFile->FileImage = Image;
+        MappedFile->Mapped    = TRUE;
+        return EFI_SUCCESS;
+      }
+    }
+    close (Fd);
+  }
+#endif
+
+  //
+  // The file can't be mapped, build the image in a buffer and
+  // write it to the file when it is unmapped.
+  //
+  MappedFile->FileImage = malloc (FileSize + 1);
+  if (MappedFile->FileImage == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Unmaps a file mapped by MapFileForRead () or MapFileForWrite ().
+
+  @param MappedFile         The mapped file.
+  @param Discard            Delete a file mapped for writing instead of
+                            keeping its content.
+
+  @retval EFI_SUCCESS            The file is unmapped.
+  @retval EFI_ABORTED            The image can't be written to the file.
+**/
+EFI_STATUS
+UnmapFile (
+  IN OUT MAPPED_FILE  *MappedFile,
+  IN     BOOLEAN      Discard
+  )
+{
+  EFI_STATUS  Status;
+  FILE        *OutputFile;
+
+  Status = EFI_SUCCESS;
+  if (MappedFile->FileImage == NULL) {
+    return Status;
+  }
+
+  if (MappedFile->Mapped) {
+#ifndef __GNUC__
+    UnmapViewOfFile (MappedFile->FileImage);
+    CloseHandle ((HANDLE) MappedFile->MappingHandle);
+    CloseHandle ((HANDLE) MappedFile->FileHandle);
+#else
+    munmap (MappedFile->FileImage, MappedFile->FileSize);
+#endif
+  } else {
+    if (MappedFile->Writable && !Discard) {
+      OutputFile = fopen (LongFilePath (MappedFile->FileName), "wb");
+      if (OutputFile == NULL) {
+        Error (NULL, 0, 0001, "Error opening file", MappedFile->FileName);
+        Status = EFI_ABORTED;
+      } else {
+        if (fwrite (MappedFile->FileImage, 1, MappedFile->FileSize, OutputFile) != MappedFile->FileSize) {
+          Error (NULL, 0, 0002, "Error writing file", MappedFile->FileName);
+          Status = EFI_ABORTED;
+        }
+        fclose (OutputFile);
+      }
+    }
+    free (MappedFile->FileImage);
+  }
+
+  if (MappedFile->Writable && Discard) {
+    remove (LongFilePath (MappedFile->FileName));
+  }
+
+  MappedFile->FileImage = NULL;
+  return Status;
+}
 
 STATIC
 VOID
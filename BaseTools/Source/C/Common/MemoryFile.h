@@ -22,6 +22,20 @@ typedef struct {
   CHAR8 *CurrentFilePointer;
 } MEMORY_FILE;
 
+//
+// A file mapped into memory. Where the file cannot be mapped, the
+// image is held in an allocated buffer instead and Mapped is FALSE.
+//
+typedef struct {
+  CHAR8   *FileName;
+  UINT8   *FileImage;
+  UINTN   FileSize;
+  BOOLEAN Writable;
+  BOOLEAN Mapped;
+  VOID    *FileHandle;
+  VOID    *MappingHandle;
+} MAPPED_FILE;
+
 
 //
 // Functions declarations
@@ -75,5 +89,60 @@ ReadMemoryFileLine (
   )
 ;
 
+/**
+  Maps a file into memory for reading. The mapping is private, changes
+  made to the image are not written back to the file.
+
+  @param FileName           Name of the file to map.
+  @param MappedFile         The mapped file.
+
+  @retval EFI_SUCCESS            The file is mapped.
+  @retval EFI_ABORTED            The file can't be opened or read.
+  @retval EFI_OUT_OF_RESOURCES   No memory to hold the file image.
+**/
+EFI_STATUS
+MapFileForRead (
+  IN  CHAR8        *FileName,
+  OUT MAPPED_FILE  *MappedFile
+  )
+;
+
+/**
+  Creates a file of the given size and maps it into memory for writing.
+  The content of the image is undefined until it is written.
+
+  @param FileName           Name of the file to create.
+  @param FileSize           Size of the file.
+  @param MappedFile         The mapped file.
+
+  @retval EFI_SUCCESS            The file is mapped.
+  @retval EFI_ABORTED            The file can't be created.
+  @retval EFI_OUT_OF_RESOURCES   No memory to hold the file image.
+**/
+EFI_STATUS
+MapFileForWrite (
+  IN  CHAR8        *FileName,
+  IN  UINTN        FileSize,
+  OUT MAPPED_FILE  *MappedFile
+  )
+;
+
+/**
+  Unmaps a file mapped by MapFileForRead () or MapFileForWrite ().
+
+  @param MappedFile         The mapped file.
+  @param Discard            Delete a file mapped for writing instead of
+                            keeping its content.
+
+  @retval EFI_SUCCESS            The file is unmapped.
+  @retval EFI_ABORTED            The image can't be written to the file.
+**/
+EFI_STATUS
+UnmapFile (
+  IN OUT MAPPED_FILE  *MappedFile,
+  IN     BOOLEAN      Discard
+  )
+;
+
 
 #endif
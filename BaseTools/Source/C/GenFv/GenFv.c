@@ -136,6 +136,10 @@ Returns:
   fprintf (stdout, "  --capheadsize HeadSize\n\
                         HeadSize is one HEX or DEC format value\n\
                         HeadSize is required by Capsule Image.\n");
+  fprintf (stdout, "  --threads ThreadNumber\n\
+                        ThreadNumber is the number of threads used to rebase\n\
+                        the FFS files. If it is 0 or not given, one thread\n\
+                        per processor is used.\n");
   fprintf (stdout, "  -c, --capsule         Create Capsule Image.\n");
   fprintf (stdout, "  -p, --dump            Dump Capsule Image header.\n");
   fprintf (stdout, "  -v, --verbose         Turn on verbose output with informational messages.\n");
@@ -550,6 +554,19 @@ Returns:
       continue;
     }
 
+    if (stricmp (argv[0], "--threads") == 0) {
+      Status = AsciiStringToUint64 (argv[1], FALSE, &TempNumber);
+      if (EFI_ERROR (Status) || TempNumber > MAX_UINT32) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        return STATUS_ERROR;
+      }
+      mThreadNumber = (UINT32) TempNumber;
+      DebugMsg (NULL, 0, 9, "Rebase threads", "%s = %u", argv[0], (unsigned) mThreadNumber);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
     //
     // Don't recognize the parameter.
     //
@@ -25,9 +25,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #endif
 #ifdef __GNUC__
 #include <sys/stat.h>
+#include <unistd.h>
+#include <pthread.h>
 #endif
 #include <string.h>
+#include <stdarg.h>
 #ifndef __GNUC__
+#define RUNTIME_FUNCTION  _WINNT_DUP_RUNTIME_FUNCTION
+#include <windows.h>
+#undef RUNTIME_FUNCTION
 #include <io.h>
 #endif
 #include <assert.h>
@@ -132,6 +138,48 @@ BOOLEAN                     mIsLargeFfs = FALSE;
 EFI_PHYSICAL_ADDRESS mFvBaseAddress[0x10];
 UINT32               mFvBaseAddressNumber = 0;
 
+//
+// The number of threads to rebase the FFS files, 0 to use one per processor
+//
+UINT32               mThreadNumber = 0;
+
+//
+// The FFS files of the FV, mapped once for both the size calculation and
+// the generation of the FV image.
+//
+STATIC MAPPED_FILE     mFvFiles[MAX_NUMBER_OF_FILES_IN_FV];
+
+//
+// The FFS files to rebase once all of them are placed in the FV image
+//
+STATIC FFS_REBASE_JOB  mRebaseJobs[MAX_NUMBER_OF_FILES_IN_FV];
+STATIC UINTN           mRebaseJobCount = 0;
+STATIC UINTN           mRebaseNextJob  = 0;
+STATIC BOOLEAN         mRebaseParallel = FALSE;
+
+#ifndef __GNUC__
+typedef HANDLE            REBASE_THREAD;
+typedef CRITICAL_SECTION  REBASE_LOCK;
+#define RebaseLockInit(Lock)     InitializeCriticalSection (Lock)
+#define RebaseLockAcquire(Lock)  EnterCriticalSection (Lock)
+#define RebaseLockRelease(Lock)  LeaveCriticalSection (Lock)
+#define RebaseLockDelete(Lock)   DeleteCriticalSection (Lock)
+#else
+typedef pthread_t         REBASE_THREAD;
+typedef pthread_mutex_t   REBASE_LOCK;
+#define RebaseLockInit(Lock)     pthread_mutex_init (Lock, NULL)
+#define RebaseLockAcquire(Lock)  pthread_mutex_lock (Lock)
+#define RebaseLockRelease(Lock)  pthread_mutex_unlock (Lock)
+#define RebaseLockDelete(Lock)   pthread_mutex_destroy (Lock)
+#endif
+
+//
+// mRebaseLock hands out the jobs to the threads, mRelocateLock serializes
+// the relocation fixups that keep state in PeCoffLoaderEx.c.
+//
+STATIC REBASE_LOCK     mRebaseLock;
+STATIC REBASE_LOCK     mRelocateLock;
+
 EFI_STATUS
 ParseFvInf (
   IN  MEMORY_FILE  *InfFile,
@@ -1135,7 +1183,6 @@ AddFile (
   IN FV_INFO                  *FvInfo,
   IN UINTN                    Index,
   IN OUT EFI_FFS_FILE_HEADER  **VtfFileImage,
-  IN FILE                     *FvMapFile,
   IN FILE                     *FvReportFile
   )
 /*++
@@ -1153,7 +1200,6 @@ Arguments:
   Index         The file in the FvInfo file list to add.
   VtfFileImage  A pointer to the VTF file within the FvImage.  If this is equal
                 to the end of the FvImage then no VTF previously found.
-  FvMapFile     Pointer to FvMap File
   FvReportFile  Pointer to FvReport File
 
 Returns:
@@ -1165,10 +1211,8 @@ Returns:
 
 --*/
 {
-  FILE                  *NewFile;
   UINTN                 FileSize;
   UINT8                 *FileBuffer;
-  UINTN                 NumBytesRead;
   UINT32                CurrentFileAlignment;
   EFI_STATUS            Status;
   UINTN                 Index1;
@@ -1183,43 +1227,13 @@ Returns:
   }
 
   //
-  // Read the file to add
-  //
-  NewFile = fopen (LongFilePath (FvInfo->FvFiles[Index]), "rb");
-
-  if (NewFile == NULL) {
-    Error (NULL, 0, 0001, "Error opening file", FvInfo->FvFiles[Index]);
-    return EFI_ABORTED;
-  }
-
-  //
-  // Get the file size
-  //
-  FileSize = _filelength (fileno (NewFile));
-
-  //
-  // Read the file into a buffer
+  // The file is mapped by CalculateFvSize. The mapping is private, so the
+  // file state and padding can be updated in place.
   //
-  FileBuffer = malloc (FileSize);
+  FileBuffer = mFvFiles[Index].FileImage;
+  FileSize   = mFvFiles[Index].FileSize;
   if (FileBuffer == NULL) {
-    fclose (NewFile);
-    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  NumBytesRead = fread (FileBuffer, sizeof (UINT8), FileSize, NewFile);
-
-  //
-  // Done with the file, from this point on we will just use the buffer read.
-  //
-  fclose (NewFile);
-
-  //
-  // Verify read successful
-  //
-  if (NumBytesRead != sizeof (UINT8) * FileSize) {
-    free  (FileBuffer);
-    Error (NULL, 0, 0004, "Error reading file", FvInfo->FvFiles[Index]);
+    Error (NULL, 0, 0001, "Error opening file", FvInfo->FvFiles[Index]);
     return EFI_ABORTED;
   }
 
@@ -1233,7 +1247,7 @@ Returns:
     } else {
       FvImage->CurrentFilePointer += FileSize;
     }
-    goto Done;
+    return EFI_SUCCESS;
   }
 
   //
@@ -1241,7 +1255,6 @@ Returns:
   //
   Status = VerifyFfsFile ((EFI_FFS_FILE_HEADER *)FileBuffer);
   if (EFI_ERROR (Status)) {
-    free (FileBuffer);
     Error (NULL, 0, 3000, "Invalid", "%s is not a valid FFS file.", FvInfo->FvFiles[Index]);
     return EFI_INVALID_PARAMETER;
   }
@@ -1250,7 +1263,6 @@ Returns:
   // Verify space exists to add the file
   //
   if (FileSize > (UINTN) ((UINTN) *VtfFileImage - (UINTN) FvImage->CurrentFilePointer)) {
-    free (FileBuffer);
     Error (NULL, 0, 4002, "Resource", "FV space is full, not enough room to add file %s.", FvInfo->FvFiles[Index]);
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1262,7 +1274,6 @@ Returns:
     if (CompareGuid ((EFI_GUID *) FileBuffer, &mFileGuidArray [Index1]) == 0) {
       Error (NULL, 0, 2000, "Invalid parameter", "the %dth file and %uth file have the same file GUID.", (unsigned) Index1 + 1, (unsigned) Index + 1);
       PrintGuid ((EFI_GUID *) FileBuffer);
-      free (FileBuffer);
       return EFI_INVALID_PARAMETER;
     }
   }
@@ -1301,27 +1312,25 @@ Returns:
       //
       if (((UINTN) *VtfFileImage + GetFfsHeaderLength((EFI_FFS_FILE_HEADER *)FileBuffer) - (UINTN) FvImage->FileImage) % (1 << CurrentFileAlignment)) {
         Error (NULL, 0, 3000, "Invalid", "VTF file cannot be aligned on a %u-byte boundary.", (unsigned) (1 << CurrentFileAlignment));
-        free (FileBuffer);
         return EFI_ABORTED;
       }
       //
-      // Rebase the PE or TE image in FileBuffer of FFS file for XIP
+      // copy VTF File
+      //
+      memcpy (*VtfFileImage, FileBuffer, FileSize);
+
+      //
+      // Rebase the PE or TE image of the VTF file in the FV image for XIP
       // Rebase for the debug genfvmap tool
       //
-      Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage, FvMapFile);
+      Status = QueueFfsRebase (FvInfo, FvInfo->FvFiles[Index], *VtfFileImage, (UINTN) *VtfFileImage - (UINTN) FvImage->FileImage);
       if (EFI_ERROR (Status)) {
-        Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
         return Status;
       }
-      //
-      // copy VTF File
-      //
-      memcpy (*VtfFileImage, FileBuffer, FileSize);
 
       PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
       fprintf (FvReportFile, "0x%08X %s\n", (unsigned)(UINTN) (((UINT8 *)*VtfFileImage) - (UINTN)FvImage->FileImage), FileGuidString);
 
-      free (FileBuffer);
       DebugMsg (NULL, 0, 9, "Add VTF FFS file in FV image", NULL);
       return EFI_SUCCESS;
     } else {
@@ -1329,7 +1338,6 @@ Returns:
       // Already found a VTF file.
       //
       Error (NULL, 0, 3000, "Invalid", "multiple VTF files are not permitted within a single FV.");
-      free (FileBuffer);
       return EFI_ABORTED;
     }
   }
@@ -1342,7 +1350,6 @@ Returns:
     Status = AddPadFile (FvImage, 1 << CurrentFileAlignment, *VtfFileImage, NULL, FileSize);
     if (EFI_ERROR (Status)) {
       Error (NULL, 0, 4002, "Resource", "FV space is full, could not add pad file for data alignment property.");
-      free (FileBuffer);
       return EFI_ABORTED;
     }
   }
@@ -1350,25 +1357,24 @@ Returns:
   // Add file
   //
   if ((UINTN) (FvImage->CurrentFilePointer + FileSize) <= (UINTN) (*VtfFileImage)) {
-    //
-    // Rebase the PE or TE image in FileBuffer of FFS file for XIP.
-    // Rebase Bs and Rt drivers for the debug genfvmap tool.
-    //
-    Status = FfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FileBuffer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage, FvMapFile);
-  if (EFI_ERROR (Status)) {
-    Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", FvInfo->FvFiles[Index]);
-    return Status;
-  }
     //
     // Copy the file
     //
     memcpy (FvImage->CurrentFilePointer, FileBuffer, FileSize);
+
+    //
+    // Rebase the PE or TE image of FFS file in the FV image for XIP.
+    // Rebase Bs and Rt drivers for the debug genfvmap tool.
+    //
+    Status = QueueFfsRebase (FvInfo, FvInfo->FvFiles[Index], (EFI_FFS_FILE_HEADER *) FvImage->CurrentFilePointer, (UINTN) FvImage->CurrentFilePointer - (UINTN) FvImage->FileImage);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
     PrintGuidToBuffer ((EFI_GUID *) FileBuffer, FileGuidString, sizeof (FileGuidString), TRUE);
     fprintf (FvReportFile, "0x%08X %s\n", (unsigned) (FvImage->CurrentFilePointer - FvImage->FileImage), FileGuidString);
     FvImage->CurrentFilePointer += FileSize;
   } else {
     Error (NULL, 0, 4002, "Resource", "FV space is full, cannot add file %s.", FvInfo->FvFiles[Index]);
-    free (FileBuffer);
     return EFI_ABORTED;
   }
   //
@@ -1378,12 +1384,6 @@ Returns:
     FvImage->CurrentFilePointer++;
   }
 
-Done:
-  //
-  // Free allocated memory.
-  //
-  free (FileBuffer);
-
   return EFI_SUCCESS;
 }
 
@@ -2527,10 +2527,9 @@ Returns:
   UINTN                           Index;
   EFI_FIRMWARE_VOLUME_HEADER      *FvHeader;
   EFI_FFS_FILE_HEADER             *VtfFileImage;
-  UINT8                           *FvBufferHeader; // to make sure fvimage header 8 type alignment.
+  MAPPED_FILE                     FvFile;
   UINT8                           *FvImage;
   UINTN                           FvImageSize;
-  FILE                            *FvFile;
   CHAR8                           *FvMapName;
   FILE                            *FvMapFile;
   EFI_FIRMWARE_VOLUME_EXT_HEADER  *FvExtHeader;
@@ -2539,8 +2538,7 @@ Returns:
   CHAR8                           *FvReportName;
   FILE                            *FvReportFile;
 
-  FvBufferHeader = NULL;
-  FvFile         = NULL;
+  memset (&FvFile, 0, sizeof (FvFile));
   FvMapName      = NULL;
   FvMapFile      = NULL;
   FvReportName   = NULL;
@@ -2749,14 +2747,13 @@ Returns:
   FvImageSize = mFvDataInfo.Size;
 
   //
-  // Allocate the FV, assure FvImage Header 8 byte alignment
+  // Create the FV file and build the FV image in place in its mapping
   //
-  FvBufferHeader = malloc (FvImageSize + sizeof (UINT64));
-  if (FvBufferHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
+  Status = MapFileForWrite (FvFileName, FvImageSize, &FvFile);
+  if (EFI_ERROR (Status)) {
     goto Finish;
   }
-  FvImage = (UINT8 *) (((UINTN) FvBufferHeader + 7) & ~7);
+  FvImage = FvFile.FileImage;
 
   //
   // Initialize the FV to the erase polarity
@@ -2904,7 +2901,7 @@ Returns:
     //
     // Add the file
     //
-    Status = AddFile (&FvImageMemoryFile, &mFvDataInfo, Index, &VtfFileImage, FvMapFile, FvReportFile);
+    Status = AddFile (&FvImageMemoryFile, &mFvDataInfo, Index, &VtfFileImage, FvReportFile);
 
     //
     // Exit if error detected while adding the file
@@ -2914,6 +2911,14 @@ Returns:
     }
   }
 
+  //
+  // Rebase the files added to the FV image
+  //
+  Status = RunFfsRebase (&mFvDataInfo, FvMapFile);
+  if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
   //
   // If there is a VTF file, some special actions need to occur.
   //
@@ -3018,22 +3023,16 @@ WriteFile:
   //
   // Write fv file
   //
-  FvFile = fopen (LongFilePath (FvFileName), "wb");
-  if (FvFile == NULL) {
-    Error (NULL, 0, 0001, "Error opening file", FvFileName);
-    Status = EFI_ABORTED;
-    goto Finish;
-  }
-
-  if (fwrite (FvImage, 1, FvImageSize, FvFile) != FvImageSize) {
-    Error (NULL, 0, 0002, "Error writing file", FvFileName);
-    Status = EFI_ABORTED;
-    goto Finish;
-  }
+  Status = UnmapFile (&FvFile, FALSE);
 
 Finish:
-  if (FvBufferHeader != NULL) {
-    free (FvBufferHeader);
+  //
+  // Don't leave a partial FV file behind on error
+  //
+  UnmapFile (&FvFile, TRUE);
+
+  for (Index = 0; Index < MAX_NUMBER_OF_FILES_IN_FV; Index++) {
+    UnmapFile (&mFvFiles[Index], FALSE);
   }
 
   if (FvExtHeader != NULL) {
@@ -3048,11 +3047,6 @@ Finish:
     free (FvReportName);
   }
 
-  if (FvFile != NULL) {
-    fflush (FvFile);
-    fclose (FvFile);
-  }
-
   if (FvMapFile != NULL) {
     fflush (FvMapFile);
     fclose (FvMapFile);
@@ -3152,6 +3146,7 @@ Returns:
   EFI_SUCCESS   - Successfully update FvSize
 --*/
 {
+  EFI_STATUS          Status;
   UINTN               CurrentOffset;
   UINTN               Index;
   FILE                *fpin;
@@ -3217,18 +3212,16 @@ Returns:
   //
   for (Index = 0; FvInfoPtr->FvFiles[Index][0] != 0; Index++) {
     //
-    // Open FFS file
+    // Map FFS file, it is kept mapped to be added to the FV image
     //
-    fpin = NULL;
-    fpin = fopen (LongFilePath (FvInfoPtr->FvFiles[Index]), "rb");
-    if (fpin == NULL) {
-      Error (NULL, 0, 0001, "Error opening file", FvInfoPtr->FvFiles[Index]);
+    Status = MapFileForRead (FvInfoPtr->FvFiles[Index], &mFvFiles[Index]);
+    if (EFI_ERROR (Status)) {
       return EFI_ABORTED;
     }
     //
     // Get the file size
     //
-    FfsFileSize = _filelength (fileno (fpin));
+    FfsFileSize = mFvFiles[Index].FileSize;
     if (FfsFileSize >= MAX_FFS_SIZE) {
       FfsHeaderSize = sizeof(EFI_FFS_FILE_HEADER2);
       mIsLargeFfs = TRUE;
@@ -3238,11 +3231,8 @@ Returns:
     //
     // Read Ffs File header
     //
-    fread (&FfsHeader, sizeof (UINT8), sizeof (EFI_FFS_FILE_HEADER), fpin);
-    //
-    // close file
-    //
-    fclose (fpin);
+    memset (&FfsHeader, 0, sizeof (EFI_FFS_FILE_HEADER));
+    memcpy (&FfsHeader, mFvFiles[Index].FileImage, MIN (FfsFileSize, sizeof (EFI_FFS_FILE_HEADER)));
 
     if (FvInfoPtr->IsPiFvImage) {
         //
@@ -3471,68 +3461,215 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
+VOID
+FfsRebaseError (
+  IN OUT FFS_REBASE_JOB  *Job,
+  IN     UINT32          ErrorCode,
+  IN     CHAR8           *ErrorText,
+  IN     CHAR8           *MsgFmt,
+  ...
+  )
+/*++
+
+Routine Description:
+
+  This function records the error of a rebase job, to be reported by
+  RunFfsRebase in the order of the files in the FV.
+
+Arguments:
+
+  Job               The rebase job of the FFS file.
+  ErrorCode         The error code passed to Error ().
+  ErrorText         The error text passed to Error ().
+  MsgFmt            The format of the error message.
+
+Returns:
+
+  None
+
+--*/
+{
+  CHAR8    Message[MAX_LONG_FILE_PATH + 0x100];
+  va_list  List;
+
+  if (Job->ErrorMessage != NULL) {
+    return;
+  }
+
+  va_start (List, MsgFmt);
+  vsnprintf (Message, sizeof (Message), MsgFmt, List);
+  va_end (List);
+
+  Job->ErrorCode    = ErrorCode;
+  Job->ErrorText    = ErrorText;
+  Job->ErrorMessage = strdup (Message);
+}
+
+STATIC
 EFI_STATUS
-FfsRebase (
-  IN OUT  FV_INFO               *FvInfo,
+FfsRebaseAddImage (
+  IN OUT FFS_REBASE_JOB                *Job,
+  IN     CHAR8                         *PdbPointer,
+  IN     EFI_PHYSICAL_ADDRESS          BaseAddress,
+  IN     PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+/*++
+
+Routine Description:
+
+  This function records a rebased image of a rebase job, to be added to
+  the FV map file by RunFfsRebase.
+
+Arguments:
+
+  Job               The rebase job of the FFS file.
+  PdbPointer        The PDB file name of the image.
+  BaseAddress       The address the image is rebased to.
+  ImageContext      The image context before the rebase.
+
+Returns:
+
+  EFI_SUCCESS             The image is recorded.
+  EFI_OUT_OF_RESOURCES    Could not allocate a required resource.
+
+--*/
+{
+  FFS_REBASE_IMAGE  *Images;
+
+  Images = realloc (Job->Images, (Job->ImageCount + 1) * sizeof (FFS_REBASE_IMAGE));
+  if (Images == NULL) {
+    FfsRebaseError (Job, 4001, "Resource", "memory cannot be allocated on rebase of %s", Job->FileName);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Job->Images                              = Images;
+  Job->Images[Job->ImageCount].PdbPointer  = PdbPointer;
+  Job->Images[Job->ImageCount].BaseAddress = BaseAddress;
+  memcpy (&Job->Images[Job->ImageCount].ImageContext, ImageContext, sizeof (PE_COFF_LOADER_IMAGE_CONTEXT));
+  Job->ImageCount++;
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+RETURN_STATUS
+RelocateFfsImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+/*++
+
+Routine Description:
+
+  This function relocates a loaded image. The RISC-V and LoongArch fixups
+  keep global state, so they are serialized when the rebase is parallel.
+
+Arguments:
+
+  ImageContext      The context of the loaded image.
+
+Returns:
+
+  The status of PeCoffLoaderRelocateImage ().
+
+--*/
+{
+  RETURN_STATUS  Status;
+  BOOLEAN        Serialize;
+
+  Serialize = (BOOLEAN) (mRebaseParallel &&
+                         ((ImageContext->Machine == IMAGE_FILE_MACHINE_RISCV64) ||
+                          (ImageContext->Machine == IMAGE_FILE_MACHINE_LOONGARCH64)));
+  if (Serialize) {
+    RebaseLockAcquire (&mRelocateLock);
+  }
+
+  Status = PeCoffLoaderRelocateImage (ImageContext);
+
+  if (Serialize) {
+    RebaseLockRelease (&mRelocateLock);
+  }
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+FfsRebaseGetSection (
+  IN      EFI_FFS_FILE_HEADER       *FfsFile,
+  IN      EFI_SECTION_TYPE          SectionType,
+  IN      UINTN                     Instance,
+  OUT     EFI_FILE_SECTION_POINTER  *Section
+  )
+/*++
+
+Routine Description:
+
+  This function finds a section of a FFS file queued for rebase, as
+  GetSectionByType () does. The file is verified by QueueFfsRebase, so it
+  is not verified again: VerifyFfsFile () reports errors with Error (),
+  which must not be called from a worker thread.
+
+Arguments:
+
+  FfsFile           A pointer to the Ffs file in the FV image.
+  SectionType       Type of the section to find.
+  Instance          Instance of the section to find, starting from 1.
+  Section           Return pointer to the section.
+
+Returns:
+
+  EFI_SUCCESS             The section is found.
+  EFI_NOT_FOUND           The section is not found.
+
+--*/
+{
+  EFI_FILE_SECTION_POINTER  FirstSection;
+  UINTN                     SectionCount;
+
+  SectionCount              = 0;
+  FirstSection.CommonHeader = (EFI_COMMON_SECTION_HEADER *) ((UINTN) FfsFile + GetFfsHeaderLength (FfsFile));
+
+  return SearchSectionByType (
+           FirstSection,
+           (UINT8 *) ((UINTN) FfsFile + GetFfsFileLength (FfsFile)),
+           SectionType,
+           &SectionCount,
+           Instance,
+           Section
+           );
+}
+
+EFI_STATUS
+QueueFfsRebase (
+  IN      FV_INFO               *FvInfo,
   IN      CHAR8                 *FileName,
-  IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
-  IN      UINTN                 XipOffset,
-  IN      FILE                  *FvMapFile
+  IN      EFI_FFS_FILE_HEADER   *FfsFile,
+  IN      UINTN                 XipOffset
   )
 /*++
 
 Routine Description:
 
-  This function determines if a file is XIP and should be rebased.  It will
-  rebase any PE32 sections found in the file using the base address.
+  This function determines if a file is XIP and should be rebased. If so,
+  it queues the file to be rebased in place by RunFfsRebase once all the
+  files are added to the FV image.
 
 Arguments:
 
   FvInfo            A pointer to FV_INFO structure.
   FileName          Ffs File PathName
-  FfsFile           A pointer to Ffs file image.
+  FfsFile           A pointer to the Ffs file in the FV image.
   XipOffset         The offset address to use for rebasing the XIP file image.
-  FvMapFile         FvMapFile to record the function address in one Fvimage
 
 Returns:
 
-  EFI_SUCCESS             The image was properly rebased.
-  EFI_INVALID_PARAMETER   An input parameter is invalid.
-  EFI_ABORTED             An error occurred while rebasing the input file image.
-  EFI_OUT_OF_RESOURCES    Could not allocate a required resource.
-  EFI_NOT_FOUND           No compressed sections could be found.
+  EFI_SUCCESS             The file is queued or needs no rebase.
+  EFI_ABORTED             The file is not a valid FFS file.
 
 --*/
 {
-  EFI_STATUS                            Status;
-  PE_COFF_LOADER_IMAGE_CONTEXT          ImageContext;
-  PE_COFF_LOADER_IMAGE_CONTEXT          OrigImageContext;
-  EFI_PHYSICAL_ADDRESS                  XipBase;
-  EFI_PHYSICAL_ADDRESS                  NewPe32BaseAddress;
-  UINTN                                 Index;
-  EFI_FILE_SECTION_POINTER              CurrentPe32Section;
-  EFI_FFS_FILE_STATE                    SavedState;
-  EFI_IMAGE_OPTIONAL_HEADER_UNION       *ImgHdr;
-  EFI_TE_IMAGE_HEADER                   *TEImageHeader;
-  UINT8                                 *MemoryImagePointer;
-  EFI_IMAGE_SECTION_HEADER              *SectionHeader;
-  CHAR8                                 PeFileName [MAX_LONG_FILE_PATH];
-  CHAR8                                 *Cptr;
-  FILE                                  *PeFile;
-  UINT8                                 *PeFileBuffer;
-  UINT32                                PeFileSize;
-  CHAR8                                 *PdbPointer;
-  UINT32                                FfsHeaderSize;
-  UINT32                                CurSecHdrSize;
-
-  Index              = 0;
-  MemoryImagePointer = NULL;
-  TEImageHeader      = NULL;
-  ImgHdr             = NULL;
-  SectionHeader      = NULL;
-  Cptr               = NULL;
-  PeFile             = NULL;
-  PeFileBuffer       = NULL;
+  FFS_REBASE_JOB  *Job;
 
   //
   // Don't need to relocate image when BaseAddress is zero and no ForceRebase Flag specified.
@@ -3548,9 +3685,6 @@ Returns:
     return EFI_SUCCESS;
   }
 
-
-  XipBase = FvInfo->BaseAddress + XipOffset;
-
   //
   // We only process files potentially containing PE32 sections.
   //
@@ -3576,6 +3710,88 @@ Returns:
       return EFI_SUCCESS;
   }
 
+  //
+  // FfsRebase may run in a worker thread, so the file is verified here.
+  //
+  if (VerifyFfsFile (FfsFile) != EFI_SUCCESS) {
+    Error (NULL, 0, 0006, "invalid FFS file", "%s", FileName);
+    return EFI_ABORTED;
+  }
+
+  Job = &mRebaseJobs[mRebaseJobCount++];
+  memset (Job, 0, sizeof (FFS_REBASE_JOB));
+  Job->FileName  = FileName;
+  Job->FfsFile   = FfsFile;
+  Job->XipOffset = XipOffset;
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+FfsRebase (
+  IN      FV_INFO               *FvInfo,
+  IN OUT  FFS_REBASE_JOB        *Job
+  )
+/*++
+
+Routine Description:
+
+  This function rebases the PE32 and TE sections of a FFS file queued by
+  QueueFfsRebase, in place in the FV image. It may run in a worker thread,
+  so the messages and the FV map file entries are kept in the job and
+  reported by RunFfsRebase.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO structure.
+  Job               The rebase job of the FFS file.
+
+Returns:
+
+  EFI_SUCCESS             The image was properly rebased.
+  EFI_INVALID_PARAMETER   An input parameter is invalid.
+  EFI_ABORTED             An error occurred while rebasing the input file image.
+  EFI_OUT_OF_RESOURCES    Could not allocate a required resource.
+  EFI_NOT_FOUND           No compressed sections could be found.
+
+--*/
+{
+  EFI_STATUS                            Status;
+  PE_COFF_LOADER_IMAGE_CONTEXT          ImageContext;
+  PE_COFF_LOADER_IMAGE_CONTEXT          OrigImageContext;
+  EFI_PHYSICAL_ADDRESS                  XipBase;
+  EFI_PHYSICAL_ADDRESS                  NewPe32BaseAddress;
+  UINTN                                 Index;
+  EFI_FILE_SECTION_POINTER              CurrentPe32Section;
+  EFI_FFS_FILE_STATE                    SavedState;
+  EFI_IMAGE_OPTIONAL_HEADER_UNION       *ImgHdr;
+  EFI_TE_IMAGE_HEADER                   *TEImageHeader;
+  UINT8                                 *MemoryImagePointer;
+  EFI_IMAGE_SECTION_HEADER              *SectionHeader;
+  CHAR8                                 PeFileName [MAX_LONG_FILE_PATH];
+  CHAR8                                 *Cptr;
+  FILE                                  *PeFile;
+  UINT8                                 *PeFileBuffer;
+  UINT32                                PeFileSize;
+  CHAR8                                 *PdbPointer;
+  UINT32                                FfsHeaderSize;
+  UINT32                                CurSecHdrSize;
+  CHAR8                                 *FileName;
+  EFI_FFS_FILE_HEADER                   *FfsFile;
+
+  Index              = 0;
+  MemoryImagePointer = NULL;
+  TEImageHeader      = NULL;
+  ImgHdr             = NULL;
+  SectionHeader      = NULL;
+  Cptr               = NULL;
+  PeFile             = NULL;
+  PeFileBuffer       = NULL;
+  FileName           = Job->FileName;
+  FfsFile            = Job->FfsFile;
+
+  XipBase = FvInfo->BaseAddress + Job->XipOffset;
+
   FfsHeaderSize = GetFfsHeaderLength(FfsFile);
   //
   // Rebase each PE32 section
@@ -3590,7 +3806,7 @@ Returns:
     //
     // Find Pe Image
     //
-    Status = GetSectionByType (FfsFile, EFI_SECTION_PE32, Index, &CurrentPe32Section);
+    Status = FfsRebaseGetSection (FfsFile, EFI_SECTION_PE32, Index, &CurrentPe32Section);
     if (EFI_ERROR (Status)) {
       break;
     }
@@ -3604,21 +3820,21 @@ Returns:
     ImageContext.ImageRead  = (PE_COFF_LOADER_READ_FILE) FfsRebaseImageRead;
     Status                  = PeCoffLoaderGetImageInfo (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+      FfsRebaseError (Job, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
       return Status;
     }
 
     if ( (ImageContext.Machine == IMAGE_FILE_MACHINE_ARMTHUMB_MIXED) ||
          (ImageContext.Machine == IMAGE_FILE_MACHINE_ARM64) ) {
-      mArm = TRUE;
+      Job->Arm = TRUE;
     }
 
     if (ImageContext.Machine == IMAGE_FILE_MACHINE_RISCV64) {
-      mRiscV = TRUE;
+      Job->RiscV = TRUE;
     }
 
     if (ImageContext.Machine == IMAGE_FILE_MACHINE_LOONGARCH64) {
-      mLoongArch = TRUE;
+      Job->LoongArch = TRUE;
     }
 
     //
@@ -3651,7 +3867,7 @@ Returns:
           //
           // Xip module has the same section alignment and file alignment.
           //
-          Error (NULL, 0, 3000, "Invalid", "PE image Section-Alignment and File-Alignment do not match : %s.", FileName);
+          FfsRebaseError (Job, 3000, "Invalid", "PE image Section-Alignment and File-Alignment do not match : %s.", FileName);
           return EFI_ABORTED;
         }
         //
@@ -3662,7 +3878,7 @@ Returns:
           // Construct the original efi file Name
           //
           if (strlen (FileName) >= MAX_LONG_FILE_PATH) {
-            Error (NULL, 0, 2000, "Invalid", "The file name %s is too long.", FileName);
+            FfsRebaseError (Job, 2000, "Invalid", "The file name %s is too long.", FileName);
             return EFI_ABORTED;
           }
           strncpy (PeFileName, FileName, MAX_LONG_FILE_PATH - 1);
@@ -3672,7 +3888,7 @@ Returns:
             Cptr --;
           }
           if (*Cptr != '.') {
-            Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
+            FfsRebaseError (Job, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
             return EFI_ABORTED;
           } else {
             *(Cptr + 1) = 'e';
@@ -3682,7 +3898,7 @@ Returns:
           }
           PeFile = fopen (LongFilePath (PeFileName), "rb");
           if (PeFile == NULL) {
-            Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+            Job->NoRelocCount++;
             //Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
             //return EFI_ABORTED;
             break;
@@ -3694,7 +3910,7 @@ Returns:
           PeFileBuffer = (UINT8 *) malloc (PeFileSize);
           if (PeFileBuffer == NULL) {
             fclose (PeFile);
-            Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+            FfsRebaseError (Job, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
             return EFI_OUT_OF_RESOURCES;
           }
           //
@@ -3711,7 +3927,7 @@ Returns:
           ImageContext.Handle = PeFileBuffer;
           Status              = PeCoffLoaderGetImageInfo (&ImageContext);
           if (EFI_ERROR (Status)) {
-            Error (NULL, 0, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+            FfsRebaseError (Job, 3000, "Invalid PeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
             return Status;
           }
           ImageContext.RelocationsStripped = FALSE;
@@ -3729,7 +3945,7 @@ Returns:
           //
           // Xip module has the same section alignment and file alignment.
           //
-          Error (NULL, 0, 3000, "Invalid", "PE image Section-Alignment and File-Alignment do not match : %s.", FileName);
+          FfsRebaseError (Job, 3000, "Invalid", "PE image Section-Alignment and File-Alignment do not match : %s.", FileName);
           return EFI_ABORTED;
         }
         NewPe32BaseAddress = XipBase + (UINTN) CurrentPe32Section.Pe32Section + CurSecHdrSize - (UINTN)FfsFile;
@@ -3746,7 +3962,7 @@ Returns:
     // Relocation doesn't exist
     //
     if (ImageContext.RelocationsStripped) {
-      Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+      Job->NoRelocCount++;
       continue;
     }
 
@@ -3758,7 +3974,7 @@ Returns:
     //
     MemoryImagePointer = (UINT8 *) malloc ((UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
     if (MemoryImagePointer == NULL) {
-      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+      FfsRebaseError (Job, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
       return EFI_OUT_OF_RESOURCES;
     }
     memset ((VOID *) MemoryImagePointer, 0, (UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
@@ -3766,15 +3982,15 @@ Returns:
 
     Status =  PeCoffLoaderLoadImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
+      FfsRebaseError (Job, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
 
     ImageContext.DestinationAddress = NewPe32BaseAddress;
-    Status                          = PeCoffLoaderRelocateImage (&ImageContext);
+    Status                          = RelocateFfsImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of %s Status=%d", FileName, Status);
+      FfsRebaseError (Job, 3000, "Invalid", "RelocateImage() call failed on rebase of %s Status=%d", FileName, Status);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -3812,7 +4028,7 @@ Returns:
     } else if (ImgHdr->Pe32Plus.OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
       ImgHdr->Pe32Plus.OptionalHeader.ImageBase = NewPe32BaseAddress;
     } else {
-      Error (NULL, 0, 3000, "Invalid", "unknown PE magic signature %X in PE32 image %s",
+      FfsRebaseError (Job, 3000, "Invalid", "unknown PE magic signature %X in PE32 image %s",
         ImgHdr->Pe32.OptionalHeader.Magic,
         FileName
         );
@@ -3844,7 +4060,10 @@ Returns:
       PdbPointer = FileName;
     }
 
-    WriteMapFile (FvMapFile, PdbPointer, FfsFile, NewPe32BaseAddress, &OrigImageContext);
+    Status = FfsRebaseAddImage (Job, PdbPointer, NewPe32BaseAddress, &OrigImageContext);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   if (FfsFile->Type != EFI_FV_FILETYPE_SECURITY_CORE &&
@@ -3868,7 +4087,7 @@ Returns:
     //
     // Find Te Image
     //
-    Status = GetSectionByType (FfsFile, EFI_SECTION_TE, Index, &CurrentPe32Section);
+    Status = FfsRebaseGetSection (FfsFile, EFI_SECTION_TE, Index, &CurrentPe32Section);
     if (EFI_ERROR (Status)) {
       break;
     }
@@ -3889,17 +4108,17 @@ Returns:
     ImageContext.ImageRead  = (PE_COFF_LOADER_READ_FILE) FfsRebaseImageRead;
     Status                  = PeCoffLoaderGetImageInfo (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+      FfsRebaseError (Job, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
       return Status;
     }
 
     if ( (ImageContext.Machine == IMAGE_FILE_MACHINE_ARMTHUMB_MIXED) ||
          (ImageContext.Machine == IMAGE_FILE_MACHINE_ARM64) ) {
-      mArm = TRUE;
+      Job->Arm = TRUE;
     }
 
     if (ImageContext.Machine == IMAGE_FILE_MACHINE_LOONGARCH64) {
-      mLoongArch = TRUE;
+      Job->LoongArch = TRUE;
     }
 
     //
@@ -3926,7 +4145,7 @@ Returns:
       // Construct the original efi file name
       //
       if (strlen (FileName) >= MAX_LONG_FILE_PATH) {
-        Error (NULL, 0, 2000, "Invalid", "The file name %s is too long.", FileName);
+        FfsRebaseError (Job, 2000, "Invalid", "The file name %s is too long.", FileName);
         return EFI_ABORTED;
       }
       strncpy (PeFileName, FileName, MAX_LONG_FILE_PATH - 1);
@@ -3937,7 +4156,7 @@ Returns:
       }
 
       if (*Cptr != '.') {
-        Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
+        FfsRebaseError (Job, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
         return EFI_ABORTED;
       } else {
         *(Cptr + 1) = 'e';
@@ -3948,7 +4167,7 @@ Returns:
 
       PeFile = fopen (LongFilePath (PeFileName), "rb");
       if (PeFile == NULL) {
-        Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+        Job->NoRelocCount++;
         //Error (NULL, 0, 3000, "Invalid", "The file %s has no .reloc section.", FileName);
         //return EFI_ABORTED;
       } else {
@@ -3959,7 +4178,7 @@ Returns:
         PeFileBuffer = (UINT8 *) malloc (PeFileSize);
         if (PeFileBuffer == NULL) {
           fclose (PeFile);
-          Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+          FfsRebaseError (Job, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
           return EFI_OUT_OF_RESOURCES;
         }
         //
@@ -3976,7 +4195,7 @@ Returns:
         ImageContext.Handle = PeFileBuffer;
         Status              = PeCoffLoaderGetImageInfo (&ImageContext);
         if (EFI_ERROR (Status)) {
-          Error (NULL, 0, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
+          FfsRebaseError (Job, 3000, "Invalid TeImage", "The input file is %s and the return status is %x", FileName, (int) Status);
           return Status;
         }
         ImageContext.RelocationsStripped = FALSE;
@@ -3986,7 +4205,7 @@ Returns:
     // Relocation doesn't exist
     //
     if (ImageContext.RelocationsStripped) {
-      Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", FileName);
+      Job->NoRelocCount++;
       continue;
     }
 
@@ -3998,7 +4217,7 @@ Returns:
     //
     MemoryImagePointer = (UINT8 *) malloc ((UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
     if (MemoryImagePointer == NULL) {
-      Error (NULL, 0, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
+      FfsRebaseError (Job, 4001, "Resource", "memory cannot be allocated on rebase of %s", FileName);
       return EFI_OUT_OF_RESOURCES;
     }
     memset ((VOID *) MemoryImagePointer, 0, (UINTN) ImageContext.ImageSize + ImageContext.SectionAlignment);
@@ -4006,7 +4225,7 @@ Returns:
 
     Status =  PeCoffLoaderLoadImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
+      FfsRebaseError (Job, 3000, "Invalid", "LocateImage() call failed on rebase of %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -4014,9 +4233,9 @@ Returns:
     // Reloacate TeImage
     //
     ImageContext.DestinationAddress = NewPe32BaseAddress;
-    Status                          = PeCoffLoaderRelocateImage (&ImageContext);
+    Status                          = RelocateFfsImage (&ImageContext);
     if (EFI_ERROR (Status)) {
-      Error (NULL, 0, 3000, "Invalid", "RelocateImage() call failed on rebase of TE image %s", FileName);
+      FfsRebaseError (Job, 3000, "Invalid", "RelocateImage() call failed on rebase of TE image %s", FileName);
       free ((VOID *) MemoryImagePointer);
       return Status;
     }
@@ -4080,18 +4299,242 @@ Returns:
       PdbPointer = FileName;
     }
 
-    WriteMapFile (
-      FvMapFile,
-      PdbPointer,
-      FfsFile,
-      NewPe32BaseAddress,
-      &OrigImageContext
-      );
+    Status = FfsRebaseAddImage (Job, PdbPointer, NewPe32BaseAddress, &OrigImageContext);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   return EFI_SUCCESS;
 }
 
+STATIC
+VOID
+RebaseFfsFiles (
+  IN FV_INFO  *FvInfo
+  )
+/*++
+
+Routine Description:
+
+  This function takes the queued rebase jobs one by one and runs them
+  until none is left.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO structure.
+
+Returns:
+
+  None
+
+--*/
+{
+  UINTN  Index;
+
+  for (;;) {
+    if (mRebaseParallel) {
+      RebaseLockAcquire (&mRebaseLock);
+    }
+    Index = mRebaseNextJob++;
+    if (mRebaseParallel) {
+      RebaseLockRelease (&mRebaseLock);
+    }
+
+    if (Index >= mRebaseJobCount) {
+      break;
+    }
+
+    mRebaseJobs[Index].Status = FfsRebase (FvInfo, &mRebaseJobs[Index]);
+  }
+}
+
+#ifndef __GNUC__
+STATIC
+DWORD
+WINAPI
+RebaseThread (
+  LPVOID  Context
+  )
+{
+  RebaseFfsFiles ((FV_INFO *) Context);
+  return 0;
+}
+#else
+STATIC
+VOID *
+RebaseThread (
+  VOID  *Context
+  )
+{
+  RebaseFfsFiles ((FV_INFO *) Context);
+  return NULL;
+}
+#endif
+
+STATIC
+UINT32
+GetProcessorNumber (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  This function gets the number of processors online.
+
+Arguments:
+
+  None
+
+Returns:
+
+  The number of processors, at least 1.
+
+--*/
+{
+#ifndef __GNUC__
+  SYSTEM_INFO  SystemInfo;
+
+  GetSystemInfo (&SystemInfo);
+  return SystemInfo.dwNumberOfProcessors > 0 ? (UINT32) SystemInfo.dwNumberOfProcessors : 1;
+#else
+  long  Number;
+
+  Number = sysconf (_SC_NPROCESSORS_ONLN);
+  return Number > 0 ? (UINT32) Number : 1;
+#endif
+}
+
+EFI_STATUS
+RunFfsRebase (
+  IN FV_INFO  *FvInfo,
+  IN FILE     *FvMapFile
+  )
+/*++
+
+Routine Description:
+
+  This function rebases the files queued by QueueFfsRebase in place in the
+  FV image. The files are rebased by mThreadNumber threads, then the
+  messages and the FV map file entries are reported in the order of the
+  files in the FV, as if the files had been rebased one after another.
+
+Arguments:
+
+  FvInfo            A pointer to FV_INFO structure.
+  FvMapFile         FvMapFile to record the function address in one Fvimage
+
+Returns:
+
+  EFI_SUCCESS             All the files are rebased.
+  Others                  The status of the first file that failed to rebase.
+
+--*/
+{
+  EFI_STATUS      Status;
+  UINT32          ThreadNumber;
+  UINT32          Started;
+  REBASE_THREAD   *Threads;
+  FFS_REBASE_JOB  *Job;
+  UINTN           Index;
+  UINTN           Index1;
+
+  ThreadNumber = (mThreadNumber != 0) ? mThreadNumber : GetProcessorNumber ();
+  if (ThreadNumber > mRebaseJobCount) {
+    ThreadNumber = (UINT32) mRebaseJobCount;
+  }
+
+  mRebaseNextJob = 0;
+  Threads        = NULL;
+  if (ThreadNumber > 1) {
+    Threads = malloc ((ThreadNumber - 1) * sizeof (REBASE_THREAD));
+  }
+
+  if (Threads == NULL) {
+    RebaseFfsFiles (FvInfo);
+  } else {
+    RebaseLockInit (&mRebaseLock);
+    RebaseLockInit (&mRelocateLock);
+    mRebaseParallel = TRUE;
+
+    //
+    // The current thread takes jobs as well, the others only speed it up.
+    //
+    for (Started = 0; Started < ThreadNumber - 1; Started++) {
+#ifndef __GNUC__
+      Threads[Started] = CreateThread (NULL, 0, RebaseThread, FvInfo, 0, NULL);
+      if (Threads[Started] == NULL) {
+        break;
+      }
+#else
+      if (pthread_create (&Threads[Started], NULL, RebaseThread, FvInfo) != 0) {
+        break;
+      }
+#endif
+    }
+
+    RebaseFfsFiles (FvInfo);
+
+    for (Index = 0; Index < Started; Index++) {
+#ifndef __GNUC__
+      WaitForSingleObject (Threads[Index], INFINITE);
+      CloseHandle (Threads[Index]);
+#else
+      pthread_join (Threads[Index], NULL);
+#endif
+    }
+
+    mRebaseParallel = FALSE;
+    RebaseLockDelete (&mRelocateLock);
+    RebaseLockDelete (&mRebaseLock);
+    free (Threads);
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < mRebaseJobCount; Index++) {
+    Job = &mRebaseJobs[Index];
+
+    if (!EFI_ERROR (Status)) {
+      for (Index1 = 0; Index1 < Job->NoRelocCount; Index1++) {
+        Warning (NULL, 0, 0, "Invalid", "The file %s has no .reloc section.", Job->FileName);
+      }
+
+      for (Index1 = 0; Index1 < Job->ImageCount; Index1++) {
+        WriteMapFile (
+          FvMapFile,
+          Job->Images[Index1].PdbPointer,
+          Job->FfsFile,
+          Job->Images[Index1].BaseAddress,
+          &Job->Images[Index1].ImageContext
+          );
+      }
+
+      mArm       = (BOOLEAN) (mArm || Job->Arm);
+      mRiscV     = (BOOLEAN) (mRiscV || Job->RiscV);
+      mLoongArch = (BOOLEAN) (mLoongArch || Job->LoongArch);
+
+      if (EFI_ERROR (Job->Status)) {
+        if (Job->ErrorMessage != NULL) {
+          Error (NULL, 0, Job->ErrorCode, Job->ErrorText, "%s", Job->ErrorMessage);
+        }
+        Error (NULL, 0, 3000, "Invalid", "Could not rebase %s.", Job->FileName);
+        Status = Job->Status;
+      }
+    }
+
+    if (Job->Images != NULL) {
+      free (Job->Images);
+    }
+    if (Job->ErrorMessage != NULL) {
+      free (Job->ErrorMessage);
+    }
+  }
+
+  mRebaseJobCount = 0;
+  return Status;
+}
+
 EFI_STATUS
 ParseCapInf (
   IN  MEMORY_FILE  *InfFile,
@@ -26,6 +26,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "CommonLib.h"
 #include "ParseInf.h"
 #include "EfiUtilityMsgs.h"
+#include "MemoryFile.h"
+#include "PeCoffLib.h"
 
 //
 // Different file separator for Linux and Windows
@@ -215,6 +217,35 @@ typedef struct {
   INT8                    ForceRebase;
 } FV_INFO;
 
+//
+// A PE or TE image rebased in an FFS file, to be recorded in the FV map file
+//
+typedef struct {
+  CHAR8                         *PdbPointer;
+  EFI_PHYSICAL_ADDRESS          BaseAddress;
+  PE_COFF_LOADER_IMAGE_CONTEXT  ImageContext;
+} FFS_REBASE_IMAGE;
+
+//
+// The rebase of one FFS file placed in the FV image. The messages and the
+// map file entries are kept until the results are reported in file order.
+//
+typedef struct {
+  CHAR8                   *FileName;
+  EFI_FFS_FILE_HEADER     *FfsFile;
+  UINTN                   XipOffset;
+  EFI_STATUS              Status;
+  UINT32                  ErrorCode;
+  CHAR8                   *ErrorText;
+  CHAR8                   *ErrorMessage;
+  UINT32                  NoRelocCount;
+  FFS_REBASE_IMAGE        *Images;
+  UINTN                   ImageCount;
+  BOOLEAN                 Arm;
+  BOOLEAN                 RiscV;
+  BOOLEAN                 LoongArch;
+} FFS_REBASE_JOB;
+
 typedef struct {
   EFI_GUID                CapGuid;
   UINT32                  HeaderSize;
@@ -245,6 +276,7 @@ extern UINT32     mFvTakenSize;
 
 extern EFI_PHYSICAL_ADDRESS mFvBaseAddress[];
 extern UINT32               mFvBaseAddressNumber;
+extern UINT32               mThreadNumber;
 //
 // Local function prototypes
 //
@@ -328,12 +360,23 @@ CalculateFvSize (
   );
 
 EFI_STATUS
-FfsRebase (
-  IN OUT  FV_INFO               *FvInfo,
+QueueFfsRebase (
+  IN      FV_INFO               *FvInfo,
   IN      CHAR8                 *FileName,
-  IN OUT  EFI_FFS_FILE_HEADER   *FfsFile,
-  IN      UINTN                 XipOffset,
-  IN      FILE                  *FvMapFile
+  IN      EFI_FFS_FILE_HEADER   *FfsFile,
+  IN      UINTN                 XipOffset
+  );
+
+EFI_STATUS
+FfsRebase (
+  IN      FV_INFO               *FvInfo,
+  IN OUT  FFS_REBASE_JOB        *Job
+  );
+
+EFI_STATUS
+RunFfsRebase (
+  IN FV_INFO  *FvInfo,
+  IN FILE     *FvMapFile
   );
 
 //
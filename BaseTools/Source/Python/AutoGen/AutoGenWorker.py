@@ -23,6 +23,8 @@ except:
 import traceback
 import sys
 from AutoGen.DataPipe import MemoryDataPipe
+from Common.BuildTrace import gBuildTrace
+from AutoGen.IncludeGraph import gIncludeGraph
 import logging
 import time
 
@@ -141,6 +143,8 @@ class AutoGenManager(threading.Thread):
                 item = cacheq.get()
                 if item == "CacheDone":
                     cache_num += 1
+                elif item[0] == "IncludeGraph":
+                    gIncludeGraph.Merge(item[1])
                 else:
                     GlobalData.gModuleAllCacheStatus.add(item)
                 if cache_num  == len(self.autogen_workers):
@@ -204,6 +208,13 @@ class AutoGenWorkerInProcess(mp.Process):
             GlobalData.gDisableIncludePathCheck = False
             GlobalData.gFdfParser = self.data_pipe.Get("FdfParser")
             GlobalData.gDatabasePath = self.data_pipe.Get("DatabasePath")
+            GlobalData.gMetaFileCacheDir = self.data_pipe.Get("MetaFileCacheDir")
+            GlobalData.gBuildTraceFile = self.data_pipe.Get("BuildTraceFile")
+            GlobalData.gIncludeGraphFile = self.data_pipe.Get("IncludeGraphFile")
+            # Drop the entries inherited from the build process by fork, it
+            # saves them itself
+            gIncludeGraph.TakeNewEntries()
+            gBuildTrace.SetProcessName("AutoGen worker")
 
             GlobalData.gUseHashCache = self.data_pipe.Get("UseHashCache")
             GlobalData.gBinCacheSource = self.data_pipe.Get("BinCacheSource")
@@ -233,7 +244,11 @@ class AutoGenWorkerInProcess(mp.Process):
             GlobalData.FfsCmd = FfsCmd
             PlatformMetaFile = self.GetPlatformMetaFile(self.data_pipe.Get("P_Info").get("ActivePlatform"),
                                              self.data_pipe.Get("P_Info").get("WorkspaceDir"))
+            ModuleSpan = None
             while True:
+                if ModuleSpan:
+                    gBuildTrace.Add(ModuleSpan[0], "autogen", ModuleSpan[1], time.time(), task=ModuleSpan[0])
+                    ModuleSpan = None
                 if self.error_event.is_set():
                     break
                 module_count += 1
@@ -251,6 +266,7 @@ class AutoGenWorkerInProcess(mp.Process):
 
                 modulefullpath = os.path.join(module_root,module_file)
                 taskname = " : ".join((modulefullpath,module_arch))
+                ModuleSpan = ("AutoGen %s [%s]" % (modulefullpath, module_arch), time.time())
                 module_metafile = PathClass(module_file,module_root)
                 if module_path:
                     module_metafile.Path = module_path
@@ -300,6 +316,11 @@ class AutoGenWorkerInProcess(mp.Process):
             EdkLogger.debug(EdkLogger.DEBUG_9, "Worker %s: %s" % (os.getpid(), str(e)))
             self.feedback_q.put(taskname)
         finally:
+            if self.data_pipe:
+                EdkLogger.verbose("Worker %s: data pipe %s" % (os.getpid(), self.data_pipe.Summary()))
+            gBuildTrace.Flush()
+            if GlobalData.gIncludeGraphFile:
+                self.cache_q.put(("IncludeGraph", gIncludeGraph.TakeNewEntries()))
             EdkLogger.debug(EdkLogger.DEBUG_9, "Worker %s: %s" % (os.getpid(), "Done"))
             self.feedback_q.put("Done")
             self.cache_q.put("CacheDone")
@@ -9,10 +9,17 @@ from Workspace.WorkspaceDatabase import BuildDB
 from Workspace.WorkspaceCommon import GetModuleLibInstances
 import Common.GlobalData as GlobalData
 import os
+import mmap
 import pickle
+import struct
+import time
 from pickle import HIGHEST_PROTOCOL
 from Common import EdkLogger
 
+## The signature and the index size at the start of a data pipe file
+DATA_PIPE_SIGNATURE = b'EDK2PIPE'
+DATA_PIPE_HEADER = struct.Struct('<8sQ')
+
 class PCD_DATA():
     def __init__(self,TokenCName,TokenSpaceGuidCName,Type,DatumType,SkuInfoList,DefaultValue,
                  MaxDatumSize,UserDefinedDefaultStoresFlag,validateranges,
@@ -36,20 +43,76 @@ class DataPipe(object):
         self.data_container = {}
         self.BuildDir = BuildDir
         self.dump_file = ""
+        self.index = {}
+        self.map = None
+        self.base = 0
+        self.LoadTime = 0.0
+        self.LoadCount = 0
 
+## MemoryDataPipe
+#
+# The data container is dumped with each entry pickled on its own, after an
+# index of the offset and the size of the entries. load() maps the file read
+# only and unpickles an entry on its first Get(), so a worker process attaches
+# to the data pipe without deserializing the data it never uses, and the pages
+# of the file are shared by all the worker processes.
+#
 class MemoryDataPipe(DataPipe):
 
     def Get(self,key):
+        if key not in self.data_container and key in self.index:
+            StartTime = time.time()
+            Offset, Size = self.index[key]
+            self.data_container[key] = pickle.loads(self.map[self.base + Offset:self.base + Offset + Size])
+            self.LoadTime += time.time() - StartTime
+            self.LoadCount += 1
         return self.data_container.get(key)
 
     def dump(self,file_path):
+        StartTime = time.time()
         self.dump_file = file_path
+        Index = {}
+        EntryList = []
+        Offset = 0
+        for key in self.data_container:
+            Entry = pickle.dumps(self.data_container[key],HIGHEST_PROTOCOL)
+            Index[key] = (Offset, len(Entry))
+            EntryList.append(Entry)
+            Offset += len(Entry)
+        IndexData = pickle.dumps(Index,HIGHEST_PROTOCOL)
         with open(file_path,'wb') as fd:
-            pickle.dump(self.data_container,fd,pickle.HIGHEST_PROTOCOL)
+            fd.write(DATA_PIPE_HEADER.pack(DATA_PIPE_SIGNATURE, len(IndexData)))
+            fd.write(IndexData)
+            for Entry in EntryList:
+                fd.write(Entry)
+        EdkLogger.verbose("Data pipe %s: %d entries, %d bytes dumped in %dms" % (file_path, len(Index), Offset,
+                          int(round((time.time() - StartTime) * 1000))))
 
     def load(self,file_path):
+        StartTime = time.time()
+        self.dump_file = file_path
+        self.data_container = {}
         with open(file_path,'rb') as fd:
-            self.data_container = pickle.load(fd)
+            Header = fd.read(DATA_PIPE_HEADER.size)
+            if len(Header) < DATA_PIPE_HEADER.size or not Header.startswith(DATA_PIPE_SIGNATURE):
+                #
+                # Data pipe dumped by an earlier version, in one piece
+                #
+                fd.seek(0)
+                self.data_container = pickle.load(fd)
+                self.index = {}
+                self.LoadTime += time.time() - StartTime
+                return
+            self.map = mmap.mmap(fd.fileno(), 0, access=mmap.ACCESS_READ)
+        _, IndexSize = DATA_PIPE_HEADER.unpack(Header)
+        self.base = DATA_PIPE_HEADER.size + IndexSize
+        self.index = pickle.loads(self.map[DATA_PIPE_HEADER.size:self.base])
+        self.LoadTime += time.time() - StartTime
+
+    ## Timing of load() and of the entries unpickled on demand, for the log
+    def Summary(self):
+        return "%d of %d entries loaded in %dms" % (self.LoadCount, len(self.index),
+                                                     int(round(self.LoadTime * 1000)))
 
     @property
     def DataContainer(self):
@@ -158,6 +221,12 @@ class MemoryDataPipe(DataPipe):
 
         self.DataContainer = {"DatabasePath":GlobalData.gDatabasePath}
 
+        self.DataContainer = {"MetaFileCacheDir":GlobalData.gMetaFileCacheDir}
+
+        self.DataContainer = {"BuildTraceFile":GlobalData.gBuildTraceFile}
+
+        self.DataContainer = {"IncludeGraphFile":GlobalData.gIncludeGraphFile}
+
         self.DataContainer = {"FdfParser": True if GlobalData.gFdfParser else False}
 
         self.DataContainer = {"LogLevel": EdkLogger.GetLevel()}
@@ -24,9 +24,7 @@ from .BuildEngine import *
 import Common.GlobalData as GlobalData
 from collections import OrderedDict
 from Common.DataType import TAB_COMPILER_MSFT
-
-## Regular expression for finding header file inclusions
-gIncludePattern = re.compile(r"^[ \t]*[#%]?[ \t]*include(?:[ \t]*(?:\\(?:\r\n|\r|\n))*[ \t]*)*(?:\(?[\"<]?[ \t]*)([-\w.\\/() \t]+)(?:[ \t]*[\">]?\)?)", re.MULTILINE | re.UNICODE | re.IGNORECASE)
+from .IncludeGraph import gIncludePattern, gIncludeGraph
 
 ## Regular expression for matching macro used in header file inclusion
 gMacroPattern = re.compile("([_A-Z][_A-Z0-9]*)[ \t]*\\((.+)\\)", re.UNICODE)
@@ -336,6 +334,10 @@ PCH_TARGET =
 BC_TARGET = ${BEGIN}${backward_compatible_target} ${END}
 CODA_TARGET = ${BEGIN}${remaining_build_target} \\
               ${END}
+MODULE_TARGET = ${BEGIN}${module_build_target} \\
+                ${END}
+FFS_TARGET = ${BEGIN}${ffs_build_target} \\
+             ${END}
 
 #
 # Default target, which will build dependent libraries in addition to source files
@@ -362,6 +364,14 @@ mbuild: $(INIT_TARGET) $(BC_TARGET) gen_libs $(PCH_TARGET) $(CODA_TARGET)
 
 tbuild: $(BC_TARGET) $(PCH_TARGET) $(CODA_TARGET)
 
+#
+# Build Targets used by the ninja backend, which generates the FFS files of the module in a build edge of their own
+#
+
+nbuild: $(BC_TARGET) $(PCH_TARGET) $(MODULE_TARGET)
+
+gen_ffs: $(FFS_TARGET)
+
 #
 # Phony target which is used to force executing commands for a target
 #
@@ -445,6 +455,7 @@ cleanlib:
         self.PlatformInfo = self._AutoGenObject.PlatformInfo
 
         self.ResultFileList = []
+        self.FfsResultFileList = []
         self.IntermediateDirectoryList = ["$(DEBUG_DIR)", "$(OUTPUT_DIR)"]
 
         self.FileBuildTargetList = []       # [(src, target string)]
@@ -706,6 +717,8 @@ cleanlib:
             "image_entry_point"         : ImageEntryPoint,
             "arch_entry_point"          : ArchEntryPoint,
             "remaining_build_target"    : self.ResultFileList,
+            "module_build_target"       : [F for F in self.ResultFileList if F not in self.FfsResultFileList],
+            "ffs_build_target"          : self.FfsResultFileList,
             "common_dependency_file"    : self.CommonFileDependency,
             "create_directory_command"  : self.GetCreateDirectoryCommand(self.IntermediateDirectoryList),
             "clean_command"             : self.GetRemoveDirectoryCommand(["$(OUTPUT_DIR)"]),
@@ -724,9 +737,6 @@ cleanlib:
 
     def ParserGenerateFfsCmd(self):
         #Add Ffs cmd to self.BuildTargetList
-        OutputFile = ''
-        DepsFileList = []
-
         for Cmd in self.GenFfsList:
             if Cmd[2]:
                 for CopyCmd in Cmd[2]:
@@ -735,36 +745,50 @@ cleanlib:
                     Dst = self.ReplaceMacro(Dst)
                     if Dst not in self.ResultFileList:
                         self.ResultFileList.append(Dst)
+                        self.FfsResultFileList.append(Dst)
                     if '%s :' %(Dst) not in self.BuildTargetList:
                         self.BuildTargetList.append("%s : %s" %(Dst,Src))
                         self.BuildTargetList.append('\t' + self._CP_TEMPLATE_[self._Platform] %{'Src': Src, 'Dst': Dst})
 
             FfsCmdList = Cmd[0]
+            OutputFile = ''
+            DepsFileList = []
             for index, Str in enumerate(FfsCmdList):
                 if '-o' == Str:
                     OutputFile = FfsCmdList[index + 1]
                 if '-i' == Str or "-oi" == Str:
-                    if DepsFileList == []:
-                        DepsFileList = [FfsCmdList[index + 1]]
-                    else:
-                        DepsFileList.append(FfsCmdList[index + 1])
-            DepsFileString = ' '.join(DepsFileList).strip()
-            if DepsFileString == '':
+                    DepsFileList.append(FfsCmdList[index + 1])
+            if DepsFileList == []:
                 continue
-            OutputFile = self.ReplaceMacro(OutputFile)
-            self.ResultFileList.append(OutputFile)
-            DepsFileString = self.ReplaceMacro(DepsFileString)
-            self.BuildTargetList.append('%s : %s' % (OutputFile, DepsFileString))
-            CmdString = ' '.join(FfsCmdList).strip()
-            CmdString = self.ReplaceMacro(CmdString)
-            self.BuildTargetList.append('\t%s' % CmdString)
 
+            #
+            # One GenSecFfs generates the sections and the FFS file from a
+            # command file, instead of one tool started per section. The
+            # commands keep the order GenFds generated them in, so that each
+            # one comes after the commands generating its inputs.
+            #
             self.ParseSecCmd(DepsFileList, Cmd[1])
-            for SecOutputFile, SecDepsFile, SecCmd in self.FfsOutputFileList :
-                self.BuildTargetList.append('%s : %s' % (self.ReplaceMacro(SecOutputFile), self.ReplaceMacro(SecDepsFile)))
-                self.BuildTargetList.append('\t%s' % self.ReplaceMacro(SecCmd))
+            SecCmdSet = set(SecCmd for _, _, SecCmd in self.FfsOutputFileList)
+            SecOutputSet = set(SecOutputFile for SecOutputFile, _, _ in self.FfsOutputFileList)
+            CmdList = [SecCmd for SecCmd in Cmd[1] if SecCmd in SecCmdSet]
+            CmdList.append(' '.join(FfsCmdList).strip())
+            ExternalDepsList = []
+            for DepsFile in DepsFileList + [Deps for _, SecDepsFile, _ in self.FfsOutputFileList for Deps in SecDepsFile.split()]:
+                if DepsFile not in SecOutputSet and DepsFile not in ExternalDepsList:
+                    ExternalDepsList.append(DepsFile)
             self.FfsOutputFileList = []
 
+            CmdFile = OutputFile + '.cmd'
+            CmdFileContent = '\n'.join(CmdList).replace('$(MODULE_NAME)', self._AutoGenObject.Macros['MODULE_NAME'])
+            SaveFileOnChange(CmdFile, CmdFileContent + '\n', False)
+            ExternalDepsList.append(CmdFile)
+
+            OutputFile = self.ReplaceMacro(OutputFile)
+            self.ResultFileList.append(OutputFile)
+            self.FfsResultFileList.append(OutputFile)
+            self.BuildTargetList.append('%s : %s' % (OutputFile, self.ReplaceMacro(' '.join(ExternalDepsList))))
+            self.BuildTargetList.append('\tGenSecFfs %s' % self.ReplaceMacro(CmdFile))
+
     def ParseSecCmd(self, OutputFileList, CmdTuple):
         for OutputFile in OutputFileList:
             for SecCmdStr in CmdTuple:
@@ -1697,9 +1721,12 @@ class TopLevelMakefile(BuildFile):
 
 ## Find dependencies for one source file
 #
-#  By searching recursively "#include" directive in file, find out all the
-#  files needed by given source file. The dependencies will be only searched
-#  in given search path list.
+#  The headers the compiler reported for the source file in the previous build
+#  are used if none of the files has changed since. Otherwise, by searching
+#  recursively "#include" directive in file, find out all the files needed by
+#  given source file. The dependencies will be only searched in given search
+#  path list. The "#include" directives of each file are kept in gIncludeGraph
+#  across builds.
 #
 #   @param      File            The source file
 #   @param      ForceInculeList The list of files which will be included forcely
@@ -1709,13 +1736,16 @@ class TopLevelMakefile(BuildFile):
 #
 def GetDependencyList(AutoGenObject, FileCache, File, ForceList, SearchPathList):
     EdkLogger.debug(EdkLogger.DEBUG_1, "Try to get dependency files for %s" % File)
+    CompilerDepList = gIncludeGraph.GetCompilerDeps(File.Path, AutoGenObject.Arch, AutoGenObject.IncludePathList)
+    if CompilerDepList is not None:
+        DependencySet = set(PathClass(Dep) for Dep in CompilerDepList)
+        DependencySet.update(ForceList)
+        DependencySet.discard(File)
+        return list(DependencySet)
+
     FileStack = [File] + ForceList
     DependencySet = set()
 
-    if AutoGenObject.Arch not in gDependencyDatabase:
-        gDependencyDatabase[AutoGenObject.Arch] = {}
-    DepDb = gDependencyDatabase[AutoGenObject.Arch]
-
     while len(FileStack) > 0:
         F = FileStack.pop()
 
@@ -1729,44 +1759,21 @@ def GetDependencyList(AutoGenObject, FileCache, File, ForceList, SearchPathList)
             continue
 
         CurrentFileDependencyList = []
-        if F in DepDb:
-            CurrentFileDependencyList = DepDb[F]
-        else:
-            try:
-                Fd = open(F.Path, 'rb')
-                FileContent = Fd.read()
-                Fd.close()
-            except BaseException as X:
-                EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=F.Path + "\n\t" + str(X))
-            if len(FileContent) == 0:
-                continue
-            try:
-                if FileContent[0] == 0xff or FileContent[0] == 0xfe:
-                    FileContent = FileContent.decode('utf-16')
+        for Inc in gIncludeGraph.GetIncludeList(F.Path):
+            # if there's macro used to reference header file, expand it
+            HeaderList = gMacroPattern.findall(Inc)
+            if len(HeaderList) == 1 and len(HeaderList[0]) == 2:
+                HeaderType = HeaderList[0][0]
+                HeaderKey = HeaderList[0][1]
+                if HeaderType in gIncludeMacroConversion:
+                    Inc = gIncludeMacroConversion[HeaderType] % {"HeaderKey" : HeaderKey}
                 else:
-                    FileContent = FileContent.decode()
-            except:
-                # The file is not txt file. for example .mcb file
-                continue
-            IncludedFileList = gIncludePattern.findall(FileContent)
-
-            for Inc in IncludedFileList:
-                Inc = Inc.strip()
-                # if there's macro used to reference header file, expand it
-                HeaderList = gMacroPattern.findall(Inc)
-                if len(HeaderList) == 1 and len(HeaderList[0]) == 2:
-                    HeaderType = HeaderList[0][0]
-                    HeaderKey = HeaderList[0][1]
-                    if HeaderType in gIncludeMacroConversion:
-                        Inc = gIncludeMacroConversion[HeaderType] % {"HeaderKey" : HeaderKey}
-                    else:
-                        # not known macro used in #include, always build the file by
-                        # returning a empty dependency
-                        FileCache[File] = []
-                        return []
-                Inc = os.path.normpath(Inc)
-                CurrentFileDependencyList.append(Inc)
-            DepDb[F] = CurrentFileDependencyList
+                    # not known macro used in #include, always build the file by
+                    # returning a empty dependency
+                    FileCache[File] = []
+                    return []
+            Inc = os.path.normpath(Inc)
+            CurrentFileDependencyList.append(Inc)
 
         CurrentFilePath = F.Dir
         PathList = [CurrentFilePath] + SearchPathList
@@ -0,0 +1,324 @@
+## @file
+# Create a ninja build file driving the makefiles of the modules and GenFds
+#
+# The ninja build file has one build edge per library and module, which runs
+# the module makefile and touches a stamp file. The inputs of an edge are the
+# makefile, the INF file, the source files and the headers recorded in deps.txt
+# by the previous build, so that ninja only starts make for the modules which
+# are out of date, and a no-op build does not start make at all. The compile
+# and link steps within a module stay in the module makefile.
+#
+# When the FFS commands of a module are known, the module edge only builds the
+# module, and a second edge depending on the module stamp runs the gen_ffs
+# target of the makefile, which outputs the FFS files of the module. Each FD,
+# and each FV outside the FD regions, is then an edge running GenFds for that
+# image only, with the FFS files of the modules in it as inputs, so that ninja
+# only regenerates the images of the modules which changed.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+## Import Modules
+#
+from __future__ import absolute_import
+import Common.LongFilePathOs as os
+import sys
+from Common.LongFilePathSupport import OpenLongFilePath as open
+from Common.Misc import SaveFileOnChange
+import Common.GlobalData as GlobalData
+from .GenMake import WIN32_PLATFORM, POSIX_PLATFORM
+
+## Name of the ninja build file in the platform build directory
+NINJA_FILE_NAME = "build.ninja"
+
+## Files created in the build directory of each module
+NINJA_STAMP_FILE = "ninja.stamp"
+NINJA_DEP_FILE = "ninja.d"
+NINJA_LOG_FILE = "ninja.log"
+NINJA_FFS_LOG_FILE = "ninja-ffs.log"
+
+## Escape a path used in the output or input list of a build edge
+#
+#   @param      Path        The path to escape
+#
+#   @retval     string      The escaped path
+#
+def NinjaPath(Path):
+    return Path.replace("$", "$$").replace(" ", "$ ").replace(":", "$:")
+
+## Escape a string assigned to a ninja variable
+#
+#   @param      Value       The string to escape
+#
+#   @retval     string      The escaped string
+#
+def NinjaValue(Value):
+    return Value.replace("$", "$$")
+
+## NinjaBuildFile class
+#
+#  This class generates the build.ninja of a platform build. The make output of
+#  each module is kept in ninja.log of its build directory, and printed only if
+#  the make fails.
+#
+class NinjaBuildFile(object):
+    ## Fixed header string for build.ninja
+    _FILE_HEADER_ = '''#
+# DO NOT EDIT
+# This file is auto-generated by build utility
+#
+# Abstract:
+#
+#   Auto-generated ninja build file driving the makefiles of the modules
+#
+ninja_required_version = 1.5
+'''
+
+    ## command running the makefile of a module
+    _MAKE_COMMAND_ = {
+        WIN32_PLATFORM :   'cmd /c cd /d "$dir" && $make $target > %(log)s 2>&1 && type nul > %(stamp)s || (type %(log)s & exit /b 1)',
+        POSIX_PLATFORM :   'cd "$dir" && $make $target > %(log)s 2>&1 && touch %(stamp)s || { cat %(log)s; exit 1; }'
+    }
+
+    ## command running the gen_ffs target of the makefile of a module
+    _FFS_COMMAND_ = {
+        WIN32_PLATFORM :   'cmd /c cd /d "$dir" && $make gen_ffs > %(log)s 2>&1 || (type %(log)s & exit /b 1)',
+        POSIX_PLATFORM :   'cd "$dir" && $make gen_ffs > %(log)s 2>&1 || { cat %(log)s; exit 1; }'
+    }
+
+    _GENFDS_COMMAND_ = {
+        WIN32_PLATFORM :   'cmd /c cd /d "$dir" && $genfds $image',
+        POSIX_PLATFORM :   'cd "$dir" && $genfds $image'
+    }
+
+    ## Constructor of NinjaBuildFile
+    #
+    #   @param  Workspace       Object of WorkspaceAutoGen class
+    #   @param  ModuleList      The ModuleAutoGen objects of the modules to build
+    #   @param  BuildCommand    The make command as list
+    #   @param  MakeFileName    The file name of the module makefiles
+    #   @param  FfsCommandDict  The FFS commands of the modules, {(Inf, Arch): [Cmd]}
+    #   @param  ImageList       The FD and FV images from GenFds.GetImageFfsList
+    #
+    def __init__(self, Workspace, ModuleList, BuildCommand, MakeFileName, FfsCommandDict=None, ImageList=None):
+        self._Workspace = Workspace
+        self._BuildCommand = BuildCommand
+        self._MakeFileName = MakeFileName
+        self.FileName = os.path.join(Workspace.BuildDir, NINJA_FILE_NAME)
+
+        if sys.platform == "win32":
+            self._Platform = WIN32_PLATFORM
+        else:
+            self._Platform = POSIX_PLATFORM
+
+        #
+        # Libraries are built before the modules linking them, except the
+        # binary ones and the ones restored from the binary cache.
+        #
+        self.LibraryList = []
+        self.ModuleList = []
+        for Ma in ModuleList:
+            for La in Ma.LibraryAutoGenList:
+                if La in self.LibraryList or La.IsBinaryModule or La.CanSkipbyCache(GlobalData.gModuleCacheHit):
+                    continue
+                self.LibraryList.append(La)
+            if Ma not in self.ModuleList:
+                self.ModuleList.append(Ma)
+
+        #
+        # The FFS files of a module generated by its makefile. A module with a
+        # custom makefile has no gen_ffs target, GenFds generates its FFS.
+        #
+        self.FfsFileDict = {}
+        FfsOwner = {}
+        for Ma in self.ModuleList:
+            if Ma.CustomMakefile or not FfsCommandDict:
+                continue
+            FfsFileList = self.GetFfsFileList(FfsCommandDict.get((Ma.MetaFile.Path, Ma.Arch), []))
+            if FfsFileList:
+                self.FfsFileDict[Ma] = FfsFileList
+                for FfsFile in FfsFileList:
+                    FfsOwner[os.path.normcase(os.path.normpath(FfsFile))] = Ma
+
+        #
+        # An image depends on the FFS files built by the module edges, the
+        # others come from binary modules and GenFds itself.
+        #
+        self.ImageList = []
+        for Option, Name, ImageFile, FfsFileList in ImageList or []:
+            FfsFileList = [FfsFile for FfsFile in FfsFileList if os.path.normcase(os.path.normpath(FfsFile)) in FfsOwner]
+            self.ImageList.append((Option, Name, ImageFile, FfsFileList))
+
+    ## Get the FFS files output by the FFS commands of a module
+    #
+    #   @param  CmdList     The FFS commands, (GenFfs command, section commands, copies)
+    #
+    #   @retval list        The FFS files
+    #
+    @staticmethod
+    def GetFfsFileList(CmdList):
+        FfsFileList = []
+        for Cmd in CmdList:
+            GenFfsCmd = list(Cmd[0])
+            if "-o" not in GenFfsCmd or ("-i" not in GenFfsCmd and "-oi" not in GenFfsCmd):
+                continue
+            Index = GenFfsCmd.index("-o")
+            if Index + 1 < len(GenFfsCmd) and GenFfsCmd[Index + 1] not in FfsFileList:
+                FfsFileList.append(GenFfsCmd[Index + 1])
+        return FfsFileList
+
+    ## Get the stamp file of a module
+    #
+    #   @param  Ma      Object of ModuleAutoGen class
+    #
+    @staticmethod
+    def GetStampFile(Ma):
+        return os.path.join(Ma.MakeFileDir, NINJA_STAMP_FILE)
+
+    ## Get the make log of a module
+    #
+    #   @param  Ma      Object of ModuleAutoGen class
+    #
+    @staticmethod
+    def GetLogFile(Ma):
+        return os.path.join(Ma.MakeFileDir, NINJA_LOG_FILE)
+
+    ## Create the depfile of a module from deps.txt of the previous build
+    #
+    #  Ninja treats a missing file in a depfile as out of date instead of an
+    #  error, so the files removed since the previous build do no harm.
+    #
+    #   @param  Ma      Object of ModuleAutoGen class
+    #
+    def _GenerateDepFile(self, Ma):
+        DepList = [Ma.MetaFile.Path]
+        DepList.extend(F.Path for F in Ma.SourceFileList)
+        AutoGenC = os.path.join(Ma.DebugDir, "AutoGen.c")
+        if os.path.exists(AutoGenC):
+            DepList.append(AutoGenC)
+        DepsTxt = os.path.join(Ma.MakeFileDir, "deps.txt")
+        if os.path.exists(DepsTxt):
+            with open(DepsTxt, "r") as Fd:
+                DepList.extend(Line.strip() for Line in Fd if Line.strip())
+
+        Content = [self.GetStampFile(Ma).replace(" ", "\\ ") + ":"]
+        Content.extend(Dep.replace(" ", "\\ ") for Dep in DepList)
+        SaveFileOnChange(os.path.join(Ma.MakeFileDir, NINJA_DEP_FILE), " \\\n  ".join(Content) + "\n", False)
+
+    ## Get the build edge of a library or module
+    #
+    #   @param  Ma      Object of ModuleAutoGen class
+    #
+    def _GetBuildEdge(self, Ma):
+        self._GenerateDepFile(Ma)
+        Edge = "build %s: make %s" % (NinjaPath(self.GetStampFile(Ma)),
+                                      NinjaPath(os.path.join(Ma.MakeFileDir, self._MakeFileName)))
+        LibStampList = [NinjaPath(self.GetStampFile(La)) for La in Ma.LibraryAutoGenList if La in self.LibraryList]
+        if LibStampList:
+            Edge += " | " + " ".join(LibStampList)
+        return [
+            Edge,
+            "  dir = %s" % NinjaValue(Ma.MakeFileDir),
+            "  target = %s" % ("nbuild" if Ma in self.FfsFileDict else "tbuild"),
+            "  desc = %s [%s]" % (NinjaValue(str(Ma)), Ma.Arch),
+            ""
+            ]
+
+    ## Get the build edge generating the FFS files of a module
+    #
+    #   @param  Ma      Object of ModuleAutoGen class
+    #
+    def _GetFfsEdge(self, Ma):
+        return [
+            "build %s: ffs %s | %s" % (" ".join(NinjaPath(FfsFile) for FfsFile in self.FfsFileDict[Ma]),
+                                       NinjaPath(self.GetStampFile(Ma)),
+                                       NinjaPath(os.path.join(Ma.MakeFileDir, self._MakeFileName))),
+            "  dir = %s" % NinjaValue(Ma.MakeFileDir),
+            "  desc = %s [%s]" % (NinjaValue(str(Ma)), Ma.Arch),
+            ""
+            ]
+
+    ## Get the build edge generating an FD or FV image
+    #
+    #   @param  Image   (Option, Name, ImageFile, FfsFileList)
+    #
+    def _GetImageEdge(self, Image):
+        Option, Name, ImageFile, FfsFileList = Image
+        Edge = "build %s: genfds %s" % (NinjaPath(ImageFile), " ".join(NinjaPath(FfsFile) for FfsFile in FfsFileList))
+        return [
+            Edge.rstrip() + " | " + NinjaPath(self._Workspace.FdfFile),
+            "  dir = %s" % NinjaValue(self._Workspace.WorkspaceDir),
+            "  image = %s %s" % (Option, NinjaValue(Name)),
+            "  desc = %s" % NinjaValue(Name),
+            "  pool = genfds",
+            ""
+            ]
+
+    ## Create build.ninja
+    #
+    #  @retval TRUE     The build file is created or re-created successfully.
+    #  @retval FALSE    The build file exists and is the same as the one to be generated.
+    #
+    def Generate(self):
+        MakeCommand = self._MAKE_COMMAND_[self._Platform] % {"log" : NINJA_LOG_FILE, "stamp" : NINJA_STAMP_FILE}
+        FfsCommand = self._FFS_COMMAND_[self._Platform] % {"log" : NINJA_FFS_LOG_FILE}
+        Content = [
+            self._FILE_HEADER_,
+            "builddir = %s" % NinjaValue(self._Workspace.BuildDir),
+            "make = %s" % NinjaValue(" ".join(self._BuildCommand)),
+            "",
+            "rule make",
+            "  command = %s" % MakeCommand,
+            "  depfile = $dir%s%s" % (os.sep, NINJA_DEP_FILE),
+            "  description = Building ... $desc",
+            "",
+            "rule ffs",
+            "  command = %s" % FfsCommand,
+            "  description = GenFfs ... $desc",
+            "  restat = 1",
+            ""
+            ]
+
+        for La in self.LibraryList:
+            Content.extend(self._GetBuildEdge(La))
+        for Ma in self.ModuleList:
+            Content.extend(self._GetBuildEdge(Ma))
+            if Ma in self.FfsFileDict:
+                Content.extend(self._GetFfsEdge(Ma))
+
+        Content.append("build modules: phony %s" % " ".join(NinjaPath(self.GetStampFile(Ma)) for Ma in self.LibraryList + self.ModuleList))
+        Content.append("build ffs: phony %s" % " ".join(NinjaPath(FfsFile) for Ma in self.ModuleList if Ma in self.FfsFileDict for FfsFile in self.FfsFileDict[Ma]))
+        Content.append("")
+
+        #
+        # GenFds writes files shared by all the images, such as the FFS files
+        # of the FILE statements, so that the image edges run one at a time.
+        # The fds target runs GenFds for the whole FDF, build runs it in
+        # process after the modules and the FFS files instead, to collect the
+        # module map before GenFds.
+        #
+        if self._Workspace.FdfFile:
+            Content.extend([
+                "genfds = %s" % NinjaValue(self._Workspace.GenFdsCommand),
+                "",
+                "pool genfds",
+                "  depth = 1",
+                "",
+                "rule genfds",
+                "  command = %s" % self._GENFDS_COMMAND_[self._Platform],
+                "  description = GenFds $desc",
+                ""
+                ])
+            for Image in self.ImageList:
+                Content.extend(self._GetImageEdge(Image))
+            Content.extend([
+                "build fds: genfds | modules ffs",
+                "  dir = %s" % NinjaValue(self._Workspace.WorkspaceDir),
+                "  pool = console",
+                ""
+                ])
+
+        Content.append("default modules ffs")
+        Content.append("")
+        return SaveFileOnChange(self.FileName, "\n".join(Content), False)
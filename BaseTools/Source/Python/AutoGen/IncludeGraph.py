@@ -0,0 +1,263 @@
+## @file
+# Keep the include dependencies of source and header files across builds
+#
+# The graph has two kinds of entries, both shared by all architectures and
+# saved in Conf/.cache/IncludeGraph at the end of a build:
+#   1. The #include directives of a file, found by scanning its content. An
+#      entry is valid as long as the modified time and the size of the file
+#      are unchanged, or else as long as the hash of its content is unchanged.
+#   2. The headers a compiler reported for a source file in its depfile after
+#      the file was built. An entry is valid as long as none of the files has
+#      changed, the include path list of the module is the same, and no header
+#      of the same name has appeared in an include directory searched before
+#      the one a header was found in.
+# So only the files which changed since the previous build are scanned again.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import Common.LongFilePathOs as os
+import pickle
+import re
+import uuid
+from hashlib import md5
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.BuildToolError import FILE_OPEN_FAILURE
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## Regular expression for finding header file inclusions
+gIncludePattern = re.compile(r"^[ \t]*[#%]?[ \t]*include(?:[ \t]*(?:\\(?:\r\n|\r|\n))*[ \t]*)*(?:\(?[\"<]?[ \t]*)([-\w.\\/() \t]+)(?:[ \t]*[\">]?\)?)", re.MULTILINE | re.UNICODE | re.IGNORECASE)
+
+## IncludeGraph
+#
+# The graph is loaded on first use. The AutoGen worker processes hand the
+# entries they added or refreshed over to the build process, which saves them
+# into the graph file on disk together with its own, without dropping the
+# entries saved by other builds in the meantime. The graph is disabled when
+# GlobalData.gIncludeGraphFile is not set.
+#
+class IncludeGraph(object):
+    # Change it whenever the layout of the entries or gIncludePattern changes
+    _VERSION_ = 1
+
+    def __init__(self):
+        self._Includes = None
+        self._CompilerDeps = None
+        self._NewIncludes = {}
+        self._NewCompilerDeps = {}
+        self.ScanCount = 0
+        self.HitCount = 0
+        self._ExistCache = {}
+
+    ## Get the stamp of a file, None if it doesn't exist
+    @staticmethod
+    def _Stamp(Path):
+        try:
+            Stat = os.stat(Path)
+        except OSError:
+            return None
+        return (Stat.st_mtime_ns, Stat.st_size)
+
+    ## Read the graph file
+    @staticmethod
+    def _Read():
+        try:
+            with open(GlobalData.gIncludeGraphFile, 'rb') as File:
+                Data = pickle.load(File)
+            if Data.get('Version') == IncludeGraph._VERSION_:
+                return Data['Includes'], Data['CompilerDeps']
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to load include graph: %s" % Exc)
+        return {}, {}
+
+    def _Load(self):
+        if self._Includes is None:
+            if GlobalData.gIncludeGraphFile and os.path.exists(GlobalData.gIncludeGraphFile):
+                self._Includes, self._CompilerDeps = self._Read()
+            else:
+                self._Includes, self._CompilerDeps = {}, {}
+
+    ## Digest of the include path list of a module
+    @staticmethod
+    def _PathDigest(IncludePathList):
+        return md5("|".join(str(Path) for Path in IncludePathList).encode('utf-8')).hexdigest()
+
+    def _Exists(self, Path):
+        if Path not in self._ExistCache:
+            self._ExistCache[Path] = os.path.isfile(Path)
+        return self._ExistCache[Path]
+
+    ## Check whether a header would be found somewhere else now
+    #
+    #   The header may have been included by its name relative to any of the
+    #   include directories it is in. For each of them, a file of that name in
+    #   an include directory searched before takes its place.
+    #
+    #   @param  Dep         The full path of the header
+    #   @param  DirList     The normalized include path list of the module
+    #
+    #   @retval True        The header is shadowed by another file
+    #   @retval False       The header is still the one found
+    #
+    def _IsShadowed(self, Dep, DirList):
+        NormDep = os.path.normcase(os.path.normpath(Dep))
+        for Index, Dir in enumerate(DirList):
+            if not NormDep.startswith(Dir + os.sep):
+                continue
+            Name = NormDep[len(Dir) + 1:]
+            for Earlier in DirList[:Index]:
+                Candidate = os.path.join(Earlier, Name)
+                if Candidate != NormDep and self._Exists(Candidate):
+                    return True
+        return False
+
+    ## Get the #include directives of a file
+    #
+    #   @param  Path        The full path of the file
+    #
+    #   @retval list        The included names, in the order they are found
+    #
+    def GetIncludeList(self, Path):
+        self._Load()
+        Stamp = self._Stamp(Path)
+        Entry = self._Includes.get(Path)
+        if Entry and Stamp and Entry[0] == Stamp:
+            self.HitCount += 1
+            return Entry[2]
+
+        try:
+            with open(Path, 'rb') as Fd:
+                FileContent = Fd.read()
+        except BaseException as X:
+            EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=Path + "\n\t" + str(X))
+
+        Digest = md5(FileContent).hexdigest()
+        if Entry and Entry[1] == Digest:
+            IncludeList = Entry[2]
+            self.HitCount += 1
+        else:
+            IncludeList = []
+            self.ScanCount += 1
+            try:
+                if FileContent and (FileContent[0] == 0xff or FileContent[0] == 0xfe):
+                    FileContent = FileContent.decode('utf-16')
+                else:
+                    FileContent = FileContent.decode()
+                IncludeList = [Inc.strip() for Inc in gIncludePattern.findall(FileContent)]
+            except:
+                # The file is not txt file. for example .mcb file
+                pass
+
+        Entry = (Stamp, Digest, IncludeList)
+        self._Includes[Path] = Entry
+        if GlobalData.gIncludeGraphFile:
+            self._NewIncludes[Path] = Entry
+        return IncludeList
+
+    ## Get the headers a compiler reported for a source file
+    #
+    #   @param  Path            The full path of the source file
+    #   @param  Arch            The architecture the file was built for
+    #   @param  IncludePathList The include path list of the module
+    #
+    #   @retval list            The full paths of the headers
+    #   @retval None            No valid entry, the file needs to be scanned
+    #
+    def GetCompilerDeps(self, Path, Arch, IncludePathList):
+        self._Load()
+        Entry = self._CompilerDeps.get((Path, Arch))
+        if not Entry or Entry[0] != self._PathDigest(IncludePathList):
+            return None
+        for Dep, Stamp in Entry[1]:
+            if self._Stamp(Dep) != Stamp:
+                return None
+        DirList = [os.path.normcase(os.path.normpath(str(Dir))) for Dir in IncludePathList]
+        for Dep, _ in Entry[1][1:]:
+            if self._IsShadowed(Dep, DirList):
+                return None
+        self.HitCount += 1
+        return [Dep for Dep, _ in Entry[1][1:]]
+
+    ## Record the headers a compiler reported for a source file
+    #
+    #   @param  Path            The full path of the source file
+    #   @param  Arch            The architecture the file was built for
+    #   @param  IncludePathList The include path list of the module
+    #   @param  DepList         The full paths of the headers
+    #
+    def SetCompilerDeps(self, Path, Arch, IncludePathList, DepList):
+        if not GlobalData.gIncludeGraphFile:
+            return
+        self._Load()
+        Stamps = []
+        for Dep in [Path] + [Dep for Dep in DepList if Dep != Path]:
+            Stamp = self._Stamp(Dep)
+            if Stamp is None:
+                return
+            Stamps.append((Dep, Stamp))
+        Entry = (self._PathDigest(IncludePathList), Stamps)
+        self._CompilerDeps[(Path, Arch)] = Entry
+        self._NewCompilerDeps[(Path, Arch)] = Entry
+
+    ## Take the entries added or refreshed by this process, and the counters
+    #
+    #   An AutoGen worker process passes them to the build process, which
+    #   merges them with Merge().
+    #
+    #   @retval tuple       The entries of the #include directives, the entries
+    #                       of the compiler dependencies, the scan count and the
+    #                       hit count
+    #
+    def TakeNewEntries(self):
+        NewEntries = (self._NewIncludes, self._NewCompilerDeps, self.ScanCount, self.HitCount)
+        self._NewIncludes = {}
+        self._NewCompilerDeps = {}
+        self.ScanCount = 0
+        self.HitCount = 0
+        return NewEntries
+
+    ## Merge the entries taken by TakeNewEntries() in another process
+    def Merge(self, NewEntries):
+        Includes, CompilerDeps, ScanCount, HitCount = NewEntries
+        self._Load()
+        self._Includes.update(Includes)
+        self._CompilerDeps.update(CompilerDeps)
+        self._NewIncludes.update(Includes)
+        self._NewCompilerDeps.update(CompilerDeps)
+        self.ScanCount += ScanCount
+        self.HitCount += HitCount
+
+    ## Save the entries added or refreshed by this process into the graph file
+    def Save(self):
+        if not GlobalData.gIncludeGraphFile or not (self._NewIncludes or self._NewCompilerDeps):
+            return
+        Includes, CompilerDeps = self._Read()
+        Includes.update(self._NewIncludes)
+        CompilerDeps.update(self._NewCompilerDeps)
+
+        #
+        # Write to a temporary file first, another build may save the graph at
+        # the same time.
+        #
+        try:
+            TempFile = "%s.%s" % (GlobalData.gIncludeGraphFile, uuid.uuid4().hex)
+            with open(TempFile, 'wb') as File:
+                pickle.dump({'Version': self._VERSION_, 'Includes': Includes, 'CompilerDeps': CompilerDeps},
+                            File, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempFile, GlobalData.gIncludeGraphFile)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to save include graph: %s" % Exc)
+        self._NewIncludes = {}
+        self._NewCompilerDeps = {}
+
+    ## Summary of the scanned files and the graph hits, for the build log
+    def Summary(self):
+        return "%d files scanned, %d dependencies reused" % (self.ScanCount, self.HitCount)
+
+gIncludeGraph = IncludeGraph()
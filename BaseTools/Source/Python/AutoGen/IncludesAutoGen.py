@@ -11,6 +11,7 @@ import Common.LongFilePathOs as os
 from Common.BuildToolError import *
 from Common.Misc import SaveFileOnChange, PathClass
 from Common.Misc import TemplateString
+from AutoGen.IncludeGraph import gIncludeGraph
 import sys
 gIsFileMap = {}
 
@@ -74,6 +75,33 @@ ${END}
     def CreateDepsTarget(self):
         SaveFileOnChange(os.path.join(self.makefile_folder,"deps_target"),"\n".join([item +":" for item in self.DepsCollection]),False)
 
+    def RecordIncludeGraph(self):
+        """ Record the included files of each source file in the include graph, taken from the updated .deps files """
+        target_source_map = {os.path.normpath(item[0].Path):item[1].Path for item in self.TargetFileList.values()}
+        for abspath in self.deps_files:
+            if abspath.endswith(".trim.deps"):
+                continue
+            try:
+                with open(abspath,"r") as fd:
+                    lines = fd.readlines()
+                firstlineitems = lines[0].split(": ", 1)
+                source_abs = target_source_map.get(os.path.normpath(firstlineitems[0].strip()))
+                if not source_abs:
+                    continue
+                deps = []
+                for item in firstlineitems[1:] + lines[1:]:
+                    if item == DEP_FILE_TAIL:
+                        continue
+                    item = item.strip(" \\\n")
+                    if item.startswith('''"'''):
+                        deps.append(item.strip('''"'''))
+                    else:
+                        deps.extend(item.split())
+                gIncludeGraph.SetCompilerDeps(source_abs, self.module_autogen.Arch, self.module_autogen.IncludePathList, deps)
+            except Exception as e:
+                EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to record the dependencies in %s: %s" % (abspath, str(e)))
+                continue
+
     @cached_property
     def deps_files(self):
         """ Get all .deps file under module build folder. """
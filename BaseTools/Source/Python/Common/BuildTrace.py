@@ -0,0 +1,396 @@
+## @file
+# Record a timeline of the build in the Chrome Trace Event format
+#
+# The trace file given by --trace-file can be loaded in chrome://tracing or
+# https://ui.perfetto.dev. Every process of the build records the spans of its
+# own work: the phases and the make tasks in build, the modules in the AutoGen
+# workers, the FV images in the GenFds workers, and the tools run by make or
+# GenFds. The worker processes flush their events into part files next to the
+# trace file, which the build process merges into the trace file at the end of
+# the build, together with a summary of the critical path and the idle CPU
+# time.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import os
+import glob
+import json
+import threading
+import time
+from bisect import bisect_right
+from contextlib import contextmanager
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.BuildToolError import FILE_OPEN_FAILURE, FILE_WRITE_FAILURE
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## The category of the steps of the tools in tools_def.txt
+gToolCategory = {
+    "CC"       : "compile",
+    "ASM"      : "compile",
+    "NASM"     : "compile",
+    "PP"       : "compile",
+    "APP"      : "compile",
+    "ASLCC"    : "compile",
+    "ASLPP"    : "compile",
+    "VFRPP"    : "compile",
+    "VFR"      : "compile",
+    "ASL"      : "compile",
+    "SLINK"    : "link",
+    "DLINK"    : "link",
+    "DLINK2"   : "link",
+    "ASLDLINK" : "link",
+    "GENFW"    : "genfw",
+    }
+
+## The BaseTools run by the makefiles without an entry in tools_def.txt
+gMakeTools = ("Trim", "GenFfs", "GenSec", "EfiRom")
+
+## The extensions of the files a step is named after
+gStepFileExt = (".c", ".cpp", ".s", ".asm", ".nasm", ".nasmb", ".asl", ".aslc", ".act", ".vfr", ".i", ".iii", ".lib", ".dll", ".efi", ".uni")
+
+## The categories of the tool steps counted on the critical path
+gStepCategory = ("compile", "link", "genfw", "tool")
+
+## The events ending at most this long after a task started are taken as done
+#  before it, to allow for the polling of the schedulers and the clock of ninja
+_TOLERANCE_ = 20000
+
+## BuildTrace
+#
+# The trace is disabled when GlobalData.gBuildTraceFile is not set. The events
+# of a forked child are dropped in the child, so a fork only flushes its own.
+#
+class BuildTrace(object):
+    def __init__(self):
+        self._Events = []
+        self._ProcessName = None
+        self._ThreadNames = {}
+
+    def _Reset(self):
+        self._Events = []
+        self._ProcessName = None
+        self._ThreadNames = {}
+
+    ## Start a new trace in the build process, removing the parts left by a
+    #  build which was interrupted
+    def Enable(self, TraceFile):
+        GlobalData.gBuildTraceFile = TraceFile
+        self._Reset()
+        self.SetProcessName("build")
+        for Part in glob.glob(glob.escape(TraceFile) + ".*.part"):
+            try:
+                os.remove(Part)
+            except OSError:
+                pass
+
+    ## Name the current process, shown on its lane group in the viewer
+    def SetProcessName(self, Name):
+        if GlobalData.gBuildTraceFile:
+            self._ProcessName = Name
+
+    ## Name the current thread, shown on its lane in the viewer
+    def SetThreadName(self, Name, Tid=None):
+        if GlobalData.gBuildTraceFile:
+            self._ThreadNames[threading.get_ident() if Tid is None else Tid] = Name
+
+    ## Record a complete event
+    #
+    #   @param  Name        The name of the event
+    #   @param  Category    The category of the event
+    #   @param  Start       The start time in seconds since the epoch
+    #   @param  End         The end time in seconds since the epoch
+    #   @param  Tid         The lane of the event, the current thread if None
+    #   @param  Args        The arguments of the event. A task has "task" and
+    #                       the list of the tasks it depends on in "deps".
+    #
+    def Add(self, Name, Category, Start, End, Tid=None, **Args):
+        if not GlobalData.gBuildTraceFile:
+            return
+        Event = {
+            "name" : Name,
+            "cat"  : Category,
+            "ph"   : "X",
+            "ts"   : int(Start * 1000000),
+            "dur"  : max(int((End - Start) * 1000000), 0),
+            "pid"  : os.getpid(),
+            "tid"  : threading.get_ident() if Tid is None else Tid
+            }
+        if Args:
+            Event["args"] = Args
+        self._Events.append(Event)
+
+    ## Record the span of the code in a with statement
+    @contextmanager
+    def Span(self, Name, Category, **Args):
+        if not GlobalData.gBuildTraceFile:
+            yield
+            return
+        Start = time.time()
+        try:
+            yield
+        finally:
+            self.Add(Name, Category, Start, time.time(), **Args)
+
+    ## Get the events and the metadata of the current process
+    def _TakeEvents(self):
+        Pid = os.getpid()
+        Events = self._Events
+        self._Events = []
+        if self._ProcessName:
+            Events.append({"name" : "process_name", "ph" : "M", "pid" : Pid, "args" : {"name" : self._ProcessName}})
+        for Tid, Name in self._ThreadNames.items():
+            Events.append({"name" : "thread_name", "ph" : "M", "pid" : Pid, "tid" : Tid, "args" : {"name" : Name}})
+        return Events
+
+    ## Write the events of a worker process into its part file
+    def Flush(self):
+        if not GlobalData.gBuildTraceFile:
+            return
+        Events = self._TakeEvents()
+        if not Events:
+            return
+        try:
+            with open("%s.%d.part" % (GlobalData.gBuildTraceFile, os.getpid()), "a") as Fd:
+                Fd.write("".join(json.dumps(Event) + "\n" for Event in Events))
+        except OSError:
+            EdkLogger.verbose("Failed to write the build trace of process %d" % os.getpid())
+
+    ## Merge the parts of the worker processes into the trace file
+    #
+    #  @retval list     The lines of the summary
+    #
+    def Save(self):
+        TraceFile = GlobalData.gBuildTraceFile
+        if not TraceFile:
+            return []
+        Events = self._TakeEvents()
+        for Part in sorted(glob.glob(glob.escape(TraceFile) + ".*.part")):
+            try:
+                with open(Part, "r") as Fd:
+                    for Line in Fd:
+                        try:
+                            Events.append(json.loads(Line))
+                        except ValueError:
+                            pass
+                os.remove(Part)
+            except OSError:
+                EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=Part)
+
+        Complete = [Event for Event in Events if Event.get("ph") == "X"]
+        if Complete:
+            Base = min(Event["ts"] for Event in Complete)
+            for Event in Complete:
+                Event["ts"] -= Base
+        Summary = self.Summary(Complete)
+
+        try:
+            Dir = os.path.dirname(TraceFile)
+            if Dir and not os.path.exists(Dir):
+                os.makedirs(Dir)
+            with open(TraceFile, "w") as Fd:
+                json.dump({"traceEvents" : Events, "displayTimeUnit" : "ms"}, Fd)
+        except OSError:
+            EdkLogger.error("build", FILE_WRITE_FAILURE, ExtraData=TraceFile)
+        return ["Build trace: %d events of %d processes saved in %s" % (len(Complete), len(set(Event["pid"] for Event in Events)), TraceFile)] + Summary
+
+    ## Find the chain of tasks which determined the end of the build
+    #
+    #  Walking back from the task ending last, the task before the current one
+    #  is the dependency ending last, or the task ending last before the
+    #  current one started if it has no dependency in the trace, since the
+    #  schedulers start the tasks of a phase only after the previous phase.
+    #
+    @staticmethod
+    def _CriticalPath(Tasks):
+        End = lambda Event: Event["ts"] + Event["dur"]
+        Tasks = sorted(Tasks, key=End)
+        EndList = [End(Task) for Task in Tasks]
+        ByName = {Task["args"]["task"] : Task for Task in Tasks}
+        Current = Tasks[-1]
+        Path = [Current]
+        while True:
+            Limit = Current["ts"] + _TOLERANCE_
+            DepList = [ByName[Dep] for Dep in Current["args"].get("deps", []) if Dep in ByName]
+            DepList = [Dep for Dep in DepList if End(Dep) <= Limit and Dep["ts"] < Current["ts"]]
+            Previous = max(DepList, key=End) if DepList else None
+            if Previous is None:
+                Index = bisect_right(EndList, Limit) - 1
+                while Index >= 0 and Tasks[Index]["ts"] >= Current["ts"]:
+                    Index -= 1
+                if Index < 0:
+                    break
+                Previous = Tasks[Index]
+            Path.append(Previous)
+            Current = Previous
+        Path.reverse()
+        return Path
+
+    ## Get the segments of time with the number of lanes busy in each
+    @staticmethod
+    def _BusySegments(Events):
+        Lanes = {}
+        for Event in Events:
+            Lanes.setdefault((Event["pid"], Event["tid"]), []).append((Event["ts"], Event["ts"] + Event["dur"]))
+        Points = []
+        for Intervals in Lanes.values():
+            Intervals.sort()
+            Start, End = Intervals[0]
+            for Begin, Finish in Intervals[1:]:
+                if Begin > End:
+                    Points.extend(((Start, 1), (End, -1)))
+                    Start = Begin
+                End = max(End, Finish)
+            Points.extend(((Start, 1), (End, -1)))
+        Points.sort()
+        Segments = []
+        Busy = 0
+        for Index, (Time, Delta) in enumerate(Points):
+            Busy += Delta
+            if Index + 1 < len(Points) and Busy > 0 and Points[Index + 1][0] > Time:
+                Segments.append((Time, Points[Index + 1][0], Busy))
+        return Segments
+
+    ## Get the summary of the critical path and the idle CPU time
+    #
+    #   @param  Events      The complete events of all processes
+    #
+    #   @retval list        The lines of the summary
+    #
+    def Summary(self, Events):
+        Work = [Event for Event in Events if Event["cat"] != "phase"]
+        Tasks = [Event for Event in Work if "task" in Event.get("args", {})]
+        if not Tasks:
+            return []
+        Lines = []
+        Start = min(Event["ts"] for Event in Events)
+        Wall = max(Event["ts"] + Event["dur"] for Event in Events) - Start
+
+        Path = self._CriticalPath(Tasks)
+        Lines.append("Critical path: %s in %d tasks, %.1f%% of the build" % (
+            _Seconds(sum(Task["dur"] for Task in Path)), len(Path), 100.0 * sum(Task["dur"] for Task in Path) / max(Wall, 1)))
+        Shown = set(id(Task) for Task in sorted(Path, key=lambda Task: Task["dur"], reverse=True)[:10])
+        for Task in Path:
+            if id(Task) in Shown:
+                Lines.append("    %10s  %s" % (_Seconds(Task["dur"]), Task["name"]))
+        if len(Path) > len(Shown):
+            Lines.append("    %10s  %d shorter tasks" % ("", len(Path) - len(Shown)))
+
+        StepTime = {}
+        for Task in Path:
+            for Event in Work:
+                if Event["cat"] in gStepCategory and Event["pid"] == Task["pid"] and Event["tid"] == Task["tid"] \
+                   and Task["ts"] <= Event["ts"] and Event["ts"] + Event["dur"] <= Task["ts"] + Task["dur"]:
+                    StepTime[Event["cat"]] = StepTime.get(Event["cat"], 0) + Event["dur"]
+        if StepTime:
+            Lines.append("    Tools on the critical path: %s" % ", ".join("%s %s" % (Category, _Seconds(StepTime[Category]))
+                                                                          for Category in gStepCategory if Category in StepTime))
+
+        Cpus = os.cpu_count() or 1
+        Segments = self._BusySegments(Work)
+        def Idle(Begin, End):
+            Busy = sum((min(Finish, End) - max(Time, Begin)) * min(Count, Cpus)
+                       for Time, Finish, Count in Segments if Time < End and Finish > Begin)
+            return Cpus * (End - Begin) - Busy, Cpus * (End - Begin)
+        IdleTime, Total = Idle(Start, Start + Wall)
+        Lines.append("Idle CPU time: %s of %s, %.1f%% on %d CPUs" % (_Seconds(IdleTime), _Seconds(Total), 100.0 * IdleTime / max(Total, 1), Cpus))
+        for Phase in sorted((Event for Event in Events if Event["cat"] == "phase"), key=lambda Event: Event["ts"]):
+            IdleTime, Total = Idle(Phase["ts"], Phase["ts"] + Phase["dur"])
+            Lines.append("    %-10s %10s wall, %.1f%% idle" % (Phase["name"], _Seconds(Phase["dur"]), 100.0 * IdleTime / max(Total, 1)))
+        return Lines
+
+## Format a time in microseconds
+def _Seconds(Time):
+    return "%.3fs" % (Time / 1000000.0)
+
+## Split the first word of a command line, which may be quoted
+def _SplitCommand(Line):
+    Line = Line.strip()
+    if Line[:1] in ('"', "'"):
+        End = Line.find(Line[0], 1)
+        if End < 0:
+            return None, []
+        return Line[1:End], Line[End + 1:].split()
+    Words = Line.split()
+    if not Words:
+        return None, []
+    return Words[0], Words[1:]
+
+## Get the name of an executable to compare, without directory and extension
+def _ToolName(Path):
+    Name = os.path.basename(Path.replace("\\", "/"))
+    if Name.lower().endswith(".exe"):
+        Name = Name[:-4]
+    return Name.lower()
+
+## ToolStepRecorder
+#
+# Make prints each command of a module before running it, one at a time, so
+# a step lasts from the line of its command until the next command or the end
+# of make. The commands are recognized by the tool paths of the module, and
+# told apart by their flags when several tools share an executable. Nothing is
+# recorded when make runs in silent mode.
+#
+class ToolStepRecorder(object):
+    ## Constructor
+    #
+    #   @param  BuildOption     The tools of the module, {Tool : {"PATH" : ..., "FLAGS" : ...}}
+    #   @param  Tid             The lane of the steps, the one of the task running make
+    #
+    def __init__(self, BuildOption, Tid):
+        self._Tools = {}
+        for Tool in sorted(BuildOption):
+            Path = BuildOption[Tool].get("PATH")
+            if Path:
+                self._Tools.setdefault(_ToolName(Path), []).append((Tool, set(BuildOption[Tool].get("FLAGS", "").split())))
+        for Tool in gMakeTools:
+            self._Tools.setdefault(Tool.lower(), [(Tool, set())])
+        self._Tid = Tid
+        self._Step = None
+
+    ## Find the tool run by a line of output
+    def _Match(self, Line):
+        Command, Arguments = _SplitCommand(Line)
+        if not Command:
+            return None
+        Candidates = self._Tools.get(_ToolName(Command))
+        if not Candidates:
+            return None
+        Arguments = set(Arguments)
+        Tool = max(Candidates, key=lambda Candidate: len(Candidate[1] & Arguments))[0]
+        Name = Tool
+        for Argument in reversed(Line.split()):
+            Argument = Argument.strip('"\'')
+            if Argument.lower().endswith(gStepFileExt):
+                Name = "%s %s" % (Tool, os.path.basename(Argument.replace("\\", "/")))
+                break
+        return Name, gToolCategory.get(Tool, "tool")
+
+    ## Take a line of the output of make
+    def Feed(self, Line):
+        Step = self._Match(Line)
+        if Step:
+            Now = time.time()
+            self.Close(Now)
+            self._Step = (Step[0], Step[1], Now)
+
+    ## Record the step running until now
+    def Close(self, Now=None):
+        if self._Step:
+            Name, Category, Start = self._Step
+            gBuildTrace.Add(Name, Category, Start, time.time() if Now is None else Now, self._Tid)
+            self._Step = None
+
+gBuildTrace = BuildTrace()
+
+#
+# Drop the events inherited by a forked worker, the parent keeps them
+#
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(after_in_child=gBuildTrace._Reset)
@@ -78,6 +78,18 @@ gBuildDirectory = ''
 # The relative default database file path
 #
 gDatabasePath = ".cache/build.db"
+#
+# The directory to keep the parsed meta files across builds, None if disabled
+#
+gMetaFileCacheDir = None
+#
+# The file to keep the include dependencies of the files across builds, None if disabled
+#
+gIncludeGraphFile = None
+#
+# The file to record the timeline of the build into, None if disabled
+#
+gBuildTraceFile = None
 
 #
 # Build flag for binary build
@@ -119,6 +131,7 @@ gModuleAllCacheStatus = None
 gModuleCacheHit = None
 
 gEnableGenfdsMultiThread = True
+gThreadNumber = 0
 gSikpAutoGenCache = set()
 # Common lock for the file access in multiple process AutoGens
 file_lock = None
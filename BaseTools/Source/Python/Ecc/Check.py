@@ -8,6 +8,7 @@
 from __future__ import absolute_import
 import Common.LongFilePathOs as os
 import re
+import time
 from CommonDataClass.DataClass import *
 import Common.DataType as DT
 from Ecc.EccToolError import *
@@ -25,19 +26,117 @@ from Common.MultipleWorkspace import MultipleWorkspace as mws
 #
 class Check(object):
     def __init__(self):
-        pass
+        # The time spent by each category of checkpoints, in seconds
+        self.TimeList = []
 
     # Check all required checkpoints
     def Check(self):
-        self.GeneralCheck()
-        self.MetaDataFileCheck()
-        self.DoxygenCheck()
-        self.IncludeFileCheck()
-        self.PredicateExpressionCheck()
-        self.DeclAndDataTypeCheck()
-        self.FunctionLayoutCheck()
-        self.NamingConventionCheck()
-        self.SmmCommParaCheck()
+        for CheckCategory in (self.GeneralCheck,
+                              self.MetaDataFileCheck,
+                              self.DoxygenCheck,
+                              self.IncludeFileCheck,
+                              self.PredicateExpressionCheck,
+                              self.DeclAndDataTypeCheck,
+                              self.FunctionLayoutCheck,
+                              self.NamingConventionCheck,
+                              self.SmmCommParaCheck):
+            StartTime = time.perf_counter()
+            CheckCategory()
+            self.TimeList.append((CheckCategory.__name__, time.perf_counter() - StartTime))
+
+    ## Run a checkpoint of c.py on each file of a list
+    #
+    # The reports of a file are taken from the cache if neither the file, the
+    # files it includes, the configuration nor the exceptions changed since
+    # they were saved. A checkpoint only looks into the file and the files it
+    # includes, so the reports can be saved relative to the file.
+    #
+    # @param CheckFunc:  The checkpoint, called with the path of a file
+    # @param FileList:   The files to check
+    # @param Tag:        The tag logged in front of each file checked, if any
+    #
+    def CheckFiles(self, CheckFunc, FileList, Tag=None):
+        Cache = EccGlobalData.gCache
+        for FullName in FileList:
+            if Tag is not None:
+                EdkLogger.quiet("[%s]%s" % (Tag, FullName))
+            if Cache is None:
+                CheckFunc(FullName)
+                continue
+
+            Key = None
+            FileID = c.GetTableID(FullName)
+            if FileID >= 0:
+                IncludeFileList = c.GetAllIncludeFiles(FullName)
+                IncludePathList = c.IncludePathListDict.get(os.path.dirname(FullName), [])
+                Key = Cache.CheckKey(FullName, IncludeFileList, IncludePathList)
+            if Key is None:
+                CheckFunc(FullName)
+                continue
+
+            Reports = Cache.GetCheckReports(FullName, Key, CheckFunc.__name__)
+            if Reports is not None:
+                self.RestoreFileReports(FileID, Reports)
+                continue
+
+            LastReportID = EccGlobalData.gDb.TblReport.ID
+            CheckFunc(FullName)
+            Reports = self.GetFileReports(FileID, LastReportID)
+            if Reports is not None:
+                Cache.SetCheckReports(FullName, Key, CheckFunc.__name__, Reports)
+
+    ## Get the range of the IDs of the functions of a file
+    def GetFunctionIDRange(self, FileID):
+        SqlCommand = """select min(ID), max(ID) from %s where BelongsToFile = %s""" % (EccGlobalData.gDb.TblFunction.Table, FileID)
+        RecordSet = EccGlobalData.gDb.TblFunction.Exec(SqlCommand)
+        if not RecordSet or RecordSet[0][0] is None:
+            return (0, -1)
+        return RecordSet[0]
+
+    ## Get the reports added since a report, relative to a file
+    #
+    # The items of the file and of its functions are saved as offsets, since
+    # the IDs of the files and the functions change from one run to another.
+    #
+    # @param FileID:        The ID of the file
+    # @param LastReportID:  The ID of the last report before the check
+    #
+    # @retval list          The reports, None if one of them belongs to
+    #                       another file
+    #
+    def GetFileReports(self, FileID, LastReportID):
+        SqlCommand = """select ErrorID, OtherMsg, BelongsToTable, BelongsToItem from %s
+                        where ID > %s order by ID""" % (EccGlobalData.gDb.TblReport.Table, LastReportID)
+        RecordSet = EccGlobalData.gDb.TblReport.Exec(SqlCommand)
+        Reports = []
+        if not RecordSet:
+            return Reports
+        IdentifierTable = 'Identifier' + str(FileID)
+        MinFunctionID, MaxFunctionID = self.GetFunctionIDRange(FileID)
+        for ErrorID, OtherMsg, BelongsToTable, BelongsToItem in RecordSet:
+            if BelongsToTable == IdentifierTable:
+                Reports.append((ErrorID, OtherMsg, 'Identifier', BelongsToItem))
+            elif BelongsToTable == 'Function' and MinFunctionID <= BelongsToItem <= MaxFunctionID:
+                Reports.append((ErrorID, OtherMsg, 'Function', BelongsToItem - MinFunctionID))
+            elif BelongsToTable == 'File' and BelongsToItem == FileID:
+                Reports.append((ErrorID, OtherMsg, 'File', 0))
+            else:
+                return None
+        return Reports
+
+    ## Add the reports got by GetFileReports back for a file
+    def RestoreFileReports(self, FileID, Reports):
+        MinFunctionID = None
+        for ErrorID, OtherMsg, BelongsToTable, BelongsToItem in Reports:
+            if BelongsToTable == 'Identifier':
+                BelongsToTable = 'Identifier' + str(FileID)
+            elif BelongsToTable == 'Function':
+                if MinFunctionID is None:
+                    MinFunctionID = self.GetFunctionIDRange(FileID)[0]
+                BelongsToItem += MinFunctionID
+            else:
+                BelongsToItem = FileID
+            EccGlobalData.gDb.TblReport.Insert(ErrorID, OtherMsg=OtherMsg, BelongsToTable=BelongsToTable, BelongsToItem=BelongsToItem)
 
     def SmmCommParaCheck(self):
         self.SmmCommParaCheckBufferType()
@@ -334,8 +433,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.c', '.h'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckFuncLayoutReturnType(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                c.CheckFuncLayoutReturnType(FullName)
+            self.CheckFiles(c.CheckFuncLayoutReturnType, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether any optional functional modifiers exist and next to the return type
     def FunctionLayoutCheckModifier(self):
@@ -347,8 +445,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.c', '.h'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckFuncLayoutModifier(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                c.CheckFuncLayoutModifier(FullName)
+            self.CheckFiles(c.CheckFuncLayoutModifier, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether the next line contains the function name, left justified, followed by the beginning of the parameter list
     # Check whether the closing parenthesis is on its own line and also indented two spaces
@@ -361,8 +458,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.c', '.h'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckFuncLayoutName(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                c.CheckFuncLayoutName(FullName)
+            self.CheckFiles(c.CheckFuncLayoutName, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether the function prototypes in include files have the same form as function definitions
     def FunctionLayoutCheckPrototype(self):
@@ -375,9 +471,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[PROTOTYPE]" + FullName)
 #                        c.CheckFuncLayoutPrototype(FullName)
-            for FullName in EccGlobalData.gCFileList:
-                EdkLogger.quiet("[PROTOTYPE]" + FullName)
-                c.CheckFuncLayoutPrototype(FullName)
+            self.CheckFiles(c.CheckFuncLayoutPrototype, EccGlobalData.gCFileList, 'PROTOTYPE')
 
     # Check whether the body of a function is contained by open and close braces that must be in the first column
     def FunctionLayoutCheckBody(self):
@@ -389,8 +483,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckFuncLayoutBody(FullName)
-            for FullName in EccGlobalData.gCFileList:
-                c.CheckFuncLayoutBody(FullName)
+            self.CheckFiles(c.CheckFuncLayoutBody, EccGlobalData.gCFileList)
 
     # Check whether the data declarations is the first code in a module.
     # self.CFunctionLayoutCheckDataDeclaration = 1
@@ -405,8 +498,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckFuncLayoutLocalVariable(FullName)
 
-            for FullName in EccGlobalData.gCFileList:
-                c.CheckFuncLayoutLocalVariable(FullName)
+            self.CheckFiles(c.CheckFuncLayoutLocalVariable, EccGlobalData.gCFileList)
 
     # Check whether no use of STATIC for functions
     # self.CFunctionLayoutCheckNoStatic = 1
@@ -432,8 +524,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h', '.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckDeclNoUseCType(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                c.CheckDeclNoUseCType(FullName)
+            self.CheckFiles(c.CheckDeclNoUseCType, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether the modifiers IN, OUT, OPTIONAL, and UNALIGNED are used only to qualify arguments to a function and should not appear in a data type declaration
     def DeclCheckInOutModifier(self):
@@ -445,8 +536,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h', '.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        c.CheckDeclArgModifier(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                c.CheckDeclArgModifier(FullName)
+            self.CheckFiles(c.CheckDeclArgModifier, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether the EFIAPI modifier should be used at the entry of drivers, events, and member functions of protocols
     def DeclCheckEFIAPIModifier(self):
@@ -464,9 +554,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[ENUM]" + FullName)
 #                        c.CheckDeclEnumTypedef(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                EdkLogger.quiet("[ENUM]" + FullName)
-                c.CheckDeclEnumTypedef(FullName)
+            self.CheckFiles(c.CheckDeclEnumTypedef, EccGlobalData.gCFileList + EccGlobalData.gHFileList, 'ENUM')
 
     # Check whether Structure Type has a 'typedef' and the name is capital
     def DeclCheckStructureDeclaration(self):
@@ -479,9 +567,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[STRUCT]" + FullName)
 #                        c.CheckDeclStructTypedef(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                EdkLogger.quiet("[STRUCT]" + FullName)
-                c.CheckDeclStructTypedef(FullName)
+            self.CheckFiles(c.CheckDeclStructTypedef, EccGlobalData.gCFileList + EccGlobalData.gHFileList, 'STRUCT')
 
     # Check whether having same Structure
     def DeclCheckSameStructure(self):
@@ -516,9 +602,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[UNION]" + FullName)
 #                        c.CheckDeclUnionTypedef(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                EdkLogger.quiet("[UNION]" + FullName)
-                c.CheckDeclUnionTypedef(FullName)
+            self.CheckFiles(c.CheckDeclUnionTypedef, EccGlobalData.gCFileList + EccGlobalData.gHFileList, 'UNION')
 
     # Predicate Expression Checking
     def PredicateExpressionCheck(self):
@@ -537,9 +621,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[BOOLEAN]" + FullName)
 #                        c.CheckBooleanValueComparison(FullName)
-            for FullName in EccGlobalData.gCFileList:
-                EdkLogger.quiet("[BOOLEAN]" + FullName)
-                c.CheckBooleanValueComparison(FullName)
+            self.CheckFiles(c.CheckBooleanValueComparison, EccGlobalData.gCFileList, 'BOOLEAN')
 
     # Check whether Non-Boolean comparisons use a compare operator (==, !=, >, < >=, <=).
     def PredicateExpressionCheckNonBooleanOperator(self):
@@ -552,9 +634,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[NON-BOOLEAN]" + FullName)
 #                        c.CheckNonBooleanValueComparison(FullName)
-            for FullName in EccGlobalData.gCFileList:
-                EdkLogger.quiet("[NON-BOOLEAN]" + FullName)
-                c.CheckNonBooleanValueComparison(FullName)
+            self.CheckFiles(c.CheckNonBooleanValueComparison, EccGlobalData.gCFileList, 'NON-BOOLEAN')
 
     # Check whether a comparison of any pointer to zero must be done via the NULL type
     def PredicateExpressionCheckComparisonNullType(self):
@@ -567,9 +647,7 @@ class Check(object):
 #                        FullName = os.path.join(Dirpath, F)
 #                        EdkLogger.quiet("[POINTER]" + FullName)
 #                        c.CheckPointerNullComparison(FullName)
-            for FullName in EccGlobalData.gCFileList:
-                EdkLogger.quiet("[POINTER]" + FullName)
-                c.CheckPointerNullComparison(FullName)
+            self.CheckFiles(c.CheckPointerNullComparison, EccGlobalData.gCFileList, 'POINTER')
 
     # Include file checking
     def IncludeFileCheck(self):
@@ -613,8 +691,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        MsgList = c.CheckHeaderFileIfndef(FullName)
-            for FullName in EccGlobalData.gHFileList:
-                MsgList = c.CheckHeaderFileIfndef(FullName)
+            self.CheckFiles(c.CheckHeaderFileIfndef, EccGlobalData.gHFileList)
 
     # Check whether include files NOT contain code or define data variables
     def IncludeFileCheckData(self):
@@ -747,8 +824,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h', '.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        MsgList = c.CheckFuncHeaderDoxygenComments(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                MsgList = c.CheckFuncHeaderDoxygenComments(FullName)
+            self.CheckFiles(c.CheckFuncHeaderDoxygenComments, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
 
     # Check whether the first line of text in a comment block is a brief description of the element being documented.
@@ -767,8 +843,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h', '.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        MsgList = c.CheckDoxygenTripleForwardSlash(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                MsgList = c.CheckDoxygenTripleForwardSlash(FullName)
+            self.CheckFiles(c.CheckDoxygenTripleForwardSlash, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Check whether only Doxygen commands allowed to mark the code are @bug and @todo.
     def DoxygenCheckCommand(self):
@@ -780,8 +855,7 @@ class Check(object):
 #                    if os.path.splitext(F)[1] in ('.h', '.c'):
 #                        FullName = os.path.join(Dirpath, F)
 #                        MsgList = c.CheckDoxygenCommand(FullName)
-            for FullName in EccGlobalData.gCFileList + EccGlobalData.gHFileList:
-                MsgList = c.CheckDoxygenCommand(FullName)
+            self.CheckFiles(c.CheckDoxygenCommand, EccGlobalData.gCFileList + EccGlobalData.gHFileList)
 
     # Meta-Data File Processing Checking
     def MetaDataFileCheck(self):
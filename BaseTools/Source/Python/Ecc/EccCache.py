@@ -0,0 +1,194 @@
+## @file
+# This file is used to keep the parse results and the check reports of ECC across runs
+#
+# The functions and identifiers parsed from a C source or header file only
+# depend on the content of the file and the token replacement list, so they
+# are saved in the Parse directory of the cache, keyed by the hash of both.
+# The reports of a per-file check in c.py also depend on the files included
+# by the file, the configuration and the exception list. They are saved in
+# the Check file of the cache with the hash of all of them, and reused as long
+# as the hash is unchanged.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import Common.LongFilePathOs as os
+import pickle
+import time
+import uuid
+from hashlib import md5
+
+import Common.EdkLogger as EdkLogger
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+## The parse results not used for this long are removed, in seconds
+PARSE_RESULT_LIFETIME = 30 * 24 * 3600
+
+## EccCache
+#
+# The parse results are read and written by the parser processes, one file
+# each. The check reports are only used by the main process, which loads them
+# on first use and saves them at the end of the run.
+#
+# @param CacheDir:        The directory of the cache
+# @param ConfigFileList:  The files whose content the check reports depend on
+#
+class EccCache(object):
+    # Change it whenever the parser or the layout of the results changes
+    _VERSION_ = 1
+
+    def __init__(self, CacheDir, ConfigFileList=()):
+        self.CacheDir = CacheDir
+        self._ParseDir = os.path.join(CacheDir, 'Parse')
+        self._CheckFile = os.path.join(CacheDir, 'Check')
+        self._FileDigest = {}
+        self._ConfigDigest = md5(str(self._VERSION_).encode())
+        for File in ConfigFileList:
+            self._ConfigDigest.update(File.encode('utf-8', 'ignore'))
+            self._ConfigDigest.update((self.FileDigest(File) or '').encode())
+        self._ConfigDigest = self._ConfigDigest.hexdigest()
+        self._Checks = None
+        self._UsedParseKeys = set()
+        self.ParseCount = 0
+        self.ParseHitCount = 0
+        self.CheckCount = 0
+        self.CheckHitCount = 0
+
+    ## Get the hash of the content of a file, None if it can't be read
+    def FileDigest(self, Path):
+        if Path not in self._FileDigest:
+            try:
+                with open(Path, 'rb') as Fd:
+                    self._FileDigest[Path] = md5(Fd.read()).hexdigest()
+            except IOError:
+                self._FileDigest[Path] = None
+        return self._FileDigest[Path]
+
+    ## Write an object into a file of the cache, through a temporary file so
+    #  that the processes reading it never see a partial one
+    @staticmethod
+    def _Dump(Path, Object):
+        TempPath = "%s.%s" % (Path, uuid.uuid4().hex)
+        try:
+            Dir = os.path.dirname(Path)
+            if not os.path.isdir(Dir):
+                os.makedirs(Dir)
+            with open(TempPath, 'wb') as Fd:
+                pickle.dump(Object, Fd, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempPath, Path)
+        except (IOError, OSError, pickle.PicklingError):
+            EdkLogger.verbose("Failed to save %s" % Path)
+            if os.path.exists(TempPath):
+                os.remove(TempPath)
+
+    ## Get the key of the parse result of a file
+    #
+    # @param FullName:          The path of the file
+    # @param TokenReleaceList:  The token replacement list of the parser
+    #
+    # @retval str               The key, None if the file can't be read
+    #
+    def ParseKey(self, FullName, TokenReleaceList):
+        Digest = self.FileDigest(FullName)
+        if Digest is None:
+            return None
+        return md5(("%s\0%s\0%s" % (self._VERSION_, Digest, "\0".join(TokenReleaceList))).encode('utf-8', 'ignore')).hexdigest()
+
+    def _ParsePath(self, Key):
+        return os.path.join(self._ParseDir, Key[:2], Key)
+
+    ## Get a saved parse result, None if there is none
+    def GetParseResult(self, Key):
+        try:
+            with open(self._ParsePath(Key), 'rb') as Fd:
+                return pickle.load(Fd)
+        except Exception:
+            return None
+
+    ## Save a parse result
+    def SetParseResult(self, Key, Result):
+        self._Dump(self._ParsePath(Key), Result)
+
+    ## Count a parse result taken by the main process
+    def AddParseResult(self, Key, Hit):
+        self.ParseCount += 1
+        if Hit:
+            self.ParseHitCount += 1
+        if Key:
+            self._UsedParseKeys.add(Key)
+
+    ## Remove the parse results neither used in this run nor for a long time
+    def PruneParseResults(self):
+        Expired = time.time() - PARSE_RESULT_LIFETIME
+        for Root, Dirs, Files in os.walk(self._ParseDir):
+            for File in Files:
+                Path = os.path.join(Root, File)
+                try:
+                    if File not in self._UsedParseKeys and os.path.getmtime(Path) < Expired:
+                        os.remove(Path)
+                except OSError:
+                    pass
+
+    ## Get the key of the check reports of a file
+    #
+    # @param FullName:          The path of the file
+    # @param IncludeFileList:   The files included by the file, directly or not
+    # @param IncludePathList:   The directories the included files are searched in
+    #
+    # @retval str               The key, None if a file can't be read
+    #
+    def CheckKey(self, FullName, IncludeFileList, IncludePathList=()):
+        Key = md5(("%s\0%s\0%s" % (self._ConfigDigest, FullName, "\0".join(IncludePathList))).encode('utf-8', 'ignore'))
+        for File in [FullName] + list(IncludeFileList):
+            Digest = self.FileDigest(File)
+            if Digest is None:
+                return None
+            Key.update(("\0%s\0%s" % (File, Digest)).encode('utf-8', 'ignore'))
+        return Key.hexdigest()
+
+    def _LoadChecks(self):
+        if self._Checks is None:
+            self._Checks = {}
+            try:
+                with open(self._CheckFile, 'rb') as Fd:
+                    Version, Checks = pickle.load(Fd)
+                if Version == self._VERSION_:
+                    self._Checks = Checks
+            except Exception:
+                pass
+        return self._Checks
+
+    ## Get the saved reports of a check of a file, None if there are none
+    #
+    # @param FullName:          The path of the file
+    # @param Key:               The key of the check reports of the file
+    # @param CheckName:         The name of the check
+    #
+    def GetCheckReports(self, FullName, Key, CheckName):
+        self.CheckCount += 1
+        Entry = self._LoadChecks().get(FullName)
+        if Entry is None or Entry[0] != Key or CheckName not in Entry[1]:
+            return None
+        self.CheckHitCount += 1
+        return Entry[1][CheckName]
+
+    ## Save the reports of a check of a file
+    def SetCheckReports(self, FullName, Key, CheckName, Reports):
+        Checks = self._LoadChecks()
+        Entry = Checks.get(FullName)
+        if Entry is None or Entry[0] != Key:
+            Entry = Checks[FullName] = (Key, {})
+        Entry[1][CheckName] = Reports
+
+    ## Save the check reports
+    def Save(self):
+        if self._Checks is not None:
+            self._Dump(self._CheckFile, (self._VERSION_, self._Checks))
+
+    def Summary(self):
+        return "%d of %d source files loaded from cache, %d of %d file checks reused" % \
+               (self.ParseHitCount, self.ParseCount, self.CheckHitCount, self.CheckCount)
@@ -19,3 +19,5 @@ gCFileList = []
 gHFileList = []
 gUFileList = []
 gException = None
+gCache = None
+gJobs = 1
@@ -11,6 +11,7 @@
 #
 from __future__ import absolute_import
 import Common.LongFilePathOs as os, time, glob, sys
+import multiprocessing
 import Common.EdkLogger as EdkLogger
 from Ecc import Database
 from Ecc import EccGlobalData
@@ -18,6 +19,7 @@ from Ecc.MetaDataParser import *
 from optparse import OptionParser
 from Ecc.Configuration import Configuration
 from Ecc.Check import Check
+from Ecc.EccCache import EccCache
 import Common.GlobalData as GlobalData
 
 from Common.StringUtils import NormPath
@@ -58,6 +60,10 @@ class Ecc(object):
         self.ScanMetaData = True
         self.MetaFile = ''
         self.OnlyScan = None
+        self.Jobs = multiprocessing.cpu_count()
+        self.CacheDir = os.path.abspath('EccCache')
+        # The time spent by each step, in seconds
+        self.TimeList = []
 
         # Parse the options and args
         self.ParseOption()
@@ -81,6 +87,11 @@ class Ecc(object):
         # Generate exception list
         EccGlobalData.gException = ExceptionCheck(self.ExceptionFile)
 
+        # Init the cache of the parse results and check reports
+        EccGlobalData.gJobs = self.Jobs
+        if self.CacheDir is not None:
+            EccGlobalData.gCache = EccCache(self.CacheDir, (self.ConfigFile, self.ExceptionFile))
+
         # Init Ecc database
         EccGlobalData.gDb = Database.Database(Database.DATABASE_PATH)
         EccGlobalData.gDb.InitDatabase(self.IsInit)
@@ -99,6 +110,12 @@ class Ecc(object):
 
         # Show report
         self.GenReport()
+        self.ShowTimeReport()
+
+        # Save cache
+        if EccGlobalData.gCache is not None:
+            EccGlobalData.gCache.Save()
+            EccGlobalData.gCache.PruneParseResults()
 
         # Close Database
         EccGlobalData.gDb.Close()
@@ -144,14 +161,18 @@ class Ecc(object):
         if self.IsInit:
             if self.ScanMetaData:
                 EdkLogger.quiet("Building database for Meta Data File ...")
+                StartTime = time.perf_counter()
                 self.BuildMetaDataFileDatabase(SpeciDirs)
+                self.TimeList.append(("MetaDataFileParse", time.perf_counter() - StartTime))
             if self.ScanSourceCode:
                 EdkLogger.quiet("Building database for Meta Data File Done!")
+                StartTime = time.perf_counter()
                 if SpeciDirs is None:
                     c.CollectSourceCodeDataIntoDB(EccGlobalData.gTarget)
                 else:
                     for specificDir in SpeciDirs:
                         c.CollectSourceCodeDataIntoDB(os.path.join(EccGlobalData.gTarget, specificDir))
+                self.TimeList.append(("SourceCodeParse", time.perf_counter() - StartTime))
 
         EccGlobalData.gIdentifierTableList = GetTableList((MODEL_FILE_C, MODEL_FILE_H), 'Identifier', EccGlobalData.gDb)
         EccGlobalData.gCFileList = GetFileList(MODEL_FILE_C, EccGlobalData.gDb)
@@ -246,6 +267,7 @@ class Ecc(object):
         EdkLogger.quiet("Checking ...")
         EccCheck = Check()
         EccCheck.Check()
+        self.TimeList.extend(EccCheck.TimeList)
         EdkLogger.quiet("Checking  done!")
 
     ##
@@ -257,6 +279,17 @@ class Ecc(object):
         EccGlobalData.gDb.TblReport.ToCSV(self.ReportFile)
         EdkLogger.quiet("Generating report done!")
 
+    ##
+    #
+    # Show the time spent by each step and how much the cache saved
+    #
+    def ShowTimeReport(self):
+        EdkLogger.quiet("\nTime spent by each step:")
+        for Name, Duration in self.TimeList:
+            EdkLogger.quiet("  %-28s %8.2fs" % (Name, Duration))
+        if EccGlobalData.gCache is not None:
+            EdkLogger.quiet(EccGlobalData.gCache.Summary())
+
     def GetRealPathCase(self, path):
         TmpPath = path.rstrip(os.sep)
         PathParts = TmpPath.split(os.sep)
@@ -341,6 +374,14 @@ class Ecc(object):
             self.ScanMetaData = False
         if Options.folders is not None:
             self.OnlyScan = True
+        if Options.Jobs is not None:
+            if Options.Jobs < 1:
+                EdkLogger.error("ECC", BuildToolError.OPTION_VALUE_INVALID, ExtraData="The number of jobs must be at least 1")
+            self.Jobs = Options.Jobs
+        if Options.CacheDir is not None:
+            self.CacheDir = os.path.abspath(Options.CacheDir)
+        if Options.NoCache is not None:
+            self.CacheDir = None
 
     ## SetLogLevel
     #
@@ -392,6 +433,12 @@ class Ecc(object):
         Parser.add_option("-d", "--debug", action="store", type="int", help="Enable debug messages at specified level.")
         Parser.add_option("-w", "--workspace", action="store", type="string", dest='Workspace', help="Specify workspace.")
         Parser.add_option("-f", "--folders", action="store_true", type=None, help="Only scanning specified folders which are recorded in config.ini file.")
+        Parser.add_option("-j", "--jobs", action="store", type="int", dest="Jobs",
+            help="Number of processes parsing the C source files. Defaultly use the number of processors.")
+        Parser.add_option("--cache-dir", action="store", type="string", dest="CacheDir",
+            help="Specify the directory of the cache of parse results and check reports. Defaultly use EccCache in the current directory.")
+        Parser.add_option("--no-cache", action="store_true", type=None, dest="NoCache",
+            help="Parse and check all files again without using or updating the cache.")
 
         (Opt, Args)=Parser.parse_args()
 
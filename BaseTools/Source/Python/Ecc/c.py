@@ -12,6 +12,7 @@ import sys
 import Common.LongFilePathOs as os
 import re
 import string
+import multiprocessing
 from Ecc import CodeFragmentCollector
 from Ecc import FileProfile
 from CommonDataClass import DataClass
@@ -27,6 +28,7 @@ IncludePathListDict = {}
 ComplexTypeDict = {}
 SUDict = {}
 IgnoredKeywordList = ['EFI_ERROR']
+ParseTokenReleaceList = []
 
 def GetIgnoredDirListPattern():
     skipList = list(EccGlobalData.gConfig.SkipDirList) + ['.svn']
@@ -493,6 +495,55 @@ def GetFileModificationTimeFromDB(FullFileName):
         TimeValue = Result[0]
     return TimeValue
 
+## Initialize a parser process of CollectSourceCodeDataIntoDB
+#
+# @param TokenReleaceList:  The token replacement list of the parser
+# @param CacheDir:          The directory of the cache, None if not used
+#
+def InitParseWorker(TokenReleaceList, CacheDir):
+    global ParseTokenReleaceList
+    ParseTokenReleaceList = TokenReleaceList
+    if EccGlobalData.gCache is None and CacheDir is not None:
+        from Ecc.EccCache import EccCache
+        EccGlobalData.gCache = EccCache(CacheDir)
+
+## Parse a C source or header file
+#
+# The functions and identifiers found are returned instead of being left in
+# FileProfile, so that the file can be parsed in another process. The result
+# is taken from the cache if the file was parsed before.
+#
+# @param FullName:  The path of the file
+#
+# @retval tuple     The function list, the identifier list, whether the file
+#                   failed to parse with preprocessor directives, the key of
+#                   the result in the cache and whether it was found there
+#
+def ParseSourceFile(FullName):
+    Cache = EccGlobalData.gCache
+    Key = None
+    if Cache is not None:
+        Key = Cache.ParseKey(FullName, ParseTokenReleaceList)
+        if Key is not None:
+            Result = Cache.GetParseResult(Key)
+            if Result is not None:
+                return Result + (Key, True)
+
+    collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
+    collector.TokenReleaceList = ParseTokenReleaceList
+    ParseError = False
+    try:
+        collector.ParseFile()
+    except UnicodeError:
+        ParseError = True
+        collector.CleanFileProfileBuffer()
+        collector.ParseFileWithClearedPPDirective()
+    Result = (GetFunctionList(), GetIdentifierList(), ParseError)
+    collector.CleanFileProfileBuffer()
+    if Key is not None:
+        Cache.SetParseResult(Key, Result)
+    return Result + (Key, False)
+
 def CollectSourceCodeDataIntoDB(RootDir):
     FileObjList = []
     tuple = os.walk(RootDir)
@@ -500,6 +551,7 @@ def CollectSourceCodeDataIntoDB(RootDir):
     ParseErrorFileList = []
     TokenReleaceList = EccGlobalData.gConfig.TokenReleaceList
     TokenReleaceList.extend(['L",\\\""'])
+    FileList = []
 
     for dirpath, dirnames, filenames in tuple:
         if IgnoredPattern.match(dirpath.upper()):
@@ -517,29 +569,46 @@ def CollectSourceCodeDataIntoDB(RootDir):
         for f in filenames:
             if f.lower() in EccGlobalData.gConfig.SkipFileList:
                 continue
-            collector = None
-            FullName = os.path.normpath(os.path.join(dirpath, f))
+            FileList.append(os.path.normpath(os.path.join(dirpath, f)))
+
+    #
+    # The C source and header files are parsed by a pool of processes, and
+    # the results are taken in the order of the files
+    #
+    SourceFileList = [FullName for FullName in FileList if os.path.splitext(FullName)[1] in ('.h', '.c')]
+    CacheDir = EccGlobalData.gCache.CacheDir if EccGlobalData.gCache is not None else None
+    Pool = None
+    if EccGlobalData.gJobs > 1 and len(SourceFileList) > 1:
+        Pool = multiprocessing.Pool(EccGlobalData.gJobs, InitParseWorker, (TokenReleaceList, CacheDir))
+        ChunkSize = max(1, len(SourceFileList) // (EccGlobalData.gJobs * 8))
+        ResultIter = Pool.imap(ParseSourceFile, SourceFileList, ChunkSize)
+    else:
+        InitParseWorker(TokenReleaceList, CacheDir)
+        ResultIter = map(ParseSourceFile, SourceFileList)
+
+    try:
+        for FullName in FileList:
+            FunctionList = []
+            IdentifierList = []
             model = DataClass.MODEL_FILE_OTHERS
-            if os.path.splitext(f)[1] in ('.h', '.c'):
+            if os.path.splitext(FullName)[1] in ('.h', '.c'):
                 EdkLogger.info("Parsing " + FullName)
-                model = f.endswith('c') and DataClass.MODEL_FILE_C or DataClass.MODEL_FILE_H
-                collector = CodeFragmentCollector.CodeFragmentCollector(FullName)
-                collector.TokenReleaceList = TokenReleaceList
-                try:
-                    collector.ParseFile()
-                except UnicodeError:
+                model = FullName.endswith('c') and DataClass.MODEL_FILE_C or DataClass.MODEL_FILE_H
+                FunctionList, IdentifierList, ParseError, Key, Hit = next(ResultIter)
+                if ParseError:
                     ParseErrorFileList.append(FullName)
-                    collector.CleanFileProfileBuffer()
-                    collector.ParseFileWithClearedPPDirective()
-#                collector.PrintFragments()
-            BaseName = os.path.basename(f)
+                if EccGlobalData.gCache is not None:
+                    EccGlobalData.gCache.AddParseResult(Key, Hit)
+            BaseName = os.path.basename(FullName)
             DirName = os.path.dirname(FullName)
-            Ext = os.path.splitext(f)[1].lstrip('.')
+            Ext = os.path.splitext(FullName)[1].lstrip('.')
             ModifiedTime = os.path.getmtime(FullName)
-            FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, GetFunctionList(), GetIdentifierList(), [])
+            FileObj = DataClass.FileClass(-1, BaseName, Ext, DirName, FullName, model, ModifiedTime, FunctionList, IdentifierList, [])
             FileObjList.append(FileObj)
-            if collector:
-                collector.CleanFileProfileBuffer()
+    finally:
+        if Pool is not None:
+            Pool.close()
+            Pool.join()
 
     if len(ParseErrorFileList) > 0:
         EdkLogger.info("Found unrecoverable error during parsing:\n\t%s\n" % "\n\t".join(ParseErrorFileList))
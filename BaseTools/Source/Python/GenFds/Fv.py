@@ -143,6 +143,7 @@ class FV (object):
             FvOutputFile = self.CreateFileName
 
         if Flag:
+            GenFdsGlobalVariable.FvFfsDict[self.UiFvName.upper()] = FfsFileList
             GenFdsGlobalVariable.ImageBinDict[self.UiFvName.upper() + 'fv'] = FvOutputFile
             return FvOutputFile
 
@@ -0,0 +1,318 @@
+## @file
+# Build independent FV images concurrently
+#
+# The scheduler replays the order GenFds.GenFd generates FD regions, FVs and
+# capsules in, and plans one job per FV that the serial pass would build:
+#   1. An FV in an FD region is built at the region address.
+#   2. An FV that is only referenced through an FV image section or a FILE
+#      statement, and so would be taken from ImageBinDict once it is built,
+#      is built as a job of its own before the first job that references it.
+#      Its compressed or GUIDed FV image sections are then generated by the
+#      referencing jobs in parallel with the other jobs.
+#   3. The other FVs and the FVs of capsules are built without address.
+# Two jobs that generate the same module, FILE statement or nested FV are run
+# in the planned order; all the others run concurrently in forked processes.
+# The serial pass then takes the FVs from ImageBinDict and only assembles the
+# FD and capsule images. Planning stops at the first object whose FVs can not
+# be planned this way, such as an FD inside an FV; the serial pass builds the
+# rest as before.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import absolute_import
+import multiprocessing
+import time
+import traceback
+from io import BytesIO
+from multiprocessing.connection import wait
+
+import Common.LongFilePathOs as os
+from Common import EdkLogger
+from Common.BuildTrace import gBuildTrace
+from Common.BuildToolError import FatalError, GENFDS_ERROR, CODE_ERROR
+from Common.DataType import BINARY_FILE_TYPE_FV
+from .GenFdsGlobalVariable import GenFdsGlobalVariable
+from .FfsFileStatement import FileStatement
+from .FfsInfStatement import FfsInfStatement
+from .FvImageSection import FvImageSection
+from .CapsuleData import CapsuleFv, CapsuleFd
+
+## One FV to build
+#
+class FvJob(object):
+    def __init__(self, FvObj, BaseAddress=None, ErasePolarity='1', RegionObj=None, BlockSizeList=None, CapsuleName=None):
+        self.Fv = FvObj
+        self.BaseAddress = BaseAddress
+        self.ErasePolarity = ErasePolarity
+        self.RegionObj = RegionObj
+        self.BlockSizeList = BlockSizeList
+        self.CapsuleName = CapsuleName
+        self.Resources = set()
+        self.DependList = []
+
+    def __str__(self):
+        if self.BaseAddress is not None:
+            return "%s at %s" % (self.Fv.UiFvName, self.BaseAddress)
+        return self.Fv.UiFvName
+
+    ## Build the FV in a child process and report the FVs added to ImageBinDict
+    #
+    #   @param  Conn        Pipe connection to send (ReturnCode, {FvName: (File, FvAlignment)})
+    #
+    def Run(self, Conn):
+        ReturnCode = 0
+        Result = {}
+        Before = set(GenFdsGlobalVariable.ImageBinDict)
+        Start = time.time()
+        gBuildTrace.SetProcessName("GenFds %s" % self)
+        try:
+            if self.RegionObj is not None:
+                self.RegionObj.BlockInfoOfRegion(self.BlockSizeList, self.Fv)
+            self.Fv.CapsuleName = self.CapsuleName
+            Buffer = BytesIO()
+            if self.BaseAddress is not None:
+                self.Fv.AddToBuffer(Buffer, self.BaseAddress, None, None, self.ErasePolarity)
+            else:
+                self.Fv.AddToBuffer(Buffer)
+            Buffer.close()
+            FvDict = GenFdsGlobalVariable.FdfParser.Profile.FvDict
+            for Key in set(GenFdsGlobalVariable.ImageBinDict) - Before:
+                if Key.endswith('fv') and Key[:-2] in FvDict:
+                    Result[Key[:-2]] = (GenFdsGlobalVariable.ImageBinDict[Key], FvDict[Key[:-2]].FvAlignment)
+        except FatalError as X:
+            ReturnCode = X.args[0]
+        except:
+            EdkLogger.quiet(traceback.format_exc())
+            ReturnCode = CODE_ERROR
+        gBuildTrace.Add("FV %s" % self, "genfds", Start, time.time(), task="FV %s" % self,
+                        deps=["FV %s" % Depend for Depend in self.DependList])
+        gBuildTrace.Flush()
+        Conn.send((ReturnCode, Result))
+        Conn.close()
+
+## Plan and run the FV jobs
+#
+class FvScheduler(object):
+    def __init__(self, ThreadNumber):
+        self.FvDict = GenFdsGlobalVariable.FdfParser.Profile.FvDict
+        self.FdDict = GenFdsGlobalVariable.FdfParser.Profile.FdDict
+        self.CapsuleDict = GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict
+        self.ThreadNumber = ThreadNumber
+        self.JobList = []
+        # FVs in ImageBinDict once the planned jobs are done
+        self.Planned = set()
+        self.Stopped = False
+
+    ## Get the FVs referenced by the FILE statements of an FV
+    #
+    #   @retval list        [(FvName, Cached)], Cached is True if the reference
+    #                       is satisfied from ImageBinDict
+    #   @retval None        The references can not be planned
+    #
+    def _GetFvReferences(self, FvObj):
+        RefList = []
+        for Ffs in FvObj.FfsList:
+            if isinstance(Ffs, FileStatement):
+                if Ffs.FdName:
+                    return None
+                if Ffs.FvName:
+                    RefList.append((Ffs.FvName.upper(), True))
+            SectionList = list(getattr(Ffs, 'SectionList', []) or [])
+            while SectionList:
+                Section = SectionList.pop()
+                if isinstance(Section, FvImageSection) and Section.FvName is not None:
+                    Nested = self.FvDict.get(Section.FvName)
+                    if Nested is None:
+                        return None
+                    RefList.append((Section.FvName.upper(), not Section.FvAddr and not Nested.BaseAddress))
+                SectionList.extend(getattr(Section, 'SectionList', []) or [])
+        for Name, _ in RefList:
+            if Name not in self.FvDict:
+                return None
+        return RefList
+
+    ## Get the module and FILE statement outputs an FV generates
+    def _GetFfsResources(self, FvObj):
+        Resources = set()
+        for Ffs in FvObj.FfsList:
+            if isinstance(Ffs, FfsInfStatement):
+                Resources.add(('inf', os.path.normcase(os.path.normpath(str(Ffs.InfFileName)))))
+            elif isinstance(Ffs, FileStatement):
+                Resources.add(('file', str(Ffs.NameGuid).upper()))
+        return Resources
+
+    ## Expand the references of an FV built in a job
+    #
+    # The references taken from ImageBinDict become jobs of their own, the
+    # others are built in the same job and add their outputs to its resources.
+    #
+    #   @param  InRegion    The FV is built at an address, so that it builds the
+    #                       nested FVs again at their addresses
+    #
+    #   @retval False       The FV can not be planned
+    #
+    def _Expand(self, FvObj, Job, InRegion, Visited):
+        Name = FvObj.UiFvName.upper()
+        if Name in Visited:
+            return True
+        Visited.add(Name)
+        Job.Resources.add(('fv', Name))
+        Job.Resources |= self._GetFfsResources(FvObj)
+        RefList = self._GetFvReferences(FvObj)
+        if RefList is None:
+            return False
+        for RefName, Cached in RefList:
+            Job.Resources.add(('fv', RefName))
+            if Cached and RefName not in self.Planned:
+                if not self.AddFv(RefName):
+                    return False
+            if not Cached or InRegion:
+                if not self._Expand(self.FvDict[RefName], Job, InRegion, Visited):
+                    return False
+                self.Planned.add(RefName)
+        return True
+
+    ## Plan a job for an FV
+    #
+    #   @retval False       Planning is stopped
+    #
+    def _AddJob(self, Job):
+        if self.Stopped:
+            return False
+        if not self._Expand(Job.Fv, Job, Job.BaseAddress is not None, set()):
+            self.Stopped = True
+            return False
+        self.Planned.add(Job.Fv.UiFvName.upper())
+        self.JobList.append(Job)
+        return True
+
+    ## Plan an FV built without address
+    def AddFv(self, Name, CapsuleName=None):
+        if self.Stopped:
+            return False
+        Name = Name.upper()
+        if Name in self.Planned:
+            return True
+        if Name not in self.FvDict:
+            self.Stopped = True
+            return False
+        return self._AddJob(FvJob(self.FvDict[Name], CapsuleName=CapsuleName))
+
+    ## Plan the FVs of the FD regions
+    #
+    # Only the first FV generated in a region is planned: the address of the
+    # next one depends on the size of the previous one.
+    #
+    def AddFd(self, FdObj):
+        HasCapsuleRegion = False
+        for RegionObj in FdObj.RegionList:
+            if RegionObj.RegionType == 'CAPSULE':
+                HasCapsuleRegion = True
+                continue
+            if RegionObj.RegionType != BINARY_FILE_TYPE_FV:
+                continue
+            Generated = False
+            for RegionData in RegionObj.RegionDataList:
+                if RegionData.endswith(".fv") or RegionData.upper() in self.Planned:
+                    continue
+                FvObj = self.FvDict.get(RegionData.upper())
+                if self.Stopped or FvObj is None or Generated:
+                    self.Stopped = True
+                    return False
+                Address = int(FdObj.BaseAddress, 16) + RegionObj.Offset
+                FvAlignValue = GenFdsGlobalVariable.GetAlignment(FvObj.FvAlignment)
+                if not FvAlignValue or Address % FvAlignValue != 0:
+                    self.Stopped = True
+                    return False
+                if not self._AddJob(FvJob(FvObj, '0x%X' % Address, FdObj.ErasePolarity, RegionObj, FdObj.BlockSizeList)):
+                    return False
+                Generated = True
+        #
+        # The capsule regions are generated after all the FV regions.
+        #
+        if HasCapsuleRegion:
+            self.Stopped = True
+            return False
+        return True
+
+    ## Plan the FVs of a capsule
+    def AddCapsule(self, CapsuleObj):
+        if CapsuleObj.FmpPayloadList:
+            self.Stopped = True
+            return False
+        for CapsuleDataObj in CapsuleObj.CapsuleDataList:
+            if isinstance(CapsuleDataObj, CapsuleFd):
+                self.Stopped = True
+                return False
+            if isinstance(CapsuleDataObj, CapsuleFv) and CapsuleDataObj.FvName.find('.fv') == -1:
+                if not self.AddFv(CapsuleDataObj.FvName, CapsuleObj.CapsuleName):
+                    return False
+        return True
+
+    ## Make each job depend on the jobs planned before it that share a resource
+    def LinkJobs(self):
+        for Index, Job in enumerate(self.JobList):
+            Job.DependList = [Previous for Previous in self.JobList[:Index] if Job.Resources & Previous.Resources]
+
+    ## Run the planned jobs
+    #
+    # Each job is forked when the jobs it depends on are done, so that it sees
+    # the FVs they built in ImageBinDict.
+    #
+    def Run(self):
+        if self.ThreadNumber <= 1 or len(self.JobList) < 2:
+            return
+        try:
+            Context = multiprocessing.get_context('fork')
+        except ValueError:
+            return
+
+        self.LinkJobs()
+        GenFdsGlobalVariable.InfLogger("\nGenerating %d FVs with %d processes" % (len(self.JobList), self.ThreadNumber))
+
+        Pending = list(self.JobList)
+        Done = set()
+        Running = {}
+        Failed = None
+        while Pending or Running:
+            #
+            # A job only depends on the jobs planned before it, so the first
+            # pending job can always be started when nothing is running.
+            #
+            for Job in list(Pending):
+                if Failed is not None or len(Running) >= self.ThreadNumber:
+                    break
+                if all(Depend in Done for Depend in Job.DependList):
+                    Pending.remove(Job)
+                    Reader, Writer = Context.Pipe(duplex=False)
+                    Process = Context.Process(target=Job.Run, args=(Writer,), name=str(Job))
+                    Process.start()
+                    Writer.close()
+                    Running[Reader] = (Job, Process)
+            if not Running:
+                break
+            for Reader in wait(list(Running)):
+                Job, Process = Running.pop(Reader)
+                try:
+                    ReturnCode, Result = Reader.recv()
+                except EOFError:
+                    ReturnCode, Result = CODE_ERROR, None
+                Reader.close()
+                Process.join()
+                if ReturnCode != 0:
+                    Failed = Failed or (ReturnCode, Job)
+                    continue
+                for Name, (FileName, FvAlignment) in Result.items():
+                    GenFdsGlobalVariable.ImageBinDict[Name + 'fv'] = FileName
+                    if FvAlignment is not None:
+                        self.FvDict[Name].FvAlignment = FvAlignment
+                Done.add(Job)
+
+        if Failed is not None:
+            ReturnCode, Job = Failed
+            EdkLogger.error("GenFds", ReturnCode, "Failed to generate FV %s" % Job)
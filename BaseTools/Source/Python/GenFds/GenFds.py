@@ -20,6 +20,7 @@ from linecache import getlines
 from io import BytesIO
 
 import Common.LongFilePathOs as os
+import multiprocessing
 from Common.TargetTxtClassObject import TargetTxtDict,gDefaultTargetTxtFile
 from Common.DataType import *
 import Common.GlobalData as GlobalData
@@ -35,6 +36,8 @@ from Workspace.WorkspaceDatabase import WorkspaceDatabase
 from .FdfParser import FdfParser, Warning
 from .GenFdsGlobalVariable import GenFdsGlobalVariable
 from .FfsFileStatement import FileStatement
+from .FvImageSection import FvImageSection
+from .FvScheduler import FvScheduler
 import Common.DataType as DataType
 from struct import Struct
 
@@ -90,10 +93,12 @@ def resetFdsGlobalVariable():
     GenFdsGlobalVariable.__BuildRuleDatabase = None
     GenFdsGlobalVariable.GuidToolDefinition = {}
     GenFdsGlobalVariable.FfsCmdDict = {}
+    GenFdsGlobalVariable.FvFfsDict = {}
     GenFdsGlobalVariable.SecCmdList = []
     GenFdsGlobalVariable.CopyList   = []
     GenFdsGlobalVariable.ModuleFile = ''
     GenFdsGlobalVariable.EnableGenfdsMultiThread = True
+    GenFdsGlobalVariable.ThreadNumber = 1
 
     GenFdsGlobalVariable.LargeFileInFvFlags = []
     GenFdsGlobalVariable.EFI_FIRMWARE_FILE_SYSTEM3_GUID = '5473C07A-3DCB-4dca-BD6F-1E9689E7349A'
@@ -142,6 +147,10 @@ def GenFdsApi(FdsCommandDict, WorkSpaceDataBase=None):
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = True
             else:
                 GenFdsGlobalVariable.EnableGenfdsMultiThread = False
+            if FdsCommandDict.get("thread_number"):
+                GenFdsGlobalVariable.ThreadNumber = FdsCommandDict.get("thread_number")
+            else:
+                GenFdsGlobalVariable.ThreadNumber = multiprocessing.cpu_count()
         os.chdir(GenFdsGlobalVariable.WorkSpaceDir)
 
         # set multiple workspace
@@ -407,6 +416,7 @@ def OptionsToCommandDict(Options):
     FdsCommandDict["debug"] = Options.debug
     FdsCommandDict["Workspace"] = Options.Workspace
     FdsCommandDict["GenfdsMultiThread"] = not Options.NoGenfdsMultiThread
+    FdsCommandDict["thread_number"] = Options.ThreadNumber
     FdsCommandDict["fdf_file"] = [PathClass(Options.filename)] if Options.filename else []
     FdsCommandDict["build_target"] = Options.BuildTarget
     FdsCommandDict["toolchain_tag"] = Options.ToolChain
@@ -465,6 +475,7 @@ def myOptionParser():
     Parser.add_option("--pcd", action="append", dest="OptionPcd", help="Set PCD value by command line. Format: \"PcdName=Value\" ")
     Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
     Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+    Parser.add_option("-n", "--thread-number", action="store", type="int", dest="ThreadNumber", help="Build the independent FV images with the specified number of processes. The number of processors is used by default, 1 builds them one by one.")
 
     Options, _ = Parser.parse_args()
     return Options
@@ -494,6 +505,7 @@ class GenFds(object):
         GenFdsGlobalVariable.SetDir ('', FdfParserObject, WorkSpace, ArchList)
 
         GenFdsGlobalVariable.VerboseLogger(" Generate all Fd images and their required FV and Capsule images!")
+        GenFds.GenFvInParallel()
         if GenFds.OnlyGenerateThisCap is not None and GenFds.OnlyGenerateThisCap.upper() in GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict:
             CapsuleObj = GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict[GenFds.OnlyGenerateThisCap.upper()]
             if CapsuleObj is not None:
@@ -534,6 +546,33 @@ class GenFds(object):
                 for OptRomObj in GenFdsGlobalVariable.FdfParser.Profile.OptRomDict.values():
                     OptRomObj.AddToBuffer(None)
 
+    ## GenFvInParallel()
+    #
+    #   Build the FVs that GenFd needs, independent ones concurrently, in the
+    #   order GenFd would build them
+    #
+    @staticmethod
+    def GenFvInParallel():
+        Profile = GenFdsGlobalVariable.FdfParser.Profile
+        Scheduler = FvScheduler(GenFdsGlobalVariable.ThreadNumber)
+        if GenFds.OnlyGenerateThisCap is not None and GenFds.OnlyGenerateThisCap.upper() in Profile.CapsuleDict:
+            Scheduler.AddCapsule(Profile.CapsuleDict[GenFds.OnlyGenerateThisCap.upper()])
+        elif GenFds.OnlyGenerateThisFd is not None and GenFds.OnlyGenerateThisFd.upper() in Profile.FdDict:
+            Scheduler.AddFd(Profile.FdDict[GenFds.OnlyGenerateThisFd.upper()])
+        else:
+            if GenFds.OnlyGenerateThisFd is None and GenFds.OnlyGenerateThisFv is None:
+                for FdObj in Profile.FdDict.values():
+                    Scheduler.AddFd(FdObj)
+            if GenFds.OnlyGenerateThisFv is not None and GenFds.OnlyGenerateThisFv.upper() in Profile.FvDict:
+                Scheduler.AddFv(GenFds.OnlyGenerateThisFv)
+            elif GenFds.OnlyGenerateThisFv is None:
+                for FvObj in Profile.FvDict.values():
+                    Scheduler.AddFv(FvObj.UiFvName)
+                if GenFds.OnlyGenerateThisFd is None and GenFds.OnlyGenerateThisCap is None:
+                    for CapsuleObj in Profile.CapsuleDict.values():
+                        Scheduler.AddCapsule(CapsuleObj)
+        Scheduler.Run()
+
     @staticmethod
     def GenFfsMakefile(OutputDir, FdfParserObject, WorkSpace, ArchList, GlobalData):
         GenFdsGlobalVariable.SetEnv(FdfParserObject, WorkSpace, ArchList, GlobalData)
@@ -549,6 +588,70 @@ class GenFds(object):
 
         return GenFdsGlobalVariable.FfsCmdDict
 
+    ## GetImageFfsList()
+    #
+    #   Get the FD images and the FV images outside the FD regions, with the
+    #   module FFS files they are generated from, after GenFfsMakefile
+    #
+    #   @retval list            [(Option, Name, ImageFile, FfsFileList)], Option
+    #                           is the GenFds option generating only this image
+    #
+    @staticmethod
+    def GetImageFfsList():
+        Profile = GenFdsGlobalVariable.FdfParser.Profile
+        ImageList = []
+        FvInRegion = set()
+        for FdObj in Profile.FdDict.values():
+            FvNameList = []
+            for RegionObj in FdObj.RegionList:
+                if RegionObj.RegionType == BINARY_FILE_TYPE_FV:
+                    FvNameList.extend(RegionData.upper() for RegionData in RegionObj.RegionDataList if not RegionData.endswith(".fv"))
+            FfsFileList, FvSet = GenFds._GetFvFfsList(FvNameList)
+            FvInRegion |= FvSet
+            ImageList.append(("-r", FdObj.FdUiName, os.path.join(GenFdsGlobalVariable.FvDir, FdObj.FdUiName + '.fd'), FfsFileList))
+
+        #
+        # An FV in an FD region is built at the region address, so that only
+        # the FD generates it.
+        #
+        for Name, FvObj in Profile.FvDict.items():
+            if Name in FvInRegion or Name + 'fv' not in GenFdsGlobalVariable.ImageBinDict:
+                continue
+            FfsFileList, _ = GenFds._GetFvFfsList([Name])
+            ImageList.append(("-i", FvObj.UiFvName, GenFdsGlobalVariable.ImageBinDict[Name + 'fv'], FfsFileList))
+        return ImageList
+
+    ## Get the module FFS files of FVs and of the FVs nested in them
+    #
+    #   @param  FvNameList      The upper case names of the FVs
+    #
+    #   @retval tuple           ([FfsFile], {FvName}), the FFS files and the FVs
+    #
+    @staticmethod
+    def _GetFvFfsList(FvNameList):
+        Profile = GenFdsGlobalVariable.FdfParser.Profile
+        FfsFileList = []
+        Visited = set()
+        FvNameList = list(FvNameList)
+        while FvNameList:
+            Name = FvNameList.pop()
+            if Name in Visited or Name not in Profile.FvDict:
+                continue
+            Visited.add(Name)
+            for FfsFile in GenFdsGlobalVariable.FvFfsDict.get(Name, []):
+                if FfsFile not in FfsFileList:
+                    FfsFileList.append(FfsFile)
+            for Ffs in Profile.FvDict[Name].FfsList:
+                if isinstance(Ffs, FileStatement) and Ffs.FvName:
+                    FvNameList.append(Ffs.FvName.upper())
+                SectionList = list(getattr(Ffs, 'SectionList', []) or [])
+                while SectionList:
+                    Section = SectionList.pop()
+                    if isinstance(Section, FvImageSection) and Section.FvName is not None:
+                        FvNameList.append(Section.FvName.upper())
+                    SectionList.extend(getattr(Section, 'SectionList', []) or [])
+        return FfsFileList, Visited
+
     ## GetFvBlockSize()
     #
     #   @param  FvObj           Whose block size to get
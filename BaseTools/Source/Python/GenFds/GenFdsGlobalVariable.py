@@ -14,10 +14,10 @@ from __future__ import absolute_import
 
 import Common.LongFilePathOs as os
 import sys
+import time
 from sys import stdout
 from subprocess import PIPE,Popen
 from struct import Struct
-from array import array
 
 from Common.BuildToolError import COMMAND_FAILURE,GENFDS_ERROR
 from Common import EdkLogger
@@ -32,7 +32,9 @@ from Common.LongFilePathSupport import OpenLongFilePath as open
 from Common.MultipleWorkspace import MultipleWorkspace as mws
 import Common.GlobalData as GlobalData
 from Common.BuildToolError import *
+from Common.BuildTrace import gBuildTrace
 from AutoGen.AutoGen import CalculatePriorityValue
+from .GenSecFfs import GenLeafSection, GenVersionSection, GenSectionList, GenFfsFile, GenUiSection
 
 ## Global variables
 #
@@ -69,10 +71,12 @@ class GenFdsGlobalVariable:
     __BuildRuleDatabase = None
     GuidToolDefinition = {}
     FfsCmdDict = {}
+    FvFfsDict = {}
     SecCmdList = []
     CopyList   = []
     ModuleFile = ''
     EnableGenfdsMultiThread = True
+    ThreadNumber = 1
 
     #
     # The list whose element are flags to indicate if large FFS or SECTION files exist in FV.
@@ -432,6 +436,29 @@ class GenFdsGlobalVariable:
                 return True
         return False
 
+    ## Write a file generated in process
+    #
+    #   @param  Output          Path of output file
+    #   @param  Data            Content of output file
+    #
+    @staticmethod
+    def WriteOutputFile(Output, Data):
+        DirName = os.path.dirname(Output)
+        if not CreateDirectory(DirName):
+            EdkLogger.error(None, FILE_CREATE_FAILURE, "Could not create directory %s" % DirName)
+        else:
+            if DirName == '':
+                DirName = os.getcwd()
+            if not os.access(DirName, os.W_OK):
+                EdkLogger.error(None, PERMISSION_FAILURE, "Do not have write permission on directory %s" % DirName)
+
+        try:
+            with open(Output, "wb") as Fd:
+                Fd.write(Data)
+                Fd.flush()
+        except IOError as X:
+            EdkLogger.error(None, FILE_CREATE_FAILURE, ExtraData='IOError %s' % X)
+
     @staticmethod
     def GenerateSection(Output, Input, Type=None, CompressionType=None, Guid=None,
                         GuidHdrLen=None, GuidAttr=[], Ui=None, Ver=None, InputAlign=[], BuildNumber=None, DummyFile=None, IsMakefile=False):
@@ -464,29 +491,7 @@ class GenFdsGlobalVariable:
                 if ' '.join(Cmd).strip() not in GenFdsGlobalVariable.SecCmdList:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             else:
-                SectionData = array('B', [0, 0, 0, 0])
-                SectionData.fromlist(array('B',Ui.encode('utf-16-le')).tolist())
-                SectionData.append(0)
-                SectionData.append(0)
-                Len = len(SectionData)
-                GenFdsGlobalVariable.SectionHeader.pack_into(SectionData, 0, Len & 0xff, (Len >> 8) & 0xff, (Len >> 16) & 0xff, 0x15)
-
-
-                DirName = os.path.dirname(Output)
-                if not CreateDirectory(DirName):
-                    EdkLogger.error(None, FILE_CREATE_FAILURE, "Could not create directory %s" % DirName)
-                else:
-                    if DirName == '':
-                        DirName = os.getcwd()
-                    if not os.access(DirName, os.W_OK):
-                        EdkLogger.error(None, PERMISSION_FAILURE, "Do not have write permission on directory %s" % DirName)
-
-                try:
-                    with open(Output, "wb") as Fd:
-                        SectionData.tofile(Fd)
-                        Fd.flush()
-                except IOError as X:
-                    EdkLogger.error(None, FILE_CREATE_FAILURE, ExtraData='IOError %s' % X)
+                GenFdsGlobalVariable.WriteOutputFile(Output, GenUiSection(Ui))
 
         elif Ver:
             Cmd += ("-n", Ver)
@@ -501,7 +506,11 @@ class GenFdsGlobalVariable:
             else:
                 if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                     return
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                SectionData = GenVersionSection(Ver, BuildNumber)
+                if SectionData is not None:
+                    GenFdsGlobalVariable.WriteOutputFile(Output, SectionData)
+                else:
+                    GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
         else:
             Cmd += ("-o", Output)
             Cmd += Input
@@ -516,7 +525,19 @@ class GenFdsGlobalVariable:
                     GenFdsGlobalVariable.SecCmdList.append(' '.join(Cmd).strip())
             elif GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 GenFdsGlobalVariable.DebugLogger(EdkLogger.DEBUG_5, "%s needs update because of newer %s" % (Output, Input))
-                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
+                #
+                # Compressed and GUIDed sections need the external tools.
+                #
+                SectionData = None
+                if not (CompressionType or Guid or DummyFile or GuidHdrLen or GuidAttr):
+                    if Type:
+                        SectionData = GenLeafSection(Type, Input)
+                    else:
+                        SectionData = GenSectionList(Input, InputAlign)
+                if SectionData is not None:
+                    GenFdsGlobalVariable.WriteOutputFile(Output, SectionData)
+                else:
+                    GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate section")
                 if (os.path.getsize(Output) >= GenFdsGlobalVariable.LARGE_FILE_SIZE and
                     GenFdsGlobalVariable.LargeFileInFvFlags):
                     GenFdsGlobalVariable.LargeFileInFvFlags[-1] = True
@@ -572,7 +593,11 @@ class GenFdsGlobalVariable:
         else:
             if not GenFdsGlobalVariable.NeedsUpdate(Output, list(Input) + [CommandFile]):
                 return
-            GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
+            FfsData = GenFfsFile(Type, Guid, Input, Fixed == True, CheckSum, Align, SectionAlign)
+            if FfsData is not None:
+                GenFdsGlobalVariable.WriteOutputFile(Output, FfsData)
+            else:
+                GenFdsGlobalVariable.CallExternalTool(Cmd, "Failed to generate FFS")
 
     @staticmethod
     def GenerateFirmwareVolume(Output, Input, BaseAddress=None, ForceRebase=None, Capsule=False, Dump=False,
@@ -722,6 +747,7 @@ class GenFdsGlobalVariable:
             if GenFdsGlobalVariable.SharpCounter % GenFdsGlobalVariable.SharpNumberPerLine == 0:
                 stdout.write('\n')
 
+        ToolStart = time.time()
         try:
             PopenObject = Popen(' '.join(cmd), stdout=PIPE, stderr=PIPE, shell=True)
         except Exception as X:
@@ -730,6 +756,12 @@ class GenFdsGlobalVariable:
 
         while PopenObject.returncode is None:
             PopenObject.wait()
+        if GlobalData.gBuildTraceFile:
+            Tool = os.path.splitext(os.path.basename(cmd[0]))[0]
+            Name = Tool
+            if '-o' in cmd[:-1]:
+                Name = "%s %s" % (Tool, os.path.basename(cmd[cmd.index('-o') + 1]))
+            gBuildTrace.Add(Name, "genfw" if Tool == "GenFw" else "tool", ToolStart, time.time())
         if returnValue != [] and returnValue[0] != 0:
             #get command return value
             returnValue[0] = PopenObject.returncode
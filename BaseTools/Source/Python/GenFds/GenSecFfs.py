@@ -0,0 +1,564 @@
+## @file
+# Generate sections and FFS files in process, the way GenSec and GenFfs do
+#
+# Every function takes the same inputs as the matching command line of GenSec
+# or GenFfs and returns the content of the output file, byte for byte what the
+# tool writes. A function returns None for the cases it does not handle, such
+# as a missing or truncated input file, an alignment taken from the PE image
+# or an invalid option; the caller then runs the tool, which reports the error
+# or does the work as before.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import os
+import re
+import shlex
+import subprocess
+import sys
+import uuid
+from struct import Struct
+
+from Common.LongFilePathSupport import OpenLongFilePath as open
+
+MAX_SECTION_SIZE = 0x1000000
+MAX_FFS_SIZE = 0x1000000
+
+EFI_SECTION_GUID_DEFINED = 0x02
+EFI_SECTION_PE32 = 0x10
+EFI_SECTION_TE = 0x12
+EFI_SECTION_FREEFORM_SUBTYPE_GUID = 0x18
+EFI_SECTION_RAW = 0x19
+EFI_SECTION_COMPRESSION = 0x01
+EFI_SECTION_FIRMWARE_VOLUME_IMAGE = 0x17
+EFI_SECTION_VERSION = 0x14
+EFI_SECTION_USER_INTERFACE = 0x15
+
+EFI_GUIDED_SECTION_PROCESSING_REQUIRED = 0x01
+EFI_TE_IMAGE_HEADER_SIGNATURE = 0x5A56
+EFI_TE_IMAGE_HEADER_SIZE = 40
+
+FFS_ATTRIB_LARGE_FILE = 0x01
+FFS_ATTRIB_DATA_ALIGNMENT2 = 0x02
+FFS_ATTRIB_FIXED = 0x04
+FFS_ATTRIB_CHECKSUM = 0x40
+FFS_FIXED_CHECKSUM = 0xAA
+EFI_FILE_STATE = 0x07   # EFI_FILE_HEADER_CONSTRUCTION | EFI_FILE_HEADER_VALID | EFI_FILE_DATA_VALID
+
+EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID = uuid.UUID('04132C8D-0A22-4FA8-826E-8BBFEFDB836C').bytes_le
+
+## The leaf section types GenSec builds by prepending a common section header
+gLeafSectionType = {
+    'EFI_SECTION_PE32'                  : 0x10,
+    'EFI_SECTION_PIC'                   : 0x11,
+    'EFI_SECTION_TE'                    : 0x12,
+    'EFI_SECTION_DXE_DEPEX'             : 0x13,
+    'EFI_SECTION_COMPATIBILITY16'       : 0x16,
+    'EFI_SECTION_FIRMWARE_VOLUME_IMAGE' : 0x17,
+    'EFI_SECTION_RAW'                   : 0x19,
+    'EFI_SECTION_PEI_DEPEX'             : 0x1B,
+    'EFI_SECTION_SMM_DEPEX'             : 0x1C,
+}
+
+gFfsFileType = {
+    'EFI_FV_FILETYPE_RAW'                   : 0x01,
+    'EFI_FV_FILETYPE_FREEFORM'              : 0x02,
+    'EFI_FV_FILETYPE_SECURITY_CORE'         : 0x03,
+    'EFI_FV_FILETYPE_PEI_CORE'              : 0x04,
+    'EFI_FV_FILETYPE_DXE_CORE'              : 0x05,
+    'EFI_FV_FILETYPE_PEIM'                  : 0x06,
+    'EFI_FV_FILETYPE_DRIVER'                : 0x07,
+    'EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER'  : 0x08,
+    'EFI_FV_FILETYPE_APPLICATION'           : 0x09,
+    'EFI_FV_FILETYPE_SMM'                   : 0x0A,
+    'EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE' : 0x0B,
+    'EFI_FV_FILETYPE_COMBINED_SMM_DXE'      : 0x0C,
+    'EFI_FV_FILETYPE_SMM_CORE'              : 0x0D,
+    'EFI_FV_FILETYPE_MM_STANDALONE'         : 0x0E,
+    'EFI_FV_FILETYPE_MM_CORE_STANDALONE'    : 0x0F,
+}
+
+## The file types which must have exactly one, or at least one, PE32 or TE section
+gSinglePeFileType = (0x03, 0x04, 0x05)
+gPeFileType = (0x06, 0x07, 0x08, 0x09)
+
+gAlignName = ["1", "2", "4", "8", "16", "32", "64", "128", "256", "512",
+              "1K", "2K", "4K", "8K", "16K", "32K", "64K", "128K", "256K",
+              "512K", "1M", "2M", "4M", "8M", "16M"]
+
+gFfsValidAlignName = ["8", "16", "128", "512", "1K", "4K", "32K", "64K", "128K", "256K",
+                      "512K", "1M", "2M", "4M", "8M", "16M"]
+gFfsValidAlign = [0, 8, 16, 128, 512, 1024, 4096, 32768, 65536, 131072, 262144,
+                  524288, 1048576, 2097152, 4194304, 8388608, 16777216]
+
+## The makefile prefix of a command whose input file is optional, "-test -e File &&" or "if exist File"
+gOptionalInputPattern = re.compile(r'^(-test\s+-e|if\s+exist)\s+("[^"]*"|\S+)\s+(?:&&\s+)?(.*)$')
+
+gGuidPattern = re.compile(r"^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$")
+
+SectionHeader = Struct("<3BB")
+SectionHeader2 = Struct("<3BBI")
+BuildNumberField = Struct("<H")
+TeImageHeader = Struct("<HHBBH")
+GuidDefinedSection = Struct("<16sHH")
+FfsFileHeader = Struct("<16sBBBB3sB")
+FfsFileHeader2 = Struct("<16sBBBB3sBQ")
+
+## Convert an alignment name of GenSec and GenFfs, from "1" to "16M", to its value
+#
+#   @retval None            The name is not a valid alignment
+#
+def StringToAlignment(Align):
+    Align = Align.upper()
+    if Align in gAlignName:
+        return 1 << gAlignName.index(Align)
+    return None
+
+## Read an input file
+#
+#   @retval None            The file does not exist or can not be read
+#
+def ReadInput(FileName):
+    try:
+        with open(FileName, 'rb') as Fd:
+            return Fd.read()
+    except (IOError, OSError):
+        return None
+
+## Sum the bytes of the data, the CalculateChecksum8 of BaseTools/Source/C
+def CalculateChecksum8(Data):
+    return (0x100 - (sum(bytearray(Data)) & 0xFF)) & 0xFF
+
+## Build the common section header of a section of the total size
+def PackSectionHeader(Type, Size):
+    if Size >= MAX_SECTION_SIZE:
+        return SectionHeader2.pack(0xFF, 0xFF, 0xFF, Type, Size + SectionHeader2.size - SectionHeader.size)
+    return SectionHeader.pack(Size & 0xFF, (Size >> 8) & 0xFF, (Size >> 16) & 0xFF, Type)
+
+## Get the header size and TE offset of an input section for its alignment
+#
+# The section data, not the section header, is aligned. For a TE image the
+# stripped part of the PE header is taken into account, so that the original
+# PE image would have been aligned.
+#
+#   @retval (Type, HeaderSize, TeOffset)
+#   @retval None            The section is too short for its headers
+#
+def GetSectionAlignInfo(Data):
+    if len(Data) >= MAX_SECTION_SIZE:
+        HeaderSize = SectionHeader2.size
+    else:
+        HeaderSize = SectionHeader.size
+    if len(Data) < HeaderSize:
+        return None
+    Type = bytearray(Data)[3]
+    TeOffset = 0
+    if Type == EFI_SECTION_TE:
+        if len(Data) < HeaderSize + EFI_TE_IMAGE_HEADER_SIZE:
+            return None
+        Signature, _, _, _, StrippedSize = TeImageHeader.unpack_from(Data, HeaderSize)
+        if Signature == EFI_TE_IMAGE_HEADER_SIGNATURE:
+            TeOffset = (StrippedSize - EFI_TE_IMAGE_HEADER_SIZE) & 0xFFFFFFFF
+    elif Type == EFI_SECTION_GUID_DEFINED:
+        if len(Data) < HeaderSize + GuidDefinedSection.size:
+            return None
+        _, DataOffset, Attributes = GuidDefinedSection.unpack_from(Data, HeaderSize)
+        if (Attributes & EFI_GUIDED_SECTION_PROCESSING_REQUIRED) == 0:
+            HeaderSize = DataOffset
+    return Type, HeaderSize, TeOffset
+
+## Get the size of the pad section in front of an input section
+#
+#   @retval 0               The section data is aligned without pad section
+#
+def GetPadSize(Size, HeaderSize, TeOffset, Align):
+    if TeOffset != 0:
+        TeOffset = (Align - (TeOffset % Align)) % Align
+    if (Size + HeaderSize + TeOffset) % Align == 0:
+        return 0
+    Offset = (Size + SectionHeader.size + HeaderSize + TeOffset + Align - 1) & ~(Align - 1)
+    return Offset - Size - HeaderSize - TeOffset
+
+## Build a leaf section: the content of one input file after a section header
+#
+#   @param  Type            Section type name, as the -s option of GenSec
+#   @param  Input           List of input files
+#
+#   @retval None            The section type or input is not handled in process
+#
+def GenLeafSection(Type, Input):
+    if Type not in gLeafSectionType or len(Input) != 1:
+        return None
+    Data = ReadInput(Input[0])
+    if Data is None:
+        return None
+    return PackSectionHeader(gLeafSectionType[Type], len(Data) + SectionHeader.size) + Data
+
+## Build a version section
+#
+#   @param  Ver             Version string, quoted as on the command line of GenSec
+#   @param  BuildNumber     Build number string, or None
+#
+#   @retval None            The string needs the shell or is not ASCII, or the
+#                           build number is invalid
+#
+def GenVersionSection(Ver, BuildNumber=None):
+    if any(Char in Ver for Char in '$`\\'):
+        return None
+    try:
+        Words = shlex.split(Ver)
+        Version = Words[0].encode('ascii') if len(Words) == 1 else None
+        Number = int(BuildNumber) if BuildNumber else 0
+    except (ValueError, UnicodeError):
+        return None
+    if Version is None or Number < 0 or Number > 0xFFFF:
+        return None
+    Body = BuildNumberField.pack(Number) + Version.decode('ascii').encode('utf-16-le') + b'\0\0'
+    return PackSectionHeader(EFI_SECTION_VERSION, len(Body) + SectionHeader.size) + Body
+
+## Concatenate sections the way GenSec does without section type
+#
+# Each section starts at a 4 byte boundary. When alignments are given, a raw
+# pad section is inserted in front of a section whose data is not aligned.
+#
+#   @param  Input           List of input section files
+#   @param  InputAlign      List of alignment names, one per input file, or []
+#
+#   @retval None            The input is not handled in process
+#
+def GenSectionList(Input, InputAlign=[]):
+    if InputAlign and len(InputAlign) != len(Input):
+        return None
+    Alignments = []
+    for Align in InputAlign:
+        Value = StringToAlignment(Align)
+        if Value is None:
+            return None
+        Alignments.append(Value)
+
+    Buffer = bytearray()
+    for Index, FileName in enumerate(Input):
+        Data = ReadInput(FileName)
+        if Data is None:
+            return None
+        Buffer += b'\0' * (-len(Buffer) & 0x03)
+        if Alignments:
+            Info = GetSectionAlignInfo(Data)
+            if Info is None:
+                return None
+            _, HeaderSize, TeOffset = Info
+            PadSize = GetPadSize(len(Buffer), HeaderSize, TeOffset, Alignments[Index])
+            if PadSize:
+                Buffer += SectionHeader.pack(PadSize & 0xFF, (PadSize >> 8) & 0xFF, (PadSize >> 16) & 0xFF, EFI_SECTION_RAW)
+                Buffer += b'\0' * (PadSize - SectionHeader.size)
+        Buffer += Data
+    return bytes(Buffer)
+
+## Build an FFS file the way GenFfs does
+#
+#   @param  Type            File type name, as the -t option of GenFfs
+#   @param  Guid            File name GUID string
+#   @param  Input           List of input section files
+#   @param  Fixed           The -x option of GenFfs
+#   @param  CheckSum        The -s option of GenFfs
+#   @param  Align           FFS alignment name, as the -a option of GenFfs
+#   @param  SectionAlign    List of section alignment names, or None
+#
+#   @retval None            The input is not handled in process
+#
+def GenFfsFile(Type, Guid, Input, Fixed=False, CheckSum=False, Align=None, SectionAlign=None):
+    if Type not in gFfsFileType or not gGuidPattern.match(Guid) or not Input:
+        return None
+    FileType = gFfsFileType[Type]
+    Attrib = 0
+    if Fixed:
+        Attrib |= FFS_ATTRIB_FIXED
+    if CheckSum:
+        Attrib |= FFS_ATTRIB_CHECKSUM
+
+    FfsAlign = 0
+    if Align:
+        if Align.upper() in gFfsValidAlignName:
+            FfsAlign = gFfsValidAlignName.index(Align.upper())
+        elif Align not in ("1", "2", "4"):
+            return None
+
+    Alignments = []
+    for Index in range(len(Input)):
+        Value = 1
+        if SectionAlign and SectionAlign[Index]:
+            Value = StringToAlignment(SectionAlign[Index])
+            if Value is None:
+                return None
+        Alignments.append(Value)
+
+    #
+    # Concatenate the sections, padding each one to its alignment. The pad
+    # section can be reduced later by GenFv when the file is fixed and no
+    # section before it needs alignment.
+    #
+    Buffer = bytearray()
+    MaxAlignment = 1
+    PeSectionNum = 0
+    for Index, FileName in enumerate(Input):
+        Data = ReadInput(FileName)
+        if Data is None:
+            return None
+        Buffer += b'\0' * (-len(Buffer) & 0x03)
+        Info = GetSectionAlignInfo(Data)
+        if Info is None:
+            return None
+        SectionType, HeaderSize, TeOffset = Info
+        if SectionType in (EFI_SECTION_PE32, EFI_SECTION_TE, EFI_SECTION_GUID_DEFINED,
+                           EFI_SECTION_COMPRESSION, EFI_SECTION_FIRMWARE_VOLUME_IMAGE):
+            PeSectionNum += 1
+        PadSize = GetPadSize(len(Buffer), HeaderSize, TeOffset, Alignments[Index])
+        if PadSize:
+            Pad = bytearray(PadSize)
+            SectionHeader.pack_into(Pad, 0, PadSize & 0xFF, (PadSize >> 8) & 0xFF, (PadSize >> 16) & 0xFF, EFI_SECTION_RAW)
+            if Fixed and MaxAlignment <= 1 and PadSize >= SectionHeader.size + 16:
+                Pad[3] = EFI_SECTION_FREEFORM_SUBTYPE_GUID
+                Pad[4:20] = EFI_FFS_SECTION_ALIGNMENT_PADDING_GUID
+            Buffer += Pad
+        MaxAlignment = max(MaxAlignment, Alignments[Index])
+        Buffer += Data
+
+    if FileType in gSinglePeFileType and PeSectionNum != 1:
+        return None
+    if FileType in gPeFileType and PeSectionNum < 1:
+        return None
+
+    #
+    # The FFS alignment is at least the maximum alignment of the sections.
+    #
+    for Index in range(len(gFfsValidAlign) - 1):
+        if gFfsValidAlign[Index] < MaxAlignment <= gFfsValidAlign[Index + 1]:
+            break
+    else:
+        Index = len(gFfsValidAlign) - 1
+    FfsAlign = max(FfsAlign, Index)
+
+    Name = uuid.UUID(Guid).bytes_le
+    if len(Buffer) + FfsFileHeader.size >= MAX_FFS_SIZE:
+        Attrib |= FFS_ATTRIB_LARGE_FILE
+        FileSize = len(Buffer) + FfsFileHeader2.size
+        Size = b'\0\0\0'
+    else:
+        FileSize = len(Buffer) + FfsFileHeader.size
+        Size = bytes(bytearray([FileSize & 0xFF, (FileSize >> 8) & 0xFF, (FileSize >> 16) & 0xFF]))
+    if FfsAlign < 8:
+        Attrib |= FfsAlign << 3
+    else:
+        Attrib |= ((FfsAlign & 0x7) << 3) | FFS_ATTRIB_DATA_ALIGNMENT2
+
+    #
+    # The checksums and the state are zero while the header checksum is calculated.
+    #
+    if Attrib & FFS_ATTRIB_LARGE_FILE:
+        Header = bytearray(FfsFileHeader2.pack(Name, 0, 0, FileType, Attrib, Size, 0, FileSize))
+    else:
+        Header = bytearray(FfsFileHeader.pack(Name, 0, 0, FileType, Attrib, Size, 0))
+    Header[16] = CalculateChecksum8(Header)
+    Header[17] = CalculateChecksum8(Buffer) if Attrib & FFS_ATTRIB_CHECKSUM else FFS_FIXED_CHECKSUM
+    Header[23] = EFI_FILE_STATE
+    return bytes(Header + Buffer)
+
+## Build a user interface section
+#
+#   @param  Ui              The user interface string
+#
+def GenUiSection(Ui):
+    Body = Ui.encode('utf-16-le') + b'\0\0'
+    return PackSectionHeader(EFI_SECTION_USER_INTERFACE, len(Body) + SectionHeader.size) + Body
+
+## Split a command line of a command file into words
+#
+# The words keep their quotes, as GenVersionSection expects them; the quotes
+# of the other words are removed by the callers.
+#
+def SplitCommand(Line):
+    try:
+        return shlex.split(Line, posix=False)
+    except ValueError:
+        return None
+
+def Unquote(Word):
+    if len(Word) >= 2 and Word[0] == Word[-1] == '"':
+        return Word[1:-1]
+    return Word
+
+## Generate the output of a GenSec command line
+#
+#   @param  Args            The words of the command line after GenSec
+#
+#   @retval (Output, Data)  The output file and its content
+#   @retval None            The command is not handled in process
+#
+def GenSecCommand(Args):
+    Options = {}
+    InputAlign = []
+    Input = []
+    Index = 0
+    while Index < len(Args):
+        Arg = Args[Index]
+        if Arg in ('-s', '-n', '-j', '-o') and Index + 1 < len(Args):
+            Options[Arg] = Args[Index + 1]
+            Index += 2
+        elif Arg == '--sectionalign' and Index + 1 < len(Args):
+            InputAlign.append(Args[Index + 1])
+            Index += 2
+        elif Arg.startswith('-'):
+            #
+            # Compressed, GUIDed and dummy sections need the tool.
+            #
+            return None
+        else:
+            Input.append(Unquote(Arg))
+            Index += 1
+
+    if '-o' not in Options:
+        return None
+    Type = Options.get('-s')
+    if Type == 'EFI_SECTION_USER_INTERFACE':
+        if '-n' not in Options or any(Char in Options['-n'] for Char in '$`\\'):
+            return None
+        Data = GenUiSection(Unquote(Options['-n']))
+    elif Type == 'EFI_SECTION_VERSION':
+        if '-n' not in Options:
+            return None
+        Data = GenVersionSection(Options['-n'], Options.get('-j'))
+    elif Type:
+        Data = GenLeafSection(Type, Input)
+    else:
+        Data = GenSectionList(Input, InputAlign)
+    if Data is None:
+        return None
+    return Unquote(Options['-o']), Data
+
+## Generate the output of a GenFfs command line
+#
+#   @param  Args            The words of the command line after GenFfs
+#
+#   @retval (Output, Data)  The output file and its content
+#   @retval None            The command is not handled in process
+#
+def GenFfsCommand(Args):
+    Options = {}
+    Fixed = False
+    CheckSum = False
+    Input = []
+    SectionAlign = []
+    Index = 0
+    while Index < len(Args):
+        Arg = Args[Index]
+        if Arg in ('-t', '-g', '-a', '-o') and Index + 1 < len(Args):
+            Options[Arg] = Args[Index + 1]
+            Index += 2
+        elif Arg in ('-i', '-oi') and Index + 1 < len(Args):
+            FileName = Unquote(Args[Index + 1])
+            Index += 2
+            if Arg == '-oi' and not os.path.exists(FileName):
+                #
+                # GenFfs skips a missing optional section file.
+                #
+                if Index < len(Args) and Args[Index] == '-n':
+                    return None
+                continue
+            Input.append(FileName)
+            SectionAlign.append(None)
+        elif Arg == '-n' and Input and Index + 1 < len(Args):
+            SectionAlign[-1] = Args[Index + 1]
+            Index += 2
+        elif Arg == '-x':
+            Fixed = True
+            Index += 1
+        elif Arg == '-s':
+            CheckSum = True
+            Index += 1
+        else:
+            return None
+
+    if '-t' not in Options or '-g' not in Options or '-o' not in Options:
+        return None
+    Data = GenFfsFile(Options['-t'], Options['-g'], Input, Fixed, CheckSum, Options.get('-a'), SectionAlign)
+    if Data is None:
+        return None
+    return Unquote(Options['-o']), Data
+
+## Run one line of a command file
+#
+# A GenSec or GenFfs command is done in process when the functions above
+# handle it; any other command runs in the shell, as the makefile would run
+# it. A command whose optional input is missing is skipped, and its errors
+# are ignored as by the "-" prefix in the makefile.
+#
+#   @retval 0               The command succeeded or its errors are ignored
+#
+def RunCommand(Line):
+    IgnoreError = False
+    Match = gOptionalInputPattern.match(Line)
+    if Match:
+        if not os.path.exists(Unquote(Match.group(2))):
+            return 0
+        IgnoreError = Match.group(1).startswith('-')
+        Line = Match.group(3)
+
+    Words = SplitCommand(Line)
+    Result = None
+    if Words and Words[0] == 'GenSec':
+        Result = GenSecCommand(Words[1:])
+    elif Words and Words[0] == 'GenFfs':
+        Result = GenFfsCommand(Words[1:])
+
+    if Result is not None:
+        Output, Data = Result
+        try:
+            if os.path.dirname(Output) and not os.path.isdir(os.path.dirname(Output)):
+                os.makedirs(os.path.dirname(Output))
+            with open(Output, 'wb') as Fd:
+                Fd.write(Data)
+        except (IOError, OSError) as X:
+            sys.stderr.write('GenSecFfs: %s\n' % X)
+            return 0 if IgnoreError else 1
+        return 0
+
+    Status = subprocess.call(Line, shell=True)
+    return 0 if IgnoreError else Status
+
+## Run the commands of a command file, one command per line, in order
+#
+# GenMake writes the commands generating one FFS file of a module into a
+# command file, so that the makefile starts one GenSecFfs for the whole FFS
+# file instead of one tool per section.
+#
+#   @retval 0               All the commands succeeded
+#
+def RunCommandFile(FileName):
+    try:
+        with open(FileName, 'r') as Fd:
+            Lines = Fd.read().splitlines()
+    except (IOError, OSError) as X:
+        sys.stderr.write('GenSecFfs: %s\n' % X)
+        return 1
+    for Line in Lines:
+        Line = Line.strip()
+        if not Line:
+            continue
+        Status = RunCommand(Line)
+        if Status != 0:
+            sys.stderr.write('GenSecFfs: "%s" failed\n' % Line)
+            return Status
+    return 0
+
+def Main():
+    if len(sys.argv) != 2:
+        sys.stderr.write('Usage: GenSecFfs CommandFile\n')
+        return 1
+    return RunCommandFile(sys.argv[1])
+
+if __name__ == '__main__':
+    sys.exit(Main())
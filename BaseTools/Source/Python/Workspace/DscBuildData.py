@@ -115,8 +115,8 @@ SkuIdPattern = re.compile(r'^[a-zA-Z_][a-zA-Z0-9_]*$')
 ## regular expressions for finding decimal and hex numbers
 Pattern = re.compile(r'^[1-9]\d*|0$')
 HexPattern = re.compile(r'0[xX][0-9a-fA-F]+$')
-## Regular expression for finding header file inclusions
-from AutoGen.GenMake import gIncludePattern
+## The #include directives of the files, kept across builds
+from AutoGen.IncludeGraph import gIncludeGraph
 
 ## Find dependencies for one source file
 #
@@ -138,30 +138,7 @@ def GetDependencyList(FileStack, SearchPathList):
         if F in DepDb:
             CurrentFileDependencyList = DepDb[F]
         else:
-            try:
-                Fd = open(F, 'r')
-                FileContent = Fd.read()
-            except BaseException as X:
-                EdkLogger.error("build", FILE_OPEN_FAILURE, ExtraData=F + "\n\t" + str(X))
-            finally:
-                if "Fd" in dir(locals()):
-                    Fd.close()
-
-            if len(FileContent) == 0:
-                continue
-
-            try:
-                if FileContent[0] == 0xff or FileContent[0] == 0xfe:
-                    FileContent = FileContent.decode('utf-16')
-                else:
-                    FileContent = FileContent.decode()
-            except:
-                # The file is not txt file. for example .mcb file
-                continue
-            IncludedFileList = gIncludePattern.findall(FileContent)
-
-            for Inc in IncludedFileList:
-                Inc = Inc.strip()
+            for Inc in gIncludeGraph.GetIncludeList(F):
                 Inc = os.path.normpath(Inc)
                 CurrentFileDependencyList.append(Inc)
             DepDb[F] = CurrentFileDependencyList
@@ -0,0 +1,180 @@
+## @file
+# This file is used to keep the parsed data of meta files across builds
+#
+# The records a parser stores in the raw table of an INF or DEC file only
+# depend on the content of the file. Those of a DSC file also depend on the
+# macros defined outside of it. They are saved in Conf/.cache/MetaFile, keyed
+# by the path of the file and the macros, and checked against the hash of the
+# file content before they are loaded in place of parsing the file again.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+import Common.LongFilePathOs as os
+import pickle
+import time
+import uuid
+from hashlib import md5
+
+import Common.EdkLogger as EdkLogger
+import Common.GlobalData as GlobalData
+from Common.LongFilePathSupport import OpenLongFilePath as open
+from CommonDataClass.DataClass import MODEL_FILE_DSC
+
+## MetaFileCache
+#
+# This class saves the raw table of a parser after the file is parsed, and
+# fills the raw table of a parser from the saved records when the file and the
+# macros have not changed since. The cache is disabled when
+# GlobalData.gMetaFileCacheDir is not set.
+#
+class MetaFileCache(object):
+    # Change it whenever the layout of the tables or the parser state changes
+    _VERSION_ = 1
+
+    # Parser attributes set during parsing and restored with the records
+    _PARSER_STATE_ = ('_Defines', '_Version', '_FileLocalMacros', '_SectionsMacroDict')
+
+    def __init__(self):
+        self.ParseCount = 0
+        self.ParseTime = 0.0
+        self.HitCount = 0
+        self.HitTime = 0.0
+
+    ## Check if the records of a parser can be cached
+    #
+    # The records of a DSC file included by another one depend on the state of
+    # the including parser, they are always parsed again.
+    #
+    def _IsCacheable(self, Parser):
+        if not GlobalData.gMetaFileCacheDir:
+            return False
+        return Parser._From == -1 and Parser._Owner[0] == -1
+
+    ## Index of the BelongsToItem column in the table rows of the parser
+    @staticmethod
+    def _OwnerColumn(Parser):
+        if Parser._FileType == MODEL_FILE_DSC:
+            return 8
+        return 7
+
+    ## Get the cache file of a parser and the digest of its meta file content
+    def _Locate(self, Parser):
+        Key = md5()
+        Key.update(("%s|%s|%s" % (self._VERSION_, Parser._FileType, Parser.MetaFile.Path)).encode('utf-8'))
+        if GlobalData.gOptions and GlobalData.gOptions.CheckUsage:
+            Key.update(b'|CheckUsage')
+        if Parser._FileType == MODEL_FILE_DSC:
+            for Macros in (GlobalData.gGlobalDefines, GlobalData.gCommandLineDefines, GlobalData.gEdkGlobal):
+                Key.update(repr(sorted(Macros.items())).encode('utf-8'))
+            Key.update(repr(GlobalData.BuildOptionPcd).encode('utf-8'))
+
+        with open(str(Parser.MetaFile), 'rb') as File:
+            Digest = md5(File.read()).hexdigest()
+
+        return os.path.join(GlobalData.gMetaFileCacheDir, Key.hexdigest()), Digest
+
+    ## Fill the raw table of a parser from the cache
+    #
+    #   @param  Parser      The parser whose meta file is not parsed yet
+    #
+    #   @retval True        The raw table is filled and the parser is finished
+    #   @retval False       The meta file needs to be parsed
+    #
+    def Load(self, Parser):
+        Table = Parser._RawTable
+        if not self._IsCacheable(Parser) or Table.CurrentContent:
+            return False
+
+        StartTime = time.time()
+        try:
+            CacheFile, Digest = self._Locate(Parser)
+            if not os.path.exists(CacheFile):
+                return False
+            with open(CacheFile, 'rb') as File:
+                Data = pickle.load(File)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to load cached %s: %s" % (Parser.MetaFile, Exc))
+            return False
+        if Data.get('Digest') != Digest:
+            return False
+
+        #
+        # The record IDs are saved relative to the first ID of the table,
+        # which depends on the order the files are parsed in.
+        #
+        Base = Table.ID
+        Owner = self._OwnerColumn(Parser)
+        for Row in Data['Records']:
+            Row = list(Row)
+            if Row[0] >= 0:
+                Row[0] += Base
+            if Row[Owner] >= 0:
+                Row[Owner] += Base
+            Table.CurrentContent.append(Row)
+        Table.ID = Base + Data['LastId']
+
+        for Name in self._PARSER_STATE_:
+            setattr(Parser, Name, Data['State'][Name])
+        Parser._Finished = True
+
+        self.HitCount += 1
+        self.HitTime += time.time() - StartTime
+        return True
+
+    ## Parse the meta file of a parser and save its raw table in the cache
+    #
+    #   @param  Parser      The parser whose meta file is not parsed yet
+    #
+    def Parse(self, Parser):
+        Table = Parser._RawTable
+        Base = Table.ID
+        StartTime = time.time()
+        Parser.Start()
+        self.ParseCount += 1
+        self.ParseTime += time.time() - StartTime
+
+        if not self._IsCacheable(Parser):
+            return
+
+        Owner = self._OwnerColumn(Parser)
+        Records = []
+        for Row in Table.CurrentContent:
+            Row = list(Row)
+            if Row[0] >= 0:
+                Row[0] -= Base
+            if Row[Owner] >= 0:
+                Row[Owner] -= Base
+            Records.append(Row)
+        Data = {
+            'Records'   : Records,
+            'LastId'    : Table.ID - Base,
+            'State'     : {Name: getattr(Parser, Name) for Name in self._PARSER_STATE_},
+        }
+
+        #
+        # Write to a temporary file first, the AutoGen worker processes may
+        # save the same file at the same time.
+        #
+        try:
+            CacheFile, Data['Digest'] = self._Locate(Parser)
+            if not os.path.exists(GlobalData.gMetaFileCacheDir):
+                os.makedirs(GlobalData.gMetaFileCacheDir)
+            TempFile = "%s.%s" % (CacheFile, uuid.uuid4().hex)
+            with open(TempFile, 'wb') as File:
+                pickle.dump(Data, File, pickle.HIGHEST_PROTOCOL)
+            os.replace(TempFile, CacheFile)
+        except Exception as Exc:
+            EdkLogger.debug(EdkLogger.DEBUG_5, "Failed to cache %s: %s" % (Parser.MetaFile, Exc))
+
+    ## Summary of the parse time and the cache hits, for the build log
+    def Summary(self):
+        return "%d files parsed in %dms, %d files loaded from cache in %dms" % (
+                   self.ParseCount, int(round(self.ParseTime * 1000)),
+                   self.HitCount, int(round(self.HitTime * 1000)))
+
+gMetaFileCache = MetaFileCache()
@@ -30,6 +30,7 @@ from subprocess import Popen,PIPE, STDOUT
 from collections import OrderedDict, defaultdict
 import json
 import secrets
+import shutil
 
 from AutoGen.PlatformAutoGen import PlatformAutoGen
 from AutoGen.ModuleAutoGen import ModuleAutoGen
@@ -50,6 +51,7 @@ from Common.DataType import *
 import Common.EdkLogger as EdkLogger
 
 from Workspace.WorkspaceDatabase import BuildDB
+from Workspace.MetaFileCache import gMetaFileCache
 
 from BuildReport import BuildReport
 from GenPatchPcdTable.GenPatchPcdTable import PeImageClass,parsePcdInfoFromMapFile
@@ -63,6 +65,9 @@ from AutoGen.DataPipe import MemoryDataPipe
 from AutoGen.ModuleAutoGenHelper import WorkSpaceInfo, PlatformInfo
 from GenFds.FdfParser import FdfParser
 from AutoGen.IncludesAutoGen import IncludesAutoGen
+from AutoGen.GenNinja import NinjaBuildFile
+from AutoGen.IncludeGraph import gIncludeGraph
+from Common.BuildTrace import gBuildTrace, ToolStepRecorder
 from GenFds.GenFds import resetFdsGlobalVariable
 from AutoGen.AutoGen import CalculatePriorityValue
 
@@ -230,6 +235,13 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
 
     Proc = None
     EndOfProcedure = None
+    To = EdkLogger.info
+    Recorder = None
+    if GlobalData.gBuildTraceFile and ModuleAuto:
+        Recorder = ToolStepRecorder(ModuleAuto.BuildOption, threading.get_ident())
+        def To(Line):
+            Recorder.Feed(Line)
+            EdkLogger.info(Line)
     try:
         # launch the command
         Proc = MakeSubProc(Command, stdout=PIPE, stderr=STDOUT, env=os.environ, cwd=WorkingDir, bufsize=-1, shell=True)
@@ -238,7 +250,7 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
         EndOfProcedure = Event()
         EndOfProcedure.clear()
         if Proc.stdout:
-            StdOutThread = Thread(target=ReadMessage, args=(Proc.stdout, EdkLogger.info, EndOfProcedure,Proc.ProcOut))
+            StdOutThread = Thread(target=ReadMessage, args=(Proc.stdout, To, EndOfProcedure,Proc.ProcOut))
             StdOutThread.name = "STDOUT-Redirector"
             StdOutThread.daemon = False
             StdOutThread.start()
@@ -258,6 +270,8 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
 
     if Proc.stdout:
         StdOutThread.join()
+    if Recorder:
+        Recorder.Close()
 
     # check the return code of the program
     if Proc.returncode != 0:
@@ -273,17 +287,27 @@ def LaunchCommand(Command, WorkingDir,ModuleAuto = None):
 
         EdkLogger.error("build", COMMAND_FAILURE, ExtraData="%s [%s]" % (Command, WorkingDir))
     if ModuleAuto:
-        iau = IncludesAutoGen(WorkingDir,ModuleAuto)
-        if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
-            iau.CreateDepsFileForMsvc(Proc.ProcOut)
-        else:
-            iau.UpdateDepsFileforNonMsvc()
-        iau.UpdateDepsFileforTrim()
-        iau.CreateModuleDeps()
-        iau.CreateDepsInclude()
-        iau.CreateDepsTarget()
+        UpdateModuleDeps(WorkingDir, ModuleAuto, Proc.ProcOut)
     return "%dms" % (int(round((time.time() - BeginTime) * 1000)))
 
+## Update the dependency files of a module after its makefile was run
+#
+# @param  WorkingDir            The build directory of the module
+# @param  ModuleAuto            The ModuleAutoGen object of the module
+# @param  ProcOut               The output lines of the make command
+#
+def UpdateModuleDeps(WorkingDir, ModuleAuto, ProcOut):
+    iau = IncludesAutoGen(WorkingDir,ModuleAuto)
+    if ModuleAuto.ToolChainFamily == TAB_COMPILER_MSFT:
+        iau.CreateDepsFileForMsvc(ProcOut)
+    else:
+        iau.UpdateDepsFileforNonMsvc()
+    iau.UpdateDepsFileforTrim()
+    iau.CreateModuleDeps()
+    iau.CreateDepsInclude()
+    iau.CreateDepsTarget()
+    iau.RecordIncludeGraph()
+
 def GenerateStackCookieValues():
     if GlobalData.gBuildDirectory == "":
         return
@@ -643,7 +667,9 @@ class BuildTask:
     #
     def _CommandThread(self, Command, WorkingDir):
         try:
-            self.BuildItem.BuildObject.BuildTime = LaunchCommand(Command, WorkingDir,self.BuildItem.BuildObject)
+            TaskName = "Make %r" % self.BuildItem
+            with gBuildTrace.Span(TaskName, "make", task=TaskName, deps=["Make %r" % Dep.BuildItem for Dep in self.DependencyList]):
+                self.BuildItem.BuildObject.BuildTime = LaunchCommand(Command, WorkingDir,self.BuildItem.BuildObject)
             self.CompleteFlag = True
 
             # Run hash operation post dependency to account for libs
@@ -745,6 +771,9 @@ class Build():
         self.SkipAutoGen    = BuildOptions.SkipAutoGen
         self.Reparse        = BuildOptions.Reparse
         self.SkuId          = BuildOptions.SkuId
+        self.Backend        = BuildOptions.Backend
+        self.FfsCommandDict = {}
+        self.FdsImageList   = []
         if self.SkuId:
             GlobalData.gSKUID_CMD = self.SkuId
         self.ConfDirectory = BuildOptions.ConfDirectory
@@ -797,6 +826,11 @@ class Build():
         GlobalData.gDatabasePath = os.path.normpath(os.path.join(GlobalData.gConfDirectory, GlobalData.gDatabasePath))
         if not os.path.exists(os.path.join(GlobalData.gConfDirectory, '.cache')):
             os.makedirs(os.path.join(GlobalData.gConfDirectory, '.cache'))
+        if not BuildOptions.DisableCache:
+            GlobalData.gMetaFileCacheDir = os.path.join(GlobalData.gConfDirectory, '.cache', 'MetaFile')
+            GlobalData.gIncludeGraphFile = os.path.join(GlobalData.gConfDirectory, '.cache', 'IncludeGraph')
+        if BuildOptions.TraceFile:
+            gBuildTrace.Enable(os.path.abspath(BuildOptions.TraceFile))
         self.Db = BuildDB
         self.BuildDatabase = self.Db.BuildObject
         self.Platform = None
@@ -1014,6 +1048,7 @@ class Build():
         self.ToolChainFamily = ToolChainFamily
 
         self.ThreadNumber   = ThreadNum()
+        GlobalData.gThreadNumber = self.ThreadNumber
     ## Initialize build configuration
     #
     #   This method will parse DSC file and merge the configurations from
@@ -2177,8 +2212,11 @@ class Build():
         CmdListDict = {}
         if GlobalData.gEnableGenfdsMultiThread and self.Fdf:
             CmdListDict = self._GenFfsCmd(Wa.ArchList)
+            self.FdsImageList = GenFds.GetImageFfsList()
+        self.FfsCommandDict = CmdListDict
 
         self.AutoGenTime += int(round((time.time() - WorkspaceAutoGenTime)))
+        gBuildTrace.Add("WorkspaceAutoGen", "autogen", WorkspaceAutoGenTime, time.time(), task="WorkspaceAutoGen")
         BuildModules = []
         for Arch in Wa.ArchList:
             PcdMaList    = []
@@ -2239,6 +2277,7 @@ class Build():
             Pa.DataPipe.dump(data_pipe_file)
 
             mqueue.put((None,None,None,None,None,None,None))
+            gBuildTrace.Add("PlatformAutoGen [%s]" % Arch, "autogen", AutoGenStart, time.time(), task="PlatformAutoGen [%s]" % Arch)
             autogen_rt, errorcode = self.StartAutoGen(mqueue, Pa.DataPipe, self.SkipAutoGen, PcdMaList, cqueue)
 
             if not autogen_rt:
@@ -2291,6 +2330,7 @@ class Build():
                 index += 1
                 ExitFlag = threading.Event()
                 ExitFlag.clear()
+                AutoGenPhaseStart = time.time()
                 if self.SkipAutoGen:
                     Wa = self.VerifyAutoGenFiles()
                     if Wa is None:
@@ -2303,34 +2343,41 @@ class Build():
                     Wa, self.BuildModules = self.PerformAutoGen(BuildTarget,ToolChain)
                 Pa = Wa.AutoGenObjectList[0]
                 GlobalData.gAutoGenPhase = False
+                gBuildTrace.Add("AutoGen", "phase", AutoGenPhaseStart, time.time())
 
                 if GlobalData.gBinCacheSource:
                     EdkLogger.quiet("[cache Summary]: Total module num: %s" % len(self.AllModules))
                     EdkLogger.quiet("[cache Summary]: PreMakecache miss num: %s " % len(self.PreMakeCacheMiss))
                     EdkLogger.quiet("[cache Summary]: Makecache miss num: %s " % len(self.MakeCacheMiss))
 
-                for Arch in Wa.ArchList:
+                MakePhaseStart = time.time()
+                if self.Backend == "ninja":
                     MakeStart = time.time()
-                    for Ma in set(self.BuildModules):
-                        # Generate build task for the module
-                        if not Ma.IsBinaryModule:
-                            Bt = BuildTask.New(ModuleMakeUnit(Ma, Pa.BuildCommand,self.Target))
-                        # Break build if any build thread has error
+                    self._NinjaBuildModules(Wa, Pa)
+                    self.MakeTime += int(round((time.time() - MakeStart)))
+                else:
+                    for Arch in Wa.ArchList:
+                        MakeStart = time.time()
+                        for Ma in set(self.BuildModules):
+                            # Generate build task for the module
+                            if not Ma.IsBinaryModule:
+                                Bt = BuildTask.New(ModuleMakeUnit(Ma, Pa.BuildCommand,self.Target))
+                            # Break build if any build thread has error
+                            if BuildTask.HasError():
+                                # we need a full version of makefile for platform
+                                ExitFlag.set()
+                                BuildTask.WaitForComplete()
+                                Pa.CreateMakeFile(False)
+                                EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
+                            # Start task scheduler
+                            if not BuildTask.IsOnGoing():
+                                BuildTask.StartScheduler(self.ThreadNumber, ExitFlag)
+
+                        # in case there's an interruption. we need a full version of makefile for platform
+
                         if BuildTask.HasError():
-                            # we need a full version of makefile for platform
-                            ExitFlag.set()
-                            BuildTask.WaitForComplete()
-                            Pa.CreateMakeFile(False)
                             EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
-                        # Start task scheduler
-                        if not BuildTask.IsOnGoing():
-                            BuildTask.StartScheduler(self.ThreadNumber, ExitFlag)
-
-                    # in case there's an interruption. we need a full version of makefile for platform
-
-                    if BuildTask.HasError():
-                        EdkLogger.error("build", BUILD_ERROR, "Failed to build module", ExtraData=GlobalData.gBuildingModule)
-                    self.MakeTime += int(round((time.time() - MakeStart)))
+                        self.MakeTime += int(round((time.time() - MakeStart)))
 
                 MakeContiue = time.time()
                 #
@@ -2352,6 +2399,7 @@ class Build():
                 ModuleList = {ma.Guid.upper(): ma for ma in self.BuildModules}
                 self.BuildModules = []
                 self.MakeTime += int(round((time.time() - MakeContiue)))
+                gBuildTrace.Add("Make", "phase", MakePhaseStart, time.time())
                 #
                 # Check for build error, and raise exception if one
                 # has been signaled.
@@ -2391,12 +2439,117 @@ class Build():
                         #
                         self._CollectFvMapBuffer(MapBuffer, Wa, ModuleList)
                         self.GenFdsTime += int(round((time.time() - GenFdsStart)))
+                        gBuildTrace.Add("GenFds", "phase", GenFdsStart, time.time())
                     #
                     # Save MAP buffer into MAP file.
                     #
                     self._SaveMapFile(MapBuffer, Wa)
                 self.CreateGuidedSectionToolsFile(Wa)
 
+    ## Build the modules of the platform and their FFS files with ninja
+    #
+    #   Ninja runs the makefiles of the modules which are out of date, in the
+    #   order of their library dependencies, and then the FFS edges of the
+    #   modules it built. The dependency files of the modules which were built
+    #   are updated afterwards, the same as the make backend does after each
+    #   make run.
+    #
+    #   @param  Wa              Object of WorkspaceAutoGen class
+    #   @param  Pa              Object of PlatformAutoGen class
+    #
+    def _NinjaBuildModules(self, Wa, Pa):
+        Ninja = shutil.which("ninja")
+        if not Ninja:
+            EdkLogger.error("build", FILE_NOT_FOUND, "ninja is required by --backend=ninja but not found in PATH")
+
+        NinjaFile = NinjaBuildFile(Wa, [Ma for Ma in set(self.BuildModules) if not Ma.IsBinaryModule],
+                                   Pa.BuildCommand, self.MakeFileName, self.FfsCommandDict, self.FdsImageList)
+        NinjaFile.Generate()
+
+        StampTime = {}
+        for Ma in NinjaFile.LibraryList + NinjaFile.ModuleList:
+            Stamp = NinjaFile.GetStampFile(Ma)
+            StampTime[Ma] = os.path.getmtime(Stamp) if os.path.exists(Stamp) else None
+        FfsTime = {}
+        for Ma in NinjaFile.FfsFileDict:
+            FfsFile = NinjaFile.FfsFileDict[Ma][0]
+            FfsTime[Ma] = os.path.getmtime(FfsFile) if os.path.exists(FfsFile) else None
+
+        EdkLogger.quiet("Building ... %s" % NinjaFile.FileName)
+        NinjaStart = time.time()
+        LaunchCommand([Ninja, "-f", NinjaFile.FileName, "-j", str(self.ThreadNumber), "modules", "ffs"], Wa.BuildDir)
+
+        BuiltList = []
+        for Ma in NinjaFile.LibraryList + NinjaFile.ModuleList:
+            Stamp = NinjaFile.GetStampFile(Ma)
+            if os.path.exists(Stamp) and os.path.getmtime(Stamp) != StampTime[Ma]:
+                BuiltList.append(Ma)
+                ProcOut = []
+                if Ma.ToolChainFamily == TAB_COMPILER_MSFT:
+                    with open(NinjaFile.GetLogFile(Ma), "r") as Fd:
+                        ProcOut = [Line.rstrip() for Line in Fd]
+                UpdateModuleDeps(Ma.MakeFileDir, Ma, ProcOut)
+            if GlobalData.gUseHashCache and not GlobalData.gBinCacheSource:
+                Ma.GenModuleHash()
+            if GlobalData.gBinCacheDest:
+                Ma.GenCMakeHash()
+        FfsBuiltList = []
+        for Ma in NinjaFile.FfsFileDict:
+            FfsFile = NinjaFile.FfsFileDict[Ma][0]
+            if os.path.exists(FfsFile) and os.path.getmtime(FfsFile) != FfsTime[Ma]:
+                FfsBuiltList.append(Ma)
+        if GlobalData.gBuildTraceFile:
+            self._TraceNinjaLog(Wa, NinjaFile, NinjaStart, BuiltList, FfsBuiltList)
+
+    ## Add the modules and the FFS files built by ninja to the build trace
+    #
+    #   Ninja runs the makefiles in its own processes, so the spans of the
+    #   edges are taken from .ninja_log, which has the start and the end time
+    #   of each edge in milliseconds since ninja started. The edges are laid
+    #   out on as many lanes as ninja ran them in parallel.
+    #
+    #   @param  Wa              Object of WorkspaceAutoGen class
+    #   @param  NinjaFile       Object of NinjaBuildFile class
+    #   @param  NinjaStart      The time ninja was launched
+    #   @param  BuiltList       The modules which were built
+    #   @param  FfsBuiltList    The modules whose FFS files were generated
+    #
+    def _TraceNinjaLog(self, Wa, NinjaFile, NinjaStart, BuiltList, FfsBuiltList):
+        EdgeTime = {}
+        try:
+            with open(os.path.join(Wa.BuildDir, ".ninja_log"), "r") as Fd:
+                for Line in Fd:
+                    Fields = Line.rstrip("\n").split("\t")
+                    if len(Fields) >= 4 and not Line.startswith("#"):
+                        EdgeTime[os.path.normcase(os.path.normpath(Fields[3]))] = (int(Fields[0]), int(Fields[1]))
+        except (OSError, ValueError):
+            return
+
+        MakeTask = lambda Ma: "Make %r" % Ma
+        FfsTask = lambda Ma: "GenFfs %r" % Ma
+        EdgeList = []
+        for Ma in BuiltList:
+            Stamp = os.path.normcase(os.path.normpath(NinjaFile.GetStampFile(Ma)))
+            if Stamp in EdgeTime:
+                EdgeList.append(EdgeTime[Stamp] + (MakeTask(Ma), "make", [MakeTask(La) for La in Ma.LibraryAutoGenList if La in NinjaFile.LibraryList]))
+        for Ma in FfsBuiltList:
+            FfsFile = os.path.normcase(os.path.normpath(NinjaFile.FfsFileDict[Ma][0]))
+            if FfsFile in EdgeTime:
+                EdgeList.append(EdgeTime[FfsFile] + (FfsTask(Ma), "ffs", [MakeTask(Ma)]))
+
+        LaneEnd = []
+        for Start, End, Name, Category, DepList in sorted(EdgeList, key=lambda Edge: Edge[:2]):
+            for Lane, LaneTime in enumerate(LaneEnd):
+                if LaneTime <= Start:
+                    break
+            else:
+                Lane = len(LaneEnd)
+                LaneEnd.append(0)
+                gBuildTrace.SetThreadName("ninja %d" % Lane, Lane)
+            LaneEnd[Lane] = End
+            gBuildTrace.Add(Name, Category, NinjaStart + Start / 1000.0, NinjaStart + End / 1000.0, Lane,
+                            task=Name, deps=DepList)
+
     ## GetFreeSizeThreshold()
     #
     #   @retval int             Threshold value
@@ -2506,16 +2659,23 @@ class Build():
         if not self.ModuleFile:
             if not self.SpawnMode or self.Target not in ["", "all"]:
                 self.SpawnMode = False
+                self._WarnNinjaBackend()
                 self._BuildPlatform()
             else:
                 self._MultiThreadBuildPlatform()
         else:
             self.SpawnMode = False
+            self._WarnNinjaBackend()
             self._BuildModule()
 
         if self.Target == 'cleanall':
             RemoveDirectory(os.path.dirname(GlobalData.gDatabasePath), True)
 
+    ## Tell that the ninja backend is only used by the multi-thread platform build
+    def _WarnNinjaBackend(self):
+        if self.Backend == "ninja":
+            EdkLogger.warn("build", "The ninja backend is only used for a multi-thread build of the whole platform, make is used instead")
+
     def CreateAsBuiltInf(self):
         for Module in self.BuildModules:
             Module.CreateAsBuiltInf()
@@ -2794,6 +2954,14 @@ def Main():
     EdkLogger.SetLevel(EdkLogger.QUIET)
     EdkLogger.quiet("\n- %s -" % Conclusion)
     EdkLogger.quiet(time.strftime("Build end time: %H:%M:%S, %b.%d %Y", time.localtime()))
+    if GlobalData.gMetaFileCacheDir:
+        EdkLogger.quiet("Meta-file parse: %s" % gMetaFileCache.Summary())
+    if GlobalData.gIncludeGraphFile:
+        gIncludeGraph.Save()
+        EdkLogger.quiet("Include graph: %s" % gIncludeGraph.Summary())
+    if GlobalData.gBuildTraceFile:
+        for Line in gBuildTrace.Save():
+            EdkLogger.quiet(Line)
     EdkLogger.quiet("Build total time: %s\n" % BuildDurationStr)
     Log_Agent.kill()
     Log_Agent.join()
@@ -102,5 +102,12 @@ class MyOptionParser():
         Parser.add_option("--binary-source", action="store", type="string", dest="BinCacheSource", help="Consume a cache of binary files from the specified directory.")
         Parser.add_option("--genfds-multi-thread", action="store_true", dest="GenfdsMultiThread", default=True, help="Enable GenFds multi thread to generate ffs file.")
         Parser.add_option("--no-genfds-multi-thread", action="store_true", dest="NoGenfdsMultiThread", default=False, help="Disable GenFds multi thread to generate ffs file.")
+        Parser.add_option("--backend", action="store", type="choice", choices=['make', 'ninja'], dest="Backend", default="make",
+            help="Choose the scheduler of a platform build. Must be one of: [make, ninja]. "\
+                 "ninja runs the makefile of each library and module as one build edge and skips the modules which are up to date. "\
+                 "With GenFds multi thread, the FFS files of a module are a build edge of their own depending on the module. "\
+                 "The compile and link steps of a module stay in its makefile. Default is make.")
         Parser.add_option("--disable-include-path-check", action="store_true", dest="DisableIncludePathCheck", default=False, help="Disable the include path check for outside of package.")
+        Parser.add_option("--trace-file", action="store", type="string", dest="TraceFile", default=None,
+            help="Record a timeline of the build in the Chrome trace event format into the given file, which can be loaded in chrome://tracing or Perfetto, and print the critical path and the idle CPU time.")
         self.BuildOption, self.BuildTarget = Parser.parse_args()
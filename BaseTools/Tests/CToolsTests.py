@@ -13,8 +13,18 @@ import os
 import sys
 import unittest
 
+import FvScheduler
+import GenFv
+import GenNinja
+import GenSecFfs
+import LzmaCompress
 import TianoCompress
 modules = (
+    FvScheduler,
+    GenFv,
+    GenNinja,
+    GenSecFfs,
+    LzmaCompress,
     TianoCompress,
     )
 
@@ -0,0 +1,212 @@
+## @file
+# Unit tests for the FV build planner of GenFds
+#
+# The planner of BaseTools/Source/Python/GenFds/FvScheduler.py must plan the
+# FVs in the order the serial pass builds them, and GenFds must generate the
+# same FD and capsule images with one process as with several.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import shutil
+import unittest
+
+import TestTools
+from Common.MultipleWorkspace import MultipleWorkspace as mws
+from GenFds.FdfParser import FdfParser
+from GenFds.GenFdsGlobalVariable import GenFdsGlobalVariable
+from GenFds.FvScheduler import FvScheduler
+
+FV_ATTRIBUTES = '''FvAlignment        = 16
+ERASE_POLARITY     = 1
+MEMORY_MAPPED      = TRUE
+STICKY_WRITE       = TRUE
+LOCK_CAP           = TRUE
+LOCK_STATUS        = TRUE
+WRITE_DISABLED_CAP = TRUE
+WRITE_ENABLED_CAP  = TRUE
+WRITE_STATUS       = TRUE
+WRITE_LOCK_CAP     = TRUE
+WRITE_LOCK_STATUS  = TRUE
+READ_DISABLED_CAP  = TRUE
+READ_ENABLED_CAP   = TRUE
+READ_STATUS        = TRUE
+READ_LOCK_CAP      = TRUE
+READ_LOCK_STATUS   = TRUE
+'''
+
+#
+# MAIN is built in the FD region, with DXE compressed in it. UPDATE is only
+# built for the capsule.
+#
+TEST_FDF = '''[FD.TEST]
+BaseAddress   = 0xFF000000
+Size          = 0x00100000
+ErasePolarity = 1
+BlockSize     = 0x1000
+NumBlocks     = 0x100
+
+0x00000000|0x00100000
+FV = MAIN
+
+[FV.MAIN]
+%(Attributes)s
+FILE RAW = 4A5C7E0B-8D7B-4F55-9F28-3F3B9B6C2A01 {
+  main.bin
+}
+FILE FV_IMAGE = 9E21FD93-9C72-4C15-8C4B-E77F1DB2D792 {
+  SECTION COMPRESS {
+    SECTION FV_IMAGE = DXE
+  }
+}
+
+[FV.DXE]
+%(Attributes)s
+FILE RAW = 4A5C7E0B-8D7B-4F55-9F28-3F3B9B6C2A02 {
+  dxe.bin
+}
+
+[FV.UPDATE]
+%(Attributes)s
+FILE RAW = 4A5C7E0B-8D7B-4F55-9F28-3F3B9B6C2A03 {
+  update.bin
+}
+
+[Capsule.TESTCAP]
+CAPSULE_GUID        = 3B6686BD-0D76-4030-B70E-B5519E2FC5A0
+CAPSULE_FLAGS       = PersistAcrossReset
+CAPSULE_HEADER_SIZE = 0x20
+
+FV = UPDATE
+''' % {'Attributes': FV_ATTRIBUTES}
+
+TEST_DSC = '''[Defines]
+  PLATFORM_NAME           = Test
+  PLATFORM_GUID           = 5A9E7754-D81B-49EA-85AD-69EAA7B1539B
+  PLATFORM_VERSION        = 0.1
+  DSC_SPECIFICATION       = 0x00010005
+  OUTPUT_DIRECTORY        = Build/Test
+  SUPPORTED_ARCHITECTURES = X64
+  BUILD_TARGETS           = DEBUG
+  FLASH_DEFINITION        = Test.fdf
+'''
+
+TEST_TARGET = '''ACTIVE_PLATFORM  = Test.dsc
+TARGET           = DEBUG
+TARGET_ARCH      = X64
+TOOL_CHAIN_CONF  = Conf/tools_def.txt
+TOOL_CHAIN_TAG   = GCC5
+BUILD_RULE_CONF  = Conf/build_rule.txt
+'''
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'GenFds'
+        self.savedWorkspace = os.environ.get('WORKSPACE')
+        os.environ['WORKSPACE'] = self.testDir
+
+        os.mkdir(self.GetTmpFilePath('Conf'))
+        ConfDir = os.path.join(TestTools.BaseToolsDir, 'Conf')
+        shutil.copy(os.path.join(ConfDir, 'tools_def.template'), self.GetTmpFilePath(os.path.join('Conf', 'tools_def.txt')))
+        shutil.copy(os.path.join(ConfDir, 'build_rule.template'), self.GetTmpFilePath(os.path.join('Conf', 'build_rule.txt')))
+        self.WriteTmpFile(os.path.join('Conf', 'target.txt'), TEST_TARGET)
+        self.WriteTmpFile('Test.dsc', TEST_DSC)
+        self.WriteTmpFile('Test.fdf', TEST_FDF)
+        self.WriteTmpFile('main.bin', os.urandom(0x1234))
+        self.WriteTmpFile('dxe.bin', os.urandom(0x2345))
+        self.WriteTmpFile('update.bin', os.urandom(0x3456))
+
+    def tearDown(self):
+        GenFdsGlobalVariable.FdfParser = None
+        if self.savedWorkspace is None:
+            del os.environ['WORKSPACE']
+        else:
+            os.environ['WORKSPACE'] = self.savedWorkspace
+        TestTools.BaseToolsTest.tearDown(self)
+
+    def GetScheduler(self):
+        GenFdsGlobalVariable.WorkSpaceDir = self.testDir
+        mws.setWs(self.testDir, None)
+        Parser = FdfParser(self.GetTmpFilePath('Test.fdf'))
+        Parser.ParseFile()
+        GenFdsGlobalVariable.FdfParser = Parser
+        return FvScheduler(8)
+
+    def GetDependencies(self, scheduler):
+        scheduler.LinkJobs()
+        return [(str(job), [str(depend) for depend in job.DependList]) for job in scheduler.JobList]
+
+    def testPlan(self):
+        scheduler = self.GetScheduler()
+        profile = GenFdsGlobalVariable.FdfParser.Profile
+        for fd in profile.FdDict.values():
+            self.assertTrue(scheduler.AddFd(fd))
+        for fv in profile.FvDict.values():
+            self.assertTrue(scheduler.AddFv(fv.UiFvName))
+        for capsule in profile.CapsuleDict.values():
+            self.assertTrue(scheduler.AddCapsule(capsule))
+        self.assertFalse(scheduler.Stopped)
+        #
+        # DXE is taken from ImageBinDict by the compressed section of MAIN,
+        # so that it is built first and MAIN waits for it.
+        #
+        self.assertEqual(self.GetDependencies(scheduler), [
+            ('DXE', []),
+            ('MAIN at 0xFF000000', ['DXE']),
+            ('UPDATE', []),
+            ])
+        self.assertIn(('fv', 'DXE'), scheduler.JobList[1].Resources)
+        self.assertIn(('file', '4A5C7E0B-8D7B-4F55-9F28-3F3B9B6C2A02'), scheduler.JobList[1].Resources)
+
+    def testPlanCapsule(self):
+        scheduler = self.GetScheduler()
+        self.assertTrue(scheduler.AddCapsule(GenFdsGlobalVariable.FdfParser.Profile.CapsuleDict['TESTCAP']))
+        self.assertEqual(self.GetDependencies(scheduler), [('UPDATE', [])])
+        #
+        # Only a capsule in an FD region passes its name to its FVs.
+        #
+        self.assertIsNone(scheduler.JobList[0].CapsuleName)
+
+    def GenerateImages(self, threadNumber):
+        outputDir = self.GetTmpFilePath(os.path.join('Build', 'Test', 'DEBUG_GCC5'))
+        if os.path.exists(outputDir):
+            self.RemoveDir(outputDir)
+        os.makedirs(outputDir)
+        result = self.RunTool(
+            '-w', self.testDir, '-p', 'Test.dsc', '-f', 'Test.fdf',
+            '-a', 'X64', '-b', 'DEBUG', '-t', 'GCC5', '--conf', 'Conf',
+            '-n', str(threadNumber),
+            logFile='log'
+            )
+        if result != 0:
+            print()
+            self.DisplayFile('log')
+        self.assertTrue(result == 0)
+        images = {}
+        for name in ('TEST.fd', 'TESTCAP.Cap', 'MAIN.Fv', 'DXE.Fv', 'UPDATE.Fv'):
+            images[name] = self.ReadTmpFile(os.path.join('Build', 'Test', 'DEBUG_GCC5', 'FV', name))
+        return images
+
+    def testThreadsOutputIdentical(self):
+        single = self.GenerateImages(1)
+        for threadNumber in (2, 8):
+            multi = self.GenerateImages(threadNumber)
+            for name in sorted(single):
+                if single[name] != multi[name]:
+                    print()
+                    print('%s generated with %d processes did not match' % (name, threadNumber))
+                self.assertTrue(single[name] == multi[name])
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,153 @@
+## @file
+# Unit tests for GenFv utility
+#
+# The FFS files of an FV are rebased on a pool of threads. The FV image and
+# the map and report files must not depend on the number of threads.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import random
+import struct
+import unittest
+
+import TestTools
+
+FV_NAME_GUID = '8C8CE578-8A3D-4F1C-9935-896185C32DD3'
+IMAGE_BASE = 0x10000000
+IMAGE_FILE_MACHINE_X64 = 0x8664
+IMAGE_REL_BASED_DIR64 = 10
+EFI_IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER = 0xB
+
+def Align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+## Build a PE32+ image with a code section and the relocations of it
+#
+#   @param  codeSize            The size of the code section
+#   @param  fixupCount          The number of 64-bit fixups in the code section
+#   @param  sectionAlignment    The section alignment, XIP images have the
+#                               same section and file alignment
+#
+def GetPeImage(codeSize, fixupCount, sectionAlignment=0x20):
+    fileAlignment = 0x20
+    headersSize = Align(0x40 + 4 + 20 + 0xF0 + 2 * 40, sectionAlignment)
+    codeRva = headersSize
+    codeSize = Align(codeSize, sectionAlignment)
+    code = bytearray(os.urandom(codeSize))
+    pages = {}
+    for offset in sorted(random.sample(range(0, codeSize - 8, 8), fixupCount)):
+        struct.pack_into('<Q', code, offset, IMAGE_BASE + codeRva + random.randrange(codeSize))
+        pages.setdefault((codeRva + offset) & ~0xFFF, []).append((codeRva + offset) & 0xFFF)
+    reloc = b''
+    for page in sorted(pages):
+        entries = [(IMAGE_REL_BASED_DIR64 << 12) | offset for offset in pages[page]]
+        if len(entries) % 2:
+            entries.append(0)
+        reloc += struct.pack('<II', page, 8 + 2 * len(entries))
+        reloc += struct.pack('<%dH' % len(entries), *entries)
+    relocRva = codeRva + codeSize
+    relocSize = Align(len(reloc), sectionAlignment)
+
+    header = b'MZ'.ljust(0x3C, b'\0') + struct.pack('<I', 0x40) + b'PE\0\0'
+    header += struct.pack('<HHIIIHH', IMAGE_FILE_MACHINE_X64, 2, 0, 0, 0, 0xF0, 0x2022)
+    header += struct.pack(
+        '<HBBIIIIIQIIHHHHHHIIIIHHQQQQII',
+        0x20B, 0, 0, codeSize, relocSize, 0, codeRva, codeRva, IMAGE_BASE,
+        sectionAlignment, fileAlignment, 0, 0, 0, 0, 0, 0, 0,
+        relocRva + relocSize, headersSize, 0,
+        EFI_IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER, 0,
+        0x10000, 0x10000, 0x10000, 0x10000, 0, 16
+        )
+    for index in range(16):
+        header += struct.pack('<II', *((relocRva, len(reloc)) if index == 5 else (0, 0)))
+    header += struct.pack('<8sIIIIIIHHI', b'.text', codeSize, codeRva, codeSize, codeRva, 0, 0, 0, 0, 0x60000020)
+    header += struct.pack('<8sIIIIIIHHI', b'.reloc', len(reloc), relocRva, relocSize, relocRva, 0, 0, 0, 0, 0x42000040)
+    return header.ljust(headersSize, b'\0') + bytes(code) + reloc.ljust(relocSize, b'\0')
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'GenFv'
+        self.ffsFiles = []
+
+    def WriteFfsFile(self, name, fileType, peImage):
+        self.WriteTmpFile(name + '.efi', peImage)
+        result = self.RunTool(
+            '-s', 'EFI_SECTION_PE32',
+            '-o', self.GetTmpFilePath(name + '.sec'),
+            self.GetTmpFilePath(name + '.efi'),
+            toolName='GenSec'
+            )
+        self.assertTrue(result == 0)
+        result = self.RunTool(
+            '-t', fileType,
+            '-g', '%08X-6B5A-4E7B-9B58-43C3A0F5D7E1' % len(self.ffsFiles),
+            '-o', self.GetTmpFilePath(name + '.ffs'),
+            '-i', self.GetTmpFilePath(name + '.sec'),
+            toolName='GenFfs'
+            )
+        self.assertTrue(result == 0)
+        self.ffsFiles.append(self.GetTmpFilePath(name + '.ffs'))
+
+    def WriteFfsFiles(self, count):
+        for index in range(count):
+            fileType = ('EFI_FV_FILETYPE_PEIM', 'EFI_FV_FILETYPE_DRIVER')[index % 2]
+            peImage = GetPeImage(random.randint(0x200, 0x8000), random.randint(4, 64))
+            self.WriteFfsFile('module%d' % index, fileType, peImage)
+
+    def GenerateFv(self, threadNumber):
+        name = 'threads%d' % threadNumber
+        args = ['-o', self.GetTmpFilePath(name + '.fv'), '-b', '0x1000', '-r', '0xFF000000', '-g', FV_NAME_GUID]
+        for ffsFile in self.ffsFiles:
+            args += ['-f', ffsFile]
+        args += ['--threads', str(threadNumber)]
+        return self.RunTool(*args, logFile=name + '.log'), name
+
+    def testHelp(self):
+        result = self.RunTool('--help', logFile='help')
+        self.assertTrue(result == 0)
+
+    def testThreadsOutputIdentical(self):
+        self.WriteFfsFiles(24)
+        outputs = []
+        for threadNumber in (1, 2, 8):
+            result, name = self.GenerateFv(threadNumber)
+            self.assertTrue(result == 0)
+            outputs.append([self.ReadTmpFile(name + suffix) for suffix in ('.fv', '.fv.map', '.fv.txt')])
+        #
+        # Every module is rebased to its flash address.
+        #
+        self.assertTrue(outputs[0][1].count(b'Fixed Flash Address') == len(self.ffsFiles))
+        for output in outputs[1:]:
+            self.assertTrue(output == outputs[0])
+
+    def testThreadsRebaseError(self):
+        #
+        # The error of a module rebased in a worker thread must be reported
+        # as it is by a serial rebase.
+        #
+        self.WriteFfsFiles(8)
+        self.WriteFfsFile('misaligned', 'EFI_FV_FILETYPE_PEIM', GetPeImage(0x2000, 16, 0x1000))
+        logs = []
+        for threadNumber in (1, 2, 8):
+            result, name = self.GenerateFv(threadNumber)
+            self.assertTrue(result != 0)
+            self.assertFalse(os.path.exists(self.GetTmpFilePath(name + '.fv')))
+            logs.append(self.ReadTmpFile(name + '.log'))
+        self.assertTrue(b'Section-Alignment and File-Alignment do not match' in logs[0])
+        for log in logs[1:]:
+            self.assertTrue(log == logs[0])
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,147 @@
+## @file
+# Unit tests for the ninja build file generator
+#
+# The build file of BaseTools/Source/Python/AutoGen/GenNinja.py must have an
+# FFS edge per module depending on the module stamp, and an edge per FD and per
+# FV outside the FD regions depending on the FFS files of the modules in it.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import unittest
+
+import TestTools
+from Common.MultipleWorkspace import MultipleWorkspace as mws
+from AutoGen.GenNinja import NinjaBuildFile, NINJA_STAMP_FILE
+from GenFds.FdfParser import FdfParser
+from GenFds.GenFds import GenFds
+from GenFds.GenFdsGlobalVariable import GenFdsGlobalVariable
+from FvScheduler import TEST_FDF
+
+class MetaFile(object):
+    def __init__(self, path):
+        self.Path = path
+
+class Module(object):
+    def __init__(self, testDir, name, customMakefile):
+        self.Name = name
+        self.Arch = 'X64'
+        self.MetaFile = MetaFile(os.path.join(testDir, name + '.inf'))
+        self.MakeFileDir = os.path.join(testDir, 'Build', name)
+        self.DebugDir = os.path.join(self.MakeFileDir, 'DEBUG')
+        self.SourceFileList = []
+        self.LibraryAutoGenList = []
+        self.IsBinaryModule = False
+        self.CustomMakefile = customMakefile
+        os.makedirs(self.MakeFileDir)
+
+    def CanSkipbyCache(self, cacheHit):
+        return False
+
+    def __str__(self):
+        return self.Name + '.inf'
+
+class Workspace(object):
+    def __init__(self, testDir):
+        self.WorkspaceDir = testDir
+        self.BuildDir = os.path.join(testDir, 'Build')
+        self.FdfFile = os.path.join(testDir, 'Test.fdf')
+        self.GenFdsCommand = 'GenFds -f Test.fdf'
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.WriteTmpFile('Test.fdf', TEST_FDF)
+        for name in ('main.bin', 'dxe.bin', 'update.bin'):
+            self.WriteTmpFile(name, b'')
+        mws.setWs(self.testDir, None)
+        GenFdsGlobalVariable.WorkSpaceDir = self.testDir
+        GenFdsGlobalVariable.FvDir = self.GetTmpFilePath('FV')
+        Parser = FdfParser(self.GetTmpFilePath('Test.fdf'))
+        Parser.ParseFile()
+        GenFdsGlobalVariable.FdfParser = Parser
+
+        #
+        # What the FFS pass of GenFfsMakefile records: MAIN has the FFS of
+        # the Main module, DXE is nested in MAIN and has the FFS of the Dxe
+        # module, UPDATE is outside the FD.
+        #
+        self.Ffs = dict((name, self.GetTmpFilePath(os.path.join('Ffs', name + '.ffs'))) for name in ('Main', 'Dxe', 'Update', 'Binary'))
+        GenFdsGlobalVariable.FvFfsDict = {
+            'MAIN': [self.Ffs['Main'], self.Ffs['Binary']],
+            'DXE': [self.Ffs['Dxe']],
+            'UPDATE': [self.Ffs['Update']],
+            }
+        GenFdsGlobalVariable.ImageBinDict = dict((name + 'fv', os.path.join(GenFdsGlobalVariable.FvDir, name + '.Fv')) for name in GenFdsGlobalVariable.FvFfsDict)
+
+    def tearDown(self):
+        GenFdsGlobalVariable.FdfParser = None
+        GenFdsGlobalVariable.FvFfsDict = {}
+        GenFdsGlobalVariable.ImageBinDict = {}
+        TestTools.BaseToolsTest.tearDown(self)
+
+    def GetFfsCommand(self, name):
+        ffsCmd = ('GenFfs', '-t', 'EFI_FV_FILETYPE_DRIVER', '-g', name, '-o', self.Ffs[name], '-oi', name + '.pe32')
+        return [(ffsCmd, (), ())]
+
+    def testImageList(self):
+        imageList = GenFds.GetImageFfsList()
+        self.assertEqual(imageList, [
+            ('-r', 'TEST', os.path.join(GenFdsGlobalVariable.FvDir, 'TEST.fd'), [self.Ffs['Main'], self.Ffs['Binary'], self.Ffs['Dxe']]),
+            ('-i', 'UPDATE', os.path.join(GenFdsGlobalVariable.FvDir, 'UPDATE.Fv'), [self.Ffs['Update']]),
+            ])
+
+    def testBuildFile(self):
+        modules = [Module(self.testDir, name, {}) for name in ('Main', 'Dxe', 'Update')]
+        custom = Module(self.testDir, 'Custom', {'gmake': 'GNUmakefile'})
+        ffsCommandDict = dict(((module.MetaFile.Path, module.Arch), self.GetFfsCommand(module.Name)) for module in modules)
+        ffsCommandDict[custom.MetaFile.Path, custom.Arch] = self.GetFfsCommand('Binary')
+
+        ninjaFile = NinjaBuildFile(Workspace(self.testDir), modules + [custom], ['make', '-f'], 'GNUmakefile',
+                                   ffsCommandDict, GenFds.GetImageFfsList())
+        self.assertTrue(ninjaFile.Generate())
+        with open(ninjaFile.FileName) as buildFile:
+            content = buildFile.read()
+        edges = dict((block.split('\n')[0], block) for block in content.split('\n\n'))
+
+        stamp = lambda module: os.path.join(module.MakeFileDir, NINJA_STAMP_FILE)
+        makefile = lambda module: os.path.join(module.MakeFileDir, 'GNUmakefile')
+        #
+        # A module with FFS commands only builds the module, its FFS files
+        # have an edge of their own depending on the module stamp.
+        #
+        for module in modules:
+            self.assertIn('  target = nbuild', edges['build %s: make %s' % (stamp(module), makefile(module))])
+            self.assertIn('build %s: ffs %s | %s' % (self.Ffs[module.Name], stamp(module), makefile(module)), edges)
+        #
+        # A custom makefile has no gen_ffs target.
+        #
+        self.assertIn('  target = tbuild', edges['build %s: make %s' % (stamp(custom), makefile(custom))])
+        self.assertNotIn(self.Ffs['Binary'], content)
+        #
+        # The FD depends on the FFS files of MAIN and of DXE nested in it, and
+        # no edge generates the FVs of its regions.
+        #
+        fdEdge = edges['build %s: genfds %s %s | %s' % (os.path.join(GenFdsGlobalVariable.FvDir, 'TEST.fd'),
+                                                        self.Ffs['Main'], self.Ffs['Dxe'], self.GetTmpFilePath('Test.fdf'))]
+        self.assertIn('  image = -r TEST', fdEdge)
+        self.assertIn('  pool = genfds', fdEdge)
+        self.assertIn('build %s: genfds %s | %s' % (os.path.join(GenFdsGlobalVariable.FvDir, 'UPDATE.Fv'),
+                                                    self.Ffs['Update'], self.GetTmpFilePath('Test.fdf')), edges)
+        self.assertNotIn('MAIN.Fv', content)
+        self.assertNotIn('DXE.Fv', content)
+        self.assertIn('build ffs: phony %s' % ' '.join(self.Ffs[module.Name] for module in modules), content)
+        self.assertIn('default modules ffs', content)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,164 @@
+## @file
+# Unit tests for the in-process section and FFS generation of GenFds
+#
+# The output of BaseTools/Source/Python/GenFds/GenSecFfs.py must be identical
+# to the output of the GenSec and GenFfs utilities for the same input.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import struct
+import unittest
+
+import TestTools
+from GenFds import GenSecFfs
+
+DRIVER_GUID = '7A9354D9-0468-444A-81CE-0BF617D890DF'
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'GenSec'
+
+    def WriteSection(self, fileName, type, data):
+        self.WriteTmpFile(fileName, GenSecFfs.PackSectionHeader(type, len(data) + 4) + data)
+        return self.GetTmpFilePath(fileName)
+
+    def WriteTeSection(self, fileName, strippedSize, size):
+        te = struct.pack('<HHBBH', 0x5A56, 0x14C, 1, 0x0B, strippedSize)
+        te += os.urandom(size - len(te))
+        return self.WriteSection(fileName, 0x12, te)
+
+    def WriteGuidedSection(self, fileName, attributes, size):
+        guided = os.urandom(16) + struct.pack('<HH', 4 + 20 + 8, attributes)
+        guided += os.urandom(size - len(guided))
+        return self.WriteSection(fileName, 0x02, guided)
+
+    def CheckOutput(self, data, toolName, *args):
+        result = self.RunTool(*args + ('-o', self.GetTmpFilePath('expected')), toolName=toolName)
+        self.assertTrue(result == 0)
+        expected = self.ReadTmpFile('expected')
+        if data != expected:
+            print()
+            print('%s output did not match the in-process output' % toolName)
+            self.DisplayBinaryData('in-process', data)
+            self.DisplayBinaryData(toolName, expected)
+        self.assertTrue(data == expected)
+
+    def testLeafSections(self):
+        self.WriteTmpFile('input', os.urandom(1021))
+        for type in sorted(GenSecFfs.gLeafSectionType):
+            data = GenSecFfs.GenLeafSection(type, [self.GetTmpFilePath('input')])
+            self.CheckOutput(data, 'GenSec', '-s', type, self.GetTmpFilePath('input'))
+
+    def testLargeLeafSection(self):
+        self.WriteTmpFile('input', os.urandom(GenSecFfs.MAX_SECTION_SIZE))
+        data = GenSecFfs.GenLeafSection('EFI_SECTION_RAW', [self.GetTmpFilePath('input')])
+        self.CheckOutput(data, 'GenSec', '-s', 'EFI_SECTION_RAW', self.GetTmpFilePath('input'))
+
+    def testVersionSection(self):
+        data = GenSecFfs.GenVersionSection('"1.0 beta"', '42')
+        self.CheckOutput(data, 'GenSec', '-s', 'EFI_SECTION_VERSION', '-n', '1.0 beta', '-j', '42')
+        data = GenSecFfs.GenVersionSection('2.1')
+        self.CheckOutput(data, 'GenSec', '-s', 'EFI_SECTION_VERSION', '-n', '2.1')
+
+    def testUiSection(self):
+        data = GenSecFfs.GenUiSection('My Driver')
+        self.CheckOutput(data, 'GenSec', '-s', 'EFI_SECTION_USER_INTERFACE', '-n', 'My Driver')
+
+    def testSectionList(self):
+        inputs = [
+            self.WriteSection('raw', 0x19, os.urandom(13)),
+            self.WriteTeSection('te', 0x1D8, 0x611),
+            self.WriteGuidedSection('guided', 0x02, 0x203),
+            self.WriteSection('pe32', 0x10, os.urandom(0x1001)),
+            ]
+        data = GenSecFfs.GenSectionList(inputs)
+        self.CheckOutput(data, 'GenSec', *inputs)
+        for align in (('1', '4K', '32', '16'), ('8', '64', '4K', '1K')):
+            args = []
+            for value in align:
+                args += ['--sectionalign', value]
+            data = GenSecFfs.GenSectionList(inputs, list(align))
+            self.CheckOutput(data, 'GenSec', *tuple(args + inputs))
+
+    def CheckFfs(self, type, inputs, align=None, sectionAlign=None, fixed=False, checkSum=False):
+        data = GenSecFfs.GenFfsFile(type, DRIVER_GUID, inputs, fixed, checkSum, align, sectionAlign)
+        args = ['-t', type, '-g', DRIVER_GUID]
+        if fixed:
+            args.append('-x')
+        if checkSum:
+            args.append('-s')
+        if align:
+            args += ['-a', align]
+        for index, input in enumerate(inputs):
+            args += ['-i', input]
+            if sectionAlign and sectionAlign[index]:
+                args += ['-n', sectionAlign[index]]
+        self.CheckOutput(data, 'GenFfs', *args)
+
+    def testFfsFiles(self):
+        depex = self.WriteSection('depex', 0x13, os.urandom(9))
+        pe32 = self.WriteSection('pe32', 0x10, os.urandom(0x2345))
+        te = self.WriteTeSection('te', 0x1D8, 0x611)
+        ui = self.WriteSection('ui', 0x15, 'Driver\0'.encode('utf-16-le'))
+        self.CheckFfs('EFI_FV_FILETYPE_DRIVER', [depex, pe32, ui])
+        self.CheckFfs('EFI_FV_FILETYPE_DRIVER', [depex, pe32, ui], checkSum=True)
+        self.CheckFfs('EFI_FV_FILETYPE_DRIVER', [depex, pe32, ui], align='16', sectionAlign=[None, '4K', None])
+        self.CheckFfs('EFI_FV_FILETYPE_PEIM', [depex, te, ui], sectionAlign=[None, '32', None], fixed=True)
+        self.CheckFfs('EFI_FV_FILETYPE_PEIM', [depex, te, ui], align='1K', sectionAlign=['4', '64K', '1'], fixed=True, checkSum=True)
+        self.CheckFfs('EFI_FV_FILETYPE_PEI_CORE', [te, ui], sectionAlign=['1M', None])
+        self.CheckFfs('EFI_FV_FILETYPE_FREEFORM', [ui])
+
+    def testLargeFfsFile(self):
+        self.WriteTmpFile('input', os.urandom(GenSecFfs.MAX_FFS_SIZE - 0x10))
+        raw = self.GetTmpFilePath('input')
+        self.CheckFfs('EFI_FV_FILETYPE_RAW', [raw], checkSum=True)
+
+    def testCommandFile(self):
+        self.WriteTmpFile('image', os.urandom(0x1234))
+        image = self.GetTmpFilePath('image')
+        missing = self.GetTmpFilePath('missing')
+        pe32 = self.GetTmpFilePath('pe32')
+        raw = self.GetTmpFilePath('raw')
+        ui = self.GetTmpFilePath('ui')
+        ver = self.GetTmpFilePath('ver')
+        ffs = self.GetTmpFilePath('ffs')
+        commands = [
+            '-test -e %s && GenSec -s EFI_SECTION_PE32 -o %s %s' % (image, pe32, image),
+            '-test -e %s && GenSec -s EFI_SECTION_RAW -o %s %s' % (missing, raw, missing),
+            'GenSec -s EFI_SECTION_USER_INTERFACE -n "My Driver" -o %s' % ui,
+            'GenSec -s EFI_SECTION_VERSION -n "1.0" -j 3 -o %s' % ver,
+            'GenFfs -t EFI_FV_FILETYPE_DRIVER -g %s -o %s -oi %s -n 4K -oi %s -oi %s -oi %s' % (DRIVER_GUID, ffs, pe32, raw, ui, ver),
+            ]
+        self.WriteTmpFile('commands', '\n'.join(commands) + '\n')
+        self.assertTrue(GenSecFfs.RunCommandFile(self.GetTmpFilePath('commands')) == 0)
+        self.assertFalse(os.path.exists(raw))
+
+        self.CheckOutput(self.ReadTmpFile('pe32'), 'GenSec', '-s', 'EFI_SECTION_PE32', image)
+        self.CheckOutput(self.ReadTmpFile('ui'), 'GenSec', '-s', 'EFI_SECTION_USER_INTERFACE', '-n', 'My Driver')
+        self.CheckOutput(self.ReadTmpFile('ver'), 'GenSec', '-s', 'EFI_SECTION_VERSION', '-n', '1.0', '-j', '3')
+        self.CheckOutput(self.ReadTmpFile('ffs'), 'GenFfs', '-t', 'EFI_FV_FILETYPE_DRIVER', '-g', DRIVER_GUID,
+                         '-i', pe32, '-n', '4K', '-i', ui, '-i', ver)
+
+        self.WriteTmpFile('commands', 'GenFfs -t EFI_FV_FILETYPE_DRIVER -g %s -o %s -i %s\n' % (DRIVER_GUID, ffs, missing))
+        self.assertTrue(GenSecFfs.RunCommandFile(self.GetTmpFilePath('commands')) != 0)
+
+    def testUnhandledInput(self):
+        self.assertTrue(GenSecFfs.GenLeafSection('EFI_SECTION_RAW', [self.GetTmpFilePath('missing')]) is None)
+        self.assertTrue(GenSecFfs.GenVersionSection('"$VERSION"') is None)
+        self.assertTrue(GenSecFfs.GenSectionList([self.GetTmpFilePath('missing')], ['0']) is None)
+        self.assertTrue(GenSecFfs.GenFfsFile('EFI_FV_FILETYPE_DRIVER', DRIVER_GUID, [self.GetTmpFilePath('missing')]) is None)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
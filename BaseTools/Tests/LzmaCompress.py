@@ -0,0 +1,84 @@
+## @file
+# Unit tests for LzmaCompress utility
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import random
+import unittest
+
+import TestTools
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'LzmaCompress'
+
+    def testHelp(self):
+        result = self.RunTool('--help', logFile='help')
+        self.assertTrue(result == 0)
+
+    def testInvalidThreads(self):
+        self.WriteTmpFile('input', os.urandom(1024))
+        result = self.RunTool(
+            '-e', '--threads', '3',
+            '-o', self.GetTmpFilePath('output'),
+            self.GetTmpFilePath('input')
+            )
+        self.assertTrue(result != 0)
+
+    def GetCompressibleData(self, size):
+        #
+        # Repeat random chunks so that the match finder has work to do
+        #
+        chunks = [os.urandom(random.randint(64, 4096)) for x in range(32)]
+        data = b''
+        while len(data) < size:
+            data += random.choice(chunks)
+        return data[:size]
+
+    def compressionTestCycle(self, data, *options):
+        self.WriteTmpFile('input', data)
+        result = self.RunTool(
+            '-e', '-q',
+            *(options + ('-o', self.GetTmpFilePath('output1'), self.GetTmpFilePath('input')))
+            )
+        self.assertTrue(result == 0)
+        result = self.RunTool(
+            '-d', '-q',
+            '-o', self.GetTmpFilePath('output2'),
+            self.GetTmpFilePath('output1')
+            )
+        self.assertTrue(result == 0)
+        self.assertTrue(self.ReadTmpFile('output2') == data)
+        return self.ReadTmpFile('output1')
+
+    def testRandomDataCycles(self):
+        for i in range(4):
+            data = self.GetCompressibleData(random.randint(1024, 65536))
+            self.compressionTestCycle(data, '--threads', '1')
+            self.compressionTestCycle(data, '--threads', '2')
+            self.CleanUpTmpDir()
+
+    def testThreadsOutputIdentical(self):
+        #
+        # The multithreaded match finder must not change the output, so that
+        # the compressed sections are reproducible on any build machine.
+        #
+        data = self.GetCompressibleData(3 * 1024 * 1024)
+        single = self.compressionTestCycle(data, '--threads', '1')
+        multi = self.compressionTestCycle(data, '--threads', '2')
+        self.assertTrue(single == multi)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+if __name__ == '__main__':
+    allTests = TheTestSuite()
+    unittest.TextTestRunner().run(allTests)
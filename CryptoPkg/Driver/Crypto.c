@@ -5509,6 +5509,66 @@ CryptoServiceTlsGetExportKey (
            );
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can resume it
+  instead of doing a full handshake. If the server declines to resume the
+  session, a full handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the session data returned by TlsGetSession().
+  @param[in]  DataSize        Size of the session data in bytes.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session data is invalid.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsSetSession (
+  IN     VOID        *Tls,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  return CALL_BASECRYPTLIB (TlsSet.Services.Session, TlsSetSession, (Tls, Data, DataSize), EFI_UNSUPPORTED);
+}
+
+/**
+  Gets the TLS/SSL session of the specified TLS connection.
+
+  This function returns the session negotiated by the TLS connection in a
+  form that can be passed to TlsSetSession() of a later connection to the
+  same server.
+
+  @param[in]      Tls             Pointer to the TLS object.
+  @param[out]     Data            Pointer to the buffer to receive the session data.
+  @param[in,out]  DataSize        The size of the buffer in bytes. On output, the
+                                  size of the session data.
+
+  @retval  EFI_SUCCESS           The session data was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_BUFFER_TOO_SMALL  The buffer is too small to hold the session data.
+  @retval  EFI_ABORTED           The session can't be encoded.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsGetSession (
+  IN     VOID   *Tls,
+  OUT    VOID   *Data,
+  IN OUT UINTN  *DataSize
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.Session, TlsGetSession, (Tls, Data, DataSize), EFI_UNSUPPORTED);
+}
+
 /**
   Carries out the RSA-SSA signature generation with EMSA-PSS encoding scheme.
 
@@ -7116,4 +7176,8 @@ const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   CryptoServicePkcs1v2Decrypt,
   CryptoServiceRsaOaepEncrypt,
   CryptoServiceRsaOaepDecrypt,
+  /// TLS Set (continued)
+  CryptoServiceTlsSetSession,
+  /// TLS Get (continued)
+  CryptoServiceTlsGetSession,
 };
@@ -595,6 +595,62 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS/SSL session to be resumed during TLS/SSL connect.
+
+  This function sets a session returned by TlsGetSession() for an earlier
+  connection to the same server, so that the handshake can resume it
+  instead of doing a full handshake. If the server declines to resume the
+  session, a full handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Data            Pointer to the session data returned by TlsGetSession().
+  @param[in]  DataSize        Size of the session data in bytes.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_ABORTED           The session data is invalid.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID        *Tls,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  TLS_CONNECTION       *TlsConn;
+  SSL_SESSION          *Session;
+  CONST unsigned char  *Ptr;
+  INTN                 Ret;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Data == NULL) || (DataSize == 0) || (DataSize > MAX_INT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Ptr     = (CONST unsigned char *)Data;
+  Session = d2i_SSL_SESSION (NULL, &Ptr, (long)DataSize);
+  if (Session == NULL) {
+    return EFI_ABORTED;
+  }
+
+  //
+  // SSL_set_session() takes its own reference of the session.
+  //
+  Ret = SSL_set_session (TlsConn->Ssl, Session);
+  SSL_SESSION_free (Session);
+
+  if (Ret != 1) {
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1308,6 +1364,71 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the TLS/SSL session of the specified TLS connection.
+
+  This function returns the session negotiated by the TLS connection in a
+  form that can be passed to TlsSetSession() of a later connection to the
+  same server.
+
+  @param[in]      Tls             Pointer to the TLS object.
+  @param[out]     Data            Pointer to the buffer to receive the session data.
+  @param[in,out]  DataSize        The size of the buffer in bytes. On output, the
+                                  size of the session data.
+
+  @retval  EFI_SUCCESS           The session data was returned successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_NOT_FOUND         The connection has no resumable session.
+  @retval  EFI_BUFFER_TOO_SMALL  The buffer is too small to hold the session data.
+  @retval  EFI_ABORTED           The session can't be encoded.
+  @retval  EFI_UNSUPPORTED       This function is not supported.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsGetSession (
+  IN     VOID   *Tls,
+  OUT    VOID   *Data,
+  IN OUT UINTN  *DataSize
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+  unsigned char   *Ptr;
+  INTN            Length;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (DataSize == NULL) || ((Data == NULL) && (*DataSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Session = SSL_get_session (TlsConn->Ssl);
+  if ((Session == NULL) || (SSL_SESSION_is_resumable (Session) != 1)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Length = i2d_SSL_SESSION (Session, NULL);
+  if (Length <= 0) {
+    return EFI_ABORTED;
+  }
+
+  if (*DataSize < (UINTN)Length) {
+    *DataSize = (UINTN)Length;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  Ptr    = (unsigned char *)Data;
+  Length = i2d_SSL_SESSION (Session, &Ptr);
+  if (Length <= 0) {
+    return EFI_ABORTED;
+  }
+
+  *DataSize = (UINTN)Length;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
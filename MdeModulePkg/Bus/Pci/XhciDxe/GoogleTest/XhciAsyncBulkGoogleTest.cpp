@@ -0,0 +1,532 @@
+/** @file
+  Tests for the asynchronous bulk transfers of XhciSched.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/UefiBootServicesTableLib.h>
+  #include "../Xhci.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_SLOT_ID        1
+#define TEST_BUS_ADDR       2
+#define TEST_BULK_IN        0x81
+#define TEST_RING_NUMBER    8
+#define TEST_CMD_NUMBER     8
+#define TEST_EVENT_NUMBER   32
+#define TEST_BUFFER_LENGTH  0x40
+#define TEST_BUFFER_NUMBER  8
+#define TEST_STREAM_NUMBER  4
+
+extern "C" UINT32  mTestDoorBell;
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+// The result of one transfer as reported to its callback.
+typedef struct {
+  VOID      *Data;
+  UINTN     Length;
+  UINT32    Result;
+} TEST_COMPLETION;
+
+// Fixture holding a device in slot TEST_SLOT_ID with a bulk IN endpoint of
+// TEST_RING_NUMBER TRBs, a command ring and an event ring. The controller
+// is emulated by posting events to the event ring: a command completes
+// during the first stall after it is queued.
+class XhcAsyncBulkTest : public ::testing::Test {
+protected:
+  USB_XHCI_INSTANCE *Xhc;
+  TRANSFER_RING Ring;
+  DEVICE_CONTEXT OutputContext;
+  EFI_PCI_IO_PROTOCOL PciIo;
+  EFI_BOOT_SERVICES BootServices;
+  EFI_BOOT_SERVICES *OriginalBootServices;
+  alignas (TEST_BUFFER_LENGTH) TRB_TEMPLATE Trbs[TEST_RING_NUMBER];
+  TRB_TEMPLATE CmdTrbs[TEST_CMD_NUMBER];
+  TRB_TEMPLATE Events[TEST_EVENT_NUMBER];
+  alignas (TEST_BUFFER_LENGTH) UINT8 Buffers[TEST_BUFFER_NUMBER][TEST_BUFFER_LENGTH];
+  alignas (TEST_BUFFER_LENGTH) TRB_TEMPLATE StreamTrbs[TEST_STREAM_NUMBER][TEST_RING_NUMBER];
+  XHC_ENDPOINT_STREAMS Streams;
+  UINTN EventCount;
+  TRB_TEMPLATE *LastCmdTrb;
+  TRB_TEMPLATE *StoppedTrb;
+
+  static XhcAsyncBulkTest *Current;
+  static std::vector<TEST_COMPLETION> Completions;
+  static std::vector<UINT8> Commands;
+
+  virtual void
+  SetUp (
+    )
+  {
+    LINK_TRB         *Link;
+    USB_DEV_CONTEXT  *Dev;
+    UINT8            Dci;
+
+    Xhc = (USB_XHCI_INSTANCE *)AllocateZeroPool (sizeof (USB_XHCI_INSTANCE));
+    ASSERT_NE (Xhc, nullptr);
+    ZeroMem (&Ring, sizeof (Ring));
+    ZeroMem (&OutputContext, sizeof (OutputContext));
+    ZeroMem (&PciIo, sizeof (PciIo));
+    ZeroMem (&BootServices, sizeof (BootServices));
+    ZeroMem (Trbs, sizeof (Trbs));
+    ZeroMem (CmdTrbs, sizeof (CmdTrbs));
+    ZeroMem (Events, sizeof (Events));
+    ZeroMem (StreamTrbs, sizeof (StreamTrbs));
+    ZeroMem (&Streams, sizeof (Streams));
+    Completions.clear ();
+    Commands.clear ();
+    EventCount    = 0;
+    mTestDoorBell = 0;
+    LastCmdTrb    = NULL;
+    StoppedTrb = NULL;
+    Current    = this;
+
+    InitializeListHead (&Xhc->AsyncIntTransfers);
+    InitializeListHead (&Xhc->AsyncBulkTransfers);
+
+    PciIo.Map   = TestMap;
+    PciIo.Unmap = TestUnmap;
+    PciIo.Flush = TestFlush;
+    Xhc->PciIo  = &PciIo;
+
+    BootServices.RaiseTPL   = TestRaiseTpl;
+    BootServices.RestoreTPL = TestRestoreTpl;
+    BootServices.Stall      = TestStall;
+    OriginalBootServices    = gBS;
+    gBS                     = &BootServices;
+
+    Xhc->EventRing.EventRingSeg0    = Events;
+    Xhc->EventRing.TrbNumber        = TEST_EVENT_NUMBER;
+    Xhc->EventRing.EventRingDequeue = Events;
+    Xhc->EventRing.EventRingEnqueue = Events;
+    Xhc->EventRing.EventRingCCS     = 1;
+
+    Link                     = (LINK_TRB *)&CmdTrbs[TEST_CMD_NUMBER - 1];
+    Link->Type               = TRB_TYPE_LINK;
+    Link->TC                 = 1;
+    Xhc->CmdRing.RingSeg0    = CmdTrbs;
+    Xhc->CmdRing.TrbNumber   = TEST_CMD_NUMBER;
+    Xhc->CmdRing.RingEnqueue = CmdTrbs;
+    Xhc->CmdRing.RingDequeue = CmdTrbs;
+    Xhc->CmdRing.RingPCS     = 1;
+
+    Link             = (LINK_TRB *)&Trbs[TEST_RING_NUMBER - 1];
+    Link->Type       = TRB_TYPE_LINK;
+    Link->TC         = 1;
+    Ring.RingSeg0    = Trbs;
+    Ring.TrbNumber   = TEST_RING_NUMBER;
+    Ring.RingEnqueue = Trbs;
+    Ring.RingDequeue = Trbs;
+    Ring.RingPCS     = 1;
+
+    Dci                              = XhcEndpointToDci (1, EfiUsbDataIn);
+    OutputContext.EP[Dci - 1].EPType = ED_BULK_IN;
+
+    Dev                                = &Xhc->UsbDevContext[TEST_SLOT_ID];
+    Dev->Enabled                       = TRUE;
+    Dev->SlotId                        = TEST_SLOT_ID;
+    Dev->BusDevAddr                    = TEST_BUS_ADDR;
+    Dev->OutputContext                 = &OutputContext;
+    Dev->EndpointTransferRing[Dci - 1] = &Ring;
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    XhciDelAllAsyncBulkTransfers (Xhc);
+    gBS     = OriginalBootServices;
+    Current = NULL;
+    FreePool (Xhc);
+  }
+
+  static EFI_STATUS
+  EFIAPI
+  TestMap (
+    IN     EFI_PCI_IO_PROTOCOL            *This,
+    IN     EFI_PCI_IO_PROTOCOL_OPERATION  Operation,
+    IN     VOID                           *HostAddress,
+    IN OUT UINTN                          *NumberOfBytes,
+    OUT    EFI_PHYSICAL_ADDRESS           *DeviceAddress,
+    OUT    VOID                           **Mapping
+    )
+  {
+    *DeviceAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)HostAddress;
+    *Mapping       = HostAddress;
+    return EFI_SUCCESS;
+  }
+
+  static EFI_STATUS
+  EFIAPI
+  TestUnmap (
+    IN EFI_PCI_IO_PROTOCOL  *This,
+    IN VOID                 *Mapping
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  static EFI_STATUS
+  EFIAPI
+  TestFlush (
+    IN EFI_PCI_IO_PROTOCOL  *This
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  static EFI_TPL
+  EFIAPI
+  TestRaiseTpl (
+    IN EFI_TPL  NewTpl
+    )
+  {
+    return TPL_APPLICATION;
+  }
+
+  static VOID
+  EFIAPI
+  TestRestoreTpl (
+    IN EFI_TPL  OldTpl
+    )
+  {
+  }
+
+  // Complete the command queued on the command ring, after reporting the
+  // transfer stopped by a Stop Endpoint command.
+  static EFI_STATUS
+  EFIAPI
+  TestStall (
+    IN UINTN  Microseconds
+    )
+  {
+    TRB_TEMPLATE  *CmdTrb;
+
+    CmdTrb = Current->Xhc->CmdRing.RingEnqueue;
+    if ((CmdTrb == Current->LastCmdTrb) || (CmdTrb->CycleBit != (Current->Xhc->CmdRing.RingPCS & BIT0))) {
+      return EFI_SUCCESS;
+    }
+
+    Current->LastCmdTrb = CmdTrb;
+    Commands.push_back ((UINT8)CmdTrb->Type);
+    if ((CmdTrb->Type == TRB_TYPE_STOP_ENDPOINT) && (Current->StoppedTrb != NULL)) {
+      Current->PostEvent (Current->StoppedTrb, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_STOPPED, 0);
+    }
+
+    Current->PostEvent (CmdTrb, TRB_TYPE_COMMAND_COMPLT_EVENT, TRB_COMPLETION_SUCCESS, 0);
+    return EFI_SUCCESS;
+  }
+
+  static EFI_STATUS
+  EFIAPI
+  TestCallback (
+    IN VOID    *Data,
+    IN UINTN   DataLength,
+    IN VOID    *Context,
+    IN UINT32  Result
+    )
+  {
+    TEST_COMPLETION  Completion;
+
+    Completion.Data   = Data;
+    Completion.Length = DataLength;
+    Completion.Result = Result;
+    Completions.push_back (Completion);
+    return EFI_SUCCESS;
+  }
+
+  // Post the event the controller raises for a TRB, with the number of
+  // bytes of the TRB that were not transferred.
+  VOID
+  PostEvent (
+    TRB_TEMPLATE  *Trb,
+    UINT8         Type,
+    UINT8         CompletionCode,
+    UINT32        Residual
+    )
+  {
+    EVT_TRB_TRANSFER  *Event;
+
+    ASSERT_LT (EventCount, (UINTN)TEST_EVENT_NUMBER - 1);
+    Event               = (EVT_TRB_TRANSFER *)&Events[EventCount++];
+    Event->TRBPtrLo     = XHC_LOW_32BIT (Trb);
+    Event->TRBPtrHi     = XHC_HIGH_32BIT (Trb);
+    Event->Length       = Residual;
+    Event->Completecode = CompletionCode;
+    Event->Type         = Type;
+    Event->CycleBit     = 1;
+  }
+
+  // Give the bulk IN endpoint TEST_STREAM_NUMBER - 1 streams, as
+  // XhcAllocateStreams() does without the Configure Endpoint command.
+  VOID
+  SetUpStreams (
+    )
+  {
+    LINK_TRB  *Link;
+    UINTN     Index;
+
+    for (Index = 1; Index < TEST_STREAM_NUMBER; Index++) {
+      Link                             = (LINK_TRB *)&StreamTrbs[Index][TEST_RING_NUMBER - 1];
+      Link->Type                       = TRB_TYPE_LINK;
+      Link->TC                         = 1;
+      Streams.Rings[Index].RingSeg0    = StreamTrbs[Index];
+      Streams.Rings[Index].TrbNumber   = TEST_RING_NUMBER;
+      Streams.Rings[Index].RingEnqueue = StreamTrbs[Index];
+      Streams.Rings[Index].RingDequeue = StreamTrbs[Index];
+      Streams.Rings[Index].RingPCS     = 1;
+    }
+
+    Streams.NumStreams = TEST_STREAM_NUMBER;
+    Xhc->UsbDevContext[TEST_SLOT_ID].EndpointStreams[XhcEndpointToDci (1, EfiUsbDataIn) - 1] = &Streams;
+  }
+
+  EFI_STATUS
+  Submit (
+    UINTN  Index,
+    URB    **Urb
+    )
+  {
+    return SubmitOnStream (Index, 0, Urb);
+  }
+
+  EFI_STATUS
+  SubmitOnStream (
+    UINTN   Index,
+    UINT16  StreamId,
+    URB     **Urb
+    )
+  {
+    return XhciInsertAsyncBulkTransfer (
+             Xhc,
+             TEST_BUS_ADDR,
+             TEST_BULK_IN,
+             StreamId,
+             EFI_USB_SPEED_HIGH,
+             512,
+             Buffers[Index],
+             TEST_BUFFER_LENGTH,
+             TestCallback,
+             NULL,
+             Urb
+             );
+  }
+};
+
+XhcAsyncBulkTest              *XhcAsyncBulkTest::Current;
+std::vector<TEST_COMPLETION>  XhcAsyncBulkTest::Completions;
+std::vector<UINT8>            XhcAsyncBulkTest::Commands;
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+// Transfers queued on one endpoint are handed to the controller at once
+// and reported in order as their events arrive.
+TEST_F (XhcAsyncBulkTest, QueuedTransfersCompleteInOrder) {
+  URB    *Urbs[3];
+  UINTN  Index;
+
+  for (Index = 0; Index < 3; Index++) {
+    ASSERT_EQ (Submit (Index, &Urbs[Index]), EFI_SUCCESS);
+    EXPECT_EQ (Urbs[Index]->TrbStart->CycleBit, 1u);
+  }
+
+  EXPECT_EQ (Ring.RingEnqueue, &Trbs[3]);
+  EXPECT_EQ (Ring.RingEnqueue->CycleBit, 0u);
+
+  PostEvent (Urbs[0]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_SUCCESS, 0);
+  PostEvent (Urbs[1]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_SHORT_PACKET, 0x10);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  ASSERT_EQ (Completions.size (), 2u);
+  EXPECT_EQ (Completions[0].Data, Buffers[0]);
+  EXPECT_EQ (Completions[0].Length, (UINTN)TEST_BUFFER_LENGTH);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_NOERROR);
+  EXPECT_EQ (Completions[1].Data, Buffers[1]);
+  EXPECT_EQ (Completions[1].Length, (UINTN)TEST_BUFFER_LENGTH - 0x10);
+  EXPECT_EQ (Completions[1].Result, (UINT32)EFI_USB_NOERROR);
+
+  PostEvent (Urbs[2]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_SUCCESS, 0);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  ASSERT_EQ (Completions.size (), 3u);
+  EXPECT_EQ (Completions[2].Data, Buffers[2]);
+  EXPECT_TRUE (IsListEmpty (&Xhc->AsyncBulkTransfers));
+  EXPECT_TRUE (Commands.empty ());
+}
+
+// A stall halts the endpoint: the transfers queued behind the stalled one
+// are not executed, and the endpoint is reset with an empty ring.
+TEST_F (XhcAsyncBulkTest, StallFlushesQueuedTransfers) {
+  URB    *Urbs[3];
+  UINTN  Index;
+
+  for (Index = 0; Index < 3; Index++) {
+    ASSERT_EQ (Submit (Index, &Urbs[Index]), EFI_SUCCESS);
+  }
+
+  PostEvent (Urbs[0]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_STALL_ERROR, TEST_BUFFER_LENGTH);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  ASSERT_EQ (Completions.size (), 3u);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_ERR_STALL);
+  EXPECT_EQ (Completions[1].Result, (UINT32)EFI_USB_ERR_NOTEXECUTE);
+  EXPECT_EQ (Completions[2].Result, (UINT32)EFI_USB_ERR_NOTEXECUTE);
+  EXPECT_TRUE (IsListEmpty (&Xhc->AsyncBulkTransfers));
+
+  ASSERT_EQ (Commands.size (), 2u);
+  EXPECT_EQ (Commands[0], TRB_TYPE_RESET_ENDPOINT);
+  EXPECT_EQ (Commands[1], TRB_TYPE_SET_TR_DEQUE);
+}
+
+// Cancelling stops the endpoint: the transfer in progress is reported as
+// timed out, the ones behind it as not executed.
+TEST_F (XhcAsyncBulkTest, CancelStopsEndpoint) {
+  URB  *Urbs[2];
+
+  ASSERT_EQ (Submit (0, &Urbs[0]), EFI_SUCCESS);
+  ASSERT_EQ (Submit (1, &Urbs[1]), EFI_SUCCESS);
+
+  StoppedTrb = Urbs[0]->TrbStart;
+  EXPECT_EQ (XhciDelAsyncBulkTransfer (Xhc, TEST_BUS_ADDR, TEST_BULK_IN, 0, TPL_APPLICATION), EFI_SUCCESS);
+
+  ASSERT_EQ (Completions.size (), 2u);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_ERR_TIMEOUT);
+  EXPECT_EQ (Completions[1].Result, (UINT32)EFI_USB_ERR_NOTEXECUTE);
+  EXPECT_TRUE (IsListEmpty (&Xhc->AsyncBulkTransfers));
+
+  ASSERT_EQ (Commands.size (), 2u);
+  EXPECT_EQ (Commands[0], TRB_TYPE_STOP_ENDPOINT);
+  EXPECT_EQ (Commands[1], TRB_TYPE_SET_TR_DEQUE);
+}
+
+// The ring keeps room for the link TRB and the enqueue pointer, a transfer
+// which may not fit is refused until the ones before it complete.
+TEST_F (XhcAsyncBulkTest, FullRingIsNotReady) {
+  URB    *Urb;
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_RING_NUMBER - 3; Index++) {
+    ASSERT_EQ (Submit (Index, &Urb), EFI_SUCCESS);
+  }
+
+  EXPECT_EQ (Submit (Index, &Urb), EFI_NOT_READY);
+
+  Urb = EFI_LIST_CONTAINER (GetFirstNode (&Xhc->AsyncBulkTransfers), URB, UrbList);
+  PostEvent (Urb->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_SUCCESS, 0);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  EXPECT_EQ (Submit (Index, &Urb), EFI_SUCCESS);
+}
+
+// Once the endpoint has streams, each transfer goes on the ring of its
+// stream and rings the doorbell with its stream ID. Stream 0 and streams
+// out of the Primary Stream Array are refused.
+TEST_F (XhcAsyncBulkTest, StreamTransfersUseStreamRings) {
+  URB  *Urbs[2];
+
+  SetUpStreams ();
+
+  EXPECT_EQ (SubmitOnStream (0, 0, &Urbs[0]), EFI_INVALID_PARAMETER);
+  EXPECT_EQ (SubmitOnStream (0, TEST_STREAM_NUMBER, &Urbs[0]), EFI_INVALID_PARAMETER);
+
+  ASSERT_EQ (SubmitOnStream (0, 1, &Urbs[0]), EFI_SUCCESS);
+  ASSERT_EQ (SubmitOnStream (1, 2, &Urbs[1]), EFI_SUCCESS);
+  EXPECT_EQ (Urbs[0]->Ring, &Streams.Rings[1]);
+  EXPECT_EQ (Urbs[1]->Ring, &Streams.Rings[2]);
+  EXPECT_EQ (Urbs[1]->TrbStart, &StreamTrbs[2][0]);
+  EXPECT_EQ (Ring.RingEnqueue, &Trbs[0]);
+
+  RingIntTransferDoorBell (Xhc, Urbs[1]);
+  EXPECT_EQ (mTestDoorBell, XhcEndpointToDci (1, EfiUsbDataIn) | (2u << 16));
+
+  PostEvent (Urbs[1]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_SUCCESS, 0);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  ASSERT_EQ (Completions.size (), 1u);
+  EXPECT_EQ (Completions[0].Data, Buffers[1]);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_NOERROR);
+}
+
+// Cancelling one stream drops its TDs with a Set TR Dequeue Pointer for
+// that stream, and restarts the other streams of the endpoint.
+TEST_F (XhcAsyncBulkTest, CancelOneStreamKeepsOthers) {
+  URB                     *Urbs[3];
+  CMD_SET_TR_DEQ_POINTER  *SetTrDeq;
+
+  SetUpStreams ();
+
+  ASSERT_EQ (SubmitOnStream (0, 1, &Urbs[0]), EFI_SUCCESS);
+  ASSERT_EQ (SubmitOnStream (1, 1, &Urbs[1]), EFI_SUCCESS);
+  ASSERT_EQ (SubmitOnStream (2, 2, &Urbs[2]), EFI_SUCCESS);
+
+  StoppedTrb = Urbs[0]->TrbStart;
+  EXPECT_EQ (XhciDelAsyncBulkTransfer (Xhc, TEST_BUS_ADDR, TEST_BULK_IN, 1, TPL_APPLICATION), EFI_SUCCESS);
+
+  ASSERT_EQ (Completions.size (), 2u);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_ERR_TIMEOUT);
+  EXPECT_EQ (Completions[1].Result, (UINT32)EFI_USB_ERR_NOTEXECUTE);
+  ASSERT_FALSE (IsListEmpty (&Xhc->AsyncBulkTransfers));
+  EXPECT_EQ (EFI_LIST_CONTAINER (GetFirstNode (&Xhc->AsyncBulkTransfers), URB, UrbList), Urbs[2]);
+  EXPECT_FALSE (Urbs[2]->Finished);
+
+  ASSERT_EQ (Commands.size (), 2u);
+  EXPECT_EQ (Commands[0], TRB_TYPE_STOP_ENDPOINT);
+  EXPECT_EQ (Commands[1], TRB_TYPE_SET_TR_DEQUE);
+  SetTrDeq = (CMD_SET_TR_DEQ_POINTER *)&CmdTrbs[1];
+  EXPECT_EQ (SetTrDeq->StreamID, 1u);
+  EXPECT_EQ (SetTrDeq->PtrLo & 0xE, (UINT32)STREAM_CONTEXT_SCT_PRIMARY_RING << 1);
+  EXPECT_EQ (mTestDoorBell, XhcEndpointToDci (1, EfiUsbDataIn) | (2u << 16));
+}
+
+// A stall on one stream flushes the transfers of that stream only, the
+// other streams are restarted once the endpoint is reset.
+TEST_F (XhcAsyncBulkTest, StallOnStreamRestartsOtherStreams) {
+  URB  *Urbs[3];
+
+  SetUpStreams ();
+
+  ASSERT_EQ (SubmitOnStream (0, 1, &Urbs[0]), EFI_SUCCESS);
+  ASSERT_EQ (SubmitOnStream (1, 1, &Urbs[1]), EFI_SUCCESS);
+  ASSERT_EQ (SubmitOnStream (2, 3, &Urbs[2]), EFI_SUCCESS);
+
+  PostEvent (Urbs[0]->TrbEnd, TRB_TYPE_TRANS_EVENT, TRB_COMPLETION_STALL_ERROR, TEST_BUFFER_LENGTH);
+  XhcProcessAsyncBulkTransfers (Xhc, TPL_APPLICATION);
+
+  ASSERT_EQ (Completions.size (), 2u);
+  EXPECT_EQ (Completions[0].Result, (UINT32)EFI_USB_ERR_STALL);
+  EXPECT_EQ (Completions[1].Result, (UINT32)EFI_USB_ERR_NOTEXECUTE);
+  EXPECT_FALSE (Urbs[2]->Finished);
+
+  ASSERT_EQ (Commands.size (), 2u);
+  EXPECT_EQ (Commands[0], TRB_TYPE_RESET_ENDPOINT);
+  EXPECT_EQ (Commands[1], TRB_TYPE_SET_TR_DEQUE);
+  EXPECT_EQ (((CMD_SET_TR_DEQ_POINTER *)&CmdTrbs[1])->StreamID, 1u);
+  EXPECT_EQ (mTestDoorBell, XhcEndpointToDci (1, EfiUsbDataIn) | (3u << 16));
+}
+
+// Streams need a controller with a Primary Stream Array.
+TEST_F (XhcAsyncBulkTest, AllocateStreamsNeedsControllerSupport) {
+  UINT16  NumStreams;
+
+  NumStreams = 8;
+  EXPECT_EQ (XhcAllocateStreams (Xhc, TEST_SLOT_ID, XhcEndpointToDci (1, EfiUsbDataIn), &NumStreams), EFI_UNSUPPORTED);
+  EXPECT_EQ (NumStreams, 8u);
+  EXPECT_EQ (XhcFreeStreams (Xhc, TEST_SLOT_ID, XhcEndpointToDci (1, EfiUsbDataIn), TRUE), EFI_NOT_FOUND);
+}
@@ -0,0 +1,335 @@
+/** @file
+  Tests for the transfer event handling of XhciSched.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../Xhci.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_TRB_LENGTH     0x1000
+#define TEST_TRB_COUNT      3
+#define TEST_EVENT_NUMBER   8
+#define TEST_SHORT_LENGTH   0x200
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These symbols are not directly under test - but required to compile.
+// The controller is not there, so the registers read as 0 and the host
+// and device addresses are the same.
+////////////////////////////////////////////////////////////////////////
+extern "C" {
+  EFI_STATUS
+  UsbHcAllocateAlignedPages (
+    IN EFI_PCI_IO_PROTOCOL    *PciIo,
+    IN UINTN                  Pages,
+    IN UINTN                  Alignment,
+    OUT VOID                  **HostAddress,
+    OUT EFI_PHYSICAL_ADDRESS  *DeviceAddress,
+    OUT VOID                  **Mapping
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  VOID *
+  UsbHcAllocateMem (
+    IN  USBHC_MEM_POOL  *Pool,
+    IN  UINTN           Size,
+    IN  BOOLEAN         AllocationForRing
+    )
+  {
+    return NULL;
+  }
+
+  VOID
+  UsbHcFreeAlignedPages (
+    IN EFI_PCI_IO_PROTOCOL  *PciIo,
+    IN VOID                 *HostAddress,
+    IN UINTN                Pages,
+    VOID                    *Mapping
+    )
+  {
+  }
+
+  VOID
+  UsbHcFreeMem (
+    IN USBHC_MEM_POOL  *Pool,
+    IN VOID            *Mem,
+    IN UINTN           Size
+    )
+  {
+  }
+
+  EFI_STATUS
+  UsbHcFreeMemPool (
+    IN USBHC_MEM_POOL  *Pool
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_PHYSICAL_ADDRESS
+  UsbHcGetHostAddrForPciAddr (
+    IN USBHC_MEM_POOL  *Pool,
+    IN VOID            *Mem,
+    IN UINTN           Size,
+    IN BOOLEAN         Alignment
+    )
+  {
+    return (EFI_PHYSICAL_ADDRESS)(UINTN)Mem;
+  }
+
+  EFI_PHYSICAL_ADDRESS
+  UsbHcGetPciAddrForHostAddr (
+    IN USBHC_MEM_POOL  *Pool,
+    IN VOID            *Mem,
+    IN UINTN           Size,
+    IN BOOLEAN         Alignment
+    )
+  {
+    return (EFI_PHYSICAL_ADDRESS)(UINTN)Mem;
+  }
+
+  USBHC_MEM_POOL *
+  UsbHcInitMemPool (
+    IN EFI_PCI_IO_PROTOCOL  *PciIo
+    )
+  {
+    return NULL;
+  }
+
+  VOID
+  XhcSetOpRegBit (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Bit
+    )
+  {
+  }
+
+  VOID
+  XhcClearOpRegBit (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Bit
+    )
+  {
+  }
+
+  VOID
+  XhcWriteOpReg (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Data
+    )
+  {
+  }
+
+  VOID
+  XhcSetRuntimeRegBit (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Bit
+    )
+  {
+  }
+
+  VOID
+  XhcClearRuntimeRegBit (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Bit
+    )
+  {
+  }
+
+  UINT32
+  XhcReadRuntimeReg (
+    IN  USB_XHCI_INSTANCE  *Xhc,
+    IN  UINT32             Offset
+    )
+  {
+    return 0;
+  }
+
+  VOID
+  XhcWriteRuntimeReg (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Data
+    )
+  {
+  }
+
+  // The last value written to a doorbell register.
+  UINT32  mTestDoorBell;
+
+  VOID
+  XhcWriteDoorBellReg (
+    IN USB_XHCI_INSTANCE  *Xhc,
+    IN UINT32             Offset,
+    IN UINT32             Data
+    )
+  {
+    mTestDoorBell = Data;
+  }
+
+  BOOLEAN
+  XhcIsHalt (
+    IN USB_XHCI_INSTANCE  *Xhc
+    )
+  {
+    return FALSE;
+  }
+
+  BOOLEAN
+  XhcIsSysError (
+    IN USB_XHCI_INSTANCE  *Xhc
+    )
+  {
+    return FALSE;
+  }
+
+  UINT64
+  XhcConvertTimeToTicks (
+    UINT64  Time
+    )
+  {
+    return Time;
+  }
+
+  UINT64
+  XhcGetElapsedTicks (
+    IN OUT UINT64  *PreviousTick
+    )
+  {
+    return 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+// Fixture holding a bulk IN URB of TEST_TRB_COUNT chained Normal TRBs,
+// built the way XhcCreateTransferTrb() builds them, and an event ring
+// the tests post transfer events to.
+class XhcCheckUrbResultTest : public ::testing::Test {
+protected:
+  USB_XHCI_INSTANCE Xhc;
+  URB Urb;
+  TRB_TEMPLATE Trbs[TEST_TRB_COUNT];
+  TRB_TEMPLATE Events[TEST_EVENT_NUMBER];
+  UINT8 Buffer[TEST_TRB_LENGTH * TEST_TRB_COUNT];
+  UINTN EventCount;
+
+  virtual void
+  SetUp (
+    )
+  {
+    TRANSFER_TRB_NORMAL  *Trb;
+    UINTN                Index;
+
+    ZeroMem (&Xhc, sizeof (Xhc));
+    ZeroMem (&Urb, sizeof (Urb));
+    ZeroMem (Trbs, sizeof (Trbs));
+    ZeroMem (Events, sizeof (Events));
+    InitializeListHead (&Xhc.AsyncIntTransfers);
+    InitializeListHead (&Xhc.AsyncBulkTransfers);
+
+    Xhc.EventRing.EventRingSeg0    = Events;
+    Xhc.EventRing.TrbNumber        = TEST_EVENT_NUMBER;
+    Xhc.EventRing.EventRingDequeue = Events;
+    Xhc.EventRing.EventRingEnqueue = Events;
+    Xhc.EventRing.EventRingCCS     = 1;
+    EventCount                     = 0;
+
+    for (Index = 0; Index < TEST_TRB_COUNT; Index++) {
+      Trb           = (TRANSFER_TRB_NORMAL *)&Trbs[Index];
+      Trb->TRBPtrLo = XHC_LOW_32BIT (Buffer + Index * TEST_TRB_LENGTH);
+      Trb->TRBPtrHi = XHC_HIGH_32BIT (Buffer + Index * TEST_TRB_LENGTH);
+      Trb->Length   = TEST_TRB_LENGTH;
+      Trb->ISP      = 1;
+      Trb->CH       = (Index < TEST_TRB_COUNT - 1) ? 1 : 0;
+      Trb->IOC      = (Index < TEST_TRB_COUNT - 1) ? 0 : 1;
+      Trb->Type     = TRB_TYPE_NORMAL;
+      Trb->CycleBit = 1;
+    }
+
+    Urb.Ep.Type  = XHC_BULK_TRANSFER;
+    Urb.Data     = Buffer;
+    Urb.DataPhy  = Buffer;
+    Urb.DataLen  = sizeof (Buffer);
+    Urb.TrbStart = &Trbs[0];
+    Urb.TrbEnd   = &Trbs[TEST_TRB_COUNT - 1];
+    Urb.TrbNum   = TEST_TRB_COUNT;
+    Urb.Result   = EFI_USB_NOERROR;
+  }
+
+  // Post the transfer event the controller raises for a TRB, with the
+  // number of bytes of the TRB that were not transferred.
+  VOID
+  PostEvent (
+    UINTN   TrbIndex,
+    UINT8   CompletionCode,
+    UINT32  Residual
+    )
+  {
+    EVT_TRB_TRANSFER  *Event;
+
+    ASSERT_LT (EventCount, (UINTN)TEST_EVENT_NUMBER - 1);
+    Event               = (EVT_TRB_TRANSFER *)&Events[EventCount++];
+    Event->TRBPtrLo     = XHC_LOW_32BIT (&Trbs[TrbIndex]);
+    Event->TRBPtrHi     = XHC_HIGH_32BIT (&Trbs[TrbIndex]);
+    Event->Length       = Residual;
+    Event->Completecode = CompletionCode;
+    Event->Type         = TRB_TYPE_TRANS_EVENT;
+    Event->CycleBit     = 1;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+// The whole TD is transferred, only the IOC TRB raises an event.
+TEST_F (XhcCheckUrbResultTest, FullTransferCompletesOnIocTrb) {
+  PostEvent (TEST_TRB_COUNT - 1, TRB_COMPLETION_SUCCESS, 0);
+
+  EXPECT_TRUE (XhcCheckUrbResult (&Xhc, &Urb));
+  EXPECT_EQ (Urb.Result, (UINT32)EFI_USB_NOERROR);
+  EXPECT_EQ (Urb.Completed, sizeof (Buffer));
+}
+
+// A short packet in the first TRB ends the TD there.
+TEST_F (XhcCheckUrbResultTest, ShortPacketInFirstTrbFinishesUrb) {
+  PostEvent (0, TRB_COMPLETION_SHORT_PACKET, TEST_TRB_LENGTH - TEST_SHORT_LENGTH);
+
+  EXPECT_TRUE (XhcCheckUrbResult (&Xhc, &Urb));
+  EXPECT_EQ (Urb.Result, (UINT32)EFI_USB_NOERROR);
+  EXPECT_EQ (Urb.Completed, (UINTN)TEST_SHORT_LENGTH);
+}
+
+// A short packet in TRB 1 of 3, then the event of the IOC TRB 3 of the
+// same TD. The length of the short packet must be kept.
+TEST_F (XhcCheckUrbResultTest, ShortPacketLengthKeptAfterIocEvent) {
+  PostEvent (0, TRB_COMPLETION_SHORT_PACKET, TEST_TRB_LENGTH - TEST_SHORT_LENGTH);
+  PostEvent (TEST_TRB_COUNT - 1, TRB_COMPLETION_SHORT_PACKET, TEST_TRB_LENGTH);
+
+  EXPECT_TRUE (XhcCheckUrbResult (&Xhc, &Urb));
+  EXPECT_EQ (Urb.Result, (UINT32)EFI_USB_NOERROR);
+  EXPECT_EQ (Urb.Completed, (UINTN)TEST_SHORT_LENGTH);
+}
+
@@ -86,6 +86,17 @@ EFI_USB2_HC_PROTOCOL  gXhciUsb2HcTemplate = {
   0x0
 };
 
+//
+// Template for Xhci's EDKII USB2 Host Controller Async Bulk Protocol Instance.
+//
+EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  gXhciUsb2HcAsyncBulkTemplate = {
+  XhcAsyncBulkSubmit,
+  XhcAsyncBulkCancel,
+  XhcAsyncBulkPoll,
+  XhcAsyncBulkAllocateStreams,
+  XhcAsyncBulkFreeStreams
+};
+
 static UINT64   mXhciPerformanceCounterStartValue;
 static UINT64   mXhciPerformanceCounterEndValue;
 static UINT64   mXhciPerformanceCounterFrequency;
@@ -205,10 +216,11 @@ XhcReset (
       }
 
       //
-      // Clean up the asynchronous transfers, currently only
-      // interrupt supports asynchronous operation.
+      // Clean up the asynchronous transfers. The asynchronous bulk
+      // transfers are reported as failed on the next poll.
       //
       XhciDelAllAsyncIntTransfers (Xhc);
+      XhcAbortAsyncBulkTransfers (Xhc, 0, 0, EFI_USB_ERR_SYSTEM);
       XhcFreeSched (Xhc);
 
       XhcInitSched (Xhc);
@@ -787,6 +799,7 @@ XhcTransfer (
           Xhc,
           DeviceAddress,
           EndPointAddress,
+          0,
           DeviceSpeed,
           MaximumPacketLength,
           Type,
@@ -1221,6 +1234,8 @@ ON_EXIT:
   @param  This                  This EFI_USB2_HC_PROTOCOL instance.
   @param  DeviceAddress         Target device address.
   @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  StreamId              The stream of the endpoint, 0 if the endpoint doesn't
+                                use streams.
   @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
                                 transfer.
   @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
@@ -1343,6 +1358,313 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Queues a bulk transfer on a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
+                                transfer.
+  @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
+                                sending or receiving.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The lenght of the data buffer.
+  @param  Translator            A pointr to the transaction translator data.
+  @param  CallBackFunction      Function to call when the transfer is done.
+  @param  Context               Context to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued.
+  @retval EFI_NOT_READY         The transfer ring of the endpoint is full.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkSubmit (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL   *This,
+  IN UINT8                               DeviceAddress,
+  IN UINT8                               EndPointAddress,
+  IN UINT16                              StreamId,
+  IN UINT8                               DeviceSpeed,
+  IN UINTN                               MaximumPacketLength,
+  IN VOID                                *Data,
+  IN UINTN                               DataLength,
+  IN EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK     CallBackFunction,
+  IN VOID                                *Context OPTIONAL
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  URB                *Urb;
+  UINT8              SlotId;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  //
+  // Validate the parameters
+  //
+  if ((This == NULL) || (Data == NULL) || (DataLength == 0) || (CallBackFunction == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((DeviceSpeed == EFI_USB_SPEED_LOW) ||
+      ((DeviceSpeed == EFI_USB_SPEED_FULL) && (MaximumPacketLength > 64)) ||
+      ((EFI_USB_SPEED_HIGH == DeviceSpeed) && (MaximumPacketLength > 512)) ||
+      ((EFI_USB_SPEED_SUPER == DeviceSpeed) && (MaximumPacketLength > 1024)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK (This);
+
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncBulkSubmit: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  //
+  // Check if the device is still enabled before every transaction.
+  //
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    goto ON_EXIT;
+  }
+
+  Status = XhciInsertAsyncBulkTransfer (
+             Xhc,
+             DeviceAddress,
+             EndPointAddress,
+             StreamId,
+             DeviceSpeed,
+             MaximumPacketLength,
+             Data,
+             DataLength,
+             CallBackFunction,
+             Context,
+             &Urb
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  //
+  // Ring the doorbell
+  //
+  Status = RingIntTransferDoorBell (Xhc, Urb);
+
+ON_EXIT:
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Cancels the bulk transfers queued on a bulk endpoint of a USB device, or on
+  one stream of the endpoint.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  StreamId              The stream to cancel, 0 for the whole endpoint.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be stopped.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkCancel (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress,
+  IN UINT16                             StreamId
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK (This);
+
+  //
+  // The cancel request may happen after device is detached, the transfers
+  // are still reported to their callbacks then.
+  //
+  Status = XhciDelAsyncBulkTransfer (Xhc, DeviceAddress, EndPointAddress, StreamId, OldTpl);
+
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Processes the completed bulk transfers and calls their callbacks.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The completed transfers were processed.
+  @retval EFI_INVALID_PARAMETER This is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkPoll (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_TPL            OldTpl;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK (This);
+  XhcProcessAsyncBulkTransfers (Xhc, OldTpl);
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Gives streams to a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  NumberOfStreams       On input, the number of streams wanted. On output,
+                                the number of streams given.
+
+  @retval EFI_SUCCESS           The endpoint has streams.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   The endpoint already has streams.
+  @retval EFI_NOT_READY         Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES  The streams could not be allocated.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be configured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkAllocateStreams (
+  IN     EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                              DeviceAddress,
+  IN     UINT8                              EndPointAddress,
+  IN OUT UINT16                             *NumberOfStreams
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  UINT8              SlotId;
+  UINT8              Dci;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  if ((This == NULL) || (NumberOfStreams == NULL) || (*NumberOfStreams == 0) || ((EndPointAddress & 0x0F) == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK (This);
+
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncBulkAllocateStreams: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    goto ON_EXIT;
+  }
+
+  Dci    = XhcEndpointToDci ((UINT8)(EndPointAddress & 0x0F), (UINT8)(((EndPointAddress & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut));
+  Status = XhcAllocateStreams (Xhc, SlotId, Dci, NumberOfStreams);
+  if (Status == EFI_TIMEOUT) {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+ON_EXIT:
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Frees the streams of a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+
+  @retval EFI_SUCCESS           The streams were freed.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_NOT_READY         Transfers are queued on the streams.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be configured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkFreeStreams (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  UINT8              SlotId;
+  UINT8              Dci;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  if ((This == NULL) || ((EndPointAddress & 0x0F) == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK (This);
+
+  //
+  // The streams are already freed if the device is detached.
+  //
+  Status = EFI_NOT_FOUND;
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId != 0) {
+    Dci    = XhcEndpointToDci ((UINT8)(EndPointAddress & 0x0F), (UINT8)(((EndPointAddress & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut));
+    Status = XhcFreeStreams (Xhc, SlotId, Dci, TRUE);
+    if (Status == EFI_TIMEOUT) {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
 /**
   Submits an asynchronous interrupt transfer to an
   interrupt endpoint of a USB device.
@@ -1820,6 +2142,7 @@ XhcCreateUsbHc (
   Xhc->DevicePath            = DevicePath;
   Xhc->OriginalPciAttributes = OriginalPciAttributes;
   CopyMem (&Xhc->Usb2Hc, &gXhciUsb2HcTemplate, sizeof (EFI_USB2_HC_PROTOCOL));
+  CopyMem (&Xhc->Usb2HcAsyncBulk, &gXhciUsb2HcAsyncBulkTemplate, sizeof (EDKII_USB2_HC_ASYNC_BULK_PROTOCOL));
 
   Status = PciIo->Pci.Read (
                         PciIo,
@@ -1835,11 +2158,13 @@ XhcCreateUsbHc (
   }
 
   InitializeListHead (&Xhc->AsyncIntTransfers);
+  InitializeListHead (&Xhc->AsyncBulkTransfers);
 
   //
   // Be caution that the Offset passed to XhcReadCapReg() should be Dword align
   //
   Xhc->CapLength        = XhcReadCapReg8 (Xhc, XHC_CAPLENGTH_OFFSET);
+  Xhc->HciVersion       = (UINT16)(XhcReadCapReg (Xhc, XHC_CAPLENGTH_OFFSET) >> 16);
   Xhc->HcSParams1.Dword = XhcReadCapReg (Xhc, XHC_HCSPARAMS1_OFFSET);
   Xhc->HcSParams2.Dword = XhcReadCapReg (Xhc, XHC_HCSPARAMS2_OFFSET);
   Xhc->HcCParams.Dword  = XhcReadCapReg (Xhc, XHC_HCCPARAMS_OFFSET);
@@ -2145,11 +2470,13 @@ XhcDriverBindingStart (
     FALSE
     );
 
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &Xhc->Usb2Hc
+                  &Xhc->Usb2Hc,
+                  &gEdkiiUsb2HcAsyncBulkProtocolGuid,
+                  &Xhc->Usb2HcAsyncBulk,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcDriverBindingStart: failed to install USB2_HC Protocol\n"));
@@ -2233,19 +2560,22 @@ XhcDriverBindingStop (
     return Status;
   }
 
-  Status = gBS->UninstallProtocolInterface (
+  Xhc   = XHC_FROM_THIS (Usb2Hc);
+  PciIo = Xhc->PciIo;
+
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  Usb2Hc
+                  Usb2Hc,
+                  &gEdkiiUsb2HcAsyncBulkProtocolGuid,
+                  &Xhc->Usb2HcAsyncBulk,
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  Xhc   = XHC_FROM_THIS (Usb2Hc);
-  PciIo = Xhc->PciIo;
-
   //
   // Stop AsyncRequest Polling timer then stop the XHCI driver
   // and uninstall the XHCI protocl.
@@ -2281,6 +2611,7 @@ XhcDriverBindingStop (
   XhcHaltHC (Xhc, XHC_GENERIC_TIMEOUT);
   XhcClearBiosOwnership (Xhc);
   XhciDelAllAsyncIntTransfers (Xhc);
+  XhciDelAllAsyncBulkTransfers (Xhc);
   XhcFreeSched (Xhc);
 
   if (Xhc->ControllerNameTable) {
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/Usb2HcAsyncBulk.h>
 #include <Protocol/PciIo.h>
 
 #include <Guid/EventGroup.h>
@@ -80,10 +81,11 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 //
 #define XHC_TPL  TPL_NOTIFY
 
-#define CMD_RING_TRB_NUMBER    0x100
-#define TR_RING_TRB_NUMBER     0x100
-#define ERST_NUMBER            0x01
-#define EVENT_RING_TRB_NUMBER  0x200
+#define CMD_RING_TRB_NUMBER     0x100
+#define TR_RING_TRB_NUMBER      0x100
+#define STREAM_RING_TRB_NUMBER  0x40
+#define ERST_NUMBER             0x01
+#define EVENT_RING_TRB_NUMBER   0x200
 
 #define CMD_INTER        0
 #define CTRL_INTER       1
@@ -104,6 +106,8 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 
 #define XHCI_INSTANCE_SIG  SIGNATURE_32 ('x', 'h', 'c', 'i')
 #define XHC_FROM_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2Hc, XHCI_INSTANCE_SIG)
+#define XHC_FROM_ASYNC_BULK(a) \
+          CR(a, USB_XHCI_INSTANCE, Usb2HcAsyncBulk, XHCI_INSTANCE_SIG)
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
@@ -180,6 +184,10 @@ struct _USB_DEV_CONTEXT {
   //
   VOID                         *EndpointTransferRing[31];
   //
+  // The stream rings of every endpoint, NULL if the endpoint doesn't use streams.
+  //
+  VOID                         *EndpointStreams[31];
+  //
   // The device descriptor which is stored to support XHCI's Evaluate_Context cmd.
   //
   EFI_USB_DEVICE_DESCRIPTOR    DevDesc;
@@ -207,7 +215,8 @@ struct _USB_XHCI_INSTANCE {
   UINT64                      OriginalPciAttributes;
   USBHC_MEM_POOL              *MemPool;
 
-  EFI_USB2_HC_PROTOCOL        Usb2Hc;
+  EFI_USB2_HC_PROTOCOL                 Usb2Hc;
+  EDKII_USB2_HC_ASYNC_BULK_PROTOCOL    Usb2HcAsyncBulk;
 
   EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
 
@@ -218,8 +227,10 @@ struct _USB_XHCI_INSTANCE {
   EFI_EVENT                   ExitBootServiceEvent;
   EFI_EVENT                   PollTimer;
   LIST_ENTRY                  AsyncIntTransfers;
+  LIST_ENTRY                  AsyncBulkTransfers;
 
   UINT8                       CapLength;  ///< Capability Register Length
+  UINT16                      HciVersion; ///< Interface Version Number
   XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
   XHC_HCSPARAMS2              HcSParams2; ///< Structural Parameters 2
   XHC_HCCPARAMS               HcCParams;  ///< Capability Parameters
@@ -523,6 +534,8 @@ XhcControlTransfer (
   @param  This                  This EFI_USB2_HC_PROTOCOL instance.
   @param  DeviceAddress         Target device address.
   @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  StreamId              The stream of the endpoint, 0 if the endpoint doesn't
+                                use streams.
   @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
                                 transfer.
   @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
@@ -653,6 +666,131 @@ XhcSyncInterruptTransfer (
   OUT    UINT32                              *TransferResult
   );
 
+/**
+  Queues a bulk transfer on a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  DeviceSpeed           Device speed, Low speed device doesn't support bulk
+                                transfer.
+  @param  MaximumPacketLength   Maximum packet size the endpoint is capable of
+                                sending or receiving.
+  @param  Data                  The buffer of data to transmit from or receive into.
+  @param  DataLength            The lenght of the data buffer.
+  @param  Translator            A pointr to the transaction translator data.
+  @param  CallBackFunction      Function to call when the transfer is done.
+  @param  Context               Context to CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer was queued.
+  @retval EFI_NOT_READY         The transfer ring of the endpoint is full.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES  The transfer failed due to lack of resource.
+  @retval EFI_DEVICE_ERROR      The transfer failed due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkSubmit (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL   *This,
+  IN UINT8                               DeviceAddress,
+  IN UINT8                               EndPointAddress,
+  IN UINT16                              StreamId,
+  IN UINT8                               DeviceSpeed,
+  IN UINTN                               MaximumPacketLength,
+  IN VOID                                *Data,
+  IN UINTN                               DataLength,
+  IN EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK     CallBackFunction,
+  IN VOID                                *Context OPTIONAL
+  );
+
+/**
+  Cancels the bulk transfers queued on a bulk endpoint of a USB device, or on
+  one stream of the endpoint.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  StreamId              The stream to cancel, 0 for the whole endpoint.
+
+  @retval EFI_SUCCESS           The transfers were cancelled.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be stopped.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkCancel (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress,
+  IN UINT16                             StreamId
+  );
+
+/**
+  Processes the completed bulk transfers and calls their callbacks.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The completed transfers were processed.
+  @retval EFI_INVALID_PARAMETER This is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkPoll (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This
+  );
+
+/**
+  Gives streams to a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+  @param  NumberOfStreams       On input, the number of streams wanted. On output,
+                                the number of streams given.
+
+  @retval EFI_SUCCESS           The endpoint has streams.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   The endpoint already has streams.
+  @retval EFI_NOT_READY         Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES  The streams could not be allocated.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be configured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkAllocateStreams (
+  IN     EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                              DeviceAddress,
+  IN     UINT8                              EndPointAddress,
+  IN OUT UINT16                             *NumberOfStreams
+  );
+
+/**
+  Frees the streams of a bulk endpoint of a USB device.
+
+  @param  This                  This EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param  DeviceAddress         Target device address.
+  @param  EndPointAddress       Endpoint number and its direction in bit 7.
+
+  @retval EFI_SUCCESS           The streams were freed.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_NOT_READY         Transfers are queued on the streams.
+  @retval EFI_DEVICE_ERROR      The endpoint could not be configured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkFreeStreams (
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress
+  );
+
 /**
   Submits isochronous transfer to a target USB device.
 
@@ -119,6 +119,7 @@ ON_EXIT:
   @param  Xhc       The XHCI Instance
   @param  BusAddr   The logical device address assigned by UsbBus driver
   @param  EpAddr    Endpoint addrress
+  @param  StreamId  The stream of the endpoint, 0 if the endpoint doesn't use streams
   @param  DevSpeed  The device speed
   @param  MaxPacket The max packet length of the endpoint
   @param  Type      The transaction type
@@ -136,6 +137,7 @@ XhcCreateUrb (
   IN USB_XHCI_INSTANCE                *Xhc,
   IN UINT8                            BusAddr,
   IN UINT8                            EpAddr,
+  IN UINT16                           StreamId,
   IN UINT8                            DevSpeed,
   IN UINTN                            MaxPacket,
   IN UINTN                            Type,
@@ -166,6 +168,7 @@ XhcCreateUrb (
   Ep->MaxPacket = MaxPacket;
   Ep->Type      = Type;
 
+  Urb->StreamId = StreamId;
   Urb->Request  = Request;
   Urb->Data     = Data;
   Urb->DataLen  = DataLen;
@@ -206,6 +209,135 @@ XhcFreeUrb (
   FreePool (Urb);
 }
 
+/**
+  Calculate the TD Size field of a Normal TRB, according to XHCI spec 4.11.2.4.
+
+  @param  Xhc         The XHCI Instance
+  @param  Remaining   The number of bytes of the TD after this TRB.
+  @param  MaxPacket   The max packet size of the endpoint.
+
+  @return The TD Size field value.
+
+**/
+UINT32
+XhcCalculateTdSize (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINTN              Remaining,
+  IN UINTN              MaxPacket
+  )
+{
+  UINTN  TdSize;
+
+  if (Remaining == 0) {
+    return 0;
+  }
+
+  if (Xhc->HciVersion < 0x0100) {
+    //
+    // XHCI 0.96 counts the remaining bytes in 1KB units.
+    //
+    TdSize = Remaining >> 10;
+  } else if (MaxPacket != 0) {
+    //
+    // XHCI 1.0 and later count the remaining packets.
+    //
+    TdSize = (Remaining + MaxPacket - 1) / MaxPacket;
+  } else {
+    TdSize = 0;
+  }
+
+  return (UINT32)MIN (TdSize, 31);
+}
+
+/**
+  Advance the enqueue pointer of a transfer ring past the TRB it points to,
+  whatever the cycle bit of that TRB is.
+
+  XhcSyncTrsRing() only moves over the TRBs already handed to the controller,
+  this is used to move over a TRB whose cycle bit is set after the TRBs
+  following it are written.
+
+  @param  Xhc         The XHCI Instance.
+  @param  TrsRing     The transfer ring to advance.
+
+**/
+VOID
+XhcAdvanceTrsRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN TRANSFER_RING      *TrsRing
+  )
+{
+  TRB_TEMPLATE  *TrsTrb;
+
+  TrsTrb = TrsRing->RingEnqueue;
+  TrsTrb++;
+  if ((UINT8)TrsTrb->Type == TRB_TYPE_LINK) {
+    ASSERT (((LINK_TRB *)TrsTrb)->TC != 0);
+    if ((UINT8)(TrsTrb - 1)->Type == TRB_TYPE_NORMAL) {
+      ((LINK_TRB *)TrsTrb)->CH = ((TRANSFER_TRB_NORMAL *)(TrsTrb - 1))->CH;
+    } else {
+      ((LINK_TRB *)TrsTrb)->CH = 0;
+    }
+
+    ((LINK_TRB *)TrsTrb)->CycleBit = TrsRing->RingPCS & BIT0;
+    TrsRing->RingPCS               = (TrsRing->RingPCS & BIT0) ? 0 : 1;
+    TrsTrb                         = (TRB_TEMPLATE *)TrsRing->RingSeg0;
+  }
+
+  TrsRing->RingEnqueue = TrsTrb;
+
+  //
+  // Clear the Trb context for enqueue, but reserve the PCS bit
+  //
+  TrsTrb->Parameter1 = 0;
+  TrsTrb->Parameter2 = 0;
+  TrsTrb->Status     = 0;
+  TrsTrb->RsvdZ1     = 0;
+  TrsTrb->Type       = 0;
+  TrsTrb->Control    = 0;
+}
+
+/**
+  Get the transfer ring of an endpoint, or of one stream of an endpoint
+  using streams.
+
+  @param  Xhc       The XHCI Instance.
+  @param  SlotId    The slot id of the device.
+  @param  Dci       The device context index of the endpoint.
+  @param  StreamId  The stream of the endpoint, 0 if the endpoint doesn't use streams.
+
+  @return The transfer ring, or NULL if the endpoint or the stream doesn't exist.
+
+**/
+TRANSFER_RING *
+XhcGetTransferRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  XHC_ENDPOINT_STREAMS  *Streams;
+
+  Streams = (XHC_ENDPOINT_STREAMS *)Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1];
+  if (Streams == NULL) {
+    if (StreamId != 0) {
+      return NULL;
+    }
+
+    return (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+  }
+
+  //
+  // Stream ID 0 is reserved once the endpoint uses streams.
+  //
+  if ((StreamId == 0) || (StreamId >= Streams->NumStreams)) {
+    return NULL;
+  }
+
+  return &Streams->Rings[StreamId];
+}
+
 /**
   Create a transfer TRB.
 
@@ -230,6 +362,8 @@ XhcCreateTransferTrb (
   UINTN                          TotalLen;
   UINTN                          Len;
   UINTN                          TrbNum;
+  TRB                            *FirstTrb;
+  UINT32                         FirstCycle;
   EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   VOID                           *Map;
@@ -248,7 +382,7 @@ XhcCreateTransferTrb (
 
   Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
   ASSERT (Dci < 32);
-  EPRing = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  EPRing = XhcGetTransferRing (Xhc, SlotId, Dci, Urb->StreamId);
   if (EPRing == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -387,72 +521,68 @@ XhcCreateTransferTrb (
 
     case ED_BULK_OUT:
     case ED_BULK_IN:
-      TotalLen = 0;
-      Len      = 0;
-      TrbNum   = 0;
-      TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
+    case ED_INTERRUPT_OUT:
+    case ED_INTERRUPT_IN:
+      //
+      // Build one TD of chained Normal TRBs. A TRB buffer can't cross a 64KB
+      // boundary (XHCI spec 4.11.7.1). Only the last TRB interrupts on
+      // completion, so a large transfer generates a single transfer event,
+      // plus one more event from the TRB that sees a short packet.
+      //
+      // The endpoint may still be running the TDs queued before this one, so
+      // the first TRB is handed to the controller only after the whole TD is
+      // written.
+      //
+      TotalLen   = 0;
+      Len        = 0;
+      TrbNum     = 0;
+      FirstTrb   = NULL;
+      FirstCycle = 0;
+      TrbStart   = (TRB *)(UINTN)EPRing->RingEnqueue;
       while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
+        Len = 0x10000 - (((UINTN)Urb->DataPhy + TotalLen) & 0xFFFF);
+        if ((TotalLen + Len) >= Urb->DataLen) {
           Len = Urb->DataLen - TotalLen;
-        } else {
-          Len = 0x10000;
         }
 
         TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
         TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
         TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
         TrbStart->TrbNormal.Length    = (UINT32)Len;
-        TrbStart->TrbNormal.TDSize    = 0;
+        TrbStart->TrbNormal.TDSize    = XhcCalculateTdSize (Xhc, Urb->DataLen - TotalLen - Len, Urb->Ep.MaxPacket);
         TrbStart->TrbNormal.IntTarget = 0;
         TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
-        TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
-        //
-        // Update the cycle bit
-        //
-        TrbStart->TrbNormal.CycleBit = EPRing->RingPCS & BIT0;
-
-        XhcSyncTrsRing (Xhc, EPRing);
-        TrbNum++;
-        TotalLen += Len;
-      }
-
-      Urb->TrbNum = TrbNum;
-      Urb->TrbEnd = (TRB_TEMPLATE *)(UINTN)TrbStart;
-      break;
-
-    case ED_INTERRUPT_OUT:
-    case ED_INTERRUPT_IN:
-      TotalLen = 0;
-      Len      = 0;
-      TrbNum   = 0;
-      TrbStart = (TRB *)(UINTN)EPRing->RingEnqueue;
-      while (TotalLen < Urb->DataLen) {
-        if ((TotalLen + 0x10000) >= Urb->DataLen) {
-          Len = Urb->DataLen - TotalLen;
+        if ((TotalLen + Len) < Urb->DataLen) {
+          TrbStart->TrbNormal.CH  = 1;
+          TrbStart->TrbNormal.IOC = 0;
         } else {
-          Len = 0x10000;
+          TrbStart->TrbNormal.CH  = 0;
+          TrbStart->TrbNormal.IOC = 1;
         }
 
-        TrbStart                      = (TRB *)(UINTN)EPRing->RingEnqueue;
-        TrbStart->TrbNormal.TRBPtrLo  = XHC_LOW_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
-        TrbStart->TrbNormal.TRBPtrHi  = XHC_HIGH_32BIT ((UINT8 *)Urb->DataPhy + TotalLen);
-        TrbStart->TrbNormal.Length    = (UINT32)Len;
-        TrbStart->TrbNormal.TDSize    = 0;
-        TrbStart->TrbNormal.IntTarget = 0;
-        TrbStart->TrbNormal.ISP       = 1;
-        TrbStart->TrbNormal.IOC       = 1;
-        TrbStart->TrbNormal.Type      = TRB_TYPE_NORMAL;
+        TrbStart->TrbNormal.Type = TRB_TYPE_NORMAL;
         //
         // Update the cycle bit
         //
-        TrbStart->TrbNormal.CycleBit = EPRing->RingPCS & BIT0;
+        if (TrbNum == 0) {
+          FirstTrb                     = TrbStart;
+          FirstCycle                   = EPRing->RingPCS & BIT0;
+          TrbStart->TrbNormal.CycleBit = FirstCycle ^ BIT0;
+          XhcAdvanceTrsRing (Xhc, EPRing);
+        } else {
+          TrbStart->TrbNormal.CycleBit = EPRing->RingPCS & BIT0;
+          XhcSyncTrsRing (Xhc, EPRing);
+        }
 
-        XhcSyncTrsRing (Xhc, EPRing);
         TrbNum++;
         TotalLen += Len;
       }
 
+      if (FirstTrb != NULL) {
+        MemoryFence ();
+        FirstTrb->TrbNormal.CycleBit = FirstCycle;
+      }
+
       Urb->TrbNum = TrbNum;
       Urb->TrbEnd = (TRB_TEMPLATE *)(UINTN)TrbStart;
       break;
@@ -700,7 +830,7 @@ XhcRecoverHaltedEndpoint (
   //
   // 3)Ring the doorbell to transit from stop to active
   //
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -1028,31 +1158,28 @@ IsTransferRingTrb (
   IN  URB                *Urb
   )
 {
-  LINK_TRB              *LinkTrb;
-  TRB_TEMPLATE          *CheckedTrb;
-  UINTN                 Index;
-  EFI_PHYSICAL_ADDRESS  PhyAddr;
+  TRB_TEMPLATE  *RingStart;
+  TRB_TEMPLATE  *RingLink;
 
-  CheckedTrb = Urb->TrbStart;
-  for (Index = 0; Index < Urb->TrbNum; Index++) {
-    if (Trb == CheckedTrb) {
-      return TRUE;
-    }
+  if (Urb->TrbNum == 0) {
+    return FALSE;
+  }
 
-    CheckedTrb++;
-    //
-    // If the checked TRB is the link TRB at the end of the transfer ring,
-    // recircle it to the head of the ring.
-    //
-    if (CheckedTrb->Type == TRB_TYPE_LINK) {
-      LinkTrb    = (LINK_TRB *)CheckedTrb;
-      PhyAddr    = (EFI_PHYSICAL_ADDRESS)(LinkTrb->PtrLo | LShiftU64 ((UINT64)LinkTrb->PtrHi, 32));
-      CheckedTrb = (TRB_TEMPLATE *)(UINTN)UsbHcGetHostAddrForPciAddr (Xhc->MemPool, (VOID *)(UINTN)PhyAddr, sizeof (TRB_TEMPLATE), FALSE);
-      ASSERT (CheckedTrb == Urb->Ring->RingSeg0);
-    }
+  //
+  // The TRBs of an URB are contiguous in the single segment transfer ring,
+  // except that they may wrap around at the link TRB. So compare with the
+  // range rather than walking all the TRBs.
+  //
+  if (Urb->TrbStart <= Urb->TrbEnd) {
+    return (BOOLEAN)((Trb >= Urb->TrbStart) && (Trb <= Urb->TrbEnd));
   }
 
-  return FALSE;
+  RingStart = (TRB_TEMPLATE *)Urb->Ring->RingSeg0;
+  RingLink  = RingStart + Urb->Ring->TrbNumber - 1;
+  ASSERT (RingLink->Type == TRB_TYPE_LINK);
+
+  return (BOOLEAN)(((Trb >= Urb->TrbStart) && (Trb < RingLink)) ||
+                   ((Trb >= RingStart) && (Trb <= Urb->TrbEnd)));
 }
 
 /**
@@ -1088,6 +1215,38 @@ IsAsyncIntTrb (
   return FALSE;
 }
 
+/**
+  Check if the Trb is a transaction of the URBs in XHCI's asynchronous bulk transfer list.
+
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB to be checked.
+  @param Urb    The pointer to the matched Urb.
+
+  @retval TRUE  The Trb is matched with a transaction of the URBs in the async bulk list.
+  @retval FALSE The Trb is not matched with any URBs in the async bulk list.
+
+**/
+BOOLEAN
+IsAsyncBulkTrb (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  TRB_TEMPLATE       *Trb,
+  OUT URB                **Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!CheckedUrb->Finished && IsTransferRingTrb (Xhc, Trb, CheckedUrb)) {
+      *Urb = CheckedUrb;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1115,6 +1274,7 @@ XhcCheckUrbResult (
   UINT32                High;
   UINT32                Low;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
+  EFI_PHYSICAL_ADDRESS  TrbDataPhy;
 
   ASSERT ((Xhc != NULL) && (Urb != NULL));
 
@@ -1170,6 +1330,8 @@ XhcCheckUrbResult (
       CheckedUrb = Urb;
     } else if (IsAsyncIntTrb (Xhc, TRBPtr, &AsyncUrb)) {
       CheckedUrb = AsyncUrb;
+    } else if (IsAsyncBulkTrb (Xhc, TRBPtr, &AsyncUrb)) {
+      CheckedUrb = AsyncUrb;
     } else {
       continue;
     }
@@ -1219,11 +1381,32 @@ XhcCheckUrbResult (
         }
 
         TRBType = (UINT8)(TRBPtr->Type);
-        if ((TRBType == TRB_TYPE_DATA_STAGE) ||
-            (TRBType == TRB_TYPE_NORMAL) ||
-            (TRBType == TRB_TYPE_ISOCH))
+        if (((TRBType == TRB_TYPE_DATA_STAGE) ||
+             (TRBType == TRB_TYPE_NORMAL) ||
+             (TRBType == TRB_TYPE_ISOCH)) &&
+            !CheckedUrb->EndDone)
         {
-          CheckedUrb->Completed += (((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length);
+          //
+          // The chained TRBs before the reported one are all done, so the
+          // completed length is counted from the start of the URB buffer.
+          // A short packet ends the TD, so once it is reported the later
+          // event of the IOC TRB must not overwrite its length.
+          //
+          TrbDataPhy = (EFI_PHYSICAL_ADDRESS)(((TRANSFER_TRB_NORMAL *)TRBPtr)->TRBPtrLo |
+                                              LShiftU64 ((UINT64)((TRANSFER_TRB_NORMAL *)TRBPtr)->TRBPtrHi, 32));
+          CheckedUrb->Completed = (UINTN)(TrbDataPhy - (UINTN)CheckedUrb->DataPhy) +
+                                  (((TRANSFER_TRB_NORMAL *)TRBPtr)->Length - EvtTrb->Length);
+        }
+
+        if (TRBType == TRB_TYPE_NORMAL) {
+          //
+          // Only the last TRB of a bulk or interrupt TD reports completion, and
+          // a short packet ends the TD at whichever TRB it happens.
+          //
+          CheckedUrb->StartDone = TRUE;
+          if (EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) {
+            CheckedUrb->EndDone = TRUE;
+          }
         }
 
         break;
@@ -1496,6 +1679,7 @@ XhciInsertAsyncIntTransfer (
           Xhc,
           BusAddr,
           EpAddr,
+          0,
           DevSpeed,
           MaxPacket,
           XHC_INT_TRANSFER_ASYNC,
@@ -1535,72 +1719,627 @@ XhcUpdateAsyncRequest (
 {
   EFI_STATUS  Status;
 
-  if (Urb->Result == EFI_USB_NOERROR) {
-    Status = XhcCreateTransferTrb (Xhc, Urb);
-    if (EFI_ERROR (Status)) {
-      return;
+  if (Urb->Result == EFI_USB_NOERROR) {
+    Status = XhcCreateTransferTrb (Xhc, Urb);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+
+    Status = RingIntTransferDoorBell (Xhc, Urb);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+  }
+}
+
+/**
+  Flush data from PCI controller specific address to mapped system
+  memory address.
+
+  @param  Xhc                The XHCI device.
+  @param  Urb                The URB to unmap.
+
+  @retval EFI_SUCCESS        Success to flush data to mapped system memory.
+  @retval EFI_DEVICE_ERROR   Fail to flush data to mapped system memory.
+
+**/
+EFI_STATUS
+XhcFlushAsyncIntMap (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
+  EFI_PCI_IO_PROTOCOL            *PciIo;
+  UINTN                          Len;
+  VOID                           *Map;
+
+  PciIo = Xhc->PciIo;
+  Len   = Urb->DataLen;
+
+  if (Urb->Ep.Direction == EfiUsbDataIn) {
+    MapOp = EfiPciIoOperationBusMasterWrite;
+  } else {
+    MapOp = EfiPciIoOperationBusMasterRead;
+  }
+
+  if (Urb->DataMap != NULL) {
+    Status = PciIo->Unmap (PciIo, Urb->DataMap);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  Urb->DataMap = NULL;
+
+  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
+  if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
+    goto ON_ERROR;
+  }
+
+  Urb->DataPhy = (VOID *)((UINTN)PhyAddr);
+  Urb->DataMap = Map;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  return EFI_DEVICE_ERROR;
+}
+
+/**
+  Check whether a finished asynchronous bulk transfer left its endpoint halted.
+
+  @param  Urb     The URB to check.
+
+  @retval TRUE    The endpoint of the URB is halted.
+  @retval FALSE   The endpoint of the URB is not halted.
+
+**/
+BOOLEAN
+XhcIsAsyncBulkHalted (
+  IN URB  *Urb
+  )
+{
+  //
+  // Based on XHCI spec 4.8.3, these are the errors which halt the endpoint.
+  //
+  return (BOOLEAN)(Urb->Finished && ((Urb->Result & (EFI_USB_ERR_STALL | EFI_USB_ERR_BABBLE | EDKII_USB_ERR_TRANSACTION)) != 0));
+}
+
+/**
+  Insert an asynchronous bulk transfer behind the ones already queued on
+  the endpoint, or on the stream of the endpoint, and build its TD on the
+  transfer ring.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param StreamId       The stream of the endpoint, 0 if the endpoint doesn't use streams
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param Data           The data buffer of the transfer
+  @param DataLen        The length of data buffer
+  @param Callback       The function to call when the transfer is done
+  @param Context        The context to the callback
+  @param Urb            The created URB
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_NOT_READY          The transfer ring of the endpoint is full.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a configured bulk endpoint,
+                                 the stream doesn't exist, or the TD doesn't
+                                 fit in the transfer ring.
+  @retval EFI_OUT_OF_RESOURCES   Failed to create the URB.
+  @retval EFI_DEVICE_ERROR       The device isn't enabled.
+
+**/
+EFI_STATUS
+XhciInsertAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE                *Xhc,
+  IN  UINT8                            BusAddr,
+  IN  UINT8                            EpAddr,
+  IN  UINT16                           StreamId,
+  IN  UINT8                            DevSpeed,
+  IN  UINTN                            MaxPacket,
+  IN  VOID                             *Data,
+  IN  UINTN                            DataLen,
+  IN  EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN  VOID                             *Context,
+  OUT URB                              **Urb
+  )
+{
+  LIST_ENTRY     *Entry;
+  URB            *QueuedUrb;
+  TRANSFER_RING  *EPRing;
+  VOID           *OutputContext;
+  UINT8          EPType;
+  UINT8          SlotId;
+  UINT8          Dci;
+  UINTN          UsedTrbs;
+  UINTN          NeededTrbs;
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, BusAddr);
+  if (SlotId == 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Dci = XhcEndpointToDci ((UINT8)(EpAddr & 0x0F), (UINT8)(((EpAddr & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut));
+  ASSERT (Dci < 32);
+  EPRing = XhcGetTransferRing (Xhc, SlotId, Dci, StreamId);
+  if (EPRing == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    EPType = (UINT8)((DEVICE_CONTEXT *)OutputContext)->EP[Dci-1].EPType;
+  } else {
+    EPType = (UINT8)((DEVICE_CONTEXT_64 *)OutputContext)->EP[Dci-1].EPType;
+  }
+
+  if ((EPType != ED_BULK_OUT) && (EPType != ED_BULK_IN)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // A TRB buffer can't cross a 64KB boundary, so the TD takes at most one
+  // TRB per 64KB plus the two partial ones at its ends. The ring keeps its
+  // link TRB and one free TRB for the enqueue pointer.
+  //
+  NeededTrbs = (DataLen >> 16) + 2;
+  if (NeededTrbs > EPRing->TrbNumber - 2) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  UsedTrbs = 0;
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    QueuedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!QueuedUrb->Finished && (QueuedUrb->Ring == EPRing)) {
+      UsedTrbs += QueuedUrb->TrbNum;
+    }
+  }
+
+  if (UsedTrbs + NeededTrbs > EPRing->TrbNumber - 2) {
+    return EFI_NOT_READY;
+  }
+
+  *Urb = XhcCreateUrb (
+           Xhc,
+           BusAddr,
+           EpAddr,
+           StreamId,
+           DevSpeed,
+           MaxPacket,
+           XHC_BULK_TRANSFER_ASYNC,
+           NULL,
+           Data,
+           DataLen,
+           Callback,
+           Context
+           );
+  if (*Urb == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to create URB\n", __func__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The transfers of an endpoint complete in order, keep the list in the
+  // same order so that they are reported in order.
+  //
+  InsertTailList (&Xhc->AsyncBulkTransfers, &(*Urb)->UrbList);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Finish the asynchronous bulk transfers not yet done by the controller,
+  without touching the transfer rings. They are reported with Result on
+  the next XhcProcessAsyncBulkTransfers().
+
+  This is used before the transfer rings are freed or reinitialized.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot whose transfers are finished, or 0 for all the slots.
+  @param  Dci                   The endpoint whose transfers are finished, or 0 for all the
+                                endpoints of the slot.
+  @param  Result                The result of the finished transfers.
+
+**/
+VOID
+XhcAbortAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT32             Result
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *Urb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (Urb->Finished) {
+      continue;
+    }
+
+    if ((SlotId != 0) && (XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr) != SlotId)) {
+      continue;
+    }
+
+    if ((Dci != 0) && (XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction)) != Dci)) {
+      continue;
+    }
+
+    //
+    // Clear TrbNum so that the TRBs left on the ring no longer match the URB.
+    //
+    Urb->Result  |= Result;
+    Urb->Finished = TRUE;
+    Urb->TrbNum   = 0;
+  }
+}
+
+/**
+  Ring the doorbells of the streams which still have asynchronous bulk
+  transfers queued on an endpoint, to restart the endpoint after it was
+  stopped or halted. An endpoint without streams only has stream 0.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint number.
+  @param  Direction             The direction of the endpoint.
+
+**/
+VOID
+XhcRingAsyncBulkDoorBells (
+  IN USB_XHCI_INSTANCE       *Xhc,
+  IN UINT8                   BusAddr,
+  IN UINT8                   EpNum,
+  IN EFI_USB_DATA_DIRECTION  Direction
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *Urb;
+  UINT8       SlotId;
+  UINT8       Dci;
+  UINT32      Rung;
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, BusAddr);
+  if (SlotId == 0) {
+    return;
+  }
+
+  Dci  = XhcEndpointToDci (EpNum, (UINT8)Direction);
+  Rung = 0;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (Urb->Finished || (Urb->Ep.BusAddr != BusAddr) || (Urb->Ep.EpAddr != EpNum) || (Urb->Ep.Direction != Direction)) {
+      continue;
+    }
+
+    ASSERT (Urb->StreamId < XHC_MAX_STREAMS);
+    if ((Rung & (BIT0 << Urb->StreamId)) == 0) {
+      Rung |= (BIT0 << Urb->StreamId);
+      XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
+    }
+  }
+}
+
+/**
+  Recover the endpoint halted by an asynchronous bulk transfer. The
+  transfers queued behind the failed one are finished with
+  EFI_USB_ERR_NOTEXECUTE, and the transfer ring of the endpoint, or of the
+  stream, is emptied. The other streams of the endpoint are restarted.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  Urb                   The URB which halted the endpoint.
+
+**/
+VOID
+XhcRecoverAsyncBulkEndpoint (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *QueuedUrb;
+  EFI_STATUS  Status;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    QueuedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!QueuedUrb->Finished && (QueuedUrb->Ring == Urb->Ring)) {
+      QueuedUrb->Result  |= EFI_USB_ERR_NOTEXECUTE;
+      QueuedUrb->Finished = TRUE;
+      QueuedUrb->TrbNum   = 0;
+    }
+  }
+
+  Status = XhcRecoverHaltedEndpoint (Xhc, Urb);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcRecoverAsyncBulkEndpoint: XhcRecoverHaltedEndpoint failed, Status = %r\n", Status));
+    return;
+  }
+
+  if (Urb->StreamId != 0) {
+    XhcRingAsyncBulkDoorBells (Xhc, Urb->Ep.BusAddr, Urb->Ep.EpAddr, Urb->Ep.Direction);
+  }
+}
+
+/**
+  Call the callbacks of the finished asynchronous bulk transfers in a list,
+  and free them.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  Done                  The list of the finished URBs.
+  @param  OldTpl                The TPL to call the callbacks at.
+
+**/
+VOID
+XhcCompleteAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN LIST_ENTRY         *Done,
+  IN EFI_TPL            OldTpl
+  )
+{
+  URB                              *Urb;
+  VOID                             *Data;
+  UINTN                            Completed;
+  UINT32                           Result;
+  EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback;
+  VOID                             *Context;
+
+  if (IsListEmpty (Done)) {
+    return;
+  }
+
+  Xhc->PciIo->Flush (Xhc->PciIo);
+
+  while (!IsListEmpty (Done)) {
+    Urb = EFI_LIST_CONTAINER (GetFirstNode (Done), URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+
+    Data      = Urb->Data;
+    Completed = MIN (Urb->Completed, Urb->DataLen);
+    Result    = Urb->Result;
+    Callback  = Urb->Callback;
+    Context   = Urb->Context;
+
+    //
+    // Unmap the data before the callback looks at it.
+    //
+    XhcFreeUrb (Xhc, Urb);
+
+    //
+    // Restore the old TPL, the callback may submit new transfers or wait
+    // for a lower TPL event.
+    //
+    gBS->RestoreTPL (OldTpl);
+    Callback (Data, Completed, Context, Result);
+    gBS->RaiseTPL (XHC_TPL);
+  }
+}
+
+/**
+  Update the asynchronous bulk transfers from the event ring, recover the
+  endpoints they halted, and call the callbacks of the finished ones.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  OldTpl                The TPL to call the callbacks at.
+
+**/
+VOID
+XhcProcessAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN EFI_TPL            OldTpl
+  )
+{
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Next;
+  LIST_ENTRY  Done;
+  URB         *Urb;
+
+  InitializeListHead (&Done);
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished) {
+      XhcCheckUrbResult (Xhc, Urb);
+    }
+  }
+
+  //
+  // Move the finished URBs out of the list before calling any callback,
+  // the callbacks may submit or cancel transfers.
+  //
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished) {
+      continue;
+    }
+
+    if (XhcIsAsyncBulkHalted (Urb)) {
+      XhcRecoverAsyncBulkEndpoint (Xhc, Urb);
+    }
+
+    RemoveEntryList (Entry);
+    InsertTailList (&Done, Entry);
+  }
+
+  XhcCompleteAsyncBulkTransfers (Xhc, &Done, OldTpl);
+}
+
+/**
+  Cancel the asynchronous bulk transfers of an endpoint, or of one stream
+  of an endpoint, and call their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+  @param  StreamId              The stream whose transfers are cancelled, or 0 for all
+                                the transfers of the endpoint.
+  @param  OldTpl                The TPL to call the callbacks at.
+
+  @retval EFI_SUCCESS           The transfers are cancelled.
+  @retval EFI_DEVICE_ERROR      Failed to stop the endpoint.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum,
+  IN  UINT16             StreamId,
+  IN  EFI_TPL            OldTpl
+  )
+{
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+  LIST_ENTRY              Done;
+  URB                     *Urb;
+  URB                     *HaltedUrb;
+  URB                     *PendingUrb;
+  URB                     *StreamUrb[XHC_MAX_STREAMS];
+  EFI_USB_DATA_DIRECTION  Direction;
+  EFI_STATUS              Status;
+  UINT8                   SlotId;
+  UINT8                   Dci;
+  UINTN                   Index;
+
+  Direction = ((EpNum & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut;
+  EpNum    &= 0x0F;
+
+  InitializeListHead (&Done);
+  HaltedUrb  = NULL;
+  PendingUrb = NULL;
+  Status     = EFI_SUCCESS;
+
+  //
+  // A transfer of any stream may have halted the endpoint, recover it
+  // before stopping the endpoint.
+  //
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr != BusAddr) || (Urb->Ep.EpAddr != EpNum) || (Urb->Ep.Direction != Direction)) {
+      continue;
+    }
+
+    if (!Urb->Finished) {
+      XhcCheckUrbResult (Xhc, Urb);
+    }
+
+    if ((HaltedUrb == NULL) && XhcIsAsyncBulkHalted (Urb)) {
+      HaltedUrb = Urb;
+    }
+  }
+
+  if (HaltedUrb != NULL) {
+    XhcRecoverAsyncBulkEndpoint (Xhc, HaltedUrb);
+  }
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished && (Urb->Ep.BusAddr == BusAddr) && (Urb->Ep.EpAddr == EpNum) && (Urb->Ep.Direction == Direction) &&
+        ((StreamId == 0) || (Urb->StreamId == StreamId)))
+    {
+      PendingUrb = Urb;
+      break;
+    }
+  }
+
+  if (PendingUrb != NULL) {
+    //
+    // Stop the endpoint, the transfer in progress finishes with a Stopped
+    // event. Then drop the TDs left on the rings of the cancelled streams,
+    // and restart the other streams.
+    //
+    SlotId = XhcBusDevAddrToSlotId (Xhc, BusAddr);
+    Dci    = XhcEndpointToDci (EpNum, (UINT8)Direction);
+    if (SlotId != 0) {
+      Status = XhcStopEndpoint (Xhc, SlotId, Dci, NULL);
+      if (EFI_ERROR (Status)) {
+        //
+        // The endpoint is halted if the transfer in progress failed meanwhile.
+        //
+        DEBUG ((DEBUG_ERROR, "XhciDelAsyncBulkTransfer: XhcStopEndpoint failed, Status = %r\n", Status));
+        Status = XhcResetEndpoint (Xhc, SlotId, Dci);
+      }
+    }
+
+    ZeroMem (StreamUrb, sizeof (StreamUrb));
+    BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+      Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+      if (!Urb->Finished && (Urb->Ep.BusAddr == BusAddr) && (Urb->Ep.EpAddr == EpNum) && (Urb->Ep.Direction == Direction) &&
+          ((StreamId == 0) || (Urb->StreamId == StreamId)))
+      {
+        Urb->Result  |= EFI_USB_ERR_NOTEXECUTE;
+        Urb->Finished = TRUE;
+        Urb->TrbNum   = 0;
+
+        ASSERT (Urb->StreamId < XHC_MAX_STREAMS);
+        StreamUrb[Urb->StreamId] = Urb;
+      }
+    }
+
+    if (SlotId != 0) {
+      for (Index = 0; Index < XHC_MAX_STREAMS; Index++) {
+        if (StreamUrb[Index] != NULL) {
+          XhcSetTrDequeuePointer (Xhc, SlotId, Dci, StreamUrb[Index]);
+        }
+      }
+
+      //
+      // Stream 0 is only used by an endpoint without streams, which is
+      // restarted with an empty transfer ring.
+      //
+      if (StreamUrb[0] != NULL) {
+        XhcRingDoorBell (Xhc, SlotId, Dci);
+      }
+
+      XhcRingAsyncBulkDoorBells (Xhc, BusAddr, EpNum, Direction);
     }
+  }
 
-    Status = RingIntTransferDoorBell (Xhc, Urb);
-    if (EFI_ERROR (Status)) {
-      return;
+  //
+  // Complete the cancelled transfers, and the finished ones of the other
+  // streams, which would be reported by the next poll otherwise.
+  //
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr == BusAddr) && (Urb->Ep.EpAddr == EpNum) && (Urb->Ep.Direction == Direction) &&
+        (Urb->Finished || (StreamId == 0) || (Urb->StreamId == StreamId)))
+    {
+      ASSERT (Urb->Finished);
+      RemoveEntryList (Entry);
+      InsertTailList (&Done, Entry);
     }
   }
+
+  XhcCompleteAsyncBulkTransfers (Xhc, &Done, OldTpl);
+
+  return (Status == EFI_SUCCESS) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
 }
 
 /**
-  Flush data from PCI controller specific address to mapped system
-  memory address.
-
-  @param  Xhc                The XHCI device.
-  @param  Urb                The URB to unmap.
+  Remove all the asynchronous bulk transfers without calling their callbacks.
 
-  @retval EFI_SUCCESS        Success to flush data to mapped system memory.
-  @retval EFI_DEVICE_ERROR   Fail to flush data to mapped system memory.
+  @param  Xhc    The XHCI Instance.
 
 **/
-EFI_STATUS
-XhcFlushAsyncIntMap (
-  IN  USB_XHCI_INSTANCE  *Xhc,
-  IN  URB                *Urb
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
   )
 {
-  EFI_STATUS                     Status;
-  EFI_PHYSICAL_ADDRESS           PhyAddr;
-  EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
-  UINTN                          Len;
-  VOID                           *Map;
-
-  PciIo = Xhc->PciIo;
-  Len   = Urb->DataLen;
-
-  if (Urb->Ep.Direction == EfiUsbDataIn) {
-    MapOp = EfiPciIoOperationBusMasterWrite;
-  } else {
-    MapOp = EfiPciIoOperationBusMasterRead;
-  }
-
-  if (Urb->DataMap != NULL) {
-    Status = PciIo->Unmap (PciIo, Urb->DataMap);
-    if (EFI_ERROR (Status)) {
-      goto ON_ERROR;
-    }
-  }
-
-  Urb->DataMap = NULL;
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Next;
+  URB         *Urb;
 
-  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
-  if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
-    goto ON_ERROR;
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+    XhcFreeUrb (Xhc, Urb);
   }
-
-  Urb->DataPhy = (VOID *)((UINTN)PhyAddr);
-  Urb->DataMap = Map;
-  return EFI_SUCCESS;
-
-ON_ERROR:
-  return EFI_DEVICE_ERROR;
 }
 
 /**
@@ -1708,6 +2447,8 @@ XhcMonitorAsyncRequests (
 
     XhcUpdateAsyncRequest (Xhc, Urb);
   }
+
+  XhcProcessAsyncBulkTransfers (Xhc, OldTpl);
   gBS->RestoreTPL (OldTpl);
 }
 
@@ -1991,6 +2732,15 @@ XhcSyncTrsRing (
     TrsTrb++;
     if ((UINT8)TrsTrb->Type == TRB_TYPE_LINK) {
       ASSERT (((LINK_TRB *)TrsTrb)->TC != 0);
+      //
+      // The Link TRB is part of the TD if the TD continues after it.
+      //
+      if ((UINT8)(TrsTrb - 1)->Type == TRB_TYPE_NORMAL) {
+        ((LINK_TRB *)TrsTrb)->CH = ((TRANSFER_TRB_NORMAL *)(TrsTrb - 1))->CH;
+      } else {
+        ((LINK_TRB *)TrsTrb)->CH = 0;
+      }
+
       //
       // set cycle bit in Link TRB as normal
       //
@@ -2087,6 +2837,38 @@ XhcRingDoorBell (
   return EFI_SUCCESS;
 }
 
+/**
+  Ring the door bell of one stream of an endpoint. Stream 0 rings the
+  endpoint without streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream of the endpoint.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  if (StreamId == 0) {
+    return XhcRingDoorBell (Xhc, SlotId, Dci);
+  }
+
+  //
+  // 5.6 Doorbell Registers, DB Stream ID is in bits 31:16.
+  //
+  XhcWriteDoorBellReg (Xhc, SlotId * sizeof (UINT32), Dci | ((UINT32)StreamId << 16));
+
+  return EFI_SUCCESS;
+}
+
 /**
   Ring the door bell to notify XHCI there is a transaction to be executed through URB.
 
@@ -2107,7 +2889,7 @@ RingIntTransferDoorBell (
 
   SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
   Dci    = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
   return EFI_SUCCESS;
 }
 
@@ -2647,6 +3429,12 @@ XhcDisableSlotCmd (
     return Status;
   }
 
+  //
+  // The transfer rings are freed below, finish the asynchronous bulk
+  // transfers still queued on them.
+  //
+  XhcAbortAsyncBulkTransfers (Xhc, SlotId, 0, EFI_USB_ERR_NOTEXECUTE);
+
   //
   // Free the slot's device context entry
   //
@@ -2656,6 +3444,7 @@ XhcDisableSlotCmd (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeStreams (Xhc, SlotId, (UINT8)(Index + 1), FALSE);
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
@@ -2760,6 +3549,12 @@ XhcDisableSlotCmd64 (
     return Status;
   }
 
+  //
+  // The transfer rings are freed below, finish the asynchronous bulk
+  // transfers still queued on them.
+  //
+  XhcAbortAsyncBulkTransfers (Xhc, SlotId, 0, EFI_USB_ERR_NOTEXECUTE);
+
   //
   // Free the slot's device context entry
   //
@@ -2769,6 +3564,7 @@ XhcDisableSlotCmd64 (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeStreams (Xhc, SlotId, (UINT8)(Index + 1), FALSE);
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
@@ -3562,6 +4358,14 @@ XhcSetTrDequeuePointer (
   PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Urb->Ring->RingEnqueue, sizeof (CMD_SET_TR_DEQ_POINTER), FALSE);
   CmdSetTRDeq.PtrLo    = XHC_LOW_32BIT (PhyAddr) | Urb->Ring->RingPCS;
   CmdSetTRDeq.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  if (Urb->StreamId != 0) {
+    //
+    // The ring of a stream is a Primary Transfer Ring, bits 3:1 hold its Stream Context Type.
+    //
+    CmdSetTRDeq.PtrLo   |= (STREAM_CONTEXT_SCT_PRIMARY_RING << 1);
+    CmdSetTRDeq.StreamID = Urb->StreamId;
+  }
+
   CmdSetTRDeq.CycleBit = 1;
   CmdSetTRDeq.Type     = TRB_TYPE_SET_TR_DEQUE;
   CmdSetTRDeq.Endpoint = Dci;
@@ -3579,6 +4383,316 @@ XhcSetTrDequeuePointer (
   return Status;
 }
 
+/**
+  Reconfigure an endpoint through XHCI's Configure_Endpoint cmd to use a
+  Primary Stream Array, or its single transfer ring again.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  Dci                   The device context index of the endpoint.
+  @param  MaxPStreams           The MaxPStreams field of the endpoint context, 0
+                                for the single transfer ring.
+  @param  Pointer               The physical address of the Primary Stream Array, or
+                                of the dequeue TRB with its cycle state.
+
+  @retval EFI_SUCCESS           The endpoint is reconfigured.
+  @retval Others                Failed to reconfigure the endpoint.
+
+**/
+EFI_STATUS
+XhcConfigureStreamEndpoint (
+  IN USB_XHCI_INSTANCE     *Xhc,
+  IN UINT8                 SlotId,
+  IN UINT8                 Dci,
+  IN UINT8                 MaxPStreams,
+  IN EFI_PHYSICAL_ADDRESS  Pointer
+  )
+{
+  EFI_STATUS                  Status;
+  INPUT_CONTEXT               *InputContext;
+  INPUT_CONTEXT_64            *InputContext64;
+  ENDPOINT_CONTEXT            *EpContext;
+  UINTN                       InputContextSize;
+  EFI_PHYSICAL_ADDRESS        PhyAddr;
+  CMD_TRB_CONFIG_ENDPOINT     CmdTrbCfgEP;
+  EVT_TRB_COMMAND_COMPLETION  *EvtTrb;
+
+  //
+  // XHCI 4.6.6 Configure Endpoint
+  // If a parameter of an enabled endpoint is modified, the Drop Context and
+  // Add Context flags of the endpoint shall be set to '1'.
+  //
+  // The first 32 bytes of a 64-byte endpoint context have the layout of a
+  // 32-byte one.
+  //
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    InputContext     = (INPUT_CONTEXT *)Xhc->UsbDevContext[SlotId].InputContext;
+    InputContextSize = sizeof (INPUT_CONTEXT);
+    ZeroMem (InputContext, sizeof (INPUT_CONTEXT));
+    CopyMem (&InputContext->Slot, &((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->Slot, sizeof (SLOT_CONTEXT));
+    CopyMem (&InputContext->EP[Dci - 1], &((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1], sizeof (ENDPOINT_CONTEXT));
+    InputContext->InputControlContext.Dword1 = (BIT0 << Dci);
+    InputContext->InputControlContext.Dword2 = BIT0 | (BIT0 << Dci);
+    EpContext                                = &InputContext->EP[Dci - 1];
+  } else {
+    InputContext64   = (INPUT_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].InputContext;
+    InputContextSize = sizeof (INPUT_CONTEXT_64);
+    ZeroMem (InputContext64, sizeof (INPUT_CONTEXT_64));
+    CopyMem (&InputContext64->Slot, &((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->Slot, sizeof (SLOT_CONTEXT_64));
+    CopyMem (&InputContext64->EP[Dci - 1], &((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1], sizeof (ENDPOINT_CONTEXT_64));
+    InputContext64->InputControlContext.Dword1 = (BIT0 << Dci);
+    InputContext64->InputControlContext.Dword2 = BIT0 | (BIT0 << Dci);
+    EpContext                                  = (ENDPOINT_CONTEXT *)&InputContext64->EP[Dci - 1];
+  }
+
+  EpContext->EPState     = 0;
+  EpContext->MaxPStreams = MaxPStreams;
+  EpContext->LSA         = (MaxPStreams != 0) ? 1 : 0;
+  EpContext->HID         = 0;
+  EpContext->PtrLo       = XHC_LOW_32BIT (Pointer);
+  EpContext->PtrHi       = XHC_HIGH_32BIT (Pointer);
+
+  EvtTrb = NULL;
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Xhc->UsbDevContext[SlotId].InputContext, InputContextSize, TRUE);
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  Status               = XhcCmdTransfer (
+                           Xhc,
+                           (TRB_TEMPLATE *)(UINTN)&CmdTrbCfgEP,
+                           XHC_GENERIC_TIMEOUT,
+                           (TRB_TEMPLATE **)(UINTN)&EvtTrb
+                           );
+  if (EFI_ERROR (Status) || (EvtTrb == NULL)) {
+    DEBUG ((DEBUG_ERROR, "XhcConfigureStreamEndpoint: Config Endpoint Failed, Status = %r\n", Status));
+  }
+
+  return Status;
+}
+
+/**
+  Free the stream rings and the Primary Stream Array of an endpoint.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  Streams               The streams to free.
+
+**/
+VOID
+XhcFreeStreamRings (
+  IN USB_XHCI_INSTANCE     *Xhc,
+  IN XHC_ENDPOINT_STREAMS  *Streams
+  )
+{
+  UINTN  Index;
+
+  for (Index = 1; Index < Streams->NumStreams; Index++) {
+    if (Streams->Rings[Index].RingSeg0 != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, Streams->Rings[Index].RingSeg0, sizeof (TRB_TEMPLATE) * STREAM_RING_TRB_NUMBER);
+    }
+  }
+
+  if (Streams->StreamContexts != NULL) {
+    UsbHcFreeMem (Xhc->MemPool, Streams->StreamContexts, sizeof (STREAM_CONTEXT) * Streams->NumStreams);
+  }
+
+  FreePool (Streams);
+}
+
+/**
+  Make a bulk endpoint use streams. A Primary Stream Array is allocated
+  with a transfer ring per stream, and the endpoint is reconfigured to use
+  it. The transfers of the endpoint then select a stream by its ID.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  Dci                   The device context index of the endpoint.
+  @param  NumStreams            On input, the number of streams wanted. On output,
+                                the number of streams allocated, with IDs 1 to
+                                NumStreams. It may be lower or higher than wanted.
+
+  @retval EFI_SUCCESS           The endpoint uses streams.
+  @retval EFI_UNSUPPORTED       The controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER The endpoint isn't a configured bulk endpoint, or
+                                NumStreams is 0.
+  @retval EFI_ALREADY_STARTED   The endpoint already uses streams.
+  @retval EFI_NOT_READY         Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the streams.
+  @retval Others                Failed to reconfigure the endpoint.
+
+**/
+EFI_STATUS
+XhcAllocateStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              Dci,
+  IN OUT UINT16             *NumStreams
+  )
+{
+  EFI_STATUS            Status;
+  XHC_ENDPOINT_STREAMS  *Streams;
+  TRANSFER_RING         *EPRing;
+  LIST_ENTRY            *Entry;
+  URB                   *Urb;
+  VOID                  *OutputContext;
+  UINT8                 EPType;
+  UINTN                 MaxArraySize;
+  UINTN                 ArraySize;
+  UINT8                 MaxPStreams;
+  UINTN                 Index;
+  EFI_PHYSICAL_ADDRESS  PhyAddr;
+
+  if (Xhc->HcCParams.Data.MaxPsaSize == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  EPRing = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+  if ((EPRing == NULL) || (*NumStreams == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    EPType = (UINT8)((DEVICE_CONTEXT *)OutputContext)->EP[Dci-1].EPType;
+  } else {
+    EPType = (UINT8)((DEVICE_CONTEXT_64 *)OutputContext)->EP[Dci-1].EPType;
+  }
+
+  if ((EPType != ED_BULK_OUT) && (EPType != ED_BULK_IN)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished && (Urb->Ring == EPRing)) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  //
+  // The Primary Stream Array has a power of 2 entries, from 4 to 2^(MaxPSASize + 1),
+  // and entry 0 is reserved.
+  //
+  MaxArraySize = MIN (XHC_MAX_STREAMS, (UINTN)1 << (Xhc->HcCParams.Data.MaxPsaSize + 1));
+  ArraySize    = 4;
+  MaxPStreams  = 1;
+  while ((ArraySize < (UINTN)*NumStreams + 1) && (ArraySize < MaxArraySize)) {
+    ArraySize <<= 1;
+    MaxPStreams++;
+  }
+
+  Streams = AllocateZeroPool (sizeof (XHC_ENDPOINT_STREAMS));
+  if (Streams == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Streams->NumStreams     = (UINT16)ArraySize;
+  Streams->StreamContexts = UsbHcAllocateMem (Xhc->MemPool, sizeof (STREAM_CONTEXT) * ArraySize, TRUE);
+  if (Streams->StreamContexts == NULL) {
+    FreePool (Streams);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Streams->StreamContexts, sizeof (STREAM_CONTEXT) * ArraySize);
+
+  for (Index = 1; Index < ArraySize; Index++) {
+    CreateTransferRing (Xhc, STREAM_RING_TRB_NUMBER, &Streams->Rings[Index]);
+    PhyAddr = UsbHcGetPciAddrForHostAddr (
+                Xhc->MemPool,
+                Streams->Rings[Index].RingSeg0,
+                sizeof (TRB_TEMPLATE) * STREAM_RING_TRB_NUMBER,
+                TRUE
+                );
+    Streams->StreamContexts[Index].PtrLo = XHC_LOW_32BIT (PhyAddr) | (STREAM_CONTEXT_SCT_PRIMARY_RING << 1) | Streams->Rings[Index].RingPCS;
+    Streams->StreamContexts[Index].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+  }
+
+  PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Streams->StreamContexts, sizeof (STREAM_CONTEXT) * ArraySize, TRUE);
+  Status  = XhcConfigureStreamEndpoint (Xhc, SlotId, Dci, MaxPStreams, PhyAddr);
+  if (EFI_ERROR (Status)) {
+    XhcFreeStreamRings (Xhc, Streams);
+    return Status;
+  }
+
+  Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = Streams;
+  *NumStreams                                         = (UINT16)(ArraySize - 1);
+
+  DEBUG ((DEBUG_INFO, "XhcAllocateStreams: Slot = 0x%x, Dci = 0x%x, %d streams\n", SlotId, Dci, *NumStreams));
+  return EFI_SUCCESS;
+}
+
+/**
+  Make an endpoint using streams use its single transfer ring again, and
+  free its streams.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  Dci                   The device context index of the endpoint.
+  @param  Reconfigure           TRUE to reconfigure the endpoint, FALSE if the endpoint
+                                or the slot is being disabled.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint doesn't use streams.
+  @retval EFI_NOT_READY         Transfers are queued on the streams.
+  @retval Others                Failed to reconfigure the endpoint.
+
+**/
+EFI_STATUS
+XhcFreeStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN BOOLEAN            Reconfigure
+  )
+{
+  EFI_STATUS            Status;
+  XHC_ENDPOINT_STREAMS  *Streams;
+  TRANSFER_RING         *EPRing;
+  LIST_ENTRY            *Entry;
+  URB                   *Urb;
+  EFI_PHYSICAL_ADDRESS  PhyAddr;
+
+  Streams = (XHC_ENDPOINT_STREAMS *)Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1];
+  if (Streams == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // When the endpoint or the slot is disabled, its transfers are aborted
+  // by the caller.
+  //
+  if (Reconfigure) {
+    BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+      Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+      if (!Urb->Finished && (Urb->Ring >= &Streams->Rings[1]) && (Urb->Ring < &Streams->Rings[Streams->NumStreams])) {
+        return EFI_NOT_READY;
+      }
+    }
+  }
+
+  Status = EFI_SUCCESS;
+  EPRing = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+  if (Reconfigure && (EPRing != NULL)) {
+    PhyAddr = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, EPRing->RingEnqueue, sizeof (TRB_TEMPLATE), FALSE);
+    Status  = XhcConfigureStreamEndpoint (Xhc, SlotId, Dci, 0, PhyAddr | EPRing->RingPCS);
+  }
+
+  //
+  // The streams are freed even if the endpoint failed to be reconfigured, the
+  // device is unusable then.
+  //
+  Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = NULL;
+  XhcFreeStreamRings (Xhc, Streams);
+
+  return Status;
+}
+
 /**
   Set interface through XHCI's Configure_Endpoint cmd.
 
@@ -3715,6 +4829,8 @@ XhcSetInterface (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcAbortAsyncBulkTransfers (Xhc, SlotId, Dci, EFI_USB_ERR_NOTEXECUTE);
+      XhcFreeStreams (Xhc, SlotId, Dci, FALSE);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
@@ -3922,6 +5038,8 @@ XhcSetInterface64 (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcAbortAsyncBulkTransfers (Xhc, SlotId, Dci, EFI_USB_ERR_NOTEXECUTE);
+      XhcFreeStreams (Xhc, SlotId, Dci, FALSE);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
@@ -13,6 +13,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define XHC_URB_SIG                   SIGNATURE_32 ('U', 'S', 'B', 'R')
 #define XHC_INIT_DEVICE_SLOT_RETRIES  1
 
+//
+// The largest Primary Stream Array allocated for an endpoint. Stream ID 0 is
+// reserved, so an endpoint has at most XHC_MAX_STREAMS - 1 usable streams.
+//
+#define XHC_MAX_STREAMS  32
+
 //
 // Transfer types, used in URB to identify the transfer type
 //
@@ -21,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define XHC_INT_TRANSFER_SYNC        0x04
 #define XHC_INT_TRANSFER_ASYNC       0x08
 #define XHC_INT_ONLY_TRANSFER_ASYNC  0x10
+#define XHC_BULK_TRANSFER_ASYNC      0x20
 
 //
 // 6.4.6 TRB Types
@@ -192,6 +199,7 @@ typedef struct _URB {
   // Command/Tranfer Ring info
   //
   TRANSFER_RING                      *Ring;
+  UINT16                             StreamId;
   TRB_TEMPLATE                       *TrbStart;
   TRB_TEMPLATE                       *TrbEnd;
   UINTN                              TrbNum;
@@ -700,6 +708,33 @@ typedef struct _ENDPOINT_CONTEXT_64 {
   UINT32    RsvdZ15;
 } ENDPOINT_CONTEXT_64;
 
+//
+// 6.2.4 Stream Context
+// PtrLo holds the Dequeue Cycle State in bit 0 and the Stream Context Type in bits 3:1.
+//
+#define STREAM_CONTEXT_SCT_PRIMARY_RING  1
+
+typedef struct _STREAM_CONTEXT {
+  UINT32    PtrLo;
+
+  UINT32    PtrHi;
+
+  UINT32    StoppedEDTLA : 24;
+  UINT32    RsvdZ1       : 8;
+
+  UINT32    RsvdZ2;
+} STREAM_CONTEXT;
+
+//
+// The streams of an endpoint: a Primary Stream Array with one Transfer Ring
+// per stream, indexed by Stream ID. Entry 0 is reserved.
+//
+typedef struct _XHC_ENDPOINT_STREAMS {
+  UINT16            NumStreams;
+  STREAM_CONTEXT    *StreamContexts;
+  TRANSFER_RING     Rings[XHC_MAX_STREAMS];
+} XHC_ENDPOINT_STREAMS;
+
 //
 // 6.2.5.1 Input Control Context
 //
@@ -798,6 +833,22 @@ RingIntTransferDoorBell (
   IN  URB                *Urb
   );
 
+/**
+  Check the URB's execution result and update the URB's
+  result accordingly.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB to check result.
+
+  @return Whether the result of URB transfer is finialized.
+
+**/
+BOOLEAN
+XhcCheckUrbResult (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb
+  );
+
 /**
   Execute the transfer by polling the URB. This is a synchronous operation.
 
@@ -877,6 +928,118 @@ XhciInsertAsyncIntTransfer (
   IN VOID                             *Context
   );
 
+/**
+  Insert an asynchronous bulk transfer behind the ones already queued on
+  the endpoint, or on the stream of the endpoint, and build its TD on the
+  transfer ring.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param StreamId       The stream of the endpoint, 0 if the endpoint doesn't use streams
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param Data           The data buffer of the transfer
+  @param DataLen        The length of data buffer
+  @param Callback       The function to call when the transfer is done
+  @param Context        The context to the callback
+  @param Urb            The created URB
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_NOT_READY          The transfer ring of the endpoint is full.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a configured bulk endpoint,
+                                 the stream doesn't exist, or the TD doesn't
+                                 fit in the transfer ring.
+  @retval EFI_OUT_OF_RESOURCES   Failed to create the URB.
+  @retval EFI_DEVICE_ERROR       The device isn't enabled.
+
+**/
+EFI_STATUS
+XhciInsertAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE                *Xhc,
+  IN  UINT8                            BusAddr,
+  IN  UINT8                            EpAddr,
+  IN  UINT16                           StreamId,
+  IN  UINT8                            DevSpeed,
+  IN  UINTN                            MaxPacket,
+  IN  VOID                             *Data,
+  IN  UINTN                            DataLen,
+  IN  EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN  VOID                             *Context,
+  OUT URB                              **Urb
+  );
+
+/**
+  Cancel the asynchronous bulk transfers of an endpoint, or of one stream
+  of an endpoint, and call their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+  @param  StreamId              The stream whose transfers are cancelled, or 0 for all
+                                the transfers of the endpoint.
+  @param  OldTpl                The TPL to call the callbacks at.
+
+  @retval EFI_SUCCESS           The transfers are cancelled.
+  @retval EFI_DEVICE_ERROR      Failed to stop the endpoint.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfer (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum,
+  IN  UINT16             StreamId,
+  IN  EFI_TPL            OldTpl
+  );
+
+/**
+  Remove all the asynchronous bulk transfers without calling their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  );
+
+/**
+  Finish the asynchronous bulk transfers not yet done by the controller,
+  without touching the transfer rings. They are reported with Result on
+  the next XhcProcessAsyncBulkTransfers().
+
+  This is used before the transfer rings are freed or reinitialized.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot whose transfers are finished, or 0 for all the slots.
+  @param  Dci                   The endpoint whose transfers are finished, or 0 for all the
+                                endpoints of the slot.
+  @param  Result                The result of the finished transfers.
+
+**/
+VOID
+XhcAbortAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT32             Result
+  );
+
+/**
+  Update the asynchronous bulk transfers from the event ring, recover the
+  endpoints they halted, and call the callbacks of the finished ones.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  OldTpl                The TPL to call the callbacks at.
+
+**/
+VOID
+XhcProcessAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN EFI_TPL            OldTpl
+  );
+
 /**
   Set Bios Ownership
 
@@ -948,6 +1111,26 @@ XhcRingDoorBell (
   IN UINT8              Dci
   );
 
+/**
+  Ring the door bell of one stream of an endpoint. Stream 0 rings the
+  endpoint without streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream of the endpoint.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
 /**
   Interrupt transfer periodic check handler.
 
@@ -1419,12 +1602,67 @@ XhcSetTrDequeuePointer (
   IN URB                *Urb
   );
 
+/**
+  Make a bulk endpoint use streams. A Primary Stream Array is allocated
+  with a transfer ring per stream, and the endpoint is reconfigured to use
+  it. The transfers of the endpoint then select a stream by its ID.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  Dci                   The device context index of the endpoint.
+  @param  NumStreams            On input, the number of streams wanted. On output,
+                                the number of streams allocated, with IDs 1 to
+                                NumStreams. It may be lower or higher than wanted.
+
+  @retval EFI_SUCCESS           The endpoint uses streams.
+  @retval EFI_UNSUPPORTED       The controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER The endpoint isn't a configured bulk endpoint, or
+                                NumStreams is 0.
+  @retval EFI_ALREADY_STARTED   The endpoint already uses streams.
+  @retval EFI_NOT_READY         Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the streams.
+  @retval Others                Failed to reconfigure the endpoint.
+
+**/
+EFI_STATUS
+XhcAllocateStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              Dci,
+  IN OUT UINT16             *NumStreams
+  );
+
+/**
+  Make an endpoint using streams use its single transfer ring again, and
+  free its streams.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  Dci                   The device context index of the endpoint.
+  @param  Reconfigure           TRUE to reconfigure the endpoint, FALSE if the endpoint
+                                or the slot is being disabled.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint doesn't use streams.
+  @retval EFI_NOT_READY         Transfers are queued on the streams.
+  @retval Others                Failed to reconfigure the endpoint.
+
+**/
+EFI_STATUS
+XhcFreeStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN BOOLEAN            Reconfigure
+  );
+
 /**
   Create a new URB for a new transaction.
 
   @param  Xhc       The XHCI Instance
   @param  DevAddr   The device address
   @param  EpAddr    Endpoint addrress
+  @param  StreamId  The stream of the endpoint, 0 if the endpoint doesn't use streams
   @param  DevSpeed  The device speed
   @param  MaxPacket The max packet length of the endpoint
   @param  Type      The transaction type
@@ -1442,6 +1680,7 @@ XhcCreateUrb (
   IN USB_XHCI_INSTANCE                *Xhc,
   IN UINT8                            DevAddr,
   IN UINT8                            EpAddr,
+  IN UINT16                           StreamId,
   IN UINT8                            DevSpeed,
   IN UINTN                            MaxPacket,
   IN UINTN                            Type,
@@ -1465,6 +1704,43 @@ XhcFreeUrb (
   IN URB                *Urb
   );
 
+/**
+  Calculate the TD Size field of a Normal TRB, according to XHCI spec 4.11.2.4.
+
+  @param  Xhc         The XHCI Instance
+  @param  Remaining   The number of bytes of the TD after this TRB.
+  @param  MaxPacket   The max packet size of the endpoint.
+
+  @return The TD Size field value.
+
+**/
+UINT32
+XhcCalculateTdSize (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINTN              Remaining,
+  IN UINTN              MaxPacket
+  );
+
+/**
+  Get the transfer ring of an endpoint, or of one stream of an endpoint
+  using streams.
+
+  @param  Xhc       The XHCI Instance.
+  @param  SlotId    The slot id of the device.
+  @param  Dci       The device context index of the endpoint.
+  @param  StreamId  The stream of the endpoint, 0 if the endpoint doesn't use streams.
+
+  @return The transfer ring, or NULL if the endpoint or the stream doesn't exist.
+
+**/
+TRANSFER_RING *
+XhcGetTransferRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
 /**
   Create a transfer TRB.
 
@@ -26,6 +26,14 @@ EFI_USB_IO_PROTOCOL  mUsbIoProtocol = {
   UsbIoPortReset
 };
 
+EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol = {
+  UsbIoAsyncBulkSubmit,
+  UsbIoAsyncBulkCancel,
+  UsbIoAsyncBulkPoll,
+  UsbIoAsyncBulkAllocateStreams,
+  UsbIoAsyncBulkFreeStreams
+};
+
 EFI_DRIVER_BINDING_PROTOCOL  mUsbBusDriverBinding = {
   UsbBusControllerDriverSupported,
   UsbBusControllerDriverStart,
@@ -924,6 +932,243 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Queue a bulk transfer on a bulk endpoint of the interface. The host
+  controller completes queued transfers in order from its event ring
+  and reports each of them through Callback.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream of the endpoint, 0 if it has no streams.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Callback               Function to call when the transfer is done.
+  @param  Context                The context to the callback.
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to queue the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSubmit (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN UINT16                            StreamId,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   Callback,
+  IN VOID                              *Context OPTIONAL
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15) ||
+      (Callback == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_USBIO_ASYNC_BULK (This);
+  Dev   = UsbIf->Device;
+
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  //
+  // Only host controllers that track the data toggle themselves produce
+  // the async bulk protocol, so EpDesc->Toggle isn't touched here.
+  //
+  Status = UsbHcAsyncBulkSubmit (
+             Dev->Bus,
+             Dev->Address,
+             Endpoint,
+             StreamId,
+             Dev->Speed,
+             EpDesc->Desc.MaxPacketSize,
+             Data,
+             DataLength,
+             &Dev->Translator,
+             Callback,
+             Context
+             );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Cancel the bulk transfers queued on a bulk endpoint of the interface, or
+  on one stream of the endpoint. The callbacks of the cancelled transfers
+  are called before return.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream to cancel, 0 for the whole endpoint.
+
+  @retval EFI_SUCCESS            The transfers are cancelled.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to cancel the transfers.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkCancel (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN UINT16                            StreamId
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_USBIO_ASYNC_BULK (This);
+  Dev    = UsbIf->Device;
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  gBS->RestoreTPL (OldTpl);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Call the host controller at the caller's TPL so that the callbacks
+  // of the cancelled transfers run there too.
+  //
+  return UsbHcAsyncBulkCancel (Dev->Bus, Dev->Address, Endpoint, StreamId);
+}
+
+/**
+  Process the completed bulk transfers and call their callbacks.
+
+  @param  This                   The USB IO async bulk instance.
+
+  @retval EFI_SUCCESS            The completed transfers are processed.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkPoll (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This
+  )
+{
+  USB_INTERFACE  *UsbIf;
+
+  UsbIf = USB_INTERFACE_FROM_USBIO_ASYNC_BULK (This);
+
+  return UsbHcAsyncBulkPoll (UsbIf->Device->Bus);
+}
+
+/**
+  Give streams to a bulk endpoint of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  NumberOfStreams        On input, the number of streams wanted. On output,
+                                 the number of streams given.
+
+  @retval EFI_SUCCESS            The endpoint has streams.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to give streams to the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkAllocateStreams (
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             Endpoint,
+  IN OUT UINT16                            *NumberOfStreams
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15) ||
+      (NumberOfStreams == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_USBIO_ASYNC_BULK (This);
+  Dev    = UsbIf->Device;
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  gBS->RestoreTPL (OldTpl);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return UsbHcAsyncBulkAllocateStreams (Dev->Bus, Dev->Address, Endpoint, NumberOfStreams);
+}
+
+/**
+  Free the streams of a bulk endpoint of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+
+  @retval EFI_SUCCESS            The streams are freed.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to free the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkFreeStreams (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_USBIO_ASYNC_BULK (This);
+  Dev    = UsbIf->Device;
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  gBS->RestoreTPL (OldTpl);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return UsbHcAsyncBulkFreeStreams (Dev->Bus, Dev->Address, Endpoint);
+}
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -1010,6 +1255,22 @@ UsbBusBuildProtocol (
     }
   }
 
+  //
+  // The async bulk extension is optional and installed by the host
+  // controller driver alongside USB2_HC, so it is only looked up.
+  //
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiUsb2HcAsyncBulkProtocolGuid,
+                  (VOID **)&(UsbBus->Usb2HcAsyncBulk),
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    UsbBus->Usb2HcAsyncBulk = NULL;
+  }
+
   //
   // Install an EFI_USB_BUS_PROTOCOL to host controller to identify it.
   //
@@ -13,7 +13,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/Usb2HcAsyncBulk.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 #include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
@@ -140,6 +142,9 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_INTERFACE_FROM_USBIO(a) \
           CR(a, USB_INTERFACE, UsbIo, USB_INTERFACE_SIGNATURE)
 
+#define USB_INTERFACE_FROM_USBIO_ASYNC_BULK(a) \
+          CR(a, USB_INTERFACE, UsbIoAsyncBulk, USB_INTERFACE_SIGNATURE)
+
 #define USB_BUS_FROM_THIS(a) \
           CR(a, USB_BUS, BusId, USB_BUS_SIGNATURE)
 
@@ -202,10 +207,11 @@ struct _USB_INTERFACE {
   //
   // Handles and protocols
   //
-  EFI_HANDLE                  Handle;
-  EFI_USB_IO_PROTOCOL         UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  BOOLEAN                     IsManaged;
+  EFI_HANDLE                          Handle;
+  EFI_USB_IO_PROTOCOL                 UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    UsbIoAsyncBulk; ///< Installed if the bus has Usb2HcAsyncBulk.
+  EFI_DEVICE_PATH_PROTOCOL            *DevicePath;
+  BOOLEAN                             IsManaged;
 
   //
   // Hub device special data
@@ -239,9 +245,10 @@ struct _USB_BUS {
   //
   // Managed USB host controller
   //
-  EFI_HANDLE                  HostHandle;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_USB2_HC_PROTOCOL        *Usb2Hc;
+  EFI_HANDLE                           HostHandle;
+  EFI_DEVICE_PATH_PROTOCOL             *DevicePath;
+  EFI_USB2_HC_PROTOCOL                 *Usb2Hc;
+  EDKII_USB2_HC_ASYNC_BULK_PROTOCOL    *Usb2HcAsyncBulk; ///< Optional, NULL if not produced.
 
   //
   // Recorded the max supported usb devices.
@@ -650,6 +657,108 @@ UsbIoPortReset (
   IN EFI_USB_IO_PROTOCOL  *This
   );
 
+/**
+  Queue a bulk transfer on a bulk endpoint of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream of the endpoint, 0 if it has no streams.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Callback               Function to call when the transfer is done.
+  @param  Context                The context to the callback.
+
+  @retval EFI_SUCCESS            The transfer is queued.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to queue the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSubmit (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN UINT16                            StreamId,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   Callback,
+  IN VOID                              *Context OPTIONAL
+  );
+
+/**
+  Cancel the bulk transfers queued on a bulk endpoint of the interface, or
+  on one stream of the endpoint.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream to cancel, 0 for the whole endpoint.
+
+  @retval EFI_SUCCESS            The transfers are cancelled.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to cancel the transfers.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkCancel (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint,
+  IN UINT16                            StreamId
+  );
+
+/**
+  Process the completed bulk transfers and call their callbacks.
+
+  @param  This                   The USB IO async bulk instance.
+
+  @retval EFI_SUCCESS            The completed transfers are processed.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkPoll (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This
+  );
+
+/**
+  Give streams to a bulk endpoint of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  NumberOfStreams        On input, the number of streams wanted. On output,
+                                 the number of streams given.
+
+  @retval EFI_SUCCESS            The endpoint has streams.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to give streams to the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkAllocateStreams (
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             Endpoint,
+  IN OUT UINT16                            *NumberOfStreams
+  );
+
+/**
+  Free the streams of a bulk endpoint of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+
+  @retval EFI_SUCCESS            The streams are freed.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to free the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkFreeStreams (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             Endpoint
+  );
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -749,9 +858,10 @@ UsbBusControllerDriverStop (
   IN EFI_HANDLE                   *ChildHandleBuffer
   );
 
-extern EFI_USB_IO_PROTOCOL           mUsbIoProtocol;
-extern EFI_DRIVER_BINDING_PROTOCOL   mUsbBusDriverBinding;
-extern EFI_COMPONENT_NAME_PROTOCOL   mUsbBusComponentName;
-extern EFI_COMPONENT_NAME2_PROTOCOL  mUsbBusComponentName2;
+extern EFI_USB_IO_PROTOCOL               mUsbIoProtocol;
+extern EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol;
+extern EFI_DRIVER_BINDING_PROTOCOL       mUsbBusDriverBinding;
+extern EFI_COMPONENT_NAME_PROTOCOL       mUsbBusComponentName;
+extern EFI_COMPONENT_NAME2_PROTOCOL      mUsbBusComponentName2;
 
 #endif
@@ -55,9 +55,23 @@ UsbFreeInterface (
   )
 {
   EFI_STATUS  Status;
+  BOOLEAN     AsyncBulk;
 
   UsbCloseHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
 
+  //
+  // The async bulk extension is only present if it was installed, see
+  // UsbCreateInterface. Put it back if the USB IO can't be removed.
+  //
+  AsyncBulk = (BOOLEAN)(UsbIf->UsbIoAsyncBulk.Submit != NULL);
+  if (AsyncBulk) {
+    gBS->UninstallProtocolInterface (
+           UsbIf->Handle,
+           &gEdkiiUsbIoAsyncBulkProtocolGuid,
+           &UsbIf->UsbIoAsyncBulk
+           );
+  }
+
   Status = gBS->UninstallMultipleProtocolInterfaces (
                   UsbIf->Handle,
                   &gEfiDevicePathProtocolGuid,
@@ -73,6 +87,15 @@ UsbFreeInterface (
 
     FreePool (UsbIf);
   } else {
+    if (AsyncBulk) {
+      gBS->InstallProtocolInterface (
+             &UsbIf->Handle,
+             &gEdkiiUsbIoAsyncBulkProtocolGuid,
+             EFI_NATIVE_INTERFACE,
+             &UsbIf->UsbIoAsyncBulk
+             );
+    }
+
     UsbOpenHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
   }
 
@@ -173,6 +196,29 @@ UsbCreateInterface (
     goto ON_ERROR;
   }
 
+  //
+  // Let class drivers queue bulk transfers if the host controller can.
+  // The interface works without it, so a failure here isn't fatal.
+  //
+  if (Device->Bus->Usb2HcAsyncBulk != NULL) {
+    CopyMem (
+      &UsbIf->UsbIoAsyncBulk,
+      &mUsbIoAsyncBulkProtocol,
+      sizeof (EDKII_USB_IO_ASYNC_BULK_PROTOCOL)
+      );
+
+    Status = gBS->InstallProtocolInterface (
+                    &UsbIf->Handle,
+                    &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &UsbIf->UsbIoAsyncBulk
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "UsbCreateInterface: failed to install UsbIoAsyncBulk - %r\n", Status));
+      ZeroMem (&UsbIf->UsbIoAsyncBulk, sizeof (EDKII_USB_IO_ASYNC_BULK_PROTOCOL));
+    }
+  }
+
   return UsbIf;
 
 ON_ERROR:
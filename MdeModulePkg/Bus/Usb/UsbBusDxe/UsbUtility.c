@@ -317,6 +317,169 @@ UsbHcAsyncInterruptTransfer (
   return Status;
 }
 
+/**
+  Queue an asynchronous bulk transfer.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+  @param  StreamId         The stream of the endpoint, 0 if it has no streams.
+  @param  DevSpeed         The device's speed.
+  @param  MaxPacket        The endpoint's max packet size.
+  @param  Data             The data buffer.
+  @param  DataLength       The length of data buffer.
+  @param  Translator       The transaction translator for low/full speed device.
+  @param  Callback         Function to call when the transfer is done.
+  @param  Context          The context to the callback.
+
+  @retval EFI_SUCCESS      The asynchronous transfer is queued.
+  @retval EFI_UNSUPPORTED  The host controller doesn't queue bulk transfers.
+  @retval Others           Failed to queue the transfer.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkSubmit (
+  IN  USB_BUS                             *UsbBus,
+  IN  UINT8                               DevAddr,
+  IN  UINT8                               EpAddr,
+  IN  UINT16                              StreamId,
+  IN  UINT8                               DevSpeed,
+  IN  UINTN                               MaxPacket,
+  IN  VOID                                *Data,
+  IN  UINTN                               DataLength,
+  IN  EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator,
+  IN  EFI_ASYNC_USB_TRANSFER_CALLBACK     Callback,
+  IN  VOID                                *Context OPTIONAL
+  )
+{
+  if (UsbBus->Usb2HcAsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->Usb2HcAsyncBulk->Submit (
+                                    UsbBus->Usb2HcAsyncBulk,
+                                    DevAddr,
+                                    EpAddr,
+                                    StreamId,
+                                    DevSpeed,
+                                    MaxPacket,
+                                    Data,
+                                    DataLength,
+                                    Translator,
+                                    Callback,
+                                    Context
+                                    );
+}
+
+/**
+  Cancel the asynchronous bulk transfers of an endpoint, or of one stream of
+  an endpoint.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+  @param  StreamId         The stream to cancel, 0 for the whole endpoint.
+
+  @retval EFI_SUCCESS      The asynchronous transfers are cancelled.
+  @retval EFI_UNSUPPORTED  The host controller doesn't queue bulk transfers.
+  @retval Others           Failed to cancel the transfers.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkCancel (
+  IN  USB_BUS  *UsbBus,
+  IN  UINT8    DevAddr,
+  IN  UINT8    EpAddr,
+  IN  UINT16   StreamId
+  )
+{
+  if (UsbBus->Usb2HcAsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->Usb2HcAsyncBulk->Cancel (UsbBus->Usb2HcAsyncBulk, DevAddr, EpAddr, StreamId);
+}
+
+/**
+  Process the completed asynchronous bulk transfers.
+
+  @param  UsbBus           The USB bus driver.
+
+  @retval EFI_SUCCESS      The completed transfers are processed.
+  @retval EFI_UNSUPPORTED  The host controller doesn't queue bulk transfers.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkPoll (
+  IN  USB_BUS  *UsbBus
+  )
+{
+  if (UsbBus->Usb2HcAsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->Usb2HcAsyncBulk->Poll (UsbBus->Usb2HcAsyncBulk);
+}
+
+/**
+  Give streams to a bulk endpoint.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+  @param  NumStreams       On input, the number of streams wanted. On output, the
+                           number of streams given.
+
+  @retval EFI_SUCCESS      The endpoint has streams.
+  @retval EFI_UNSUPPORTED  The host controller doesn't queue bulk transfers.
+  @retval Others           Failed to give streams to the endpoint.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkAllocateStreams (
+  IN     USB_BUS  *UsbBus,
+  IN     UINT8    DevAddr,
+  IN     UINT8    EpAddr,
+  IN OUT UINT16   *NumStreams
+  )
+{
+  if (UsbBus->Usb2HcAsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->Usb2HcAsyncBulk->AllocateStreams (UsbBus->Usb2HcAsyncBulk, DevAddr, EpAddr, NumStreams);
+}
+
+/**
+  Free the streams of a bulk endpoint.
+
+  @param  UsbBus           The USB bus driver.
+  @param  DevAddr          The target device address.
+  @param  EpAddr           The target endpoint address, with direction encoded in
+                           bit 7.
+
+  @retval EFI_SUCCESS      The streams are freed.
+  @retval EFI_UNSUPPORTED  The host controller doesn't queue bulk transfers.
+  @retval Others           Failed to free the streams.
+
+**/
+EFI_STATUS
+UsbHcAsyncBulkFreeStreams (
+  IN  USB_BUS  *UsbBus,
+  IN  UINT8    DevAddr,
+  IN  UINT8    EpAddr
+  )
+{
+  if (UsbBus->Usb2HcAsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return UsbBus->Usb2HcAsyncBulk->FreeStreams (UsbBus->Usb2HcAsyncBulk, DevAddr, EpAddr);
+}
+
 /**
   Execute a synchronous interrupt transfer to the target endpoint.
 
@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <IndustryStandard/Scsi.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/DiskInfo.h>
 #include <Library/BaseLib.h>
@@ -28,8 +29,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct _USB_MASS_TRANSPORT  USB_MASS_TRANSPORT;
 typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
 
+///
+/// A command of the batch passed to USB_MASS_EXEC_COMMANDS.
+///
+typedef struct {
+  VOID                      *Cmd;
+  UINT8                     CmdLen;
+  EFI_USB_DATA_DIRECTION    DataDir;
+  VOID                      *Data;
+  UINT32                    DataLen;
+  UINT32                    CmdStatus;  ///< The result of the command execution
+} USB_MASS_COMMAND;
+
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
+#include "UsbMassUas.h"
 #include "UsbMassBoot.h"
 #include "UsbMassDiskInfo.h"
 #include "UsbMassImpl.h"
@@ -54,6 +68,7 @@ typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
   It will save its context in the Context if Context isn't NULL.
 
   @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
   @param  Context               The buffer to save the context to
 
   @retval EFI_SUCCESS           The device is successfully initialized.
@@ -65,6 +80,7 @@ typedef
 EFI_STATUS
 (*USB_MASS_INIT_TRANSPORT) (
   IN  EFI_USB_IO_PROTOCOL  *Usb,
+  IN  EFI_HANDLE           Controller,
   OUT VOID                 **Context    OPTIONAL
   );
 
@@ -99,6 +115,34 @@ EFI_STATUS
   OUT UINT32                  *CmdStatus
   );
 
+/**
+  Execute several USB mass storage commands through the transport protocol.
+
+  The transport may have all the commands outstanding on the device at
+  the same time, so the commands must not depend on each other.
+
+  @param  Context               The USB Transport Protocol.
+  @param  Commands              The commands to execute. CmdStatus of each
+                                command returns its result, USB_MASS_CMD_FAIL
+                                if the command isn't completed.
+  @param  Count                 The number of commands
+  @param  Lun                   Should be 0, this field for bot only
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are executed.
+  @retval Other                 Failed to execute some of the commands.
+
+**/
+typedef
+EFI_STATUS
+(*USB_MASS_EXEC_COMMANDS) (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  );
+
 /**
   Reset the USB mass storage device by Transport protocol.
 
@@ -159,11 +203,12 @@ EFI_STATUS
 ///
 struct _USB_MASS_TRANSPORT {
   UINT8                      Protocol;
-  USB_MASS_INIT_TRANSPORT    Init;        ///< Initialize the mass storage transport protocol
-  USB_MASS_EXEC_COMMAND      ExecCommand; ///< Transport command to the device then get result
-  USB_MASS_RESET             Reset;       ///< Reset the device
-  USB_MASS_GET_MAX_LUN       GetMaxLun;   ///< Get max lun, only for bot
-  USB_MASS_CLEAN_UP          CleanUp;     ///< Clean up the resources.
+  USB_MASS_INIT_TRANSPORT    Init;         ///< Initialize the mass storage transport protocol
+  USB_MASS_EXEC_COMMAND      ExecCommand;  ///< Transport command to the device then get result
+  USB_MASS_RESET             Reset;        ///< Reset the device
+  USB_MASS_GET_MAX_LUN       GetMaxLun;    ///< Get max lun, only for bot
+  USB_MASS_CLEAN_UP          CleanUp;      ///< Clean up the resources.
+  USB_MASS_EXEC_COMMANDS     ExecCommands; ///< Queue several commands together, NULL if not supported
 };
 
 struct _USB_MASS_DEVICE {
@@ -309,6 +309,70 @@ EXIT:
   return Status;
 }
 
+/**
+  Execute several USB mass storage bootability commands with retrial.
+
+  If the transport can queue commands, they are executed together first.
+  Each command that doesn't succeed that way, or all of them if the
+  transport can't queue commands, is then executed by
+  UsbBootExecCmdWithRetry, which retrieves the error and retries.
+
+  @param  UsbMass                The device to issue commands to
+  @param  Commands               The commands to execute, which must not
+                                 depend on each other
+  @param  Count                  The number of commands
+  @param  Timeout                The timeout used to transfer each command
+
+  @retval EFI_SUCCESS            All the commands are executed successfully.
+  @retval Others                 Some command execution failed after retrial.
+
+**/
+EFI_STATUS
+UsbBootExecCmdsWithRetry (
+  IN USB_MASS_DEVICE   *UsbMass,
+  IN USB_MASS_COMMAND  *Commands,
+  IN UINTN             Count,
+  IN UINT32            Timeout
+  )
+{
+  USB_MASS_TRANSPORT  *Transport;
+  EFI_STATUS          Status;
+  UINTN               Index;
+
+  Transport = UsbMass->Transport;
+  if ((Transport->ExecCommands != NULL) && (Count > 1)) {
+    Status = Transport->ExecCommands (UsbMass->Context, Commands, Count, UsbMass->Lun, Timeout);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbBootExecCmdsWithRetry: %r to Exec %d Cmds\n", Status, Count));
+    }
+  } else {
+    for (Index = 0; Index < Count; Index++) {
+      Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    if (Commands[Index].CmdStatus == USB_MASS_CMD_SUCCESS) {
+      continue;
+    }
+
+    Status = UsbBootExecCmdWithRetry (
+               UsbMass,
+               Commands[Index].Cmd,
+               Commands[Index].CmdLen,
+               Commands[Index].DataDir,
+               Commands[Index].Data,
+               Commands[Index].DataLen,
+               Timeout
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Execute TEST UNIT READY command to check if the device is ready.
 
@@ -815,8 +879,10 @@ UsbBootReadWriteBlocks (
   IN OUT UINT8         *Buffer
   )
 {
-  USB_BOOT_READ_WRITE_10_CMD  Cmd;
+  USB_BOOT_READ_WRITE_10_CMD  Cmd[USB_BOOT_MAX_QUEUED_CMDS];
+  USB_MASS_COMMAND            Commands[USB_BOOT_MAX_QUEUED_CMDS];
   EFI_STATUS                  Status;
+  UINTN                       CmdCount;
   UINT32                      Count;
   UINT32                      CountMax;
   UINT32                      BlockSize;
@@ -827,54 +893,56 @@ UsbBootReadWriteBlocks (
   CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
   Status    = EFI_SUCCESS;
 
+  //
+  // USB command's upper limit timeout is 5s. [USB2.0-9.2.6.1]
+  //
+  Timeout = (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT;
+
   while (TotalBlock > 0) {
     //
     // Split the total blocks into smaller pieces to ease the pressure
     // on the device. We must split the total block because the READ10
     // command only has 16 bit transfer length (in the unit of block).
+    // The pieces are issued USB_BOOT_MAX_QUEUED_CMDS at a time, so a
+    // transport that can queue commands keeps the device busy.
     //
-    Count    = (UINT32)MIN (TotalBlock, CountMax);
-    Count    = MIN (MAX_UINT16, Count);
-    ByteSize = Count * BlockSize;
-
-    //
-    // USB command's upper limit timeout is 5s. [USB2.0-9.2.6.1]
-    //
-    Timeout = (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT;
+    for (CmdCount = 0; (CmdCount < USB_BOOT_MAX_QUEUED_CMDS) && (TotalBlock > 0); CmdCount++) {
+      Count    = (UINT32)MIN (TotalBlock, CountMax);
+      Count    = MIN (MAX_UINT16, Count);
+      ByteSize = Count * BlockSize;
 
-    //
-    // Fill in the command then execute
-    //
-    ZeroMem (&Cmd, sizeof (USB_BOOT_READ_WRITE_10_CMD));
-
-    Cmd.OpCode = Write ? USB_BOOT_WRITE10_OPCODE : USB_BOOT_READ10_OPCODE;
-    Cmd.Lun    = (UINT8)(USB_BOOT_LUN (UsbMass->Lun));
-    WriteUnaligned32 ((UINT32 *)Cmd.Lba, SwapBytes32 (Lba));
-    WriteUnaligned16 ((UINT16 *)Cmd.TransferLen, SwapBytes16 ((UINT16)Count));
+      //
+      // Fill in the command
+      //
+      ZeroMem (&Cmd[CmdCount], sizeof (USB_BOOT_READ_WRITE_10_CMD));
+
+      Cmd[CmdCount].OpCode = Write ? USB_BOOT_WRITE10_OPCODE : USB_BOOT_READ10_OPCODE;
+      Cmd[CmdCount].Lun    = (UINT8)(USB_BOOT_LUN (UsbMass->Lun));
+      WriteUnaligned32 ((UINT32 *)Cmd[CmdCount].Lba, SwapBytes32 (Lba));
+      WriteUnaligned16 ((UINT16 *)Cmd[CmdCount].TransferLen, SwapBytes16 ((UINT16)Count));
+
+      Commands[CmdCount].Cmd     = &Cmd[CmdCount];
+      Commands[CmdCount].CmdLen  = (UINT8)sizeof (USB_BOOT_READ_WRITE_10_CMD);
+      Commands[CmdCount].DataDir = Write ? EfiUsbDataOut : EfiUsbDataIn;
+      Commands[CmdCount].Data    = Buffer;
+      Commands[CmdCount].DataLen = ByteSize;
+
+      DEBUG ((
+        DEBUG_BLKIO,
+        "UsbBoot%sBlocks: LBA (0x%lx), Blk (0x%x)\n",
+        Write ? L"Write" : L"Read",
+        Lba,
+        Count
+        ));
+      Lba        += Count;
+      Buffer     += ByteSize;
+      TotalBlock -= Count;
+    }
 
-    Status = UsbBootExecCmdWithRetry (
-               UsbMass,
-               &Cmd,
-               (UINT8)sizeof (USB_BOOT_READ_WRITE_10_CMD),
-               Write ? EfiUsbDataOut : EfiUsbDataIn,
-               Buffer,
-               ByteSize,
-               Timeout
-               );
+    Status = UsbBootExecCmdsWithRetry (UsbMass, Commands, CmdCount, Timeout);
     if (EFI_ERROR (Status)) {
       return Status;
     }
-
-    DEBUG ((
-      DEBUG_BLKIO,
-      "UsbBoot%sBlocks: LBA (0x%lx), Blk (0x%x)\n",
-      Write ? L"Write" : L"Read",
-      Lba,
-      Count
-      ));
-    Lba        += Count;
-    Buffer     += ByteSize;
-    TotalBlock -= Count;
   }
 
   return Status;
@@ -901,63 +969,66 @@ UsbBootReadWriteBlocks16 (
   IN OUT UINT8         *Buffer
   )
 {
-  UINT8       Cmd[16];
-  EFI_STATUS  Status;
-  UINT32      Count;
-  UINT32      CountMax;
-  UINT32      BlockSize;
-  UINT32      ByteSize;
-  UINT32      Timeout;
+  UINT8             Cmd[USB_BOOT_MAX_QUEUED_CMDS][16];
+  USB_MASS_COMMAND  Commands[USB_BOOT_MAX_QUEUED_CMDS];
+  EFI_STATUS        Status;
+  UINTN             CmdCount;
+  UINT32            Count;
+  UINT32            CountMax;
+  UINT32            BlockSize;
+  UINT32            ByteSize;
+  UINT32            Timeout;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
   CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
   Status    = EFI_SUCCESS;
 
-  while (TotalBlock > 0) {
-    //
-    // Split the total blocks into smaller pieces.
-    //
-    Count    = (UINT32)MIN (TotalBlock, CountMax);
-    ByteSize = Count * BlockSize;
-
-    //
-    // USB command's upper limit timeout is 5s. [USB2.0-9.2.6.1]
-    //
-    Timeout = (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT;
+  //
+  // USB command's upper limit timeout is 5s. [USB2.0-9.2.6.1]
+  //
+  Timeout = (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT;
 
+  while (TotalBlock > 0) {
     //
-    // Fill in the command then execute
+    // Split the total blocks into smaller pieces, and issue them
+    // USB_BOOT_MAX_QUEUED_CMDS at a time.
     //
-    ZeroMem (Cmd, sizeof (Cmd));
+    for (CmdCount = 0; (CmdCount < USB_BOOT_MAX_QUEUED_CMDS) && (TotalBlock > 0); CmdCount++) {
+      Count    = (UINT32)MIN (TotalBlock, CountMax);
+      ByteSize = Count * BlockSize;
 
-    Cmd[0] = Write ? EFI_SCSI_OP_WRITE16 : EFI_SCSI_OP_READ16;
-    Cmd[1] = (UINT8)((USB_BOOT_LUN (UsbMass->Lun) & 0xE0));
-    WriteUnaligned64 ((UINT64 *)&Cmd[2], SwapBytes64 (Lba));
-    WriteUnaligned32 ((UINT32 *)&Cmd[10], SwapBytes32 (Count));
+      //
+      // Fill in the command
+      //
+      ZeroMem (Cmd[CmdCount], sizeof (Cmd[CmdCount]));
+
+      Cmd[CmdCount][0] = Write ? EFI_SCSI_OP_WRITE16 : EFI_SCSI_OP_READ16;
+      Cmd[CmdCount][1] = (UINT8)((USB_BOOT_LUN (UsbMass->Lun) & 0xE0));
+      WriteUnaligned64 ((UINT64 *)&Cmd[CmdCount][2], SwapBytes64 (Lba));
+      WriteUnaligned32 ((UINT32 *)&Cmd[CmdCount][10], SwapBytes32 (Count));
+
+      Commands[CmdCount].Cmd     = Cmd[CmdCount];
+      Commands[CmdCount].CmdLen  = (UINT8)sizeof (Cmd[CmdCount]);
+      Commands[CmdCount].DataDir = Write ? EfiUsbDataOut : EfiUsbDataIn;
+      Commands[CmdCount].Data    = Buffer;
+      Commands[CmdCount].DataLen = ByteSize;
+
+      DEBUG ((
+        DEBUG_BLKIO,
+        "UsbBoot%sBlocks16: LBA (0x%lx), Blk (0x%x)\n",
+        Write ? L"Write" : L"Read",
+        Lba,
+        Count
+        ));
+      Lba        += Count;
+      Buffer     += ByteSize;
+      TotalBlock -= Count;
+    }
 
-    Status = UsbBootExecCmdWithRetry (
-               UsbMass,
-               Cmd,
-               (UINT8)sizeof (Cmd),
-               Write ? EfiUsbDataOut : EfiUsbDataIn,
-               Buffer,
-               ByteSize,
-               Timeout
-               );
+    Status = UsbBootExecCmdsWithRetry (UsbMass, Commands, CmdCount, Timeout);
     if (EFI_ERROR (Status)) {
       return Status;
     }
-
-    DEBUG ((
-      DEBUG_BLKIO,
-      "UsbBoot%sBlocks16: LBA (0x%lx), Blk (0x%x)\n",
-      Write ? L"Write" : L"Read",
-      Lba,
-      Count
-      ));
-    Lba        += Count;
-    Buffer     += ByteSize;
-    TotalBlock -= Count;
   }
 
   return Status;
@@ -63,6 +63,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
 
+//
+// Max number of carried pieces issued together to a transport that
+// can queue commands.
+//
+#define USB_BOOT_MAX_QUEUED_CMDS  8
+
 //
 // Retry mass command times, set by experience
 //
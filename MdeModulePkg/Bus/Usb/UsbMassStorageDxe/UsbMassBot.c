@@ -18,7 +18,8 @@ USB_MASS_TRANSPORT  mUsbBotTransport = {
   UsbBotExecCommand,
   UsbBotResetDevice,
   UsbBotGetMaxLun,
-  UsbBotCleanUp
+  UsbBotCleanUp,
+  NULL
 };
 
 /**
@@ -29,6 +30,7 @@ USB_MASS_TRANSPORT  mUsbBotTransport = {
   in the Context if Context isn't NULL.
 
   @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
   @param  Context               The buffer to save the context to
 
   @retval EFI_SUCCESS           The device is successfully initialized.
@@ -39,6 +41,7 @@ USB_MASS_TRANSPORT  mUsbBotTransport = {
 EFI_STATUS
 UsbBotInit (
   IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
   OUT VOID                 **Context OPTIONAL
   )
 {
@@ -112,6 +115,22 @@ UsbBotInit (
   UsbBot->CbwTag = 0x01;
 
   if (Context != NULL) {
+    //
+    // If the bus can queue bulk transfers, the CBW, data and CSW of a
+    // command are submitted together, see UsbBotExecCommandAsync.
+    //
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                    (VOID **)&UsbBot->UsbIoAsyncBulk,
+                    gImageHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      UsbBot->UsbIoAsyncBulk = NULL;
+    }
+
     *Context = UsbBot;
   } else {
     FreePool (UsbBot);
@@ -124,6 +143,42 @@ ON_ERROR:
   return Status;
 }
 
+/**
+  Fill in the Command Block Wrapper of a command.
+
+  @param  UsbBot                The USB BOT device
+  @param  Cmd                   The command to transfer to device
+  @param  CmdLen                The length of the command
+  @param  DataDir               The direction of the data
+  @param  TransLen              The expected length of the data
+  @param  Lun                   The number of logic unit
+  @param  Cbw                   The Command Block Wrapper to fill in
+
+**/
+VOID
+UsbBotBuildCbw (
+  IN  USB_BOT_PROTOCOL        *UsbBot,
+  IN  UINT8                   *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  UINT32                  TransLen,
+  IN  UINT8                   Lun,
+  OUT USB_BOT_CBW             *Cbw
+  )
+{
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_BOT_MAX_CMDLEN));
+
+  Cbw->Signature = USB_BOT_CBW_SIGNATURE;
+  Cbw->Tag       = UsbBot->CbwTag;
+  Cbw->DataLen   = TransLen;
+  Cbw->Flag      = (UINT8)((DataDir == EfiUsbDataIn) ? BIT7 : 0);
+  Cbw->Lun       = Lun;
+  Cbw->CmdLen    = CmdLen;
+
+  ZeroMem (Cbw->CmdBlock, USB_BOT_MAX_CMDLEN);
+  CopyMem (Cbw->CmdBlock, Cmd, CmdLen);
+}
+
 /**
   Send the command to the device using Bulk-Out endpoint.
 
@@ -159,20 +214,10 @@ UsbBotSendCommand (
   UINTN        DataLen;
   UINTN        Timeout;
 
-  ASSERT ((CmdLen > 0) && (CmdLen <= USB_BOT_MAX_CMDLEN));
-
   //
   // Fill in the Command Block Wrapper.
   //
-  Cbw.Signature = USB_BOT_CBW_SIGNATURE;
-  Cbw.Tag       = UsbBot->CbwTag;
-  Cbw.DataLen   = TransLen;
-  Cbw.Flag      = (UINT8)((DataDir == EfiUsbDataIn) ? BIT7 : 0);
-  Cbw.Lun       = Lun;
-  Cbw.CmdLen    = CmdLen;
-
-  ZeroMem (Cbw.CmdBlock, USB_BOT_MAX_CMDLEN);
-  CopyMem (Cbw.CmdBlock, Cmd, CmdLen);
+  UsbBotBuildCbw (UsbBot, Cmd, CmdLen, DataDir, TransLen, Lun, &Cbw);
 
   Result  = 0;
   DataLen = sizeof (USB_BOT_CBW);
@@ -370,6 +415,226 @@ UsbBotGetStatus (
   return Status;
 }
 
+/**
+  Record the result of a queued CBW, data or CSW transfer.
+
+  @param  Data                  The data buffer of the transfer.
+  @param  DataLength            The number of bytes transferred.
+  @param  Context               The USB_BOT_ASYNC_TRANSFER of the transfer.
+  @param  Result                The result of the transfer.
+
+  @retval EFI_SUCCESS           The result is recorded.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbBotAsyncTransferDone (
+  IN VOID    *Data,
+  IN UINTN   DataLength,
+  IN VOID    *Context,
+  IN UINT32  Result
+  )
+{
+  USB_BOT_ASYNC_TRANSFER  *Transfer;
+
+  Transfer         = (USB_BOT_ASYNC_TRANSFER *)Context;
+  Transfer->Length = DataLength;
+  Transfer->Result = Result;
+  Transfer->Done   = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Execute a command with the CBW, data and CSW queued on the bulk
+  endpoints together, so the device doesn't wait for the host to
+  start the next phase.
+
+  Each phase is handled as in UsbBotSendCommand, UsbBotDataTransfer
+  and UsbBotGetStatus. A phase that can't be queued is finished with
+  the synchronous transfers instead.
+
+  @param  UsbBot                The USB BOT device
+  @param  Cmd                   The command to transfer to device
+  @param  CmdLen                The length of the command
+  @param  DataDir               The direction of the data
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait the data to transfer
+  @param  CmdStatus             The result of the command execution
+
+  @retval EFI_SUCCESS           Command execute result is retrieved and in CmdStatus.
+  @retval EFI_UNSUPPORTED       The CBW can't be queued, nothing is sent.
+  @retval Other                 Failed to execute the command.
+
+**/
+EFI_STATUS
+UsbBotExecCommandAsync (
+  IN  USB_BOT_PROTOCOL        *UsbBot,
+  IN  UINT8                   *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT8                   *CmdStatus
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  EFI_USB_ENDPOINT_DESCRIPTOR       *Endpoint;
+  USB_BOT_CBW                       Cbw;
+  USB_BOT_CSW                       Csw;
+  USB_BOT_ASYNC_TRANSFER            CbwTransfer;
+  USB_BOT_ASYNC_TRANSFER            DataTransfer;
+  USB_BOT_ASYNC_TRANSFER            CswTransfer;
+  USB_BOT_ASYNC_TRANSFER            *Last;
+  BOOLEAN                           HasData;
+  BOOLEAN                           DataQueued;
+  BOOLEAN                           CswQueued;
+  BOOLEAN                           TimedOut;
+  UINT64                            Waited;
+  UINT64                            Limit;
+  UINTN                             TransLen;
+  EFI_STATUS                        Status;
+
+  AsyncBulk = UsbBot->UsbIoAsyncBulk;
+  HasData   = (BOOLEAN)((DataDir != EfiUsbNoData) && (DataLen != 0));
+  Endpoint  = (DataDir == EfiUsbDataIn) ? UsbBot->BulkInEndpoint : UsbBot->BulkOutEndpoint;
+
+  UsbBotBuildCbw (UsbBot, Cmd, CmdLen, DataDir, DataLen, Lun, &Cbw);
+  ZeroMem (&Csw, sizeof (USB_BOT_CSW));
+  ZeroMem (&CbwTransfer, sizeof (USB_BOT_ASYNC_TRANSFER));
+  ZeroMem (&DataTransfer, sizeof (USB_BOT_ASYNC_TRANSFER));
+  ZeroMem (&CswTransfer, sizeof (USB_BOT_ASYNC_TRANSFER));
+
+  Status = AsyncBulk->Submit (
+                        AsyncBulk,
+                        UsbBot->BulkOutEndpoint->EndpointAddress,
+                        0,
+                        &Cbw,
+                        sizeof (USB_BOT_CBW),
+                        UsbBotAsyncTransferDone,
+                        &CbwTransfer
+                        );
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  DataQueued = FALSE;
+  if (HasData) {
+    Status = AsyncBulk->Submit (
+                          AsyncBulk,
+                          Endpoint->EndpointAddress,
+                          0,
+                          Data,
+                          DataLen,
+                          UsbBotAsyncTransferDone,
+                          &DataTransfer
+                          );
+    DataQueued = (BOOLEAN) !EFI_ERROR (Status);
+  }
+
+  CswQueued = FALSE;
+  if (!HasData || DataQueued) {
+    Status = AsyncBulk->Submit (
+                          AsyncBulk,
+                          UsbBot->BulkInEndpoint->EndpointAddress,
+                          0,
+                          &Csw,
+                          sizeof (USB_BOT_CSW),
+                          UsbBotAsyncTransferDone,
+                          &CswTransfer
+                          );
+    CswQueued = (BOOLEAN) !EFI_ERROR (Status);
+  }
+
+  //
+  // Wait for the last queued transfer. Nothing queued behind a failed
+  // CBW can complete, so stop waiting as soon as the CBW fails.
+  //
+  if (CswQueued) {
+    Last = &CswTransfer;
+  } else if (DataQueued) {
+    Last = &DataTransfer;
+  } else {
+    Last = &CbwTransfer;
+  }
+
+  Limit = (UINT64)USB_BOT_SEND_CBW_TIMEOUT + Timeout + USB_BOT_RECV_CSW_TIMEOUT;
+  for (Waited = 0; Waited < Limit; Waited += USB_BOT_ASYNC_POLL_INTERVAL) {
+    AsyncBulk->Poll (AsyncBulk);
+    if (Last->Done || (CbwTransfer.Done && (CbwTransfer.Result != EFI_USB_NOERROR))) {
+      break;
+    }
+
+    gBS->Stall (USB_BOT_ASYNC_POLL_INTERVAL);
+  }
+
+  TimedOut = (BOOLEAN)(Waited >= Limit);
+
+  //
+  // Take back whatever is still queued before the buffers on the stack
+  // go away. The cancelled transfers are reported as not executed.
+  //
+  AsyncBulk->Cancel (AsyncBulk, UsbBot->BulkOutEndpoint->EndpointAddress, 0);
+  AsyncBulk->Cancel (AsyncBulk, UsbBot->BulkInEndpoint->EndpointAddress, 0);
+
+  //
+  // Command phase.
+  //
+  if (!CbwTransfer.Done || (CbwTransfer.Result != EFI_USB_NOERROR)) {
+    if (USB_IS_ERROR (CbwTransfer.Result, EFI_USB_ERR_STALL) && (DataDir == EfiUsbDataOut)) {
+      //
+      // Respond to Bulk-Out endpoint stall with a Reset Recovery,
+      // according to section 5.3.1 of USB Mass Storage Class Bulk-Only Transport Spec, v1.0.
+      //
+      UsbBotResetDevice (UsbBot, FALSE);
+    }
+
+    if (USB_IS_ERROR (CbwTransfer.Result, EFI_USB_ERR_NAK)) {
+      return EFI_NOT_READY;
+    }
+
+    return TimedOut ? EFI_TIMEOUT : EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Data phase. As in UsbBotExecCommand, go on to the status phase
+  // even if the data transfer failed.
+  //
+  if (HasData && !DataQueued) {
+    TransLen = (UINTN)DataLen;
+    UsbBotDataTransfer (UsbBot, DataDir, Data, &TransLen, Timeout);
+  } else if (HasData && (DataTransfer.Result != EFI_USB_NOERROR)) {
+    DEBUG ((DEBUG_INFO, "UsbBotExecCommandAsync: data transfer result 0x%x\n", DataTransfer.Result));
+    if (USB_IS_ERROR (DataTransfer.Result, EFI_USB_ERR_STALL)) {
+      UsbClearEndpointStall (UsbBot->UsbIo, Endpoint->EndpointAddress);
+    } else if (TimedOut && USB_IS_ERROR (DataTransfer.Result, EFI_USB_ERR_NOTEXECUTE)) {
+      UsbBotResetDevice (UsbBot, FALSE);
+    }
+  }
+
+  //
+  // Status phase. Take the queued CSW if it is valid, otherwise recover
+  // the same way as UsbBotGetStatus and read the CSW again.
+  //
+  if (CswQueued && (CswTransfer.Result == EFI_USB_NOERROR)) {
+    if ((Csw.Signature == USB_BOT_CSW_SIGNATURE) && (Csw.CmdStatus != USB_BOT_COMMAND_ERROR)) {
+      *CmdStatus = Csw.CmdStatus;
+      UsbBot->CbwTag++;
+      return EFI_SUCCESS;
+    }
+
+    UsbBotResetDevice (UsbBot, FALSE);
+  } else if (CswQueued && USB_IS_ERROR (CswTransfer.Result, EFI_USB_ERR_STALL)) {
+    UsbClearEndpointStall (UsbBot->UsbIo, UsbBot->BulkInEndpoint->EndpointAddress);
+  }
+
+  return UsbBotGetStatus (UsbBot, DataLen, CmdStatus);
+}
+
 /**
   Call the USB Mass Storage Class BOT protocol to issue
   the command/data/status circle to execute the commands.
@@ -410,6 +675,26 @@ UsbBotExecCommand (
   *CmdStatus = USB_MASS_CMD_FAIL;
   UsbBot     = (USB_BOT_PROTOCOL *)Context;
 
+  //
+  // Queue all three phases if the bus supports it. Only fall back to
+  // the synchronous phases below if the CBW can't be queued.
+  //
+  if (UsbBot->UsbIoAsyncBulk != NULL) {
+    Status = UsbBotExecCommandAsync (UsbBot, Cmd, CmdLen, DataDir, Data, DataLen, Lun, Timeout, &Result);
+    if (Status != EFI_UNSUPPORTED) {
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "UsbBotExecCommand: UsbBotExecCommandAsync (%r)\n", Status));
+        return Status;
+      }
+
+      if (Result == 0) {
+        *CmdStatus = USB_MASS_CMD_SUCCESS;
+      }
+
+      return EFI_SUCCESS;
+    }
+  }
+
   //
   // Send the command to the device. Return immediately if device
   // rejects the command.
@@ -47,6 +47,11 @@ extern USB_MASS_TRANSPORT  mUsbBotTransport;
 #define USB_BOT_RECV_CSW_TIMEOUT      (3 * USB_MASS_1_SECOND)
 #define USB_BOT_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
 
+//
+// Interval to poll the queued CBW, data and CSW transfers
+//
+#define USB_BOT_ASYNC_POLL_INTERVAL  1
+
 #pragma pack(1)
 ///
 /// The CBW (Command Block Wrapper) structures used by the USB BOT protocol.
@@ -76,13 +81,23 @@ typedef struct {
   //
   // Put Interface at the first field to make it easy to distinguish BOT/CBI Protocol instance
   //
-  EFI_USB_INTERFACE_DESCRIPTOR    Interface;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkInEndpoint;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkOutEndpoint;
-  UINT32                          CbwTag;
-  EFI_USB_IO_PROTOCOL             *UsbIo;
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkInEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkOutEndpoint;
+  UINT32                              CbwTag;
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *UsbIoAsyncBulk; ///< NULL if bulk transfers can't be queued
 } USB_BOT_PROTOCOL;
 
+///
+/// State of a CBW, data or CSW transfer queued by UsbBotExecCommand.
+///
+typedef struct {
+  BOOLEAN    Done;
+  UINTN      Length;
+  UINT32     Result;
+} USB_BOT_ASYNC_TRANSFER;
+
 /**
   Initializes USB BOT protocol.
 
@@ -91,6 +106,7 @@ typedef struct {
   in the Context if Context isn't NULL.
 
   @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
   @param  Context               The buffer to save the context to
 
   @retval EFI_SUCCESS           The device is successfully initialized.
@@ -101,6 +117,7 @@ typedef struct {
 EFI_STATUS
 UsbBotInit (
   IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
   OUT VOID                 **Context OPTIONAL
   );
 
@@ -20,7 +20,8 @@ USB_MASS_TRANSPORT  mUsbCbi0Transport = {
   UsbCbiExecCommand,
   UsbCbiResetDevice,
   NULL,
-  UsbCbiCleanUp
+  UsbCbiCleanUp,
+  NULL
 };
 
 //
@@ -32,7 +33,8 @@ USB_MASS_TRANSPORT  mUsbCbi1Transport = {
   UsbCbiExecCommand,
   UsbCbiResetDevice,
   NULL,
-  UsbCbiCleanUp
+  UsbCbiCleanUp,
+  NULL
 };
 
 /**
@@ -43,6 +45,7 @@ USB_MASS_TRANSPORT  mUsbCbi1Transport = {
   in the Context if Context isn't NULL.
 
   @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
   @param  Context               The buffer to save the context to
 
   @retval EFI_SUCCESS           The device is successfully initialized.
@@ -53,6 +56,7 @@ USB_MASS_TRANSPORT  mUsbCbi1Transport = {
 EFI_STATUS
 UsbCbiInit (
   IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
   OUT VOID                 **Context       OPTIONAL
   )
 {
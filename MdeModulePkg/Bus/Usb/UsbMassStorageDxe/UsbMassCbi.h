@@ -54,6 +54,7 @@ typedef struct {
   in the Context if Context isn't NULL.
 
   @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
   @param  Context               The buffer to save the context to
 
   @retval EFI_SUCCESS           The device is successfully initialized.
@@ -64,6 +65,7 @@ typedef struct {
 EFI_STATUS
 UsbCbiInit (
   IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
   OUT VOID                 **Context       OPTIONAL
   );
 
@@ -8,7 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "UsbMass.h"
 
-#define USB_MASS_TRANSPORT_COUNT  3
+#define USB_MASS_TRANSPORT_COUNT  4
 //
 // Array of USB transport interfaces.
 //
@@ -16,6 +16,7 @@ USB_MASS_TRANSPORT  *mUsbMassTransport[USB_MASS_TRANSPORT_COUNT] = {
   &mUsbCbi0Transport,
   &mUsbCbi1Transport,
   &mUsbBotTransport,
+  &mUsbUasTransport,
 };
 
 EFI_DRIVER_BINDING_PROTOCOL  gUSBMassDriverBinding = {
@@ -417,17 +418,27 @@ UsbMassInitTransport (
 
   Status = EFI_UNSUPPORTED;
 
+  //
+  // UAS capable devices usually present BOT in alternate setting 0 and UAS
+  // in another alternate setting. Prefer UAS if the interface has it, the
+  // UAS transport selects its alternate setting in Init().
+  //
+  if (Interface.InterfaceProtocol == USB_MASS_STORE_BOT) {
+    *Transport = &mUsbUasTransport;
+    Status     = (*Transport)->Init (UsbIo, Controller, Context);
+  }
+
   //
   // Traverse the USB_MASS_TRANSPORT arrary and try to find the
   // matching transport protocol.
   // If not found, return EFI_UNSUPPORTED.
   // If found, execute USB_MASS_TRANSPORT.Init() to initialize the transport context.
   //
-  for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
+  for (Index = 0; EFI_ERROR (Status) && (Index < USB_MASS_TRANSPORT_COUNT); Index++) {
     *Transport = mUsbMassTransport[Index];
 
     if (Interface.InterfaceProtocol == (*Transport)->Protocol) {
-      Status = (*Transport)->Init (UsbIo, Context);
+      Status = (*Transport)->Init (UsbIo, Controller, Context);
       break;
     }
   }
@@ -437,11 +448,13 @@ UsbMassInitTransport (
   }
 
   //
-  // For BOT device, try to get its max LUN.
+  // For BOT and UAS device, try to get its max LUN.
   // If max LUN is 0, then it is a non-lun device.
   // Otherwise, it is a multi-lun device.
   //
-  if ((*Transport)->Protocol == USB_MASS_STORE_BOT) {
+  if (((*Transport)->Protocol == USB_MASS_STORE_BOT) ||
+      ((*Transport)->Protocol == USB_MASS_STORE_UAS))
+  {
     (*Transport)->GetMaxLun (*Context, MaxLun);
   }
 
@@ -752,7 +765,7 @@ USBMassDriverBindingSupported (
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     Transport = mUsbMassTransport[Index];
     if (Interface.InterfaceProtocol == Transport->Protocol) {
-      Status = Transport->Init (UsbIo, NULL);
+      Status = Transport->Init (UsbIo, Controller, NULL);
       break;
     }
   }
@@ -0,0 +1,1451 @@
+/** @file
+  Implementation of the USB Attached SCSI (UAS) transport, according to
+  "Universal Serial Bus Attached SCSI (UAS)" Revision 1.0.
+
+  UAS devices normally expose a Bulk-Only alternate setting 0 and a UAS
+  alternate setting 1 on the same interface. The UAS setting is selected
+  when present.
+
+  At SuperSpeed the status and data pipes have bulk streams. The commands
+  are then queued through EDKII_USB_IO_ASYNC_BULK_PROTOCOL, each with its
+  status and data on the streams of its tag. At high speed the pipes have
+  no streams, and the transport runs the UAS flow with READ READY / WRITE
+  READY information units and a single outstanding command.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbMass.h"
+
+//
+// Definition of USB UAS Transport Protocol
+//
+USB_MASS_TRANSPORT  mUsbUasTransport = {
+  USB_MASS_STORE_UAS,
+  UsbUasInit,
+  UsbUasExecCommand,
+  UsbUasResetDevice,
+  UsbUasGetMaxLun,
+  UsbUasCleanUp,
+  UsbUasExecCommands
+};
+
+/**
+  Read the whole active configuration descriptor, including the interface,
+  endpoint and class specific descriptors that follow it.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Config                Return the configuration descriptor. Caller
+                                should free it with FreePool().
+
+  @retval EFI_SUCCESS           The configuration descriptor is returned.
+  @retval EFI_NOT_FOUND         The active configuration can't be found.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval Others                Failed to get the descriptor.
+
+**/
+EFI_STATUS
+UsbUasGetConfigDescriptor (
+  IN  EFI_USB_IO_PROTOCOL        *UsbIo,
+  OUT EFI_USB_CONFIG_DESCRIPTOR  **Config
+  )
+{
+  EFI_USB_DEVICE_DESCRIPTOR  DevDesc;
+  EFI_USB_CONFIG_DESCRIPTOR  ActiveConfig;
+  EFI_USB_CONFIG_DESCRIPTOR  ConfigHead;
+  EFI_USB_DEVICE_REQUEST     Request;
+  EFI_STATUS                 Status;
+  UINT32                     Result;
+  UINT32                     Timeout;
+  UINT8                      Index;
+  VOID                       *Buffer;
+
+  *Config = NULL;
+
+  Status = UsbIo->UsbGetDeviceDescriptor (UsbIo, &DevDesc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &ActiveConfig);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Request.RequestType = USB_ENDPOINT_DIR_IN;
+  Request.Request     = USB_REQ_GET_DESCRIPTOR;
+  Timeout             = USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  //
+  // The descriptor index used by GET_DESCRIPTOR isn't the configuration
+  // value, so find the active configuration by its value first.
+  //
+  for (Index = 0; Index < DevDesc.NumConfigurations; Index++) {
+    Request.Value  = (UINT16)((USB_DESC_TYPE_CONFIG << 8) | Index);
+    Request.Index  = 0;
+    Request.Length = (UINT16)sizeof (EFI_USB_CONFIG_DESCRIPTOR);
+
+    Status = UsbIo->UsbControlTransfer (
+                      UsbIo,
+                      &Request,
+                      EfiUsbDataIn,
+                      Timeout,
+                      &ConfigHead,
+                      sizeof (EFI_USB_CONFIG_DESCRIPTOR),
+                      &Result
+                      );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (ConfigHead.ConfigurationValue != ActiveConfig.ConfigurationValue) {
+      continue;
+    }
+
+    if (ConfigHead.TotalLength < sizeof (EFI_USB_CONFIG_DESCRIPTOR)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Buffer = AllocateZeroPool (ConfigHead.TotalLength);
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Request.Length = ConfigHead.TotalLength;
+    Status         = UsbIo->UsbControlTransfer (
+                              UsbIo,
+                              &Request,
+                              EfiUsbDataIn,
+                              Timeout,
+                              Buffer,
+                              ConfigHead.TotalLength,
+                              &Result
+                              );
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      return Status;
+    }
+
+    *Config = Buffer;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find the UAS alternate setting of an interface in the configuration
+  descriptor and get the endpoints of the four UAS pipes.
+
+  @param  Config                The whole configuration descriptor.
+  @param  InterfaceNumber       The interface to look for.
+  @param  UsbUas                The UAS context to save the endpoints and
+                                the number of streams to.
+  @param  AltSetting            Return the UAS alternate setting.
+
+  @retval EFI_SUCCESS           A usable UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no usable UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasParseSetting (
+  IN  EFI_USB_CONFIG_DESCRIPTOR  *Config,
+  IN  UINT8                      InterfaceNumber,
+  IN  USB_UAS_PROTOCOL           *UsbUas,
+  OUT UINT8                      *AltSetting
+  )
+{
+  UINT8                               *Desc;
+  UINT8                               *End;
+  EFI_USB_INTERFACE_DESCRIPTOR        *IfDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *EpDesc;
+  USB_UAS_PIPE_USAGE_DESCRIPTOR       *PipeDesc;
+  USB_UAS_SS_EP_COMPANION_DESCRIPTOR  *CompDesc;
+  BOOLEAN                             InUasSetting;
+  UINT8                               EndpointAddr;
+  UINT8                               EpStreams;
+  UINT8                               MaxStreams;
+
+  Desc         = (UINT8 *)Config;
+  End          = Desc + Config->TotalLength;
+  InUasSetting = FALSE;
+  EndpointAddr = 0;
+  EpStreams    = 0;
+  MaxStreams   = MAX_UINT8;
+
+  while ((Desc + 2 <= End) && (Desc[0] >= 2) && (Desc + Desc[0] <= End)) {
+    switch (Desc[1]) {
+      case USB_DESC_TYPE_INTERFACE:
+        if (InUasSetting) {
+          //
+          // Reach the next setting, the UAS setting is complete.
+          //
+          goto ON_SETTING_END;
+        }
+
+        IfDesc = (EFI_USB_INTERFACE_DESCRIPTOR *)Desc;
+        if ((Desc[0] >= sizeof (EFI_USB_INTERFACE_DESCRIPTOR)) &&
+            (IfDesc->InterfaceNumber == InterfaceNumber) &&
+            (IfDesc->InterfaceClass == USB_MASS_STORE_CLASS) &&
+            (IfDesc->InterfaceProtocol == USB_MASS_STORE_UAS))
+        {
+          InUasSetting = TRUE;
+          *AltSetting  = IfDesc->AlternateSetting;
+        }
+
+        break;
+
+      case USB_DESC_TYPE_ENDPOINT:
+        if (InUasSetting && (Desc[0] >= sizeof (EFI_USB_ENDPOINT_DESCRIPTOR))) {
+          EpDesc       = (EFI_USB_ENDPOINT_DESCRIPTOR *)Desc;
+          EndpointAddr = USB_IS_BULK_ENDPOINT (EpDesc->Attributes) ? EpDesc->EndpointAddress : 0;
+          EpStreams    = 0;
+        }
+
+        break;
+
+      case USB_UAS_DESC_TYPE_SS_EP_COMPANION:
+        CompDesc = (USB_UAS_SS_EP_COMPANION_DESCRIPTOR *)Desc;
+        if (InUasSetting && (Desc[0] >= sizeof (USB_UAS_SS_EP_COMPANION_DESCRIPTOR))) {
+          EpStreams = USB_UAS_SS_MAX_STREAMS (CompDesc->Attributes);
+        }
+
+        break;
+
+      case USB_UAS_DESC_TYPE_PIPE_USAGE:
+        PipeDesc = (USB_UAS_PIPE_USAGE_DESCRIPTOR *)Desc;
+        if (!InUasSetting || (EndpointAddr == 0) || (Desc[0] < sizeof (USB_UAS_PIPE_USAGE_DESCRIPTOR))) {
+          break;
+        }
+
+        if ((PipeDesc->PipeId == USB_UAS_PIPE_ID_COMMAND) && USB_IS_OUT_ENDPOINT (EndpointAddr)) {
+          UsbUas->CommandEndpoint = EndpointAddr;
+        } else if ((PipeDesc->PipeId == USB_UAS_PIPE_ID_STATUS) && USB_IS_IN_ENDPOINT (EndpointAddr)) {
+          UsbUas->StatusEndpoint = EndpointAddr;
+          MaxStreams             = MIN (MaxStreams, EpStreams);
+        } else if ((PipeDesc->PipeId == USB_UAS_PIPE_ID_DATA_IN) && USB_IS_IN_ENDPOINT (EndpointAddr)) {
+          UsbUas->DataInEndpoint = EndpointAddr;
+          MaxStreams             = MIN (MaxStreams, EpStreams);
+        } else if ((PipeDesc->PipeId == USB_UAS_PIPE_ID_DATA_OUT) && USB_IS_OUT_ENDPOINT (EndpointAddr)) {
+          UsbUas->DataOutEndpoint = EndpointAddr;
+          MaxStreams              = MIN (MaxStreams, EpStreams);
+        }
+
+        EndpointAddr = 0;
+        break;
+
+      default:
+        break;
+    }
+
+    Desc += Desc[0];
+  }
+
+ON_SETTING_END:
+  if (!InUasSetting ||
+      (UsbUas->CommandEndpoint == 0) || (UsbUas->StatusEndpoint == 0) ||
+      (UsbUas->DataInEndpoint == 0) || (UsbUas->DataOutEndpoint == 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Streams are only used if the status and both data pipes have them.
+  //
+  UsbUas->MaxStreams = MaxStreams;
+  return EFI_SUCCESS;
+}
+
+/**
+  Select an alternate setting of the mass storage interface.
+
+  @param  UsbUas                The USB UAS device
+  @param  AltSetting            The alternate setting to select
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval Others                Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSelectSetting (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT8             AltSetting
+  )
+{
+  EFI_USB_DEVICE_REQUEST  Request;
+  UINT32                  Result;
+  UINT32                  Timeout;
+
+  //
+  // USB bus driver updates the endpoints of the USB I/O Protocol
+  // instance when it sees a SET_INTERFACE request.
+  //
+  Request.RequestType = 0x01;
+  Request.Request     = USB_REQ_SET_INTERFACE;
+  Request.Value       = AltSetting;
+  Request.Index       = UsbUas->Interface.InterfaceNumber;
+  Request.Length      = 0;
+  Timeout             = USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND;
+
+  return UsbUas->UsbIo->UsbControlTransfer (
+                          UsbUas->UsbIo,
+                          &Request,
+                          EfiUsbNoData,
+                          Timeout,
+                          NULL,
+                          0,
+                          &Result
+                          );
+}
+
+/**
+  Free the streams of the status and data pipes.
+
+  @param  UsbUas                The USB UAS device
+
+**/
+VOID
+UsbUasFreeStreams (
+  IN USB_UAS_PROTOCOL  *UsbUas
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+
+  AsyncBulk = UsbUas->UsbIoAsyncBulk;
+  AsyncBulk->FreeStreams (AsyncBulk, UsbUas->StatusEndpoint);
+  AsyncBulk->FreeStreams (AsyncBulk, UsbUas->DataInEndpoint);
+  AsyncBulk->FreeStreams (AsyncBulk, UsbUas->DataOutEndpoint);
+
+  UsbUas->QueueDepth = 0;
+}
+
+/**
+  Give streams to the status and data pipes of the selected UAS setting,
+  and set the command queue depth by the number of streams they get.
+
+  Stream 1 carries the status of the task management functions, and each
+  of the other streams carries the status and data of one queued command.
+
+  @param  UsbUas                The USB UAS device
+
+  @retval EFI_SUCCESS           The pipes have streams for at least one command.
+  @retval EFI_UNSUPPORTED       The pipes don't get enough streams.
+  @retval Others                Failed to give streams to the pipes.
+
+**/
+EFI_STATUS
+UsbUasAllocateStreams (
+  IN USB_UAS_PROTOCOL  *UsbUas
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  UINT8                             Pipes[3];
+  UINT16                            Wanted;
+  UINT16                            Granted;
+  UINT16                            NumStreams;
+  UINTN                             Index;
+  EFI_STATUS                        Status;
+
+  AsyncBulk = UsbUas->UsbIoAsyncBulk;
+  Pipes[0]  = UsbUas->StatusEndpoint;
+  Pipes[1]  = UsbUas->DataInEndpoint;
+  Pipes[2]  = UsbUas->DataOutEndpoint;
+  Wanted    = (UINT16)MIN (USB_UAS_MAX_QUEUED_CMDS + 1, 1U << UsbUas->MaxStreams);
+  Granted   = Wanted;
+
+  for (Index = 0; Index < ARRAY_SIZE (Pipes); Index++) {
+    NumStreams = Wanted;
+    Status     = AsyncBulk->AllocateStreams (AsyncBulk, Pipes[Index], &NumStreams);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasAllocateStreams: Pipe %02x (%r)\n", Pipes[Index], Status));
+      while (Index-- > 0) {
+        AsyncBulk->FreeStreams (AsyncBulk, Pipes[Index]);
+      }
+
+      return Status;
+    }
+
+    Granted = MIN (Granted, NumStreams);
+  }
+
+  if (Granted < 2) {
+    UsbUasFreeStreams (UsbUas);
+    return EFI_UNSUPPORTED;
+  }
+
+  UsbUas->QueueDepth = Granted - 1;
+  for (Index = 0; Index < UsbUas->QueueDepth; Index++) {
+    UsbUas->Tasks[Index].Command = NULL;
+    UsbUas->Tasks[Index].Tag     = (UINT16)(USB_UAS_FIRST_CMD_TAG + Index);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks for a UAS alternate setting of the current interface,
+  selects it and initializes the USB mass storage class UAS protocol.
+  It will save its context which is a USB_UAS_PROTOCOL structure
+  in the Context if Context isn't NULL. If Context is NULL, the alternate
+  setting is not changed.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
+  OUT VOID                 **Context OPTIONAL
+  )
+{
+  USB_UAS_PROTOCOL           *UsbUas;
+  EFI_USB_CONFIG_DESCRIPTOR  *Config;
+  EFI_STATUS                 Status;
+  UINT8                      AltSetting;
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_PROTOCOL));
+  if (UsbUas == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  UsbUas->UsbIo = UsbIo;
+  Config        = NULL;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (UsbUas->Interface.InterfaceClass != USB_MASS_STORE_CLASS) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  //
+  // The UAS setting may not be the active one, so the endpoints and
+  // the pipe usage descriptors are taken from the configuration descriptor.
+  //
+  Status = UsbUasGetConfigDescriptor (UsbIo, &Config);
+  if (EFI_ERROR (Status)) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  Status = UsbUasParseSetting (Config, UsbUas->Interface.InterfaceNumber, UsbUas, &AltSetting);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Context == NULL) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Streams can only be addressed through the async bulk extension of the
+  // USB I/O Protocol. Stay on BOT if the bus doesn't have it.
+  //
+  if (UsbUas->MaxStreams != 0) {
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                    (VOID **)&UsbUas->UsbIoAsyncBulk,
+                    gImageHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "UsbUasInit: UAS setting %d needs bulk streams, not used\n", AltSetting));
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+  }
+
+  UsbUas->PrevAltSetting = UsbUas->Interface.AlternateSetting;
+  if (AltSetting != UsbUas->Interface.AlternateSetting) {
+    Status = UsbUasSelectSetting (UsbUas, AltSetting);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasInit: Select alternate setting %d (%r)\n", AltSetting, Status));
+      goto ON_ERROR;
+    }
+
+    Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &UsbUas->Interface);
+    if (EFI_ERROR (Status) || (UsbUas->Interface.InterfaceProtocol != USB_MASS_STORE_UAS)) {
+      UsbUasSelectSetting (UsbUas, UsbUas->PrevAltSetting);
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+  }
+
+  if (UsbUas->UsbIoAsyncBulk != NULL) {
+    Status = UsbUasAllocateStreams (UsbUas);
+    if (EFI_ERROR (Status)) {
+      if (UsbUas->PrevAltSetting != UsbUas->Interface.AlternateSetting) {
+        UsbUasSelectSetting (UsbUas, UsbUas->PrevAltSetting);
+      }
+
+      Status = EFI_UNSUPPORTED;
+      goto ON_ERROR;
+    }
+  }
+
+  UsbUas->Tag = USB_UAS_FIRST_CMD_TAG;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbUasInit: UAS setting %d, pipes %02x/%02x/%02x/%02x, %d commands queued\n",
+    AltSetting,
+    UsbUas->CommandEndpoint,
+    UsbUas->StatusEndpoint,
+    UsbUas->DataInEndpoint,
+    UsbUas->DataOutEndpoint,
+    MAX (UsbUas->QueueDepth, 1)
+    ));
+
+  FreePool (Config);
+  *Context = UsbUas;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  if (Config != NULL) {
+    FreePool (Config);
+  }
+
+  FreePool (UsbUas);
+  return Status;
+}
+
+/**
+  Transfer an information unit or data over one of the UAS pipes, and
+  recover the pipe if it is stalled.
+
+  @param  UsbUas                The USB UAS device
+  @param  Endpoint              The endpoint address of the pipe
+  @param  Data                  The buffer to hold data
+  @param  TransLen              The expected length of the data, and return
+                                the transferred length.
+  @param  Timeout               The time to wait, in microseconds
+
+  @retval EFI_SUCCESS           The data is transferred
+  @retval EFI_NOT_READY         The device return NAK to the transfer
+  @retval Others                Failed to transfer data
+
+**/
+EFI_STATUS
+UsbUasTransfer (
+  IN     USB_UAS_PROTOCOL  *UsbUas,
+  IN     UINT8             Endpoint,
+  IN OUT VOID              *Data,
+  IN OUT UINTN             *TransLen,
+  IN     UINT32            Timeout
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Result;
+
+  Result = 0;
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            Endpoint,
+                            Data,
+                            TransLen,
+                            Timeout / USB_MASS_1_MILLISECOND,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    if (USB_IS_ERROR (Result, EFI_USB_ERR_STALL)) {
+      DEBUG ((DEBUG_INFO, "UsbUasTransfer: Endpoint %02x stall\n", Endpoint));
+      UsbClearEndpointStall (UsbUas->UsbIo, Endpoint);
+    } else if (USB_IS_ERROR (Result, EFI_USB_ERR_NAK)) {
+      Status = EFI_NOT_READY;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Receive the next information unit for a tag from the status pipe.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag the IU should carry
+  @param  Iu                    The buffer to receive the IU
+  @param  Timeout               The time to wait, in microseconds
+
+  @retval EFI_SUCCESS           An IU with the tag is received
+  @retval EFI_DEVICE_ERROR      The IU is malformed or carries another tag
+  @retval Others                Failed to receive the IU
+
+**/
+EFI_STATUS
+UsbUasRecvStatusIu (
+  IN  USB_UAS_PROTOCOL   *UsbUas,
+  IN  UINT16             Tag,
+  OUT USB_UAS_STATUS_IU  *Iu,
+  IN  UINT32             Timeout
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Len;
+
+  ZeroMem (Iu, sizeof (USB_UAS_STATUS_IU));
+  Len    = sizeof (USB_UAS_STATUS_IU);
+  Status = UsbUasTransfer (UsbUas, UsbUas->StatusEndpoint, Iu, &Len, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Len < sizeof (USB_UAS_IU_HEADER)) || (SwapBytes16 (Iu->Header.Tag) != Tag)) {
+    DEBUG ((DEBUG_ERROR, "UsbUasRecvStatusIu: Unexpected IU %x, tag %x\n", Iu->Header.IuId, SwapBytes16 (Iu->Header.Tag)));
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Record the result of an IU or data transfer queued on a UAS pipe.
+
+  @param  Data                  The data buffer of the transfer.
+  @param  DataLength            The number of bytes transferred.
+  @param  Context               The USB_UAS_ASYNC_TRANSFER of the transfer.
+  @param  Result                The result of the transfer.
+
+  @retval EFI_SUCCESS           The result is recorded.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasAsyncTransferDone (
+  IN VOID    *Data,
+  IN UINTN   DataLength,
+  IN VOID    *Context,
+  IN UINT32  Result
+  )
+{
+  USB_UAS_ASYNC_TRANSFER  *Transfer;
+
+  Transfer         = (USB_UAS_ASYNC_TRANSFER *)Context;
+  Transfer->Length = DataLength;
+  Transfer->Result = Result;
+  Transfer->Done   = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Wait for a transfer queued on a UAS pipe to complete.
+
+  @param  UsbUas                The USB UAS device
+  @param  Transfer              The transfer to wait for
+  @param  Timeout               The time to wait, in microseconds
+
+  @retval EFI_SUCCESS           The transfer is completed.
+  @retval EFI_TIMEOUT           The transfer isn't completed in time.
+
+**/
+EFI_STATUS
+UsbUasWaitTransfer (
+  IN USB_UAS_PROTOCOL        *UsbUas,
+  IN USB_UAS_ASYNC_TRANSFER  *Transfer,
+  IN UINT32                  Timeout
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  UINT32                            Waited;
+
+  AsyncBulk = UsbUas->UsbIoAsyncBulk;
+  for (Waited = 0; Waited < Timeout; Waited += USB_UAS_ASYNC_POLL_INTERVAL) {
+    AsyncBulk->Poll (AsyncBulk);
+    if (Transfer->Done) {
+      return EFI_SUCCESS;
+    }
+
+    gBS->Stall (USB_UAS_ASYNC_POLL_INTERVAL);
+  }
+
+  return EFI_TIMEOUT;
+}
+
+/**
+  Cancel everything queued on the UAS pipes and free all the tasks.
+  The callbacks of the cancelled transfers are called before return.
+
+  @param  UsbUas                The USB UAS device
+
+**/
+VOID
+UsbUasCancelTasks (
+  IN USB_UAS_PROTOCOL  *UsbUas
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  UINTN                             Index;
+
+  AsyncBulk = UsbUas->UsbIoAsyncBulk;
+  AsyncBulk->Cancel (AsyncBulk, UsbUas->CommandEndpoint, 0);
+  AsyncBulk->Cancel (AsyncBulk, UsbUas->StatusEndpoint, 0);
+  AsyncBulk->Cancel (AsyncBulk, UsbUas->DataInEndpoint, 0);
+  AsyncBulk->Cancel (AsyncBulk, UsbUas->DataOutEndpoint, 0);
+
+  for (Index = 0; Index < USB_UAS_MAX_QUEUED_CMDS; Index++) {
+    UsbUas->Tasks[Index].Command = NULL;
+  }
+}
+
+/**
+  Queue a command on a free task. The sense IU and the data are queued on
+  the streams of the task's tag before the command IU is sent, so they are
+  ready when the device picks the command up.
+
+  @param  UsbUas                The USB UAS device
+  @param  Task                  The free task to queue the command on
+  @param  Command               The command to queue
+  @param  Lun                   The number of logic unit
+
+  @retval EFI_SUCCESS           The command is queued.
+  @retval Others                Failed to queue the command. Some of its
+                                transfers may be queued already.
+
+**/
+EFI_STATUS
+UsbUasStartTask (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN USB_UAS_TASK      *Task,
+  IN USB_MASS_COMMAND  *Command,
+  IN UINT8             Lun
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  EFI_STATUS                        Status;
+
+  ASSERT ((Command->CmdLen > 0) && (Command->CmdLen <= USB_UAS_MAX_CDBLEN));
+
+  AsyncBulk     = UsbUas->UsbIoAsyncBulk;
+  Task->Command = Command;
+  ZeroMem (&Task->CmdIu, sizeof (USB_UAS_COMMAND_IU));
+  ZeroMem (&Task->StatusIu, sizeof (USB_UAS_STATUS_IU));
+  ZeroMem (&Task->CmdTransfer, sizeof (USB_UAS_ASYNC_TRANSFER));
+  ZeroMem (&Task->DataTransfer, sizeof (USB_UAS_ASYNC_TRANSFER));
+  ZeroMem (&Task->StatusTransfer, sizeof (USB_UAS_ASYNC_TRANSFER));
+
+  Task->CmdIu.IuId   = USB_UAS_IU_COMMAND;
+  Task->CmdIu.Tag    = SwapBytes16 (Task->Tag);
+  Task->CmdIu.Lun[1] = Lun;
+  CopyMem (Task->CmdIu.Cdb, Command->Cmd, Command->CmdLen);
+
+  Status = AsyncBulk->Submit (
+                        AsyncBulk,
+                        UsbUas->StatusEndpoint,
+                        Task->Tag,
+                        &Task->StatusIu,
+                        sizeof (USB_UAS_STATUS_IU),
+                        UsbUasAsyncTransferDone,
+                        &Task->StatusTransfer
+                        );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Command->DataDir != EfiUsbNoData) && (Command->DataLen != 0)) {
+    Status = AsyncBulk->Submit (
+                          AsyncBulk,
+                          (Command->DataDir == EfiUsbDataIn) ? UsbUas->DataInEndpoint : UsbUas->DataOutEndpoint,
+                          Task->Tag,
+                          Command->Data,
+                          Command->DataLen,
+                          UsbUasAsyncTransferDone,
+                          &Task->DataTransfer
+                          );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return AsyncBulk->Submit (
+                      AsyncBulk,
+                      UsbUas->CommandEndpoint,
+                      0,
+                      &Task->CmdIu,
+                      sizeof (USB_UAS_COMMAND_IU),
+                      UsbUasAsyncTransferDone,
+                      &Task->CmdTransfer
+                      );
+}
+
+/**
+  Complete a task whose sense IU is received, and free the task.
+
+  @param  UsbUas                The USB UAS device
+  @param  Task                  The task to complete
+
+  @retval EFI_SUCCESS           The result of the command is in its CmdStatus.
+  @retval EFI_DEVICE_ERROR      The device didn't follow the protocol, it
+                                should be reset.
+
+**/
+EFI_STATUS
+UsbUasFinishTask (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN USB_UAS_TASK      *Task
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  USB_MASS_COMMAND                  *Command;
+  UINT16                            SenseLen;
+
+  AsyncBulk     = UsbUas->UsbIoAsyncBulk;
+  Command       = Task->Command;
+  Task->Command = NULL;
+
+  //
+  // A response IU to a command means the command IU is rejected.
+  //
+  if ((Task->StatusTransfer.Result != EFI_USB_NOERROR) ||
+      (Task->StatusTransfer.Length < sizeof (USB_UAS_IU_HEADER)) ||
+      (SwapBytes16 (Task->StatusIu.Header.Tag) != Task->Tag) ||
+      (Task->StatusIu.Header.IuId != USB_UAS_IU_SENSE))
+  {
+    DEBUG ((
+      DEBUG_ERROR,
+      "UsbUasFinishTask: Unexpected IU %x for cmd 0x%x, result %x\n",
+      Task->StatusIu.Header.IuId,
+      *(UINT8 *)Command->Cmd,
+      Task->StatusTransfer.Result
+      ));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((Command->DataDir != EfiUsbNoData) && (Command->DataLen != 0)) {
+    if (!Task->DataTransfer.Done) {
+      //
+      // The device closed the command before the data phase ended, which
+      // it does for a failed command. Take back the data transfer of this
+      // tag only, the other commands go on.
+      //
+      AsyncBulk->Cancel (
+                   AsyncBulk,
+                   (Command->DataDir == EfiUsbDataIn) ? UsbUas->DataInEndpoint : UsbUas->DataOutEndpoint,
+                   Task->Tag
+                   );
+    } else if (Task->DataTransfer.Result != EFI_USB_NOERROR) {
+      DEBUG ((DEBUG_ERROR, "UsbUasFinishTask: Data transfer result %x for cmd 0x%x\n", Task->DataTransfer.Result, *(UINT8 *)Command->Cmd));
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  if (Task->StatusIu.Sense.Status == USB_UAS_STATUS_GOOD) {
+    Command->CmdStatus = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  SenseLen = MIN (SwapBytes16 (Task->StatusIu.Sense.SenseLength), USB_UAS_MAX_SENSELEN);
+  if (SenseLen != 0) {
+    ZeroMem (UsbUas->SenseData, USB_UAS_MAX_SENSELEN);
+    CopyMem (UsbUas->SenseData, Task->StatusIu.Sense.SenseData, SenseLen);
+    UsbUas->SenseValid = TRUE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Execute the commands queued on the streams of the UAS pipes, with up to
+  QueueDepth commands outstanding on the device.
+
+  A command is done when its sense IU is received. If the device stops
+  completing commands, or breaks the protocol, everything still queued is
+  cancelled and the device is reset.
+
+  @param  UsbUas                The USB UAS device
+  @param  Commands              The commands to execute. CmdStatus of each
+                                command returns its result.
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are executed.
+  @retval EFI_TIMEOUT           No command is completed in time.
+  @retval Others                Failed to execute some of the commands.
+
+**/
+EFI_STATUS
+UsbUasExecCommandsOnStreams (
+  IN     USB_UAS_PROTOCOL  *UsbUas,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  )
+{
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  USB_UAS_TASK                      *Task;
+  EFI_STATUS                        Status;
+  UINTN                             Next;
+  UINTN                             Finished;
+  UINTN                             Index;
+  UINT64                            Waited;
+  UINT64                            Limit;
+  BOOLEAN                           Progress;
+
+  for (Index = 0; Index < Count; Index++) {
+    Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+  }
+
+  //
+  // The streams are gone if a port reset failed to restore them.
+  //
+  if (UsbUas->QueueDepth == 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  AsyncBulk = UsbUas->UsbIoAsyncBulk;
+  Next      = 0;
+  Finished  = 0;
+  Waited    = 0;
+  Limit     = (UINT64)USB_UAS_SEND_IU_TIMEOUT + Timeout + USB_UAS_RECV_IU_TIMEOUT;
+
+  while (Finished < Count) {
+    //
+    // Keep every tag busy while there are commands left.
+    //
+    for (Index = 0; (Index < UsbUas->QueueDepth) && (Next < Count); Index++) {
+      Task = &UsbUas->Tasks[Index];
+      if (Task->Command == NULL) {
+        Status = UsbUasStartTask (UsbUas, Task, &Commands[Next], Lun);
+        if (EFI_ERROR (Status)) {
+          goto ON_ERROR;
+        }
+
+        Next++;
+      }
+    }
+
+    AsyncBulk->Poll (AsyncBulk);
+
+    Progress = FALSE;
+    for (Index = 0; Index < UsbUas->QueueDepth; Index++) {
+      Task = &UsbUas->Tasks[Index];
+      if (Task->Command == NULL) {
+        continue;
+      }
+
+      //
+      // No sense IU comes for a command IU that isn't delivered.
+      //
+      if (Task->CmdTransfer.Done && (Task->CmdTransfer.Result != EFI_USB_NOERROR)) {
+        DEBUG ((DEBUG_ERROR, "UsbUasExecCommandsOnStreams: Command IU result %x\n", Task->CmdTransfer.Result));
+        Status = EFI_DEVICE_ERROR;
+        goto ON_ERROR;
+      }
+
+      if (Task->CmdTransfer.Done && Task->StatusTransfer.Done) {
+        Status = UsbUasFinishTask (UsbUas, Task);
+        if (EFI_ERROR (Status)) {
+          goto ON_ERROR;
+        }
+
+        Finished++;
+        Progress = TRUE;
+      }
+    }
+
+    if (Progress) {
+      Waited = 0;
+      continue;
+    }
+
+    if (Waited >= Limit) {
+      Status = EFI_TIMEOUT;
+      goto ON_ERROR;
+    }
+
+    gBS->Stall (USB_UAS_ASYNC_POLL_INTERVAL);
+    Waited += USB_UAS_ASYNC_POLL_INTERVAL;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  DEBUG ((DEBUG_ERROR, "UsbUasExecCommandsOnStreams: %r, %d of %d commands done\n", Status, Finished, Count));
+
+  //
+  // Take back everything still queued before the buffers go away, and
+  // bring the device back to a known state. The commands not finished
+  // keep USB_MASS_CMD_FAIL.
+  //
+  UsbUasCancelTasks (UsbUas);
+  UsbUasResetDevice (UsbUas, FALSE);
+  return Status;
+}
+
+/**
+  Call the USB Attached SCSI protocol to issue the command/data/status
+  information units to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  )
+{
+  USB_UAS_PROTOCOL    *UsbUas;
+  USB_UAS_COMMAND_IU  CmdIu;
+  USB_UAS_STATUS_IU   StatusIu;
+  USB_MASS_COMMAND    Command;
+  EFI_STATUS          Status;
+  UINTN               Len;
+  UINT16              Tag;
+  UINT16              SenseLen;
+  BOOLEAN             DataDone;
+
+  ASSERT ((CmdLen > 0) && (CmdLen <= USB_UAS_MAX_CDBLEN));
+
+  *CmdStatus = USB_MASS_CMD_FAIL;
+  UsbUas     = (USB_UAS_PROTOCOL *)Context;
+
+  //
+  // The sense data of the last failed command has been returned in its
+  // sense IU, and the device has already discarded it. Answer the REQUEST
+  // SENSE command that follows from the saved copy.
+  //
+  if ((*(UINT8 *)Cmd == USB_BOOT_REQUEST_SENSE_OPCODE) && UsbUas->SenseValid && (DataDir == EfiUsbDataIn)) {
+    CopyMem (Data, UsbUas->SenseData, MIN (DataLen, USB_UAS_MAX_SENSELEN));
+    UsbUas->SenseValid = FALSE;
+    *CmdStatus         = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  UsbUas->SenseValid = FALSE;
+
+  if (UsbUas->UsbIoAsyncBulk != NULL) {
+    Command.Cmd     = Cmd;
+    Command.CmdLen  = CmdLen;
+    Command.DataDir = DataDir;
+    Command.Data    = Data;
+    Command.DataLen = DataLen;
+
+    Status     = UsbUasExecCommandsOnStreams (UsbUas, &Command, 1, Lun, Timeout);
+    *CmdStatus = Command.CmdStatus;
+    return Status;
+  }
+
+  Tag = UsbUas->Tag;
+  UsbUas->Tag++;
+  if (UsbUas->Tag < USB_UAS_FIRST_CMD_TAG) {
+    UsbUas->Tag = USB_UAS_FIRST_CMD_TAG;
+  }
+
+  //
+  // Send the command IU. The LUN uses single level peripheral device addressing.
+  //
+  ZeroMem (&CmdIu, sizeof (CmdIu));
+  CmdIu.IuId   = USB_UAS_IU_COMMAND;
+  CmdIu.Tag    = SwapBytes16 (Tag);
+  CmdIu.Lun[1] = Lun;
+  CopyMem (CmdIu.Cdb, Cmd, CmdLen);
+
+  Len    = sizeof (CmdIu);
+  Status = UsbUasTransfer (UsbUas, UsbUas->CommandEndpoint, &CmdIu, &Len, USB_UAS_SEND_IU_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Send command IU (%r)\n", Status));
+    return Status;
+  }
+
+  //
+  // Without streams, the device announces the data phase with a READ READY
+  // or WRITE READY IU, and closes the command with a sense IU, which may
+  // come without the data phase if the command fails early.
+  //
+  DataDone = (BOOLEAN)((DataDir == EfiUsbNoData) || (DataLen == 0));
+
+  for ( ; ;) {
+    Status = UsbUasRecvStatusIu (UsbUas, Tag, &StatusIu, DataDone ? USB_UAS_RECV_IU_TIMEOUT : Timeout);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Receive status IU (%r)\n", Status));
+      break;
+    }
+
+    if (((StatusIu.Header.IuId == USB_UAS_IU_READ_READY) && (DataDir == EfiUsbDataIn)) ||
+        ((StatusIu.Header.IuId == USB_UAS_IU_WRITE_READY) && (DataDir == EfiUsbDataOut)))
+    {
+      if (DataDone) {
+        Status = EFI_DEVICE_ERROR;
+        break;
+      }
+
+      Len    = DataLen;
+      Status = UsbUasTransfer (
+                 UsbUas,
+                 (DataDir == EfiUsbDataIn) ? UsbUas->DataInEndpoint : UsbUas->DataOutEndpoint,
+                 Data,
+                 &Len,
+                 Timeout
+                 );
+      if (Status == EFI_TIMEOUT) {
+        UsbUasResetDevice (UsbUas, FALSE);
+        break;
+      }
+
+      //
+      // Like BOT, still receive the status even if the data phase fails.
+      //
+      DataDone = TRUE;
+      continue;
+    }
+
+    if (StatusIu.Header.IuId == USB_UAS_IU_SENSE) {
+      if (StatusIu.Sense.Status == USB_UAS_STATUS_GOOD) {
+        *CmdStatus = USB_MASS_CMD_SUCCESS;
+      } else {
+        SenseLen = MIN (SwapBytes16 (StatusIu.Sense.SenseLength), USB_UAS_MAX_SENSELEN);
+        if (SenseLen != 0) {
+          ZeroMem (UsbUas->SenseData, USB_UAS_MAX_SENSELEN);
+          CopyMem (UsbUas->SenseData, StatusIu.Sense.SenseData, SenseLen);
+          UsbUas->SenseValid = TRUE;
+        }
+      }
+
+      Status = EFI_SUCCESS;
+      break;
+    }
+
+    //
+    // A response IU to a command means the command IU is rejected.
+    //
+    DEBUG ((DEBUG_ERROR, "UsbUasExecCommand: Unexpected IU %x for cmd 0x%x\n", StatusIu.Header.IuId, *(UINT8 *)Cmd));
+    Status = EFI_DEVICE_ERROR;
+    break;
+  }
+
+  return Status;
+}
+
+/**
+  Execute several commands, queued together on the streams of the UAS
+  pipes if the device has them.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Commands              The commands to execute. CmdStatus of each
+                                command returns its result.
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are executed.
+  @retval Other                 Failed to execute some of the commands.
+
+**/
+EFI_STATUS
+UsbUasExecCommands (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+  EFI_STATUS        Status;
+  UINTN             Index;
+
+  UsbUas             = (USB_UAS_PROTOCOL *)Context;
+  UsbUas->SenseValid = FALSE;
+
+  if (UsbUas->UsbIoAsyncBulk != NULL) {
+    return UsbUasExecCommandsOnStreams (UsbUas, Commands, Count, Lun, Timeout);
+  }
+
+  //
+  // Without streams the commands run one by one.
+  //
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+    if (!EFI_ERROR (Status)) {
+      Status = UsbUasExecCommand (
+                 Context,
+                 Commands[Index].Cmd,
+                 Commands[Index].CmdLen,
+                 Commands[Index].DataDir,
+                 Commands[Index].Data,
+                 Commands[Index].DataLen,
+                 Lun,
+                 Timeout,
+                 &Commands[Index].CmdStatus
+                 );
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management function.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  )
+{
+  USB_UAS_PROTOCOL                  *UsbUas;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  USB_UAS_TASK_MGMT_IU              TaskIu;
+  USB_UAS_STATUS_IU                 StatusIu;
+  USB_UAS_ASYNC_TRANSFER            StatusTransfer;
+  EFI_STATUS                        Status;
+  UINTN                             Len;
+
+  UsbUas             = (USB_UAS_PROTOCOL *)Context;
+  AsyncBulk          = UsbUas->UsbIoAsyncBulk;
+  UsbUas->SenseValid = FALSE;
+
+  if (AsyncBulk != NULL) {
+    UsbUasCancelTasks (UsbUas);
+  }
+
+  if (ExtendedVerification) {
+    //
+    // If we need to do strictly reset, reset its parent hub port.
+    // The port reset falls back to the default alternate setting, and
+    // the streams go with the UAS setting, so they are given again.
+    //
+    if (AsyncBulk != NULL) {
+      UsbUasFreeStreams (UsbUas);
+    }
+
+    Status = UsbUas->UsbIo->UsbPortReset (UsbUas->UsbIo);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Status = UsbUasSelectSetting (UsbUas, UsbUas->Interface.AlternateSetting);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    if (AsyncBulk != NULL) {
+      Status = UsbUasAllocateStreams (UsbUas);
+      if (EFI_ERROR (Status)) {
+        return EFI_DEVICE_ERROR;
+      }
+    }
+  }
+
+  //
+  // Clear the pipes first so that the task management IU can get through.
+  //
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->CommandEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->StatusEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataInEndpoint);
+  UsbClearEndpointStall (UsbUas->UsbIo, UsbUas->DataOutEndpoint);
+
+  //
+  // UAS has no class specific reset request, issue a LOGICAL UNIT RESET
+  // task management function instead.
+  //
+  ZeroMem (&TaskIu, sizeof (TaskIu));
+  TaskIu.IuId     = USB_UAS_IU_TASK_MGMT;
+  TaskIu.Tag      = SwapBytes16 (USB_UAS_TASK_MGMT_TAG);
+  TaskIu.Function = USB_UAS_TMF_LOGICAL_UNIT_RESET;
+
+  //
+  // With streams, the response IU comes on the stream of the task
+  // management tag, which must be queued before the IU is sent.
+  //
+  if (AsyncBulk != NULL) {
+    ZeroMem (&StatusIu, sizeof (USB_UAS_STATUS_IU));
+    ZeroMem (&StatusTransfer, sizeof (USB_UAS_ASYNC_TRANSFER));
+    Status = AsyncBulk->Submit (
+                          AsyncBulk,
+                          UsbUas->StatusEndpoint,
+                          USB_UAS_TASK_MGMT_TAG,
+                          &StatusIu,
+                          sizeof (USB_UAS_STATUS_IU),
+                          UsbUasAsyncTransferDone,
+                          &StatusTransfer
+                          );
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  Len    = sizeof (TaskIu);
+  Status = UsbUasTransfer (UsbUas, UsbUas->CommandEndpoint, &TaskIu, &Len, USB_UAS_SEND_IU_TIMEOUT);
+  if (!EFI_ERROR (Status)) {
+    if (AsyncBulk != NULL) {
+      Status = UsbUasWaitTransfer (UsbUas, &StatusTransfer, USB_UAS_RESET_DEVICE_TIMEOUT);
+      if (!EFI_ERROR (Status) &&
+          ((StatusTransfer.Result != EFI_USB_NOERROR) || (SwapBytes16 (StatusIu.Header.Tag) != USB_UAS_TASK_MGMT_TAG)))
+      {
+        Status = EFI_DEVICE_ERROR;
+      }
+    } else {
+      Status = UsbUasRecvStatusIu (UsbUas, USB_UAS_TASK_MGMT_TAG, &StatusIu, USB_UAS_RESET_DEVICE_TIMEOUT);
+    }
+  }
+
+  if (AsyncBulk != NULL) {
+    AsyncBulk->Cancel (AsyncBulk, UsbUas->StatusEndpoint, USB_UAS_TASK_MGMT_TAG);
+  }
+
+  if (EFI_ERROR (Status) ||
+      (StatusIu.Header.IuId != USB_UAS_IU_RESPONSE) ||
+      ((StatusIu.Response.ResponseCode != USB_UAS_RC_TMF_COMPLETE) &&
+       (StatusIu.Response.ResponseCode != USB_UAS_RC_TMF_SUCCEEDED)))
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  gBS->Stall (USB_UAS_RESET_DEVICE_STALL);
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  UAS has no GET MAX LUN request, so the LUN inventory is read by the
+  SCSI REPORT LUNS command.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN. (e.g. MaxLun=1 means LUN0 and
+                           LUN1 in all.)
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+  @retval Others           Fail to execute this request.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  )
+{
+  UINT8       Cdb[12];
+  UINT8       LunList[8 + 8 * (USB_BOT_MAX_LUN + 1)];
+  UINT8       *Entry;
+  UINT32      ListLen;
+  UINT32      Index;
+  UINT32      CmdStatus;
+  EFI_STATUS  Status;
+
+  if ((Context == NULL) || (MaxLun == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *MaxLun = 0;
+
+  ZeroMem (Cdb, sizeof (Cdb));
+  ZeroMem (LunList, sizeof (LunList));
+  Cdb[0] = USB_UAS_REPORT_LUNS_OPCODE;
+  WriteUnaligned32 ((UINT32 *)&Cdb[6], SwapBytes32 (sizeof (LunList)));
+
+  Status = UsbUasExecCommand (
+             Context,
+             Cdb,
+             sizeof (Cdb),
+             EfiUsbDataIn,
+             LunList,
+             sizeof (LunList),
+             0,
+             USB_BOOT_GENERAL_CMD_TIMEOUT,
+             &CmdStatus
+             );
+  if (EFI_ERROR (Status) || (CmdStatus != USB_MASS_CMD_SUCCESS)) {
+    //
+    // Like BOT, treat the device as a single LUN device on any error.
+    //
+    ((USB_UAS_PROTOCOL *)Context)->SenseValid = FALSE;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Only LUNs in single level peripheral device addressing are supported,
+  // which covers the LUN 0 to 15 numbering used by BOT devices as well.
+  //
+  ListLen = MIN (SwapBytes32 (ReadUnaligned32 ((UINT32 *)LunList)), sizeof (LunList) - 8);
+  for (Index = 0; Index < ListLen / 8; Index++) {
+    Entry = &LunList[8 + Index * 8];
+    if ((Entry[0] == 0) && (Entry[1] <= USB_BOT_MAX_LUN) && (Entry[1] > *MaxLun)) {
+      *MaxLun = Entry[1];
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  The streams are freed and the interface is switched back to the
+  alternate setting active before UAS was selected, so that the next
+  start finds the device as it was.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+  if (UsbUas->UsbIoAsyncBulk != NULL) {
+    UsbUasCancelTasks (UsbUas);
+    UsbUasFreeStreams (UsbUas);
+  }
+
+  if (UsbUas->PrevAltSetting != UsbUas->Interface.AlternateSetting) {
+    UsbUasSelectSetting (UsbUas, UsbUas->PrevAltSetting);
+  }
+
+  FreePool (Context);
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,348 @@
+/** @file
+  Definition for the USB Attached SCSI (UAS) transport, according to
+  "Universal Serial Bus Attached SCSI (UAS)" Revision 1.0, and the
+  T10 "USB Attached SCSI - 2 (UAS-2)" information unit formats.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_USBMASS_UAS_H_
+#define _EFI_USBMASS_UAS_H_
+
+extern USB_MASS_TRANSPORT  mUsbUasTransport;
+
+//
+// UAS pipe usage class specific descriptor, UAS 1.0 Section 5.3.3.1
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE  0x24
+#define USB_UAS_PIPE_ID_COMMAND       0x01 ///< Command pipe, bulk-out
+#define USB_UAS_PIPE_ID_STATUS        0x02 ///< Status pipe, bulk-in
+#define USB_UAS_PIPE_ID_DATA_IN       0x03 ///< Data-In pipe, bulk-in
+#define USB_UAS_PIPE_ID_DATA_OUT      0x04 ///< Data-Out pipe, bulk-out
+
+//
+// SuperSpeed endpoint companion descriptor, USB 3.1 Section 9.6.7.
+// A UAS device operating at SuperSpeed requires bulk streams, up to
+// 2^MaxStreams of them on each of the status and data pipes.
+//
+#define USB_UAS_DESC_TYPE_SS_EP_COMPANION  0x30
+#define USB_UAS_SS_MAX_STREAMS(Attr)  ((Attr) & 0x1F)
+
+//
+// UAS information unit IDs, UAS-2 Section 6.2
+//
+#define USB_UAS_IU_COMMAND      0x01
+#define USB_UAS_IU_SENSE        0x03
+#define USB_UAS_IU_RESPONSE     0x04
+#define USB_UAS_IU_TASK_MGMT    0x05
+#define USB_UAS_IU_READ_READY   0x06
+#define USB_UAS_IU_WRITE_READY  0x07
+
+//
+// Task management function and response codes, UAS-2 Section 6.2.5 / 6.2.4
+//
+#define USB_UAS_TMF_LOGICAL_UNIT_RESET  0x08
+#define USB_UAS_RC_TMF_COMPLETE         0x00
+#define USB_UAS_RC_TMF_SUCCEEDED        0x08
+
+//
+// SCSI status returned in the sense IU
+//
+#define USB_UAS_STATUS_GOOD             0x00
+#define USB_UAS_STATUS_CHECK_CONDITION  0x02
+
+//
+// Tag 0 is reserved, the task management IU uses tag 1, and commands use
+// the tags from USB_UAS_FIRST_CMD_TAG upwards. With streams, the status
+// and data of a command are carried on the stream whose ID is its tag,
+// so up to USB_UAS_MAX_QUEUED_CMDS commands are outstanding at a time.
+// Without streams only one command is outstanding.
+//
+#define USB_UAS_TASK_MGMT_TAG    0x0001
+#define USB_UAS_FIRST_CMD_TAG    0x0002
+#define USB_UAS_MAX_QUEUED_CMDS  8
+
+#define USB_UAS_MAX_CDBLEN       16
+#define USB_UAS_MAX_SENSELEN     18   ///< Fixed format sense data kept for REQUEST SENSE
+#define USB_UAS_MAX_IU_SENSELEN  252  ///< Largest sense data a sense IU may carry
+
+#define USB_UAS_REPORT_LUNS_OPCODE  0xA0
+
+//
+// UAS transport timeout, set by experience
+//
+#define USB_UAS_SEND_IU_TIMEOUT       (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RECV_IU_TIMEOUT       (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
+#define USB_UAS_RESET_DEVICE_STALL    (100 * USB_MASS_1_MILLISECOND)
+#define USB_UAS_ASYNC_POLL_INTERVAL   1
+
+#pragma pack(1)
+///
+/// UAS pipe usage descriptor.
+///
+typedef struct {
+  UINT8    Length;
+  UINT8    DescriptorType;
+  UINT8    PipeId;
+  UINT8    Reserved;
+} USB_UAS_PIPE_USAGE_DESCRIPTOR;
+
+///
+/// SuperSpeed endpoint companion descriptor.
+///
+typedef struct {
+  UINT8     Length;
+  UINT8     DescriptorType;
+  UINT8     MaxBurst;
+  UINT8     Attributes;
+  UINT16    BytesPerInterval;
+} USB_UAS_SS_EP_COMPANION_DESCRIPTOR;
+
+///
+/// The Command IU. Tag is big endian as all UAS multi-byte fields.
+///
+typedef struct {
+  UINT8     IuId;
+  UINT8     Reserved0;
+  UINT16    Tag;
+  UINT8     Attribute;        ///< Bits 2:0 task attribute, 0 ~ SIMPLE
+  UINT8     Reserved1;
+  UINT8     AddCdbLen;        ///< Bits 7:2, additional CDB length in dwords
+  UINT8     Reserved2;
+  UINT8     Lun[8];
+  UINT8     Cdb[USB_UAS_MAX_CDBLEN];
+} USB_UAS_COMMAND_IU;
+
+///
+/// The Task Management IU.
+///
+typedef struct {
+  UINT8     IuId;
+  UINT8     Reserved0;
+  UINT16    Tag;
+  UINT8     Function;
+  UINT8     Reserved1;
+  UINT16    TaskTag;
+  UINT8     Lun[8];
+} USB_UAS_TASK_MGMT_IU;
+
+///
+/// The common head of the IUs received from the status pipe.
+///
+typedef struct {
+  UINT8     IuId;
+  UINT8     Reserved;
+  UINT16    Tag;
+} USB_UAS_IU_HEADER;
+
+///
+/// The Sense IU.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT16               StatusQualifier;
+  UINT8                Status;
+  UINT8                Reserved[7];
+  UINT16               SenseLength;
+  UINT8                SenseData[USB_UAS_MAX_IU_SENSELEN];
+} USB_UAS_SENSE_IU;
+
+///
+/// The Response IU.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                AddResponseInfo[3];
+  UINT8                ResponseCode;
+} USB_UAS_RESPONSE_IU;
+
+///
+/// Any IU that may arrive on the status pipe.
+///
+typedef union {
+  USB_UAS_IU_HEADER      Header;
+  USB_UAS_SENSE_IU       Sense;
+  USB_UAS_RESPONSE_IU    Response;
+} USB_UAS_STATUS_IU;
+#pragma pack()
+
+///
+/// State of a status, data or command IU transfer queued on a stream.
+///
+typedef struct {
+  BOOLEAN    Done;
+  UINTN      Length;
+  UINT32     Result;
+} USB_UAS_ASYNC_TRANSFER;
+
+///
+/// A command queued on the streams of its tag.
+///
+typedef struct {
+  USB_MASS_COMMAND          *Command;   ///< NULL if the task is free
+  UINT16                    Tag;
+  USB_UAS_COMMAND_IU        CmdIu;
+  USB_UAS_STATUS_IU         StatusIu;
+  USB_UAS_ASYNC_TRANSFER    CmdTransfer;
+  USB_UAS_ASYNC_TRANSFER    DataTransfer;
+  USB_UAS_ASYNC_TRANSFER    StatusTransfer;
+} USB_UAS_TASK;
+
+typedef struct {
+  //
+  // Put Interface at the first field to make it easy to distinguish BOT/CBI/UAS Protocol instance
+  //
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;
+  UINT8                               CommandEndpoint;
+  UINT8                               StatusEndpoint;
+  UINT8                               DataInEndpoint;
+  UINT8                               DataOutEndpoint;
+  UINT8                               MaxStreams;       ///< Exponent from the SS companion descriptors, 0 without streams
+  UINT8                               PrevAltSetting;   ///< Alternate setting to restore on clean up
+  UINT16                              Tag;
+  //
+  // UAS always returns sense data with the failed command. Keep it for
+  // the REQUEST SENSE that the command set layer issues afterwards.
+  //
+  BOOLEAN                             SenseValid;
+  UINT8                               SenseData[USB_UAS_MAX_SENSELEN];
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *UsbIoAsyncBulk; ///< NULL if the pipes have no streams
+  UINT16                              QueueDepth;      ///< Commands queued at a time on the streams
+  USB_UAS_TASK                        Tasks[USB_UAS_MAX_QUEUED_CMDS];
+} USB_UAS_PROTOCOL;
+
+/**
+  Initializes USB UAS protocol.
+
+  This function looks for a UAS alternate setting of the current interface,
+  selects it and initializes the USB mass storage class UAS protocol.
+  It will save its context which is a USB_UAS_PROTOCOL structure
+  in the Context if Context isn't NULL. If Context is NULL, the alternate
+  setting is not changed.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Controller            The handle the USB I/O Protocol is installed on
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The transport protocol doesn't support the device.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  EFI_HANDLE           Controller,
+  OUT VOID                 **Context OPTIONAL
+  );
+
+/**
+  Call the USB Attached SCSI protocol to issue the command/data/status
+  information units to execute the commands.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  );
+
+/**
+  Execute several commands, queued together on the streams of the UAS
+  pipes if the device has them.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Commands              The commands to execute. CmdStatus of each
+                                command returns its result.
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are executed.
+  @retval Other                 Failed to execute some of the commands.
+
+**/
+EFI_STATUS
+UsbUasExecCommands (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  );
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management function.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  );
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN. (e.g. MaxLun=1 means LUN0 and
+                           LUN1 in all.)
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+  @retval Others           Fail to execute this request.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  );
+
+/**
+  Clean up the resource used by this UAS protocol.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  );
+
+#endif
@@ -0,0 +1,140 @@
+/** @file
+  The EDKII RAM Disk Extension Protocol registers sparse, chunked RAM disks.
+
+  A sparse RAM disk is described by a table of fixed size chunks instead of
+  one contiguous memory range. Chunks that only contain zeros need no backing
+  memory, and chunks may be kept compressed as GUIDed sections that are
+  decoded on demand by the handlers registered to ExtractGuidedSectionLib of
+  the producer (for example LzmaCustomDecompressLib). A sparse RAM disk has
+  no physical address range, so its device path ends with a vendor defined
+  media node instead of a RAM disk node, and it is not published to the NFIT.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_RAM_DISK_EX_H__
+#define __EDKII_RAM_DISK_EX_H__
+
+#include <Protocol/RamDisk.h>
+
+//
+// GUID for EDKII RAM Disk Extension Protocol
+//
+#define EDKII_RAM_DISK_EX_PROTOCOL_GUID \
+  { 0x72e17fd7, 0x2b6b, 0x40cd, { 0xb4, 0x26, 0x99, 0x95, 0x02, 0x69, 0x00, 0xb0 } }
+
+//
+// GUID of the vendor defined media device path node of a sparse RAM disk
+//
+#define EDKII_RAM_DISK_SPARSE_DEVICE_PATH_GUID \
+  { 0xe9662831, 0xb7e9, 0x4f5f, { 0xb5, 0xa3, 0x17, 0x62, 0x98, 0x58, 0xf4, 0x13 } }
+
+typedef struct _EDKII_RAM_DISK_EX_PROTOCOL EDKII_RAM_DISK_EX_PROTOCOL;
+
+#pragma pack(1)
+
+///
+/// The device path node of a sparse RAM disk, a MEDIA_VENDOR_DP node with
+/// EDKII_RAM_DISK_SPARSE_DEVICE_PATH_GUID.
+///
+typedef struct {
+  VENDOR_DEVICE_PATH    Header;
+  ///
+  /// The size of the RAM disk.
+  ///
+  UINT64                Size;
+  ///
+  /// The type of the RAM disk, as passed to RegisterSparse().
+  ///
+  EFI_GUID              TypeGuid;
+  ///
+  /// Tells the sparse RAM disks registered by the producer apart.
+  ///
+  UINT32                DiskId;
+} EDKII_RAM_DISK_SPARSE_DEVICE_PATH;
+
+#pragma pack()
+
+typedef enum {
+  ///
+  /// The chunk reads as zeros. Buffer and Length are ignored. Backing memory
+  /// is only allocated when non-zero data is written to the chunk.
+  ///
+  EdkiiRamDiskChunkZero,
+  ///
+  /// Buffer holds the chunk data uncompressed, Length is the chunk size.
+  /// Writes to the chunk go directly to Buffer.
+  ///
+  EdkiiRamDiskChunkRaw,
+  ///
+  /// Buffer holds an EFI_SECTION_GUID_DEFINED section of Length bytes that
+  /// decodes to the chunk data, e.g. an LZMA compressed section.
+  ///
+  EdkiiRamDiskChunkGuidedSection,
+  EdkiiRamDiskChunkTypeMax
+} EDKII_RAM_DISK_CHUNK_TYPE;
+
+typedef struct {
+  EDKII_RAM_DISK_CHUNK_TYPE    Type;
+  UINT32                       Length;
+  UINT64                       Buffer;
+} EDKII_RAM_DISK_CHUNK;
+
+/**
+  Register a sparse RAM disk made up of fixed size chunks.
+
+  Every chunk covers ChunkSize bytes of the disk, except the last one which
+  covers the remainder of RamDiskSize. The chunk table is copied, but the
+  memory referenced by the chunks is still owned by the caller and must stay
+  valid until the RAM disk is unregistered.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  ChunkSize      The size of each chunk, a power of two and a
+                             multiple of 512 bytes.
+  @param[in]  ChunkCount     The number of entries in Chunks.
+  @param[in]  Chunks         The chunk table describing the disk content.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device. It ends with an
+                             EDKII_RAM_DISK_SPARSE_DEVICE_PATH node. The buffer
+                             is allocated with the boot service AllocatePool().
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   DevicePath, Chunks or RamDiskType is NULL.
+                                  RamDiskSize is 0.
+                                  ChunkSize or ChunkCount does not match
+                                  RamDiskSize.
+                                  A chunk descriptor is malformed.
+  @retval EFI_UNSUPPORTED         No handler decodes a GUIDed section chunk.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_RAM_DISK_REGISTER_SPARSE)(
+  IN UINT64                      RamDiskSize,
+  IN UINT32                      ChunkSize,
+  IN UINTN                       ChunkCount,
+  IN CONST EDKII_RAM_DISK_CHUNK  *Chunks,
+  IN EFI_GUID                    *RamDiskType,
+  IN EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL   **DevicePath
+  );
+
+struct _EDKII_RAM_DISK_EX_PROTOCOL {
+  EDKII_RAM_DISK_REGISTER_SPARSE     RegisterSparse;
+  EFI_RAM_DISK_UNREGISTER_RAMDISK    Unregister;
+};
+
+extern EFI_GUID  gEdkiiRamDiskExProtocolGuid;
+extern EFI_GUID  gEdkiiRamDiskSparseDevicePathGuid;
+
+#endif
@@ -0,0 +1,108 @@
+/** @file
+  The EDKII Simple Network Batch Protocol transmits and recycles packets in
+  batches.
+
+  The protocol is installed by a Simple Network Protocol driver on the handle
+  of the EFI_SIMPLE_NETWORK_PROTOCOL instance it extends. Transmit() places
+  several packets on the transmit queue and notifies the device once for all
+  of them, GetStatus() returns several recycled transmit buffers in one call.
+  Both work on the queues of the EFI_SIMPLE_NETWORK_PROTOCOL instance, so a
+  buffer transmitted by one protocol can be recycled by the other.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_SIMPLE_NETWORK_BATCH_H__
+#define __EDKII_SIMPLE_NETWORK_BATCH_H__
+
+#include <Protocol/SimpleNetwork.h>
+
+//
+// GUID for EDKII Simple Network Batch Protocol
+//
+#define EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL_GUID \
+  { 0xe29d1e00, 0x1408, 0x4e0f, { 0x93, 0x10, 0x7c, 0xff, 0xb9, 0x0b, 0xd9, 0x03 } }
+
+typedef struct _EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL;
+
+///
+/// A packet to transmit, the parameters of EFI_SIMPLE_NETWORK_PROTOCOL.Transmit().
+///
+typedef struct {
+  UINTN              HeaderSize;
+  UINTN              BufferSize;
+  VOID               *Buffer;
+  EFI_MAC_ADDRESS    *SrcAddr;  ///< Optional.
+  EFI_MAC_ADDRESS    *DestAddr; ///< Optional.
+  UINT16             *Protocol; ///< Optional.
+} EDKII_SIMPLE_NETWORK_TX_PACKET;
+
+/**
+  Places packets in the transmit queue of a network interface.
+
+  The packets are placed in order, with the same rules as
+  EFI_SIMPLE_NETWORK_PROTOCOL.Transmit(). The device is notified once after
+  the last packet is placed. If a packet can't be placed, the packets after
+  it are not placed either.
+
+  @param[in]      This             Pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param[in, out] PacketCount      On input, the number of packets in Packets. On output,
+                                   the number of packets placed on the transmit queue.
+  @param[in]      Packets          The packets to transmit.
+
+  @retval EFI_SUCCESS              All the packets were placed on the transmit queue.
+  @retval EFI_NOT_READY            The transmit queue is full, *PacketCount packets
+                                   were placed.
+  @retval EFI_INVALID_PARAMETER    This, PacketCount or Packets is NULL, or *PacketCount is 0.
+  @retval Others                   The error returned by EFI_SIMPLE_NETWORK_PROTOCOL.Transmit()
+                                   for the packet at index *PacketCount. The packets before
+                                   it were placed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_BATCH_TRANSMIT)(
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  IN OUT UINTN                                *PacketCount,
+  IN     EDKII_SIMPLE_NETWORK_TX_PACKET       *Packets
+  );
+
+/**
+  Reads the current interrupt status and the recycled transmit buffers from
+  a network interface.
+
+  @param[in]      This             Pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param[out]     InterruptStatus  The interrupt status as returned by
+                                   EFI_SIMPLE_NETWORK_PROTOCOL.GetStatus(). If this is NULL,
+                                   the interrupt status is not read.
+  @param[in, out] TxBufCount       On input, the number of entries in TxBuf. On output, the
+                                   number of recycled transmit buffers returned. This is
+                                   also set if an error is returned, the buffers returned
+                                   are recycled and belong to the caller either way.
+  @param[out]     TxBuf            The recycled transmit buffer addresses.
+
+  @retval EFI_SUCCESS              The status of the network interface was retrieved.
+  @retval EFI_NOT_STARTED          The network interface has not been started.
+  @retval EFI_INVALID_PARAMETER    This, TxBufCount or TxBuf is NULL, or *TxBufCount is 0.
+  @retval EFI_DEVICE_ERROR         The command could not be sent to the network interface.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_BATCH_GET_STATUS)(
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  OUT    UINT32                               *InterruptStatus OPTIONAL,
+  IN OUT UINTN                                *TxBufCount,
+  OUT    VOID                                 **TxBuf
+  );
+
+struct _EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL {
+  EDKII_SIMPLE_NETWORK_BATCH_TRANSMIT      Transmit;
+  EDKII_SIMPLE_NETWORK_BATCH_GET_STATUS    GetStatus;
+};
+
+extern EFI_GUID  gEdkiiSimpleNetworkBatchProtocolGuid;
+
+#endif
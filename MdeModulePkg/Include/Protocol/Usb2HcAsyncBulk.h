@@ -0,0 +1,206 @@
+/** @file
+  The EDKII USB2 Host Controller Async Bulk Protocol queues bulk transfers.
+
+  The protocol is installed by a USB host controller driver on the handle of
+  the EFI_USB2_HC_PROTOCOL instance it extends. Submit() places a bulk
+  transfer on the transfer ring of an endpoint and returns without waiting
+  for it, so several transfers can be outstanding on one endpoint and on
+  several endpoints of one device at the same time. The transfers of an
+  endpoint complete in the order they were submitted, each completion calls
+  the callback given to Submit().
+
+  A SuperSpeed bulk endpoint can also be given streams by AllocateStreams().
+  Each stream has its own queue of transfers, selected by its stream ID in
+  Submit(), and the device chooses which stream it serves next. This is what
+  lets a USB Attached SCSI device have several commands outstanding.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_USB2_HC_ASYNC_BULK_H__
+#define __EDKII_USB2_HC_ASYNC_BULK_H__
+
+#include <Protocol/Usb2HostController.h>
+
+//
+// GUID for EDKII USB2 Host Controller Async Bulk Protocol
+//
+#define EDKII_USB2_HC_ASYNC_BULK_PROTOCOL_GUID \
+  { 0x95eff69b, 0x3c34, 0x4b8e, { 0xbc, 0x10, 0x78, 0x74, 0x3f, 0xa0, 0xb3, 0x77 } }
+
+typedef struct _EDKII_USB2_HC_ASYNC_BULK_PROTOCOL EDKII_USB2_HC_ASYNC_BULK_PROTOCOL;
+
+/**
+  Queues a bulk transfer on an endpoint of a USB device.
+
+  The transfer is started as soon as the transfers submitted before it on the
+  same endpoint are done. When it completes, fails or is cancelled, Callback
+  is called with Data, the number of bytes transferred, Context and the
+  EFI_USB_ERR_* result of the transfer. Callback is called from Poll(), or at
+  TPL_NOTIFY from the periodic timer of the host controller driver. Data must
+  stay valid until Callback has been called.
+
+  If an endpoint halts, the transfers queued behind the failed one on the
+  same stream are completed with EFI_USB_ERR_NOTEXECUTE, and the endpoint is
+  made ready for new transfers once the caller has cleared the halt on the
+  device.
+
+  @param[in]  This                 Pointer to the EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceAddress        Represents the address of the target device on the USB.
+  @param[in]  EndPointAddress      The combination of an endpoint number and an endpoint
+                                   direction of the target USB device.
+  @param[in]  StreamId             The stream to queue the transfer on, from 1 to the number
+                                   of streams of the endpoint. 0 if the endpoint doesn't
+                                   use streams.
+  @param[in]  DeviceSpeed          Indicates device speed.
+  @param[in]  MaximumPacketLength  Maximum packet size the target endpoint is capable of
+                                   sending or receiving.
+  @param[in]  Data                 The data buffer to be transmitted or received.
+  @param[in]  DataLength           The size, in bytes, of the data buffer.
+  @param[in]  Translator           A pointer to the transaction translator data.
+  @param[in]  CallBackFunction     The function called when the transfer is done.
+  @param[in]  Context              Data passed to CallBackFunction. Optional.
+
+  @retval EFI_SUCCESS              The transfer was queued.
+  @retval EFI_NOT_READY            The transfer ring of the endpoint or of the stream is full.
+                                   Retry after some of the queued transfers have completed.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES     The transfer could not be queued due to a lack of resources.
+  @retval EFI_DEVICE_ERROR         The host controller or the device is in an error state.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_ASYNC_BULK_SUBMIT)(
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL   *This,
+  IN UINT8                               DeviceAddress,
+  IN UINT8                               EndPointAddress,
+  IN UINT16                              StreamId,
+  IN UINT8                               DeviceSpeed,
+  IN UINTN                               MaximumPacketLength,
+  IN VOID                                *Data,
+  IN UINTN                               DataLength,
+  IN EFI_USB2_HC_TRANSACTION_TRANSLATOR  *Translator,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK     CallBackFunction,
+  IN VOID                                *Context OPTIONAL
+  );
+
+/**
+  Cancels the bulk transfers queued on an endpoint of a USB device, or on one
+  stream of the endpoint.
+
+  The endpoint is stopped and the callback of every cancelled transfer is
+  called before this function returns. A transfer that had already completed
+  keeps its result, the other transfers, including one that was stopped while
+  in progress, complete with EFI_USB_ERR_NOTEXECUTE. The transfers of the
+  other streams of the endpoint are resumed.
+
+  @param[in]  This                 Pointer to the EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceAddress        Represents the address of the target device on the USB.
+  @param[in]  EndPointAddress      The combination of an endpoint number and an endpoint
+                                   direction of the target USB device.
+  @param[in]  StreamId             The stream whose transfers are cancelled, or 0 for all
+                                   the transfers of the endpoint.
+
+  @retval EFI_SUCCESS              The transfers were cancelled, or none was queued.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR         The endpoint could not be stopped.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_ASYNC_BULK_CANCEL)(
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress,
+  IN UINT16                             StreamId
+  );
+
+/**
+  Processes the completed bulk transfers of the host controller and calls
+  their callbacks.
+
+  @param[in]  This                 Pointer to the EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+
+  @retval EFI_SUCCESS              The completed transfers were processed.
+  @retval EFI_INVALID_PARAMETER    This is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_ASYNC_BULK_POLL)(
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This
+  );
+
+/**
+  Gives streams to a bulk endpoint of a USB device.
+
+  The endpoint must have no transfer queued. Once it has streams, every
+  transfer submitted to it selects a stream, and transfers without a stream
+  are rejected until FreeStreams() is called. The streams are freed
+  implicitly when the device is detached or its interface setting changes.
+
+  @param[in]      This             Pointer to the EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param[in]      DeviceAddress    Represents the address of the target device on the USB.
+  @param[in]      EndPointAddress  The combination of an endpoint number and an endpoint
+                                   direction of the target USB device.
+  @param[in, out] NumberOfStreams  On input, the number of streams wanted, not larger than
+                                   the endpoint supports. On output, the number of streams
+                                   given, with stream IDs from 1 to NumberOfStreams. It may
+                                   be lower or higher than wanted.
+
+  @retval EFI_SUCCESS              The endpoint has streams.
+  @retval EFI_UNSUPPORTED          The host controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED      The endpoint already has streams.
+  @retval EFI_NOT_READY            Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES     The streams could not be allocated.
+  @retval EFI_DEVICE_ERROR         The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_ASYNC_BULK_ALLOCATE_STREAMS)(
+  IN     EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                              DeviceAddress,
+  IN     UINT8                              EndPointAddress,
+  IN OUT UINT16                             *NumberOfStreams
+  );
+
+/**
+  Frees the streams of a bulk endpoint of a USB device. The endpoint must
+  have no transfer queued.
+
+  @param[in]  This                 Pointer to the EDKII_USB2_HC_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceAddress        Represents the address of the target device on the USB.
+  @param[in]  EndPointAddress      The combination of an endpoint number and an endpoint
+                                   direction of the target USB device.
+
+  @retval EFI_SUCCESS              The streams were freed.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid.
+  @retval EFI_NOT_FOUND            The endpoint has no streams.
+  @retval EFI_NOT_READY            Transfers are queued on the streams.
+  @retval EFI_DEVICE_ERROR         The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_ASYNC_BULK_FREE_STREAMS)(
+  IN EDKII_USB2_HC_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                              DeviceAddress,
+  IN UINT8                              EndPointAddress
+  );
+
+struct _EDKII_USB2_HC_ASYNC_BULK_PROTOCOL {
+  EDKII_USB2_HC_ASYNC_BULK_SUBMIT              Submit;
+  EDKII_USB2_HC_ASYNC_BULK_CANCEL              Cancel;
+  EDKII_USB2_HC_ASYNC_BULK_POLL                Poll;
+  EDKII_USB2_HC_ASYNC_BULK_ALLOCATE_STREAMS    AllocateStreams;
+  EDKII_USB2_HC_ASYNC_BULK_FREE_STREAMS        FreeStreams;
+};
+
+extern EFI_GUID  gEdkiiUsb2HcAsyncBulkProtocolGuid;
+
+#endif
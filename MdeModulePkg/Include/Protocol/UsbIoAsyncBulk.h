@@ -0,0 +1,175 @@
+/** @file
+  The EDKII USB I/O Async Bulk Protocol queues bulk transfers.
+
+  The protocol is installed by the USB bus driver on the handle of an
+  EFI_USB_IO_PROTOCOL instance when the host controller of the device
+  produces the EDKII USB2 Host Controller Async Bulk Protocol. It lets the
+  driver of a USB interface keep several bulk transfers outstanding on the
+  bulk endpoints of the interface, for example the command, data and status
+  stages of a mass storage command. On a SuperSpeed device the bulk endpoints
+  can also be given streams, one queue of transfers per stream ID, as used
+  by USB Attached SCSI to keep several commands outstanding.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_USB_IO_ASYNC_BULK_H__
+#define __EDKII_USB_IO_ASYNC_BULK_H__
+
+#include <Protocol/UsbIo.h>
+
+//
+// GUID for EDKII USB I/O Async Bulk Protocol
+//
+#define EDKII_USB_IO_ASYNC_BULK_PROTOCOL_GUID \
+  { 0x55e498c7, 0xd75f, 0x42af, { 0x93, 0x48, 0x66, 0xff, 0x2f, 0x9a, 0xef, 0x91 } }
+
+typedef struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL EDKII_USB_IO_ASYNC_BULK_PROTOCOL;
+
+/**
+  Queues a bulk transfer on a bulk endpoint of the USB interface.
+
+  Callback is called with Data, the number of bytes transferred, Context and
+  the EFI_USB_ERR_* result of the transfer once the transfer is done. It is
+  called from Poll(), or at TPL_NOTIFY from the host controller driver. Data
+  must stay valid until Callback has been called. After a transfer fails
+  with EFI_USB_ERR_STALL the transfers queued behind it on the endpoint, or
+  on its stream, complete with EFI_USB_ERR_NOTEXECUTE, and the caller clears
+  the halt of the endpoint before submitting new transfers to it.
+
+  @param[in]  This                 Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceEndpoint       The destination USB device endpoint to which the
+                                   device request is being sent.
+  @param[in]  StreamId             The stream to queue the transfer on, from 1 to the number
+                                   of streams of the endpoint. 0 if the endpoint has no
+                                   streams.
+  @param[in]  Data                 The data buffer to be transmitted or received.
+  @param[in]  DataLength           The size, in bytes, of the data buffer.
+  @param[in]  Callback             The function called when the transfer is done.
+  @param[in]  Context              Data passed to Callback. Optional.
+
+  @retval EFI_SUCCESS              The transfer was queued.
+  @retval EFI_NOT_READY            The transfer queue of the endpoint or of the stream is full.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid, or DeviceEndpoint is not a
+                                   bulk endpoint of the interface.
+  @retval EFI_OUT_OF_RESOURCES     The transfer could not be queued due to a lack of resources.
+  @retval EFI_DEVICE_ERROR         The host controller or the device is in an error state.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_SUBMIT)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             DeviceEndpoint,
+  IN UINT16                            StreamId,
+  IN VOID                              *Data,
+  IN UINTN                             DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK   Callback,
+  IN VOID                              *Context OPTIONAL
+  );
+
+/**
+  Cancels the bulk transfers queued on a bulk endpoint of the USB interface,
+  or on one stream of the endpoint.
+
+  The callback of every cancelled transfer is called before this function
+  returns. The transfers of the other streams of the endpoint stay queued.
+
+  @param[in]  This                 Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceEndpoint       The endpoint whose transfers are cancelled.
+  @param[in]  StreamId             The stream whose transfers are cancelled, or 0 for all
+                                   the transfers of the endpoint.
+
+  @retval EFI_SUCCESS              The transfers were cancelled, or none was queued.
+  @retval EFI_INVALID_PARAMETER    DeviceEndpoint is not a bulk endpoint of the interface.
+  @retval EFI_DEVICE_ERROR         The endpoint could not be stopped.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_CANCEL)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             DeviceEndpoint,
+  IN UINT16                            StreamId
+  );
+
+/**
+  Processes the completed bulk transfers and calls their callbacks.
+
+  @param[in]  This                 Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+
+  @retval EFI_SUCCESS              The completed transfers were processed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_POLL)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This
+  );
+
+/**
+  Gives streams to a bulk endpoint of the USB interface.
+
+  The endpoint must have no transfer queued. The number of streams wanted
+  must not be larger than the endpoint supports, as given by the MaxStreams
+  field of its SuperSpeed Endpoint Companion descriptor. The streams are
+  freed implicitly when the alternate setting of the interface changes.
+
+  @param[in]      This             Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]      DeviceEndpoint   The endpoint to give streams to.
+  @param[in, out] NumberOfStreams  On input, the number of streams wanted. On output, the
+                                   number of streams given, with stream IDs from 1 to
+                                   NumberOfStreams. It may be lower or higher than wanted.
+
+  @retval EFI_SUCCESS              The endpoint has streams.
+  @retval EFI_UNSUPPORTED          The host controller doesn't support streams.
+  @retval EFI_INVALID_PARAMETER    Some parameters are invalid, or DeviceEndpoint is not a
+                                   bulk endpoint of the interface.
+  @retval EFI_ALREADY_STARTED      The endpoint already has streams.
+  @retval EFI_NOT_READY            Transfers are queued on the endpoint.
+  @retval EFI_OUT_OF_RESOURCES     The streams could not be allocated.
+  @retval EFI_DEVICE_ERROR         The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_ALLOCATE_STREAMS)(
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             DeviceEndpoint,
+  IN OUT UINT16                            *NumberOfStreams
+  );
+
+/**
+  Frees the streams of a bulk endpoint of the USB interface. The endpoint
+  must have no transfer queued.
+
+  @param[in]  This                 Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DeviceEndpoint       The endpoint whose streams are freed.
+
+  @retval EFI_SUCCESS              The streams were freed.
+  @retval EFI_INVALID_PARAMETER    DeviceEndpoint is not a bulk endpoint of the interface.
+  @retval EFI_NOT_FOUND            The endpoint has no streams.
+  @retval EFI_NOT_READY            Transfers are queued on the streams.
+  @retval EFI_DEVICE_ERROR         The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_FREE_STREAMS)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             DeviceEndpoint
+  );
+
+struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL {
+  EDKII_USB_IO_ASYNC_BULK_SUBMIT              Submit;
+  EDKII_USB_IO_ASYNC_BULK_CANCEL              Cancel;
+  EDKII_USB_IO_ASYNC_BULK_POLL                Poll;
+  EDKII_USB_IO_ASYNC_BULK_ALLOCATE_STREAMS    AllocateStreams;
+  EDKII_USB_IO_ASYNC_BULK_FREE_STREAMS        FreeStreams;
+};
+
+extern EFI_GUID  gEdkiiUsbIoAsyncBulkProtocolGuid;
+
+#endif
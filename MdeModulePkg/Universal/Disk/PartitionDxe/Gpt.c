@@ -21,6 +21,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Partition.h"
 
+//
+// Time in microseconds to wait for the prefetched backup header, and the
+// interval at which its completion is polled.
+//
+#define PARTITION_GPT_READ_TIMEOUT        5000000
+#define PARTITION_GPT_READ_POLL_INTERVAL  100
+
 /**
   Install child handles if the Handle supports GPT partition structure.
 
@@ -45,6 +52,37 @@ PartitionValidGptTable (
   OUT EFI_PARTITION_TABLE_HEADER  *PartHeader
   );
 
+/**
+  Validate a GPT partition table header that has already been read from the
+  disk, and the partition entry array it describes.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The Lba the header block was read from.
+  @param[in]  PartHdr     The header block read from Lba.
+  @param[out] PartHeader  Stores the partition table that is read
+  @param[out] PartEntry   If not NULL, returns the partition entry array
+                          read for the CRC check when the table is valid.
+                          The caller frees it.
+
+  @retval TRUE      The partition table is valid
+  @retval FALSE     The partition table is not valid
+
+**/
+BOOLEAN
+PartitionValidGptHeader (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHdr,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT VOID                        **PartEntry OPTIONAL
+  );
+
 /**
   Check if the CRC field in the Partition table header is valid
   for Partition entry array.
@@ -52,6 +90,8 @@ PartitionValidGptTable (
   @param[in]  BlockIo     Parent BlockIo interface
   @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[out] PartEntry   If not NULL, returns the partition entry array
+                          when the CRC is valid. The caller frees it.
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -61,7 +101,54 @@ BOOLEAN
 PartitionCheckGptEntryArrayCRC (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT VOID                        **PartEntry OPTIONAL
+  );
+
+/**
+  Start reading one block of the disk without waiting for the data.
+
+  @param[in]  DiskIo2     Parent DiskIo2 interface.
+  @param[in]  MediaId     Id of the media.
+  @param[in]  Lba         The Lba to read.
+  @param[in]  BlockSize   The block size of the media.
+  @param[out] Token       The token of the read. The token and Buffer share
+                          one pool allocation which is freed through Token.
+  @param[out] Buffer      The buffer receiving the block.
+
+  @retval TRUE      The read was started, PartitionWaitGptBlock() must be
+                    called before Buffer is used.
+  @retval FALSE     The read was not started.
+
+**/
+BOOLEAN
+PartitionStartGptBlockRead (
+  IN  EFI_DISK_IO2_PROTOCOL  *DiskIo2,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINT32                 BlockSize,
+  OUT EFI_DISK_IO2_TOKEN     **Token,
+  OUT VOID                   **Buffer
+  );
+
+/**
+  Wait for a read started by PartitionStartGptBlockRead() to complete.
+
+  If the read does not complete within PARTITION_GPT_READ_TIMEOUT, it is
+  cancelled. If it is still outstanding after that, the token and the buffer
+  are left allocated for the request and *Token is set to NULL.
+
+  @param[in]      DiskIo2 Parent DiskIo2 interface.
+  @param[in, out] Token   The token of the read.
+
+  @retval EFI_TIMEOUT     The read did not complete in time.
+  @return The transaction status of the read.
+
+**/
+EFI_STATUS
+PartitionWaitGptBlock (
+  IN     EFI_DISK_IO2_PROTOCOL  *DiskIo2,
+  IN OUT EFI_DISK_IO2_TOKEN     **Token
   );
 
 /**
@@ -207,12 +294,18 @@ PartitionInstallGptChildHandles (
   HARDDRIVE_DEVICE_PATH        HdDev;
   UINT32                       MediaId;
   EFI_PARTITION_INFO_PROTOCOL  PartitionInfo;
+  EFI_DISK_IO2_TOKEN           *BackupToken;
+  EFI_PARTITION_TABLE_HEADER   *BackupBlock;
+  BOOLEAN                      PrimaryValid;
+  BOOLEAN                      BackupValid;
 
   ProtectiveMbr = NULL;
   PrimaryHeader = NULL;
   BackupHeader  = NULL;
   PartEntry     = NULL;
   PEntryStatus  = NULL;
+  BackupToken   = NULL;
+  BackupBlock   = NULL;
 
   BlockSize = BlockIo->Media->BlockSize;
   LastBlock = BlockIo->Media->LastBlock;
@@ -224,28 +317,29 @@ PartitionInstallGptChildHandles (
   GptValidStatus = EFI_NOT_FOUND;
 
   //
-  // Ensure the block size can hold the MBR
+  // Ensure the block size can hold the MBR, and the disk the primary header
   //
-  if (BlockSize < sizeof (MASTER_BOOT_RECORD)) {
+  if ((BlockSize < sizeof (MASTER_BOOT_RECORD)) || (LastBlock < PRIMARY_PART_HEADER_LBA)) {
     return EFI_NOT_FOUND;
   }
 
   //
-  // Allocate a buffer for the Protective MBR
+  // Allocate a buffer for the Protective MBR and the primary header
   //
-  ProtectiveMbr = AllocatePool (BlockSize);
+  ProtectiveMbr = AllocatePool (BlockSize * (PRIMARY_PART_HEADER_LBA + 1));
   if (ProtectiveMbr == NULL) {
     return EFI_NOT_FOUND;
   }
 
   //
-  // Read the Protective MBR from LBA #0
+  // Read the Protective MBR from LBA #0 together with the primary header,
+  // saving a separate read of the header on GPT disks
   //
   Status = DiskIo->ReadDisk (
                      DiskIo,
                      MediaId,
                      0,
-                     BlockSize,
+                     BlockSize * (PRIMARY_PART_HEADER_LBA + 1),
                      ProtectiveMbr
                      );
   if (EFI_ERROR (Status)) {
@@ -269,6 +363,15 @@ PartitionInstallGptChildHandles (
     goto Done;
   }
 
+  //
+  // The backup header normally is at the far end of the disk. If DiskIo2 is
+  // available, fetch it while the primary entry array is read, so that both
+  // reads overlap.
+  //
+  if (DiskIo2 != NULL) {
+    PartitionStartGptBlockRead (DiskIo2, MediaId, LastBlock, BlockSize, &BackupToken, (VOID **)&BackupBlock);
+  }
+
   //
   // Allocate the GPT structures
   //
@@ -283,12 +386,38 @@ PartitionInstallGptChildHandles (
   }
 
   //
-  // Check primary and backup partition tables
+  // Check primary and backup partition tables. The entry array of a valid
+  // primary table is kept from the CRC check.
+  //
+  PrimaryValid = PartitionValidGptHeader (
+                   BlockIo,
+                   DiskIo,
+                   PRIMARY_PART_HEADER_LBA,
+                   (EFI_PARTITION_TABLE_HEADER *)((UINT8 *)ProtectiveMbr + BlockSize * PRIMARY_PART_HEADER_LBA),
+                   PrimaryHeader,
+                   (VOID **)&PartEntry
+                   );
+
   //
-  if (!PartitionValidGptTable (BlockIo, DiskIo, PRIMARY_PART_HEADER_LBA, PrimaryHeader)) {
+  // Use the prefetched block if the backup header is where it is expected.
+  //
+  if ((BackupToken != NULL) && !EFI_ERROR (PartitionWaitGptBlock (DiskIo2, &BackupToken)) &&
+      (!PrimaryValid || (PrimaryHeader->AlternateLBA == LastBlock)))
+  {
+    BackupValid = PartitionValidGptHeader (BlockIo, DiskIo, LastBlock, BackupBlock, BackupHeader, NULL);
+  } else {
+    BackupValid = PartitionValidGptTable (
+                    BlockIo,
+                    DiskIo,
+                    PrimaryValid ? PrimaryHeader->AlternateLBA : LastBlock,
+                    BackupHeader
+                    );
+  }
+
+  if (!PrimaryValid) {
     DEBUG ((DEBUG_INFO, " Not Valid primary partition table\n"));
 
-    if (!PartitionValidGptTable (BlockIo, DiskIo, LastBlock, BackupHeader)) {
+    if (!BackupValid) {
       DEBUG ((DEBUG_INFO, " Not Valid backup partition table\n"));
       goto Done;
     } else {
@@ -302,7 +431,7 @@ PartitionInstallGptChildHandles (
         DEBUG ((DEBUG_INFO, " Restore backup partition table success\n"));
       }
     }
-  } else if (!PartitionValidGptTable (BlockIo, DiskIo, PrimaryHeader->AlternateLBA, BackupHeader)) {
+  } else if (!BackupValid) {
     DEBUG ((DEBUG_INFO, " Valid primary and !Valid backup partition table\n"));
     DEBUG ((DEBUG_INFO, " Restore backup partition table by the primary\n"));
     if (!PartitionRestoreGptTable (BlockIo, DiskIo, PrimaryHeader)) {
@@ -317,25 +446,28 @@ PartitionInstallGptChildHandles (
   DEBUG ((DEBUG_INFO, " Valid primary and Valid backup partition table\n"));
 
   //
-  // Read the EFI Partition Entries
+  // Read the EFI Partition Entries, unless they were kept from validating the
+  // primary partition table
   //
-  PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
   if (PartEntry == NULL) {
-    DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
-    goto Done;
-  }
+    PartEntry = AllocatePool (PrimaryHeader->NumberOfPartitionEntries * PrimaryHeader->SizeOfPartitionEntry);
+    if (PartEntry == NULL) {
+      DEBUG ((DEBUG_ERROR, "Allocate pool error\n"));
+      goto Done;
+    }
 
-  Status = DiskIo->ReadDisk (
-                     DiskIo,
-                     MediaId,
-                     MultU64x32 (PrimaryHeader->PartitionEntryLBA, BlockSize),
-                     PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
-                     PartEntry
-                     );
-  if (EFI_ERROR (Status)) {
-    GptValidStatus = Status;
-    DEBUG ((DEBUG_ERROR, " Partition Entry ReadDisk error\n"));
-    goto Done;
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       MediaId,
+                       MultU64x32 (PrimaryHeader->PartitionEntryLBA, BlockSize),
+                       PrimaryHeader->NumberOfPartitionEntries * (PrimaryHeader->SizeOfPartitionEntry),
+                       PartEntry
+                       );
+    if (EFI_ERROR (Status)) {
+      GptValidStatus = Status;
+      DEBUG ((DEBUG_ERROR, " Partition Entry ReadDisk error\n"));
+      goto Done;
+    }
   }
 
   DEBUG ((DEBUG_INFO, " Partition entries read block success\n"));
@@ -424,6 +556,22 @@ PartitionInstallGptChildHandles (
   DEBUG ((DEBUG_INFO, "Prepare to Free Pool\n"));
 
 Done:
+  if (BackupToken != NULL) {
+    //
+    // The prefetch is still in flight if no GPT structures were allocated.
+    //
+    if (BackupToken->Event != NULL) {
+      PartitionWaitGptBlock (DiskIo2, &BackupToken);
+    }
+
+    //
+    // BackupBlock shares the allocation of the token.
+    //
+    if (BackupToken != NULL) {
+      FreePool (BackupToken);
+    }
+  }
+
   if (ProtectiveMbr != NULL) {
     FreePool (ProtectiveMbr);
   }
@@ -475,6 +623,7 @@ PartitionValidGptTable (
   UINT32                      BlockSize;
   EFI_PARTITION_TABLE_HEADER  *PartHdr;
   UINT32                      MediaId;
+  BOOLEAN                     Valid;
 
   BlockSize = BlockIo->Media->BlockSize;
   MediaId   = BlockIo->Media->MediaId;
@@ -500,14 +649,49 @@ PartitionValidGptTable (
     return FALSE;
   }
 
+  Valid = PartitionValidGptHeader (BlockIo, DiskIo, Lba, PartHdr, PartHeader, NULL);
+  FreePool (PartHdr);
+  return Valid;
+}
+
+/**
+  Validate a GPT partition table header that has already been read from the
+  disk, and the partition entry array it describes.
+
+  Caution: This function may receive untrusted input.
+  The GPT partition table header is external input, so this routine
+  will do basic validation for GPT partition table header before return.
+
+  @param[in]  BlockIo     Parent BlockIo interface.
+  @param[in]  DiskIo      Disk Io protocol.
+  @param[in]  Lba         The Lba the header block was read from.
+  @param[in]  PartHdr     The header block read from Lba.
+  @param[out] PartHeader  Stores the partition table that is read
+  @param[out] PartEntry   If not NULL, returns the partition entry array
+                          read for the CRC check when the table is valid.
+                          The caller frees it.
+
+  @retval TRUE      The partition table is valid
+  @retval FALSE     The partition table is not valid
+
+**/
+BOOLEAN
+PartitionValidGptHeader (
+  IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
+  IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
+  IN  EFI_LBA                     Lba,
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHdr,
+  OUT EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT VOID                        **PartEntry OPTIONAL
+  )
+{
   if ((PartHdr->Header.Signature != EFI_PTAB_HEADER_ID) ||
-      !PartitionCheckCrc (BlockSize, &PartHdr->Header) ||
+      !PartitionCheckCrc (BlockIo->Media->BlockSize, &PartHdr->Header) ||
       (PartHdr->MyLBA != Lba) ||
       (PartHdr->SizeOfPartitionEntry < sizeof (EFI_PARTITION_ENTRY))
       )
   {
     DEBUG ((DEBUG_INFO, "Invalid efi partition table header\n"));
-    FreePool (PartHdr);
     return FALSE;
   }
 
@@ -515,18 +699,15 @@ PartitionValidGptTable (
   // Ensure the NumberOfPartitionEntries * SizeOfPartitionEntry doesn't overflow.
   //
   if (PartHdr->NumberOfPartitionEntries > DivU64x32 (MAX_UINTN, PartHdr->SizeOfPartitionEntry)) {
-    FreePool (PartHdr);
     return FALSE;
   }
 
   CopyMem (PartHeader, PartHdr, sizeof (EFI_PARTITION_TABLE_HEADER));
-  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader)) {
-    FreePool (PartHdr);
+  if (!PartitionCheckGptEntryArrayCRC (BlockIo, DiskIo, PartHeader, PartEntry)) {
     return FALSE;
   }
 
   DEBUG ((DEBUG_INFO, " Valid efi partition table header\n"));
-  FreePool (PartHdr);
   return TRUE;
 }
 
@@ -537,6 +718,8 @@ PartitionValidGptTable (
   @param[in]  BlockIo     Parent BlockIo interface
   @param[in]  DiskIo      Disk Io Protocol.
   @param[in]  PartHeader  Partition table header structure
+  @param[out] PartEntry   If not NULL, returns the partition entry array
+                          when the CRC is valid. The caller frees it.
 
   @retval TRUE      the CRC is valid
   @retval FALSE     the CRC is invalid
@@ -546,7 +729,8 @@ BOOLEAN
 PartitionCheckGptEntryArrayCRC (
   IN  EFI_BLOCK_IO_PROTOCOL       *BlockIo,
   IN  EFI_DISK_IO_PROTOCOL        *DiskIo,
-  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader
+  IN  EFI_PARTITION_TABLE_HEADER  *PartHeader,
+  OUT VOID                        **PartEntry OPTIONAL
   )
 {
   EFI_STATUS  Status;
@@ -584,11 +768,137 @@ PartitionCheckGptEntryArrayCRC (
     return FALSE;
   }
 
+  if ((PartEntry != NULL) && (PartHeader->PartitionEntryArrayCRC32 == Crc)) {
+    *PartEntry = Ptr;
+    return TRUE;
+  }
+
   FreePool (Ptr);
 
   return (BOOLEAN)(PartHeader->PartitionEntryArrayCRC32 == Crc);
 }
 
+/**
+  Start reading one block of the disk without waiting for the data.
+
+  @param[in]  DiskIo2     Parent DiskIo2 interface.
+  @param[in]  MediaId     Id of the media.
+  @param[in]  Lba         The Lba to read.
+  @param[in]  BlockSize   The block size of the media.
+  @param[out] Token       The token of the read. The token and Buffer share
+                          one pool allocation which is freed through Token.
+  @param[out] Buffer      The buffer receiving the block.
+
+  @retval TRUE      The read was started, PartitionWaitGptBlock() must be
+                    called before Buffer is used.
+  @retval FALSE     The read was not started.
+
+**/
+BOOLEAN
+PartitionStartGptBlockRead (
+  IN  EFI_DISK_IO2_PROTOCOL  *DiskIo2,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINT32                 BlockSize,
+  OUT EFI_DISK_IO2_TOKEN     **Token,
+  OUT VOID                   **Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // The token lives in the same pool as the buffer, so that a read that never
+  // completes can keep both without referencing the stack of the caller.
+  //
+  *Token = AllocateZeroPool (sizeof (EFI_DISK_IO2_TOKEN) + BlockSize);
+  if (*Token == NULL) {
+    *Buffer = NULL;
+    return FALSE;
+  }
+
+  *Buffer = *Token + 1;
+
+  //
+  // The event is only polled, the DiskIo2 completion runs at TPL_NOTIFY
+  // which is above the TPL of the caller.
+  //
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &(*Token)->Event);
+  if (!EFI_ERROR (Status)) {
+    Status = DiskIo2->ReadDiskEx (
+                        DiskIo2,
+                        MediaId,
+                        MultU64x32 (Lba, BlockSize),
+                        *Token,
+                        BlockSize,
+                        *Buffer
+                        );
+    if (!EFI_ERROR (Status)) {
+      return TRUE;
+    }
+
+    gBS->CloseEvent ((*Token)->Event);
+  }
+
+  FreePool (*Token);
+  *Token  = NULL;
+  *Buffer = NULL;
+  return FALSE;
+}
+
+/**
+  Wait for a read started by PartitionStartGptBlockRead() to complete.
+
+  If the read does not complete within PARTITION_GPT_READ_TIMEOUT, it is
+  cancelled. If it is still outstanding after that, the token and the buffer
+  are left allocated for the request and *Token is set to NULL.
+
+  @param[in]      DiskIo2 Parent DiskIo2 interface.
+  @param[in, out] Token   The token of the read.
+
+  @retval EFI_TIMEOUT     The read did not complete in time.
+  @return The transaction status of the read.
+
+**/
+EFI_STATUS
+PartitionWaitGptBlock (
+  IN     EFI_DISK_IO2_PROTOCOL  *DiskIo2,
+  IN OUT EFI_DISK_IO2_TOKEN     **Token
+  )
+{
+  EFI_DISK_IO2_TOKEN  *ReadToken;
+  UINTN               Elapsed;
+
+  ReadToken = *Token;
+  if (ReadToken->Event == NULL) {
+    return ReadToken->TransactionStatus;
+  }
+
+  for (Elapsed = 0; Elapsed < PARTITION_GPT_READ_TIMEOUT; Elapsed += PARTITION_GPT_READ_POLL_INTERVAL) {
+    if (gBS->CheckEvent (ReadToken->Event) != EFI_NOT_READY) {
+      break;
+    }
+
+    gBS->Stall (PARTITION_GPT_READ_POLL_INTERVAL);
+  }
+
+  if (Elapsed >= PARTITION_GPT_READ_TIMEOUT) {
+    DEBUG ((DEBUG_WARN, "PartitionWaitGptBlock: prefetch timed out, cancelling\n"));
+    DiskIo2->Cancel (DiskIo2);
+    if (gBS->CheckEvent (ReadToken->Event) == EFI_NOT_READY) {
+      //
+      // The device may still write the token and the buffer, leave them to it.
+      //
+      *Token = NULL;
+      return EFI_TIMEOUT;
+    }
+  }
+
+  gBS->CloseEvent (ReadToken->Event);
+  ReadToken->Event = NULL;
+
+  return ReadToken->TransactionStatus;
+}
+
 /**
   Restore Partition Table to its alternate place
   (Primary -> Backup or Backup -> Primary).
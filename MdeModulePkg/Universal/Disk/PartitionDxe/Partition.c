@@ -314,7 +314,9 @@ PartitionDriverBindingStart (
     // Try for GPT, then legacy MBR partition types, and then UDF and El Torito.
     // If the media supports a given partition type install child handles to
     // represent the partitions described by the media.
+    // The probe time is recorded per disk, identified by ControllerHandle.
     //
+    PERF_START (ControllerHandle, "PartitionProbe", NULL, 0);
     Routine = &mPartitionDetectRoutineTable[0];
     while (*Routine != NULL) {
       Status = (*Routine)(
@@ -332,6 +334,8 @@ PartitionDriverBindingStart (
 
       Routine++;
     }
+
+    PERF_END (ControllerHandle, "PartitionProbe", NULL, 0);
   }
 
   //
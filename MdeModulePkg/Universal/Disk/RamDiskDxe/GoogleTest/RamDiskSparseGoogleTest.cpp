@@ -0,0 +1,461 @@
+/** @file
+  Tests for the sparse RAM disks of RamDiskSparse.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+  #include <PiDxe.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include "../RamDiskImpl.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_CHUNK_SIZE  0x1000
+#define TEST_XOR_KEY     0xA5
+
+//
+// The GUIDed sections of the tests hold the chunk data XORed with
+// TEST_XOR_KEY.
+//
+#define TEST_SECTION_GUID \
+  { 0x5ec5cc4a, 0x7f2e, 0x4b0d, { 0x9a, 0x61, 0x0e, 0x43, 0x8b, 0x27, 0xd1, 0x96 } }
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These symbols are not directly under test - but required to compile.
+// The GUIDed section handlers decode TEST_SECTION_GUID only, and
+// RamDiskInstall() records the RAM disk instead of installing it.
+////////////////////////////////////////////////////////////////////////
+STATIC EFI_GUID               mTestSectionGuid = TEST_SECTION_GUID;
+STATIC UINTN                  mDecodeCount;
+STATIC RAM_DISK_PRIVATE_DATA  *mInstalled;
+
+extern "C" {
+  RAM_DISK_PRIVATE_DATA  mRamDiskPrivateDataTemplate = {
+    RAM_DISK_PRIVATE_DATA_SIGNATURE,
+    NULL
+  };
+
+  EFI_STATUS
+  EFIAPI
+  ExtractGuidedSectionGetInfo (
+    IN  CONST VOID    *InputSection,
+    OUT       UINT32  *OutputBufferSize,
+    OUT       UINT32  *ScratchBufferSize,
+    OUT       UINT16  *SectionAttribute
+    )
+  {
+    CONST EFI_GUID_DEFINED_SECTION  *Section;
+
+    Section = (CONST EFI_GUID_DEFINED_SECTION *)InputSection;
+    if (!CompareGuid (&Section->SectionDefinitionGuid, &mTestSectionGuid)) {
+      return EFI_UNSUPPORTED;
+    }
+
+    *OutputBufferSize  = SECTION_SIZE (Section) - Section->DataOffset;
+    *ScratchBufferSize = 0;
+    *SectionAttribute  = Section->Attributes;
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  ExtractGuidedSectionDecode (
+    IN  CONST VOID    *InputSection,
+    OUT       VOID    **OutputBuffer,
+    IN        VOID    *ScratchBuffer OPTIONAL,
+    OUT       UINT32  *AuthenticationStatus
+    )
+  {
+    CONST EFI_GUID_DEFINED_SECTION  *Section;
+    CONST UINT8                     *Data;
+    UINT8                           *Output;
+    UINT32                          Index;
+
+    Section = (CONST EFI_GUID_DEFINED_SECTION *)InputSection;
+    if (!CompareGuid (&Section->SectionDefinitionGuid, &mTestSectionGuid)) {
+      return EFI_UNSUPPORTED;
+    }
+
+    Data   = (CONST UINT8 *)Section + Section->DataOffset;
+    Output = (UINT8 *)*OutputBuffer;
+    for (Index = 0; Index < SECTION_SIZE (Section) - Section->DataOffset; Index++) {
+      Output[Index] = Data[Index] ^ TEST_XOR_KEY;
+    }
+
+    *AuthenticationStatus = 0;
+    mDecodeCount++;
+    return EFI_SUCCESS;
+  }
+
+  EFI_DEVICE_PATH_PROTOCOL *
+  EFIAPI
+  CreateDeviceNode (
+    IN UINT8   NodeType,
+    IN UINT8   NodeSubType,
+    IN UINT16  NodeLength
+    )
+  {
+    EFI_DEVICE_PATH_PROTOCOL  *Node;
+
+    Node = (EFI_DEVICE_PATH_PROTOCOL *)AllocateZeroPool (NodeLength);
+    if (Node != NULL) {
+      Node->Type      = NodeType;
+      Node->SubType   = NodeSubType;
+      Node->Length[0] = (UINT8)NodeLength;
+      Node->Length[1] = (UINT8)(NodeLength >> 8);
+    }
+
+    return Node;
+  }
+
+  EFI_STATUS
+  RamDiskInstall (
+    IN  RAM_DISK_PRIVATE_DATA     *PrivateData,
+    IN  EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+    OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+    )
+  {
+    *DevicePath = RamDiskSparseCreateDeviceNode (PrivateData);
+    if (*DevicePath == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    PrivateData->DevicePath = *DevicePath;
+    mInstalled              = PrivateData;
+    return EFI_SUCCESS;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+// Fixture building chunk tables and registering sparse RAM disks. The
+// disks, their device paths and the GUIDed sections are freed at the end
+// of each test.
+class RamDiskSparseTest : public ::testing::Test {
+protected:
+  std::vector<RAM_DISK_PRIVATE_DATA *> Disks;
+  std::vector<VOID *> Sections;
+
+  virtual void
+  SetUp (
+    )
+  {
+    mDecodeCount = 0;
+    mInstalled   = NULL;
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    for (RAM_DISK_PRIVATE_DATA *PrivateData : Disks) {
+      RamDiskSparseFree (PrivateData->Sparse);
+      FreePool (PrivateData->DevicePath);
+      FreePool (PrivateData);
+    }
+
+    for (VOID *Section : Sections) {
+      FreePool (Section);
+    }
+  }
+
+  // Build a GUIDed section chunk decoding to Length bytes of Data.
+  EDKII_RAM_DISK_CHUNK
+  GuidedChunk (
+    CONST UINT8  *Data,
+    UINT32       Length,
+    EFI_GUID     *Guid = &mTestSectionGuid
+    )
+  {
+    EFI_GUID_DEFINED_SECTION  *Section;
+    EDKII_RAM_DISK_CHUNK      Chunk;
+    UINT32                    Size;
+    UINT32                    Index;
+
+    Size    = sizeof (EFI_GUID_DEFINED_SECTION) + Length;
+    Section = (EFI_GUID_DEFINED_SECTION *)AllocateZeroPool (Size);
+    Sections.push_back (Section);
+
+    Section->CommonHeader.Size[0] = (UINT8)Size;
+    Section->CommonHeader.Size[1] = (UINT8)(Size >> 8);
+    Section->CommonHeader.Size[2] = (UINT8)(Size >> 16);
+    Section->CommonHeader.Type    = EFI_SECTION_GUID_DEFINED;
+    Section->DataOffset           = sizeof (EFI_GUID_DEFINED_SECTION);
+    Section->Attributes           = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+    CopyGuid (&Section->SectionDefinitionGuid, Guid);
+    for (Index = 0; Index < Length; Index++) {
+      ((UINT8 *)(Section + 1))[Index] = Data[Index] ^ TEST_XOR_KEY;
+    }
+
+    Chunk.Type   = EdkiiRamDiskChunkGuidedSection;
+    Chunk.Length = Size;
+    Chunk.Buffer = (UINTN)Section;
+    return Chunk;
+  }
+
+  // Register a sparse RAM disk, returning its private data on success.
+  EFI_STATUS
+  Register (
+    UINT64                      Size,
+    UINTN                       ChunkCount,
+    CONST EDKII_RAM_DISK_CHUNK  *Chunks,
+    RAM_DISK_PRIVATE_DATA       **PrivateData
+    )
+  {
+    EFI_STATUS                Status;
+    EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+
+    mInstalled = NULL;
+    Status     = RamDiskRegisterSparse (
+                   Size,
+                   TEST_CHUNK_SIZE,
+                   ChunkCount,
+                   Chunks,
+                   &gEfiVirtualDiskGuid,
+                   NULL,
+                   &DevicePath
+                   );
+    if (!EFI_ERROR (Status)) {
+      Disks.push_back (mInstalled);
+      *PrivateData = mInstalled;
+    }
+
+    return Status;
+  }
+};
+
+// Fill a buffer with a pattern that differs for every chunk.
+STATIC
+VOID
+FillPattern (
+  UINT8   *Buffer,
+  UINT32  Length,
+  UINT8   Seed
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    Buffer[Index] = (UINT8)(Seed + Index * 7);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+// Zero chunks read as zeros and have no memory behind them.
+TEST_F (RamDiskSparseTest, ZeroChunksReadAsZeros) {
+  EDKII_RAM_DISK_CHUNK   Chunks[3];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Buffer[3 * TEST_CHUNK_SIZE];
+  UINTN                  Index;
+
+  ZeroMem (Chunks, sizeof (Chunks));
+  ASSERT_EQ (Register (sizeof (Buffer), 3, Chunks, &PrivateData), EFI_SUCCESS);
+
+  SetMem (Buffer, sizeof (Buffer), 0xCC);
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 0, sizeof (Buffer), Buffer), EFI_SUCCESS);
+  EXPECT_TRUE (IsZeroBuffer (Buffer, sizeof (Buffer)));
+
+  for (Index = 0; Index < 3; Index++) {
+    EXPECT_EQ (PrivateData->Sparse->Chunks[Index].Type, EdkiiRamDiskChunkZero);
+    EXPECT_FALSE (PrivateData->Sparse->Chunks[Index].Allocated);
+  }
+}
+
+// Writing zeros to a zero chunk keeps it sparse, other data gives it memory.
+TEST_F (RamDiskSparseTest, ZeroChunkAllocatedOnNonZeroWrite) {
+  EDKII_RAM_DISK_CHUNK   Chunks[3];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Data[16];
+  UINT8                  Buffer[3 * TEST_CHUNK_SIZE];
+
+  ZeroMem (Chunks, sizeof (Chunks));
+  ASSERT_EQ (Register (sizeof (Buffer), 3, Chunks, &PrivateData), EFI_SUCCESS);
+
+  ZeroMem (Data, sizeof (Data));
+  ASSERT_EQ (RamDiskSparseWrite (PrivateData, 100, sizeof (Data), Data), EFI_SUCCESS);
+  EXPECT_EQ (PrivateData->Sparse->Chunks[0].Type, EdkiiRamDiskChunkZero);
+  EXPECT_FALSE (PrivateData->Sparse->Chunks[0].Allocated);
+
+  SetMem (Data, sizeof (Data), 0x5A);
+  ASSERT_EQ (RamDiskSparseWrite (PrivateData, TEST_CHUNK_SIZE + 100, sizeof (Data), Data), EFI_SUCCESS);
+  EXPECT_EQ (PrivateData->Sparse->Chunks[1].Type, EdkiiRamDiskChunkRaw);
+  EXPECT_TRUE (PrivateData->Sparse->Chunks[1].Allocated);
+  EXPECT_EQ (PrivateData->Sparse->Chunks[2].Type, EdkiiRamDiskChunkZero);
+
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 0, sizeof (Buffer), Buffer), EFI_SUCCESS);
+  EXPECT_TRUE (IsZeroBuffer (Buffer, TEST_CHUNK_SIZE + 100));
+  EXPECT_EQ (CompareMem (Buffer + TEST_CHUNK_SIZE + 100, Data, sizeof (Data)), 0);
+  EXPECT_TRUE (IsZeroBuffer (Buffer + TEST_CHUNK_SIZE + 100 + sizeof (Data), sizeof (Buffer) - TEST_CHUNK_SIZE - 100 - sizeof (Data)));
+}
+
+// A read across a raw and a GUIDed section chunk returns the decoded data,
+// and a second read of the chunk comes from the cache.
+TEST_F (RamDiskSparseTest, GuidedChunkDecodedOnce) {
+  EDKII_RAM_DISK_CHUNK   Chunks[2];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Expected[2 * TEST_CHUNK_SIZE];
+  UINT8                  Buffer[2 * TEST_CHUNK_SIZE];
+
+  FillPattern (Expected, TEST_CHUNK_SIZE, 1);
+  FillPattern (Expected + TEST_CHUNK_SIZE, TEST_CHUNK_SIZE, 2);
+
+  Chunks[0].Type   = EdkiiRamDiskChunkRaw;
+  Chunks[0].Length = TEST_CHUNK_SIZE;
+  Chunks[0].Buffer = (UINTN)Expected;
+  Chunks[1]        = GuidedChunk (Expected + TEST_CHUNK_SIZE, TEST_CHUNK_SIZE);
+  ASSERT_EQ (Register (sizeof (Buffer), 2, Chunks, &PrivateData), EFI_SUCCESS);
+
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 512, sizeof (Buffer) - 1024, Buffer), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, Expected + 512, sizeof (Buffer) - 1024), 0);
+  EXPECT_EQ (mDecodeCount, 1U);
+
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 0, sizeof (Buffer), Buffer), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, Expected, sizeof (Buffer)), 0);
+  EXPECT_EQ (mDecodeCount, 1U);
+}
+
+// The least recently used chunk is evicted from a full cache.
+TEST_F (RamDiskSparseTest, CacheEvictsLeastRecentlyUsed) {
+  EDKII_RAM_DISK_CHUNK   Chunks[RAM_DISK_CHUNK_CACHE_ENTRIES + 1];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Data[TEST_CHUNK_SIZE];
+  UINT8                  Buffer[TEST_CHUNK_SIZE];
+  UINTN                  Index;
+
+  for (Index = 0; Index < RAM_DISK_CHUNK_CACHE_ENTRIES + 1; Index++) {
+    FillPattern (Data, TEST_CHUNK_SIZE, (UINT8)Index);
+    Chunks[Index] = GuidedChunk (Data, TEST_CHUNK_SIZE);
+  }
+
+  ASSERT_EQ (Register ((RAM_DISK_CHUNK_CACHE_ENTRIES + 1) * TEST_CHUNK_SIZE, RAM_DISK_CHUNK_CACHE_ENTRIES + 1, Chunks, &PrivateData), EFI_SUCCESS);
+
+  for (Index = 0; Index < RAM_DISK_CHUNK_CACHE_ENTRIES + 1; Index++) {
+    ASSERT_EQ (RamDiskSparseRead (PrivateData, Index * TEST_CHUNK_SIZE, TEST_CHUNK_SIZE, Buffer), EFI_SUCCESS);
+    FillPattern (Data, TEST_CHUNK_SIZE, (UINT8)Index);
+    EXPECT_EQ (CompareMem (Buffer, Data, TEST_CHUNK_SIZE), 0);
+  }
+
+  EXPECT_EQ (mDecodeCount, (UINTN)RAM_DISK_CHUNK_CACHE_ENTRIES + 1);
+
+  //
+  // Chunk 0 was evicted by the last chunk, the last chunk is still cached.
+  //
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, RAM_DISK_CHUNK_CACHE_ENTRIES * TEST_CHUNK_SIZE, TEST_CHUNK_SIZE, Buffer), EFI_SUCCESS);
+  EXPECT_EQ (mDecodeCount, (UINTN)RAM_DISK_CHUNK_CACHE_ENTRIES + 1);
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 0, TEST_CHUNK_SIZE, Buffer), EFI_SUCCESS);
+  EXPECT_EQ (mDecodeCount, (UINTN)RAM_DISK_CHUNK_CACHE_ENTRIES + 2);
+}
+
+// A write to a GUIDed section chunk keeps the decoded data around it.
+TEST_F (RamDiskSparseTest, GuidedChunkWriteKeepsDecodedData) {
+  EDKII_RAM_DISK_CHUNK   Chunks[1];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Expected[TEST_CHUNK_SIZE];
+  UINT8                  Buffer[TEST_CHUNK_SIZE];
+  UINT8                  Data[4];
+
+  FillPattern (Expected, TEST_CHUNK_SIZE, 3);
+  Chunks[0] = GuidedChunk (Expected, TEST_CHUNK_SIZE);
+  ASSERT_EQ (Register (TEST_CHUNK_SIZE, 1, Chunks, &PrivateData), EFI_SUCCESS);
+
+  SetMem (Data, sizeof (Data), 0xEE);
+  ASSERT_EQ (RamDiskSparseWrite (PrivateData, 1000, sizeof (Data), Data), EFI_SUCCESS);
+  EXPECT_EQ (PrivateData->Sparse->Chunks[0].Type, EdkiiRamDiskChunkRaw);
+  EXPECT_TRUE (PrivateData->Sparse->Chunks[0].Allocated);
+
+  CopyMem (Expected + 1000, Data, sizeof (Data));
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, 0, sizeof (Buffer), Buffer), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, Expected, sizeof (Buffer)), 0);
+}
+
+// The last chunk covers the rest of the disk only.
+TEST_F (RamDiskSparseTest, LastChunkCoversRemainder) {
+  EDKII_RAM_DISK_CHUNK   Chunks[2];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Data[TEST_CHUNK_SIZE];
+  UINT8                  Buffer[512];
+
+  FillPattern (Data, TEST_CHUNK_SIZE, 4);
+  ZeroMem (Chunks, sizeof (Chunks));
+  Chunks[1] = GuidedChunk (Data, TEST_CHUNK_SIZE);
+  EXPECT_EQ (Register (TEST_CHUNK_SIZE + 512, 2, Chunks, &PrivateData), EFI_INVALID_PARAMETER);
+
+  Chunks[1] = GuidedChunk (Data, 512);
+  ASSERT_EQ (Register (TEST_CHUNK_SIZE + 512, 2, Chunks, &PrivateData), EFI_SUCCESS);
+  ASSERT_EQ (RamDiskSparseRead (PrivateData, TEST_CHUNK_SIZE, sizeof (Buffer), Buffer), EFI_SUCCESS);
+  EXPECT_EQ (CompareMem (Buffer, Data, sizeof (Buffer)), 0);
+}
+
+// Malformed chunk tables are rejected.
+TEST_F (RamDiskSparseTest, InvalidChunkTables) {
+  EDKII_RAM_DISK_CHUNK   Chunks[2];
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  UINT8                  Data[TEST_CHUNK_SIZE];
+  EFI_GUID               OtherGuid = gEfiVirtualDiskGuid;
+
+  ZeroMem (Chunks, sizeof (Chunks));
+  ZeroMem (Data, sizeof (Data));
+
+  //
+  // The chunk table must cover the disk exactly.
+  //
+  EXPECT_EQ (Register (3 * TEST_CHUNK_SIZE, 2, Chunks, &PrivateData), EFI_INVALID_PARAMETER);
+  EXPECT_EQ (Register (TEST_CHUNK_SIZE, 2, Chunks, &PrivateData), EFI_INVALID_PARAMETER);
+
+  //
+  // A raw chunk must have a buffer of the chunk size.
+  //
+  Chunks[0].Type   = EdkiiRamDiskChunkRaw;
+  Chunks[0].Length = TEST_CHUNK_SIZE / 2;
+  Chunks[0].Buffer = (UINTN)Data;
+  EXPECT_EQ (Register (2 * TEST_CHUNK_SIZE, 2, Chunks, &PrivateData), EFI_INVALID_PARAMETER);
+
+  //
+  // Nothing decodes a section of an unknown GUID.
+  //
+  Chunks[0] = GuidedChunk (Data, TEST_CHUNK_SIZE, &OtherGuid);
+  EXPECT_EQ (Register (2 * TEST_CHUNK_SIZE, 2, Chunks, &PrivateData), EFI_UNSUPPORTED);
+
+  Chunks[0].Type = EdkiiRamDiskChunkTypeMax;
+  EXPECT_EQ (Register (2 * TEST_CHUNK_SIZE, 2, Chunks, &PrivateData), EFI_INVALID_PARAMETER);
+  EXPECT_TRUE (Disks.empty ());
+}
+
+// A sparse RAM disk is identified by a vendor node, not a memory range.
+TEST_F (RamDiskSparseTest, DeviceNodeIdentifiesDisk) {
+  EDKII_RAM_DISK_CHUNK               Chunks[1];
+  RAM_DISK_PRIVATE_DATA              *First;
+  RAM_DISK_PRIVATE_DATA              *Second;
+  EDKII_RAM_DISK_SPARSE_DEVICE_PATH  *Node;
+
+  ZeroMem (Chunks, sizeof (Chunks));
+  ASSERT_EQ (Register (TEST_CHUNK_SIZE, 1, Chunks, &First), EFI_SUCCESS);
+  ASSERT_EQ (Register (TEST_CHUNK_SIZE, 1, Chunks, &Second), EFI_SUCCESS);
+
+  EXPECT_EQ (First->StartingAddr, 0U);
+  Node = (EDKII_RAM_DISK_SPARSE_DEVICE_PATH *)First->DevicePath;
+  EXPECT_EQ (Node->Header.Header.Type, MEDIA_DEVICE_PATH);
+  EXPECT_EQ (Node->Header.Header.SubType, MEDIA_VENDOR_DP);
+  EXPECT_TRUE (CompareGuid (&Node->Header.Guid, &gEdkiiRamDiskSparseDevicePathGuid));
+  EXPECT_EQ (ReadUnaligned64 (&Node->Size), (UINT64)TEST_CHUNK_SIZE);
+
+  EXPECT_TRUE (RamDiskSparseMatchDeviceNode (First, Node));
+  EXPECT_FALSE (RamDiskSparseMatchDeviceNode (Second, Node));
+  EXPECT_TRUE (RamDiskSparseMatchDeviceNode (Second, (EDKII_RAM_DISK_SPARSE_DEVICE_PATH *)Second->DevicePath));
+}
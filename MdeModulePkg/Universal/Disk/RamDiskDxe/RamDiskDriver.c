@@ -23,6 +23,15 @@ EFI_RAM_DISK_PROTOCOL  mRamDiskProtocol = {
   RamDiskUnregister
 };
 
+//
+// The EDKII_RAM_DISK_EX_PROTOCOL instance that is installed onto the driver
+// handle
+//
+EDKII_RAM_DISK_EX_PROTOCOL  mRamDiskExProtocol = {
+  RamDiskRegisterSparse,
+  RamDiskUnregister
+};
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 //
@@ -94,7 +103,9 @@ RamDiskAcpiCheck (
 
   BASE_LIST_FOR_EACH (Entry, &RegisteredRamDisks) {
     PrivateData = RAM_DISK_PRIVATE_FROM_THIS (Entry);
-    RamDiskPublishNfit (PrivateData);
+    if (PrivateData->Sparse == NULL) {
+      RamDiskPublishNfit (PrivateData);
+    }
   }
 }
 
@@ -166,6 +177,8 @@ RamDiskDxeEntryPoint (
                   &mRamDiskHandle,
                   &gEfiRamDiskProtocolGuid,
                   &mRamDiskProtocol,
+                  &gEdkiiRamDiskExProtocolGuid,
+                  &mRamDiskExProtocol,
                   &gEfiCallerIdGuid,
                   ConfigPrivate,
                   NULL
@@ -231,6 +244,8 @@ RamDiskDxeUnload (
          mRamDiskHandle,
          &gEfiRamDiskProtocolGuid,
          &mRamDiskProtocol,
+         &gEdkiiRamDiskExProtocolGuid,
+         &mRamDiskExProtocol,
          &gEfiCallerIdGuid,
          ConfigPrivate,
          NULL
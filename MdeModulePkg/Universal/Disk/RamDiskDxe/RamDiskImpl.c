@@ -188,6 +188,7 @@ UnregisterAllRamDisks (
         FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
       }
 
+      RamDiskSparseFree (PrivateData->Sparse);
       FreePool (PrivateData->DevicePath);
       FreePool (PrivateData);
     }
@@ -517,14 +518,24 @@ UpdateMainForm (
     PrivateData->CheckBoxChecked = FALSE;
     String                       = RamDiskStr;
 
-    UnicodeSPrint (
-      String,
-      sizeof (RamDiskStr),
-      L"  RAM Disk %d: [0x%lx, 0x%lx]\n",
-      Index,
-      PrivateData->StartingAddr,
-      PrivateData->StartingAddr + PrivateData->Size - 1
-      );
+    if (PrivateData->Sparse != NULL) {
+      UnicodeSPrint (
+        String,
+        sizeof (RamDiskStr),
+        L"  RAM Disk %d: sparse, 0x%lx bytes\n",
+        Index,
+        PrivateData->Size
+        );
+    } else {
+      UnicodeSPrint (
+        String,
+        sizeof (RamDiskStr),
+        L"  RAM Disk %d: [0x%lx, 0x%lx]\n",
+        Index,
+        PrivateData->StartingAddr,
+        PrivateData->StartingAddr + PrivateData->Size - 1
+        );
+    }
 
     StringId = HiiSetString (ConfigPrivate->HiiHandle, 0, RamDiskStr, NULL);
     ASSERT (StringId != 0);
@@ -10,7 +10,7 @@
 #ifndef _RAM_DISK_IMPL_H_
 #define _RAM_DISK_IMPL_H_
 
-#include <Uefi.h>
+#include <PiDxe.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
@@ -25,7 +25,9 @@
 #include <Library/PrintLib.h>
 #include <Library/PcdLib.h>
 #include <Library/DxeServicesLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
 #include <Protocol/RamDisk.h>
+#include <Protocol/RamDiskEx.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/BlockIo2.h>
 #include <Protocol/HiiConfigAccess.h>
@@ -48,6 +50,11 @@
 //
 #define RAM_DISK_DEFAULT_BLOCK_SIZE  512
 
+//
+// Number of decoded chunks kept for each sparse RAM disk
+//
+#define RAM_DISK_CHUNK_CACHE_ENTRIES  8
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 //
@@ -67,6 +74,42 @@ typedef enum _RAM_DISK_CREATE_METHOD {
   RamDiskCreateHii
 } RAM_DISK_CREATE_METHOD;
 
+//
+// One chunk of a sparse RAM disk. A chunk whose data is allocated by the
+// driver (after a write to a zero or GUIDed section chunk) is raw and has
+// Allocated set.
+//
+typedef struct {
+  EDKII_RAM_DISK_CHUNK_TYPE    Type;
+  UINT32                       Length;
+  UINT64                       Buffer;
+  BOOLEAN                      Allocated;
+} RAM_DISK_CHUNK;
+
+//
+// A decoded GUIDed section chunk. Index is MAX_UINTN for an unused entry.
+//
+typedef struct {
+  UINTN     Index;
+  UINT64    LastUse;
+  UINT8     *Data;
+} RAM_DISK_CHUNK_CACHE;
+
+//
+// The backing store of a sparse RAM disk.
+//
+typedef struct {
+  UINT32                  DiskId;
+  UINT32                  ChunkSize;
+  UINTN                   ChunkShift;
+  UINTN                   ChunkCount;
+  RAM_DISK_CHUNK          *Chunks;
+  UINT64                  CacheTick;
+  RAM_DISK_CHUNK_CACHE    Cache[RAM_DISK_CHUNK_CACHE_ENTRIES];
+  VOID                    *ScratchBuffer;
+  UINT32                  ScratchSize;
+} RAM_DISK_SPARSE_DATA;
+
 //
 // RamDiskDxe driver maintains a list of registered RAM disks.
 // The struct contains the list entry and the information of each RAM
@@ -91,6 +134,12 @@ typedef struct {
   EFI_QUESTION_ID             CheckBoxId;
   BOOLEAN                     CheckBoxChecked;
 
+  //
+  // Non-NULL for a RAM disk registered by RegisterSparse(), StartingAddr is
+  // then 0.
+  //
+  RAM_DISK_SPARSE_DATA        *Sparse;
+
   LIST_ENTRY                  ThisInstance;
 } RAM_DISK_PRIVATE_DATA;
 
@@ -99,6 +148,8 @@ typedef struct {
 #define RAM_DISK_PRIVATE_FROM_BLKIO2(a)  CR (a, RAM_DISK_PRIVATE_DATA, BlockIo2, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 #define RAM_DISK_PRIVATE_FROM_THIS(a)    CR (a, RAM_DISK_PRIVATE_DATA, ThisInstance, RAM_DISK_PRIVATE_DATA_SIGNATURE)
 
+extern RAM_DISK_PRIVATE_DATA  mRamDiskPrivateDataTemplate;
+
 ///
 /// RAM disk HII-related definitions and declarations
 ///
@@ -169,6 +220,65 @@ RamDiskRegister (
   OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   );
 
+/**
+  Register a sparse RAM disk made up of fixed size chunks.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  ChunkSize      The size of each chunk, a power of two and a
+                             multiple of 512 bytes.
+  @param[in]  ChunkCount     The number of entries in Chunks.
+  @param[in]  Chunks         The chunk table describing the disk content.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   A parameter or a chunk descriptor is invalid.
+  @retval EFI_UNSUPPORTED         No handler decodes a GUIDed section chunk.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskRegisterSparse (
+  IN UINT64                      RamDiskSize,
+  IN UINT32                      ChunkSize,
+  IN UINTN                       ChunkCount,
+  IN CONST EDKII_RAM_DISK_CHUNK  *Chunks,
+  IN EFI_GUID                    *RamDiskType,
+  IN EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL   **DevicePath
+  );
+
+/**
+  Create the device path of a new RAM disk, install it with the Block IO
+  protocols and add it to the registered RAM disk list.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path, or NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is installed.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval Others                  The RAM disk could not be installed.
+
+**/
+EFI_STATUS
+RamDiskInstall (
+  IN  RAM_DISK_PRIVATE_DATA     *PrivateData,
+  IN  EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  );
+
 /**
   Unregister a RAM disk specified by DevicePath.
 
@@ -190,6 +300,89 @@ RamDiskUnregister (
   IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   );
 
+/**
+  Read data from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to read from.
+  @param[in]  Length         The number of bytes to read.
+  @param[out] Buffer         The buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory to decode a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Length,
+  OUT UINT8                  *Buffer
+  );
+
+/**
+  Write data to a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to write to.
+  @param[in]  Length         The number of bytes to write.
+  @param[in]  Buffer         The data to write.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory to back a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Length,
+  IN UINT8                  *Buffer
+  );
+
+/**
+  Free the backing store of a sparse RAM disk.
+
+  @param[in] Sparse          The backing store, may be NULL.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_SPARSE_DATA  *Sparse
+  );
+
+/**
+  Create the device path node of a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+
+  @return The EDKII_RAM_DISK_SPARSE_DEVICE_PATH node, or NULL if it could not
+          be allocated.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+RamDiskSparseCreateDeviceNode (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  );
+
+/**
+  Check whether a device path node identifies a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Node            An EDKII_RAM_DISK_SPARSE_DEVICE_PATH node.
+
+  @retval TRUE               The node is the one of the RAM disk.
+  @retval FALSE              The node belongs to another RAM disk.
+
+**/
+BOOLEAN
+RamDiskSparseMatchDeviceNode (
+  IN RAM_DISK_PRIVATE_DATA              *PrivateData,
+  IN EDKII_RAM_DISK_SPARSE_DEVICE_PATH  *Node
+  );
+
 /**
   Initialize the BlockIO protocol of a RAM disk device.
 
@@ -598,12 +598,8 @@ RamDiskRegister (
   OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   )
 {
-  EFI_STATUS                  Status;
-  RAM_DISK_PRIVATE_DATA       *PrivateData;
-  RAM_DISK_PRIVATE_DATA       *RegisteredPrivateData;
-  MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
-  UINTN                       DevicePathSize;
-  LIST_ENTRY                  *Entry;
+  EFI_STATUS             Status;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
 
   if ((0 == RamDiskSize) || (NULL == RamDiskType) || (NULL == DevicePath)) {
     return EFI_INVALID_PARAMETER;
@@ -618,8 +614,6 @@ RamDiskRegister (
     return EFI_INVALID_PARAMETER;
   }
 
-  RamDiskDevNode = NULL;
-
   //
   // Create a new RAM disk instance and initialize its private data
   //
@@ -636,24 +630,67 @@ RamDiskRegister (
   CopyGuid (&PrivateData->TypeGuid, RamDiskType);
   InitializeListHead (&PrivateData->ThisInstance);
 
+  Status = RamDiskInstall (PrivateData, ParentDevicePath, DevicePath);
+  if (EFI_ERROR (Status)) {
+    FreePool (PrivateData);
+  }
+
+  return Status;
+}
+
+/**
+  Create the device path of a new RAM disk, install it with the Block IO
+  protocols and add it to the registered RAM disk list.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path, or NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is installed.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval Others                  The RAM disk could not be installed.
+
+**/
+EFI_STATUS
+RamDiskInstall (
+  IN  RAM_DISK_PRIVATE_DATA     *PrivateData,
+  IN  EFI_DEVICE_PATH           *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath
+  )
+{
+  EFI_STATUS                  Status;
+  RAM_DISK_PRIVATE_DATA       *RegisteredPrivateData;
+  MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
+  EFI_DEVICE_PATH_PROTOCOL    *DevNode;
+  UINTN                       DevicePathSize;
+  LIST_ENTRY                  *Entry;
+
   //
-  // Generate device path information for the registered RAM disk
+  // Generate device path information for the registered RAM disk. A sparse
+  // RAM disk has no memory range to put in a RAM disk node.
   //
-  RamDiskDevNode = AllocateCopyPool (
-                     sizeof (MEDIA_RAM_DISK_DEVICE_PATH),
-                     &mRamDiskDeviceNodeTemplate
-                     );
-  if (NULL == RamDiskDevNode) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ErrorExit;
+  if (PrivateData->Sparse != NULL) {
+    DevNode = RamDiskSparseCreateDeviceNode (PrivateData);
+  } else {
+    RamDiskDevNode = AllocateCopyPool (
+                       sizeof (MEDIA_RAM_DISK_DEVICE_PATH),
+                       &mRamDiskDeviceNodeTemplate
+                       );
+    if (NULL != RamDiskDevNode) {
+      RamDiskInitDeviceNode (PrivateData, RamDiskDevNode);
+    }
+
+    DevNode = (EFI_DEVICE_PATH_PROTOCOL *)RamDiskDevNode;
   }
 
-  RamDiskInitDeviceNode (PrivateData, RamDiskDevNode);
+  if (NULL == DevNode) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-  *DevicePath = AppendDevicePathNode (
-                  ParentDevicePath,
-                  (EFI_DEVICE_PATH_PROTOCOL *)RamDiskDevNode
-                  );
+  *DevicePath = AppendDevicePathNode (ParentDevicePath, DevNode);
   if (NULL == *DevicePath) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ErrorExit;
@@ -718,25 +755,25 @@ RamDiskRegister (
 
   gBS->ConnectController (PrivateData->Handle, NULL, NULL, TRUE);
 
-  FreePool (RamDiskDevNode);
+  FreePool (DevNode);
 
-  if ((mAcpiTableProtocol != NULL) && (mAcpiSdtProtocol != NULL)) {
+  //
+  // A sparse RAM disk has no physical address range to describe in NFIT.
+  //
+  if ((mAcpiTableProtocol != NULL) && (mAcpiSdtProtocol != NULL) &&
+      (PrivateData->Sparse == NULL))
+  {
     RamDiskPublishNfit (PrivateData);
   }
 
   return EFI_SUCCESS;
 
 ErrorExit:
-  if (RamDiskDevNode != NULL) {
-    FreePool (RamDiskDevNode);
-  }
+  FreePool (DevNode);
 
-  if (PrivateData != NULL) {
-    if (PrivateData->DevicePath) {
-      FreePool (PrivateData->DevicePath);
-    }
-
-    FreePool (PrivateData);
+  if (PrivateData->DevicePath != NULL) {
+    FreePool (PrivateData->DevicePath);
+    PrivateData->DevicePath = NULL;
   }
 
   return Status;
@@ -763,14 +800,16 @@ RamDiskUnregister (
   IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   )
 {
-  LIST_ENTRY                  *Entry;
-  LIST_ENTRY                  *NextEntry;
-  BOOLEAN                     Found;
-  UINT64                      StartingAddr;
-  UINT64                      EndingAddr;
-  EFI_DEVICE_PATH_PROTOCOL    *Header;
-  MEDIA_RAM_DISK_DEVICE_PATH  *RamDiskDevNode;
-  RAM_DISK_PRIVATE_DATA       *PrivateData;
+  LIST_ENTRY                         *Entry;
+  LIST_ENTRY                         *NextEntry;
+  BOOLEAN                            Found;
+  BOOLEAN                            Match;
+  UINT64                             StartingAddr;
+  UINT64                             EndingAddr;
+  EFI_DEVICE_PATH_PROTOCOL           *Header;
+  MEDIA_RAM_DISK_DEVICE_PATH         *RamDiskDevNode;
+  EDKII_RAM_DISK_SPARSE_DEVICE_PATH  *SparseDevNode;
+  RAM_DISK_PRIVATE_DATA              *PrivateData;
 
   if (NULL == DevicePath) {
     return EFI_INVALID_PARAMETER;
@@ -780,10 +819,11 @@ RamDiskUnregister (
   // Locate the RAM disk device node.
   //
   RamDiskDevNode = NULL;
+  SparseDevNode  = NULL;
   Header         = DevicePath;
   do {
     //
-    // Test if the current device node is a RAM disk.
+    // Test if the current device node is a RAM disk or a sparse RAM disk.
     //
     if ((MEDIA_DEVICE_PATH == Header->Type) &&
         (MEDIA_RAM_DISK_DP == Header->SubType))
@@ -793,16 +833,30 @@ RamDiskUnregister (
       break;
     }
 
+    if ((MEDIA_DEVICE_PATH == Header->Type) &&
+        (MEDIA_VENDOR_DP == Header->SubType) &&
+        (DevicePathNodeLength (Header) == sizeof (EDKII_RAM_DISK_SPARSE_DEVICE_PATH)) &&
+        CompareGuid (&((VENDOR_DEVICE_PATH *)Header)->Guid, &gEdkiiRamDiskSparseDevicePathGuid))
+    {
+      SparseDevNode = (EDKII_RAM_DISK_SPARSE_DEVICE_PATH *)Header;
+
+      break;
+    }
+
     Header = NextDevicePathNode (Header);
   } while ((Header->Type != END_DEVICE_PATH_TYPE));
 
-  if (NULL == RamDiskDevNode) {
+  if ((NULL == RamDiskDevNode) && (NULL == SparseDevNode)) {
     return EFI_UNSUPPORTED;
   }
 
   Found        = FALSE;
-  StartingAddr = ReadUnaligned64 ((UINT64 *)&(RamDiskDevNode->StartingAddr[0]));
-  EndingAddr   = ReadUnaligned64 ((UINT64 *)&(RamDiskDevNode->EndingAddr[0]));
+  StartingAddr = 0;
+  EndingAddr   = 0;
+  if (NULL != RamDiskDevNode) {
+    StartingAddr = ReadUnaligned64 ((UINT64 *)&(RamDiskDevNode->StartingAddr[0]));
+    EndingAddr   = ReadUnaligned64 ((UINT64 *)&(RamDiskDevNode->EndingAddr[0]));
+  }
 
   if (!IsListEmpty (&RegisteredRamDisks)) {
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &RegisteredRamDisks) {
@@ -810,12 +864,19 @@ RamDiskUnregister (
 
       //
       // Unregister the RAM disk given by its starting address, ending address
-      // and type guid.
+      // and type guid, or the sparse RAM disk given by its node.
       //
-      if ((StartingAddr == PrivateData->StartingAddr) &&
-          (EndingAddr == PrivateData->StartingAddr + PrivateData->Size - 1) &&
-          (CompareGuid (&RamDiskDevNode->TypeGuid, &PrivateData->TypeGuid)))
-      {
+      if (NULL != SparseDevNode) {
+        Match = (BOOLEAN)((PrivateData->Sparse != NULL) &&
+                          RamDiskSparseMatchDeviceNode (PrivateData, SparseDevNode));
+      } else {
+        Match = (BOOLEAN)((PrivateData->Sparse == NULL) &&
+                          (StartingAddr == PrivateData->StartingAddr) &&
+                          (EndingAddr == PrivateData->StartingAddr + PrivateData->Size - 1) &&
+                          CompareGuid (&RamDiskDevNode->TypeGuid, &PrivateData->TypeGuid));
+      }
+
+      if (Match) {
         //
         // Remove the content for this RAM disk in NFIT.
         //
@@ -848,6 +909,7 @@ RamDiskUnregister (
           FreePool ((VOID *)(UINTN)PrivateData->StartingAddr);
         }
 
+        RamDiskSparseFree (PrivateData->Sparse);
         FreePool (PrivateData->DevicePath);
         FreePool (PrivateData);
         Found = TRUE;
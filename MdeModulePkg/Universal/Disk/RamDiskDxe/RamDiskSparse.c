@@ -0,0 +1,668 @@
+/** @file
+  Produce EDKII_RAM_DISK_EX_PROTOCOL and the backing store of sparse RAM disks.
+
+  A sparse RAM disk is split into fixed size chunks. Zero chunks have no
+  memory until they are written with non-zero data, raw chunks are accessed
+  in place, and GUIDed section chunks (e.g. LZMA compressed) are decoded into
+  a small LRU cache of chunk buffers when read. A write to a zero or GUIDed
+  section chunk turns it into a raw chunk owned by the driver.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "RamDiskImpl.h"
+
+//
+// The DiskId of the next sparse RAM disk registered.
+//
+STATIC UINT32  mRamDiskSparseNextId;
+
+/**
+  Return the number of disk bytes covered by a chunk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Index           The index of the chunk.
+
+  @return The chunk length, ChunkSize for all chunks but the last one.
+
+**/
+STATIC
+UINT32
+RamDiskSparseChunkLength (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  Index
+  )
+{
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  UINT64                Offset;
+
+  Sparse = PrivateData->Sparse;
+  Offset = LShiftU64 (Index, Sparse->ChunkShift);
+
+  return (UINT32)MIN (Sparse->ChunkSize, PrivateData->Size - Offset);
+}
+
+/**
+  Check a chunk descriptor passed to RegisterSparse().
+
+  @param[in]      Chunk          The chunk descriptor.
+  @param[in]      ChunkLength    The number of disk bytes covered by the chunk.
+  @param[in, out] ScratchSize    The largest scratch buffer size required to
+                                 decode the GUIDed section chunks so far.
+
+  @retval EFI_SUCCESS            The chunk descriptor is valid.
+  @retval EFI_INVALID_PARAMETER  The chunk descriptor is malformed.
+  @retval EFI_UNSUPPORTED        No handler decodes the GUIDed section.
+
+**/
+STATIC
+EFI_STATUS
+RamDiskSparseCheckChunk (
+  IN     CONST EDKII_RAM_DISK_CHUNK  *Chunk,
+  IN     UINT32                      ChunkLength,
+  IN OUT UINT32                      *ScratchSize
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_COMMON_SECTION_HEADER  *Section;
+  UINT32                     SectionSize;
+  UINT32                     OutputSize;
+  UINT32                     DecodeScratchSize;
+  UINT16                     SectionAttribute;
+
+  switch (Chunk->Type) {
+    case EdkiiRamDiskChunkZero:
+      return EFI_SUCCESS;
+
+    case EdkiiRamDiskChunkRaw:
+      if ((Chunk->Buffer == 0) || (Chunk->Length != ChunkLength) ||
+          (Chunk->Buffer > MAX_UINTN - Chunk->Length + 1))
+      {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      return EFI_SUCCESS;
+
+    case EdkiiRamDiskChunkGuidedSection:
+      if ((Chunk->Buffer == 0) || (Chunk->Buffer > MAX_UINTN - Chunk->Length + 1) ||
+          (Chunk->Length < sizeof (EFI_GUID_DEFINED_SECTION)))
+      {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      Section = (EFI_COMMON_SECTION_HEADER *)(UINTN)Chunk->Buffer;
+      if (Section->Type != EFI_SECTION_GUID_DEFINED) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      if (IS_SECTION2 (Section)) {
+        if (Chunk->Length < sizeof (EFI_GUID_DEFINED_SECTION2)) {
+          return EFI_INVALID_PARAMETER;
+        }
+
+        SectionSize = SECTION2_SIZE (Section);
+      } else {
+        SectionSize = SECTION_SIZE (Section);
+      }
+
+      if (SectionSize > Chunk->Length) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      Status = ExtractGuidedSectionGetInfo (
+                 Section,
+                 &OutputSize,
+                 &DecodeScratchSize,
+                 &SectionAttribute
+                 );
+      if (EFI_ERROR (Status)) {
+        return EFI_UNSUPPORTED;
+      }
+
+      if (OutputSize != ChunkLength) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      *ScratchSize = MAX (*ScratchSize, DecodeScratchSize);
+      return EFI_SUCCESS;
+
+    default:
+      return EFI_INVALID_PARAMETER;
+  }
+}
+
+/**
+  Free the backing store of a sparse RAM disk.
+
+  @param[in] Sparse          The backing store, may be NULL.
+
+**/
+VOID
+RamDiskSparseFree (
+  IN RAM_DISK_SPARSE_DATA  *Sparse
+  )
+{
+  UINTN  Index;
+
+  if (Sparse == NULL) {
+    return;
+  }
+
+  if (Sparse->Chunks != NULL) {
+    for (Index = 0; Index < Sparse->ChunkCount; Index++) {
+      if (Sparse->Chunks[Index].Allocated) {
+        FreePool ((VOID *)(UINTN)Sparse->Chunks[Index].Buffer);
+      }
+    }
+
+    FreePool (Sparse->Chunks);
+  }
+
+  for (Index = 0; Index < RAM_DISK_CHUNK_CACHE_ENTRIES; Index++) {
+    if (Sparse->Cache[Index].Data != NULL) {
+      FreePool (Sparse->Cache[Index].Data);
+    }
+  }
+
+  if (Sparse->ScratchBuffer != NULL) {
+    FreePool (Sparse->ScratchBuffer);
+  }
+
+  FreePool (Sparse);
+}
+
+/**
+  Create the device path node of a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+
+  @return The EDKII_RAM_DISK_SPARSE_DEVICE_PATH node, or NULL if it could not
+          be allocated.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+RamDiskSparseCreateDeviceNode (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData
+  )
+{
+  EDKII_RAM_DISK_SPARSE_DEVICE_PATH  *Node;
+
+  Node = (EDKII_RAM_DISK_SPARSE_DEVICE_PATH *)CreateDeviceNode (
+                                                MEDIA_DEVICE_PATH,
+                                                MEDIA_VENDOR_DP,
+                                                sizeof (EDKII_RAM_DISK_SPARSE_DEVICE_PATH)
+                                                );
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  CopyGuid (&Node->Header.Guid, &gEdkiiRamDiskSparseDevicePathGuid);
+  WriteUnaligned64 (&Node->Size, PrivateData->Size);
+  CopyGuid (&Node->TypeGuid, &PrivateData->TypeGuid);
+  WriteUnaligned32 (&Node->DiskId, PrivateData->Sparse->DiskId);
+
+  return (EFI_DEVICE_PATH_PROTOCOL *)Node;
+}
+
+/**
+  Check whether a device path node identifies a sparse RAM disk.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Node            An EDKII_RAM_DISK_SPARSE_DEVICE_PATH node.
+
+  @retval TRUE               The node is the one of the RAM disk.
+  @retval FALSE              The node belongs to another RAM disk.
+
+**/
+BOOLEAN
+RamDiskSparseMatchDeviceNode (
+  IN RAM_DISK_PRIVATE_DATA              *PrivateData,
+  IN EDKII_RAM_DISK_SPARSE_DEVICE_PATH  *Node
+  )
+{
+  return (BOOLEAN)((ReadUnaligned32 (&Node->DiskId) == PrivateData->Sparse->DiskId) &&
+                   (ReadUnaligned64 (&Node->Size) == PrivateData->Size) &&
+                   CompareGuid (&Node->TypeGuid, &PrivateData->TypeGuid));
+}
+
+/**
+  Register a sparse RAM disk made up of fixed size chunks.
+
+  @param[in]  RamDiskSize    The size of registered RAM disk.
+  @param[in]  ChunkSize      The size of each chunk, a power of two and a
+                             multiple of 512 bytes.
+  @param[in]  ChunkCount     The number of entries in Chunks.
+  @param[in]  Chunks         The chunk table describing the disk content.
+  @param[in]  RamDiskType    The type of registered RAM disk.
+  @param[in]  ParentDevicePath
+                             Pointer to the parent device path. If there is no
+                             parent device path then ParentDevicePath is NULL.
+  @param[out] DevicePath     On return, points to a pointer to the device path
+                             of the RAM disk device.
+
+  @retval EFI_SUCCESS             The RAM disk is registered successfully.
+  @retval EFI_INVALID_PARAMETER   A parameter or a chunk descriptor is invalid.
+  @retval EFI_UNSUPPORTED         No handler decodes a GUIDed section chunk.
+  @retval EFI_ALREADY_STARTED     A Device Path Protocol instance to be created
+                                  is already present in the handle database.
+  @retval EFI_OUT_OF_RESOURCES    The RAM disk register operation fails due to
+                                  resource limitation.
+
+**/
+EFI_STATUS
+EFIAPI
+RamDiskRegisterSparse (
+  IN UINT64                      RamDiskSize,
+  IN UINT32                      ChunkSize,
+  IN UINTN                       ChunkCount,
+  IN CONST EDKII_RAM_DISK_CHUNK  *Chunks,
+  IN EFI_GUID                    *RamDiskType,
+  IN EFI_DEVICE_PATH             *ParentDevicePath     OPTIONAL,
+  OUT EFI_DEVICE_PATH_PROTOCOL   **DevicePath
+  )
+{
+  EFI_STATUS             Status;
+  RAM_DISK_PRIVATE_DATA  *PrivateData;
+  RAM_DISK_SPARSE_DATA   *Sparse;
+  UINTN                  ChunkShift;
+  UINTN                  Index;
+  UINT32                 ScratchSize;
+  UINTN                  ZeroChunks;
+  UINTN                  GuidedChunks;
+
+  if ((0 == RamDiskSize) || (NULL == Chunks) || (NULL == RamDiskType) ||
+      (NULL == DevicePath))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((ChunkSize < RAM_DISK_DEFAULT_BLOCK_SIZE) || ((ChunkSize & (ChunkSize - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The chunk table must cover the whole disk, and be addressable.
+  //
+  if (RamDiskSize > MAX_UINT64 - ChunkSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ChunkShift = (UINTN)HighBitSet32 (ChunkSize);
+  if ((ChunkCount > MAX_UINTN / sizeof (RAM_DISK_CHUNK)) ||
+      ((UINT64)ChunkCount != RShiftU64 (RamDiskSize + ChunkSize - 1, ChunkShift)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PrivateData = AllocateCopyPool (
+                  sizeof (RAM_DISK_PRIVATE_DATA),
+                  &mRamDiskPrivateDataTemplate
+                  );
+  if (NULL == PrivateData) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Sparse = AllocateZeroPool (sizeof (RAM_DISK_SPARSE_DATA));
+  if (NULL == Sparse) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ErrorExit;
+  }
+
+  PrivateData->Sparse = Sparse;
+  PrivateData->Size   = RamDiskSize;
+  Sparse->ChunkSize   = ChunkSize;
+  Sparse->ChunkShift  = ChunkShift;
+  Sparse->ChunkCount  = ChunkCount;
+  for (Index = 0; Index < RAM_DISK_CHUNK_CACHE_ENTRIES; Index++) {
+    Sparse->Cache[Index].Index = MAX_UINTN;
+  }
+
+  Sparse->Chunks = AllocateZeroPool (ChunkCount * sizeof (RAM_DISK_CHUNK));
+  if (NULL == Sparse->Chunks) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ErrorExit;
+  }
+
+  ScratchSize  = 0;
+  ZeroChunks   = 0;
+  GuidedChunks = 0;
+  for (Index = 0; Index < ChunkCount; Index++) {
+    Status = RamDiskSparseCheckChunk (
+               &Chunks[Index],
+               RamDiskSparseChunkLength (PrivateData, Index),
+               &ScratchSize
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "RamDiskRegisterSparse: Chunk %Lu is invalid - %r\n", (UINT64)Index, Status));
+      goto ErrorExit;
+    }
+
+    Sparse->Chunks[Index].Type   = Chunks[Index].Type;
+    Sparse->Chunks[Index].Length = Chunks[Index].Length;
+    Sparse->Chunks[Index].Buffer = Chunks[Index].Buffer;
+
+    if (Chunks[Index].Type == EdkiiRamDiskChunkZero) {
+      ZeroChunks++;
+    } else if (Chunks[Index].Type == EdkiiRamDiskChunkGuidedSection) {
+      GuidedChunks++;
+    }
+  }
+
+  if (ScratchSize != 0) {
+    Sparse->ScratchBuffer = AllocatePool (ScratchSize);
+    if (NULL == Sparse->ScratchBuffer) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ErrorExit;
+    }
+
+    Sparse->ScratchSize = ScratchSize;
+  }
+
+  //
+  // There is no memory range behind a sparse RAM disk, DiskId identifies it
+  // in its device path node instead.
+  //
+  PrivateData->StartingAddr = 0;
+  Sparse->DiskId            = mRamDiskSparseNextId++;
+
+  CopyGuid (&PrivateData->TypeGuid, RamDiskType);
+  InitializeListHead (&PrivateData->ThisInstance);
+
+  Status = RamDiskInstall (PrivateData, ParentDevicePath, DevicePath);
+  if (EFI_ERROR (Status)) {
+    goto ErrorExit;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "RamDiskRegisterSparse: 0x%lx bytes in %Lu chunks, %Lu zero, %Lu GUIDed section\n",
+    RamDiskSize,
+    (UINT64)ChunkCount,
+    (UINT64)ZeroChunks,
+    (UINT64)GuidedChunks
+    ));
+
+  return EFI_SUCCESS;
+
+ErrorExit:
+  RamDiskSparseFree (PrivateData->Sparse);
+  FreePool (PrivateData);
+
+  return Status;
+}
+
+/**
+  Get the decoded data of a GUIDed section chunk, decoding it into the least
+  recently used cache entry if it is not cached.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Index          The index of the chunk.
+  @param[out] Entry          Returns the cache entry holding the chunk data.
+
+  @retval EFI_SUCCESS             The chunk data is in the cache.
+  @retval EFI_DEVICE_ERROR        The chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory for the cache entry.
+
+**/
+STATIC
+EFI_STATUS
+RamDiskSparseDecodeChunk (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINTN                  Index,
+  OUT RAM_DISK_CHUNK_CACHE   **Entry
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  RAM_DISK_CHUNK_CACHE  *Victim;
+  UINTN                 Slot;
+  VOID                  *Section;
+  VOID                  *Output;
+  UINT32                OutputSize;
+  UINT32                ScratchSize;
+  UINT16                SectionAttribute;
+  UINT32                AuthenticationStatus;
+
+  Sparse = PrivateData->Sparse;
+  Victim = &Sparse->Cache[0];
+
+  for (Slot = 0; Slot < RAM_DISK_CHUNK_CACHE_ENTRIES; Slot++) {
+    if (Sparse->Cache[Slot].Index == Index) {
+      Sparse->Cache[Slot].LastUse = ++Sparse->CacheTick;
+      *Entry                      = &Sparse->Cache[Slot];
+      return EFI_SUCCESS;
+    }
+
+    if (Sparse->Cache[Slot].LastUse < Victim->LastUse) {
+      Victim = &Sparse->Cache[Slot];
+    }
+  }
+
+  if (Victim->Data == NULL) {
+    Victim->Data = AllocatePool (Sparse->ChunkSize);
+    if (Victim->Data == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Victim->Index   = MAX_UINTN;
+  Victim->LastUse = 0;
+
+  Section = (VOID *)(UINTN)Sparse->Chunks[Index].Buffer;
+  Status  = ExtractGuidedSectionGetInfo (Section, &OutputSize, &ScratchSize, &SectionAttribute);
+  if (EFI_ERROR (Status) || (OutputSize != RamDiskSparseChunkLength (PrivateData, Index)) ||
+      (ScratchSize > Sparse->ScratchSize))
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Some handlers return a pointer into the section instead of filling the
+  // output buffer.
+  //
+  Output = Victim->Data;
+  Status = ExtractGuidedSectionDecode (Section, &Output, Sparse->ScratchBuffer, &AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "RamDiskSparseDecodeChunk: Chunk %Lu - %r\n", (UINT64)Index, Status));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Output != Victim->Data) {
+    CopyMem (Victim->Data, Output, OutputSize);
+  }
+
+  Victim->Index   = Index;
+  Victim->LastUse = ++Sparse->CacheTick;
+  *Entry          = Victim;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Give a zero or GUIDed section chunk its own writable memory.
+
+  @param[in] PrivateData     Points to RAM disk private data.
+  @param[in] Index           The index of the chunk.
+
+  @retval EFI_SUCCESS             The chunk is a raw chunk now.
+  @retval EFI_DEVICE_ERROR        The chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory for the chunk.
+
+**/
+STATIC
+EFI_STATUS
+RamDiskSparsePromoteChunk (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINTN                  Index
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_CHUNK        *Chunk;
+  RAM_DISK_CHUNK_CACHE  *Entry;
+  VOID                  *Buffer;
+  UINT32                ChunkLength;
+
+  Chunk       = &PrivateData->Sparse->Chunks[Index];
+  ChunkLength = RamDiskSparseChunkLength (PrivateData, Index);
+
+  if (Chunk->Type == EdkiiRamDiskChunkGuidedSection) {
+    //
+    // Take the decoded buffer over from the cache.
+    //
+    Status = RamDiskSparseDecodeChunk (PrivateData, Index, &Entry);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Buffer         = Entry->Data;
+    Entry->Data    = NULL;
+    Entry->Index   = MAX_UINTN;
+    Entry->LastUse = 0;
+  } else {
+    Buffer = AllocateZeroPool (ChunkLength);
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Chunk->Type      = EdkiiRamDiskChunkRaw;
+  Chunk->Length    = ChunkLength;
+  Chunk->Buffer    = (UINTN)Buffer;
+  Chunk->Allocated = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read data from a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to read from.
+  @param[in]  Length         The number of bytes to read.
+  @param[out] Buffer         The buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_DEVICE_ERROR        A chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory to decode a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseRead (
+  IN  RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN  UINT64                 Offset,
+  IN  UINTN                  Length,
+  OUT UINT8                  *Buffer
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  RAM_DISK_CHUNK        *Chunk;
+  RAM_DISK_CHUNK_CACHE  *Entry;
+  EFI_TPL               OldTpl;
+  UINTN                 Index;
+  UINTN                 ChunkOffset;
+  UINTN                 Count;
+
+  Sparse = PrivateData->Sparse;
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  while (Length > 0) {
+    Index       = (UINTN)RShiftU64 (Offset, Sparse->ChunkShift);
+    ChunkOffset = (UINTN)(Offset & (Sparse->ChunkSize - 1));
+    Count       = MIN (Length, Sparse->ChunkSize - ChunkOffset);
+    Chunk       = &Sparse->Chunks[Index];
+
+    switch (Chunk->Type) {
+      case EdkiiRamDiskChunkZero:
+        ZeroMem (Buffer, Count);
+        break;
+
+      case EdkiiRamDiskChunkRaw:
+        CopyMem (Buffer, (UINT8 *)(UINTN)Chunk->Buffer + ChunkOffset, Count);
+        break;
+
+      default:
+        Status = RamDiskSparseDecodeChunk (PrivateData, Index, &Entry);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+
+        CopyMem (Buffer, Entry->Data + ChunkOffset, Count);
+        break;
+    }
+
+    Offset += Count;
+    Buffer += Count;
+    Length -= Count;
+  }
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Write data to a sparse RAM disk.
+
+  @param[in]  PrivateData    Points to RAM disk private data.
+  @param[in]  Offset         The byte offset on the disk to write to.
+  @param[in]  Length         The number of bytes to write.
+  @param[in]  Buffer         The data to write.
+
+  @retval EFI_SUCCESS             The data was written.
+  @retval EFI_DEVICE_ERROR        A chunk could not be decoded.
+  @retval EFI_OUT_OF_RESOURCES    No memory to back a chunk.
+
+**/
+EFI_STATUS
+RamDiskSparseWrite (
+  IN RAM_DISK_PRIVATE_DATA  *PrivateData,
+  IN UINT64                 Offset,
+  IN UINTN                  Length,
+  IN UINT8                  *Buffer
+  )
+{
+  EFI_STATUS            Status;
+  RAM_DISK_SPARSE_DATA  *Sparse;
+  RAM_DISK_CHUNK        *Chunk;
+  EFI_TPL               OldTpl;
+  UINTN                 Index;
+  UINTN                 ChunkOffset;
+  UINTN                 Count;
+
+  Sparse = PrivateData->Sparse;
+  Status = EFI_SUCCESS;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  while (Length > 0) {
+    Index       = (UINTN)RShiftU64 (Offset, Sparse->ChunkShift);
+    ChunkOffset = (UINTN)(Offset & (Sparse->ChunkSize - 1));
+    Count       = MIN (Length, Sparse->ChunkSize - ChunkOffset);
+    Chunk       = &Sparse->Chunks[Index];
+
+    //
+    // Zeros written to a zero chunk need no memory.
+    //
+    if ((Chunk->Type != EdkiiRamDiskChunkZero) || !IsZeroBuffer (Buffer, Count)) {
+      if (Chunk->Type != EdkiiRamDiskChunkRaw) {
+        Status = RamDiskSparsePromoteChunk (PrivateData, Index);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+      }
+
+      CopyMem ((UINT8 *)(UINTN)Chunk->Buffer + ChunkOffset, Buffer, Count);
+    }
+
+    Offset += Count;
+    Buffer += Count;
+    Length -= Count;
+  }
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
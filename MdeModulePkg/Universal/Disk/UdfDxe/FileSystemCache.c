@@ -0,0 +1,389 @@
+/** @file
+  Cache of parsed FE/EFEs, extent lists and directory indexes in UDF volumes.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "Udf.h"
+
+/**
+  Release the extent list and directory data of a cache entry.
+
+  @param[in, out] Entry   Cache entry.
+
+**/
+STATIC
+VOID
+ResetUdfCacheEntry (
+  IN OUT UDF_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->ExtentList.Extents != NULL) {
+    FreePool (Entry->ExtentList.Extents);
+  }
+
+  if (Entry->DirectoryData != NULL) {
+    FreePool (Entry->DirectoryData);
+  }
+
+  if (Entry->IndexBuckets != NULL) {
+    FreePool (Entry->IndexBuckets);
+  }
+
+  if (Entry->IndexEntries != NULL) {
+    FreePool (Entry->IndexEntries);
+  }
+
+  Entry->ExtentsValid = FALSE;
+  ZeroMem (&Entry->ExtentList, sizeof (UDF_FILE_EXTENT_LIST));
+  Entry->DirectoryValid   = FALSE;
+  Entry->DirectoryData    = NULL;
+  Entry->DirectoryLength  = 0;
+  Entry->ParentFidOffset  = MAX_UINT64;
+  Entry->IndexBucketCount = 0;
+  Entry->IndexBuckets     = NULL;
+  Entry->IndexEntries     = NULL;
+}
+
+/**
+  Remove a cache entry from the cache and free it.
+
+  @param[in, out] Volume  UDF volume information structure.
+  @param[in]      Entry   Cache entry.
+
+**/
+STATIC
+VOID
+RemoveUdfCacheEntry (
+  IN OUT UDF_VOLUME_INFO  *Volume,
+  IN     UDF_CACHE_ENTRY  *Entry
+  )
+{
+  RemoveEntryList (&Entry->HashLink);
+  RemoveEntryList (&Entry->LruLink);
+  Volume->CacheCount--;
+
+  ResetUdfCacheEntry (Entry);
+  FreePool (Entry->FileEntry);
+  FreePool (Entry);
+}
+
+/**
+  Initialize the FE/EFE cache of a volume.
+
+  @param[out] Volume    UDF volume information structure.
+
+**/
+VOID
+InitializeUdfCache (
+  OUT UDF_VOLUME_INFO  *Volume
+  )
+{
+  UINTN  Index;
+
+  Volume->CacheCount = 0;
+  InitializeListHead (&Volume->CacheLru);
+  for (Index = 0; Index < UDF_CACHE_BUCKETS; Index++) {
+    InitializeListHead (&Volume->CacheBuckets[Index]);
+  }
+}
+
+/**
+  Free all entries of the FE/EFE cache of a volume.
+
+  @param[in, out] Volume    UDF volume information structure.
+
+**/
+VOID
+FreeUdfCache (
+  IN OUT UDF_VOLUME_INFO  *Volume
+  )
+{
+  while (!IsListEmpty (&Volume->CacheLru)) {
+    RemoveUdfCacheEntry (
+      Volume,
+      CR (GetFirstNode (&Volume->CacheLru), UDF_CACHE_ENTRY, LruLink, UDF_CACHE_ENTRY_SIGNATURE)
+      );
+  }
+}
+
+/**
+  Look up the cache entry of a FE/EFE.
+
+  If FileEntry is not NULL, the entry is only returned if it caches the same
+  FE/EFE. If Add is TRUE, FileEntry is known to be the FE/EFE recorded at Lsn
+  and a missing or stale entry is (re)created from it.
+
+  @param[in] BlockIo    BlockIo interface.
+  @param[in] Volume     UDF volume information structure.
+  @param[in] Lsn        Logical sector number of the FE/EFE.
+  @param[in] FileEntry  FE/EFE to match, or NULL to match any.
+  @param[in] Add        Whether to add FileEntry to the cache on a miss.
+
+  @return The cache entry, or NULL if it is not cached.
+
+**/
+UDF_CACHE_ENTRY *
+GetUdfCacheEntry (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN UDF_VOLUME_INFO        *Volume,
+  IN UINT64                 Lsn,
+  IN VOID                   *FileEntry  OPTIONAL,
+  IN BOOLEAN                Add
+  )
+{
+  LIST_ENTRY       *Bucket;
+  LIST_ENTRY       *Link;
+  UDF_CACHE_ENTRY  *Entry;
+
+  ASSERT (!Add || FileEntry != NULL);
+
+  //
+  // Nothing cached survives a media change.
+  //
+  if (Volume->CacheMediaId != BlockIo->Media->MediaId) {
+    FreeUdfCache (Volume);
+    Volume->CacheMediaId = BlockIo->Media->MediaId;
+  }
+
+  Bucket = &Volume->CacheBuckets[UDF_CACHE_BUCKET (Lsn)];
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    Entry = CR (Link, UDF_CACHE_ENTRY, HashLink, UDF_CACHE_ENTRY_SIGNATURE);
+    if (Entry->Lsn != Lsn) {
+      continue;
+    }
+
+    if ((FileEntry != NULL) &&
+        (CompareMem (Entry->FileEntry, FileEntry, Volume->FileEntrySize) != 0))
+    {
+      if (!Add) {
+        return NULL;
+      }
+
+      ResetUdfCacheEntry (Entry);
+      CopyMem (Entry->FileEntry, FileEntry, Volume->FileEntrySize);
+    }
+
+    //
+    // Move it to the most recently used end.
+    //
+    RemoveEntryList (&Entry->LruLink);
+    InsertHeadList (&Volume->CacheLru, &Entry->LruLink);
+    return Entry;
+  }
+
+  if (!Add) {
+    return NULL;
+  }
+
+  if (Volume->CacheCount >= UDF_CACHE_MAX_ENTRIES) {
+    RemoveUdfCacheEntry (
+      Volume,
+      CR (GetPreviousNode (&Volume->CacheLru, &Volume->CacheLru), UDF_CACHE_ENTRY, LruLink, UDF_CACHE_ENTRY_SIGNATURE)
+      );
+  }
+
+  Entry = AllocateZeroPool (sizeof (UDF_CACHE_ENTRY));
+  if (Entry == NULL) {
+    return NULL;
+  }
+
+  Entry->FileEntry = AllocateCopyPool (Volume->FileEntrySize, FileEntry);
+  if (Entry->FileEntry == NULL) {
+    FreePool (Entry);
+    return NULL;
+  }
+
+  Entry->Signature       = UDF_CACHE_ENTRY_SIGNATURE;
+  Entry->Lsn             = Lsn;
+  Entry->ParentFidOffset = MAX_UINT64;
+
+  InsertHeadList (Bucket, &Entry->HashLink);
+  InsertHeadList (&Volume->CacheLru, &Entry->LruLink);
+  Volume->CacheCount++;
+
+  return Entry;
+}
+
+/**
+  Hash a file name for the directory index.
+
+  @param[in] FileName   File name.
+
+  @return The hash of FileName.
+
+**/
+STATIC
+UINT32
+HashFileName (
+  IN CHAR16  *FileName
+  )
+{
+  return CalculateCrc32 (FileName, StrLen (FileName) * sizeof (CHAR16));
+}
+
+/**
+  Build the hashed FID index of a cached directory. The directory data must
+  have been read into the cache entry.
+
+  @param[in, out] Entry   Cache entry of the directory.
+
+  @retval EFI_SUCCESS           The index was built.
+  @retval EFI_OUT_OF_RESOURCES  The index was not built due to lack of
+                                resources.
+
+**/
+EFI_STATUS
+BuildDirectoryIndex (
+  IN OUT UDF_CACHE_ENTRY  *Entry
+  )
+{
+  UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
+  UINT64                          FidOffset;
+  UINT64                          FidLength;
+  UINTN                           FidCount;
+  UINTN                           Index;
+  UINT32                          BucketCount;
+  UINT32                          *Bucket;
+  CHAR16                          FileName[UDF_FILENAME_LENGTH];
+
+  ASSERT (Entry->DirectoryValid);
+
+  //
+  // Walk the FIDs twice: count them, then hash their names. FIDs which run
+  // past the end of the directory data terminate the walk.
+  //
+  FidCount = 0;
+  for (FidOffset = 0; ; FidOffset += FidLength) {
+    if (Entry->DirectoryLength - FidOffset < OFFSET_OF (UDF_FILE_IDENTIFIER_DESCRIPTOR, Data[0])) {
+      break;
+    }
+
+    FileIdentifierDesc = GET_FID_FROM_ADS (Entry->DirectoryData, FidOffset);
+    FidLength          = GetFidDescriptorLength (FileIdentifierDesc);
+    if (FidLength > Entry->DirectoryLength - FidOffset) {
+      break;
+    }
+
+    FidCount++;
+  }
+
+  BucketCount = 1;
+  while ((BucketCount < FidCount) && (BucketCount < BIT30)) {
+    BucketCount <<= 1;
+  }
+
+  Entry->IndexBuckets = AllocatePool (BucketCount * sizeof (UINT32));
+  Entry->IndexEntries = AllocatePool (MAX (FidCount, 1) * sizeof (UDF_DIRECTORY_INDEX_ENTRY));
+  if ((Entry->IndexBuckets == NULL) || (Entry->IndexEntries == NULL)) {
+    if (Entry->IndexBuckets != NULL) {
+      FreePool (Entry->IndexBuckets);
+      Entry->IndexBuckets = NULL;
+    }
+
+    if (Entry->IndexEntries != NULL) {
+      FreePool (Entry->IndexEntries);
+      Entry->IndexEntries = NULL;
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem32 (Entry->IndexBuckets, BucketCount * sizeof (UINT32), UDF_DIRECTORY_INDEX_END);
+  Entry->IndexBucketCount = BucketCount;
+  Entry->ParentFidOffset  = MAX_UINT64;
+
+  Index = 0;
+  for (FidOffset = 0; Index < FidCount; FidOffset += GetFidDescriptorLength (FileIdentifierDesc)) {
+    FileIdentifierDesc = GET_FID_FROM_ADS (Entry->DirectoryData, FidOffset);
+    if (FileIdentifierDesc->FileCharacteristics & DELETED_FILE) {
+      FidCount--;
+      continue;
+    }
+
+    if (FileIdentifierDesc->FileCharacteristics & PARENT_FILE) {
+      if (Entry->ParentFidOffset == MAX_UINT64) {
+        Entry->ParentFidOffset = FidOffset;
+      }
+
+      FidCount--;
+      continue;
+    }
+
+    if (EFI_ERROR (GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FileName), FileName))) {
+      FidCount--;
+      continue;
+    }
+
+    Entry->IndexEntries[Index].Hash      = HashFileName (FileName);
+    Entry->IndexEntries[Index].FidOffset = FidOffset;
+    Index++;
+  }
+
+  //
+  // Chain the entries backwards so that every bucket lists its FIDs in
+  // directory order, and the first of duplicated names is found first.
+  //
+  while (Index > 0) {
+    Index--;
+    Bucket                          = &Entry->IndexBuckets[Entry->IndexEntries[Index].Hash & (BucketCount - 1)];
+    Entry->IndexEntries[Index].Next = *Bucket;
+    *Bucket                         = (UINT32)Index;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find a FID by file name in the index of a cached directory.
+
+  @param[in]  Entry       Cache entry of the directory.
+  @param[in]  FileName    File name to look up.
+  @param[out] FidOffset   Offset of the FID in the directory data.
+
+  @retval EFI_SUCCESS     The FID was found.
+  @retval EFI_NOT_FOUND   There is no such file in the directory.
+
+**/
+EFI_STATUS
+FindDirectoryIndex (
+  IN  UDF_CACHE_ENTRY  *Entry,
+  IN  CHAR16           *FileName,
+  OUT UINT64           *FidOffset
+  )
+{
+  UINT32                     Hash;
+  UINT32                     Index;
+  UDF_DIRECTORY_INDEX_ENTRY  *IndexEntry;
+  CHAR16                     FoundFileName[UDF_FILENAME_LENGTH];
+
+  ASSERT (Entry->IndexBuckets != NULL);
+
+  Hash = HashFileName (FileName);
+  for (Index = Entry->IndexBuckets[Hash & (Entry->IndexBucketCount - 1)];
+       Index != UDF_DIRECTORY_INDEX_END;
+       Index = IndexEntry->Next)
+  {
+    IndexEntry = &Entry->IndexEntries[Index];
+    if (IndexEntry->Hash != Hash) {
+      continue;
+    }
+
+    //
+    // Confirm the match, names were decoded fine when building the index.
+    //
+    GetFileNameFromFid (
+      GET_FID_FROM_ADS (Entry->DirectoryData, IndexEntry->FidOffset),
+      ARRAY_SIZE (FoundFileName),
+      FoundFileName
+      );
+    if (StrCmp (FileName, FoundFileName) == 0) {
+      *FidOffset = IndexEntry->FidOffset;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
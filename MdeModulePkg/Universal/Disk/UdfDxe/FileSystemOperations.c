@@ -1014,40 +1014,304 @@ GetAedAdsData (
 }
 
 /**
-  Function used to serialise reads of Allocation Descriptors.
+  Build the list of recorded extents of a file from its Allocation
+  Descriptors, following Allocation Extent Descriptors.
 
-  @param[in]      RecordingFlags  Flag to indicate the type of descriptor.
-  @param[in]      Ad              Allocation Descriptor pointer.
-  @param[in, out] Buffer          Buffer to hold the next Allocation Descriptor.
-  @param[in]      Length          Length of Buffer.
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ParentIcb           Long Allocation Descriptor pointer.
+  @param[in]  FileEntryData       FE/EFE structure pointer.
+  @param[out] ExtentList          The extent list. The caller frees
+                                  ExtentList->Extents.
 
-  @retval EFI_SUCCESS             Buffer was grown to hold the next Allocation
-                                  Descriptor.
-  @retval EFI_OUT_OF_RESOURCES    Buffer was not grown due to lack of resources.
+  @retval EFI_SUCCESS             The extent list was built.
+  @retval EFI_OUT_OF_RESOURCES    The extent list was not built due to lack of
+                                  resources.
+  @retval other                   The Allocation Descriptors were not read.
 
 **/
 EFI_STATUS
-GrowUpBufferToNextAd (
-  IN      UDF_FE_RECORDING_FLAGS  RecordingFlags,
-  IN      VOID                    *Ad,
-  IN OUT  VOID                    **Buffer,
-  IN      UINT64                  Length
+BuildFileExtentList (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_FILE_EXTENT_LIST            *ExtentList
   )
 {
-  UINT32  ExtentLength;
+  EFI_STATUS              Status;
+  UDF_FE_RECORDING_FLAGS  RecordingFlags;
+  VOID                    *Data;
+  VOID                    *DataBak;
+  UINT64                  Length;
+  VOID                    *Ad;
+  UINT64                  AdOffset;
+  UINT64                  Lsn;
+  BOOLEAN                 DoFreeAed;
+  UDF_FILE_EXTENT         *Extents;
+  UINTN                   MaxExtents;
 
-  ExtentLength = GET_EXTENT_LENGTH (RecordingFlags, Ad);
+  ZeroMem (ExtentList, sizeof (UDF_FILE_EXTENT_LIST));
 
-  if (*Buffer == NULL) {
-    *Buffer = AllocatePool (ExtentLength);
-    if (*Buffer == NULL) {
-      return EFI_OUT_OF_RESOURCES;
+  RecordingFlags = GET_FE_RECORDING_FLAGS (FileEntryData);
+
+  Status = GetAdsInformation (FileEntryData, Volume->FileEntrySize, &Data, &Length);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  DoFreeAed  = FALSE;
+  MaxExtents = 0;
+  AdOffset   = 0;
+
+  for ( ; ;) {
+    //
+    // Read AD.
+    //
+    Status = GetAllocationDescriptor (
+               RecordingFlags,
+               Data,
+               &AdOffset,
+               Length,
+               &Ad
+               );
+    if (Status == EFI_DEVICE_ERROR) {
+      Status = EFI_SUCCESS;
+      break;
     }
-  } else {
-    *Buffer = ReallocatePool ((UINTN)Length, (UINTN)(Length + ExtentLength), *Buffer);
-    if (*Buffer == NULL) {
-      return EFI_OUT_OF_RESOURCES;
+
+    //
+    // Check if AD is an indirect AD. If so, read Allocation Extent
+    // Descriptor and its extents (ADs).
+    //
+    if (GET_EXTENT_FLAGS (RecordingFlags, Ad) == ExtentIsNextExtent) {
+      DataBak = Data;
+      Status  = GetAedAdsData (
+                  BlockIo,
+                  DiskIo,
+                  Volume,
+                  ParentIcb,
+                  RecordingFlags,
+                  Ad,
+                  &Data,
+                  &Length
+                  );
+
+      if (DoFreeAed) {
+        FreePool (DataBak);
+      }
+
+      if (EFI_ERROR (Status)) {
+        if (Data != DataBak) {
+          FreePool (Data);
+        }
+
+        DoFreeAed = FALSE;
+        break;
+      }
+
+      ASSERT (Data != NULL);
+
+      DoFreeAed = TRUE;
+      AdOffset  = 0;
+      continue;
     }
+
+    Status = GetAllocationDescriptorLsn (
+               RecordingFlags,
+               Volume,
+               ParentIcb,
+               Ad,
+               &Lsn
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (ExtentList->ExtentCount == MaxExtents) {
+      MaxExtents = MAX (MaxExtents * 2, 8);
+      Extents    = ReallocatePool (
+                     ExtentList->ExtentCount * sizeof (UDF_FILE_EXTENT),
+                     MaxExtents * sizeof (UDF_FILE_EXTENT),
+                     ExtentList->Extents
+                     );
+      if (Extents == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+
+      ExtentList->Extents = Extents;
+    }
+
+    Extents             = &ExtentList->Extents[ExtentList->ExtentCount++];
+    Extents->FileOffset = ExtentList->Length;
+    Extents->Lsn        = Lsn;
+    Extents->Length     = GET_EXTENT_LENGTH (RecordingFlags, Ad);
+    ExtentList->Length += Extents->Length;
+
+    //
+    // Point to the next AD (extent).
+    //
+    AdOffset += AD_LENGTH (RecordingFlags);
+  }
+
+  if (DoFreeAed) {
+    FreePool (Data);
+  }
+
+  if (EFI_ERROR (Status) && (ExtentList->Extents != NULL)) {
+    FreePool (ExtentList->Extents);
+    ZeroMem (ExtentList, sizeof (UDF_FILE_EXTENT_LIST));
+  }
+
+  return Status;
+}
+
+/**
+  Get the extent list of a file, from the FE/EFE cache when the file is
+  cached there.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ParentIcb           Long Allocation Descriptor pointer.
+  @param[in]  FileEntryData       FE/EFE structure pointer.
+  @param[out] LocalList           Extent list used if the file is not cached.
+                                  The caller frees LocalList->Extents.
+  @param[out] ExtentList          Returns either the cached list or LocalList.
+
+  @retval EFI_SUCCESS             The extent list was returned.
+  @retval other                   The extent list was not built.
+
+**/
+EFI_STATUS
+GetFileExtentList (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_FILE_EXTENT_LIST            *LocalList,
+  OUT  UDF_FILE_EXTENT_LIST            **ExtentList
+  )
+{
+  EFI_STATUS       Status;
+  UINT64           Lsn;
+  UDF_CACHE_ENTRY  *Entry;
+
+  ZeroMem (LocalList, sizeof (UDF_FILE_EXTENT_LIST));
+  *ExtentList = LocalList;
+
+  //
+  // ParentIcb is not always the ICB of FileEntryData (e.g. for symlinks), so
+  // only use a cache entry which holds the very same FE/EFE.
+  //
+  Entry = NULL;
+  if (!EFI_ERROR (GetLongAdLsn (Volume, ParentIcb, &Lsn))) {
+    Entry = GetUdfCacheEntry (BlockIo, Volume, Lsn, FileEntryData, FALSE);
+  }
+
+  if ((Entry != NULL) && Entry->ExtentsValid) {
+    *ExtentList = &Entry->ExtentList;
+    return EFI_SUCCESS;
+  }
+
+  Status = BuildFileExtentList (
+             BlockIo,
+             DiskIo,
+             Volume,
+             ParentIcb,
+             FileEntryData,
+             (Entry != NULL) ? &Entry->ExtentList : LocalList
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Entry != NULL) {
+    Entry->ExtentsValid = TRUE;
+    *ExtentList         = &Entry->ExtentList;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read file data spanning one or more extents. Extents which are contiguous
+  on the disk are read with a single disk access.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ExtentList          The extent list of the file.
+  @param[in]  Index               Index of the extent to start reading from.
+  @param[in]  Offset              Offset in that extent to start reading from.
+  @param[in]  Length              Number of bytes to read.
+  @param[out] Buffer              Buffer to read the data into.
+
+  @retval EFI_SUCCESS             The data was read.
+  @retval EFI_VOLUME_CORRUPTED    The extents hold less data than requested.
+  @retval other                   The data was not read.
+
+**/
+EFI_STATUS
+ReadFileExtents (
+  IN   EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN   UDF_VOLUME_INFO        *Volume,
+  IN   UDF_FILE_EXTENT_LIST   *ExtentList,
+  IN   UINTN                  Index,
+  IN   UINT64                 Offset,
+  IN   UINT64                 Length,
+  OUT  UINT8                  *Buffer
+  )
+{
+  EFI_STATUS       Status;
+  UINT32           LogicalBlockSize;
+  UDF_FILE_EXTENT  *Extent;
+  UINT64           DiskOffset;
+  UINT64           ReadLength;
+
+  LogicalBlockSize = Volume->LogicalVolDesc.LogicalBlockSize;
+
+  while (Length > 0) {
+    if (Index >= ExtentList->ExtentCount) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Extent     = &ExtentList->Extents[Index];
+    DiskOffset = MultU64x32 (Extent->Lsn, LogicalBlockSize) + Offset;
+    ReadLength = MIN (Length, Extent->Length - Offset);
+
+    //
+    // Merge the following extents as long as they continue on the disk.
+    //
+    while ((ReadLength < Length) && (Index + 1 < ExtentList->ExtentCount) &&
+           (MultU64x32 (Extent[1].Lsn, LogicalBlockSize) ==
+            MultU64x32 (Extent[0].Lsn, LogicalBlockSize) + Extent[0].Length))
+    {
+      Index++;
+      Extent++;
+      ReadLength += MIN (Length - ReadLength, Extent->Length);
+    }
+
+    Status = DiskIo->ReadDisk (
+                       DiskIo,
+                       BlockIo->Media->MediaId,
+                       DiskOffset,
+                       (UINTN)ReadLength,
+                       Buffer
+                       );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Buffer += ReadLength;
+    Length -= ReadLength;
+    Offset  = 0;
+    Index++;
   }
 
   return EFI_SUCCESS;
@@ -1084,34 +1348,16 @@ ReadFile (
   )
 {
   EFI_STATUS              Status;
-  UINT32                  LogicalBlockSize;
   VOID                    *Data;
-  VOID                    *DataBak;
   UINT64                  Length;
-  VOID                    *Ad;
-  UINT64                  AdOffset;
-  UINT64                  Lsn;
-  BOOLEAN                 DoFreeAed;
-  UINT64                  FilePosition;
-  UINT64                  Offset;
-  UINT64                  DataOffset;
-  UINT64                  BytesLeft;
-  UINT64                  DataLength;
-  BOOLEAN                 FinishedSeeking;
-  UINT32                  ExtentLength;
   UDF_FE_RECORDING_FLAGS  RecordingFlags;
+  UDF_FILE_EXTENT_LIST    LocalList;
+  UDF_FILE_EXTENT_LIST    *ExtentList;
+  UINTN                   Low;
+  UINTN                   High;
+  UINTN                   Middle;
 
-  LogicalBlockSize = Volume->LogicalVolDesc.LogicalBlockSize;
-  DoFreeAed        = FALSE;
-
-  //
-  // set BytesLeft to suppress incorrect compiler/analyzer warnings
-  //
-  BytesLeft       = 0;
-  DataOffset      = 0;
-  FilePosition    = 0;
-  FinishedSeeking = FALSE;
-  Data            = NULL;
+  Data = NULL;
 
   switch (ReadFileInfo->Flags) {
     case ReadFileGetFileSize:
@@ -1135,14 +1381,6 @@ ReadFile (
         ReadFileInfo->FileDataSize = Length;
       }
 
-      //
-      // Initialise data to start seeking and/or reading a file.
-      //
-      BytesLeft       = ReadFileInfo->FileDataSize;
-      DataOffset      = 0;
-      FilePosition    = 0;
-      FinishedSeeking = FALSE;
-
       break;
   }
 
@@ -1196,186 +1434,97 @@ ReadFile (
     case LongAdsSequence:
     case ShortAdsSequence:
       //
-      // This FE/EFE contains a run of Allocation Descriptors. Get data + size
-      // for start reading them out.
+      // This FE/EFE contains a run of Allocation Descriptors. Get the list of
+      // extents they describe, cached after the first walk of the ADs.
       //
-      Status = GetAdsInformation (FileEntryData, Volume->FileEntrySize, &Data, &Length);
+      Status = GetFileExtentList (
+                 BlockIo,
+                 DiskIo,
+                 Volume,
+                 ParentIcb,
+                 FileEntryData,
+                 &LocalList,
+                 &ExtentList
+                 );
       if (EFI_ERROR (Status)) {
         return Status;
       }
 
-      AdOffset = 0;
-
-      for ( ; ;) {
-        //
-        // Read AD.
-        //
-        Status = GetAllocationDescriptor (
-                   RecordingFlags,
-                   Data,
-                   &AdOffset,
-                   Length,
-                   &Ad
-                   );
-        if (Status == EFI_DEVICE_ERROR) {
-          Status = EFI_SUCCESS;
-          goto Done;
-        }
-
-        //
-        // Check if AD is an indirect AD. If so, read Allocation Extent
-        // Descriptor and its extents (ADs).
-        //
-        if (GET_EXTENT_FLAGS (RecordingFlags, Ad) == ExtentIsNextExtent) {
-          DataBak = Data;
-          Status  = GetAedAdsData (
-                      BlockIo,
-                      DiskIo,
-                      Volume,
-                      ParentIcb,
-                      RecordingFlags,
-                      Ad,
-                      &Data,
-                      &Length
-                      );
-
-          if (!DoFreeAed) {
-            DoFreeAed = TRUE;
-          } else {
-            FreePool (DataBak);
+      switch (ReadFileInfo->Flags) {
+        case ReadFileGetFileSize:
+          ReadFileInfo->ReadLength = ExtentList->Length;
+          break;
+        case ReadFileAllocateAndRead:
+          if (ExtentList->Length == 0) {
+            break;
           }
 
-          if (EFI_ERROR (Status)) {
-            goto Error_Get_Aed;
+          ReadFileInfo->FileData = AllocatePool ((UINTN)ExtentList->Length);
+          if (ReadFileInfo->FileData == NULL) {
+            Status = EFI_OUT_OF_RESOURCES;
+            break;
           }
 
-          ASSERT (Data != NULL);
-
-          AdOffset = 0;
-          continue;
-        }
-
-        ExtentLength = GET_EXTENT_LENGTH (RecordingFlags, Ad);
-
-        Status = GetAllocationDescriptorLsn (
-                   RecordingFlags,
-                   Volume,
-                   ParentIcb,
-                   Ad,
-                   &Lsn
-                   );
-        if (EFI_ERROR (Status)) {
-          goto Done;
-        }
-
-        switch (ReadFileInfo->Flags) {
-          case ReadFileGetFileSize:
-            ReadFileInfo->ReadLength += ExtentLength;
+          Status = ReadFileExtents (
+                     BlockIo,
+                     DiskIo,
+                     Volume,
+                     ExtentList,
+                     0,
+                     0,
+                     ExtentList->Length,
+                     ReadFileInfo->FileData
+                     );
+          if (EFI_ERROR (Status)) {
+            FreePool (ReadFileInfo->FileData);
+            ReadFileInfo->FileData = NULL;
             break;
-          case ReadFileAllocateAndRead:
-            //
-            // Increase FileData (if necessary) to read next extent.
-            //
-            Status = GrowUpBufferToNextAd (
-                       RecordingFlags,
-                       Ad,
-                       &ReadFileInfo->FileData,
-                       ReadFileInfo->ReadLength
-                       );
-            if (EFI_ERROR (Status)) {
-              goto Error_Alloc_Buffer_To_Next_Ad;
-            }
-
-            //
-            // Read extent's data into FileData.
-            //
-            Status = DiskIo->ReadDisk (
-                               DiskIo,
-                               BlockIo->Media->MediaId,
-                               MultU64x32 (Lsn, LogicalBlockSize),
-                               ExtentLength,
-                               (VOID *)((UINT8 *)ReadFileInfo->FileData +
-                                        ReadFileInfo->ReadLength)
-                               );
-            if (EFI_ERROR (Status)) {
-              goto Error_Read_Disk_Blk;
-            }
+          }
 
-            ReadFileInfo->ReadLength += ExtentLength;
+          ReadFileInfo->ReadLength = ExtentList->Length;
+          break;
+        case ReadFileSeekAndRead:
+          if (ReadFileInfo->FileDataSize == 0) {
             break;
-          case ReadFileSeekAndRead:
-            //
-            // Seek file first before reading in its data.
-            //
-            if (FinishedSeeking) {
-              Offset = 0;
-              goto Skip_File_Seek;
-            }
-
-            if (FilePosition + ExtentLength < ReadFileInfo->FilePosition) {
-              FilePosition += ExtentLength;
-              goto Skip_Ad;
-            }
-
-            if (FilePosition + ExtentLength > ReadFileInfo->FilePosition) {
-              Offset = ReadFileInfo->FilePosition - FilePosition;
-            } else {
-              Offset = 0;
-            }
+          }
 
-            //
-            // Done with seeking file. Start reading its data.
-            //
-            FinishedSeeking = TRUE;
-
-Skip_File_Seek:
-            //
-            // Make sure we don't read more data than really wanted.
-            //
-            if (ExtentLength - Offset > BytesLeft) {
-              DataLength = BytesLeft;
+          //
+          // Seek to the last extent starting at or before FilePosition.
+          //
+          Low  = 0;
+          High = ExtentList->ExtentCount;
+          while (Low + 1 < High) {
+            Middle = (Low + High) / 2;
+            if (ExtentList->Extents[Middle].FileOffset <= ReadFileInfo->FilePosition) {
+              Low = Middle;
             } else {
-              DataLength = ExtentLength - Offset;
-            }
-
-            //
-            // Read extent's data into FileData.
-            //
-            Status = DiskIo->ReadDisk (
-                               DiskIo,
-                               BlockIo->Media->MediaId,
-                               Offset + MultU64x32 (Lsn, LogicalBlockSize),
-                               (UINTN)DataLength,
-                               (VOID *)((UINT8 *)ReadFileInfo->FileData +
-                                        DataOffset)
-                               );
-            if (EFI_ERROR (Status)) {
-              goto Error_Read_Disk_Blk;
-            }
-
-            //
-            // Update current file's position.
-            //
-            DataOffset                 += DataLength;
-            ReadFileInfo->FilePosition += DataLength;
-
-            BytesLeft -= DataLength;
-            if (BytesLeft == 0) {
-              //
-              // There is no more file data to read.
-              //
-              Status = EFI_SUCCESS;
-              goto Done;
+              High = Middle;
             }
+          }
 
+          Status = ReadFileExtents (
+                     BlockIo,
+                     DiskIo,
+                     Volume,
+                     ExtentList,
+                     Low,
+                     ReadFileInfo->FilePosition - ExtentList->Extents[Low].FileOffset,
+                     ReadFileInfo->FileDataSize,
+                     ReadFileInfo->FileData
+                     );
+          if (EFI_ERROR (Status)) {
             break;
-        }
+          }
 
-Skip_Ad:
-        //
-        // Point to the next AD (extent).
-        //
-        AdOffset += AD_LENGTH (RecordingFlags);
+          //
+          // Update current file's position.
+          //
+          ReadFileInfo->FilePosition += ReadFileInfo->FileDataSize;
+          break;
+      }
+
+      if (LocalList.Extents != NULL) {
+        FreePool (LocalList.Extents);
       }
 
       break;
@@ -1394,25 +1543,73 @@ Skip_Ad:
       break;
   }
 
-Done:
-  if (DoFreeAed) {
-    FreePool (Data);
+  return Status;
+}
+
+/**
+  Get the cache entry of a directory holding its recorded data, reading the
+  data on the first use.
+
+  @param[in]  BlockIo             BlockIo interface.
+  @param[in]  DiskIo              DiskIo interface.
+  @param[in]  Volume              Volume information pointer.
+  @param[in]  ParentIcb           ICB of the directory.
+  @param[in]  FileEntryData       FE/EFE of the directory.
+  @param[out] Entry               The cache entry of the directory.
+
+  @retval EFI_SUCCESS             The directory data is cached in Entry.
+  @retval EFI_OUT_OF_RESOURCES    The directory was not cached due to lack of
+                                  resources.
+  @retval other                   The directory data was not read.
+
+**/
+EFI_STATUS
+GetCachedDirectory (
+  IN   EFI_BLOCK_IO_PROTOCOL           *BlockIo,
+  IN   EFI_DISK_IO_PROTOCOL            *DiskIo,
+  IN   UDF_VOLUME_INFO                 *Volume,
+  IN   UDF_LONG_ALLOCATION_DESCRIPTOR  *ParentIcb,
+  IN   VOID                            *FileEntryData,
+  OUT  UDF_CACHE_ENTRY                 **Entry
+  )
+{
+  EFI_STATUS          Status;
+  UINT64              Lsn;
+  UDF_READ_FILE_INFO  ReadFileInfo;
+
+  Status = GetLongAdLsn (Volume, ParentIcb, &Lsn);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  return Status;
+  *Entry = GetUdfCacheEntry (BlockIo, Volume, Lsn, FileEntryData, TRUE);
+  if (*Entry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-Error_Read_Disk_Blk:
-Error_Alloc_Buffer_To_Next_Ad:
-  if (ReadFileInfo->Flags != ReadFileSeekAndRead) {
-    FreePool (ReadFileInfo->FileData);
+  if ((*Entry)->DirectoryValid) {
+    return EFI_SUCCESS;
   }
 
-  if (DoFreeAed) {
-    FreePool (Data);
+  ReadFileInfo.Flags = ReadFileAllocateAndRead;
+
+  Status = ReadFile (
+             BlockIo,
+             DiskIo,
+             Volume,
+             ParentIcb,
+             FileEntryData,
+             &ReadFileInfo
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-Error_Get_Aed:
-  return Status;
+  (*Entry)->DirectoryData   = ReadFileInfo.FileData;
+  (*Entry)->DirectoryLength = ReadFileInfo.ReadLength;
+  (*Entry)->DirectoryValid  = TRUE;
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1444,9 +1641,9 @@ InternalFindFile (
 {
   EFI_STATUS                      Status;
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
-  UDF_READ_DIRECTORY_INFO         ReadDirInfo;
+  UDF_CACHE_ENTRY                 *Entry;
+  UINT64                          FidOffset;
   BOOLEAN                         Found;
-  CHAR16                          FoundFileName[UDF_FILENAME_LENGTH];
   VOID                            *CompareFileEntry;
 
   //
@@ -1487,74 +1684,55 @@ InternalFindFile (
   }
 
   //
-  // Start directory listing.
+  // Look the name up in the hashed index of the parent directory, instead of
+  // decoding and comparing the name of every FID in turn.
   //
-  ZeroMem ((VOID *)&ReadDirInfo, sizeof (UDF_READ_DIRECTORY_INFO));
-  Found = FALSE;
+  Status = GetCachedDirectory (
+             BlockIo,
+             DiskIo,
+             Volume,
+             (Parent->FileIdentifierDesc != NULL) ?
+             &Parent->FileIdentifierDesc->Icb :
+             Icb,
+             Parent->FileEntry,
+             &Entry
+             );
+  if (EFI_ERROR (Status)) {
+    return (Status == EFI_DEVICE_ERROR) ? EFI_NOT_FOUND : Status;
+  }
 
-  for ( ; ;) {
-    Status = ReadDirectoryEntry (
-               BlockIo,
-               DiskIo,
-               Volume,
-               (Parent->FileIdentifierDesc != NULL) ?
-               &Parent->FileIdentifierDesc->Icb :
-               Icb,
-               Parent->FileEntry,
-               &ReadDirInfo,
-               &FileIdentifierDesc
-               );
+  if (Entry->IndexBuckets == NULL) {
+    Status = BuildDirectoryIndex (Entry);
     if (EFI_ERROR (Status)) {
-      if (Status == EFI_DEVICE_ERROR) {
-        Status = EFI_NOT_FOUND;
-      }
-
-      break;
+      return Status;
     }
+  }
 
+  Found              = FALSE;
+  FileIdentifierDesc = NULL;
+
+  if ((StrCmp (FileName, L"..") == 0) || (StrCmp (FileName, L"\\") == 0)) {
     //
-    // After calling function ReadDirectoryEntry(), if 'FileIdentifierDesc' is
-    // NULL, then the 'Status' must be EFI_OUT_OF_RESOURCES. Hence, if the code
-    // reaches here, 'FileIdentifierDesc' must be not NULL.
-    //
-    // The ASSERT here is for addressing a false positive NULL pointer
-    // dereference issue raised from static analysis.
+    // The PARENT_FILE FID contains the location (FE/EFE) of the parent
+    // directory of this directory (Parent), and it's the expected FID for
+    // either ".." or "\\".
     //
-    ASSERT (FileIdentifierDesc != NULL);
-
-    if (FileIdentifierDesc->FileCharacteristics & PARENT_FILE) {
-      //
-      // This FID contains the location (FE/EFE) of the parent directory of this
-      // directory (Parent), and if FileName is either ".." or "\\", then it's
-      // the expected FID.
-      //
-      if ((StrCmp (FileName, L"..") == 0) || (StrCmp (FileName, L"\\") == 0)) {
-        Found = TRUE;
-        break;
-      }
-    } else {
-      Status = GetFileNameFromFid (FileIdentifierDesc, ARRAY_SIZE (FoundFileName), FoundFileName);
-      if (EFI_ERROR (Status)) {
-        break;
-      }
+    FidOffset = Entry->ParentFidOffset;
+    Status    = (FidOffset != MAX_UINT64) ? EFI_SUCCESS : EFI_NOT_FOUND;
+  } else {
+    Status = FindDirectoryIndex (Entry, FileName, &FidOffset);
+  }
 
-      if (StrCmp (FileName, FoundFileName) == 0) {
-        //
-        // FID has been found. Prepare to find its respective FE/EFE.
-        //
-        Found = TRUE;
-        break;
-      }
+  if (!EFI_ERROR (Status)) {
+    DuplicateFid (
+      GET_FID_FROM_ADS (Entry->DirectoryData, FidOffset),
+      &FileIdentifierDesc
+      );
+    if (FileIdentifierDesc == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
-    FreePool ((VOID *)FileIdentifierDesc);
-  }
-
-  if (ReadDirInfo.DirectoryData != NULL) {
-    //
-    // Free all allocated resources for the directory listing.
-    //
-    FreePool (ReadDirInfo.DirectoryData);
+    Found = TRUE;
   }
 
   if (Found) {
@@ -1629,6 +1807,11 @@ ReadUdfVolumeInformation (
 {
   EFI_STATUS  Status;
 
+  //
+  // Drop everything cached from a previous medium.
+  //
+  FreeUdfCache (Volume);
+
   //
   // Read all necessary UDF volume information and keep it private to the driver
   //
@@ -1741,12 +1924,19 @@ FindFileEntry (
   UINT32              LogicalBlockSize;
   UDF_DESCRIPTOR_TAG  *DescriptorTag;
   VOID                *ReadBuffer;
+  UDF_CACHE_ENTRY     *Entry;
 
   Status = GetLongAdLsn (Volume, Icb, &Lsn);
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  Entry = GetUdfCacheEntry (BlockIo, Volume, Lsn, NULL, FALSE);
+  if (Entry != NULL) {
+    *FileEntry = AllocateCopyPool (Volume->FileEntrySize, Entry->FileEntry);
+    return (*FileEntry == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+  }
+
   LogicalBlockSize = Volume->LogicalVolDesc.LogicalBlockSize;
 
   ReadBuffer = AllocateZeroPool (Volume->FileEntrySize);
@@ -1781,6 +1971,12 @@ FindFileEntry (
     goto Error_Invalid_Fe;
   }
 
+  //
+  // Keep a copy for the next lookup. Running out of cache entries is not an
+  // error since the FE/EFE can always be read again.
+  //
+  GetUdfCacheEntry (BlockIo, Volume, Lsn, ReadBuffer, TRUE);
+
   *FileEntry = ReadBuffer;
   return EFI_SUCCESS;
 
@@ -1980,33 +2176,40 @@ ReadDirectoryEntry (
   )
 {
   EFI_STATUS                      Status;
-  UDF_READ_FILE_INFO              ReadFileInfo;
+  UDF_CACHE_ENTRY                 *Entry;
   UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc;
 
   if (ReadDirInfo->DirectoryData == NULL) {
     //
-    // The directory's recorded data has not been read yet. So let's cache it
-    // into memory and the next calls won't need to read it again.
+    // The directory's recorded data has not been read yet. Take a private copy
+    // of the cached data, so the listing survives eviction of the cache entry.
     //
-    ReadFileInfo.Flags = ReadFileAllocateAndRead;
-
-    Status = ReadFile (
+    Status = GetCachedDirectory (
                BlockIo,
                DiskIo,
                Volume,
                ParentIcb,
                FileEntryData,
-               &ReadFileInfo
+               &Entry
                );
     if (EFI_ERROR (Status)) {
       return Status;
     }
 
+    if (Entry->DirectoryLength > 0) {
+      ReadDirInfo->DirectoryData = AllocateCopyPool (
+                                     (UINTN)Entry->DirectoryLength,
+                                     Entry->DirectoryData
+                                     );
+      if (ReadDirInfo->DirectoryData == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+
     //
     // Fill in ReadDirInfo structure with the read directory's data information.
     //
-    ReadDirInfo->DirectoryData   = ReadFileInfo.FileData;
-    ReadDirInfo->DirectoryLength = ReadFileInfo.ReadLength;
+    ReadDirInfo->DirectoryLength = Entry->DirectoryLength;
   }
 
   do {
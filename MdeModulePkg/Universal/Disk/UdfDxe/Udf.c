@@ -176,6 +176,8 @@ UdfDriverBindingStart (
   PrivFsData->DiskIo    = DiskIo;
   PrivFsData->Handle    = ControllerHandle;
 
+  InitializeUdfCache (&PrivFsData->Volume);
+
   //
   // Set up SimpleFs protocol
   //
@@ -273,6 +275,7 @@ UdfDriverBindingStop (
                     NULL
                     );
 
+    FreeUdfCache (&PrivFsData->Volume);
     FreePool ((VOID *)PrivFsData);
   }
 
@@ -309,6 +309,57 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Cache of parsed FE/EFEs, kept per volume and keyed by the logical sector
+// number of the FE/EFE. Besides a copy of the FE/EFE, an entry holds the
+// file's extent list and, for directories, the directory data and a hashed
+// index of its FIDs, so that opens and reads do not parse the same on-disk
+// structures again.
+//
+#define UDF_CACHE_MAX_ENTRIES  64
+#define UDF_CACHE_BUCKETS      16
+
+#define UDF_CACHE_BUCKET(_Lsn)  ((UINTN)(_Lsn) & (UDF_CACHE_BUCKETS - 1))
+
+typedef struct {
+  UINT64    FileOffset;
+  UINT64    Lsn;
+  UINT32    Length;
+} UDF_FILE_EXTENT;
+
+typedef struct {
+  UDF_FILE_EXTENT    *Extents;
+  UINTN              ExtentCount;
+  UINT64             Length;
+} UDF_FILE_EXTENT_LIST;
+
+#define UDF_DIRECTORY_INDEX_END  MAX_UINT32
+
+typedef struct {
+  UINT32    Hash;
+  UINT32    Next;
+  UINT64    FidOffset;
+} UDF_DIRECTORY_INDEX_ENTRY;
+
+#define UDF_CACHE_ENTRY_SIGNATURE  SIGNATURE_32 ('U', 'd', 'f', 'c')
+
+typedef struct {
+  UINTN                        Signature;
+  LIST_ENTRY                   HashLink;
+  LIST_ENTRY                   LruLink;
+  UINT64                       Lsn;
+  VOID                         *FileEntry;
+  BOOLEAN                      ExtentsValid;
+  UDF_FILE_EXTENT_LIST         ExtentList;
+  BOOLEAN                      DirectoryValid;
+  VOID                         *DirectoryData;
+  UINT64                       DirectoryLength;
+  UINT64                       ParentFidOffset;
+  UINT32                       IndexBucketCount;
+  UINT32                       *IndexBuckets;
+  UDF_DIRECTORY_INDEX_ENTRY    *IndexEntries;
+} UDF_CACHE_ENTRY;
+
 //
 // UDF filesystem driver's private data
 //
@@ -318,6 +369,10 @@ typedef struct {
   UDF_PARTITION_DESCRIPTOR         PartitionDesc;
   UDF_FILE_SET_DESCRIPTOR          FileSetDesc;
   UINTN                            FileEntrySize;
+  UINT32                           CacheMediaId;
+  UINTN                            CacheCount;
+  LIST_ENTRY                       CacheLru;
+  LIST_ENTRY                       CacheBuckets[UDF_CACHE_BUCKETS];
 } UDF_VOLUME_INFO;
 
 typedef struct {
@@ -633,6 +688,100 @@ UdfFlush (
   IN EFI_FILE_PROTOCOL  *This
   );
 
+/**
+  Initialize the FE/EFE cache of a volume.
+
+  @param[out] Volume    UDF volume information structure.
+
+**/
+VOID
+InitializeUdfCache (
+  OUT UDF_VOLUME_INFO  *Volume
+  );
+
+/**
+  Free all entries of the FE/EFE cache of a volume.
+
+  @param[in, out] Volume    UDF volume information structure.
+
+**/
+VOID
+FreeUdfCache (
+  IN OUT UDF_VOLUME_INFO  *Volume
+  );
+
+/**
+  Look up the cache entry of a FE/EFE.
+
+  If FileEntry is not NULL, the entry is only returned if it caches the same
+  FE/EFE. If Add is TRUE, FileEntry is known to be the FE/EFE recorded at Lsn
+  and a missing or stale entry is (re)created from it.
+
+  @param[in] BlockIo    BlockIo interface.
+  @param[in] Volume     UDF volume information structure.
+  @param[in] Lsn        Logical sector number of the FE/EFE.
+  @param[in] FileEntry  FE/EFE to match, or NULL to match any.
+  @param[in] Add        Whether to add FileEntry to the cache on a miss.
+
+  @return The cache entry, or NULL if it is not cached.
+
+**/
+UDF_CACHE_ENTRY *
+GetUdfCacheEntry (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN UDF_VOLUME_INFO        *Volume,
+  IN UINT64                 Lsn,
+  IN VOID                   *FileEntry  OPTIONAL,
+  IN BOOLEAN                Add
+  );
+
+/**
+  Build the hashed FID index of a cached directory. The directory data must
+  have been read into the cache entry.
+
+  @param[in, out] Entry   Cache entry of the directory.
+
+  @retval EFI_SUCCESS           The index was built.
+  @retval EFI_OUT_OF_RESOURCES  The index was not built due to lack of
+                                resources.
+
+**/
+EFI_STATUS
+BuildDirectoryIndex (
+  IN OUT UDF_CACHE_ENTRY  *Entry
+  );
+
+/**
+  Find a FID by file name in the index of a cached directory.
+
+  @param[in]  Entry       Cache entry of the directory.
+  @param[in]  FileName    File name to look up.
+  @param[out] FidOffset   Offset of the FID in the directory data.
+
+  @retval EFI_SUCCESS     The FID was found.
+  @retval EFI_NOT_FOUND   There is no such file in the directory.
+
+**/
+EFI_STATUS
+FindDirectoryIndex (
+  IN  UDF_CACHE_ENTRY  *Entry,
+  IN  CHAR16           *FileName,
+  OUT UINT64           *FidOffset
+  );
+
+/**
+  Calculate length of a given File Identifier Descriptor.
+
+  @param[in]  FileIdentifierDesc  File Identifier Descriptor pointer.
+
+  @return The length of a given File Identifier Descriptor.
+
+**/
+UINT64
+GetFidDescriptorLength (
+  IN UDF_FILE_IDENTIFIER_DESCRIPTOR  *FileIdentifierDesc
+  );
+
 /**
   Read volume information on a medium which contains a valid UDF file system.
 
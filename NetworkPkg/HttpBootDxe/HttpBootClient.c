@@ -597,26 +597,27 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance with the station address of the driver.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       The HttpIo callback function, NULL if no callback is needed.
+  @param[out]   HttpIo         The HttpIo to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootInitHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     HTTP_IO_CALLBACK        Callback  OPTIONAL,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
-  ASSERT (Private != NULL);
-
   //
   // Get HTTP timeout value
   //
@@ -636,15 +637,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootInitHttpIo (Private, HttpBootHttpIoCallback, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -1088,6 +1110,553 @@ EXIT:
   return Status;
 }
 
+/**
+  Parse the value of a Content-Range header in the form of
+  "bytes <first-byte-pos>-<last-byte-pos>/<complete-length>".
+
+  @param[in]   Value           The value of the Content-Range header.
+  @param[out]  First           The first byte position of the range.
+  @param[out]  Last            The last byte position of the range.
+  @param[out]  Total           The complete length of the file.
+
+  @retval EFI_SUCCESS          The value is parsed.
+  @retval EFI_UNSUPPORTED      The value is not a byte range of a file of known length.
+
+**/
+EFI_STATUS
+HttpBootParseContentRange (
+  IN  CHAR8  *Value,
+  OUT UINTN  *First,
+  OUT UINTN  *Last,
+  OUT UINTN  *Total
+  )
+{
+  CHAR8  *Char;
+
+  if (AsciiStrnCmp (Value, "bytes ", 6) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Char = Value + 6;
+  if (!NET_IS_DIGIT (*Char)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *First = AsciiStrDecimalToUintn (Char);
+
+  Char = AsciiStrStr (Char, "-");
+  if ((Char == NULL) || !NET_IS_DIGIT (Char[1])) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Last = AsciiStrDecimalToUintn (Char + 1);
+
+  //
+  // The complete length is "*" if the server does not know it.
+  //
+  Char = AsciiStrStr (Char, "/");
+  if ((Char == NULL) || !NET_IS_DIGIT (Char[1])) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Total = AsciiStrDecimalToUintn (Char + 1);
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue the response token of a byte range connection. The response header is
+  received first, then the message-body is received directly into the segment
+  of the boot file buffer.
+
+  @param[in, out]  Connection      The byte range connection.
+  @param[in]       Buffer          The memory buffer to transfer the boot file to.
+
+  @retval EFI_SUCCESS              The response token is queued.
+  @retval Others                   Failed to queue the response token.
+
+**/
+EFI_STATUS
+HttpBootRangeQueueResponse (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Buffer
+  )
+{
+  HTTP_IO           *HttpIo;
+  EFI_HTTP_MESSAGE  *Message;
+
+  HttpIo  = &Connection->HttpIo;
+  Message = HttpIo->RspToken.Message;
+
+  if (!Connection->HeaderReceived) {
+    ZeroMem (&Connection->Response, sizeof (EFI_HTTP_RESPONSE_DATA));
+    Message->Data.Response = &Connection->Response;
+    Message->BodyLength    = 0;
+    Message->Body          = NULL;
+  } else {
+    Message->Data.Response = NULL;
+    Message->BodyLength    = Connection->RangeLength - Connection->ReceivedSize;
+    Message->Body          = Buffer + Connection->RangeStart + Connection->ReceivedSize;
+  }
+
+  Message->HeaderCount    = 0;
+  Message->Headers        = NULL;
+  HttpIo->RspToken.Status = EFI_NOT_READY;
+  HttpIo->IsRxDone        = FALSE;
+
+  return HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+}
+
+/**
+  Request a segment of the boot file on a byte range connection.
+
+  @param[in, out]  Connection      The byte range connection, which must be idle.
+  @param[in]       RequestData     The GET request of the boot file.
+  @param[in]       HttpIoHeader    The request headers, the Range header is updated.
+  @param[in]       RangeStart      The offset of the segment in the boot file.
+  @param[in]       RangeLength     The length of the segment in bytes.
+  @param[in]       Buffer          The memory buffer to transfer the boot file to.
+
+  @retval EFI_SUCCESS              The request is sent and the response token is queued.
+  @retval Others                   Failed to send the request.
+
+**/
+EFI_STATUS
+HttpBootRangeSendRequest (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     EFI_HTTP_REQUEST_DATA       *RequestData,
+  IN     HTTP_IO_HEADER              *HttpIoHeader,
+  IN     UINTN                       RangeStart,
+  IN     UINTN                       RangeLength,
+  IN     UINT8                       *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       RangeValue[64];
+
+  ASSERT (!Connection->Busy && (RangeLength != 0));
+
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "bytes=%lu-%lu",
+    (UINT64)RangeStart,
+    (UINT64)(RangeStart + RangeLength - 1)
+    );
+  Status = HttpIoSetHeader (HttpIoHeader, "Range", RangeValue);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIoSendRequest (
+             &Connection->HttpIo,
+             RequestData,
+             HttpIoHeader->HeaderCount,
+             HttpIoHeader->Headers,
+             0,
+             NULL
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connection->Busy           = TRUE;
+  Connection->HeaderReceived = FALSE;
+  Connection->RangeStart     = RangeStart;
+  Connection->RangeLength    = RangeLength;
+  Connection->ReceivedSize   = 0;
+
+  return HttpBootRangeQueueResponse (Connection, Buffer);
+}
+
+/**
+  Check the response header received on a byte range connection. The server
+  must return exactly the segment requested, of a file of the size the HEAD
+  request reported.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Connection      The byte range connection.
+
+  @retval EFI_SUCCESS              The server returned the segment requested.
+  @retval EFI_UNSUPPORTED          The server returned something else.
+
+**/
+EFI_STATUS
+HttpBootRangeCheckHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection
+  )
+{
+  EFI_STATUS        Status;
+  EFI_HTTP_MESSAGE  *Message;
+  EFI_HTTP_HEADER   *HttpHeader;
+  UINTN             First;
+  UINTN             Last;
+  UINTN             Total;
+
+  Message = Connection->HttpIo.RspToken.Message;
+  Status  = EFI_UNSUPPORTED;
+
+  if (Connection->Response.StatusCode == HTTP_STATUS_206_PARTIAL_CONTENT) {
+    HttpHeader = HttpFindHeader (
+                   Message->HeaderCount,
+                   Message->Headers,
+                   HTTP_HEADER_CONTENT_RANGE
+                   );
+    if ((HttpHeader != NULL) &&
+        !EFI_ERROR (HttpBootParseContentRange (HttpHeader->FieldValue, &First, &Last, &Total)) &&
+        (First == Connection->RangeStart) &&
+        (Last == Connection->RangeStart + Connection->RangeLength - 1) &&
+        (Total == Private->BootFileSize))
+    {
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_WARN,
+      "HttpBootRangeCheckHeader: Unexpected response (status code %d) to the range request at %lu.\n",
+      Connection->Response.StatusCode,
+      (UINT64)Connection->RangeStart
+      ));
+  }
+
+  HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+  Message->Headers           = NULL;
+  Message->HeaderCount       = 0;
+  Connection->HeaderReceived = TRUE;
+
+  return Status;
+}
+
+/**
+  Process the completed response token of a byte range connection, and queue
+  the next one until the whole segment is received.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Connection      The byte range connection.
+  @param[in]       Buffer          The memory buffer to transfer the boot file to.
+
+  @retval EFI_SUCCESS              The response is processed. Connection->Busy is
+                                   cleared if the whole segment is received.
+  @retval Others                   The response is an error.
+
+**/
+EFI_STATUS
+HttpBootRangeProcessResponse (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Buffer
+  )
+{
+  EFI_STATUS        Status;
+  EFI_HTTP_MESSAGE  *Message;
+
+  Connection->HttpIo.IsRxDone = FALSE;
+  Message                     = Connection->HttpIo.RspToken.Message;
+  Status                      = Connection->HttpIo.RspToken.Status;
+
+  if (!Connection->HeaderReceived) {
+    if ((Status == EFI_SUCCESS) || (Status == EFI_HTTP_ERROR)) {
+      Status = HttpBootRangeCheckHeader (Private, Connection);
+    }
+  } else if (!EFI_ERROR (Status)) {
+    Connection->ReceivedSize += Message->BodyLength;
+    if (Private->HttpBootCallback != NULL) {
+      Status = Private->HttpBootCallback->Callback (
+                                            Private->HttpBootCallback,
+                                            HttpBootHttpEntityBody,
+                                            TRUE,
+                                            (UINT32)Message->BodyLength,
+                                            Message->Body
+                                            );
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Connection->ReceivedSize < Connection->RangeLength) {
+    return HttpBootRangeQueueResponse (Connection, Buffer);
+  }
+
+  Connection->Busy = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file over several HTTP connections in parallel. The file
+  is split into segments, and every connection requests one segment at a time
+  with a Range header, so that a single TCP stream that is limited by the
+  latency to the server does not limit the download. The segments are
+  received directly into the caller's buffer.
+
+  The size and the image type of the boot file, and whether the server
+  accepts byte range requests, must have been got by a HEAD request before.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[out]      Buffer          The memory buffer to transfer the file to, which
+                                   is at least Private->BootFileSize bytes.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval EFI_UNSUPPORTED          The server did not return the range requested.
+  @retval EFI_TIMEOUT              No data was received on any connection within
+                                   PcdHttpIoTimeout milliseconds.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  OUT    UINT8                   *Buffer
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CONNECTION  *Connections;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  HTTP_IO_HEADER              *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA       RequestData;
+  EFI_HTTP_MESSAGE            RequestMessage;
+  EFI_EVENT                   TimeoutEvent;
+  CHAR8                       *HostName;
+  CHAR8                       BaseAuthValue[80];
+  UINT64                      Timeout;
+  UINTN                       Count;
+  UINTN                       Index;
+  UINTN                       Active;
+  UINTN                       SegmentSize;
+  UINTN                       NextOffset;
+  UINTN                       Length;
+
+  Connections  = NULL;
+  TimeoutEvent = NULL;
+
+  //
+  // Split the file into about HTTP_BOOT_RANGE_SEGMENTS_PER_CONNECTION segments
+  // per connection, and don't open more connections than segments.
+  //
+  Count       = MIN (PcdGet8 (PcdHttpBootRangeConnections), HTTP_BOOT_RANGE_MAX_CONNECTIONS);
+  SegmentSize = MAX (
+                  Private->BootFileSize / (Count * HTTP_BOOT_RANGE_SEGMENTS_PER_CONNECTION),
+                  HTTP_BOOT_RANGE_MIN_SEGMENT_SIZE
+                  );
+  Count = MIN (Count, (Private->BootFileSize + SegmentSize - 1) / SegmentSize);
+  ASSERT (Count > 1);
+
+  //
+  // Build the request headers shared by all connections:
+  //       Host
+  //       Accept
+  //       User-Agent
+  //       [Authorization]
+  //       Range
+  //       [If-Match]|[If-Unmodified-Since]
+  // The If-Match or If-Unmodified-Since header makes sure that all segments
+  // are from the same version of the file.
+  //
+  HttpIoHeader = HttpIoCreateHeader (6);
+  if (HttpIoHeader == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (Private->AuthData != NULL) {
+    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+      Status = EFI_UNSUPPORTED;
+      goto ON_EXIT;
+    }
+
+    AsciiSPrint (BaseAuthValue, sizeof (BaseAuthValue), "%a %a", "Basic", Private->AuthData);
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_AUTHORIZATION, BaseAuthValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  if (Private->LastModifiedOrEtag != NULL) {
+    Status = HttpIoSetHeader (
+               HttpIoHeader,
+               Private->LastModifiedOrEtag[0] == '"' ? HTTP_HEADER_IF_MATCH : HTTP_HEADER_IF_UNMODIFIED_SINCE,
+               Private->LastModifiedOrEtag
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  //
+  // Open the connections. Go on with fewer connections if the HTTP driver
+  // runs out of resources.
+  //
+  Connections = AllocateZeroPool (Count * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  if (Connections == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = HttpBootInitHttpIo (Private, NULL, &Connections[Index].HttpIo);
+    if (EFI_ERROR (Status)) {
+      if (Index == 0) {
+        goto ON_EXIT;
+      }
+
+      Count = Index;
+      break;
+    }
+
+    Connections[Index].Created = TRUE;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimeoutEvent);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpBootGetBootFileByRange: Download %lu bytes over %d connections in segments of %lu bytes.\n",
+    (UINT64)Private->BootFileSize,
+    (UINT32)Count,
+    (UINT64)SegmentSize
+    ));
+
+  if (Private->HttpBootCallback != NULL) {
+    ZeroMem (&RequestMessage, sizeof (EFI_HTTP_MESSAGE));
+    RequestMessage.Data.Request = &RequestData;
+    RequestMessage.HeaderCount  = HttpIoHeader->HeaderCount;
+    RequestMessage.Headers      = HttpIoHeader->Headers;
+    Status                      = Private->HttpBootCallback->Callback (
+                                                               Private->HttpBootCallback,
+                                                               HttpBootHttpRequest,
+                                                               FALSE,
+                                                               sizeof (EFI_HTTP_MESSAGE),
+                                                               &RequestMessage
+                                                               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Hand out the segments in order to the idle connections, until the whole
+  // file is received. The download fails if no connection makes progress
+  // within the HTTP IO timeout.
+  //
+  Timeout    = MultU64x32 (Connections[0].HttpIo.Timeout, TICKS_PER_MS);
+  NextOffset = 0;
+  Status     = gBS->SetTimer (TimeoutEvent, TimerRelative, Timeout);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  do {
+    Active = 0;
+    for (Index = 0; Index < Count; Index++) {
+      Connection = &Connections[Index];
+
+      if (Connection->Busy && Connection->HttpIo.IsRxDone) {
+        Status = HttpBootRangeProcessResponse (Private, Connection, Buffer);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+
+        gBS->SetTimer (TimeoutEvent, TimerRelative, Timeout);
+      }
+
+      if (!Connection->Busy && (NextOffset < Private->BootFileSize)) {
+        Length = MIN (SegmentSize, Private->BootFileSize - NextOffset);
+        Status = HttpBootRangeSendRequest (Connection, &RequestData, HttpIoHeader, NextOffset, Length, Buffer);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+
+        NextOffset += Length;
+      }
+
+      if (Connection->Busy) {
+        Active++;
+        Connection->HttpIo.Http->Poll (Connection->HttpIo.Http);
+      }
+    }
+
+    if ((Active != 0) && !EFI_ERROR (gBS->CheckEvent (TimeoutEvent))) {
+      Status = EFI_TIMEOUT;
+      goto ON_EXIT;
+    }
+  } while (Active != 0);
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  if (TimeoutEvent != NULL) {
+    gBS->CloseEvent (TimeoutEvent);
+  }
+
+  if (Connections != NULL) {
+    for (Index = 0; Index < Count; Index++) {
+      Connection = &Connections[Index];
+      if (!Connection->Created) {
+        continue;
+      }
+
+      if (Connection->Busy) {
+        //
+        // Abort the outstanding token and let its DPC run while the
+        // connection is still valid.
+        //
+        Connection->HttpIo.Http->Cancel (Connection->HttpIo.Http, NULL);
+        DispatchDpc ();
+        if (!Connection->HeaderReceived) {
+          HttpFreeHeaderFields (
+            Connection->HttpIo.RspToken.Message->Headers,
+            Connection->HttpIo.RspToken.Message->HeaderCount
+            );
+        }
+      }
+
+      HttpIoDestroyIo (&Connection->HttpIo);
+    }
+
+    FreePool (Connections);
+  }
+
+  HttpIoFreeHeader (HttpIoHeader);
+  return Status;
+}
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -1193,6 +1762,29 @@ HttpBootGetBootFile (
   // Not found in cache, try to download it through HTTP.
   //
 
+  //
+  // Download a large file over several connections in parallel if the server
+  // accepts byte range requests. Fall back to a single connection if anything
+  // goes wrong, e.g. a server or a cache in the way ignores the Range header.
+  //
+  if (!HeaderOnly && !ResumingOperation && (Buffer != NULL) &&
+      Private->AcceptRanges && (Private->ProxyUri == NULL) &&
+      (Private->BootFileSize >= HTTP_BOOT_RANGE_MIN_FILE_SIZE) &&
+      (*BufferSize >= Private->BootFileSize) &&
+      (PcdGet8 (PcdHttpBootRangeConnections) > 1))
+  {
+    Status = HttpBootGetBootFileByRange (Private, Url, Buffer);
+    if (!EFI_ERROR (Status)) {
+      *BufferSize = Private->BootFileSize;
+      *ImageType  = Private->ImageType;
+      FreePool (Url);
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFile: Ranged download failed - %r, use a single connection.\n", Status));
+    Private->AcceptRanges = FALSE;
+  }
+
   //
   // 1. Create a temp cache item for the requested URI if caller doesn't provide buffer.
   //
@@ -1543,6 +2135,18 @@ HttpBootGetBootFile (
     Private->LastModifiedOrEtag = AllocateCopyPool (AsciiStrSize (HttpHeader->FieldValue), HttpHeader->FieldValue);
   }
 
+  //
+  // 3.2.1 Record whether the server accepts byte range requests.
+  //
+  if (!ResumingOperation) {
+    HttpHeader = HttpFindHeader (
+                   ResponseData->HeaderCount,
+                   ResponseData->Headers,
+                   HTTP_HEADER_ACCEPT_RANGES
+                   );
+    Private->AcceptRanges = (BOOLEAN)((HttpHeader != NULL) && (AsciiStrStr (HttpHeader->FieldValue, "bytes") != NULL));
+  }
+
   //
   // 3.2.2 Validate the range response. If operation is being resumed,
   // server must respond with Content-Range.
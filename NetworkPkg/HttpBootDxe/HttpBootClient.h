@@ -14,6 +14,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT          "UefiHttpBoot/1.0"
 #define HTTP_BOOT_AUTHENTICATION_INFO_MAX_LEN  255
 
+//
+// A boot file of at least HTTP_BOOT_RANGE_MIN_FILE_SIZE bytes is downloaded
+// over up to PcdHttpBootRangeConnections connections in parallel if the server
+// accepts byte range requests. The file is split into about
+// HTTP_BOOT_RANGE_SEGMENTS_PER_CONNECTION segments per connection, so that a
+// fast connection takes over the work of a slow one.
+//
+#define HTTP_BOOT_RANGE_MIN_FILE_SIZE            SIZE_4MB
+#define HTTP_BOOT_RANGE_MIN_SEGMENT_SIZE         SIZE_1MB
+#define HTTP_BOOT_RANGE_SEGMENTS_PER_CONNECTION  4
+#define HTTP_BOOT_RANGE_MAX_CONNECTIONS          16
+
 //
 // Record the data length and start address of a data block.
 //
@@ -58,6 +70,20 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// A connection of a byte range download, see HttpBootGetBootFileByRange().
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   Created;
+  BOOLEAN                   Busy;           // A request is outstanding.
+  BOOLEAN                   HeaderReceived; // The response header of the request is received.
+  UINTN                     RangeStart;     // The first byte of the segment requested.
+  UINTN                     RangeLength;
+  UINTN                     ReceivedSize;
+  EFI_HTTP_RESPONSE_DATA    Response;
+} HTTP_BOOT_RANGE_CONNECTION;
+
 /**
   Discover all the boot information for boot file.
 
@@ -216,6 +216,7 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   UINTN                                        BootFileSize;
   UINTN                                        PartialTransferredSize;
   CHAR8                                        *LastModifiedOrEtag;
+  BOOLEAN                                      AcceptRanges;
   BOOLEAN                                      NoGateway;
   HTTP_BOOT_IMAGE_TYPE                         ImageType;
 
@@ -584,6 +584,7 @@ HttpBootStop (
   Private->SelectIndex            = 0;
   Private->SelectProxyType        = HttpOfferTypeMax;
   Private->PartialTransferredSize = 0;
+  Private->AcceptRanges           = FALSE;
 
   if (!Private->UsingIpv6) {
     //
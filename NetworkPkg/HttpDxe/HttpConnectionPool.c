@@ -0,0 +1,768 @@
+/** @file
+  Keep-alive connection pool and connection latency counters of HttpDxe.
+
+  Clients such as Redfish create a new HTTP child for every request, and
+  every child used to do the DNS query, the TCP handshake and the TLS
+  handshake again. When an HTTP child is destroyed or reset with an idle
+  keep-alive connection, the TCP child and the TLS child are moved to the
+  pool of the HTTP service instead, and the next HTTP child requesting the
+  same origin continues to use them.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpDriver.h"
+
+/**
+  Check whether the TCP connection is still established.
+
+  @param[in]  UsingIpv6           Use Tcp6 if TRUE, Tcp4 otherwise.
+  @param[in]  Tcp4                The TCP4 protocol of the connection.
+  @param[in]  Tcp6                The TCP6 protocol of the connection.
+
+  @retval TRUE                    The connection is established.
+  @retval FALSE                   The connection is closed or closing.
+
+**/
+BOOLEAN
+HttpConnectionIsEstablished (
+  IN BOOLEAN            UsingIpv6,
+  IN EFI_TCP4_PROTOCOL  *Tcp4,
+  IN EFI_TCP6_PROTOCOL  *Tcp6
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+
+  if (!UsingIpv6) {
+    Status = Tcp4->GetModeData (Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp4State == Tcp4StateEstablished));
+  }
+
+  Status = Tcp6->GetModeData (Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+  return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp6State == Tcp6StateEstablished));
+}
+
+/**
+  Close a pooled connection and free it.
+
+  @param[in]  HttpService         The HTTP service that owns the pool.
+  @param[in]  Connection          The pooled connection.
+
+**/
+VOID
+HttpConnectionPoolClose (
+  IN HTTP_SERVICE            *HttpService,
+  IN HTTP_POOLED_CONNECTION  *Connection
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  RemoveEntryList (&Connection->Link);
+  HttpService->ConnectionPoolCount--;
+  gBS->RestoreTPL (OldTpl);
+
+  HttpDumpConnectionStatistics (&Connection->ConnStats);
+
+  //
+  // Configure (NULL) resets the connection without waiting for the peer.
+  //
+  if (!Connection->UsingIpv6) {
+    Connection->Tcp4->Configure (Connection->Tcp4, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  } else {
+    Connection->Tcp6->Configure (Connection->Tcp6, NULL);
+
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  }
+
+  if (Connection->TlsChildHandle != NULL) {
+    Connection->TlsSb->DestroyChild (Connection->TlsSb, Connection->TlsChildHandle);
+  }
+
+  gBS->CloseEvent (Connection->IdleTimer);
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+}
+
+/**
+  Find a pooled connection to the origin an HTTP child requests. The
+  connections that idled too long or were closed by the server meanwhile
+  are closed on the way.
+
+  @param[in]  HttpInstance        Pointer to HTTP_PROTOCOL structure.
+  @param[in]  HostName            The host name of the request URL.
+  @param[in]  RemotePort          The port of the request URL.
+
+  @return The pooled connection, or NULL if there is none.
+
+**/
+HTTP_POOLED_CONNECTION *
+HttpConnectionPoolFind (
+  IN HTTP_PROTOCOL  *HttpInstance,
+  IN CHAR8          *HostName,
+  IN UINT16         RemotePort
+  )
+{
+  HTTP_SERVICE            *HttpService;
+  HTTP_POOLED_CONNECTION  *Connection;
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+
+  HttpService = HttpInstance->Service;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->ConnectionPool) {
+    Connection = NET_LIST_USER_STRUCT_S (Entry, HTTP_POOLED_CONNECTION, Link, HTTP_POOLED_CONNECTION_SIGNATURE);
+
+    if (!EFI_ERROR (gBS->CheckEvent (Connection->IdleTimer)) ||
+        !HttpConnectionIsEstablished (Connection->UsingIpv6, Connection->Tcp4, Connection->Tcp6))
+    {
+      HttpConnectionPoolClose (HttpService, Connection);
+      continue;
+    }
+
+    if ((Connection->UsingIpv6 != HttpInstance->LocalAddressIsIPv6) ||
+        (Connection->UseHttps != HttpInstance->UseHttps) ||
+        (Connection->RemotePort != RemotePort) ||
+        (AsciiStrCmp (Connection->RemoteHost, HostName) != 0))
+    {
+      continue;
+    }
+
+    //
+    // The local end of the connection must be what the HTTP child is configured for.
+    //
+    if (!Connection->UsingIpv6) {
+      if ((Connection->IPv4Node.UseDefaultAddress != HttpInstance->IPv4Node.UseDefaultAddress) ||
+          (Connection->IPv4Node.LocalPort != HttpInstance->IPv4Node.LocalPort))
+      {
+        continue;
+      }
+
+      if (!Connection->IPv4Node.UseDefaultAddress &&
+          (!EFI_IP4_EQUAL (&Connection->IPv4Node.LocalAddress, &HttpInstance->IPv4Node.LocalAddress) ||
+           !EFI_IP4_EQUAL (&Connection->IPv4Node.LocalSubnet, &HttpInstance->IPv4Node.LocalSubnet)))
+      {
+        continue;
+      }
+    } else {
+      if ((Connection->Ipv6Node.LocalPort != HttpInstance->Ipv6Node.LocalPort) ||
+          !EFI_IP6_EQUAL (&Connection->Ipv6Node.LocalAddress, &HttpInstance->Ipv6Node.LocalAddress))
+      {
+        continue;
+      }
+    }
+
+    return Connection;
+  }
+
+  return NULL;
+}
+
+/**
+  Hand the idle keep-alive connection of an HTTP child over to the connection
+  pool of its service.
+
+  The connection is pooled only if it is established, the last response has
+  been received completely and the server did not ask to close it. On success
+  the TCP child and the TLS child are detached from HttpInstance, so that the
+  clean up of HttpInstance leaves them alone.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+  @retval TRUE                    The connection is pooled.
+  @retval FALSE                   The connection is not pooled.
+
+**/
+BOOLEAN
+HttpConnectionPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE            *HttpService;
+  HTTP_POOLED_CONNECTION  *Connection;
+  EFI_TLS_VERIFY          VerifyMethod;
+  UINT8                   TlsConfigDigest[SHA256_DIGEST_SIZE];
+  UINTN                   DataSize;
+  EFI_STATUS              Status;
+  EFI_TPL                 OldTpl;
+
+  HttpService  = HttpInstance->Service;
+  VerifyMethod = EFI_TLS_VERIFY_NONE;
+
+  if ((PcdGet8 (PcdHttpConnectionPoolSize) == 0) ||
+      (HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      HttpInstance->ConnectionClose ||
+      HttpInstance->ProxyConnected ||
+      HttpInstance->ResponsePending ||
+      (HttpInstance->RemoteHost == NULL) ||
+      (HttpInstance->CacheBody != NULL) ||
+      (NetMapGetCount (&HttpInstance->TxTokens) != 0) ||
+      (NetMapGetCount (&HttpInstance->RxTokens) != 0))
+  {
+    return FALSE;
+  }
+
+  //
+  // The rest of the last response would be taken for the next one.
+  //
+  if ((HttpInstance->MsgParser != NULL) && !HttpIsMessageComplete (HttpInstance->MsgParser)) {
+    return FALSE;
+  }
+
+  if (HttpInstance->UseHttps) {
+    if (!HttpInstance->TlsAlreadyCreated || (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring)) {
+      return FALSE;
+    }
+
+    DataSize = sizeof (EFI_TLS_VERIFY);
+    Status   = HttpInstance->Tls->GetSessionData (HttpInstance->Tls, EfiTlsVerifyMethod, &VerifyMethod, &DataSize);
+    if (EFI_ERROR (Status)) {
+      return FALSE;
+    }
+
+    //
+    // The session is reused only with the configuration it was established with.
+    //
+    Status = TlsGetConfigDigest (HttpInstance, TlsConfigDigest);
+    if (EFI_ERROR (Status)) {
+      return FALSE;
+    }
+  }
+
+  if (!HttpConnectionIsEstablished (HttpInstance->LocalAddressIsIPv6, HttpInstance->Tcp4, HttpInstance->Tcp6)) {
+    return FALSE;
+  }
+
+  Connection = AllocateZeroPool (sizeof (HTTP_POOLED_CONNECTION));
+  if (Connection == NULL) {
+    return FALSE;
+  }
+
+  Connection->RemoteHost = AllocateCopyPool (AsciiStrSize (HttpInstance->RemoteHost), HttpInstance->RemoteHost);
+  if (Connection->RemoteHost == NULL) {
+    goto ON_ERROR;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &Connection->IdleTimer);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = gBS->SetTimer (Connection->IdleTimer, TimerRelative, HTTP_CONNECTION_POOL_IDLE_TIMEOUT * TICKS_PER_SECOND);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Remove the TLS protocols installed on the HTTP handle for external usages.
+  //
+  if (HttpInstance->UseHttps) {
+    Status = gBS->UninstallMultipleProtocolInterfaces (
+                    HttpInstance->Handle,
+                    &gEfiTlsProtocolGuid,
+                    HttpInstance->Tls,
+                    &gEfiTlsConfigurationProtocolGuid,
+                    HttpInstance->TlsConfiguration,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  Connection->Signature  = HTTP_POOLED_CONNECTION_SIGNATURE;
+  Connection->UsingIpv6  = HttpInstance->LocalAddressIsIPv6;
+  Connection->RemotePort = HttpInstance->RemotePort;
+  Connection->UseHttps   = HttpInstance->UseHttps;
+  IP4_COPY_ADDRESS (&Connection->RemoteAddr, &HttpInstance->RemoteAddr);
+  IP6_COPY_ADDRESS (&Connection->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+  CopyMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (EFI_HTTPv4_ACCESS_POINT));
+  CopyMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (EFI_HTTPv6_ACCESS_POINT));
+  CopyMem (&Connection->ConnStats, &HttpInstance->ConnStats, sizeof (HTTP_CONNECTION_STATISTICS));
+
+  //
+  // Detach the TCP child from the HTTP child. The pool keeps the
+  // BY_DRIVER open of the TCP child.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    Connection->TcpChildHandle = HttpInstance->Tcp4ChildHandle;
+    Connection->Tcp4           = HttpInstance->Tcp4;
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    Connection->TcpChildHandle = HttpInstance->Tcp6ChildHandle;
+    Connection->Tcp6           = HttpInstance->Tcp6;
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  HttpInstance->TcpFragmentReceive = NULL;
+  HttpInstance->State              = HTTP_STATE_TCP_UNCONFIGED;
+
+  if (HttpInstance->UseHttps) {
+    Connection->TlsSb            = HttpInstance->TlsSb;
+    Connection->TlsChildHandle   = HttpInstance->TlsChildHandle;
+    Connection->Tls              = HttpInstance->Tls;
+    Connection->TlsConfiguration = HttpInstance->TlsConfiguration;
+    Connection->TlsVerifyMethod  = VerifyMethod;
+    CopyMem (Connection->TlsConfigDigest, TlsConfigDigest, sizeof (Connection->TlsConfigDigest));
+
+    HttpInstance->TlsChildHandle    = NULL;
+    HttpInstance->Tls               = NULL;
+    HttpInstance->TlsConfiguration  = NULL;
+    HttpInstance->TlsAlreadyCreated = FALSE;
+    HttpInstance->TlsSessionState   = EfiTlsSessionNotStarted;
+  }
+
+  //
+  // Make room by closing the connection that has been idle the longest.
+  //
+  if (HttpService->ConnectionPoolCount >= PcdGet8 (PcdHttpConnectionPoolSize)) {
+    HttpConnectionPoolClose (
+      HttpService,
+      NET_LIST_HEAD (&HttpService->ConnectionPool, HTTP_POOLED_CONNECTION, Link)
+      );
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&HttpService->ConnectionPool, &Connection->Link);
+  HttpService->ConnectionPoolCount++;
+  gBS->RestoreTPL (OldTpl);
+
+  DEBUG ((DEBUG_INFO, "HttpConnectionPoolPark: %a:%d pooled\n", Connection->RemoteHost, Connection->RemotePort));
+  return TRUE;
+
+ON_ERROR:
+  if (Connection->IdleTimer != NULL) {
+    gBS->CloseEvent (Connection->IdleTimer);
+  }
+
+  if (Connection->RemoteHost != NULL) {
+    FreePool (Connection->RemoteHost);
+  }
+
+  FreePool (Connection);
+  return FALSE;
+}
+
+/**
+  Get the remote address of a pooled connection to the requested origin,
+  which saves a DNS query when the connection is taken over later.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       HostName       The host name of the request URL.
+  @param[in]       RemotePort     The port of the request URL.
+
+  @retval EFI_SUCCESS             The remote address is returned in HttpInstance.
+  @retval EFI_NOT_FOUND           There is no pooled connection to the origin.
+
+**/
+EFI_STATUS
+HttpConnectionPoolGetAddress (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *HostName,
+  IN     UINT16         RemotePort
+  )
+{
+  HTTP_POOLED_CONNECTION  *Connection;
+
+  Connection = HttpConnectionPoolFind (HttpInstance, HostName, RemotePort);
+  if (Connection == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Connection->RemoteAddr);
+  } else {
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Connection->RemoteIpv6Addr);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Take over a pooled connection to the origin of HttpInstance, instead of
+  connecting the TCP child and the TLS child HttpInstance has created.
+
+  A pooled HTTPS connection is taken over only if its TLS session was
+  established with the same verification method, CA certificates, cipher
+  list and client certificate as HttpInstance has configured.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure, configured
+                                  for its first request.
+
+  @retval EFI_SUCCESS             HttpInstance owns the pooled connection now.
+  @retval EFI_NOT_FOUND           There is no usable pooled connection.
+  @retval Others                  Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnectionPoolAdopt (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE            *HttpService;
+  HTTP_POOLED_CONNECTION  *Connection;
+  EFI_HANDLE              DriverBindingHandle;
+  EFI_GUID                *TcpProtocolGuid;
+  VOID                    *Interface;
+  EFI_TLS_VERIFY          VerifyMethod;
+  UINT8                   TlsConfigDigest[SHA256_DIGEST_SIZE];
+  UINTN                   DataSize;
+  EFI_STATUS              Status;
+  EFI_TPL                 OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if ((HttpInstance->RemoteHost == NULL) || HttpInstance->ProxyConnected) {
+    return EFI_NOT_FOUND;
+  }
+
+  Connection = HttpConnectionPoolFind (HttpInstance, HttpInstance->RemoteHost, HttpInstance->RemotePort);
+  if (Connection == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (HttpInstance->UseHttps) {
+    if (!HttpInstance->TlsAlreadyCreated) {
+      return EFI_NOT_FOUND;
+    }
+
+    DataSize = sizeof (EFI_TLS_VERIFY);
+    Status   = HttpInstance->Tls->GetSessionData (HttpInstance->Tls, EfiTlsVerifyMethod, &VerifyMethod, &DataSize);
+    if (EFI_ERROR (Status) || (VerifyMethod != Connection->TlsVerifyMethod)) {
+      return EFI_NOT_FOUND;
+    }
+
+    Status = TlsGetConfigDigest (HttpInstance, TlsConfigDigest);
+    if (EFI_ERROR (Status) ||
+        (CompareMem (TlsConfigDigest, Connection->TlsConfigDigest, sizeof (TlsConfigDigest)) != 0))
+    {
+      return EFI_NOT_FOUND;
+    }
+  }
+
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    DriverBindingHandle = HttpService->Ip4DriverBindingHandle;
+    TcpProtocolGuid     = &gEfiTcp4ProtocolGuid;
+  } else {
+    DriverBindingHandle = HttpService->Ip6DriverBindingHandle;
+    TcpProtocolGuid     = &gEfiTcp6ProtocolGuid;
+  }
+
+  Status = gBS->OpenProtocol (
+                  Connection->TcpChildHandle,
+                  TcpProtocolGuid,
+                  &Interface,
+                  DriverBindingHandle,
+                  HttpInstance->Handle,
+                  EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                  );
+  if (EFI_ERROR (Status)) {
+    HttpConnectionPoolClose (HttpService, Connection);
+    return Status;
+  }
+
+  //
+  // Replace the TLS protocols on the HTTP handle by the ones of the pooled TLS
+  // child, which has the established session.
+  //
+  if (HttpInstance->UseHttps) {
+    Status = gBS->UninstallMultipleProtocolInterfaces (
+                    HttpInstance->Handle,
+                    &gEfiTlsProtocolGuid,
+                    HttpInstance->Tls,
+                    &gEfiTlsConfigurationProtocolGuid,
+                    HttpInstance->TlsConfiguration,
+                    NULL
+                    );
+    if (!EFI_ERROR (Status)) {
+      Status = gBS->InstallMultipleProtocolInterfaces (
+                      &HttpInstance->Handle,
+                      &gEfiTlsProtocolGuid,
+                      Connection->Tls,
+                      &gEfiTlsConfigurationProtocolGuid,
+                      Connection->TlsConfiguration,
+                      NULL
+                      );
+      if (EFI_ERROR (Status)) {
+        gBS->InstallMultipleProtocolInterfaces (
+               &HttpInstance->Handle,
+               &gEfiTlsProtocolGuid,
+               HttpInstance->Tls,
+               &gEfiTlsConfigurationProtocolGuid,
+               HttpInstance->TlsConfiguration,
+               NULL
+               );
+      }
+    }
+
+    if (EFI_ERROR (Status)) {
+      gBS->CloseProtocol (Connection->TcpChildHandle, TcpProtocolGuid, DriverBindingHandle, HttpInstance->Handle);
+      return Status;
+    }
+
+    HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+
+    HttpInstance->TlsChildHandle   = Connection->TlsChildHandle;
+    HttpInstance->Tls              = Connection->Tls;
+    HttpInstance->TlsConfiguration = Connection->TlsConfiguration;
+    HttpInstance->TlsSessionState  = EfiTlsSessionDataTransferring;
+  }
+
+  //
+  // Release the unconnected TCP child of the HTTP child.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      HttpInstance->Tcp4ChildHandle
+      );
+
+    HttpInstance->Tcp4ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp4            = Connection->Tcp4;
+  } else {
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      HttpInstance->Tcp6ChildHandle
+      );
+
+    HttpInstance->Tcp6ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp6            = Connection->Tcp6;
+  }
+
+  Status = gBS->OpenProtocol (
+                  Connection->TcpChildHandle,
+                  &gEdkiiTcpFragmentReceiveProtocolGuid,
+                  (VOID **)&HttpInstance->TcpFragmentReceive,
+                  DriverBindingHandle,
+                  HttpInstance->Handle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    HttpInstance->TcpFragmentReceive = NULL;
+  }
+
+  CopyMem (&HttpInstance->ConnStats, &Connection->ConnStats, sizeof (HTTP_CONNECTION_STATISTICS));
+  HttpInstance->ConnStats.Reuses++;
+  HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+  DEBUG ((DEBUG_INFO, "HttpConnectionPoolAdopt: %a:%d reused\n", Connection->RemoteHost, Connection->RemotePort));
+
+  //
+  // The children belong to the HTTP child now, only free the pool entry.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  RemoveEntryList (&Connection->Link);
+  HttpService->ConnectionPoolCount--;
+  gBS->RestoreTPL (OldTpl);
+
+  gBS->CloseEvent (Connection->IdleTimer);
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Close all the pooled connections of an IP version.
+
+  @param[in]  HttpService         The HTTP service.
+  @param[in]  UsingIpv6           Close the TCP6 connections if TRUE, the
+                                  TCP4 connections otherwise.
+
+**/
+VOID
+HttpConnectionPoolFlush (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  )
+{
+  HTTP_POOLED_CONNECTION  *Connection;
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->ConnectionPool) {
+    Connection = NET_LIST_USER_STRUCT_S (Entry, HTTP_POOLED_CONNECTION, Link, HTTP_POOLED_CONNECTION_SIGNATURE);
+    if (Connection->UsingIpv6 == UsingIpv6) {
+      HttpConnectionPoolClose (HttpService, Connection);
+    }
+  }
+}
+
+/**
+  Get the time elapsed since a value of the performance counter.
+
+  @param[in]  StartTime           A value returned by GetPerformanceCounter().
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+HttpGetElapsedTime (
+  IN UINT64  StartTime
+  )
+{
+  UINT64  Now;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  Now = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+
+  //
+  // The counter may count down, and may have wrapped around once.
+  //
+  if (CounterEnd >= CounterStart) {
+    if (Now >= StartTime) {
+      Ticks = Now - StartTime;
+    } else {
+      Ticks = (CounterEnd - StartTime) + (Now - CounterStart);
+    }
+  } else {
+    if (StartTime >= Now) {
+      Ticks = StartTime - Now;
+    } else {
+      Ticks = (StartTime - CounterEnd) + (CounterStart - Now);
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Update the latency counters of the connection after a response header
+  is received.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+HttpRecordResponseTime (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_CONNECTION_STATISTICS  *ConnStats;
+
+  if (!HttpInstance->ResponsePending) {
+    return;
+  }
+
+  HttpInstance->ResponsePending = FALSE;
+
+  ConnStats                     = &HttpInstance->ConnStats;
+  ConnStats->LastResponseTime   = HttpGetElapsedTime (HttpInstance->RequestStartTime);
+  ConnStats->TotalResponseTime += ConnStats->LastResponseTime;
+  ConnStats->MaxResponseTime    = MAX (ConnStats->MaxResponseTime, ConnStats->LastResponseTime);
+  ConnStats->Requests++;
+}
+
+/**
+  Print the latency counters of a connection that is about to be closed.
+
+  @param[in]  ConnStats           The latency counters of the connection.
+
+**/
+VOID
+HttpDumpConnectionStatistics (
+  IN HTTP_CONNECTION_STATISTICS  *ConnStats
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpDxe: connection closed, TCP connect %Lu us, TLS handshake %Lu us, reused %d times\n",
+    DivU64x32 (ConnStats->ConnectTime, 1000),
+    DivU64x32 (ConnStats->TlsHandshakeTime, 1000),
+    ConnStats->Reuses
+    ));
+
+  if (ConnStats->Requests != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "HttpDxe: %d responses, time to response header last %Lu us, average %Lu us, max %Lu us\n",
+      ConnStats->Requests,
+      DivU64x32 (ConnStats->LastResponseTime, 1000),
+      DivU64x64Remainder (ConnStats->TotalResponseTime, MultU64x32 (ConnStats->Requests, 1000), NULL),
+      DivU64x32 (ConnStats->MaxResponseTime, 1000)
+      ));
+  }
+}
@@ -0,0 +1,165 @@
+/** @file
+  The header file of the keep-alive connection pool and the connection
+  latency counters of HttpDxe.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EFI_HTTP_CONNECTION_POOL_H_
+#define EFI_HTTP_CONNECTION_POOL_H_
+
+//
+// Seconds an idle connection stays in the pool. Most servers close
+// idle keep-alive connections on their side after 5 to 60 seconds.
+//
+#define HTTP_CONNECTION_POOL_IDLE_TIMEOUT  30
+
+#define HTTP_POOLED_CONNECTION_SIGNATURE  SIGNATURE_32 ('H', 't', 'p', 'C')
+
+//
+// An idle keep-alive connection. The TCP child and, for HTTPS, the TLS
+// child with its established session are detached from the HTTP child
+// that created them, until another HTTP child of the same service takes
+// them over.
+//
+typedef struct {
+  UINT32                            Signature;
+  LIST_ENTRY                        Link;
+  EFI_EVENT                         IdleTimer;
+
+  BOOLEAN                           UsingIpv6;
+  CHAR8                             *RemoteHost;
+  UINT16                            RemotePort;
+  EFI_IPv4_ADDRESS                  RemoteAddr;
+  EFI_IPv6_ADDRESS                  RemoteIpv6Addr;
+  EFI_HTTPv4_ACCESS_POINT           IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT           Ipv6Node;
+
+  EFI_HANDLE                        TcpChildHandle;
+  EFI_TCP4_PROTOCOL                 *Tcp4;
+  EFI_TCP6_PROTOCOL                 *Tcp6;
+
+  BOOLEAN                           UseHttps;
+  EFI_SERVICE_BINDING_PROTOCOL      *TlsSb;
+  EFI_HANDLE                        TlsChildHandle;
+  EFI_TLS_PROTOCOL                  *Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL    *TlsConfiguration;
+  EFI_TLS_VERIFY                    TlsVerifyMethod;
+  UINT8                             TlsConfigDigest[SHA256_DIGEST_SIZE];
+
+  HTTP_CONNECTION_STATISTICS        ConnStats;
+} HTTP_POOLED_CONNECTION;
+
+/**
+  Hand the idle keep-alive connection of an HTTP child over to the connection
+  pool of its service.
+
+  The connection is pooled only if it is established, the last response has
+  been received completely and the server did not ask to close it. On success
+  the TCP child and the TLS child are detached from HttpInstance, so that the
+  clean up of HttpInstance leaves them alone.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+  @retval TRUE                    The connection is pooled.
+  @retval FALSE                   The connection is not pooled.
+
+**/
+BOOLEAN
+HttpConnectionPoolPark (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Get the remote address of a pooled connection to the requested origin,
+  which saves a DNS query when the connection is taken over later.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+  @param[in]       HostName       The host name of the request URL.
+  @param[in]       RemotePort     The port of the request URL.
+
+  @retval EFI_SUCCESS             The remote address is returned in HttpInstance.
+  @retval EFI_NOT_FOUND           There is no pooled connection to the origin.
+
+**/
+EFI_STATUS
+HttpConnectionPoolGetAddress (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     CHAR8          *HostName,
+  IN     UINT16         RemotePort
+  );
+
+/**
+  Take over a pooled connection to the origin of HttpInstance, instead of
+  connecting the TCP child and the TLS child HttpInstance has created.
+
+  A pooled HTTPS connection is taken over only if its TLS session was
+  established with the same verification method, CA certificates, cipher
+  list and client certificate as HttpInstance has configured.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure, configured
+                                  for its first request.
+
+  @retval EFI_SUCCESS             HttpInstance owns the pooled connection now.
+  @retval EFI_NOT_FOUND           There is no usable pooled connection.
+  @retval Others                  Other error as indicated.
+
+**/
+EFI_STATUS
+HttpConnectionPoolAdopt (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Close all the pooled connections of an IP version.
+
+  @param[in]  HttpService         The HTTP service.
+  @param[in]  UsingIpv6           Close the TCP6 connections if TRUE, the
+                                  TCP4 connections otherwise.
+
+**/
+VOID
+HttpConnectionPoolFlush (
+  IN HTTP_SERVICE  *HttpService,
+  IN BOOLEAN       UsingIpv6
+  );
+
+/**
+  Get the time elapsed since a value of the performance counter.
+
+  @param[in]  StartTime           A value returned by GetPerformanceCounter().
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+HttpGetElapsedTime (
+  IN UINT64  StartTime
+  );
+
+/**
+  Update the latency counters of the connection after a response header
+  is received.
+
+  @param[in, out]  HttpInstance   Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+HttpRecordResponseTime (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Print the latency counters of a connection that is about to be closed.
+
+  @param[in]  ConnStats           The latency counters of the connection.
+
+**/
+VOID
+HttpDumpConnectionStatistics (
+  IN HTTP_CONNECTION_STATISTICS  *ConnStats
+  );
+
+#endif
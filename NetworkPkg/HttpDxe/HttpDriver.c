@@ -67,6 +67,7 @@ HttpCreateService (
   HttpService->ControllerHandle            = Controller;
   HttpService->ChildrenNumber              = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->ConnectionPool);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -90,6 +91,8 @@ HttpCleanService (
     return;
   }
 
+  HttpConnectionPoolFlush (HttpService, UsingIpv6);
+
   if (!UsingIpv6) {
     if (HttpService->Tcp4ChildHandle != NULL) {
       gBS->CloseProtocol (
@@ -269,6 +272,11 @@ HttpDestroyChildEntryInHandleBuffer (
     return EFI_SUCCESS;
   }
 
+  //
+  // The TCP children are going away, do not pool the connection.
+  //
+  HttpInstance->ConnectionClose = TRUE;
+
   return ServiceBinding->DestroyChild (ServiceBinding, HttpInstance->Handle);
 }
 
@@ -999,6 +1007,7 @@ HttpServiceBindingDestroyChild (
   EFI_HTTP_PROTOCOL  *Http;
   EFI_STATUS         Status;
   EFI_TPL            OldTpl;
+  BOOLEAN            Pooled;
 
   if ((This == NULL) || (ChildHandle == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1028,6 +1037,11 @@ HttpServiceBindingDestroyChild (
 
   HttpInstance->InDestroy = TRUE;
 
+  //
+  // Pool an idle keep-alive connection while the child handle is still valid.
+  //
+  Pooled = HttpConnectionPoolPark (HttpInstance);
+
   //
   // Uninstall the HTTP protocol.
   //
@@ -1038,6 +1052,14 @@ HttpServiceBindingDestroyChild (
                   );
 
   if (EFI_ERROR (Status)) {
+    if (Pooled) {
+      //
+      // The connection is gone, the child has to be configured again.
+      //
+      HttpCleanProtocol (HttpInstance);
+      HttpInstance->State = HTTP_STATE_UNCONFIGED;
+    }
+
     HttpInstance->InDestroy = FALSE;
     return Status;
   }
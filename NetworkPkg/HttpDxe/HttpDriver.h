@@ -27,6 +27,8 @@
 #include <Library/HttpLib.h>
 #include <Library/DpcLib.h>
 #include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/BaseCryptLib.h>
 
 //
 // UEFI Driver Model Protocols
@@ -42,6 +44,7 @@
 #include <Protocol/HttpUtilities.h>
 #include <Protocol/Tcp4.h>
 #include <Protocol/Tcp6.h>
+#include <Protocol/TcpFragmentReceive.h>
 #include <Protocol/Dns4.h>
 #include <Protocol/Dns6.h>
 #include <Protocol/Ip4Config2.h>
@@ -86,6 +89,7 @@ extern EFI_HTTP_UTILITIES_PROTOCOL  *mHttpUtilities;
 #include "HttpProto.h"
 #include "HttpsSupport.h"
 #include "HttpDns.h"
+#include "HttpConnectionPool.h"
 
 typedef struct {
   EFI_SERVICE_BINDING_PROTOCOL    *ServiceBinding;
@@ -575,6 +575,13 @@ EfiHttpRequest (
       Status = HttpUrlGetIp6 (ParseUrl, UrlParser, &HttpInstance->RemoteIpv6Addr);
     }
 
+    if (EFI_ERROR (Status) && !ReConfigure) {
+      //
+      // A pooled connection to the same origin saves the DNS query.
+      //
+      Status = HttpConnectionPoolGetAddress (HttpInstance, HostName, RemotePort);
+    }
+
     if (EFI_ERROR (Status)) {
       HostNameSize = AsciiStrSize (HostName);
       HostNameStr  = AllocateZeroPool (HostNameSize * sizeof (CHAR16));
@@ -1201,6 +1208,8 @@ HttpResponseWorker (
       goto Error;
     }
 
+    HttpRecordResponseTime (HttpInstance);
+
     ASSERT (HttpHeaders != NULL);
 
     //
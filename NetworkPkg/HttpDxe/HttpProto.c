@@ -732,6 +732,22 @@ HttpInitProtocol (
     }
   }
 
+  //
+  // TCP may hand the received data over by reference, which saves
+  // copying the TLS records. It is optional.
+  //
+  Status = gBS->OpenProtocol (
+                  UsingIpv6 ? HttpInstance->Tcp6ChildHandle : HttpInstance->Tcp4ChildHandle,
+                  &gEdkiiTcpFragmentReceiveProtocolGuid,
+                  (VOID **)&HttpInstance->TcpFragmentReceive,
+                  UsingIpv6 ? HttpInstance->Service->Ip6DriverBindingHandle : HttpInstance->Service->Ip4DriverBindingHandle,
+                  HttpInstance->Handle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    HttpInstance->TcpFragmentReceive = NULL;
+  }
+
   HttpInstance->Url = AllocateZeroPool (HTTP_URL_BUFFER_LEN);
   if (HttpInstance->Url == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -821,6 +837,27 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   )
 {
+  EDKII_TCP_RECEIVE_STATISTICS  Statistics;
+
+  //
+  // Keep an idle keep-alive connection for the next HTTP instance that
+  // requests the same origin.
+  //
+  HttpConnectionPoolPark (HttpInstance);
+
+  if (HttpInstance->TcpFragmentReceive != NULL) {
+    if (!EFI_ERROR (HttpInstance->TcpFragmentReceive->GetStatistics (HttpInstance->TcpFragmentReceive, &Statistics))) {
+      DEBUG ((
+        DEBUG_INFO,
+        "HttpCleanProtocol: TCP delivered %Lu bytes by copy, %Lu bytes by reference\n",
+        Statistics.BytesCopied,
+        Statistics.BytesByReference
+        ));
+    }
+
+    HttpInstance->TcpFragmentReceive = NULL;
+  }
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -868,13 +905,10 @@ HttpCleanProtocol (
   NetMapClean (&HttpInstance->TxTokens);
   NetMapClean (&HttpInstance->RxTokens);
 
-  if ((HttpInstance->TlsSb != NULL) && HttpInstance->TlsAlreadyCreated) {
-    //
-    // Destroy the TLS instance.
-    //
-    HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->Handle);
-    HttpInstance->TlsAlreadyCreated = FALSE;
-  }
+  //
+  // Destroy the TLS instance.
+  //
+  TlsDestroyChild (HttpInstance);
 
   if (HttpInstance->Tcp4ChildHandle != NULL) {
     gBS->CloseProtocol (
@@ -958,6 +992,9 @@ HttpCreateConnection (
   )
 {
   EFI_STATUS  Status;
+  UINT64      StartTime;
+
+  StartTime = GetPerformanceCounter ();
 
   //
   // Connect to Http server
@@ -995,7 +1032,9 @@ HttpCreateConnection (
   }
 
   if (!EFI_ERROR (Status)) {
-    HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+    ZeroMem (&HttpInstance->ConnStats, sizeof (HTTP_CONNECTION_STATISTICS));
+    HttpInstance->ConnStats.ConnectTime = HttpGetElapsedTime (StartTime);
+    HttpInstance->State                 = HTTP_STATE_TCP_CONNECTED;
   }
 
   return Status;
@@ -1018,6 +1057,8 @@ HttpCloseConnection (
   EFI_STATUS  Status;
 
   if (HttpInstance->State == HTTP_STATE_TCP_CONNECTED) {
+    HttpDumpConnectionStatistics (&HttpInstance->ConnStats);
+
     if (HttpInstance->LocalAddressIsIPv6) {
       HttpInstance->Tcp6CloseToken.AbortOnClose = TRUE;
       HttpInstance->IsTcp6CloseDone             = FALSE;
@@ -1101,6 +1142,7 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle         = TRUE;
   Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
   Tcp4CfgData->ControlOption      = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
@@ -1185,6 +1227,7 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle         = TRUE;
   Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -1239,6 +1282,7 @@ HttpConnectTcp4 (
 {
   EFI_STATUS                 Status;
   EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  UINT64                     StartTime;
 
   if ((HttpInstance->State < HTTP_STATE_TCP_CONFIGED) || (HttpInstance->Tcp4 == NULL)) {
     return EFI_NOT_READY;
@@ -1301,7 +1345,8 @@ HttpConnectTcp4 (
       return Status;
     }
 
-    Status = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
+    StartTime = GetPerformanceCounter ();
+    Status    = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
     HttpNotify (HttpEventTlsConnectSession, Status);
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
@@ -1310,6 +1355,8 @@ HttpConnectTcp4 (
       TlsCloseTxRxEvent (HttpInstance);
       return Status;
     }
+
+    HttpInstance->ConnStats.TlsHandshakeTime = HttpGetElapsedTime (StartTime);
   }
 
   return Status;
@@ -1335,6 +1382,7 @@ HttpConnectTcp6 (
 {
   EFI_STATUS                 Status;
   EFI_TCP6_CONNECTION_STATE  Tcp6State;
+  UINT64                     StartTime;
 
   if ((HttpInstance->State < HTTP_STATE_TCP_CONFIGED) || (HttpInstance->Tcp6 == NULL)) {
     return EFI_NOT_READY;
@@ -1398,7 +1446,8 @@ HttpConnectTcp6 (
       return Status;
     }
 
-    Status = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
+    StartTime = GetPerformanceCounter ();
+    Status    = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
     HttpNotify (HttpEventTlsConnectSession, Status);
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
@@ -1407,6 +1456,8 @@ HttpConnectTcp6 (
       TlsCloseTxRxEvent (HttpInstance);
       return Status;
     }
+
+    HttpInstance->ConnStats.TlsHandshakeTime = HttpGetElapsedTime (StartTime);
   }
 
   return Status;
@@ -1447,6 +1498,24 @@ HttpInitSession (
     }
   }
 
+  //
+  // The first request of the HTTP instance takes over an idle connection
+  // to the same origin from the connection pool if there is one.
+  //
+  if (Configure && (HttpInstance->State == HTTP_STATE_HTTP_CONFIGED) &&
+      (Wrap->TcpWrap.Method != HttpMethodConnect))
+  {
+    Status = HttpConnectionPoolAdopt (HttpInstance);
+    if (!EFI_ERROR (Status)) {
+      Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      return HttpCreateTcpTxEvent (Wrap);
+    }
+  }
+
   if (!HttpInstance->LocalAddressIsIPv6) {
     //
     // Configure TCP instance.
@@ -1530,6 +1599,12 @@ HttpTransmitTcp (
   RecordCount       = 0;
   RemainingLen      = 0;
 
+  //
+  // The response time is measured from the last data sent.
+  //
+  HttpInstance->RequestStartTime = GetPerformanceCounter ();
+  HttpInstance->ResponsePending  = TRUE;
+
   //
   // Need to encrypt data.
   //
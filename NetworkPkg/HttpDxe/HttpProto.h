@@ -60,6 +60,11 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                      ChildrenList;
   UINTN                           ChildrenNumber;
   INTN                            State;
+  //
+  // Idle keep-alive connections, see HttpConnectionPool.c.
+  //
+  LIST_ENTRY                      ConnectionPool;
+  UINTN                           ConnectionPoolCount;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -85,6 +90,21 @@ typedef struct {
   EFI_TLS_SESSION_STATE     SessionState;
 } TLS_CONFIG_DATA;
 
+//
+// Latency counters of a TCP connection. They move with the connection
+// when it is handed over to another HTTP child by the connection pool.
+// The times are in nanoseconds.
+//
+typedef struct {
+  UINT64    ConnectTime;       ///< TCP three-way handshake.
+  UINT64    TlsHandshakeTime;  ///< TLS handshake, 0 for HTTP.
+  UINT64    LastResponseTime;  ///< From the request sent to the response header received.
+  UINT64    TotalResponseTime;
+  UINT64    MaxResponseTime;
+  UINT32    Requests;          ///< Number of responses received on the connection.
+  UINT32    Reuses;            ///< Number of times the connection was taken from the pool.
+} HTTP_CONNECTION_STATISTICS;
+
 //
 // Callback data for HTTP_PARSER_CALLBACK()
 //
@@ -95,117 +115,131 @@ typedef struct {
 } HTTP_CALLBACK_DATA;
 
 typedef struct _HTTP_PROTOCOL {
-  UINT32                            Signature;
-  EFI_HTTP_PROTOCOL                 Http;
-  EFI_HANDLE                        Handle;
-  HTTP_SERVICE                      *Service;
-  LIST_ENTRY                        Link; // Link to all HTTP instance from the service.
-  BOOLEAN                           InDestroy;
-  INTN                              State;
-  EFI_HTTP_METHOD                   Method;
-
-  UINTN                             StatusCode;
-
-  EFI_EVENT                         TimeoutEvent;
-
-  EFI_HANDLE                        Tcp4ChildHandle;
-  EFI_TCP4_PROTOCOL                 *Tcp4;
-  EFI_TCP4_CONFIG_DATA              Tcp4CfgData;
-  EFI_TCP4_OPTION                   Tcp4Option;
-
-  EFI_TCP4_CONNECTION_TOKEN         Tcp4ConnToken;
-  BOOLEAN                           IsTcp4ConnDone;
-  EFI_TCP4_CLOSE_TOKEN              Tcp4CloseToken;
-  BOOLEAN                           IsTcp4CloseDone;
-  CHAR8                             *RemoteHost;
-  UINT16                            RemotePort;
-  EFI_IPv4_ADDRESS                  RemoteAddr;
-
-  EFI_HANDLE                        Tcp6ChildHandle;
-  EFI_TCP6_PROTOCOL                 *Tcp6;
-  EFI_TCP6_CONFIG_DATA              Tcp6CfgData;
-  EFI_TCP6_OPTION                   Tcp6Option;
-
-  EFI_TCP6_CONNECTION_TOKEN         Tcp6ConnToken;
-  BOOLEAN                           IsTcp6ConnDone;
-  EFI_TCP6_CLOSE_TOKEN              Tcp6CloseToken;
-  BOOLEAN                           IsTcp6CloseDone;
-  EFI_IPv6_ADDRESS                  RemoteIpv6Addr;
+  UINT32                                 Signature;
+  EFI_HTTP_PROTOCOL                      Http;
+  EFI_HANDLE                             Handle;
+  HTTP_SERVICE                           *Service;
+  LIST_ENTRY                             Link; // Link to all HTTP instance from the service.
+  BOOLEAN                                InDestroy;
+  INTN                                   State;
+  EFI_HTTP_METHOD                        Method;
+
+  UINTN                                  StatusCode;
+
+  EFI_EVENT                              TimeoutEvent;
+
+  EFI_HANDLE                             Tcp4ChildHandle;
+  EFI_TCP4_PROTOCOL                      *Tcp4;
+  EFI_TCP4_CONFIG_DATA                   Tcp4CfgData;
+  EFI_TCP4_OPTION                        Tcp4Option;
+
+  EFI_TCP4_CONNECTION_TOKEN              Tcp4ConnToken;
+  BOOLEAN                                IsTcp4ConnDone;
+  EFI_TCP4_CLOSE_TOKEN                   Tcp4CloseToken;
+  BOOLEAN                                IsTcp4CloseDone;
+  CHAR8                                  *RemoteHost;
+  UINT16                                 RemotePort;
+  EFI_IPv4_ADDRESS                       RemoteAddr;
+
+  EFI_HANDLE                             Tcp6ChildHandle;
+  EFI_TCP6_PROTOCOL                      *Tcp6;
+  EFI_TCP6_CONFIG_DATA                   Tcp6CfgData;
+  EFI_TCP6_OPTION                        Tcp6Option;
+
+  EFI_TCP6_CONNECTION_TOKEN              Tcp6ConnToken;
+  BOOLEAN                                IsTcp6ConnDone;
+  EFI_TCP6_CLOSE_TOKEN                   Tcp6CloseToken;
+  BOOLEAN                                IsTcp6CloseDone;
+  EFI_IPv6_ADDRESS                       RemoteIpv6Addr;
 
   //
   // Rx4Token or Rx6Token used for receiving HTTP header.
   //
-  EFI_TCP4_IO_TOKEN                 Rx4Token;
-  EFI_TCP4_RECEIVE_DATA             Rx4Data;
-  EFI_TCP6_IO_TOKEN                 Rx6Token;
-  EFI_TCP6_RECEIVE_DATA             Rx6Data;
-  BOOLEAN                           IsRxDone;
-
-  CHAR8                             **EndofHeader;
-  CHAR8                             **HttpHeaders;
-  CHAR8                             *CacheBody;
-  CHAR8                             *NextMsg;
-  UINTN                             CacheLen;
-  UINTN                             CacheOffset;
+  EFI_TCP4_IO_TOKEN                      Rx4Token;
+  EFI_TCP4_RECEIVE_DATA                  Rx4Data;
+  EFI_TCP6_IO_TOKEN                      Rx6Token;
+  EFI_TCP6_RECEIVE_DATA                  Rx6Data;
+  BOOLEAN                                IsRxDone;
+
+  CHAR8                                  **EndofHeader;
+  CHAR8                                  **HttpHeaders;
+  CHAR8                                  *CacheBody;
+  CHAR8                                  *NextMsg;
+  UINTN                                  CacheLen;
+  UINTN                                  CacheOffset;
 
   //
   // HTTP message-body parser.
   //
-  VOID                              *MsgParser;
-  HTTP_CALLBACK_DATA                CallbackData;
+  VOID                                   *MsgParser;
+  HTTP_CALLBACK_DATA                     CallbackData;
 
-  EFI_HTTP_VERSION                  HttpVersion;
-  UINT32                            TimeOutMillisec;
-  BOOLEAN                           LocalAddressIsIPv6;
+  EFI_HTTP_VERSION                       HttpVersion;
+  UINT32                                 TimeOutMillisec;
+  BOOLEAN                                LocalAddressIsIPv6;
 
-  EFI_HTTPv4_ACCESS_POINT           IPv4Node;
-  EFI_HTTPv6_ACCESS_POINT           Ipv6Node;
+  EFI_HTTPv4_ACCESS_POINT                IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT                Ipv6Node;
 
-  NET_MAP                           TxTokens;
-  NET_MAP                           RxTokens;
+  NET_MAP                                TxTokens;
+  NET_MAP                                RxTokens;
 
-  CHAR8                             *Url;
-  UINTN                             UrlLen;
+  CHAR8                                  *Url;
+  UINTN                                  UrlLen;
 
   //
   // Proxy support
   //
-  CHAR8                             *ProxyUrl;
-  UINTN                             ProxyUrlLen;
-  BOOLEAN                           ProxyConnected;
-  CHAR8                             *EndPointHostName;
+  CHAR8                                  *ProxyUrl;
+  UINTN                                  ProxyUrlLen;
+  BOOLEAN                                ProxyConnected;
+  CHAR8                                  *EndPointHostName;
 
   //
   // Https Support
   //
-  BOOLEAN                           UseHttps;
+  BOOLEAN                                UseHttps;
 
-  EFI_SERVICE_BINDING_PROTOCOL      *TlsSb;
-  BOOLEAN                           TlsAlreadyCreated;
-  TLS_CONFIG_DATA                   TlsConfigData;
-  EFI_TLS_PROTOCOL                  *Tls;
-  EFI_TLS_CONFIGURATION_PROTOCOL    *TlsConfiguration;
-  EFI_TLS_SESSION_STATE             TlsSessionState;
+  EFI_SERVICE_BINDING_PROTOCOL           *TlsSb;
+  BOOLEAN                                TlsAlreadyCreated;
+  EFI_HANDLE                             TlsChildHandle;
+  TLS_CONFIG_DATA                        TlsConfigData;
+  EFI_TLS_PROTOCOL                       *Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL         *TlsConfiguration;
+  EFI_TLS_SESSION_STATE                  TlsSessionState;
 
   //
   // TlsTxData used for transmitting TLS related messages.
   //
-  EFI_TCP4_IO_TOKEN                 Tcp4TlsTxToken;
-  EFI_TCP4_TRANSMIT_DATA            Tcp4TlsTxData;
-  EFI_TCP6_IO_TOKEN                 Tcp6TlsTxToken;
-  EFI_TCP6_TRANSMIT_DATA            Tcp6TlsTxData;
-  BOOLEAN                           TlsIsTxDone;
+  EFI_TCP4_IO_TOKEN                      Tcp4TlsTxToken;
+  EFI_TCP4_TRANSMIT_DATA                 Tcp4TlsTxData;
+  EFI_TCP6_IO_TOKEN                      Tcp6TlsTxToken;
+  EFI_TCP6_TRANSMIT_DATA                 Tcp6TlsTxData;
+  BOOLEAN                                TlsIsTxDone;
 
   //
   // TlsRxData used for receiving TLS related messages.
   //
-  EFI_TCP4_IO_TOKEN                 Tcp4TlsRxToken;
-  EFI_TCP4_RECEIVE_DATA             Tcp4TlsRxData;
-  EFI_TCP6_IO_TOKEN                 Tcp6TlsRxToken;
-  EFI_TCP6_RECEIVE_DATA             Tcp6TlsRxData;
-  BOOLEAN                           TlsIsRxDone;
+  EFI_TCP4_IO_TOKEN                      Tcp4TlsRxToken;
+  EFI_TCP4_RECEIVE_DATA                  Tcp4TlsRxData;
+  EFI_TCP6_IO_TOKEN                      Tcp6TlsRxToken;
+  EFI_TCP6_RECEIVE_DATA                  Tcp6TlsRxData;
+  BOOLEAN                                TlsIsRxDone;
 
-  BOOLEAN                           ConnectionClose;
+  //
+  // Receive TLS records by reference when TCP supports it.
+  //
+  EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL    *TcpFragmentReceive;
+  EDKII_TCP_FRAGMENT_RECEIVE_TOKEN       TlsFragmentRxToken;
+
+  BOOLEAN                                ConnectionClose;
+
+  //
+  // Latency counters of the current connection.
+  //
+  HTTP_CONNECTION_STATISTICS             ConnStats;
+  UINT64                                 RequestStartTime;
+  BOOLEAN                                ResponsePending;
 } HTTP_PROTOCOL;
 
 typedef struct {
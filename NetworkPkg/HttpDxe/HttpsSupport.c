@@ -174,17 +174,18 @@ TlsCreateChild (
   }
 
   //
-  // Create TLS protocol on HTTP handle, this creates the association between HTTP and TLS
-  // for HTTP driver external usages.
+  // Create TLS protocol on a handle of its own, so that the connection pool
+  // can hand an established TLS session over to another HTTP instance.
   //
-  Status = HttpInstance->TlsSb->CreateChild (HttpInstance->TlsSb, &HttpInstance->Handle);
+  HttpInstance->TlsChildHandle = NULL;
+  Status                       = HttpInstance->TlsSb->CreateChild (HttpInstance->TlsSb, &HttpInstance->TlsChildHandle);
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
   HttpInstance->TlsAlreadyCreated = TRUE;
   Status                          = gBS->OpenProtocol (
-                                           HttpInstance->Handle,
+                                           HttpInstance->TlsChildHandle,
                                            &gEfiTlsProtocolGuid,
                                            (VOID **)&HttpInstance->Tls,
                                            ImageHandle,
@@ -192,13 +193,11 @@ TlsCreateChild (
                                            EFI_OPEN_PROTOCOL_GET_PROTOCOL
                                            );
   if (EFI_ERROR (Status)) {
-    HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->Handle);
-    HttpInstance->TlsAlreadyCreated = FALSE;
-    return Status;
+    goto ON_ERROR;
   }
 
   Status = gBS->OpenProtocol (
-                  HttpInstance->Handle,
+                  HttpInstance->TlsChildHandle,
                   &gEfiTlsConfigurationProtocolGuid,
                   (VOID **)&HttpInstance->TlsConfiguration,
                   ImageHandle,
@@ -206,12 +205,65 @@ TlsCreateChild (
                   EFI_OPEN_PROTOCOL_GET_PROTOCOL
                   );
   if (EFI_ERROR (Status)) {
-    HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->Handle);
-    HttpInstance->TlsAlreadyCreated = FALSE;
-    return Status;
+    goto ON_ERROR;
+  }
+
+  //
+  // Install the TLS protocols on HTTP handle as well, this creates the association
+  // between HTTP and TLS for HTTP driver external usages.
+  //
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &HttpInstance->Handle,
+                  &gEfiTlsProtocolGuid,
+                  HttpInstance->Tls,
+                  &gEfiTlsConfigurationProtocolGuid,
+                  HttpInstance->TlsConfiguration,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
   }
 
   return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+  HttpInstance->TlsChildHandle    = NULL;
+  HttpInstance->TlsAlreadyCreated = FALSE;
+  return Status;
+}
+
+/**
+  Remove the TLS protocols from the HTTP handle and destroy the TLS child.
+
+  @param[in, out]  HttpInstance  Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+EFIAPI
+TlsDestroyChild (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  if ((HttpInstance->TlsSb == NULL) || !HttpInstance->TlsAlreadyCreated) {
+    return;
+  }
+
+  gBS->UninstallMultipleProtocolInterfaces (
+         HttpInstance->Handle,
+         &gEfiTlsProtocolGuid,
+         HttpInstance->Tls,
+         &gEfiTlsConfigurationProtocolGuid,
+         HttpInstance->TlsConfiguration,
+         NULL
+         );
+
+  HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
+
+  HttpInstance->TlsChildHandle    = NULL;
+  HttpInstance->Tls               = NULL;
+  HttpInstance->TlsConfiguration  = NULL;
+  HttpInstance->TlsAlreadyCreated = FALSE;
 }
 
 /**
@@ -322,6 +374,24 @@ TlsCreateTxRxEvent (
     HttpInstance->Tcp6TlsRxToken.CompletionToken.Status         = EFI_NOT_READY;
   }
 
+  //
+  // For TlsFragmentRxToken, shares TlsIsRxDone with the TlsRxToken.
+  //
+  if (HttpInstance->TcpFragmentReceive != NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    HttpCommonNotify,
+                    &HttpInstance->TlsIsRxDone,
+                    &HttpInstance->TlsFragmentRxToken.CompletionToken.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ERROR;
+    }
+
+    HttpInstance->TlsFragmentRxToken.CompletionToken.Status = EFI_NOT_READY;
+  }
+
   return Status;
 
 ERROR:
@@ -367,6 +437,11 @@ TlsCloseTxRxEvent (
       HttpInstance->Tcp6TlsRxToken.CompletionToken.Event = NULL;
     }
   }
+
+  if (NULL != HttpInstance->TlsFragmentRxToken.CompletionToken.Event) {
+    gBS->CloseEvent (HttpInstance->TlsFragmentRxToken.CompletionToken.Event);
+    HttpInstance->TlsFragmentRxToken.CompletionToken.Event = NULL;
+  }
 }
 
 /**
@@ -760,6 +835,161 @@ ERROR:
   return Status;
 }
 
+/**
+  Feed one item of the TLS configuration to a SHA-256 digest. The size of the
+  item goes first, so that neither an absent item nor the boundary between two
+  items is ambiguous.
+
+  @param[in, out]  HashContext    The SHA-256 context.
+  @param[in]       Data           The item, NULL if absent.
+  @param[in]       DataSize       The size of the item in bytes.
+
+  @retval TRUE                    The item is digested.
+  @retval FALSE                   SHA-256 failed.
+
+**/
+BOOLEAN
+TlsDigestConfigItem (
+  IN OUT VOID        *HashContext,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  )
+{
+  UINT64  Size;
+
+  Size = DataSize;
+  if (!Sha256Update (HashContext, &Size, sizeof (Size))) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)((DataSize == 0) || Sha256Update (HashContext, Data, DataSize));
+}
+
+/**
+  Compute a digest of the TLS configuration of an HTTP instance: the CA
+  certificates and the cipher list configured from the TlsCaCertificate and
+  HttpTlsCipherList variables, and the client certificate configured through
+  the TLS configuration protocol of the instance.
+
+  @param[in]   HttpInstance      The HTTP instance private data.
+  @param[out]  Digest            The SHA-256 digest of the configuration,
+                                 SHA256_DIGEST_SIZE bytes.
+
+  @retval EFI_SUCCESS            The digest is computed.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_UNSUPPORTED        SHA-256 is not available.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+TlsGetConfigDigest (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  OUT UINT8          *Digest
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *HashContext;
+  VOID        *Data;
+  UINTN       DataSize;
+  BOOLEAN     Digested;
+
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (!Sha256Init (HashContext)) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  //
+  // The CA certificates.
+  //
+  Status = GetVariable2 (EFI_TLS_CA_CERTIFICATE_VARIABLE, &gEfiTlsCaCertificateGuid, &Data, &DataSize);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    goto ON_EXIT;
+  }
+
+  Digested = TlsDigestConfigItem (HashContext, Data, DataSize);
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+
+  if (!Digested) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  //
+  // The cipher list.
+  //
+  Status = GetVariable2 (EDKII_HTTP_TLS_CIPHER_LIST_VARIABLE, &gEdkiiHttpTlsCipherListGuid, &Data, &DataSize);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    goto ON_EXIT;
+  }
+
+  Digested = TlsDigestConfigItem (HashContext, Data, DataSize);
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+
+  if (!Digested) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  //
+  // The client certificate, which the consumer of HTTP may have set through
+  // the TLS configuration protocol on the HTTP handle.
+  //
+  Data     = NULL;
+  DataSize = 0;
+  Status   = HttpInstance->TlsConfiguration->GetData (
+                                               HttpInstance->TlsConfiguration,
+                                               EfiTlsConfigDataTypeHostPublicCert,
+                                               NULL,
+                                               &DataSize
+                                               );
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Data = AllocatePool (DataSize);
+    if (Data == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ON_EXIT;
+    }
+
+    Status = HttpInstance->TlsConfiguration->GetData (
+                                               HttpInstance->TlsConfiguration,
+                                               EfiTlsConfigDataTypeHostPublicCert,
+                                               Data,
+                                               &DataSize
+                                               );
+  } else if (Status == EFI_NOT_FOUND) {
+    DataSize = 0;
+    Status   = EFI_SUCCESS;
+  }
+
+  if (!EFI_ERROR (Status) && !TlsDigestConfigItem (HashContext, Data, DataSize)) {
+    Status = EFI_UNSUPPORTED;
+  }
+
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (!Sha256Final (HashContext, Digest)) {
+    Status = EFI_UNSUPPORTED;
+  }
+
+ON_EXIT:
+  FreePool (HashContext);
+  return Status;
+}
+
 /**
   Transmit the Packet by processing the associated HTTPS token.
 
@@ -1024,6 +1254,120 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  The callback function to release the fragments received by reference.
+
+  @param[in]  Arg The EDKII_TCP_FRAGMENT_RECEIVE_DATA of the fragments.
+
+**/
+VOID
+EFIAPI
+TlsRecycleFragments (
+  IN VOID  *Arg
+  )
+{
+  ASSERT (Arg != NULL);
+
+  gBS->SignalEvent (((EDKII_TCP_FRAGMENT_RECEIVE_DATA *)Arg)->RecycleSignal);
+}
+
+/**
+  Receive Len bytes by reference through the TCP fragment receive protocol.
+  The data stays in the buffers TCP received it in, one NET_BUF wraps the
+  fragments of each receive.
+
+  @param[in, out]   HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]        Len             The number of bytes to receive.
+  @param[in, out]   NbufList        The list to append the received NET_BUFs to.
+  @param[in]        Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS            The data is received.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_TIMEOUT            The operation is time out.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsCommonReceiveFragments (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     UINT32         Len,
+  IN OUT LIST_ENTRY     *NbufList,
+  IN     EFI_EVENT      Timeout
+  )
+{
+  EDKII_TCP_FRAGMENT_RECEIVE_TOKEN  *Token;
+  EDKII_TCP_FRAGMENT_RECEIVE_DATA   *RxData;
+  NET_BUF                           *Nbuf;
+  EFI_STATUS                        Status;
+
+  ASSERT (HttpInstance->TcpFragmentReceive != NULL);
+
+  Token = &HttpInstance->TlsFragmentRxToken;
+
+  while (Len > 0) {
+    Token->MaxLength = Len;
+    Token->RxData    = NULL;
+
+    Status = HttpInstance->TcpFragmentReceive->Receive (HttpInstance->TcpFragmentReceive, Token);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    while (!HttpInstance->TlsIsRxDone && ((Timeout == NULL) || EFI_ERROR (gBS->CheckEvent (Timeout)))) {
+      //
+      // Poll until some data is received or an error occurs.
+      //
+      if (!HttpInstance->LocalAddressIsIPv6) {
+        HttpInstance->Tcp4->Poll (HttpInstance->Tcp4);
+      } else {
+        HttpInstance->Tcp6->Poll (HttpInstance->Tcp6);
+      }
+    }
+
+    if (!HttpInstance->TlsIsRxDone) {
+      //
+      // Timeout occurs, cancel the receive request.
+      //
+      if (!HttpInstance->LocalAddressIsIPv6) {
+        HttpInstance->Tcp4->Cancel (HttpInstance->Tcp4, &Token->CompletionToken);
+      } else {
+        HttpInstance->Tcp6->Cancel (HttpInstance->Tcp6, (EFI_TCP6_COMPLETION_TOKEN *)&Token->CompletionToken);
+      }
+
+      return EFI_TIMEOUT;
+    }
+
+    HttpInstance->TlsIsRxDone = FALSE;
+
+    Status = Token->CompletionToken.Status;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    RxData = Token->RxData;
+    ASSERT ((RxData != NULL) && (RxData->DataLength <= Len));
+
+    Nbuf = NetbufFromExt (
+             (NET_FRAGMENT *)RxData->FragmentTable,
+             RxData->FragmentCount,
+             0,
+             0,
+             TlsRecycleFragments,
+             RxData
+             );
+    if (Nbuf == NULL) {
+      gBS->SignalEvent (RxData->RecycleSignal);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    InsertTailList (NbufList, &Nbuf->List);
+    Len -= RxData->DataLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Receive one TLS PDU. An TLS PDU contains an TLS record header and its
   corresponding record data. These two parts will be put into two blocks of buffers in the
@@ -1120,6 +1464,18 @@ TlsReceiveOnePdu (
     goto FORM_PDU;
   }
 
+  //
+  // Receive the TLS payload by reference if TCP supports it.
+  //
+  if (HttpInstance->TcpFragmentReceive != NULL) {
+    Status = TlsCommonReceiveFragments (HttpInstance, Len, NbufList, Timeout);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    goto FORM_PDU;
+  }
+
   //
   // Allocate buffer to receive one TLS payload.
   //
@@ -1533,17 +1889,15 @@ TlsCloseSession (
 }
 
 /**
-  Process one message according to the CryptMode.
+  Process the message in a fragment table according to the CryptMode.
 
   @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
-  @param[in]           Message         Pointer to the message buffer needed to processed.
-                                       If ProcessMode is EfiTlsEncrypt, the message contain the TLS
-                                       header and plain text TLS APP payload.
-                                       If ProcessMode is EfiTlsDecrypt, the message contain the TLS
-                                       header and cipher text TLS APP payload.
-  @param[in]           MessageSize     Pointer to the message buffer size.
+  @param[in]           FragmentTable   The fragments of the message, the TLS header
+                                       followed by the TLS APP payload. The caller
+                                       keeps the ownership of the table.
+  @param[in]           FragmentCount   Number of fragments in FragmentTable.
   @param[in]           ProcessMode     Process mode.
-  @param[in, out]      Fragment        Only one Fragment returned after the Message is
+  @param[in, out]      Fragment        Only one Fragment returned after the message is
                                        processed successfully.
                                        If ProcessMode is EfiTlsEncrypt, the fragment contain the TLS
                                        header and cipher text TLS APP payload.
@@ -1557,42 +1911,24 @@ TlsCloseSession (
 **/
 EFI_STATUS
 EFIAPI
-TlsProcessMessage (
-  IN     HTTP_PROTOCOL       *HttpInstance,
-  IN     UINT8               *Message,
-  IN     UINTN               MessageSize,
-  IN     EFI_TLS_CRYPT_MODE  ProcessMode,
-  IN OUT NET_FRAGMENT        *Fragment
+TlsProcessFragments (
+  IN     HTTP_PROTOCOL          *HttpInstance,
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  IN     EFI_TLS_CRYPT_MODE     ProcessMode,
+  IN OUT NET_FRAGMENT           *Fragment
   )
 {
   EFI_STATUS             Status;
   UINT8                  *Buffer;
   UINT32                 BufferSize;
   UINT32                 BytesCopied;
-  EFI_TLS_FRAGMENT_DATA  *FragmentTable;
-  UINT32                 FragmentCount;
   EFI_TLS_FRAGMENT_DATA  *OriginalFragmentTable;
   UINTN                  Index;
 
-  Status                = EFI_SUCCESS;
-  Buffer                = NULL;
-  BufferSize            = 0;
-  BytesCopied           = 0;
-  FragmentTable         = NULL;
-  OriginalFragmentTable = NULL;
-
-  //
-  // Rebuild fragment table from BufferIn.
-  //
-  FragmentCount = 1;
-  FragmentTable = AllocateZeroPool (FragmentCount * sizeof (EFI_TLS_FRAGMENT_DATA));
-  if (FragmentTable == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
-  }
-
-  FragmentTable->FragmentLength = (UINT32)MessageSize;
-  FragmentTable->FragmentBuffer = Message;
+  Buffer      = NULL;
+  BufferSize  = 0;
+  BytesCopied = 0;
 
   //
   // Record the original FragmentTable.
@@ -1650,26 +1986,57 @@ TlsProcessMessage (
 
 ON_EXIT:
 
-  if (OriginalFragmentTable != NULL) {
-    if ( FragmentTable == OriginalFragmentTable) {
-      FragmentTable = NULL;
-    }
-
-    FreePool (OriginalFragmentTable);
-    OriginalFragmentTable = NULL;
-  }
-
   //
-  // Caller has the responsibility to free the FragmentTable.
+  // Caller has the responsibility to free the FragmentTable returned by TLS.
   //
-  if (FragmentTable != NULL) {
+  if ((FragmentTable != NULL) && (FragmentTable != OriginalFragmentTable)) {
     FreePool (FragmentTable);
-    FragmentTable = NULL;
   }
 
   return Status;
 }
 
+/**
+  Process one message according to the CryptMode.
+
+  @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]           Message         Pointer to the message buffer needed to processed.
+                                       If ProcessMode is EfiTlsEncrypt, the message contain the TLS
+                                       header and plain text TLS APP payload.
+                                       If ProcessMode is EfiTlsDecrypt, the message contain the TLS
+                                       header and cipher text TLS APP payload.
+  @param[in]           MessageSize     Pointer to the message buffer size.
+  @param[in]           ProcessMode     Process mode.
+  @param[in, out]      Fragment        Only one Fragment returned after the Message is
+                                       processed successfully.
+                                       If ProcessMode is EfiTlsEncrypt, the fragment contain the TLS
+                                       header and cipher text TLS APP payload.
+                                       If ProcessMode is EfiTlsDecrypt, the fragment contain the TLS
+                                       header and plain text TLS APP payload.
+
+  @retval EFI_SUCCESS          Message is processed successfully.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsProcessMessage (
+  IN     HTTP_PROTOCOL       *HttpInstance,
+  IN     UINT8               *Message,
+  IN     UINTN               MessageSize,
+  IN     EFI_TLS_CRYPT_MODE  ProcessMode,
+  IN OUT NET_FRAGMENT        *Fragment
+  )
+{
+  EFI_TLS_FRAGMENT_DATA  FragmentTable;
+
+  FragmentTable.FragmentLength = (UINT32)MessageSize;
+  FragmentTable.FragmentBuffer = Message;
+
+  return TlsProcessFragments (HttpInstance, &FragmentTable, 1, ProcessMode, Fragment);
+}
+
 /**
   Receive one fragment decrypted from one TLS record.
 
@@ -1694,6 +2061,9 @@ HttpsReceive (
   EFI_STATUS         Status;
   NET_BUF            *Pdu;
   TLS_RECORD_HEADER  RecordHeader;
+  BOOLEAN            IsAppData;
+  NET_FRAGMENT       *PduFragment;
+  UINT32             PduFragmentCount;
   UINT8              *BufferIn;
   UINTN              BufferInSize;
   NET_FRAGMENT       TempFragment;
@@ -1723,42 +2093,58 @@ HttpsReceive (
     return Status;
   }
 
-  BufferInSize = Pdu->TotalSize;
-  BufferIn     = AllocateZeroPool (BufferInSize);
-  if (BufferIn == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    NetbufFree (Pdu);
-    return Status;
-  }
+  NetbufCopy (Pdu, 0, TLS_RECORD_HEADER_LENGTH, (UINT8 *)&RecordHeader);
+
+  IsAppData = (BOOLEAN)((RecordHeader.ContentType == TlsContentTypeApplicationData) &&
+                        (RecordHeader.Version.Major == 0x03) &&
+                        ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
+                         (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
+                         (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR)));
+
+  //
+  // The application data is decrypted straight from the blocks of the
+  // PDU, the other records are flattened into one buffer.
+  //
+  if (!IsAppData) {
+    BufferInSize = Pdu->TotalSize;
+    BufferIn     = AllocateZeroPool (BufferInSize);
+    if (BufferIn == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      NetbufFree (Pdu);
+      return Status;
+    }
 
-  NetbufCopy (Pdu, 0, (UINT32)BufferInSize, BufferIn);
+    NetbufCopy (Pdu, 0, (UINT32)BufferInSize, BufferIn);
 
-  NetbufFree (Pdu);
+    NetbufFree (Pdu);
+  }
 
   //
   // Handle Receive data.
   //
-  RecordHeader = *(TLS_RECORD_HEADER *)BufferIn;
+  if (IsAppData) {
+    PduFragmentCount = Pdu->BlockOpNum;
+    PduFragment      = AllocatePool (PduFragmentCount * sizeof (NET_FRAGMENT));
+    if (PduFragment == NULL) {
+      NetbufFree (Pdu);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    NetbufBuildExt (Pdu, PduFragment, &PduFragmentCount);
 
-  if ((RecordHeader.ContentType == TlsContentTypeApplicationData) &&
-      (RecordHeader.Version.Major == 0x03) &&
-      ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
-       (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
-       (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR))
-      )
-  {
     //
     // Decrypt Packet.
     //
-    Status = TlsProcessMessage (
+    Status = TlsProcessFragments (
                HttpInstance,
-               BufferIn,
-               BufferInSize,
+               (EFI_TLS_FRAGMENT_DATA *)PduFragment,
+               PduFragmentCount,
                EfiTlsDecrypt,
                &TempFragment
                );
 
-    FreePool (BufferIn);
+    FreePool (PduFragment);
+    NetbufFree (Pdu);
 
     if (EFI_ERROR (Status)) {
       if (Status == EFI_ABORTED) {
@@ -45,6 +45,18 @@ TlsCreateChild (
   IN  HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Remove the TLS protocols from the HTTP handle and destroy the TLS child.
+
+  @param[in, out]  HttpInstance  Pointer to HTTP_PROTOCOL structure.
+
+**/
+VOID
+EFIAPI
+TlsDestroyChild (
+  IN OUT HTTP_PROTOCOL  *HttpInstance
+  );
+
 /**
   Create event for the TLS receive and transmit tokens which are used to receive and
   transmit TLS related messages.
@@ -104,6 +116,28 @@ TlsConfigureSession (
   IN OUT HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Compute a digest of the TLS configuration of an HTTP instance: the CA
+  certificates and the cipher list configured from the TlsCaCertificate and
+  HttpTlsCipherList variables, and the client certificate configured through
+  the TLS configuration protocol of the instance.
+
+  @param[in]   HttpInstance      The HTTP instance private data.
+  @param[out]  Digest            The SHA-256 digest of the configuration,
+                                 SHA256_DIGEST_SIZE bytes.
+
+  @retval EFI_SUCCESS            The digest is computed.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_UNSUPPORTED        SHA-256 is not available.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+TlsGetConfigDigest (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  OUT UINT8          *Digest
+  );
+
 /**
   Transmit the Packet by processing the associated HTTPS token.
 
@@ -146,6 +180,31 @@ TlsCommonReceive (
   IN     EFI_EVENT      Timeout
   );
 
+/**
+  Receive Len bytes by reference through the TCP fragment receive protocol.
+  The data stays in the buffers TCP received it in, one NET_BUF wraps the
+  fragments of each receive.
+
+  @param[in, out]   HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]        Len             The number of bytes to receive.
+  @param[in, out]   NbufList        The list to append the received NET_BUFs to.
+  @param[in]        Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS            The data is received.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_TIMEOUT            The operation is time out.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsCommonReceiveFragments (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     UINT32         Len,
+  IN OUT LIST_ENTRY     *NbufList,
+  IN     EFI_EVENT      Timeout
+  );
+
 /**
   Receive one TLS PDU. An TLS PDU contains an TLS record header and its
   corresponding record data. These two parts will be put into two blocks of buffers in the
@@ -205,6 +264,37 @@ TlsCloseSession (
   IN  HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Process the message in a fragment table according to the CryptMode.
+
+  @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]           FragmentTable   The fragments of the message, the TLS header
+                                       followed by the TLS APP payload. The caller
+                                       keeps the ownership of the table.
+  @param[in]           FragmentCount   Number of fragments in FragmentTable.
+  @param[in]           ProcessMode     Process mode.
+  @param[in, out]      Fragment        Only one Fragment returned after the message is
+                                       processed successfully.
+                                       If ProcessMode is EfiTlsEncrypt, the fragment contain the TLS
+                                       header and cipher text TLS APP payload.
+                                       If ProcessMode is EfiTlsDecrypt, the fragment contain the TLS
+                                       header and plain text TLS APP payload.
+
+  @retval EFI_SUCCESS          Message is processed successfully.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsProcessFragments (
+  IN     HTTP_PROTOCOL          *HttpInstance,
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  IN     EFI_TLS_CRYPT_MODE     ProcessMode,
+  IN OUT NET_FRAGMENT           *Fragment
+  );
+
 /**
   Process one message according to the CryptMode.
 
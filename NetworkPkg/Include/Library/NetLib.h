@@ -1556,6 +1556,7 @@ NetLibIp6ToStr (
 #define  NET_BUF_HEAD          1    // Trim or allocate space from head
 #define  NET_BUF_TAIL          0    // Trim or allocate space from tail
 #define  NET_VECTOR_OWN_FIRST  0x01 // We allocated the 1st block in the vector
+#define  NET_VECTOR_CACHED     0x02 // The 1st block is from the NET_BUF cache
 
 #define NET_CHECK_SIGNATURE(PData, SIGNATURE) \
   ASSERT (((PData) != NULL) && ((PData)->Signature == (SIGNATURE)))
@@ -1695,6 +1696,26 @@ typedef struct {
 #define NET_TAILSPACE(BlockOp)  \
   ((UINTN)((BlockOp)->BlockTail) - (UINTN)((BlockOp)->Tail))
 
+//
+// The counters of one object cache of the NET_BUF cache.
+//
+typedef struct {
+  UINT64    Hits;                   // Allocations served from the cache
+  UINT64    Misses;                 // Allocations from the memory pool
+  UINT32    Cached;                 // Freed objects kept in the cache
+} NET_BUF_CACHE_COUNTER;
+
+//
+// The counters of the NET_BUF cache, which recycles the NET_BUF
+// structures, the NET_VECTOR structures and the data blocks of
+// NetbufAlloc() of the module.
+//
+typedef struct {
+  NET_BUF_CACHE_COUNTER    Buf;
+  NET_BUF_CACHE_COUNTER    Vector;
+  NET_BUF_CACHE_COUNTER    Block;
+} NET_BUF_CACHE_STATISTICS;
+
 /**
   Allocate a single block NET_BUF. Upon allocation, all the
   free space is in the tail room.
@@ -2231,6 +2252,18 @@ NetIpSecNetbufFree (
   NET_BUF  *Nbuf
   );
 
+/**
+  Get the counters of the NET_BUF cache of the module.
+
+  @param[out]  Statistics     The counters of the NET_BUF cache.
+
+**/
+VOID
+EFIAPI
+NetbufGetCacheStatistics (
+  OUT NET_BUF_CACHE_STATISTICS  *Statistics
+  );
+
 /**
   This function obtains the system guid from the smbios table.
 
@@ -0,0 +1,58 @@
+/** @file
+  This file defines the EDKII MNP Statistics Protocol interface.
+
+  The protocol is installed by MnpDxe on the controller handle of every
+  network device it manages. It reports how many packets MNP received
+  from the Simple Network Protocol, how many it dropped, and the current
+  interval of its receive poll.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_MNP_STATISTICS_H_
+#define EDKII_MNP_STATISTICS_H_
+
+#define EDKII_MNP_STATISTICS_PROTOCOL_GUID \
+  { \
+    0x152ac557, 0x504d, 0x4a50, {0x8c, 0xa9, 0x1f, 0x5e, 0x28, 0x2d, 0xa3, 0x5a} \
+  }
+
+typedef struct _EDKII_MNP_STATISTICS_PROTOCOL EDKII_MNP_STATISTICS_PROTOCOL;
+
+///
+/// The receive statistics of a network device.
+///
+typedef struct {
+  UINT64    RxPackets;          ///< Packets received from the Simple Network Protocol.
+  UINT64    RxDropped;          ///< Packets dropped on receive errors, queue overflow or timeout.
+  UINT64    RxNoReceiver;       ///< Packets that no MNP child wanted.
+  UINT32    RxPacketsPerSecond; ///< Receive rate measured over the last second.
+  UINT32    RxBatchMax;         ///< The most packets received in one poll.
+  UINT64    PollInterval;       ///< Current interval of the receive poll, in 100ns units.
+} EDKII_MNP_STATISTICS;
+
+/**
+  Get the receive statistics of the network device.
+
+  @param[in]   This                Pointer to the EDKII_MNP_STATISTICS_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MNP_GET_STATISTICS)(
+  IN  EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  OUT EDKII_MNP_STATISTICS           *Statistics
+  );
+
+struct _EDKII_MNP_STATISTICS_PROTOCOL {
+  EDKII_MNP_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiMnpStatisticsProtocolGuid;
+
+#endif
@@ -0,0 +1,111 @@
+/** @file
+  This file defines the EDKII TCP Fragment Receive Protocol interface.
+
+  The protocol is installed by TcpDxe on every TCP4 and TCP6 child handle
+  next to the EFI_TCP4_PROTOCOL or EFI_TCP6_PROTOCOL instance. It hands the
+  received data over as fragments that still reside in the buffers the data
+  was received in, instead of copying it into a caller supplied buffer the
+  way Receive() of the TCP protocols does. The caller signals RecycleSignal
+  to release the fragments once it has consumed them.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_TCP_FRAGMENT_RECEIVE_H_
+#define EDKII_TCP_FRAGMENT_RECEIVE_H_
+
+#include <Protocol/Tcp4.h>
+
+#define EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL_GUID \
+  { \
+    0x5d2f6a83, 0x1c4e, 0x4b7a, {0x9e, 0x02, 0x7b, 0x31, 0xc8, 0x4d, 0x6f, 0x15} \
+  }
+
+typedef struct _EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL;
+
+///
+/// The data received by reference. The fragments stay valid until
+/// RecycleSignal is signaled by the consumer.
+///
+typedef struct {
+  BOOLEAN                   UrgentFlag;
+  UINT32                    DataLength;
+  EFI_EVENT                 RecycleSignal;
+  UINT32                    FragmentCount;
+  EFI_TCP4_FRAGMENT_DATA    FragmentTable[1];
+} EDKII_TCP_FRAGMENT_RECEIVE_DATA;
+
+typedef struct {
+  ///
+  /// The Event is signaled and Status is updated when the receive completes.
+  /// The token can be canceled with Cancel() of the TCP protocol.
+  ///
+  EFI_TCP4_COMPLETION_TOKEN          CompletionToken;
+  ///
+  /// The maximum number of bytes to receive, set by the caller.
+  ///
+  UINT32                             MaxLength;
+  ///
+  /// The received data, set by the driver when Status is EFI_SUCCESS.
+  ///
+  EDKII_TCP_FRAGMENT_RECEIVE_DATA    *RxData;
+} EDKII_TCP_FRAGMENT_RECEIVE_TOKEN;
+
+///
+/// The number of bytes a TCP instance has delivered to its consumers.
+///
+typedef struct {
+  UINT64    BytesCopied;      ///< Copied into the buffers of Receive() tokens.
+  UINT64    BytesByReference; ///< Handed over in fragments without copy.
+} EDKII_TCP_RECEIVE_STATISTICS;
+
+/**
+  Place an asynchronous request to receive data by reference.
+
+  The token is completed with the data buffered in the TCP instance, at
+  most MaxLength bytes, as soon as some data is available. The tokens are
+  served in the same queue as the tokens of Receive() of the TCP protocol.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[in]  Token                Pointer to the receive token.
+
+  @retval EFI_SUCCESS              The receive token was queued or completed.
+  @retval EFI_INVALID_PARAMETER    This or Token is NULL, Token->CompletionToken.Event
+                                   is NULL or Token->MaxLength is 0.
+  @retval Others                   The same errors as Receive() of the TCP protocol.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TCP_FRAGMENT_RECEIVE)(
+  IN EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  IN EDKII_TCP_FRAGMENT_RECEIVE_TOKEN     *Token
+  );
+
+/**
+  Get the number of bytes the TCP instance has delivered by copy and by
+  reference since it was created.
+
+  @param[in]   This                Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TCP_FRAGMENT_RECEIVE_GET_STATISTICS)(
+  IN  EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  OUT EDKII_TCP_RECEIVE_STATISTICS         *Statistics
+  );
+
+struct _EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL {
+  EDKII_TCP_FRAGMENT_RECEIVE                   Receive;
+  EDKII_TCP_FRAGMENT_RECEIVE_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiTcpFragmentReceiveProtocolGuid;
+
+#endif
@@ -0,0 +1,32 @@
+/** @file
+  Sum the data of a checksum with Advanced SIMD, which every AArch64
+  processor running UEFI has enabled.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include "../NetChecksum.h"
+
+/**
+  Sum the data in 32 bit words with the fastest implementation of the
+  processor.
+
+  @param[in]   Bulk                  Pointer to the data, 4 byte aligned.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumBlocks (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  )
+{
+  return InternalNetSumNeon (Bulk, Length);
+}
@@ -0,0 +1,366 @@
+/** @file
+  Tests for the checksum functions and the NET_BUF cache of NetBuffer.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/NetLib.h>
+  #include "../NetChecksum.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_BUFFER_SIZE  (65536 + 16)
+#define TEST_MAX_OFFSET   8
+#define TEST_MAX_LENGTH   300
+#define TEST_CACHE_DEPTH  64U   // NET_BUF_CACHE_DEPTH
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+typedef UINT64 (EFIAPI *NET_SUM_FUNCTION)(
+  CONST VOID  *Bulk,
+  UINTN       Length
+  );
+
+// Sum some whole blocks at every 4 byte aligned offset, and unaligned ones,
+// with an implementation and with InternalNetSumWords.
+static VOID
+ExpectSameSumAsWords (
+  NET_SUM_FUNCTION  SumFunction,
+  UINT8             *Buffer
+  )
+{
+  UINT32  Offset;
+  UINTN   Length;
+
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    for (Length = 0; Length <= 16 * NET_SUM_BLOCK_SIZE; Length += NET_SUM_BLOCK_SIZE) {
+      ASSERT_EQ (SumFunction (Buffer + Offset, Length), InternalNetSumWords (Buffer + Offset, Length))
+        << "Offset " << Offset << " Length " << Length;
+    }
+  }
+
+  Length = (65536 / NET_SUM_BLOCK_SIZE) * NET_SUM_BLOCK_SIZE;
+  EXPECT_EQ (SumFunction (Buffer, Length), InternalNetSumWords (Buffer, Length));
+}
+
+// The checksum as RFC1071 defines it, one 16 bit word at a time, in
+// network byte order. Returned in host byte order like NetblockChecksum.
+static UINT16
+ReferenceChecksum (
+  UINT8   *Bulk,
+  UINT32  Len
+  )
+{
+  UINT32  Sum;
+  UINT32  Index;
+
+  Sum = 0;
+  for (Index = 0; Index + 1 < Len; Index += 2) {
+    Sum += ((UINT32)Bulk[Index] << 8) | Bulk[Index + 1];
+  }
+
+  if ((Len & 0x01) != 0) {
+    Sum += (UINT32)Bulk[Len - 1] << 8;
+  }
+
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return NTOHS ((UINT16)Sum);
+}
+
+static VOID
+EFIAPI
+TestExtFree (
+  VOID  *Arg
+  )
+{
+}
+
+// Fixture owning a buffer with a repeatable pseudo random content.
+class NetChecksumTest : public ::testing::Test {
+protected:
+  UINT8 *Buffer;
+
+  virtual void
+  SetUp (
+    )
+  {
+    UINT32  Seed;
+    UINT32  Index;
+
+    Buffer = new UINT8[TEST_BUFFER_SIZE];
+    Seed   = 0x12345678;
+    for (Index = 0; Index < TEST_BUFFER_SIZE; Index++) {
+      Seed          = Seed * 1103515245 + 12345;
+      Buffer[Index] = (UINT8)(Seed >> 16);
+    }
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    delete[] Buffer;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// NetblockChecksum
+////////////////////////////////////////////////////////////////////////
+
+// Every alignment and every short length, including the odd ones.
+TEST_F (NetChecksumTest, BlockMatchesReferenceForAllAlignments) {
+  UINT32  Offset;
+  UINT32  Len;
+
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    for (Len = 0; Len <= TEST_MAX_LENGTH; Len++) {
+      ASSERT_EQ (NetblockChecksum (Buffer + Offset, Len), ReferenceChecksum (Buffer + Offset, Len))
+        << "Offset " << Offset << " Length " << Len;
+    }
+  }
+}
+
+// A jumbo sized block, long enough to carry out of 32 bits many times.
+TEST_F (NetChecksumTest, BlockMatchesReferenceForLargeBlocks) {
+  UINT32  Offset;
+
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    EXPECT_EQ (NetblockChecksum (Buffer + Offset, 65536 + Offset), ReferenceChecksum (Buffer + Offset, 65536 + Offset));
+  }
+}
+
+// All ones produce the largest carries in every word.
+TEST_F (NetChecksumTest, BlockOfAllOnes) {
+  UINT32  Offset;
+
+  SetMem (Buffer, TEST_BUFFER_SIZE, 0xff);
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    EXPECT_EQ (NetblockChecksum (Buffer + Offset, 65536 + Offset), ReferenceChecksum (Buffer + Offset, 65536 + Offset));
+    EXPECT_EQ (NetblockChecksum (Buffer + Offset, 1501), ReferenceChecksum (Buffer + Offset, 1501));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////
+// InternalNetSumBlocks and the SIMD implementations
+////////////////////////////////////////////////////////////////////////
+
+// The implementation selected for the processor sums the same as C.
+TEST_F (NetChecksumTest, SumBlocksMatchesWords) {
+  ExpectSameSumAsWords (InternalNetSumBlocks, Buffer);
+  SetMem (Buffer, TEST_BUFFER_SIZE, 0xff);
+  ExpectSameSumAsWords (InternalNetSumBlocks, Buffer);
+}
+
+#if defined (MDE_CPU_X64)
+
+TEST_F (NetChecksumTest, Sse2MatchesWords) {
+  ExpectSameSumAsWords (InternalNetSumSse2, Buffer);
+  SetMem (Buffer, TEST_BUFFER_SIZE, 0xff);
+  ExpectSameSumAsWords (InternalNetSumSse2, Buffer);
+}
+
+TEST_F (NetChecksumTest, Avx2MatchesWords) {
+  if (!InternalNetIsAvx2Enabled ()) {
+    GTEST_SKIP () << "AVX2 is not enabled";
+  }
+
+  ExpectSameSumAsWords (InternalNetSumAvx2, Buffer);
+  SetMem (Buffer, TEST_BUFFER_SIZE, 0xff);
+  ExpectSameSumAsWords (InternalNetSumAvx2, Buffer);
+}
+
+#elif defined (MDE_CPU_AARCH64)
+
+TEST_F (NetChecksumTest, NeonMatchesWords) {
+  ExpectSameSumAsWords (InternalNetSumNeon, Buffer);
+  SetMem (Buffer, TEST_BUFFER_SIZE, 0xff);
+  ExpectSameSumAsWords (InternalNetSumNeon, Buffer);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+// NetbufChecksum
+////////////////////////////////////////////////////////////////////////
+
+// A NET_BUF split into blocks of odd sizes sums the same as the
+// contiguous data.
+TEST_F (NetChecksumTest, NetbufMatchesContiguousData) {
+  NET_FRAGMENT  Fragment[4];
+  NET_BUF       *Nbuf;
+
+  Fragment[0].Bulk = Buffer + 1;
+  Fragment[0].Len  = 13;
+  Fragment[1].Bulk = Buffer + 14;
+  Fragment[1].Len  = 1000;
+  Fragment[2].Bulk = Buffer + 1014;
+  Fragment[2].Len  = 7;
+  Fragment[3].Bulk = Buffer + 1021;
+  Fragment[3].Len  = 480;
+
+  Nbuf = NetbufFromExt (Fragment, 4, 0, 0, TestExtFree, NULL);
+  ASSERT_NE (Nbuf, (NET_BUF *)NULL);
+
+  EXPECT_EQ (NetbufChecksum (Nbuf), ReferenceChecksum (Buffer + 1, 1500));
+
+  NetbufFree (Nbuf);
+}
+
+////////////////////////////////////////////////////////////////////////
+// NetPseudoHeadChecksum
+////////////////////////////////////////////////////////////////////////
+
+// The pseudo header sum is the same as the sum of the header in memory.
+TEST_F (NetChecksumTest, PseudoHeaderMatchesHeaderInMemory) {
+  NET_PSEUDO_HDR  Hdr;
+  IP4_ADDR        Src;
+  IP4_ADDR        Dst;
+
+  CopyMem (&Src, Buffer, sizeof (Src));
+  CopyMem (&Dst, Buffer + 4, sizeof (Dst));
+
+  ZeroMem (&Hdr, sizeof (Hdr));
+  Hdr.SrcIp    = Src;
+  Hdr.DstIp    = Dst;
+  Hdr.Protocol = EFI_IP_PROTO_TCP;
+  Hdr.Len      = HTONS (1480);
+
+  EXPECT_EQ (
+    NetPseudoHeadChecksum (Src, Dst, EFI_IP_PROTO_TCP, 1480),
+    ReferenceChecksum ((UINT8 *)&Hdr, sizeof (Hdr))
+    );
+
+  //
+  // All ones carry out of every word.
+  //
+  Hdr.SrcIp    = 0xffffffff;
+  Hdr.DstIp    = 0xffffffff;
+  Hdr.Protocol = 0xff;
+  Hdr.Len      = 0xffff;
+
+  EXPECT_EQ (
+    NetPseudoHeadChecksum (0xffffffff, 0xffffffff, 0xff, 0xffff),
+    ReferenceChecksum ((UINT8 *)&Hdr, sizeof (Hdr))
+    );
+}
+
+////////////////////////////////////////////////////////////////////////
+// NET_BUF cache
+////////////////////////////////////////////////////////////////////////
+
+class NetbufCacheTest : public ::testing::Test {
+protected:
+  NET_BUF_CACHE_STATISTICS Before;
+  NET_BUF_CACHE_STATISTICS After;
+
+  virtual void
+  SetUp (
+    )
+  {
+    NetbufGetCacheStatistics (&Before);
+  }
+};
+
+// A freed frame sized buffer is recycled, and comes back with its
+// protocol data zeroed like a new one.
+TEST_F (NetbufCacheTest, FrameBufferIsRecycled) {
+  NET_BUF  *Nbuf;
+
+  Nbuf = NetbufAlloc (1514);
+  ASSERT_NE (Nbuf, (NET_BUF *)NULL);
+  SetMem (Nbuf->ProtoData, NET_PROTO_DATA, 0x5a);
+  SetMem (NetbufAllocSpace (Nbuf, 1514, NET_BUF_TAIL), 1514, 0xa5);
+  NetbufFree (Nbuf);
+  NetbufGetCacheStatistics (&Before);
+
+  Nbuf = NetbufAlloc (1514);
+  ASSERT_NE (Nbuf, (NET_BUF *)NULL);
+  NetbufGetCacheStatistics (&After);
+
+  EXPECT_EQ (After.Buf.Hits, Before.Buf.Hits + 1);
+  EXPECT_EQ (After.Vector.Hits, Before.Vector.Hits + 1);
+  EXPECT_EQ (After.Block.Hits, Before.Block.Hits + 1);
+  EXPECT_EQ (Nbuf->TotalSize, 0U);
+  EXPECT_EQ (Nbuf->Vector->Len, 1514U);
+  EXPECT_EQ (NET_TAILSPACE (&Nbuf->BlockOp[0]), 1514U);
+  EXPECT_EQ (NetbufAllocSpace (Nbuf, 1514, NET_BUF_TAIL), Nbuf->BlockOp[0].BlockHead);
+  for (UINT32 Index = 0; Index < NET_PROTO_DATA; Index++) {
+    ASSERT_EQ (Nbuf->ProtoData[Index], 0);
+  }
+
+  NetbufFree (Nbuf);
+}
+
+// Small data blocks are not worth a frame sized block, they come from
+// the memory pool.
+TEST_F (NetbufCacheTest, SmallBlockIsNotCached) {
+  NET_BUF  *Nbuf;
+
+  Nbuf = NetbufAlloc (64);
+  ASSERT_NE (Nbuf, (NET_BUF *)NULL);
+  NetbufFree (Nbuf);
+
+  NetbufGetCacheStatistics (&After);
+  EXPECT_EQ (After.Block.Hits, Before.Block.Hits);
+  EXPECT_EQ (After.Block.Misses, Before.Block.Misses);
+  EXPECT_EQ (After.Block.Cached, Before.Block.Cached);
+}
+
+// Clones share the vector, which goes back to the cache only after the
+// last reference is freed.
+TEST_F (NetbufCacheTest, ClonedBufferIsRecycledOnce) {
+  NET_BUF  *Nbuf;
+  NET_BUF  *Clone;
+
+  Nbuf = NetbufAlloc (2048);
+  ASSERT_NE (Nbuf, (NET_BUF *)NULL);
+  Clone = NetbufClone (Nbuf);
+  ASSERT_NE (Clone, (NET_BUF *)NULL);
+  NetbufGetCacheStatistics (&Before);
+
+  NetbufFree (Nbuf);
+  NetbufGetCacheStatistics (&After);
+  EXPECT_EQ (After.Buf.Cached, MIN (Before.Buf.Cached + 1, TEST_CACHE_DEPTH));
+  EXPECT_EQ (After.Vector.Cached, Before.Vector.Cached);
+  EXPECT_EQ (After.Block.Cached, Before.Block.Cached);
+
+  NetbufFree (Clone);
+  NetbufGetCacheStatistics (&After);
+  EXPECT_EQ (After.Vector.Cached, MIN (Before.Vector.Cached + 1, TEST_CACHE_DEPTH));
+  EXPECT_EQ (After.Block.Cached, MIN (Before.Block.Cached + 1, TEST_CACHE_DEPTH));
+}
+
+// The cache keeps a bounded number of objects, the rest goes back to
+// the memory pool.
+TEST_F (NetbufCacheTest, CacheDepthIsBounded) {
+  NET_BUF  *Nbuf[100];
+  UINT32   Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    Nbuf[Index] = NetbufAlloc (1500);
+    ASSERT_NE (Nbuf[Index], (NET_BUF *)NULL);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    NetbufFree (Nbuf[Index]);
+  }
+
+  NetbufGetCacheStatistics (&After);
+  EXPECT_EQ (After.Buf.Cached, TEST_CACHE_DEPTH);
+  EXPECT_EQ (After.Vector.Cached, TEST_CACHE_DEPTH);
+  EXPECT_EQ (After.Block.Cached, TEST_CACHE_DEPTH);
+}
@@ -14,6 +14,267 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+#include "NetChecksum.h"
+
+//
+// The NET_BUF cache keeps the freed NET_BUF and NET_VECTOR structures
+// and the data blocks of NetbufAlloc() on free lists, so that the packets
+// sent and received at line rate don't go to the memory pool every time.
+// The structures with up to NET_BUF_CACHE_BLOCK_NUM blocks are cached in
+// the size of NET_BUF_CACHE_BLOCK_NUM blocks. The data blocks longer than
+// half of NET_BUF_CACHE_BLOCK_SIZE, up to NET_BUF_CACHE_BLOCK_SIZE, are
+// cached in NET_BUF_CACHE_BLOCK_SIZE, that covers the Ethernet frames.
+// Each free list keeps at most NET_BUF_CACHE_DEPTH objects. The free
+// lists are only changed at TPL_NOTIFY.
+//
+#define NET_BUF_CACHE_DEPTH       64
+#define NET_BUF_CACHE_BLOCK_NUM   4
+#define NET_BUF_CACHE_BLOCK_SIZE  2048
+
+typedef struct {
+  VOID                     *FreeList;  // Linked through the first pointer of the objects
+  UINTN                    Size;
+  NET_BUF_CACHE_COUNTER    *Counter;
+} NET_BUF_CACHE;
+
+NET_BUF_CACHE_STATISTICS  mNetbufCacheStatistics;
+
+NET_BUF_CACHE  mNetbufBufCache = {
+  NULL,
+  NET_BUF_SIZE (NET_BUF_CACHE_BLOCK_NUM),
+  &mNetbufCacheStatistics.Buf
+};
+
+NET_BUF_CACHE  mNetbufVectorCache = {
+  NULL,
+  NET_VECTOR_SIZE (NET_BUF_CACHE_BLOCK_NUM),
+  &mNetbufCacheStatistics.Vector
+};
+
+NET_BUF_CACHE  mNetbufBlockCache = {
+  NULL,
+  NET_BUF_CACHE_BLOCK_SIZE,
+  &mNetbufCacheStatistics.Block
+};
+
+/**
+  Allocate an object from the NET_BUF cache, or from the memory pool
+  if the cache is empty.
+
+  @param[in, out]  Cache     The cache to allocate from.
+
+  @return  Pointer to the object of Cache->Size bytes, or NULL if the
+           allocation failed due to resource limit.
+
+**/
+VOID *
+NetbufCacheAlloc (
+  IN OUT NET_BUF_CACHE  *Cache
+  )
+{
+  EFI_TPL  OldTpl;
+  VOID     *Object;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Object = Cache->FreeList;
+  if (Object != NULL) {
+    Cache->FreeList = *(VOID **)Object;
+    Cache->Counter->Cached--;
+    Cache->Counter->Hits++;
+  } else {
+    Cache->Counter->Misses++;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Object == NULL) {
+    Object = AllocatePool (Cache->Size);
+  }
+
+  return Object;
+}
+
+/**
+  Return an object to the NET_BUF cache, or to the memory pool if the
+  cache is full.
+
+  @param[in, out]  Cache     The cache the object was allocated from.
+  @param[in]       Object    The object to free.
+
+**/
+VOID
+NetbufCacheFree (
+  IN OUT NET_BUF_CACHE  *Cache,
+  IN     VOID           *Object
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Cache->Counter->Cached < NET_BUF_CACHE_DEPTH) {
+    *(VOID **)Object = Cache->FreeList;
+    Cache->FreeList  = Object;
+    Cache->Counter->Cached++;
+    Object = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Object != NULL) {
+    FreePool (Object);
+  }
+}
+
+/**
+  Free all the objects kept in a NET_BUF cache.
+
+  @param[in, out]  Cache     The cache to drain.
+
+**/
+VOID
+NetbufCacheDrain (
+  IN OUT NET_BUF_CACHE  *Cache
+  )
+{
+  EFI_TPL  OldTpl;
+  VOID     *FreeList;
+  VOID     *Object;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  FreeList               = Cache->FreeList;
+  Cache->FreeList        = NULL;
+  Cache->Counter->Cached = 0;
+
+  gBS->RestoreTPL (OldTpl);
+
+  while (FreeList != NULL) {
+    Object   = FreeList;
+    FreeList = *(VOID **)Object;
+    FreePool (Object);
+  }
+}
+
+/**
+  Allocate the memory of a NET_BUF structure, it isn't initialized.
+
+  @param[in]  BlockOpNum     The number of NET_BLOCK_OP in the net buffer.
+
+  @return  Pointer to the NET_BUF, or NULL if the allocation failed due to
+           resource limit.
+
+**/
+NET_BUF *
+NetbufAllocBufStruct (
+  IN UINT32  BlockOpNum
+  )
+{
+  if (BlockOpNum <= NET_BUF_CACHE_BLOCK_NUM) {
+    return NetbufCacheAlloc (&mNetbufBufCache);
+  }
+
+  return AllocatePool (NET_BUF_SIZE (BlockOpNum));
+}
+
+/**
+  Free the memory of a NET_BUF structure.
+
+  @param[in]  Nbuf           The NET_BUF to free.
+
+**/
+VOID
+NetbufFreeBufStruct (
+  IN NET_BUF  *Nbuf
+  )
+{
+  if (Nbuf->BlockOpNum <= NET_BUF_CACHE_BLOCK_NUM) {
+    NetbufCacheFree (&mNetbufBufCache, Nbuf);
+  } else {
+    FreePool (Nbuf);
+  }
+}
+
+/**
+  Free the memory of a NET_VECTOR structure, and its first block if it is
+  from the NET_BUF cache.
+
+  @param[in]  Vector         The NET_VECTOR to free.
+
+**/
+VOID
+NetbufFreeVectorStruct (
+  IN NET_VECTOR  *Vector
+  )
+{
+  if ((Vector->Flag & NET_VECTOR_CACHED) != 0) {
+    NetbufCacheFree (&mNetbufBlockCache, Vector->Block[0].Bulk);
+  }
+
+  if (Vector->BlockNum <= NET_BUF_CACHE_BLOCK_NUM) {
+    NetbufCacheFree (&mNetbufVectorCache, Vector);
+  } else {
+    FreePool (Vector);
+  }
+}
+
+/**
+  Get the counters of the NET_BUF cache of the module.
+
+  @param[out]  Statistics     The counters of the NET_BUF cache.
+
+**/
+VOID
+EFIAPI
+NetbufGetCacheStatistics (
+  OUT NET_BUF_CACHE_STATISTICS  *Statistics
+  )
+{
+  EFI_TPL  OldTpl;
+
+  ASSERT (Statistics != NULL);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  CopyMem (Statistics, &mNetbufCacheStatistics, sizeof (NET_BUF_CACHE_STATISTICS));
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  The destructor of the library, it frees the objects kept in the
+  NET_BUF cache when the module is unloaded.
+
+  @param[in]  ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in]  SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS        The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+NetbufCacheDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "NetbufCache: buf %ld/%ld, vector %ld/%ld, block %ld/%ld hits/misses\n",
+    mNetbufCacheStatistics.Buf.Hits,
+    mNetbufCacheStatistics.Buf.Misses,
+    mNetbufCacheStatistics.Vector.Hits,
+    mNetbufCacheStatistics.Vector.Misses,
+    mNetbufCacheStatistics.Block.Hits,
+    mNetbufCacheStatistics.Block.Misses
+    ));
+
+  NetbufCacheDrain (&mNetbufBufCache);
+  NetbufCacheDrain (&mNetbufVectorCache);
+  NetbufCacheDrain (&mNetbufBlockCache);
+
+  return EFI_SUCCESS;
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,24 +303,32 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetbufAllocBufStruct (BlockOpNum);
 
   if (Nbuf == NULL) {
     return NULL;
   }
 
+  ZeroMem (Nbuf, NET_BUF_SIZE (BlockOpNum));
+
   Nbuf->Signature  = NET_BUF_SIGNATURE;
   Nbuf->RefCnt     = 1;
   Nbuf->BlockOpNum = BlockOpNum;
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    if (BlockNum <= NET_BUF_CACHE_BLOCK_NUM) {
+      Vector = NetbufCacheAlloc (&mNetbufVectorCache);
+    } else {
+      Vector = AllocatePool (NET_VECTOR_SIZE (BlockNum));
+    }
 
     if (Vector == NULL) {
       goto FreeNbuf;
     }
 
+    ZeroMem (Vector, NET_VECTOR_SIZE (BlockNum));
+
     Vector->Signature = NET_VECTOR_SIGNATURE;
     Vector->RefCnt    = 1;
     Vector->BlockNum  = BlockNum;
@@ -70,7 +339,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufFreeBufStruct (Nbuf);
   return NULL;
 }
 
@@ -102,13 +371,19 @@ NetbufAlloc (
     return NULL;
   }
 
-  Bulk = AllocatePool (Len);
+  Vector = Nbuf->Vector;
+
+  if ((Len > NET_BUF_CACHE_BLOCK_SIZE / 2) && (Len <= NET_BUF_CACHE_BLOCK_SIZE)) {
+    Bulk         = NetbufCacheAlloc (&mNetbufBlockCache);
+    Vector->Flag = NET_VECTOR_CACHED;
+  } else {
+    Bulk = AllocatePool (Len);
+  }
 
   if (Bulk == NULL) {
     goto FreeNBuf;
   }
 
-  Vector      = Nbuf->Vector;
   Vector->Len = Len;
 
   Vector->Block[0].Bulk = Bulk;
@@ -124,7 +399,9 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  Vector->Flag = 0;
+  NetbufFreeVectorStruct (Vector);
+  NetbufFreeBufStruct (Nbuf);
   return NULL;
 }
 
@@ -168,14 +445,19 @@ NetbufFreeVector (
     Vector->Free (Vector->Arg);
   } else {
     //
-    // Free each memory block associated with the Vector
+    // Free each memory block associated with the Vector. The first
+    // block from the NET_BUF cache is freed with the Vector.
     //
     for (Index = 0; Index < Vector->BlockNum; Index++) {
+      if ((Index == 0) && ((Vector->Flag & NET_VECTOR_CACHED) != 0)) {
+        continue;
+      }
+
       gBS->FreePool (Vector->Block[Index].Bulk);
     }
   }
 
-  FreePool (Vector);
+  NetbufFreeVectorStruct (Vector);
 }
 
 /**
@@ -208,7 +490,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeBufStruct (Nbuf);
   }
 }
 
@@ -234,7 +516,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetbufAllocBufStruct (Nbuf->BlockOpNum);
 
   if (Clone == NULL) {
     return NULL;
@@ -662,7 +944,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetbufFreeVectorStruct (Child->Vector);
+  NetbufFreeBufStruct (Child);
   return NULL;
 }
 
@@ -1601,6 +1884,43 @@ NetbufQueFlush (
   NbufQue->BufSize = 0;
 }
 
+/**
+  Sum the data in 32 bit words, in C.
+
+  @param[in]   Bulk                  Pointer to the data, 4 byte aligned.
+  @param[in]   Length                Length of the data in bytes, a multiple of 4.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumWords (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  )
+{
+  CONST UINT32  *Word;
+  UINT64        Sum;
+
+  Word = (CONST UINT32 *)Bulk;
+  Sum  = 0;
+
+  while (Length >= 16) {
+    Sum    += (UINT64)Word[0] + Word[1] + Word[2] + Word[3];
+    Word   += 4;
+    Length -= 16;
+  }
+
+  while (Length >= 4) {
+    Sum    += *Word;
+    Word   += 1;
+    Length -= 4;
+  }
+
+  return Sum;
+}
+
 /**
   Compute the checksum for a bulk of data.
 
@@ -1617,31 +1937,66 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64   Sum;
+  BOOLEAN  Odd;
+  UINT32   BlockLen;
 
   Sum = 0;
+  Odd = FALSE;
 
   //
-  // Add left-over byte, if any
+  // The one's complement sum is independent of the byte order (RFC1071),
+  // so the data can be summed in 32 bit words into a 64 bit accumulator
+  // that can't overflow for any UINT32 length. Align the data first. If
+  // it starts at an odd address, sum it from the next byte and swap the
+  // result; the first byte becomes the high byte of a word then. The bulk
+  // of the data is summed with the SIMD instructions of the processor.
   //
-  if (Len % 2 != 0) {
-    Sum += *(Bulk + Len - 1);
+  if ((Len > 0) && (((UINTN)Bulk & 0x01) != 0)) {
+    Sum   = (UINT32)*Bulk << 8;
+    Odd   = TRUE;
+    Bulk += 1;
+    Len  -= 1;
+  }
+
+  if ((Len >= 2) && (((UINTN)Bulk & 0x02) != 0)) {
+    Sum  += *(UINT16 *)Bulk;
+    Bulk += 2;
+    Len  -= 2;
   }
 
-  while (Len > 1) {
+  BlockLen = Len & ~(UINT32)(NET_SUM_BLOCK_SIZE - 1);
+  if (BlockLen != 0) {
+    Sum  += InternalNetSumBlocks (Bulk, BlockLen);
+    Bulk += BlockLen;
+    Len  -= BlockLen;
+  }
+
+  Sum  += InternalNetSumWords (Bulk, Len & ~(UINT32)0x03);
+  Bulk += Len & ~(UINT32)0x03;
+  Len  &= 0x03;
+
+  if (Len >= 2) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
     Len  -= 2;
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Add left-over byte, if any
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  if (Len != 0) {
+    Sum += *Bulk;
   }
 
-  return (UINT16)Sum;
+  //
+  // Fold 64-bit sum to 16 bits
+  //
+  while (RShiftU64 (Sum, 16) != 0) {
+    Sum = (Sum & 0xffff) + RShiftU64 (Sum, 16);
+  }
+
+  return Odd ? SwapBytes16 ((UINT16)Sum) : (UINT16)Sum;
 }
 
 /**
@@ -1744,19 +2099,23 @@ NetPseudoHeadChecksum (
   IN UINT16    Len
   )
 {
-  NET_PSEUDO_HDR  Hdr;
+  UINT32  Sum;
 
   //
-  // Zero the memory to relieve align problems
+  // Sum the 16 bit words of NET_PSEUDO_HDR directly instead of building
+  // it in memory. The reserved byte is zero, so the protocol is the high
+  // byte of its word.
   //
-  ZeroMem (&Hdr, sizeof (Hdr));
+  Sum = (Src & 0xffff) + (Src >> 16) + (Dst & 0xffff) + (Dst >> 16) + ((UINT32)Proto << 8) + HTONS (Len);
 
-  Hdr.SrcIp    = Src;
-  Hdr.DstIp    = Dst;
-  Hdr.Protocol = Proto;
-  Hdr.Len      = HTONS (Len);
+  //
+  // Fold 32-bit sum to 16 bits
+  //
+  while ((Sum >> 16) != 0) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
 
-  return NetblockChecksum ((UINT8 *)&Hdr, sizeof (Hdr));
+  return (UINT16)Sum;
 }
 
 /**
@@ -1840,7 +2199,7 @@ NetIpSecNetbufFree (
       FreePool (Nbuf->Vector->Block[0].Bulk);
     }
 
-    FreePool (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeVectorStruct (Nbuf->Vector);
+    NetbufFreeBufStruct (Nbuf);
   }
 }
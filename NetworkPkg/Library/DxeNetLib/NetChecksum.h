@@ -0,0 +1,126 @@
+/** @file
+  Internal functions summing the data of an Internet checksum.
+
+  The one's complement sum of RFC1071 is independent of the byte order, so
+  the data is summed in 32 bit words into a 64 bit accumulator, which the
+  caller folds to 16 bits. The architectures with SIMD instructions sum the
+  bulk of the data in vector registers, and all the implementations return
+  the same sum as InternalNetSumWords.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef NET_CHECKSUM_H_
+#define NET_CHECKSUM_H_
+
+//
+// InternalNetSumBlocks sums the data in blocks of this size.
+//
+#define NET_SUM_BLOCK_SIZE  64
+
+/**
+  Sum the data in 32 bit words, in C.
+
+  @param[in]   Bulk                  Pointer to the data, 4 byte aligned.
+  @param[in]   Length                Length of the data in bytes, a multiple of 4.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumWords (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  );
+
+/**
+  Sum the data in 32 bit words with the fastest implementation of the
+  processor.
+
+  @param[in]   Bulk                  Pointer to the data, 4 byte aligned.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumBlocks (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  );
+
+#if defined (MDE_CPU_X64)
+
+/**
+  Sum the data in 32 bit words with SSE2 instructions.
+
+  @param[in]   Bulk                  Pointer to the data.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumSse2 (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  );
+
+/**
+  Sum the data in 32 bit words with AVX2 instructions.
+
+  @param[in]   Bulk                  Pointer to the data.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumAvx2 (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  );
+
+/**
+  Check whether the processor supports AVX2 and the AVX state is enabled.
+
+  @retval TRUE     InternalNetSumAvx2 can be used.
+  @retval FALSE    InternalNetSumAvx2 can't be used.
+
+**/
+BOOLEAN
+EFIAPI
+InternalNetIsAvx2Enabled (
+  VOID
+  );
+
+#elif defined (MDE_CPU_AARCH64)
+
+/**
+  Sum the data in 32 bit words with Advanced SIMD instructions.
+
+  @param[in]   Bulk                  Pointer to the data.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumNeon (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  );
+
+#endif
+
+#endif
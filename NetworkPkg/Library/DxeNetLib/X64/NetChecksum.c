@@ -0,0 +1,49 @@
+/** @file
+  Sum the data of a checksum with SSE2 or, if the processor supports it and
+  the AVX state is enabled, with AVX2.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include "../NetChecksum.h"
+
+#define NET_SUM_UNKNOWN  0
+#define NET_SUM_SSE2     1
+#define NET_SUM_AVX2     2
+
+//
+// The implementation selected at the first call.
+//
+STATIC UINT8  mNetSumLevel = NET_SUM_UNKNOWN;
+
+/**
+  Sum the data in 32 bit words with the fastest implementation of the
+  processor.
+
+  @param[in]   Bulk                  Pointer to the data, 4 byte aligned.
+  @param[in]   Length                Length of the data in bytes, a multiple
+                                     of NET_SUM_BLOCK_SIZE.
+
+  @return    The sum of the 32 bit words of the data.
+
+**/
+UINT64
+EFIAPI
+InternalNetSumBlocks (
+  IN CONST VOID  *Bulk,
+  IN UINTN       Length
+  )
+{
+  if (mNetSumLevel == NET_SUM_UNKNOWN) {
+    mNetSumLevel = InternalNetIsAvx2Enabled () ? NET_SUM_AVX2 : NET_SUM_SSE2;
+  }
+
+  if (mNetSumLevel == NET_SUM_AVX2) {
+    return InternalNetSumAvx2 (Bulk, Length);
+  }
+
+  return InternalNetSumSse2 (Bulk, Length);
+}
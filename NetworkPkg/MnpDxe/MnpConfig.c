@@ -382,13 +382,42 @@ MnpRecycleTxBuf (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   )
 {
-  UINT8                        *TxBuf;
-  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
-  EFI_STATUS                   Status;
+  UINT8                                *TxBuf;
+  EFI_SIMPLE_NETWORK_PROTOCOL          *Snp;
+  EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *SnpBatch;
+  VOID                                 *TxBufs[MNP_TX_RECYCLE_BATCH];
+  UINTN                                Count;
+  UINTN                                Index;
+  EFI_STATUS                           Status;
 
   Snp = MnpDeviceData->Snp;
   ASSERT (Snp != NULL);
 
+  SnpBatch = MnpDeviceData->SnpBatch;
+  if (SnpBatch != NULL) {
+    //
+    // Collect the transmitted buffers a batch at a time, until the
+    // SNP driver returns less than a full batch.
+    //
+    do {
+      Count  = MNP_TX_RECYCLE_BATCH;
+      Status = SnpBatch->GetStatus (SnpBatch, NULL, &Count, TxBufs);
+
+      //
+      // The buffers returned are recycled even if GetStatus() fails.
+      //
+      for (Index = 0; Index < Count; Index++) {
+        MnpFreeTxBuf (MnpDeviceData, TxBufs[Index]);
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    } while (Count == MNP_TX_RECYCLE_BATCH);
+
+    return EFI_SUCCESS;
+  }
+
   do {
     TxBuf  = NULL;
     Status = Snp->GetStatus (Snp, NULL, (VOID **)&TxBuf);
@@ -435,6 +464,8 @@ MnpInitializeDeviceData (
   // Copy the MNP Protocol interfaces from the template.
   //
   CopyMem (&MnpDeviceData->VlanConfig, &mVlanConfigProtocolTemplate, sizeof (EFI_VLAN_CONFIG_PROTOCOL));
+  MnpDeviceData->Statistics.GetStatistics = MnpGetStatistics;
+  MnpDeviceData->RateWindowStart          = GetPerformanceCounter ();
 
   //
   // Open the Simple Network protocol.
@@ -457,6 +488,22 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // Batch transmit buffer recycling is optional, the SNP driver of the
+  // controller may not produce it.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiSimpleNetworkBatchProtocolGuid,
+                  (VOID **)&MnpDeviceData->SnpBatch,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->SnpBatch = NULL;
+  }
+
   //
   // Initialize the lists.
   //
@@ -512,6 +559,25 @@ MnpInitializeDeviceData (
   InitializeListHead (&MnpDeviceData->AllTxBufList);
   MnpDeviceData->TxBufCount = 0;
 
+  //
+  // Create the event to flush the transmit batch.
+  //
+  MnpDeviceData->TxBatchCount = 0;
+  if (MnpDeviceData->SnpBatch != NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    MnpFlushTxBatchNotify,
+                    MnpDeviceData,
+                    &MnpDeviceData->TxFlushEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "MnpInitializeDeviceData: CreateEvent for tx flush failed.\n"));
+
+      goto ERROR;
+    }
+  }
+
   //
   // Create the system poll timer.
   //
@@ -581,6 +647,10 @@ ERROR:
       gBS->CloseEvent (MnpDeviceData->PollTimer);
     }
 
+    if (MnpDeviceData->TxFlushEvent != NULL) {
+      gBS->CloseEvent (MnpDeviceData->TxFlushEvent);
+    }
+
     if (MnpDeviceData->RxNbufCache != NULL) {
       MnpFreeNbuf (MnpDeviceData, MnpDeviceData->RxNbufCache);
     }
@@ -641,6 +711,11 @@ MnpDestroyDeviceData (
   gBS->CloseEvent (MnpDeviceData->MediaDetectTimer);
   gBS->CloseEvent (MnpDeviceData->PollTimer);
 
+  ASSERT (MnpDeviceData->TxBatchCount == 0);
+  if (MnpDeviceData->TxFlushEvent != NULL) {
+    gBS->CloseEvent (MnpDeviceData->TxFlushEvent);
+  }
+
   //
   // Free the Tx buffer pool.
   //
@@ -1151,6 +1226,11 @@ MnpStopSnp (
   Snp = MnpDeviceData->Snp;
   ASSERT (Snp != NULL);
 
+  //
+  // Transmit the packets still waiting in the transmit batch.
+  //
+  MnpFlushTxBatch (MnpDeviceData);
+
   //
   // Recycle all the transmit buffer from SNP.
   //
@@ -1263,9 +1343,10 @@ MnpStart (
     // The EnableSystemPoll differs with the current state, disable or enable
     // the system poll.
     //
-    TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    TimerOpType                 = EnableSystemPoll ? TimerPeriodic : TimerCancel;
+    MnpDeviceData->PollInterval = MNP_SYS_POLL_INTERVAL;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
@@ -1428,6 +1509,12 @@ MnpConfigureInstance (
   MnpDeviceData  = MnpServiceData->MnpDeviceData;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  //
+  // Complete the transmit tokens of the instance before its configuration
+  // changes.
+  //
+  MnpFlushTxBatch (MnpDeviceData);
+
   IsConfigUpdate = (BOOLEAN)((Instance->Configured) && (ConfigData != NULL));
 
   OldConfigData = &Instance->ConfigData;
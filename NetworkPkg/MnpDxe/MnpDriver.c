@@ -176,6 +176,21 @@ MnpDriverBindingStart (
     return Status;
   }
 
+  //
+  // Install the MNP Statistics Protocol
+  //
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &ControllerHandle,
+                  &gEdkiiMnpStatisticsProtocolGuid,
+                  &MnpDeviceData->Statistics,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDestroyDeviceData (MnpDeviceData, This->DriverBindingHandle);
+    FreePool (MnpDeviceData);
+    return Status;
+  }
+
   //
   // Check whether NIC driver has already produced VlanConfig protocol
   //
@@ -272,6 +287,13 @@ Exit:
              );
     }
 
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiMnpStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
@@ -378,6 +400,13 @@ MnpDriverBindingStop (
              );
     }
 
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiMnpStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
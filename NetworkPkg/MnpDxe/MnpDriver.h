@@ -13,8 +13,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/ManagedNetwork.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkBatch.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Protocol/MnpStatistics.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -27,64 +29,105 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
 
 #include "ComponentName.h"
 
 #define MNP_DEVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'D')
 
+#define MNP_TX_BATCH_SIZE  32                  // Packets handed to the batch Transmit() at most
+
 //
 // Global Variables
 //
 extern  EFI_DRIVER_BINDING_PROTOCOL  gMnpDriverBinding;
 
+//
+// A packet waiting in the transmit batch. The addresses and the protocol
+// type are copied, the token only has to stay valid until it's signaled.
+//
+typedef struct {
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN    *Token;
+  UINT16                                  ProtocolType;
+  EFI_MAC_ADDRESS                         SrcAddr;
+  EFI_MAC_ADDRESS                         DestAddr;
+} MNP_TX_BATCH_ENTRY;
+
 typedef struct {
-  UINT32                         Signature;
+  UINT32                           Signature;
 
-  EFI_HANDLE                     ControllerHandle;
-  EFI_HANDLE                     ImageHandle;
+  EFI_HANDLE                       ControllerHandle;
+  EFI_HANDLE                       ImageHandle;
 
-  EFI_VLAN_CONFIG_PROTOCOL       VlanConfig;
-  UINTN                          NumberOfVlan;
-  CHAR16                         *MacString;
-  EFI_SIMPLE_NETWORK_PROTOCOL    *Snp;
+  EFI_VLAN_CONFIG_PROTOCOL               VlanConfig;
+  UINTN                                  NumberOfVlan;
+  CHAR16                                 *MacString;
+  EFI_SIMPLE_NETWORK_PROTOCOL            *Snp;
+  EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL    *SnpBatch;     ///< NULL if the SNP driver doesn't produce it.
 
   //
   // List of MNP_SERVICE_DATA
   //
-  LIST_ENTRY                     ServiceList;
+  LIST_ENTRY                       ServiceList;
   //
   // Number of configured MNP Service Binding child
   //
-  UINTN                          ConfiguredChildrenNumber;
+  UINTN                            ConfiguredChildrenNumber;
 
-  LIST_ENTRY                     GroupAddressList;
-  UINT32                         GroupAddressCount;
+  LIST_ENTRY                       GroupAddressList;
+  UINT32                           GroupAddressCount;
 
-  LIST_ENTRY                     FreeTxBufList;
-  LIST_ENTRY                     AllTxBufList;
-  UINT32                         TxBufCount;
+  LIST_ENTRY                       FreeTxBufList;
+  LIST_ENTRY                       AllTxBufList;
+  UINT32                           TxBufCount;
 
-  NET_BUF_QUEUE                  FreeNbufQue;
-  INTN                           NbufCnt;
-
-  EFI_EVENT                      PollTimer;
-  BOOLEAN                        EnableSystemPoll;
+  //
+  // Packets queued by MnpSyncSendPacket() when the SNP driver produces
+  // SnpBatch. TxFlushEvent is signaled for the first one, and transmits the
+  // batch once the TPL drops below TPL_CALLBACK, at the end of the burst.
+  //
+  EFI_EVENT                        TxFlushEvent;
+  UINTN                            TxBatchCount;
+  EDKII_SIMPLE_NETWORK_TX_PACKET   TxBatch[MNP_TX_BATCH_SIZE];
+  MNP_TX_BATCH_ENTRY               TxBatchEntry[MNP_TX_BATCH_SIZE];
+
+  NET_BUF_QUEUE                    FreeNbufQue;
+  INTN                             NbufCnt;
+
+  EFI_EVENT                        PollTimer;
+  BOOLEAN                          EnableSystemPoll;
+  UINT64                           PollInterval;
+  BOOLEAN                          WaitForPacketSupported;
+  //
+  // The last receive batch used up its budget, so packets may be left in
+  // the receive ring without WaitForPacket being signaled again.
+  //
+  BOOLEAN                          RxBudgetExhausted;
 
-  EFI_EVENT                      TimeoutCheckTimer;
-  EFI_EVENT                      MediaDetectTimer;
+  EFI_EVENT                        TimeoutCheckTimer;
+  EFI_EVENT                        MediaDetectTimer;
 
-  UINT32                         UnicastCount;
-  UINT32                         BroadcastCount;
-  UINT32                         MulticastCount;
-  UINT32                         PromiscuousCount;
+  UINT32                           UnicastCount;
+  UINT32                           BroadcastCount;
+  UINT32                           MulticastCount;
+  UINT32                           PromiscuousCount;
 
   //
   // The size of the data buffer in the MNP_PACKET_BUFFER used to
   // store a packet.
   //
-  UINT32                         BufferLength;
-  UINT32                         PaddingSize;
-  NET_BUF                        *RxNbufCache;
+  UINT32                           BufferLength;
+  UINT32                           PaddingSize;
+  NET_BUF                          *RxNbufCache;
+
+  //
+  // Receive statistics, and the packets and the performance counter at
+  // the start of the current window to measure the receive rate.
+  //
+  EDKII_MNP_STATISTICS_PROTOCOL    Statistics;
+  EDKII_MNP_STATISTICS             RxStatistics;
+  UINT64                           RateWindowPackets;
+  UINT64                           RateWindowStart;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -95,6 +138,14 @@ typedef struct {
   MNP_DEVICE_DATA_SIGNATURE \
   )
 
+#define MNP_DEVICE_DATA_FROM_STATISTICS(a) \
+  CR ( \
+  (a), \
+  MNP_DEVICE_DATA, \
+  Statistics, \
+  MNP_DEVICE_DATA_SIGNATURE \
+  )
+
 #define MNP_SERVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'S')
 
 typedef struct {
@@ -13,7 +13,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define NET_ETHER_FCS_SIZE  4
 
-#define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds, the interval when idle
+#define MNP_SYS_POLL_INTERVAL_MIN    (1 * TICKS_PER_MS)     // 1 millisecond, the interval under load
+#define MNP_RX_BATCH_SIZE            64                     // Packets received in one poll at most
+#define MNP_RX_RATE_WINDOW           1000000000ULL          // 1 second, in nanoseconds
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -22,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MNP_MAX_NET_BUFFER_NUM       65536
 #define MNP_TX_BUFFER_INCREASEMENT   32     // Same as the recycling Q length for xmit_done in UNDI command.
 #define MNP_MAX_TX_BUFFER_NUM        65536
+#define MNP_TX_RECYCLE_BATCH         16     // Transmit buffers recycled in one batch GetStatus() call.
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
 
@@ -383,6 +387,32 @@ MnpSyncSendPacket (
   IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
   );
 
+/**
+  Transmit the packets queued in the transmit batch and signal their tokens.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+
+**/
+VOID
+MnpFlushTxBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  );
+
+/**
+  Transmit the packets queued in the transmit batch, the notify function of
+  TxFlushEvent.
+
+  @param[in]  Event        The event this notify function registered to.
+  @param[in]  Context      Pointer to the context data registered to the event.
+
+**/
+VOID
+EFIAPI
+MnpFlushTxBatchNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Try to deliver the received packet to the instance.
 
@@ -430,6 +460,55 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets pending in the SNP receive ring until
+  it is empty or Budget packets are received.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received, optional.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of MnpReceivePacket() when no packet
+                                is received.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received OPTIONAL
+  );
+
+/**
+  Update the receive rate when MNP_RX_RATE_WINDOW has elapsed since the
+  current measurement window started.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+**/
+VOID
+MnpUpdateRxRate (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  );
+
+/**
+  Get the receive statistics of the network device.
+
+  @param[in]   This                Pointer to the EDKII_MNP_STATISTICS_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  OUT EDKII_MNP_STATISTICS           *Statistics
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
@@ -475,6 +554,19 @@ MnpAllocTxBuf (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Try to reclaim the TX buffer into the buffer pool.
+
+  @param[in, out]  MnpDeviceData         Pointer to the mnp device context data.
+  @param[in, out]  TxBuf                 Pointer to the TX buffer to free.
+
+**/
+VOID
+MnpFreeTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN OUT UINT8            *TxBuf
+  );
+
 /**
   Try to recycle all the transmitted buffer address from SNP.
 
@@ -519,7 +611,9 @@ MnpCheckMediaStatus (
 
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
-  protocols/applications or the system poll timer notify mechanism.
+  protocols/applications or the system poll timer notify mechanism. The timer
+  runs at MNP_SYS_POLL_INTERVAL_MIN while packets arrive and backs off to
+  MNP_SYS_POLL_INTERVAL when the device is idle.
 
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
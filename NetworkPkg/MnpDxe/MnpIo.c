@@ -190,7 +190,9 @@ MnpBuildTxPacket (
 
   This function places the packet buffer to SNP driver's tansmit queue. The packet
   can be considered successfully sent out once SNP accept the packet, while the
-  packet buffer recycle is deferred for better performance.
+  packet buffer recycle is deferred for better performance. If the SNP driver
+  transmits in batches, the packet is queued in the transmit batch instead and
+  the token is signaled when the batch is flushed.
 
   @param[in]       MnpServiceData      Pointer to the mnp service context data.
   @param[in]       Packet              Pointer to the packet buffer.
@@ -216,6 +218,8 @@ MnpSyncSendPacket (
   UINT32                             HeaderSize;
   MNP_DEVICE_DATA                    *MnpDeviceData;
   UINT16                             ProtocolType;
+  EDKII_SIMPLE_NETWORK_TX_PACKET     *TxPacket;
+  MNP_TX_BATCH_ENTRY                 *BatchEntry;
 
   MnpDeviceData = MnpServiceData->MnpDeviceData;
   Snp           = MnpDeviceData->Snp;
@@ -245,6 +249,45 @@ MnpSyncSendPacket (
     ProtocolType = TxData->ProtocolType;
   }
 
+  if (MnpDeviceData->SnpBatch != NULL) {
+    //
+    // Queue the packet, the whole burst is transmitted with one call.
+    //
+    ASSERT (MnpDeviceData->TxBatchCount < MNP_TX_BATCH_SIZE);
+    TxPacket   = &MnpDeviceData->TxBatch[MnpDeviceData->TxBatchCount];
+    BatchEntry = &MnpDeviceData->TxBatchEntry[MnpDeviceData->TxBatchCount];
+
+    BatchEntry->Token        = Token;
+    BatchEntry->ProtocolType = ProtocolType;
+    TxPacket->HeaderSize     = HeaderSize;
+    TxPacket->BufferSize     = Length;
+    TxPacket->Buffer         = Packet;
+    TxPacket->SrcAddr        = NULL;
+    TxPacket->DestAddr       = NULL;
+    TxPacket->Protocol       = &BatchEntry->ProtocolType;
+
+    if (TxData->SourceAddress != NULL) {
+      CopyMem (&BatchEntry->SrcAddr, TxData->SourceAddress, sizeof (EFI_MAC_ADDRESS));
+      TxPacket->SrcAddr = &BatchEntry->SrcAddr;
+    }
+
+    if (TxData->DestinationAddress != NULL) {
+      CopyMem (&BatchEntry->DestAddr, TxData->DestinationAddress, sizeof (EFI_MAC_ADDRESS));
+      TxPacket->DestAddr = &BatchEntry->DestAddr;
+    }
+
+    Token->Status = EFI_NOT_READY;
+    MnpDeviceData->TxBatchCount++;
+
+    if (MnpDeviceData->TxBatchCount == MNP_TX_BATCH_SIZE) {
+      MnpFlushTxBatch (MnpDeviceData);
+    } else if (MnpDeviceData->TxBatchCount == 1) {
+      gBS->SignalEvent (MnpDeviceData->TxFlushEvent);
+    }
+
+    return EFI_SUCCESS;
+  }
+
   //
   // Transmit the packet through SNP.
   //
@@ -291,6 +334,123 @@ SIGNAL_TOKEN:
   return EFI_SUCCESS;
 }
 
+/**
+  Transmit the packets queued in the transmit batch and signal their tokens.
+
+  @param[in, out]  MnpDeviceData       Pointer to the mnp device context data.
+
+**/
+VOID
+MnpFlushTxBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_STATUS                            Status;
+  EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL   *SnpBatch;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Tokens[MNP_TX_BATCH_SIZE];
+  EFI_TPL                               OldTpl;
+  UINTN                                 Count;
+  UINTN                                 Index;
+  UINTN                                 Placed;
+  BOOLEAN                               Retried;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Count = MnpDeviceData->TxBatchCount;
+  if (Count == 0) {
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  SnpBatch = MnpDeviceData->SnpBatch;
+  ASSERT (SnpBatch != NULL);
+
+  Index   = 0;
+  Retried = FALSE;
+  while (Index < Count) {
+    Placed = Count - Index;
+    Status = SnpBatch->Transmit (SnpBatch, &Placed, &MnpDeviceData->TxBatch[Index]);
+    if (!EFI_ERROR (Status)) {
+      Placed = Count - Index;
+    }
+
+    if (Placed != 0) {
+      Retried = FALSE;
+    }
+
+    for ( ; Placed != 0; Placed--, Index++) {
+      MnpDeviceData->TxBatchEntry[Index].Token->Status = EFI_SUCCESS;
+    }
+
+    if (!EFI_ERROR (Status)) {
+      break;
+    }
+
+    if ((Status == EFI_NOT_READY) && !Retried) {
+      //
+      // The transmit queue is full, recycle the transmitted buffers and
+      // try once more.
+      //
+      Retried = TRUE;
+      if (!EFI_ERROR (MnpRecycleTxBuf (MnpDeviceData))) {
+        continue;
+      }
+    }
+
+    //
+    // The packet can't be transmitted, fail its token and go on with the
+    // packets after it.
+    //
+    MnpDeviceData->TxBatchEntry[Index].Token->Status = EFI_DEVICE_ERROR;
+    MnpFreeTxBuf (MnpDeviceData, MnpDeviceData->TxBatch[Index].Buffer);
+    Index++;
+    Retried = FALSE;
+  }
+
+  //
+  // Signaling the tokens may queue new packets, empty the batch first.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    Tokens[Index] = MnpDeviceData->TxBatchEntry[Index].Token;
+  }
+
+  MnpDeviceData->TxBatchCount = 0;
+
+  for (Index = 0; Index < Count; Index++) {
+    gBS->SignalEvent (Tokens[Index]->Event);
+  }
+
+  //
+  // Dispatch the DPC queued by the NotifyFunction of the tokens' events.
+  //
+  DispatchDpc ();
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Transmit the packets queued in the transmit batch, the notify function of
+  TxFlushEvent.
+
+  @param[in]  Event        The event this notify function registered to.
+  @param[in]  Context      Pointer to the context data registered to the event.
+
+**/
+VOID
+EFIAPI
+MnpFlushTxBatchNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  MNP_DEVICE_DATA  *MnpDeviceData;
+
+  MnpDeviceData = (MNP_DEVICE_DATA *)Context;
+  NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
+
+  MnpFlushTxBatch (MnpDeviceData);
+}
+
 /**
   Try to deliver the received packet to the instance.
 
@@ -481,6 +641,7 @@ MnpQueueRcvdPacket (
   //
   if (Instance->RcvdPacketQueueSize == MNP_MAX_RCVD_PACKET_QUE_SIZE) {
     DEBUG ((DEBUG_WARN, "MnpQueueRcvdPacket: Drop one packet bcz queue size limit reached.\n"));
+    Instance->MnpServiceData->MnpDeviceData->RxStatistics.RxDropped++;
 
     //
     // Get the oldest packet.
@@ -880,13 +1041,11 @@ MnpReceivePacket (
   //
   Status = Snp->Receive (Snp, &HeaderSize, &BufLen, BufPtr, NULL, NULL, NULL);
   if (EFI_ERROR (Status)) {
-    DEBUG_CODE_BEGIN ();
     if (Status != EFI_NOT_READY) {
       DEBUG ((DEBUG_WARN, "MnpReceivePacket: Snp->Receive() = %r.\n", Status));
+      MnpDeviceData->RxStatistics.RxDropped++;
     }
 
-    DEBUG_CODE_END ();
-
     return Status;
   }
 
@@ -900,9 +1059,13 @@ MnpReceivePacket (
        HeaderSize,
        BufLen)
       );
+    MnpDeviceData->RxStatistics.RxDropped++;
     return EFI_DEVICE_ERROR;
   }
 
+  MnpDeviceData->RxStatistics.RxPackets++;
+  MnpDeviceData->RateWindowPackets++;
+
   Trimmed = 0;
   if (Nbuf->TotalSize != BufLen) {
     //
@@ -927,6 +1090,7 @@ MnpReceivePacket (
     //
     // VLAN is not set for this tagged frame, ignore this packet
     //
+    MnpDeviceData->RxStatistics.RxNoReceiver++;
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -962,6 +1126,7 @@ MnpReceivePacket (
     //
     // No receiver for this packet.
     //
+    MnpDeviceData->RxStatistics.RxNoReceiver++;
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -985,6 +1150,126 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets pending in the SNP receive ring until
+  it is empty or Budget packets are received.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received, optional.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of MnpReceivePacket() when no packet
+                                is received.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Count;
+
+  Status = EFI_NOT_READY;
+
+  for (Count = 0; Count < Budget; Count++) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (Count > MnpDeviceData->RxStatistics.RxBatchMax) {
+    MnpDeviceData->RxStatistics.RxBatchMax = Count;
+  }
+
+  MnpDeviceData->RxBudgetExhausted = (BOOLEAN)(Count == Budget);
+  MnpUpdateRxRate (MnpDeviceData);
+
+  if (Received != NULL) {
+    *Received = Count;
+  }
+
+  return (Count > 0) ? EFI_SUCCESS : Status;
+}
+
+/**
+  Get the time elapsed since a value of the performance counter.
+
+  @param[in]  StartTime           A value returned by GetPerformanceCounter().
+
+  @return The elapsed time in nanoseconds.
+
+**/
+STATIC
+UINT64
+MnpGetElapsedTime (
+  IN UINT64  StartTime
+  )
+{
+  UINT64  Now;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  Now = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+
+  //
+  // The counter may count down, and may have wrapped around once.
+  //
+  if (CounterEnd >= CounterStart) {
+    if (Now >= StartTime) {
+      Ticks = Now - StartTime;
+    } else {
+      Ticks = (CounterEnd - StartTime) + (Now - CounterStart);
+    }
+  } else {
+    if (StartTime >= Now) {
+      Ticks = StartTime - Now;
+    } else {
+      Ticks = (StartTime - CounterEnd) + (CounterStart - Now);
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Update the receive rate when MNP_RX_RATE_WINDOW has elapsed since the
+  current measurement window started.
+
+  The window is measured with the performance counter, so that the rate
+  doesn't depend on how often the poll timer actually fires, and counts
+  the packets received by Poll() as well.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+**/
+VOID
+MnpUpdateRxRate (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  UINT64  Elapsed;
+
+  Elapsed = MnpGetElapsedTime (MnpDeviceData->RateWindowStart);
+  if (Elapsed < MNP_RX_RATE_WINDOW) {
+    return;
+  }
+
+  MnpDeviceData->RxStatistics.RxPacketsPerSecond = (UINT32)DivU64x64Remainder (
+                                                             MultU64x32 (MnpDeviceData->RateWindowPackets, 1000000000),
+                                                             Elapsed,
+                                                             NULL
+                                                             );
+  MnpDeviceData->RateWindowPackets = 0;
+  MnpDeviceData->RateWindowStart   = GetPerformanceCounter ();
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1042,6 +1327,7 @@ MnpCheckPacketTimeout (
           // Drop the timeout packet.
           //
           DEBUG ((DEBUG_WARN, "MnpCheckPacketTimeout: Received packet timeout.\n"));
+          MnpDeviceData->RxStatistics.RxDropped++;
           MnpRecycleRxData (NULL, RxDataWrap);
           Instance->RcvdPacketQueueSize--;
         }
@@ -1098,18 +1384,101 @@ MnpSystemPoll (
   IN VOID       *Context
   )
 {
-  MNP_DEVICE_DATA  *MnpDeviceData;
+  MNP_DEVICE_DATA              *MnpDeviceData;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  BOOLEAN                      PacketPending;
+  UINT32                       Received;
+  UINT64                       Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  Snp = MnpDeviceData->Snp;
+
+  //
+  // Transmit the packets still waiting in the transmit batch.
+  //
+  MnpFlushTxBatch (MnpDeviceData);
+
+  //
+  // Check WaitForPacket first. Once the SNP driver has shown that it
+  // signals the event, Receive() is skipped while it reports nothing.
+  // The event only reports new packets though: if the last batch used up
+  // its budget, the rest of the ring is received without waiting for it.
+  //
+  PacketPending = FALSE;
+  if (Snp->WaitForPacket != NULL) {
+    PacketPending = (BOOLEAN)(gBS->CheckEvent (Snp->WaitForPacket) == EFI_SUCCESS);
+  }
+
   //
-  // Try to receive packets from Snp.
+  // Try to receive packets from Snp, drain the receive ring in a batch.
   //
-  MnpReceivePacket (MnpDeviceData);
+  Received = 0;
+  if (PacketPending || MnpDeviceData->RxBudgetExhausted || !MnpDeviceData->WaitForPacketSupported) {
+    MnpReceivePackets (MnpDeviceData, MNP_RX_BATCH_SIZE, &Received);
+
+    if (PacketPending && (Received > 0)) {
+      MnpDeviceData->WaitForPacketSupported = TRUE;
+    }
+  } else {
+    MnpUpdateRxRate (MnpDeviceData);
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  //
+  // Poll fast while packets arrive, and back off exponentially to
+  // MNP_SYS_POLL_INTERVAL when the device is idle.
+  //
+  if (Received > 0) {
+    Interval = MNP_SYS_POLL_INTERVAL_MIN;
+  } else {
+    Interval = MIN (MnpDeviceData->PollInterval * 2, MNP_SYS_POLL_INTERVAL);
+  }
+
+  if ((Interval != MnpDeviceData->PollInterval) && MnpDeviceData->EnableSystemPoll) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
+}
+
+/**
+  Get the receive statistics of the network device.
+
+  @param[in]   This                Pointer to the EDKII_MNP_STATISTICS_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  OUT EDKII_MNP_STATISTICS           *Statistics
+  )
+{
+  MNP_DEVICE_DATA  *MnpDeviceData;
+  EFI_TPL          OldTpl;
+
+  if ((This == NULL) || (Statistics == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MnpDeviceData = MNP_DEVICE_DATA_FROM_STATISTICS (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  CopyMem (Statistics, &MnpDeviceData->RxStatistics, sizeof (EDKII_MNP_STATISTICS));
+  Statistics->PollInterval = MnpDeviceData->EnableSystemPoll ? MnpDeviceData->PollInterval : 0;
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
 }
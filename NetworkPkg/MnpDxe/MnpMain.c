@@ -702,6 +702,12 @@ MnpCancel (
     goto ON_EXIT;
   }
 
+  //
+  // Transmit tokens are not queued by MNP, complete the ones waiting in
+  // the transmit batch.
+  //
+  MnpFlushTxBatch (Instance->MnpServiceData->MnpDeviceData);
+
   //
   // Iterate the RxTokenMap to cancel the specified Token.
   //
@@ -771,9 +777,14 @@ MnpPoll (
   }
 
   //
-  // Try to receive packets.
+  // Transmit the packets waiting in the transmit batch.
+  //
+  MnpFlushTxBatch (Instance->MnpServiceData->MnpDeviceData);
+
+  //
+  // Try to receive packets, drain the receive ring in a batch.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePackets (Instance->MnpServiceData->MnpDeviceData, MNP_RX_BATCH_SIZE, NULL);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -264,6 +264,18 @@ Mtftp4RrqHandleData (
   // expected one. If we are passive (Slave), save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
+    //
+    // With a window of more than one block, all the blocks following a
+    // lost one arrive out of order. ACK the gap only once, the server
+    // restarts the window from the ACKed block (RFC 7440 section 4). If
+    // that ACK is lost, the retransmission timer sends it again.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -280,6 +292,7 @@ Mtftp4RrqHandleData (
   // Record the total received and saved block number.
   //
   Instance->TotalBlock++;
+  Instance->GapAcked = FALSE;
 
   //
   // Reset the passive client's timer whenever it received a
@@ -241,6 +241,18 @@ Mtftp6RrqHandleData (
     NetbufFree (*UdpPacket);
     *UdpPacket = NULL;
 
+    //
+    // With a window of more than one block, all the blocks following a
+    // lost one arrive out of order. ACK the gap only once, the server
+    // restarts the window from the ACKed block (RFC 7440 section 4). If
+    // that ACK is lost, the retransmission timer sends it again.
+    //
+    if ((Instance->WindowSize > 1) && Instance->GapAcked) {
+      return EFI_SUCCESS;
+    }
+
+    Instance->GapAcked = TRUE;
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -257,6 +269,7 @@ Mtftp6RrqHandleData (
   // Record the total received and saved block number.
   //
   Instance->TotalBlock++;
+  Instance->GapAcked = FALSE;
 
   //
   // Reset the passive client's timer whenever it received a valid data packet.
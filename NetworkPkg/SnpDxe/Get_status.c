@@ -258,3 +258,86 @@ ON_EXIT:
 
   return Status;
 }
+
+/**
+  Reads the current interrupt status and several recycled transmit buffers
+  from a network interface.
+
+  One UNDI GET_STATUS command returns up to MAX_XMIT_BUFFERS recycled
+  buffers, they are all handed to the caller as far as TxBuf has room.
+
+  @param This            A pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param InterruptStatus A pointer to the bit mask of the currently active
+                         interrupts. If this is NULL, the interrupt status will
+                         not be read from the device.
+  @param TxBufCount      On input, the number of entries in TxBuf. On output,
+                         the number of recycled transmit buffers returned.
+  @param TxBuf           The recycled transmit buffer addresses.
+
+  @retval EFI_SUCCESS           The status of the network interface was retrieved.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network
+                                interface.
+
+**/
+EFI_STATUS
+EFIAPI
+SnpUndi32GetStatusBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  OUT    UINT32                               *InterruptStatus  OPTIONAL,
+  IN OUT UINTN                                *TxBufCount,
+  OUT    VOID                                 **TxBuf
+  )
+{
+  SNP_DRIVER  *Snp;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINTN       Count;
+
+  if ((This == NULL) || (TxBufCount == NULL) || (*TxBufCount == 0) || (TxBuf == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Snp = SNP_DRIVER_FROM_BATCH_THIS (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Count = 0;
+  switch (Snp->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+      break;
+
+    case EfiSimpleNetworkStopped:
+      Status = EFI_NOT_STARTED;
+      goto ON_EXIT;
+
+    default:
+      Status = EFI_DEVICE_ERROR;
+      goto ON_EXIT;
+  }
+
+  //
+  // Only ask UNDI for more buffers if the ones already collected
+  // don't fill the caller's array.
+  //
+  Status = PxeGetStatus (Snp, InterruptStatus, (BOOLEAN)(Snp->RecycledTxBufCount < *TxBufCount));
+  if (EFI_ERROR (Status)) {
+    //
+    // Keep the collected buffers for the next call rather than hand them
+    // out with an error.
+    //
+    goto ON_EXIT;
+  }
+
+  while ((Count < *TxBufCount) && (Snp->RecycledTxBufCount != 0)) {
+    Snp->RecycledTxBufCount--;
+    TxBuf[Count++] = (VOID *)(UINTN)Snp->RecycledTxBuf[Snp->RecycledTxBufCount];
+  }
+
+ON_EXIT:
+  *TxBufCount = Count;
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
@@ -402,6 +402,9 @@ SimpleNetworkDriverStart (
 
   Snp->Snp.Mode = &Snp->Mode;
 
+  Snp->SnpBatch.Transmit  = SnpUndi32TransmitBatch;
+  Snp->SnpBatch.GetStatus = SnpUndi32GetStatusBatch;
+
   Snp->TxRxBufferSize = 0;
   Snp->TxRxBuffer     = NULL;
 
@@ -670,11 +673,13 @@ SimpleNetworkDriverStart (
   //
   //  add SNP to the undi handle
   //
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiSimpleNetworkProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &(Snp->Snp)
+                  &(Snp->Snp),
+                  &gEdkiiSimpleNetworkBatchProtocolGuid,
+                  &(Snp->SnpBatch),
+                  NULL
                   );
 
   if (!EFI_ERROR (Status)) {
@@ -773,10 +778,13 @@ SimpleNetworkDriverStop (
 
   Snp = EFI_SIMPLE_NETWORK_DEV_FROM_THIS (SnpProtocol);
 
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiSimpleNetworkProtocolGuid,
-                  &Snp->Snp
+                  &Snp->Snp,
+                  &gEdkiiSimpleNetworkBatchProtocolGuid,
+                  &Snp->SnpBatch,
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
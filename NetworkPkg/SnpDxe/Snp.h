@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkBatch.h>
 #include <Protocol/PciIo.h>
 #include <Protocol/NetworkInterfaceIdentifier.h>
 #include <Protocol/DevicePath.h>
@@ -56,8 +57,9 @@ typedef struct {
   UINT32                         Signature;
   EFI_LOCK                       Lock;
 
-  EFI_SIMPLE_NETWORK_PROTOCOL    Snp;
-  EFI_SIMPLE_NETWORK_MODE        Mode;
+  EFI_SIMPLE_NETWORK_PROTOCOL            Snp;
+  EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL    SnpBatch;
+  EFI_SIMPLE_NETWORK_MODE                Mode;
 
   EFI_HANDLE                     DeviceHandle;
   EFI_DEVICE_PATH_PROTOCOL       *DevicePath;
@@ -151,6 +153,7 @@ typedef struct {
 } SNP_DRIVER;
 
 #define EFI_SIMPLE_NETWORK_DEV_FROM_THIS(a)  CR (a, SNP_DRIVER, Snp, SNP_DRIVER_SIGNATURE)
+#define SNP_DRIVER_FROM_BATCH_THIS(a)        CR (a, SNP_DRIVER, SnpBatch, SNP_DRIVER_SIGNATURE)
 
 //
 // Global Variables
@@ -887,6 +890,37 @@ SnpUndi32GetStatus (
   OUT VOID                        **TxBuf           OPTIONAL
   );
 
+/**
+  Reads the current interrupt status and several recycled transmit buffers
+  from a network interface.
+
+  One UNDI GET_STATUS command returns up to MAX_XMIT_BUFFERS recycled
+  buffers, they are all handed to the caller as far as TxBuf has room.
+
+  @param This            A pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param InterruptStatus A pointer to the bit mask of the currently active
+                         interrupts. If this is NULL, the interrupt status will
+                         not be read from the device.
+  @param TxBufCount      On input, the number of entries in TxBuf. On output,
+                         the number of recycled transmit buffers returned.
+  @param TxBuf           The recycled transmit buffer addresses.
+
+  @retval EFI_SUCCESS           The status of the network interface was retrieved.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network
+                                interface.
+
+**/
+EFI_STATUS
+EFIAPI
+SnpUndi32GetStatusBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  OUT    UINT32                               *InterruptStatus  OPTIONAL,
+  IN OUT UINTN                                *TxBufCount,
+  OUT    VOID                                 **TxBuf
+  );
+
 /**
   Places a packet in the transmit queue of a network interface.
 
@@ -953,6 +987,35 @@ SnpUndi32Transmit (
   IN UINT16                       *Protocol  OPTIONAL
   );
 
+/**
+  Places several packets in the transmit queue of a network interface.
+
+  The packets are placed in order, with the same rules as SnpUndi32Transmit().
+  If a packet can't be placed, the packets after it are not placed either.
+
+  @param This        A pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param PacketCount On input, the number of packets in Packets. On output, the
+                     number of packets placed on the transmit queue.
+  @param Packets     The packets to transmit.
+
+  @retval EFI_SUCCESS           All the packets were placed on the transmit queue.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_NOT_READY         The network interface is too busy to accept more
+                                packets, *PacketCount packets were placed.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported
+                                value.
+  @retval Others                The error returned by SnpUndi32Transmit() for the
+                                packet at index *PacketCount.
+
+**/
+EFI_STATUS
+EFIAPI
+SnpUndi32TransmitBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  IN OUT UINTN                                *PacketCount,
+  IN     EDKII_SIMPLE_NETWORK_TX_PACKET       *Packets
+  );
+
 /**
   Receives a packet from a network interface.
 
@@ -211,6 +211,74 @@ PxeTransmit (
   return Status;
 }
 
+/**
+  Validate one packet, fill in its media header and hand it to UNDI.
+
+  The caller has raised the TPL and checked that the network interface is
+  initialized.
+
+  @param  Snp              Pointer to SNP driver structure.
+  @param  HeaderSize       The size of the media header to fill in, or 0.
+  @param  BufferSize       The size of the entire packet.
+  @param  Buffer           The packet to transmit.
+  @param  SrcAddr          The source HW MAC address, optional.
+  @param  DestAddr         The destination HW MAC address.
+  @param  Protocol         The type of header to build.
+
+  @retval EFI_SUCCESS      The packet was placed on the transmit queue.
+  @retval Other            The same errors as SnpUndi32Transmit().
+
+**/
+STATIC
+EFI_STATUS
+SnpTransmitPacket (
+  IN SNP_DRIVER       *Snp,
+  IN UINTN            HeaderSize,
+  IN UINTN            BufferSize,
+  IN VOID             *Buffer,
+  IN EFI_MAC_ADDRESS  *SrcAddr   OPTIONAL,
+  IN EFI_MAC_ADDRESS  *DestAddr  OPTIONAL,
+  IN UINT16           *Protocol  OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Buffer == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (BufferSize < Snp->Mode.MediaHeaderSize) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  //
+  // if the HeaderSize is non-zero, we need to fill up the header and for that
+  // we need the destination address and the protocol
+  //
+  if (HeaderSize != 0) {
+    if ((HeaderSize != Snp->Mode.MediaHeaderSize) || (DestAddr == 0) || (Protocol == 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = PxeFillHeader (
+               Snp,
+               Buffer,
+               HeaderSize,
+               (UINT8 *)Buffer + HeaderSize,
+               BufferSize - HeaderSize,
+               DestAddr,
+               SrcAddr,
+               Protocol
+               );
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return PxeTransmit (Snp, Buffer, BufferSize);
+}
+
 /**
   Places a packet in the transmit queue of a network interface.
 
@@ -306,45 +374,90 @@ SnpUndi32Transmit (
       goto ON_EXIT;
   }
 
-  if (Buffer == NULL) {
-    Status = EFI_INVALID_PARAMETER;
-    goto ON_EXIT;
-  }
+  Status = SnpTransmitPacket (Snp, HeaderSize, BufferSize, Buffer, SrcAddr, DestAddr, Protocol);
 
-  if (BufferSize < Snp->Mode.MediaHeaderSize) {
-    Status = EFI_BUFFER_TOO_SMALL;
-    goto ON_EXIT;
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Places several packets in the transmit queue of a network interface.
+
+  The packets are placed in order, with the same rules as SnpUndi32Transmit().
+  If a packet can't be placed, the packets after it are not placed either.
+  UNDI has no multi-packet transmit command, but the state check and the
+  TPL raise are done once for the whole batch.
+
+  @param This        A pointer to the EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL instance.
+  @param PacketCount On input, the number of packets in Packets. On output, the
+                     number of packets placed on the transmit queue.
+  @param Packets     The packets to transmit.
+
+  @retval EFI_SUCCESS           All the packets were placed on the transmit queue.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_NOT_READY         The network interface is too busy to accept more
+                                packets, *PacketCount packets were placed.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported
+                                value.
+  @retval Others                The error returned by SnpUndi32Transmit() for the
+                                packet at index *PacketCount.
+
+**/
+EFI_STATUS
+EFIAPI
+SnpUndi32TransmitBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  IN OUT UINTN                                *PacketCount,
+  IN     EDKII_SIMPLE_NETWORK_TX_PACKET       *Packets
+  )
+{
+  SNP_DRIVER  *Snp;
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  UINTN       Index;
+
+  if ((This == NULL) || (PacketCount == NULL) || (*PacketCount == 0) || (Packets == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // if the HeaderSize is non-zero, we need to fill up the header and for that
-  // we need the destination address and the protocol
-  //
-  if (HeaderSize != 0) {
-    if ((HeaderSize != Snp->Mode.MediaHeaderSize) || (DestAddr == 0) || (Protocol == 0)) {
-      Status = EFI_INVALID_PARAMETER;
+  Snp = SNP_DRIVER_FROM_BATCH_THIS (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Index = 0;
+  switch (Snp->Mode.State) {
+    case EfiSimpleNetworkInitialized:
+      break;
+
+    case EfiSimpleNetworkStopped:
+      Status = EFI_NOT_STARTED;
       goto ON_EXIT;
-    }
 
-    Status = PxeFillHeader (
+    default:
+      Status = EFI_DEVICE_ERROR;
+      goto ON_EXIT;
+  }
+
+  Status = EFI_SUCCESS;
+  for ( ; Index < *PacketCount; Index++) {
+    Status = SnpTransmitPacket (
                Snp,
-               Buffer,
-               HeaderSize,
-               (UINT8 *)Buffer + HeaderSize,
-               BufferSize - HeaderSize,
-               DestAddr,
-               SrcAddr,
-               Protocol
+               Packets[Index].HeaderSize,
+               Packets[Index].BufferSize,
+               Packets[Index].Buffer,
+               Packets[Index].SrcAddr,
+               Packets[Index].DestAddr,
+               Packets[Index].Protocol
                );
-
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      break;
     }
   }
 
-  Status = PxeTransmit (Snp, Buffer, BufferSize);
-
 ON_EXIT:
+  *PacketCount = Index;
   gBS->RestoreTPL (OldTpl);
 
   return Status;
@@ -0,0 +1,133 @@
+/** @file
+  Tests for the congestion control algorithms of TcpCongestion.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+  #include "TcpCongestionGoogleTest.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_MSS  1000
+#define TEST_ISS  0xFFFF0000 // The flight wraps around.
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+// Give the TCB a window of Segments full sized segments in flight
+// and a congestion window of the same size.
+static VOID
+SetFlight (
+  TCP_CB  *Tcb,
+  UINT32  Segments
+  )
+{
+  Tcb->SndMss = TEST_MSS;
+  Tcb->SndUna = TEST_ISS;
+  Tcb->SndNxt = TEST_ISS + Segments * TEST_MSS;
+  Tcb->CWnd   = Segments * TEST_MSS;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Congestion control Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// The integer cube root is exact up to MAX_UINT64.
+TEST (TcpCubicTest, CubeRoot) {
+  EXPECT_EQ (TcpCubicRoot (0), 0U);
+  EXPECT_EQ (TcpCubicRoot (1), 1U);
+  EXPECT_EQ (TcpCubicRoot (7), 1U);
+  EXPECT_EQ (TcpCubicRoot (8), 2U);
+  EXPECT_EQ (TcpCubicRoot (26), 2U);
+  EXPECT_EQ (TcpCubicRoot (27), 3U);
+  EXPECT_EQ (TcpCubicRoot (999999999999999999ULL), 999999U);
+  EXPECT_EQ (TcpCubicRoot (1000000000000000000ULL), 1000000U);
+  EXPECT_EQ (TcpCubicRoot (MAX_UINT64), 2642245U);
+}
+
+// Test Description:
+// NewReno halves the window, CUBIC reduces it to 70 percent.
+TEST (TcpCubicTest, Ssthresh) {
+  TCP_CB  Tcb;
+
+  ZeroMem (&Tcb, sizeof (Tcb));
+  SetFlight (&Tcb, 100);
+  EXPECT_EQ (mTcpNewRenoOps.Ssthresh (&Tcb), 50U * TEST_MSS);
+
+  mTcpCubicOps.Init (&Tcb);
+  EXPECT_EQ (mTcpCubicOps.Ssthresh (&Tcb), 70U * TEST_MSS);
+  EXPECT_EQ (Tcb.CongestData.Cubic.WMax, 100U);
+
+  //
+  // Fast convergence: a loss below the last maximum lowers WMax further.
+  //
+  SetFlight (&Tcb, 80);
+  EXPECT_EQ (mTcpCubicOps.Ssthresh (&Tcb), 56U * TEST_MSS);
+  EXPECT_EQ (Tcb.CongestData.Cubic.WMax, 68U);
+  EXPECT_EQ (Tcb.CongestData.Cubic.LastWMax, 80U);
+
+  //
+  // Never below two segments.
+  //
+  SetFlight (&Tcb, 1);
+  EXPECT_EQ (mTcpNewRenoOps.Ssthresh (&Tcb), 2U * TEST_MSS);
+  EXPECT_EQ (mTcpCubicOps.Ssthresh (&Tcb), 2U * TEST_MSS);
+}
+
+// Test Description:
+// After a loss CUBIC grows back to WMax around K seconds, plateaus
+// there and then probes beyond it, while NewReno grows one segment
+// per round trip.
+TEST (TcpCubicTest, WindowGrowth) {
+  TCP_CB  Cubic;
+  TCP_CB  Reno;
+  UINT32  Round;
+  UINT32  Acked;
+  UINT32  K;
+
+  ZeroMem (&Cubic, sizeof (Cubic));
+  SetFlight (&Cubic, 100);
+  Cubic.SRtt = 1 << TCP_RTT_SHIFT;
+  mTcpCubicOps.Init (&Cubic);
+
+  Cubic.Ssthresh = mTcpCubicOps.Ssthresh (&Cubic);
+  Cubic.CWnd     = Cubic.Ssthresh;
+  CopyMem (&Reno, &Cubic, sizeof (Reno));
+
+  //
+  // K = cbrt (WMax * (1 - beta) / C), in round trips of one tick.
+  //
+  K = TcpCubicRoot (30ULL * 2500000000ULL) / TCP_TICK;
+
+  for (Round = 1; Round <= 3 * K; Round++) {
+    mTcpTick++;
+    for (Acked = 0; Acked < Cubic.CWnd; Acked += TEST_MSS) {
+      mTcpCubicOps.CongAvoid (&Cubic, TEST_MSS);
+    }
+
+    for (Acked = 0; Acked < Reno.CWnd; Acked += TEST_MSS) {
+      mTcpNewRenoOps.CongAvoid (&Reno, TEST_MSS);
+    }
+
+    if (Round == K) {
+      EXPECT_GE (Cubic.CWnd, 95U * TEST_MSS);
+      EXPECT_LE (Cubic.CWnd, 105U * TEST_MSS);
+    }
+  }
+
+  EXPECT_GT (Cubic.CWnd, 130U * TEST_MSS);
+  EXPECT_GT (Cubic.CWnd, Reno.CWnd);
+  EXPECT_LE (Reno.CWnd, (70U + 3 * K + 1) * TEST_MSS);
+}
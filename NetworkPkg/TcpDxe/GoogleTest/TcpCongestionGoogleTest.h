@@ -0,0 +1,30 @@
+/** @file
+  Exposes the functions needed to test the TcpCongestion module.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef TCP_CONGESTION_GOOGLE_TEST_H_
+#define TCP_CONGESTION_GOOGLE_TEST_H_
+
+#include <Uefi.h>
+#include "../TcpMain.h"
+
+extern TCP_CONGEST_OPS  mTcpNewRenoOps;
+extern TCP_CONGEST_OPS  mTcpCubicOps;
+
+/**
+  Compute the integer cube root of a 64 bit value.
+
+  @param[in]  Value     The value.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  );
+
+#endif // TCP_CONGESTION_GOOGLE_TEST_H_
@@ -0,0 +1,656 @@
+/** @file
+  Goodput tests that run a bulk transfer between two TCBs through the
+  real TcpInput, TcpOutput and TcpTicking, over a simulated IP layer that
+  limits the bandwidth and drops segments.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+#include <deque>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+  #include "TcpCongestionGoogleTest.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define LINK_MSS         1000
+#define LINK_SND_ISS     0xFFFF0000 // Wraps around during the transfer.
+#define LINK_RCV_ISS     0x1000
+#define LINK_SND_PORT    0x4000
+#define LINK_RCV_PORT    80
+#define LINK_RCV_WINDOW  (4 * 1024 * 1024)
+
+////////////////////////////////////////////////////////////////////////
+// Lossy link simulation
+////////////////////////////////////////////////////////////////////////
+
+class TcpLossyLink;
+
+// The link the stubbed IP and socket layers below belong to.
+static TcpLossyLink  *mLink;
+
+// A socket with the state of the application on top of it. The sender
+// has an endless stream of data to send, and the receiver consumes the
+// data as soon as TCP delivers it.
+typedef struct {
+  SOCKET           Sk;
+  NET_BUF_QUEUE    SndQue;
+  NET_BUF_QUEUE    RcvQue;
+  UINT64           Sent;
+  UINT64           Received;
+  BOOLEAN          Corrupted;
+} LINK_SOCKET;
+
+// The byte at Offset of the stream the sender sends.
+static UINT8
+StreamByte (
+  UINT64  Offset
+  )
+{
+  return (UINT8)(Offset % 251);
+}
+
+// A bulk transfer from Snd to Rcv over a link with a round trip time of
+// one TCP tick. The link delivers at most Capacity data segments per
+// round trip and queues up to Buffer more segments for the next round
+// trip, dropping the excess as a full router queue would. It also drops
+// the first transmission of the new data segments in DropList, and
+// random data segments at LossRate per million. ACKs are never lost.
+//
+// Both TCBs are set up as the handshake leaves them with the window
+// scale and SACK permitted options, and run the driver's segment
+// processing, output and timers.
+class TcpLossyLink {
+public:
+  TCP_CB                 Snd;
+  TCP_CB                 Rcv;
+  LINK_SOCKET            SndSk;
+  LINK_SOCKET            RcvSk;
+  IP_IO_IP_INFO          IpInfo;
+  UINT32                 Capacity;
+  UINT32                 Buffer;
+  UINT32                 LossRate;
+  UINT32                 Seed;
+  std::vector<UINT32>    DropList;
+  std::deque<NET_BUF *>  Forward;
+  std::deque<NET_BUF *>  Reverse;
+  TCP_SEQNO              SndMax;
+  UINT32                 NewSegments;
+  UINT32                 Ticks;
+  UINT32                 RecoverTicks;
+  UINT32                 Lost;
+  UINT32                 Retransmitted;
+  UINT32                 Timeouts;
+
+  TcpLossyLink (
+    TCP_CONGEST_OPS  *Ops,
+    BOOLEAN          Sack,
+    UINT32           Capacity,
+    UINT32           Buffer,
+    UINT32           LossRate
+    ) : Capacity (Capacity), Buffer (Buffer), LossRate (LossRate), Seed (1), NewSegments (0),
+    Ticks (0), RecoverTicks (0), Lost (0), Retransmitted (0), Timeouts (0)
+  {
+    ZeroMem (&IpInfo, sizeof (IpInfo));
+    IpInfo.IpVersion = IP_VERSION_4;
+
+    InitSocket (&SndSk);
+    InitSocket (&RcvSk);
+    InitTcb (&Snd, &SndSk, LINK_SND_PORT, LINK_RCV_PORT, 1, 2, LINK_SND_ISS, LINK_RCV_ISS, Ops, Sack);
+    InitTcb (&Rcv, &RcvSk, LINK_RCV_PORT, LINK_SND_PORT, 2, 1, LINK_RCV_ISS, LINK_SND_ISS, Ops, Sack);
+
+    SndMax = Snd.SndNxt;
+    mLink  = this;
+  }
+
+  ~TcpLossyLink (
+    )
+  {
+    FreeTcb (&Snd);
+    FreeTcb (&Rcv);
+    FreeLink (&Forward);
+    FreeLink (&Reverse);
+    mLink = NULL;
+  }
+
+  // Transfer Segments full sized segments, and return the goodput in
+  // bytes per second, or 0 if the transfer does not complete in time.
+  UINT64
+  Run (
+    UINT32  Segments,
+    UINT32  MaxTicks
+    )
+  {
+    UINT64  Length;
+    UINT32  LossTimes;
+
+    Length                       = (UINT64)Segments * LINK_MSS;
+    SndSk.SndQue.BufSize         = (UINT32)Length;
+    SndSk.Sk.SndBuffer.HighWater = (UINT32)Length;
+    TcpOnAppSend (&Snd);
+
+    while ((RcvSk.Received < Length) && (Ticks < MaxTicks)) {
+      Ticks++;
+
+      Deliver (&Forward, Capacity);
+      Deliver (&Reverse, (UINT32)Reverse.size ());
+
+      LossTimes = Snd.LossTimes;
+      TcpTicking (NULL, NULL);
+      if (Snd.LossTimes > LossTimes) {
+        Timeouts++;
+      }
+
+      if (Snd.CongestState == TCP_CONGEST_RECOVER) {
+        RecoverTicks++;
+      }
+    }
+
+    EXPECT_FALSE (RcvSk.Corrupted);
+
+    if (RcvSk.Received != Length) {
+      return 0;
+    }
+
+    return Length * 1000 / ((UINT64)Ticks * TCP_TICK);
+  }
+
+  // TcpSendIpPacket: put a copy of the segment on the link, or drop it.
+  INTN
+  Send (
+    TCP_CB   *Tcb,
+    NET_BUF  *Nbuf
+    )
+  {
+    TCP_SEG  *Seg;
+
+    Seg = TCPSEG_NETBUF (Nbuf);
+
+    if (Tcb == &Rcv) {
+      Reverse.push_back (CopySegment (Nbuf));
+      return 0;
+    }
+
+    if (Seg->End != Seg->Seq) {
+      if (TCP_SEQ_LT (Seg->Seq, SndMax)) {
+        Retransmitted++;
+      } else {
+        SndMax = Seg->End;
+        if (IsInDropList (NewSegments++)) {
+          Lost++;
+          return 0;
+        }
+      }
+
+      if (RandomLoss () || (Forward.size () >= Capacity + Buffer)) {
+        Lost++;
+        return 0;
+      }
+    }
+
+    Forward.push_back (CopySegment (Nbuf));
+    return 0;
+  }
+
+private:
+  VOID
+  InitSocket (
+    LINK_SOCKET  *Socket
+    )
+  {
+    ZeroMem (Socket, sizeof (*Socket));
+    Socket->Sk.IpVersion           = IP_VERSION_4;
+    Socket->Sk.SndBuffer.DataQueue = &Socket->SndQue;
+    Socket->Sk.RcvBuffer.DataQueue = &Socket->RcvQue;
+    Socket->Sk.RcvBuffer.HighWater = LINK_RCV_WINDOW;
+  }
+
+  // The state TcpConfigurePcb, TcpInitTcbLocal and TcpInitTcbPeer
+  // leave the TCB in after the handshake.
+  VOID
+  InitTcb (
+    TCP_CB           *Tcb,
+    LINK_SOCKET      *Socket,
+    UINT16           LocalPort,
+    UINT16           RemotePort,
+    UINT8            LocalHost,
+    UINT8            RemoteHost,
+    TCP_SEQNO        Iss,
+    TCP_SEQNO        Irs,
+    TCP_CONGEST_OPS  *Ops,
+    BOOLEAN          Sack
+    )
+  {
+    ZeroMem (Tcb, sizeof (*Tcb));
+    InitializeListHead (&Tcb->SndQue);
+    InitializeListHead (&Tcb->RcvQue);
+
+    Tcb->Sk     = &Socket->Sk;
+    Tcb->IpInfo = &IpInfo;
+
+    Tcb->LocalEnd.Ip.v4.Addr[0]  = 10;
+    Tcb->LocalEnd.Ip.v4.Addr[3]  = LocalHost;
+    Tcb->LocalEnd.Port           = HTONS (LocalPort);
+    Tcb->RemoteEnd.Ip.v4.Addr[0] = 10;
+    Tcb->RemoteEnd.Ip.v4.Addr[3] = RemoteHost;
+    Tcb->RemoteEnd.Port          = HTONS (RemotePort);
+    Tcb->HeadSum                 = NetPseudoHeadChecksum (
+                                     Tcb->LocalEnd.Ip.Addr[0],
+                                     Tcb->RemoteEnd.Ip.Addr[0],
+                                     0x06,
+                                     0
+                                     );
+
+    Tcb->State    = TCP_ESTABLISHED;
+    Tcb->CtrlFlag = TCP_CTRL_NO_KEEPALIVE | TCP_CTRL_RCVD_WS;
+    if (Sack) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SACK);
+    }
+
+    Tcb->SndMss = LINK_MSS;
+    Tcb->RcvMss = LINK_MSS;
+    Tcb->Rto    = 3 * TCP_TICK_HZ;
+
+    Tcb->Iss     = Iss;
+    Tcb->SndUna  = Iss + 1;
+    Tcb->SndNxt  = Iss + 1;
+    Tcb->HighRxt = Iss + 1;
+    Tcb->SndWl2  = Iss + 1;
+    Tcb->Irs     = Irs;
+    Tcb->RcvNxt  = Irs + 1;
+    Tcb->RcvWl2  = Irs + 1;
+    Tcb->SndWl1  = Irs + 1;
+
+    Tcb->RcvWndScale = TcpComputeScale (Tcb);
+    Tcb->SndWndScale = Tcb->RcvWndScale;
+    Tcb->RcvWnd      = LINK_RCV_WINDOW;
+    Tcb->SndWnd      = LINK_RCV_WINDOW;
+    Tcb->SndWndMax   = LINK_RCV_WINDOW;
+
+    Tcb->CWnd         = Tcb->SndMss;
+    Tcb->Ssthresh     = 0xffffffff;
+    Tcb->CongestState = TCP_CONGEST_OPEN;
+    Tcb->CongestOps   = Ops;
+    Ops->Init (Tcb);
+
+    Tcb->MaxRexmit = TCP_MAX_LOSS;
+
+    InsertTailList (&mTcpRunQue, &Tcb->List);
+  }
+
+  static VOID
+  FreeTcb (
+    TCP_CB  *Tcb
+    )
+  {
+    RemoveEntryList (&Tcb->List);
+    NetbufFreeList (&Tcb->SndQue);
+    NetbufFreeList (&Tcb->RcvQue);
+  }
+
+  static VOID
+  FreeLink (
+    std::deque<NET_BUF *>  *Link
+    )
+  {
+    while (!Link->empty ()) {
+      NetbufFree (Link->front ());
+      Link->pop_front ();
+    }
+  }
+
+  static NET_BUF *
+  CopySegment (
+    NET_BUF  *Nbuf
+    )
+  {
+    NET_BUF  *Copy;
+    UINT8    *Data;
+
+    Copy = NetbufAlloc (Nbuf->TotalSize);
+    EXPECT_NE (Copy, (NET_BUF *)NULL);
+    Data = NetbufAllocSpace (Copy, Nbuf->TotalSize, NET_BUF_TAIL);
+    NetbufCopy (Nbuf, 0, Nbuf->TotalSize, Data);
+    return Copy;
+  }
+
+  // TcpRxCallback: hand up to Count segments on the link to TcpInput.
+  // The segments the receiving TCB sends in response go on the links
+  // behind them, for the next round trip.
+  VOID
+  Deliver (
+    std::deque<NET_BUF *>  *Link,
+    UINT32                 Count
+    )
+  {
+    std::vector<NET_BUF *>  Segments;
+    EFI_IP_ADDRESS          Src;
+    EFI_IP_ADDRESS          Dst;
+    UINT32                  Index;
+
+    Count = MIN (Count, (UINT32)Link->size ());
+    Segments.assign (Link->begin (), Link->begin () + Count);
+    Link->erase (Link->begin (), Link->begin () + Count);
+
+    if (Link == &Forward) {
+      Src = Snd.LocalEnd.Ip;
+      Dst = Rcv.LocalEnd.Ip;
+    } else {
+      Src = Rcv.LocalEnd.Ip;
+      Dst = Snd.LocalEnd.Ip;
+    }
+
+    for (Index = 0; Index < Segments.size (); Index++) {
+      EXPECT_EQ (TcpInput (Segments[Index], &Src, &Dst, IP_VERSION_4), 0);
+    }
+  }
+
+  BOOLEAN
+  IsInDropList (
+    UINT32  Number
+    )
+  {
+    UINT32  Index;
+
+    for (Index = 0; Index < DropList.size (); Index++) {
+      if (DropList[Index] == Number) {
+        return TRUE;
+      }
+    }
+
+    return FALSE;
+  }
+
+  BOOLEAN
+  RandomLoss (
+    )
+  {
+    Seed = Seed * 1103515245 + 12345;
+    return ((Seed >> 8) % 1000000) < LossRate;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// The IP, socket and DPC layers under the TCP state machine
+////////////////////////////////////////////////////////////////////////
+
+INTN
+TcpSendIpPacket (
+  IN TCP_CB          *Tcb,
+  IN NET_BUF         *Nbuf,
+  IN EFI_IP_ADDRESS  *Src,
+  IN EFI_IP_ADDRESS  *Dest,
+  IN UINT8           Version
+  )
+{
+  return mLink->Send (Tcb, Nbuf);
+}
+
+EFI_STATUS
+Tcp6RefreshNeighbor (
+  IN TCP_CB          *Tcb,
+  IN EFI_IP_ADDRESS  *Neighbor,
+  IN UINT32          Timeout
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+IpIoGetIcmpErrStatus (
+  IN  UINT8    IcmpError,
+  IN  UINT8    IpVersion,
+  OUT BOOLEAN  *IsHard  OPTIONAL,
+  OUT BOOLEAN  *Notify  OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+// Run the heart beat of TcpTicking at once.
+EFI_STATUS
+EFIAPI
+QueueDpc (
+  IN EFI_TPL            DpcTpl,
+  IN EFI_DPC_PROCEDURE  DpcProcedure,
+  IN VOID               *DpcContext    OPTIONAL
+  )
+{
+  DpcProcedure (DpcContext);
+  return EFI_SUCCESS;
+}
+
+SOCKET *
+SockClone (
+  IN SOCKET  *Sock
+  )
+{
+  return NULL;
+}
+
+VOID
+SockConnEstablished (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+VOID
+SockConnClosed (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+VOID
+SockNoMoreData (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+UINT32
+SockGetFreeSpace (
+  IN SOCKET  *Sock,
+  IN UINT32  Which
+  )
+{
+  SOCK_BUFFER  *Buffer;
+
+  Buffer = (Which == SOCK_SND_BUF) ? &Sock->SndBuffer : &Sock->RcvBuffer;
+  return Buffer->HighWater - Buffer->DataQueue->BufSize;
+}
+
+UINT32
+SockGetDataToSend (
+  IN  SOCKET  *Sock,
+  IN  UINT32  Offset,
+  IN  UINT32  Len,
+  OUT UINT8   *Dest
+  )
+{
+  LINK_SOCKET  *Socket;
+  UINT32       Index;
+
+  Socket = (LINK_SOCKET *)Sock;
+  Len    = MIN (Len, GET_SND_DATASIZE (Sock) - Offset);
+
+  for (Index = 0; Index < Len; Index++) {
+    Dest[Index] = StreamByte (Socket->Sent + Offset + Index);
+  }
+
+  return Len;
+}
+
+VOID
+SockDataSent (
+  IN OUT SOCKET  *Sock,
+  IN     UINT32  Count
+  )
+{
+  LINK_SOCKET  *Socket;
+
+  Socket                  = (LINK_SOCKET *)Sock;
+  Socket->Sent           += Count;
+  Socket->SndQue.BufSize -= Count;
+}
+
+VOID
+SockDataRcvd (
+  IN OUT SOCKET   *Sock,
+  IN OUT NET_BUF  *NetBuffer,
+  IN     UINT32   UrgLen
+  )
+{
+  LINK_SOCKET         *Socket;
+  std::vector<UINT8>  Data (NetBuffer->TotalSize);
+  UINT32              Index;
+
+  Socket = (LINK_SOCKET *)Sock;
+  NetbufCopy (NetBuffer, 0, NetBuffer->TotalSize, Data.data ());
+
+  for (Index = 0; Index < Data.size (); Index++) {
+    if (Data[Index] != StreamByte (Socket->Received + Index)) {
+      Socket->Corrupted = TRUE;
+    }
+  }
+
+  Socket->Received += NetBuffer->TotalSize;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// With SACK, several losses in one window are repaired without a
+// timeout in fewer round trips, and only the lost segments are
+// retransmitted. NewReno without SACK repairs one hole per round trip.
+TEST (TcpLossyLinkTest, SackRepairsSeveralLossesInOneRoundTrip) {
+  UINT32  SackRecoverTicks;
+  UINT32  NoSackRecoverTicks;
+
+  {
+    TcpLossyLink  Sack (&mTcpNewRenoOps, TRUE, 1000, 1000, 0);
+
+    Sack.DropList = { 40, 44, 48, 52, 56 };
+    ASSERT_NE (Sack.Run (200, 100), 0U);
+
+    EXPECT_EQ (Sack.Timeouts, 0U);
+    EXPECT_EQ (Sack.Retransmitted, 5U);
+    SackRecoverTicks = Sack.RecoverTicks;
+  }
+
+  {
+    TcpLossyLink  NoSack (&mTcpNewRenoOps, FALSE, 1000, 1000, 0);
+
+    NoSack.DropList = { 40, 44, 48, 52, 56 };
+    ASSERT_NE (NoSack.Run (200, 100), 0U);
+
+    EXPECT_EQ (NoSack.Timeouts, 0U);
+    NoSackRecoverTicks = NoSack.RecoverTicks;
+  }
+
+  EXPECT_GE (NoSackRecoverTicks, 5U);
+  EXPECT_LT (SackRecoverTicks, NoSackRecoverTicks);
+}
+
+// Test Description:
+// The slow start overshoot drops many segments of one window at the
+// router queue. SACK repairs them in a few round trips without a
+// timeout and improves the goodput, NewReno repairs one per round trip.
+TEST (TcpLossyLinkTest, SackImprovesGoodputAfterQueueOverflow) {
+  UINT64  SackGoodput;
+  UINT64  NoSackGoodput;
+  UINT32  SackRecoverTicks;
+  UINT32  NoSackRecoverTicks;
+
+  {
+    TcpLossyLink  Sack (&mTcpNewRenoOps, TRUE, 100, 10, 0);
+
+    SackGoodput = Sack.Run (20000, 100000);
+    ASSERT_NE (SackGoodput, 0U);
+    EXPECT_EQ (Sack.Timeouts, 0U);
+    EXPECT_EQ (Sack.Retransmitted, Sack.Lost);
+    SackRecoverTicks = Sack.RecoverTicks;
+  }
+
+  {
+    TcpLossyLink  NoSack (&mTcpNewRenoOps, FALSE, 100, 10, 0);
+
+    NoSackGoodput = NoSack.Run (20000, 100000);
+    ASSERT_NE (NoSackGoodput, 0U);
+    NoSackRecoverTicks = NoSack.RecoverTicks;
+  }
+
+  RecordProperty ("SackGoodput", (int)SackGoodput);
+  RecordProperty ("NoSackGoodput", (int)NoSackGoodput);
+
+  EXPECT_LT (SackRecoverTicks * 4, NoSackRecoverTicks);
+  EXPECT_GT (SackGoodput, NoSackGoodput);
+}
+
+// Test Description:
+// The transfer completes with the data intact over a link with random
+// loss, including lost retransmissions, and SACK retransmits little
+// more than what was lost.
+TEST (TcpLossyLinkTest, TransferSurvivesRandomLoss) {
+  UINT64  SackGoodput;
+  UINT64  NoSackGoodput;
+
+  {
+    TcpLossyLink  Sack (&mTcpNewRenoOps, TRUE, 100, 100, 10000);
+
+    SackGoodput = Sack.Run (20000, 100000);
+    ASSERT_NE (SackGoodput, 0U);
+    EXPECT_LE (Sack.Retransmitted, Sack.Lost + Sack.Lost / 4);
+  }
+
+  {
+    TcpLossyLink  NoSack (&mTcpNewRenoOps, FALSE, 100, 100, 10000);
+
+    NoSackGoodput = NoSack.Run (20000, 100000);
+    ASSERT_NE (NoSackGoodput, 0U);
+  }
+
+  RecordProperty ("SackGoodput", (int)SackGoodput);
+  RecordProperty ("NoSackGoodput", (int)NoSackGoodput);
+}
+
+// Test Description:
+// CUBIC keeps a long fat pipe with a shallow router queue fuller than
+// NewReno after each loss.
+TEST (TcpLossyLinkTest, CubicImprovesGoodputOnLongFatPipe) {
+  UINT64  CubicGoodput;
+  UINT64  RenoGoodput;
+
+  {
+    TcpLossyLink  Cubic (&mTcpCubicOps, TRUE, 300, 30, 0);
+
+    CubicGoodput = Cubic.Run (100000, 100000);
+    ASSERT_NE (CubicGoodput, 0U);
+  }
+
+  {
+    TcpLossyLink  Reno (&mTcpNewRenoOps, TRUE, 300, 30, 0);
+
+    RenoGoodput = Reno.Run (100000, 100000);
+    ASSERT_NE (RenoGoodput, 0U);
+  }
+
+  RecordProperty ("CubicGoodput", (int)CubicGoodput);
+  RecordProperty ("NewRenoGoodput", (int)RenoGoodput);
+
+  EXPECT_GT (CubicGoodput, RenoGoodput);
+}
@@ -0,0 +1,457 @@
+/** @file
+  Tests for the SACK option handling of TcpOption.c and the SACK
+  scoreboard of TcpSack.c.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <gtest/gtest.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define TEST_MSS          1000
+#define TEST_ISS          0x10000
+#define TEST_OPTION_ROOM  64
+
+////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////
+
+// Fixture owning a zeroed TCB with empty queues, and helpers to put
+// segments on them in sequence order.
+class TcpSackTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    InitializeListHead (&Tcb.SndQue);
+    InitializeListHead (&Tcb.RcvQue);
+
+    Tcb.SndMss   = TEST_MSS;
+    Tcb.SndUna   = TEST_ISS;
+    Tcb.SndNxt   = TEST_ISS;
+    Tcb.HighRxt  = TEST_ISS;
+    Tcb.RcvNxt   = TEST_ISS;
+    Tcb.CtrlFlag = TCP_CTRL_SACK;
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    FreeQueue (&Tcb.SndQue);
+    FreeQueue (&Tcb.RcvQue);
+  }
+
+  static VOID
+  FreeQueue (
+    LIST_ENTRY  *Head
+    )
+  {
+    LIST_ENTRY  *Entry;
+    LIST_ENTRY  *Next;
+    NET_BUF     *Nbuf;
+
+    NET_LIST_FOR_EACH_SAFE (Entry, Next, Head) {
+      Nbuf = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      RemoveEntryList (Entry);
+      NetbufFree (Nbuf);
+    }
+  }
+
+  static TCP_SEG *
+  QueueSegment (
+    LIST_ENTRY  *Head,
+    TCP_SEQNO   Seq,
+    TCP_SEQNO   End
+    )
+  {
+    NET_BUF  *Nbuf;
+
+    Nbuf = NetbufAlloc (1);
+    EXPECT_NE (Nbuf, nullptr);
+
+    TCPSEG_NETBUF (Nbuf)->Seq  = Seq;
+    TCPSEG_NETBUF (Nbuf)->End  = End;
+    TCPSEG_NETBUF (Nbuf)->Sack = 0;
+    InsertTailList (Head, &Nbuf->List);
+    return TCPSEG_NETBUF (Nbuf);
+  }
+
+  // Send Count full sized segments.
+  VOID
+  Send (
+    UINT32  Count
+    )
+  {
+    while (Count-- > 0) {
+      QueueSegment (&Tcb.SndQue, Tcb.SndNxt, Tcb.SndNxt + TEST_MSS);
+      Tcb.SndNxt += TEST_MSS;
+    }
+  }
+
+  // Receive the Index-th segment after RcvNxt out of order.
+  VOID
+  ReceiveOutOfOrder (
+    UINT32  Index
+    )
+  {
+    TCP_SEQNO   Seq;
+    LIST_ENTRY  *Entry;
+    NET_BUF     *Nbuf;
+
+    Seq = Tcb.RcvNxt + Index * TEST_MSS;
+
+    NET_LIST_FOR_EACH (Entry, &Tcb.RcvQue) {
+      if (TCP_SEQ_GT (TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Seq, Seq)) {
+        break;
+      }
+    }
+
+    Nbuf = NetbufAlloc (1);
+    ASSERT_NE (Nbuf, nullptr);
+    TCPSEG_NETBUF (Nbuf)->Seq = Seq;
+    TCPSEG_NETBUF (Nbuf)->End = Seq + TEST_MSS;
+    InsertTailList (Entry, &Nbuf->List);
+
+    Tcb.RcvSackSeq = Seq;
+  }
+
+  TCP_SEG *
+  SndSegment (
+    UINT32  Index
+    )
+  {
+    LIST_ENTRY  *Entry;
+
+    for (Entry = Tcb.SndQue.ForwardLink; Index > 0; Index--) {
+      Entry = Entry->ForwardLink;
+    }
+
+    return TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+  }
+
+  // Encode the options the TCB would put on a pure ACK, and parse
+  // them back as the peer would.
+  UINT16
+  BuildAndParse (
+    TCP_OPTION  *Option
+    )
+  {
+    NET_BUF   *Nbuf;
+    TCP_HEAD  *Head;
+    UINT16    Len;
+
+    Nbuf = NetbufAlloc (TEST_OPTION_ROOM);
+    EXPECT_NE (Nbuf, nullptr);
+    NetbufReserve (Nbuf, TEST_OPTION_ROOM);
+
+    Len = TcpBuildOption (&Tcb, Nbuf);
+
+    Head = (TCP_HEAD *)NetbufAllocSpace (Nbuf, sizeof (TCP_HEAD), NET_BUF_HEAD);
+    EXPECT_NE (Head, nullptr);
+    ZeroMem (Head, sizeof (TCP_HEAD));
+    Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+
+    EXPECT_EQ (TcpParseOption (Head, Option), 0);
+    NetbufFree (Nbuf);
+    return Len;
+  }
+};
+
+// Build a TCP header followed by raw option bytes and parse it.
+static int
+ParseRawOption (
+  const UINT8  *Raw,
+  UINT8        RawLen,
+  TCP_OPTION   *Option
+  )
+{
+  UINT8     Buffer[60];
+  TCP_HEAD  *Head;
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  CopyMem (Buffer + sizeof (TCP_HEAD), Raw, RawLen);
+
+  Head          = (TCP_HEAD *)Buffer;
+  Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + RawLen + 3) >> 2);
+
+  return TcpParseOption (Head, Option);
+}
+
+////////////////////////////////////////////////////////////////////////
+// SACK option Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// The SYN carries SACK permitted unless SACK is disabled, and the
+// peer sees it as such.
+TEST_F (TcpSackTest, SynCarriesSackPermitted) {
+  NET_BUF     *Nbuf;
+  TCP_HEAD    *Head;
+  TCP_OPTION  Option;
+  UINT16      Len;
+
+  Tcb.CtrlFlag = TCP_CTRL_NO_TS | TCP_CTRL_NO_WS;
+  Tcb.RcvMss   = TEST_MSS;
+
+  Nbuf = NetbufAlloc (TEST_OPTION_ROOM);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufReserve (Nbuf, TEST_OPTION_ROOM);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN;
+
+  Len = TcpSynBuildOption (&Tcb, Nbuf);
+  EXPECT_EQ (Len, TCP_OPTION_SACK_PERM_ALIGNED_LEN + TCP_OPTION_MSS_LEN);
+
+  Head = (TCP_HEAD *)NetbufAllocSpace (Nbuf, sizeof (TCP_HEAD), NET_BUF_HEAD);
+  ZeroMem (Head, sizeof (TCP_HEAD));
+  Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+
+  ASSERT_EQ (TcpParseOption (Head, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+  EXPECT_EQ (Option.Mss, TEST_MSS);
+  NetbufFree (Nbuf);
+
+  Tcb.CtrlFlag |= TCP_CTRL_NO_SACK;
+  Nbuf          = NetbufAlloc (TEST_OPTION_ROOM);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufReserve (Nbuf, TEST_OPTION_ROOM);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN;
+
+  EXPECT_EQ (TcpSynBuildOption (&Tcb, Nbuf), TCP_OPTION_MSS_LEN);
+  NetbufFree (Nbuf);
+}
+
+// Test Description:
+// No SACK option is sent when all the data is in order.
+TEST_F (TcpSackTest, NoBlocksWhenInOrder) {
+  TCP_OPTION  Option;
+
+  EXPECT_EQ (BuildAndParse (&Option), 0);
+  EXPECT_EQ (Option.SackCount, 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+}
+
+// Test Description:
+// The block of the latest segment goes first, the others follow in
+// sequence order, and adjacent segments are merged into one block.
+TEST_F (TcpSackTest, BlocksReportLatestFirst) {
+  TCP_OPTION  Option;
+
+  ReceiveOutOfOrder (2);
+  ReceiveOutOfOrder (3);
+  ReceiveOutOfOrder (8);
+  ReceiveOutOfOrder (5);
+
+  EXPECT_EQ (BuildAndParse (&Option), 4 + 3 * TCP_OPTION_SACK_BLOCK_LEN);
+  ASSERT_EQ (Option.SackCount, 3);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+
+  EXPECT_EQ (Option.SackBlock[0].Left, (TCP_SEQNO)(TEST_ISS + 5 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[0].Right, (TCP_SEQNO)(TEST_ISS + 6 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[1].Left, (TCP_SEQNO)(TEST_ISS + 2 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[1].Right, (TCP_SEQNO)(TEST_ISS + 4 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[2].Left, (TCP_SEQNO)(TEST_ISS + 8 * TEST_MSS));
+  EXPECT_EQ (Option.SackBlock[2].Right, (TCP_SEQNO)(TEST_ISS + 9 * TEST_MSS));
+}
+
+// Test Description:
+// At most four blocks fit, and only three next to the timestamp.
+TEST_F (TcpSackTest, BlocksLimitedByOptionSpace) {
+  TCP_OPTION  Option;
+  UINT32      Index;
+
+  for (Index = 1; Index <= 11; Index += 2) {
+    ReceiveOutOfOrder (Index);
+  }
+
+  EXPECT_EQ (BuildAndParse (&Option), 4 + TCP_OPTION_MAX_SACK * TCP_OPTION_SACK_BLOCK_LEN);
+  EXPECT_EQ (Option.SackCount, TCP_OPTION_MAX_SACK);
+  EXPECT_EQ (Option.SackBlock[0].Left, (TCP_SEQNO)(TEST_ISS + 11 * TEST_MSS));
+
+  Tcb.CtrlFlag |= TCP_CTRL_SND_TS;
+  EXPECT_EQ (BuildAndParse (&Option), TCP_OPTION_TS_ALIGNED_LEN + 4 + 3 * TCP_OPTION_SACK_BLOCK_LEN);
+  EXPECT_EQ (Option.SackCount, 3);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS));
+}
+
+// Test Description:
+// No SACK blocks are sent when SACK was not negotiated.
+TEST_F (TcpSackTest, NoBlocksWithoutNegotiation) {
+  TCP_OPTION  Option;
+
+  ReceiveOutOfOrder (2);
+  Tcb.CtrlFlag = 0;
+
+  EXPECT_EQ (BuildAndParse (&Option), 0);
+  EXPECT_EQ (Option.SackCount, 0);
+}
+
+// Test Description:
+// Malformed SACK options are rejected.
+TEST (TcpSackOptionTest, MalformedOptionsRejected) {
+  TCP_OPTION  Option;
+  //
+  // SACK permitted with a wrong length, a SACK option that is not a
+  // multiple of the block size, one that overruns the header, and
+  // one without any block.
+  //
+  const UINT8  BadPerm[]    = { TCP_OPTION_SACK_PERM, 3, 0, TCP_OPTION_EOP };
+  const UINT8  BadLen[]     = { TCP_OPTION_SACK, 6, 0, 0, 0, 1, TCP_OPTION_EOP, 0 };
+  const UINT8  Overrun[]    = { TCP_OPTION_SACK, 18, 0, 0, 0, 1, 0, 0, 0, 2 };
+  const UINT8  Empty[]      = { TCP_OPTION_SACK, 2, TCP_OPTION_EOP, 0 };
+  const UINT8  GoodPerm[]   = { TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_SACK_PERM, 2 };
+  const UINT8  GoodBlocks[] = {
+    TCP_OPTION_NOP, TCP_OPTION_NOP, TCP_OPTION_SACK, 18,
+    0x00,           0x00,           0x10,            0x00,
+    0x00,           0x00,           0x20,            0x00,
+    0x00,           0x00,           0x30,            0x00,
+    0x00,           0x00,           0x40,            0x00
+  };
+
+  EXPECT_EQ (ParseRawOption (BadPerm, sizeof (BadPerm), &Option), -1);
+  EXPECT_EQ (ParseRawOption (BadLen, sizeof (BadLen), &Option), -1);
+  EXPECT_EQ (ParseRawOption (Overrun, sizeof (Overrun), &Option), -1);
+  EXPECT_EQ (ParseRawOption (Empty, sizeof (Empty), &Option), -1);
+
+  ASSERT_EQ (ParseRawOption (GoodPerm, sizeof (GoodPerm), &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+
+  ASSERT_EQ (ParseRawOption (GoodBlocks, sizeof (GoodBlocks), &Option), 0);
+  ASSERT_EQ (Option.SackCount, 2);
+  EXPECT_EQ (Option.SackBlock[0].Left, 0x1000U);
+  EXPECT_EQ (Option.SackBlock[0].Right, 0x2000U);
+  EXPECT_EQ (Option.SackBlock[1].Left, 0x3000U);
+  EXPECT_EQ (Option.SackBlock[1].Right, 0x4000U);
+}
+
+////////////////////////////////////////////////////////////////////////
+// SACK scoreboard Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// Only the segments entirely covered by a valid block are SACKed,
+// blocks below the ACK or beyond SndNxt are ignored.
+TEST_F (TcpSackTest, UpdateMarksCoveredSegments) {
+  TCP_OPTION  Option;
+
+  Send (6);
+
+  ZeroMem (&Option, sizeof (Option));
+  Option.SackCount          = 3;
+  Option.SackBlock[0].Left  = TEST_ISS + 2 * TEST_MSS;
+  Option.SackBlock[0].Right = TEST_ISS + 3 * TEST_MSS + TEST_MSS / 2;
+  Option.SackBlock[1].Left  = TEST_ISS - TEST_MSS;
+  Option.SackBlock[1].Right = TEST_ISS;
+  Option.SackBlock[2].Left  = TEST_ISS + 5 * TEST_MSS;
+  Option.SackBlock[2].Right = TEST_ISS + 7 * TEST_MSS;
+
+  EXPECT_TRUE (TcpSackUpdate (&Tcb, TEST_ISS, &Option));
+  EXPECT_EQ (SndSegment (0)->Sack, 0);
+  EXPECT_EQ (SndSegment (1)->Sack, 0);
+  EXPECT_EQ (SndSegment (2)->Sack, TCP_SEG_SACKED);
+  EXPECT_EQ (SndSegment (3)->Sack, 0);
+  EXPECT_EQ (SndSegment (4)->Sack, 0);
+  EXPECT_EQ (SndSegment (5)->Sack, 0);
+
+  //
+  // Nothing new the second time.
+  //
+  EXPECT_FALSE (TcpSackUpdate (&Tcb, TEST_ISS, &Option));
+}
+
+// Test Description:
+// A hole is lost once more than two segments above it are SACKed,
+// and the pipe counts only the segments that may still be in flight.
+TEST_F (TcpSackTest, SetPipeMarksLostSegments) {
+  TCP_OPTION  Option;
+  TCP_SEQNO   Seq;
+  TCP_SEQNO   End;
+
+  Send (8);
+
+  ZeroMem (&Option, sizeof (Option));
+  Option.SackCount          = 1;
+  Option.SackBlock[0].Left  = TEST_ISS + 4 * TEST_MSS;
+  Option.SackBlock[0].Right = TEST_ISS + 7 * TEST_MSS;
+  TcpSackUpdate (&Tcb, TEST_ISS, &Option);
+
+  //
+  // Segments 0 - 3 are below three SACKed segments, segment 7
+  // is above them and still in flight.
+  //
+  EXPECT_EQ (TcpSackSetPipe (&Tcb), (UINT32)TEST_MSS);
+  EXPECT_EQ (SndSegment (0)->Sack, TCP_SEG_LOST);
+  EXPECT_EQ (SndSegment (3)->Sack, TCP_SEG_LOST);
+  EXPECT_EQ (SndSegment (7)->Sack, 0);
+
+  ASSERT_TRUE (TcpSackNextSeg (&Tcb, &Seq, &End));
+  EXPECT_EQ (Seq, (TCP_SEQNO)TEST_ISS);
+  EXPECT_EQ (End, (TCP_SEQNO)(TEST_ISS + TEST_MSS));
+
+  //
+  // The retransmitted segments count in the pipe again, and
+  // NextSeg moves on to the next hole.
+  //
+  Tcb.HighRxt = TEST_ISS + 2 * TEST_MSS;
+  EXPECT_EQ (TcpSackSetPipe (&Tcb), (UINT32)(3 * TEST_MSS));
+
+  ASSERT_TRUE (TcpSackNextSeg (&Tcb, &Seq, &End));
+  EXPECT_EQ (Seq, (TCP_SEQNO)(TEST_ISS + 2 * TEST_MSS));
+
+  Tcb.HighRxt = TEST_ISS + 4 * TEST_MSS;
+  EXPECT_FALSE (TcpSackNextSeg (&Tcb, &Seq, &End));
+}
+
+// Test Description:
+// In fast recovery the first unacknowledged segment is lost even
+// with too few SACKed segments above it.
+TEST_F (TcpSackTest, SetPipeHeadLostInRecovery) {
+  TCP_OPTION  Option;
+
+  Send (4);
+
+  ZeroMem (&Option, sizeof (Option));
+  Option.SackCount          = 1;
+  Option.SackBlock[0].Left  = TEST_ISS + 2 * TEST_MSS;
+  Option.SackBlock[0].Right = TEST_ISS + 3 * TEST_MSS;
+  TcpSackUpdate (&Tcb, TEST_ISS, &Option);
+
+  EXPECT_EQ (TcpSackSetPipe (&Tcb), (UINT32)(3 * TEST_MSS));
+  EXPECT_EQ (SndSegment (0)->Sack, 0);
+
+  Tcb.CongestState = TCP_CONGEST_RECOVER;
+  EXPECT_EQ (TcpSackSetPipe (&Tcb), (UINT32)(2 * TEST_MSS));
+  EXPECT_EQ (SndSegment (0)->Sack, TCP_SEG_LOST);
+  EXPECT_EQ (SndSegment (1)->Sack, 0);
+}
+
+// Test Description:
+// The scoreboard is discarded after a retransmission timeout.
+TEST_F (TcpSackTest, ClearResetsScoreboard) {
+  Send (3);
+  SndSegment (1)->Sack = TCP_SEG_SACKED;
+  SndSegment (0)->Sack = TCP_SEG_LOST;
+  Tcb.HighRxt          = TEST_ISS + TEST_MSS;
+  Tcb.Pipe             = TEST_MSS;
+
+  TcpSackClear (&Tcb);
+
+  EXPECT_EQ (SndSegment (0)->Sack, 0);
+  EXPECT_EQ (SndSegment (1)->Sack, 0);
+  EXPECT_EQ (Tcb.HighRxt, Tcb.SndUna);
+  EXPECT_EQ (Tcb.Pipe, 0U);
+}
@@ -218,6 +218,8 @@ SockSetTcpRxData (
     RcvdBytes               -= CopyBytes;
     OffSet                  += CopyBytes;
   }
+
+  Sock->RcvCopiedBytes += OffSet;
 }
 
 /**
@@ -334,6 +336,169 @@ SockProcessRcvToken (
   return TokenRcvdBytes;
 }
 
+/**
+  Release the NET_BUFs handed over to a fragment receive token. It is
+  the notify function of RecycleSignal.
+
+  @param[in]  Event              The event that is signaled.
+  @param[in]  Context            Pointer to the SOCK_FRAGMENT_WRAP.
+
+**/
+VOID
+EFIAPI
+SockRecycleFragments (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  SOCK_FRAGMENT_WRAP  *Wrap;
+
+  Wrap = (SOCK_FRAGMENT_WRAP *)Context;
+
+  NetbufFreeList (&Wrap->NbufList);
+  gBS->CloseEvent (Event);
+  FreePool (Wrap);
+}
+
+/**
+  Hand the received data over to the fragment receive token by reference.
+
+  The NET_BUFs that are completely consumed are moved from the receive
+  buffer of the socket to the token, the last one is cloned if it is only
+  partly consumed. No data is copied.
+
+  @param[in, out]  Sock       Pointer to the socket.
+  @param[in, out]  Token      Pointer to the application provided fragment receive token.
+
+  @return The length of data received in this token.
+
+**/
+UINT32
+SockProcessRcvFragmentToken (
+  IN OUT SOCKET                            *Sock,
+  IN OUT EDKII_TCP_FRAGMENT_RECEIVE_TOKEN  *Token
+  )
+{
+  NET_BUF_QUEUE       *DataQueue;
+  SOCK_FRAGMENT_WRAP  *Wrap;
+  LIST_ENTRY          *Entry;
+  NET_BUF             *Nbuf;
+  NET_BUF             *Partial;
+  UINT32              TokenRcvdBytes;
+  UINT32              Remaining;
+  UINT32              BlockNum;
+  UINT32              Index;
+  UINT32              Num;
+  BOOLEAN             IsUrg;
+  EFI_STATUS          Status;
+
+  ASSERT ((Sock != NULL) && (SockStream == Sock->Type));
+
+  DataQueue      = Sock->RcvBuffer.DataQueue;
+  TokenRcvdBytes = SockTcpDataToRcv (&Sock->RcvBuffer, &IsUrg, Token->MaxLength);
+
+  //
+  // Find out the number of blocks to hand over, and the NET_BUF
+  // that is only partly consumed, if any.
+  //
+  Partial   = NULL;
+  Remaining = TokenRcvdBytes;
+  BlockNum  = 0;
+
+  NET_LIST_FOR_EACH (Entry, &DataQueue->BufList) {
+    if (Remaining == 0) {
+      break;
+    }
+
+    Nbuf      = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    BlockNum += Nbuf->BlockOpNum;
+
+    if (Nbuf->TotalSize > Remaining) {
+      Partial = Nbuf;
+      break;
+    }
+
+    Remaining -= Nbuf->TotalSize;
+  }
+
+  ASSERT (BlockNum > 0);
+
+  Wrap = AllocateZeroPool (sizeof (SOCK_FRAGMENT_WRAP) + (BlockNum - 1) * sizeof (EFI_TCP4_FRAGMENT_DATA));
+  if (Wrap == NULL) {
+    goto OnError;
+  }
+
+  InitializeListHead (&Wrap->NbufList);
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  SockRecycleFragments,
+                  Wrap,
+                  &Wrap->RxData.RecycleSignal
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (Wrap);
+    goto OnError;
+  }
+
+  //
+  // Clone the partly consumed NET_BUF before the receive buffer is
+  // modified, so that nothing has to be undone if it fails. The clone
+  // shares the data blocks with the original.
+  //
+  if (Partial != NULL) {
+    Partial = NetbufGetFragment (Partial, 0, Remaining, 0);
+    if (Partial == NULL) {
+      gBS->CloseEvent (Wrap->RxData.RecycleSignal);
+      FreePool (Wrap);
+      goto OnError;
+    }
+  }
+
+  Remaining = TokenRcvdBytes;
+  while ((Remaining > 0) && (Remaining >= NET_LIST_HEAD (&DataQueue->BufList, NET_BUF, List)->TotalSize)) {
+    Nbuf       = NetbufQueRemove (DataQueue);
+    Remaining -= Nbuf->TotalSize;
+    InsertTailList (&Wrap->NbufList, &Nbuf->List);
+  }
+
+  if (Partial != NULL) {
+    ASSERT (Partial->TotalSize == Remaining);
+    NetbufQueTrim (DataQueue, Remaining);
+    InsertTailList (&Wrap->NbufList, &Partial->List);
+  }
+
+  //
+  // Build the fragment table on the blocks of the NET_BUFs.
+  //
+  Index = 0;
+  NET_LIST_FOR_EACH (Entry, &Wrap->NbufList) {
+    Nbuf = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Num  = BlockNum - Index;
+
+    Status = NetbufBuildExt (Nbuf, (NET_FRAGMENT *)&Wrap->RxData.FragmentTable[Index], &Num);
+    ASSERT_EFI_ERROR (Status);
+    Index += Num;
+  }
+
+  Wrap->RxData.UrgentFlag    = IsUrg;
+  Wrap->RxData.DataLength    = TokenRcvdBytes;
+  Wrap->RxData.FragmentCount = Index;
+  Token->RxData              = &Wrap->RxData;
+
+  Sock->RcvByReferenceBytes += TokenRcvdBytes;
+
+  SIGNAL_TOKEN (&Token->CompletionToken, EFI_SUCCESS);
+  return TokenRcvdBytes;
+
+OnError:
+  DEBUG ((DEBUG_ERROR, "SockProcessRcvFragmentToken: No resource to hand over the data\n"));
+
+  SIGNAL_TOKEN (&Token->CompletionToken, EFI_OUT_OF_RESOURCES);
+  return 0;
+}
+
 /**
   Process the TCP send data, buffer the tcp txdata, and append
   the buffer to socket send buffer, then try to send it.
@@ -531,6 +696,7 @@ SockWakeRcvToken (
   UINT32         TokenRcvdBytes;
   SOCK_TOKEN     *SockToken;
   SOCK_IO_TOKEN  *RcvToken;
+  BOOLEAN        Handoff;
 
   ASSERT (Sock->RcvBuffer.DataQueue != NULL);
 
@@ -545,10 +711,22 @@ SockWakeRcvToken (
                   TokenList
                   );
 
-    RcvToken       = (SOCK_IO_TOKEN *)SockToken->Token;
-    TokenRcvdBytes = SockProcessRcvToken (Sock, RcvToken);
+    //
+    // A fragment receive token is completed, with an error if the data
+    // can't be handed over, so it is always removed.
+    //
+    Handoff = SockToken->Handoff;
+    if (Handoff) {
+      TokenRcvdBytes = SockProcessRcvFragmentToken (
+                         Sock,
+                         (EDKII_TCP_FRAGMENT_RECEIVE_TOKEN *)SockToken->Token
+                         );
+    } else {
+      RcvToken       = (SOCK_IO_TOKEN *)SockToken->Token;
+      TokenRcvdBytes = SockProcessRcvToken (Sock, RcvToken);
+    }
 
-    if (0 == TokenRcvdBytes) {
+    if (!Handoff && (0 == TokenRcvdBytes)) {
       return;
     }
 
@@ -724,6 +902,7 @@ SockCreate (
   // Install protocol on Sock->SockHandle
   //
   CopyMem (&Sock->NetProtocol, SockInitData->Protocol, ProtocolLength);
+  CopyMem (&Sock->FragmentReceive, SockInitData->FragmentReceive, sizeof (EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL));
 
   //
   // copy the protodata into socket
@@ -734,6 +913,8 @@ SockCreate (
                   &Sock->SockHandle,
                   TcpProtocolGuid,
                   &Sock->NetProtocol,
+                  &gEdkiiTcpFragmentReceiveProtocolGuid,
+                  &Sock->FragmentReceive,
                   NULL
                   );
 
@@ -782,6 +963,8 @@ OnError:
            Sock->SockHandle,
            TcpProtocolGuid,
            &Sock->NetProtocol,
+           &gEdkiiTcpFragmentReceiveProtocolGuid,
+           &Sock->FragmentReceive,
            NULL
            );
   }
@@ -951,6 +1134,7 @@ SockClone (
   InitData.DriverBinding   = Sock->DriverBinding;
   InitData.IpVersion       = Sock->IpVersion;
   InitData.Protocol        = &(Sock->NetProtocol);
+  InitData.FragmentReceive = &(Sock->FragmentReceive);
   InitData.CreateCallback  = Sock->CreateCallback;
   InitData.DestroyCallback = Sock->DestroyCallback;
   InitData.Context         = Sock->Context;
@@ -28,6 +28,16 @@
 
 #define SOCK_HEADER_SPACE  (60 + 60 + 72)
 
+///
+/// The data of a fragment receive token, together with the NET_BUFs
+/// the fragments reside in. They are released when RecycleSignal is
+/// signaled.
+///
+typedef struct {
+  LIST_ENTRY                         NbufList;
+  EDKII_TCP_FRAGMENT_RECEIVE_DATA    RxData; ///< Must be the last, FragmentTable grows.
+} SOCK_FRAGMENT_WRAP;
+
 /**
   Process the TCP send data, buffer the tcp txdata and append
   the buffer to socket send buffer, then try to send it.
@@ -60,6 +70,21 @@ SockProcessRcvToken (
   IN OUT SOCK_IO_TOKEN  *RcvToken
   );
 
+/**
+  Hand the received data over to the fragment receive token by reference.
+
+  @param[in, out]  Sock       Pointer to the socket.
+  @param[in, out]  Token      Pointer to the application provided fragment receive token.
+
+  @return The length of data received in this token.
+
+**/
+UINT32
+SockProcessRcvFragmentToken (
+  IN OUT SOCKET                            *Sock,
+  IN OUT EDKII_TCP_FRAGMENT_RECEIVE_TOKEN  *Token
+  );
+
 /**
   Flush the sndBuffer and rcvBuffer of socket.
 
@@ -202,6 +202,8 @@ SockDestroyChild (
          Sock->SockHandle,
          TcpProtocolGuid,
          SockProtocol,
+         &gEdkiiTcpFragmentReceiveProtocolGuid,
+         &Sock->FragmentReceive,
          NULL
          );
 
@@ -333,6 +335,8 @@ ERROR:
          Sock->SockHandle,
          TcpProtocolGuid,
          SockProtocol,
+         &gEdkiiTcpFragmentReceiveProtocolGuid,
+         &Sock->FragmentReceive,
          NULL
          );
   SockDestroy (Sock);
@@ -683,11 +687,13 @@ Exit:
 }
 
 /**
-  Issue a token to get data from the socket.
+  Issue a receive token or a fragment receive token to get data from the socket.
 
   @param[in]  Sock             Pointer to the socket to get data from.
   @param[in]  Token            The token to store the received data from the
                                socket.
+  @param[in]  Handoff          If TRUE, Token is an EDKII_TCP_FRAGMENT_RECEIVE_TOKEN
+                               and the data is handed over by reference.
 
   @retval EFI_SUCCESS          The token processed successfully.
   @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket, or the
@@ -702,12 +708,14 @@ Exit:
 
 **/
 EFI_STATUS
-SockRcv (
-  IN SOCKET  *Sock,
-  IN VOID    *Token
+SockRcvToken (
+  IN SOCKET   *Sock,
+  IN VOID     *Token,
+  IN BOOLEAN  Handoff
   )
 {
   SOCK_IO_TOKEN  *RcvToken;
+  SOCK_TOKEN     *SockToken;
   UINT32         RcvdBytes;
   EFI_STATUS     Status;
   EFI_EVENT      Event;
@@ -718,7 +726,7 @@ SockRcv (
   if (EFI_ERROR (Status)) {
     DEBUG (
       (DEBUG_ERROR,
-       "SockRcv: Get the access for socket failed with %r",
+       "SockRcvToken: Get the access for socket failed with %r",
        Status)
       );
 
@@ -740,6 +748,9 @@ SockRcv (
     goto Exit;
   }
 
+  //
+  // Both kinds of tokens start with the completion token.
+  //
   RcvToken = (SOCK_IO_TOKEN *)Token;
 
   //
@@ -773,12 +784,19 @@ SockRcv (
   }
 
   if (RcvdBytes != 0) {
-    SockProcessRcvToken (Sock, RcvToken);
+    if (Handoff) {
+      SockProcessRcvFragmentToken (Sock, (EDKII_TCP_FRAGMENT_RECEIVE_TOKEN *)Token);
+    } else {
+      SockProcessRcvToken (Sock, RcvToken);
+    }
 
     Status = Sock->ProtoHandler (Sock, SOCK_CONSUMED, NULL);
   } else {
-    if (NULL == SockBufferToken (Sock, &Sock->RcvTokenList, RcvToken, 0)) {
+    SockToken = SockBufferToken (Sock, &Sock->RcvTokenList, RcvToken, 0);
+    if (NULL == SockToken) {
       Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      SockToken->Handoff = Handoff;
     }
   }
 
@@ -787,6 +805,54 @@ Exit:
   return Status;
 }
 
+/**
+  Issue a token to get data from the socket.
+
+  @param[in]  Sock             Pointer to the socket to get data from.
+  @param[in]  Token            The token to store the received data from the
+                               socket.
+
+  @retval EFI_SUCCESS          The token processed successfully.
+  @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket, or the
+                               socket is closed, or the socket is not in a
+                               synchronized state , or the token is already in one
+                               of this socket's lists.
+  @retval EFI_NO_MAPPING       The IP address configuration operation is not
+                               finished.
+  @retval EFI_NOT_STARTED      The socket is not configured.
+  @retval EFI_CONNECTION_FIN   The connection is closed and there is no more data.
+  @retval EFI_OUT_OF_RESOURCE  Failed to buffer the token due to memory limit.
+
+**/
+EFI_STATUS
+SockRcv (
+  IN SOCKET  *Sock,
+  IN VOID    *Token
+  )
+{
+  return SockRcvToken (Sock, Token, FALSE);
+}
+
+/**
+  Issue a token to get data from the socket by reference. The data is
+  handed over in the NET_BUFs it was received in, without copy.
+
+  @param[in]  Sock             Pointer to the socket to get data from.
+  @param[in]  Token            The fragment receive token.
+
+  @retval EFI_SUCCESS          The token processed successfully.
+  @retval Others               The same errors as SockRcv().
+
+**/
+EFI_STATUS
+SockRcvFragments (
+  IN SOCKET                            *Sock,
+  IN EDKII_TCP_FRAGMENT_RECEIVE_TOKEN  *Token
+  )
+{
+  return SockRcvToken (Sock, Token, TRUE);
+}
+
 /**
   Reset the socket and its associated protocol control block.
 
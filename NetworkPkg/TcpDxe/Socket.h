@@ -14,6 +14,7 @@
 
 #include <Protocol/Tcp4.h>
 #include <Protocol/Tcp6.h>
+#include <Protocol/TcpFragmentReceive.h>
 
 #include <Library/NetLib.h>
 #include <Library/DebugLib.h>
@@ -315,6 +316,8 @@
 
 #define SOCK_FROM_THIS(a)  CR ((a), SOCKET, NetProtocol, SOCK_SIGNATURE)
 
+#define SOCK_FROM_FRAGMENT_RECEIVE(a)  CR ((a), SOCKET, FragmentReceive, SOCK_SIGNATURE)
+
 #define SOCK_FROM_TOKEN(Token)  (((SOCK_TOKEN *) (Token))->Sock)
 
 #define PROTO_TOKEN_FORM_SOCK(SockToken, Type)  ((Type *) (((SOCK_TOKEN *) (SockToken))->Token))
@@ -424,6 +427,8 @@ typedef struct _SOCK_INIT_DATA {
   UINT8                    IpVersion;
   VOID                     *Protocol;    ///< The pointer to protocol function template
                                          ///< wanted to install on socket
+  VOID                     *FragmentReceive; ///< The pointer to the fragment receive
+                                             ///< protocol template
 
   //
   // Callbacks after socket is created and before socket is to be destroyed.
@@ -457,52 +462,55 @@ struct _TCP_SOCKET {
   //
   // Socket description information
   //
-  UINT32                      Signature;     ///< Signature of the socket
-  EFI_HANDLE                  SockHandle;    ///< The virtual handle of the socket
-  EFI_HANDLE                  DriverBinding; ///< Socket's driver binding protocol
-  EFI_DEVICE_PATH_PROTOCOL    *ParentDevicePath;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  LIST_ENTRY                  Link;
-  UINT8                       ConfigureState;
-  SOCK_TYPE                   Type;
-  UINT8                       State;
-  UINT16                      Flag;
-  EFI_LOCK                    Lock;         ///< The lock of socket
-  SOCK_BUFFER                 SndBuffer;    ///< Send buffer of application's data
-  SOCK_BUFFER                 RcvBuffer;    ///< Receive buffer of received data
-  EFI_STATUS                  SockError;    ///< The error returned by low layer protocol
-  BOOLEAN                     InDestroy;
+  UINT32                                 Signature;     ///< Signature of the socket
+  EFI_HANDLE                             SockHandle;    ///< The virtual handle of the socket
+  EFI_HANDLE                             DriverBinding; ///< Socket's driver binding protocol
+  EFI_DEVICE_PATH_PROTOCOL               *ParentDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL               *DevicePath;
+  LIST_ENTRY                             Link;
+  UINT8                                  ConfigureState;
+  SOCK_TYPE                              Type;
+  UINT8                                  State;
+  UINT16                                 Flag;
+  EFI_LOCK                               Lock;         ///< The lock of socket
+  SOCK_BUFFER                            SndBuffer;    ///< Send buffer of application's data
+  SOCK_BUFFER                            RcvBuffer;    ///< Receive buffer of received data
+  EFI_STATUS                             SockError;    ///< The error returned by low layer protocol
+  BOOLEAN                                InDestroy;
 
   //
   // Fields used to manage the connection request
   //
-  UINT32                      BackLog;        ///< the limit of connection to this socket
-  UINT32                      ConnCnt;        ///< the current count of connections to it
-  SOCKET                      *Parent;        ///< listening parent that accept the connection
-  LIST_ENTRY                  ConnectionList; ///< the connections maintained by this socket
+  UINT32                                 BackLog;        ///< the limit of connection to this socket
+  UINT32                                 ConnCnt;        ///< the current count of connections to it
+  SOCKET                                 *Parent;        ///< listening parent that accept the connection
+  LIST_ENTRY                             ConnectionList; ///< the connections maintained by this socket
   //
   // The queue to buffer application's asynchronous token
   //
-  LIST_ENTRY                  ListenTokenList;
-  LIST_ENTRY                  RcvTokenList;
-  LIST_ENTRY                  SndTokenList;
-  LIST_ENTRY                  ProcessingSndTokenList;
+  LIST_ENTRY                             ListenTokenList;
+  LIST_ENTRY                             RcvTokenList;
+  LIST_ENTRY                             SndTokenList;
+  LIST_ENTRY                             ProcessingSndTokenList;
 
-  SOCK_COMPLETION_TOKEN       *ConnectionToken; ///< app's token to signal if connected
-  SOCK_COMPLETION_TOKEN       *CloseToken;      ///< app's token to signal if closed
+  SOCK_COMPLETION_TOKEN                  *ConnectionToken; ///< app's token to signal if connected
+  SOCK_COMPLETION_TOKEN                  *CloseToken;      ///< app's token to signal if closed
   //
   // Interface for low level protocol
   //
-  SOCK_PROTO_HANDLER          ProtoHandler;                      ///< The request handler of protocol
-  UINT8                       ProtoReserved[PROTO_RESERVED_LEN]; ///< Data fields reserved for protocol
-  UINT8                       IpVersion;
-  NET_PROTOCOL                NetProtocol;                      ///< TCP4 or TCP6 protocol socket used
+  SOCK_PROTO_HANDLER                     ProtoHandler;                      ///< The request handler of protocol
+  UINT8                                  ProtoReserved[PROTO_RESERVED_LEN]; ///< Data fields reserved for protocol
+  UINT8                                  IpVersion;
+  NET_PROTOCOL                           NetProtocol;                      ///< TCP4 or TCP6 protocol socket used
+  EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL    FragmentReceive;     ///< Receive data by reference
+  UINT64                                 RcvCopiedBytes;      ///< Data copied to receive tokens
+  UINT64                                 RcvByReferenceBytes; ///< Data handed over by reference
   //
   // Callbacks after socket is created and before socket is to be destroyed.
   //
-  SOCK_CREATE_CALLBACK        CreateCallback;  ///< Callback after created
-  SOCK_DESTROY_CALLBACK       DestroyCallback; ///< Callback before destroyed
-  VOID                        *Context;        ///< The context of the callback
+  SOCK_CREATE_CALLBACK                   CreateCallback;  ///< Callback after created
+  SOCK_DESTROY_CALLBACK                  DestroyCallback; ///< Callback before destroyed
+  VOID                                   *Context;        ///< The context of the callback
 };
 
 ///
@@ -512,6 +520,7 @@ typedef struct _SOCK_TOKEN {
   LIST_ENTRY               TokenList;     ///< The entry to add in the token list
   SOCK_COMPLETION_TOKEN    *Token;        ///< The application's token
   UINT32                   RemainDataLen; ///< Unprocessed data length
+  BOOLEAN                  Handoff;       ///< A fragment receive token
   SOCKET                   *Sock;         ///< The pointer to the socket this token
                                           ///< belongs to
 } SOCK_TOKEN;
@@ -818,6 +827,23 @@ SockRcv (
   IN VOID    *Token
   );
 
+/**
+  Issue a token to get data from the socket by reference. The data is
+  handed over in the NET_BUFs it was received in, without copy.
+
+  @param[in]  Sock             Pointer to the socket to get data from.
+  @param[in]  Token            The fragment receive token.
+
+  @retval EFI_SUCCESS          The token processed successfully.
+  @retval Others               The same errors as SockRcv().
+
+**/
+EFI_STATUS
+SockRcvFragments (
+  IN SOCKET                            *Sock,
+  IN EDKII_TCP_FRAGMENT_RECEIVE_TOKEN  *Token
+  );
+
 /**
   Reset the socket and its associated protocol control block.
 
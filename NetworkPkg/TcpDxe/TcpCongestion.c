@@ -0,0 +1,283 @@
+/** @file
+  TCP congestion control algorithms.
+
+  NewReno (RFC5681) keeps the behavior TcpDxe always had. CUBIC (RFC8312)
+  grows the window as a cubic function of the time since the last
+  congestion event, independent of the RTT, so that long fat paths get
+  back to their previous window quickly after a loss. The algorithm is
+  selected by PcdTcpCongestionControl.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC constants, RFC8312 section 5. The multiplicative decrease
+// factor is TCP_CUBIC_BETA / 10, and C = 0.4 is folded into
+// TCP_CUBIC_C_DIV: with time in milliseconds,
+// W(t) = C * t^3 = t^3 / 2500000000 segments.
+//
+#define TCP_CUBIC_BETA       7
+#define TCP_CUBIC_C_DIV      2500000000U
+#define TCP_CUBIC_MAX_DELTA  1000000      ///< Limit of |t - K| to avoid overflow, in ms.
+#define TCP_CUBIC_MAX_ROOT   2642245      ///< The cube root of MAX_UINT64.
+
+/**
+  Initialize the NewReno state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpNewRenoInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  ZeroMem (&Tcb->CongestData, sizeof (TCP_CONGEST_DATA));
+}
+
+/**
+  Compute the NewReno slow start threshold, half of the data in flight.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+UINT32
+TcpNewRenoSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  NewReno slow start and congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    Number of bytes newly acknowledged.
+
+**/
+VOID
+TcpNewRenoCongAvoid (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Compute the integer cube root of a 64 bit value.
+
+  @param[in]  Value     The value.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Bit;
+  UINT64  Try;
+
+  //
+  // Set the result bit by bit from bit 21, since the
+  // cube root of a 64 bit value is less than 2^22. The
+  // cube of a larger Try would overflow.
+  //
+  Root = 0;
+  for (Bit = 1U << 21; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+    if ((Try <= TCP_CUBIC_MAX_ROOT) && (MultU64x64 (MultU64x64 (Try, Try), Try) <= Value)) {
+      Root = Try;
+    }
+  }
+
+  return (UINT32)Root;
+}
+
+/**
+  Initialize the CUBIC state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  ZeroMem (&Tcb->CongestData, sizeof (TCP_CONGEST_DATA));
+}
+
+/**
+  Record the window of the congestion event and compute the CUBIC
+  slow start threshold, a fraction of the congestion window as RFC8312
+  defines. Fast convergence releases bandwidth to new flows when the
+  window keeps shrinking.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  TCP_CUBIC  *Cubic;
+  UINT32     Segments;
+
+  Cubic             = &Tcb->CongestData.Cubic;
+  Cubic->EpochStart = 0;
+
+  Segments = Tcb->CWnd / Tcb->SndMss;
+  if (Segments < Cubic->LastWMax) {
+    Cubic->WMax = Segments * (10 + TCP_CUBIC_BETA) / 20;
+  } else {
+    Cubic->WMax = Segments;
+  }
+
+  Cubic->LastWMax = Segments;
+
+  return MAX (Tcb->CWnd / 10 * TCP_CUBIC_BETA, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  CUBIC slow start and congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    Number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCubicCongAvoid (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  TCP_CUBIC  *Cubic;
+  UINT32     Segments;
+  UINT32     Time;
+  UINT32     Delta;
+  UINT64     Offset;
+  UINT64     Target;
+  UINT64     Increase;
+
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+    return;
+  }
+
+  Cubic = &Tcb->CongestData.Cubic;
+
+  //
+  // Start a new epoch on the first ACK after a congestion event.
+  //
+  if (Cubic->EpochStart == 0) {
+    Cubic->EpochStart = (mTcpTick != 0) ? mTcpTick : 1;
+    Cubic->WEst       = Tcb->CWnd;
+
+    Segments = Tcb->CWnd / Tcb->SndMss;
+    if (Segments < Cubic->WMax) {
+      Cubic->K           = TcpCubicRoot (MultU64x32 (Cubic->WMax - Segments, TCP_CUBIC_C_DIV));
+      Cubic->OriginPoint = Cubic->WMax;
+    } else {
+      Cubic->K           = 0;
+      Cubic->OriginPoint = Segments;
+    }
+  }
+
+  //
+  // Compute the target window one RTT ahead, W(t + RTT).
+  //
+  Time = (TCP_SUB_TIME (mTcpTick, Cubic->EpochStart) + (Tcb->SRtt >> TCP_RTT_SHIFT)) * TCP_TICK;
+  if (Time > Cubic->K) {
+    Delta = MIN (Time - Cubic->K, TCP_CUBIC_MAX_DELTA);
+  } else {
+    Delta = MIN (Cubic->K - Time, TCP_CUBIC_MAX_DELTA);
+  }
+
+  Offset = DivU64x32 (MultU64x64 (MultU64x32 (Delta, Delta), Delta), TCP_CUBIC_C_DIV);
+  if (Time > Cubic->K) {
+    Target = Cubic->OriginPoint + Offset;
+  } else {
+    Target = (Cubic->OriginPoint > Offset) ? Cubic->OriginPoint - Offset : 0;
+  }
+
+  Target = MultU64x32 (Target, Tcb->SndMss);
+
+  //
+  // Reach the target in one RTT, but grow at most 1.5 times per RTT.
+  // Probe very slowly when the target is not above the current window.
+  //
+  if (Target > Tcb->CWnd) {
+    Increase = DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Acked), Tcb->CWnd);
+    Increase = MIN (Increase, Acked / 2);
+  } else {
+    Increase = DivU64x32 (DivU64x32 (MultU64x32 (Tcb->SndMss, Acked), Tcb->CWnd), 100);
+  }
+
+  //
+  // TCP friendly region: never grow slower than the standard TCP
+  // with the same beta would, which adds 3 * (1 - beta) / (1 + beta),
+  // that is 9/17 segment per RTT.
+  //
+  Cubic->WEst += (UINT32)DivU64x32 (DivU64x32 (MultU64x32 (9 * (UINT32)Tcb->SndMss, Acked), 17), Tcb->CWnd);
+  if (Cubic->WEst > Tcb->CWnd) {
+    Increase = MAX (Increase, DivU64x32 (MultU64x32 (Cubic->WEst - Tcb->CWnd, Acked), Tcb->CWnd));
+  }
+
+  Tcb->CWnd += (UINT32)MAX (Increase, 1);
+}
+
+TCP_CONGEST_OPS  mTcpNewRenoOps = {
+  "NewReno",
+  TcpNewRenoInit,
+  TcpNewRenoSsthresh,
+  TcpNewRenoCongAvoid
+};
+
+TCP_CONGEST_OPS  mTcpCubicOps = {
+  "CUBIC",
+  TcpCubicInit,
+  TcpCubicSsthresh,
+  TcpCubicCongAvoid
+};
+
+/**
+  Get the congestion control algorithm selected by PcdTcpCongestionControl.
+
+  @return The operations of the congestion control algorithm.
+
+**/
+TCP_CONGEST_OPS *
+TcpGetCongestOps (
+  VOID
+  )
+{
+  switch (PcdGet8 (PcdTcpCongestionControl)) {
+    case TCP_CONGEST_ALGO_CUBIC:
+      return &mTcpCubicOps;
+
+    default:
+      return &mTcpNewRenoOps;
+  }
+}
@@ -42,6 +42,11 @@ EFI_TCP6_PROTOCOL  gTcp6ProtocolTemplate = {
   Tcp6Poll
 };
 
+EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  gTcpFragmentReceiveTemplate = {
+  TcpFragmentReceive,
+  TcpGetReceiveStatistics
+};
+
 SOCK_INIT_DATA  mTcpDefaultSockData = {
   SockStream,
   SO_CLOSED,
@@ -51,6 +56,7 @@ SOCK_INIT_DATA  mTcpDefaultSockData = {
   TCP_RCV_BUF_SIZE,
   IP_VERSION_4,
   NULL,
+  &gTcpFragmentReceiveTemplate,
   TcpCreateSocketCallback,
   TcpDestroySocketCallback,
   NULL,
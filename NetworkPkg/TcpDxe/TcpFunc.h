@@ -354,6 +354,24 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the lost segments on the SACK scoreboard during fast recovery,
+  as long as the estimated data in flight is less than the congestion window.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Force   If TRUE, retransmit the first lost segment even if
+                           the congestion window is full.
+
+  @retval 0       The retransmission succeeded.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB   *Tcb,
+  IN     BOOLEAN  Force
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -493,6 +511,102 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Build the SACK blocks that describe the out-of-order data in RcvQue.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block    The buffer to return the SACK blocks.
+  @param[in]   Max      The maximum number of blocks to return.
+
+  @return The number of SACK blocks returned.
+
+**/
+UINTN
+TcpSackBuildBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINTN           Max
+  );
+
+/**
+  Update the SACK scoreboard with the SACK blocks received.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge number of the received segment.
+  @param[in]       Option   The options of the received segment.
+
+  @retval TRUE     Some data is newly SACKed.
+  @retval FALSE    No data is newly SACKed.
+
+**/
+BOOLEAN
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Discard the SACK scoreboard.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Mark the lost segments and estimate the data in flight.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The estimated number of bytes in flight, also kept in Tcb->Pipe.
+
+**/
+UINT32
+TcpSackSetPipe (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Find the next lost segment to retransmit.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Seq      The first sequence to retransmit.
+  @param[out]  End      The end of the segment containing Seq.
+
+  @retval TRUE     A lost segment is found.
+  @retval FALSE    Nothing needs to be retransmitted.
+
+**/
+BOOLEAN
+TcpSackNextSeg (
+  IN  TCP_CB     *Tcb,
+  OUT TCP_SEQNO  *Seq,
+  OUT TCP_SEQNO  *End
+  );
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Get the congestion control algorithm selected by PcdTcpCongestionControl.
+
+  @return The operations of the congestion control algorithm.
+
+**/
+TCP_CONGEST_OPS *
+TcpGetCongestOps (
+  VOID
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -30,7 +30,9 @@ TcpSeqAcceptable (
 }
 
 /**
-  NewReno fast recovery defined in RFC3782.
+  NewReno fast recovery defined in RFC3782. If SACK is permitted, the
+  window is managed as RFC6675 instead, and the holes are retransmitted
+  by TcpSackRetransmit after SndUna is updated.
 
   @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
   @param[in]       Seg      Segment that triggers the fast recovery.
@@ -52,14 +54,30 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
 
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+      //
+      // RFC6675 step 4: set CWnd to the reduced ssthresh and
+      // retransmit the first lost segment regardless of it.
+      //
+      Tcb->CWnd    = Tcb->Ssthresh;
+      Tcb->HighRxt = Tcb->SndUna;
+      TcpSackRetransmit (Tcb, TRUE);
+
+      DEBUG (
+        (DEBUG_NET,
+         "TcpFastRecover: enter SACK recovery for TCB %p, recover point is %d\n",
+         Tcb,
+         Tcb->Recover)
+        );
+      return;
+    }
+
     //
     // Step 2: Entering fast retransmission
     //
@@ -85,9 +103,14 @@ TcpFastRecover (
     //
 
     // Step 4 is skipped here only to be executed later
-    // by TcpToSendData
+    // by TcpToSendData. In SACK recovery the window is
+    // not inflated, the data that left the network is
+    // deducted from the pipe instead.
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -115,7 +138,7 @@ TcpFastRecover (
          Seg->Ack,
          Tcb)
         );
-    } else {
+    } else if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
@@ -179,9 +202,14 @@ TcpFastLossRecover (
     } else {
       //
       // Partial ACK:
-      // fast retransmit the first unacknowledge field.
+      // fast retransmit the first unacknowledge field. With
+      // SACK, TcpSackRetransmit sends the holes after SndUna
+      // is updated.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       DEBUG (
         (DEBUG_NET,
          "TcpFastLossRecover: received a partial ACK(%d) for TCB %p\n",
@@ -563,6 +591,12 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  //
+  // Remember the latest segment, it is reported in the
+  // first SACK block if it is out of order.
+  //
+  Tcb->RcvSackSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1207,9 +1241,24 @@ TcpInput (
     TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
   }
 
+  //
+  // Update the SACK scoreboard.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK))
+  {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
+  //
+  // Restart the retransmission timer only when new data is ACKed,
+  // RFC6298 section 5.3. Otherwise the duplicate ACKs keep pushing
+  // it back, and a lost retransmission is never recovered while
+  // new data is still being sent.
+  //
   if (Seg->Ack == Tcb->SndNxt) {
     TcpClearTimer (Tcb, TCP_TIMER_REXMIT);
-  } else {
+  } else if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
@@ -1229,15 +1278,11 @@ TcpInput (
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
-  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
+  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < TCP_DUPACK_THRESHOLD)) ||
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
+      Tcb->CongestOps->CongAvoid (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
     }
@@ -1269,6 +1314,13 @@ TcpInput (
     }
   }
 
+  //
+  // Retransmit the holes on the scoreboard in SACK recovery.
+  //
+  if (TCP_IN_SACK_RECOVERY (Tcb)) {
+    TcpSackRetransmit (Tcb, FALSE);
+  }
+
   //
   // Update window info
   //
@@ -163,7 +163,7 @@ Tcp4Configure (
     }
 
     Option = TcpConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) && Option->EnablePathMtuDiscovery) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -698,7 +698,7 @@ Tcp6Configure (
     }
 
     Option = Tcp6ConfigData->ControlOption;
-    if ((NULL != Option) && (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) && Option->EnablePathMtuDiscovery) {
       return EFI_UNSUPPORTED;
     }
   }
@@ -1106,3 +1106,66 @@ Tcp6Poll (
 
   return Status;
 }
+
+/**
+  Place an asynchronous request to receive data by reference.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[in]  Token                Pointer to the fragment receive token.
+
+  @retval EFI_SUCCESS              The receive token was queued or completed.
+  @retval EFI_INVALID_PARAMETER    This or Token is NULL, Token->CompletionToken.Event
+                                   is NULL or Token->MaxLength is 0.
+  @retval Others                   The same errors as Tcp4Receive() and Tcp6Receive().
+
+**/
+EFI_STATUS
+EFIAPI
+TcpFragmentReceive (
+  IN EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  IN EDKII_TCP_FRAGMENT_RECEIVE_TOKEN     *Token
+  )
+{
+  if ((NULL == This) ||
+      (NULL == Token) ||
+      (NULL == Token->CompletionToken.Event) ||
+      (0 == Token->MaxLength)
+      )
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return SockRcvFragments (SOCK_FROM_FRAGMENT_RECEIVE (This), Token);
+}
+
+/**
+  Get the number of bytes the TCP instance has delivered by copy and by
+  reference since it was created.
+
+  @param[in]   This                Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+TcpGetReceiveStatistics (
+  IN  EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  OUT EDKII_TCP_RECEIVE_STATISTICS         *Statistics
+  )
+{
+  SOCKET  *Sock;
+
+  if ((NULL == This) || (NULL == Statistics)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Sock = SOCK_FROM_FRAGMENT_RECEIVE (This);
+
+  Statistics->BytesCopied      = Sock->RcvCopiedBytes;
+  Statistics->BytesByReference = Sock->RcvByReferenceBytes;
+
+  return EFI_SUCCESS;
+}
@@ -17,6 +17,7 @@
 #include <Library/IpIoLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 
 #include "Socket.h"
 #include "TcpProto.h"
@@ -767,6 +768,43 @@ Tcp6Poll (
   IN EFI_TCP6_PROTOCOL  *This
   );
 
+/**
+  Place an asynchronous request to receive data by reference.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[in]  Token                Pointer to the fragment receive token.
+
+  @retval EFI_SUCCESS              The receive token was queued or completed.
+  @retval EFI_INVALID_PARAMETER    This or Token is NULL, Token->CompletionToken.Event
+                                   is NULL or Token->MaxLength is 0.
+  @retval Others                   The same errors as Tcp4Receive() and Tcp6Receive().
+
+**/
+EFI_STATUS
+EFIAPI
+TcpFragmentReceive (
+  IN EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  IN EDKII_TCP_FRAGMENT_RECEIVE_TOKEN     *Token
+  );
+
+/**
+  Get the number of bytes the TCP instance has delivered by copy and by
+  reference since it was created.
+
+  @param[in]   This                Pointer to the EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL instance.
+  @param[out]  Statistics          The receive statistics.
+
+  @retval EFI_SUCCESS              The statistics are returned.
+  @retval EFI_INVALID_PARAMETER    This or Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+TcpGetReceiveStatistics (
+  IN  EDKII_TCP_FRAGMENT_RECEIVE_PROTOCOL  *This,
+  OUT EDKII_TCP_RECEIVE_STATISTICS         *Statistics
+  );
+
 /**
   Retrieves the Initial Sequence Number (ISN) for a TCP connection identified by local
   and remote IP addresses and ports.
@@ -160,6 +160,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when configured
+  // to use SACK, and either we are doing active open
+  // or the peer has permitted SACK.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -187,11 +209,16 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK];
+  UINTN           Count;
+  UINTN           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
+  Seg = TCPSEG_NETBUF (Nbuf);
 
   //
   // Build the Timestamp option.
@@ -214,6 +241,41 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Report the out-of-order data in RcvQue with SACK blocks. The
+  // blocks are only added to pure ACKs, so that the option space
+  // never has to be taken from SndMss. Nbuf holds nothing but the
+  // options built so far on a pure ACK.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK) &&
+      (Nbuf->TotalSize == Len) &&
+      !TCP_FLG_ON (Seg->Flag, TCP_FLG_SYN | TCP_FLG_FIN | TCP_FLG_RST)
+      )
+  {
+    Count = TcpSackBuildBlocks (
+              Tcb,
+              Block,
+              (Len == 0) ? TCP_OPTION_MAX_SACK : TCP_OPTION_MAX_SACK - 1
+              );
+
+    if (Count != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               4 + (UINT32)Count * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16)(Len + 4 + Count * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST (Count));
+      for (Index = 0; Index < Count; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,10 +301,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINTN  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +375,56 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        if (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN) {
+          return -1;
+        }
+
+        Len = Head[Cur + 1];
+
+        if (Len != TCP_OPTION_SACK_PERM_LEN) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        if (TotalLen - Cur < 2) {
+          return -1;
+        }
+
+        Len = Head[Cur + 1];
+
+        if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            (((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN) != 0) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        //
+        // Ignore a second SACK option, the first one carries
+        // the most recent information.
+        //
+        if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+          Index = Cur + 2;
+          while ((Index < (UINTN)Cur + Len) && (Option->SackCount < TCP_OPTION_MAX_SACK)) {
+            Option->SackBlock[Option->SackCount].Left  = TcpGetUint32 (&Head[Index]);
+            Option->SackBlock[Option->SackCount].Right = TcpGetUint32 (&Head[Index + 4]);
+            Option->SackCount++;
+
+            Index += TCP_OPTION_SACK_BLOCK_LEN;
+          }
+
+          TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+        }
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
@@ -168,11 +168,12 @@ TcpDataToSend (
   IN INTN    Force
   )
 {
-  SOCKET  *Sk;
-  UINT32  Win;
-  UINT32  Len;
-  UINT32  Left;
-  UINT32  Limit;
+  SOCKET     *Sk;
+  UINT32     Win;
+  UINT32     Len;
+  UINT32     Left;
+  UINT32     Limit;
+  TCP_SEQNO  CongLimit;
 
   Sk = Tcb->Sk;
   ASSERT (Sk != NULL);
@@ -182,13 +183,20 @@ TcpDataToSend (
   // and congestion window. The right edge of send
   // window is defined as SND.WL2 + SND.WND. The right
   // edge of congestion window is defined as SND.UNA +
-  // CWND.
+  // CWND. In SACK based recovery, it is the data in
+  // flight that is limited by CWND, as RFC6675 defines.
   //
   Win   = 0;
   Limit = Tcb->SndWl2 + Tcb->SndWnd;
 
-  if (TCP_SEQ_GT (Limit, Tcb->SndUna + Tcb->CWnd)) {
-    Limit = Tcb->SndUna + Tcb->CWnd;
+  if (TCP_IN_SACK_RECOVERY (Tcb)) {
+    CongLimit = Tcb->SndNxt + ((Tcb->CWnd > Tcb->Pipe) ? Tcb->CWnd - Tcb->Pipe : 0);
+  } else {
+    CongLimit = Tcb->SndUna + Tcb->CWnd;
+  }
+
+  if (TCP_SEQ_GT (Limit, CongLimit)) {
+    Limit = CongLimit;
   }
 
   if (TCP_SEQ_GT (Limit, Tcb->SndNxt)) {
@@ -567,8 +575,9 @@ TcpGetSegmentSock (
 
   NET_GET_REF (Nbuf);
 
-  TCPSEG_NETBUF (Nbuf)->Seq = Seq;
-  TCPSEG_NETBUF (Nbuf)->End = Seq + Len;
+  TCPSEG_NETBUF (Nbuf)->Seq  = Seq;
+  TCPSEG_NETBUF (Nbuf)->End  = Seq + Len;
+  TCPSEG_NETBUF (Nbuf)->Sack = 0;
 
   InsertTailList (&(Tcb->SndQue), &(Nbuf->List));
 
@@ -712,6 +721,53 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the lost segments on the SACK scoreboard during fast recovery,
+  as long as the estimated data in flight is less than the congestion window.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Force   If TRUE, retransmit the first lost segment even if
+                           the congestion window is full.
+
+  @retval 0       The retransmission succeeded.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB   *Tcb,
+  IN     BOOLEAN  Force
+  )
+{
+  TCP_SEQNO  Seq;
+  TCP_SEQNO  End;
+  UINT32     Len;
+
+  TcpSackSetPipe (Tcb);
+
+  while (TcpSackNextSeg (Tcb, &Seq, &End)) {
+    if (!Force && (Tcb->Pipe + Tcb->SndMss > Tcb->CWnd)) {
+      break;
+    }
+
+    Force = FALSE;
+
+    if (TcpRetransmit (Tcb, Seq) != 0) {
+      return -1;
+    }
+
+    //
+    // TcpRetransmit sends at most one SndMss, and never
+    // crosses the boundary of the segment on SndQue.
+    //
+    Len          = MIN (TCP_SUB_SEQ (End, Seq), Tcb->SndMss);
+    Tcb->HighRxt = Seq + Len;
+    Tcb->Pipe   += Len;
+  }
+
+  return 0;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
@@ -902,6 +958,10 @@ TcpToSendData (
 
     Sent += TCP_SUB_SEQ (End, Seq);
 
+    if (TCP_IN_SACK_RECOVERY (Tcb)) {
+      Tcb->Pipe += TCP_SUB_SEQ (End, Seq);
+    }
+
     //
     // All the buffers in the SndQue are headless.
     //
@@ -52,6 +52,17 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+#define TCP_DUPACK_THRESHOLD  3     ///< Duplicate ACKs to trigger fast retransmission.
+
+//
+// Whether the loss recovery is driven by the SACK scoreboard, in fast
+// recovery as well as after a retransmission timeout.
+//
+#define TCP_IN_SACK_RECOVERY(Tcb)                   \
+  (TCP_FLG_ON ((Tcb)->CtrlFlag, TCP_CTRL_SACK) &&  \
+   (((Tcb)->CongestState == TCP_CONGEST_RECOVER) || \
+    ((Tcb)->CongestState == TCP_CONGEST_LOSS)))
+
 //
 // TCP control flags
 //
@@ -70,6 +81,14 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_SACK          0x10000  ///< SACK is permitted by both ends.
+
+//
+// Congestion control algorithms, the value of PcdTcpCongestionControl.
+//
+#define TCP_CONGEST_ALGO_NEWRENO  0
+#define TCP_CONGEST_ALGO_CUBIC    1
 
 //
 // Timer related values
@@ -212,10 +231,17 @@ typedef struct _TCP_SEG {
   TCP_SEQNO    End;  ///< The sequence of the last byte + 1, include SYN/FIN. End-Seq = SEG.LEN.
   TCP_SEQNO    Ack;  ///< ACK field in the segment.
   UINT8        Flag; ///< TCP header flags.
+  UINT8        Sack; ///< SACK scoreboard state of a segment on SndQue.
   UINT16       Urg;  ///< Valid if URG flag is set.
   UINT32       Wnd;  ///< TCP window size field.
 } TCP_SEG;
 
+//
+// SACK scoreboard state of the segments on SndQue, RFC6675.
+//
+#define TCP_SEG_SACKED  0x01        ///< The segment is covered by a SACK block.
+#define TCP_SEG_LOST    0x02        ///< The segment is deemed lost by the scoreboard.
+
 ///
 /// Network endpoint, IP plus Port structure.
 ///
@@ -226,6 +252,77 @@ typedef struct _TCP_PEER {
 
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
+///
+/// CUBIC state, RFC8312. Windows are in segments, times are in milliseconds.
+///
+typedef struct _TCP_CUBIC {
+  UINT32    WMax;        ///< Window before the last reduction.
+  UINT32    LastWMax;    ///< WMax of the previous congestion event.
+  UINT32    EpochStart;  ///< mTcpTick when the current epoch started, 0 if none.
+  UINT32    K;           ///< Time to grow back to WMax since EpochStart.
+  UINT32    OriginPoint; ///< Window the cubic function is centered at.
+  UINT32    WEst;        ///< Estimated Reno window, in bytes.
+} TCP_CUBIC;
+
+///
+/// Per connection private data of the congestion control algorithm.
+///
+typedef union {
+  TCP_CUBIC    Cubic;
+} TCP_CONGEST_DATA;
+
+/**
+  Initialize the congestion control state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_INIT) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Compute the new slow start threshold on a congestion event, that is
+  entering fast recovery or retransmission timeout.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+typedef
+UINT32
+(*TCP_CONGEST_SSTHRESH) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Grow the congestion window when new data is acknowledged
+  outside of fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    Number of bytes newly acknowledged.
+
+**/
+typedef
+VOID
+(*TCP_CONGEST_AVOID) (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+///
+/// Congestion control algorithm operations.
+///
+typedef struct _TCP_CONGEST_OPS {
+  CHAR8                   *Name;
+  TCP_CONGEST_INIT        Init;
+  TCP_CONGEST_SSTHRESH    Ssthresh;
+  TCP_CONGEST_AVOID       CongAvoid;
+} TCP_CONGEST_OPS;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -306,6 +403,20 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 and RFC6675 variables.
+  // SACK option and scoreboard based loss recovery.
+  //
+  TCP_SEQNO           RcvSackSeq; ///< Seq of the latest segment queued to RcvQue.
+  TCP_SEQNO           HighRxt;    ///< Highest sequence retransmitted in recovery.
+  UINT32              Pipe;       ///< Estimated bytes in flight during recovery.
+
+  //
+  // Congestion control algorithm and its private data.
+  //
+  TCP_CONGEST_OPS     *CongestOps;
+  TCP_CONGEST_DATA    CongestData;
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -0,0 +1,300 @@
+/** @file
+  TCP selective acknowledgment (RFC2018) and the SACK based
+  loss recovery scoreboard (RFC6675).
+
+  The receiver reports the out-of-order data of RcvQue in SACK
+  blocks. The sender keeps its scoreboard on the segments of
+  SndQue: every segment that is completely covered by a received
+  SACK block is marked as SACKed, and the segments that are deemed
+  lost are retransmitted during fast recovery.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Build the SACK blocks that describe the out-of-order data in RcvQue.
+
+  The first block contains the segment received most recently as RFC2018
+  requires, the other blocks follow in sequence order.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block    The buffer to return the SACK blocks.
+  @param[in]   Max      The maximum number of blocks to return.
+
+  @return The number of SACK blocks returned.
+
+**/
+UINTN
+TcpSackBuildBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINTN           Max
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Range;
+  BOOLEAN         InRange;
+  BOOLEAN         HasFirst;
+  UINTN           Count;
+
+  ASSERT ((Tcb != NULL) && (Block != NULL));
+
+  if ((Max == 0) || IsListEmpty (&Tcb->RcvQue)) {
+    return 0;
+  }
+
+  //
+  // Block[0] is reserved for the range holding RcvSackSeq.
+  //
+  Count       = 1;
+  InRange     = FALSE;
+  HasFirst    = FALSE;
+  Range.Left  = 0;
+  Range.Right = 0;
+
+  for (Entry = Tcb->RcvQue.ForwardLink; ; Entry = Entry->ForwardLink) {
+    Seg = NULL;
+    if (Entry != &Tcb->RcvQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      //
+      // Skip the data that is not yet delivered but already in order.
+      //
+      if (TCP_SEQ_LEQ (Seg->End, Tcb->RcvNxt) || (Seg->Seq == Seg->End)) {
+        continue;
+      }
+
+      if (InRange && TCP_SEQ_LEQ (Seg->Seq, Range.Right)) {
+        if (TCP_SEQ_GT (Seg->End, Range.Right)) {
+          Range.Right = Seg->End;
+        }
+
+        continue;
+      }
+    }
+
+    //
+    // The current range is complete, record it.
+    //
+    if (InRange) {
+      if (!HasFirst && TCP_SEQ_LEQ (Range.Left, Tcb->RcvSackSeq) && TCP_SEQ_LT (Tcb->RcvSackSeq, Range.Right)) {
+        CopyMem (&Block[0], &Range, sizeof (TCP_SACK_BLOCK));
+        HasFirst = TRUE;
+      } else if (Count < Max) {
+        CopyMem (&Block[Count], &Range, sizeof (TCP_SACK_BLOCK));
+        Count++;
+      }
+    }
+
+    if (Seg == NULL) {
+      break;
+    }
+
+    Range.Left  = TCP_SEQ_LT (Seg->Seq, Tcb->RcvNxt) ? Tcb->RcvNxt : Seg->Seq;
+    Range.Right = Seg->End;
+    InRange     = TRUE;
+  }
+
+  if (!HasFirst) {
+    //
+    // The most recent segment is already in order, shift the
+    // other blocks down.
+    //
+    Count--;
+    CopyMem (&Block[0], &Block[1], Count * sizeof (TCP_SACK_BLOCK));
+  }
+
+  return Count;
+}
+
+/**
+  Update the SACK scoreboard with the SACK blocks received.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge number of the received segment.
+  @param[in]       Option   The options of the received segment.
+
+  @retval TRUE     Some data is newly SACKed.
+  @retval FALSE    No data is newly SACKed.
+
+**/
+BOOLEAN
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  LIST_ENTRY      *Entry;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  *Block;
+  BOOLEAN         Updated;
+  UINTN           Index;
+
+  ASSERT ((Tcb != NULL) && (Option != NULL));
+
+  Updated = FALSE;
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Block = &Option->SackBlock[Index];
+
+    //
+    // Ignore the D-SACK blocks below the ACK, and the
+    // blocks beyond the data that has been sent.
+    //
+    if (TCP_SEQ_LEQ (Block->Right, Block->Left) ||
+        TCP_SEQ_LEQ (Block->Right, Ack) ||
+        TCP_SEQ_GT (Block->Right, Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      if (TCP_SEQ_GEQ (Seg->Seq, Block->Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_LEQ (Block->Left, Seg->Seq) &&
+          TCP_SEQ_LEQ (Seg->End, Block->Right) &&
+          !TCP_FLG_ON (Seg->Sack, TCP_SEG_SACKED))
+      {
+        Seg->Sack = TCP_SEG_SACKED;
+        Updated   = TRUE;
+      }
+    }
+  }
+
+  return Updated;
+}
+
+/**
+  Discard the SACK scoreboard. RFC2018 requires the sender to
+  ignore the SACK information after a retransmission timeout.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Sack = 0;
+  }
+
+  Tcb->HighRxt = Tcb->SndUna;
+  Tcb->Pipe    = 0;
+}
+
+/**
+  Mark the lost segments and estimate the data in flight, the SetPipe
+  procedure of RFC6675.
+
+  A segment is deemed lost if more than (DupThresh - 1) * SMSS bytes above
+  it are SACKed. In fast recovery the first unacknowledged segment is
+  deemed lost as well, like the partial ACK of NewReno. After a
+  retransmission timeout all the data sent before it that is not SACKed
+  is deemed lost, as RFC6675 section 5.1 suggests.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The estimated number of bytes in flight, also kept in Tcb->Pipe.
+
+**/
+UINT32
+TcpSackSetPipe (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  UINT32      Sacked;
+  UINT32      Len;
+  UINT32      Pipe;
+
+  Sacked = 0;
+  Pipe   = 0;
+
+  for (Entry = Tcb->SndQue.BackLink; Entry != &Tcb->SndQue; Entry = Entry->BackLink) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      continue;
+    }
+
+    Len = TCP_SUB_SEQ (TCP_SEQ_LT (Seg->End, Tcb->SndNxt) ? Seg->End : Tcb->SndNxt, Seg->Seq);
+
+    if (TCP_FLG_ON (Seg->Sack, TCP_SEG_SACKED)) {
+      Sacked += Len;
+      continue;
+    }
+
+    if ((Sacked > (TCP_DUPACK_THRESHOLD - 1) * (UINT32)Tcb->SndMss) ||
+        ((Entry->BackLink == &Tcb->SndQue) && (Tcb->CongestState == TCP_CONGEST_RECOVER)) ||
+        ((Tcb->CongestState == TCP_CONGEST_LOSS) && TCP_SEQ_LT (Seg->Seq, Tcb->LossRecover)))
+    {
+      Seg->Sack = TCP_SEG_LOST;
+    } else {
+      Seg->Sack = 0;
+      Pipe     += Len;
+    }
+
+    if (TCP_SEQ_LT (Seg->Seq, Tcb->HighRxt)) {
+      Pipe += Len;
+    }
+  }
+
+  Tcb->Pipe = Pipe;
+  return Pipe;
+}
+
+/**
+  Find the next lost segment to retransmit, the NextSeg procedure
+  of RFC6675.
+
+  @param[in]   Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Seq      The first sequence to retransmit.
+  @param[out]  End      The end of the segment containing Seq.
+
+  @retval TRUE     A lost segment is found.
+  @retval FALSE    Nothing needs to be retransmitted.
+
+**/
+BOOLEAN
+TcpSackNextSeg (
+  IN  TCP_CB     *Tcb,
+  OUT TCP_SEQNO  *Seq,
+  OUT TCP_SEQNO  *End
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      break;
+    }
+
+    if (!TCP_FLG_ON (Seg->Sack, TCP_SEG_LOST) || TCP_SEQ_LEQ (Seg->End, Tcb->HighRxt)) {
+      continue;
+    }
+
+    *Seq = TCP_SEQ_LT (Seg->Seq, Tcb->HighRxt) ? Tcb->HighRxt : Seg->Seq;
+    *End = Seg->End;
+    return TRUE;
+  }
+
+  return FALSE;
+}
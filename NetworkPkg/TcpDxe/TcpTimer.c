@@ -180,8 +180,6 @@ TcpRexmitTimeout (
   IN OUT TCP_CB  *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG (
     (DEBUG_WARN,
      "TcpRexmitTimeout: transmission timeout for TCB %p\n",
@@ -189,16 +187,24 @@ TcpRexmitTimeout (
     );
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window. The congestion control
+  // algorithm reduces ssthresh from the amount of data
+  // that has been sent but not yet ACKed. Ssthresh is
+  // held constant on repeated timeouts, RFC5681.
   //
-  FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
+  }
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
 
+  //
+  // The receiver may renege on the SACKed data, RFC2018
+  // requires to forget the scoreboard after a timeout.
+  //
+  TcpSackClear (Tcb);
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
     DEBUG (
@@ -216,11 +222,20 @@ TcpRexmitTimeout (
   }
 
   TcpBackoffRto (Tcb);
-  TcpRetransmit (Tcb, Tcb->SndUna);
-  TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
-
   Tcb->CongestState = TCP_CONGEST_LOSS;
 
+  //
+  // With SACK, the lost data is retransmitted from the scoreboard
+  // as the ACKs arrive, starting with the first segment now.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SACK)) {
+    TcpSackRetransmit (Tcb, TRUE);
+  } else {
+    TcpRetransmit (Tcb, Tcb->SndUna);
+  }
+
+  TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
+
   TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
 }
 
@@ -74,6 +74,10 @@ TlsConfigurationSetData (
       Status = EFI_UNSUPPORTED;
   }
 
+  if (!EFI_ERROR (Status)) {
+    TlsSessionCacheKeyUpdate (Instance, TLS_SESSION_KEY_CONFIG_TAG (DataType), Data, DataSize);
+  }
+
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -30,6 +30,15 @@ TlsCleanInstance (
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+    }
+
+    if (Instance->ConfigHashContext != NULL) {
+      FreePool (Instance->ConfigHashContext);
+    }
+
+    ZeroMem (&Instance->SessionKey, sizeof (Instance->SessionKey));
     FreePool (Instance);
   }
 }
@@ -69,6 +78,16 @@ TlsCreateInstance (
 
   TlsInstance->TlsSessionState = EfiTlsSessionNotStarted;
 
+  //
+  // Without SHA-256 the configuration can't be told apart, and the sessions
+  // of the instance are not cached.
+  //
+  TlsInstance->ConfigHashContext = AllocatePool (Sha256GetContextSize ());
+  if ((TlsInstance->ConfigHashContext != NULL) && !Sha256Init (TlsInstance->ConfigHashContext)) {
+    FreePool (TlsInstance->ConfigHashContext);
+    TlsInstance->ConfigHashContext = NULL;
+  }
+
   *Instance = TlsInstance;
 
   return EFI_SUCCESS;
@@ -86,6 +105,8 @@ TlsCleanService (
   )
 {
   if (Service != NULL) {
+    TlsSessionCacheFlush (Service);
+
     if (Service->TlsCtx != NULL) {
       TlsCtxFree (Service->TlsCtx);
     }
@@ -132,6 +153,8 @@ TlsCreateService (
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
   TlsService->ImageHandle = Image;
+  InitializeListHead (&TlsService->SessionCache);
+  TlsService->SessionCacheCount = 0;
 
   *Service = TlsService;
 
@@ -483,6 +506,8 @@ TlsServiceBindingDestroyChild (
   RemoveEntryList (&TlsInstance->Link);
   TlsService->TlsChildrenNum--;
 
+  TlsSessionCacheSave (TlsInstance);
+
   gBS->RestoreTPL (OldTpl);
 
   TlsCleanInstance (TlsInstance);
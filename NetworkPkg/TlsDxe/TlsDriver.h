@@ -26,6 +26,19 @@
 
 #define TLS_INSTANCE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'I')
 
+#define TLS_SESSION_CACHE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'C')
+
+//
+// The maximum number of client sessions kept for resumption.
+//
+#define TLS_SESSION_CACHE_SIZE  8
+
+//
+// The tag of a TLS configuration data type in the session cache key, which
+// keeps it apart from the TLS session data types.
+//
+#define TLS_SESSION_KEY_CONFIG_TAG(DataType)  ((UINT32)(DataType) | BIT31)
+
 ///
 /// TLS Service Data
 ///
@@ -36,6 +49,28 @@ typedef struct _TLS_SERVICE TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// What a session was established with, besides the server host name. A
+/// session is only resumed by a connection with the same key.
+///
+typedef struct {
+  EFI_TLS_VERIFY    VerifyMethod;
+  UINT8             ConfigDigest[SHA256_DIGEST_SIZE];
+} TLS_SESSION_CACHE_KEY;
+
+///
+/// A client session kept for resumption, indexed by the server host name
+/// and the session cache key.
+///
+typedef struct {
+  UINT32                   Signature;
+  LIST_ENTRY               Link;
+  CHAR8                    *HostName;
+  TLS_SESSION_CACHE_KEY    Key;
+  VOID                     *Data;
+  UINTN                    DataSize;
+} TLS_SESSION_CACHE_ENTRY;
+
 struct _TLS_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -55,6 +90,13 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // The sessions of the finished client connections, most recently used
+  // first, to be resumed by later connections to the same host.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheCount;
 };
 
 struct _TLS_INSTANCE {
@@ -76,6 +118,20 @@ struct _TLS_INSTANCE {
   // per established connection.
   //
   VOID                              *TlsConn;
+
+  //
+  // The host name set by EfiTlsVerifyHost and the verify method set by
+  // EfiTlsVerifyMethod. With the SHA-256 of the other configuration that
+  // affects the trust in the peer or the cipher suites, they make up the key
+  // of the session cache. ConfigHashContext is NULL if the session can't be
+  // cached. SessionKey is taken when the handshake starts.
+  //
+  CHAR8                             *HostName;
+  EFI_TLS_VERIFY                    VerifyMethod;
+  VOID                              *ConfigHashContext;
+  TLS_SESSION_CACHE_KEY             SessionKey;
+  BOOLEAN                           SessionKeyValid;
+  BOOLEAN                           SessionResumeTried;
 };
 
 #define TLS_SERVICE_FROM_THIS(a)   \
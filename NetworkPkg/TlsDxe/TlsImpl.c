@@ -37,6 +37,7 @@ TlsEncryptPacket (
   UINT32             BytesCopied;
   UINT32             BufferInSize;
   UINT8              *BufferIn;
+  UINT8              *BufferInPool;
   UINT8              *BufferInPtr;
   TLS_RECORD_HEADER  *RecordHeaderIn;
   UINT16             ThisPlainMessageSize;
@@ -51,6 +52,7 @@ TlsEncryptPacket (
   BytesCopied      = 0;
   BufferInSize     = 0;
   BufferIn         = NULL;
+  BufferInPool     = NULL;
   BufferInPtr      = NULL;
   RecordHeaderIn   = NULL;
   TempRecordHeader = NULL;
@@ -66,25 +68,33 @@ TlsEncryptPacket (
     BufferInSize += (*FragmentTable)[Index].FragmentLength;
   }
 
-  //
-  // Allocate buffer for processing data.
-  //
-  BufferIn = AllocateZeroPool (BufferInSize);
-  if (BufferIn == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR;
-  }
+  if (*FragmentCount == 1) {
+    //
+    // The records of a single fragment are processed in place.
+    //
+    BufferIn = (*FragmentTable)[0].FragmentBuffer;
+  } else {
+    //
+    // Allocate buffer for processing data.
+    //
+    BufferInPool = AllocatePool (BufferInSize);
+    if (BufferInPool == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ERROR;
+    }
 
-  //
-  // Copy all TLS plain record header and payload into BufferIn.
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    CopyMem (
-      (BufferIn + BytesCopied),
-      (*FragmentTable)[Index].FragmentBuffer,
-      (*FragmentTable)[Index].FragmentLength
-      );
-    BytesCopied += (*FragmentTable)[Index].FragmentLength;
+    //
+    // Copy all TLS plain record header and payload into BufferIn.
+    //
+    BufferIn = BufferInPool;
+    for (Index = 0; Index < *FragmentCount; Index++) {
+      CopyMem (
+        (BufferIn + BytesCopied),
+        (*FragmentTable)[Index].FragmentBuffer,
+        (*FragmentTable)[Index].FragmentLength
+        );
+      BytesCopied += (*FragmentTable)[Index].FragmentLength;
+    }
   }
 
   //
@@ -105,7 +115,7 @@ TlsEncryptPacket (
   //
   // Allocate enough buffer to hold TLS Ciphertext.
   //
-  BufferOut = AllocateZeroPool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH));
+  BufferOut = AllocatePool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH));
   if (BufferOut == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
@@ -142,8 +152,10 @@ TlsEncryptPacket (
     TempRecordHeader = (TLS_RECORD_HEADER *)((UINT8 *)TempRecordHeader + ThisMessageSize);
   }
 
-  FreePool (BufferIn);
-  BufferIn = NULL;
+  if (BufferInPool != NULL) {
+    FreePool (BufferInPool);
+    BufferInPool = NULL;
+  }
 
   //
   // The caller will be responsible to handle the original fragment table.
@@ -162,9 +174,9 @@ TlsEncryptPacket (
 
 ERROR:
 
-  if (BufferIn != NULL) {
-    FreePool (BufferIn);
-    BufferIn = NULL;
+  if (BufferInPool != NULL) {
+    FreePool (BufferInPool);
+    BufferInPool = NULL;
   }
 
   if (BufferOut != NULL) {
@@ -202,6 +214,7 @@ TlsDecryptPacket (
   UINTN              Index;
   UINT32             BytesCopied;
   UINT8              *BufferIn;
+  UINT8              *BufferInPool;
   UINT32             BufferInSize;
   UINT8              *BufferInPtr;
   TLS_RECORD_HEADER  *RecordHeaderIn;
@@ -216,6 +229,7 @@ TlsDecryptPacket (
   Status           = EFI_SUCCESS;
   BytesCopied      = 0;
   BufferIn         = NULL;
+  BufferInPool     = NULL;
   BufferInSize     = 0;
   BufferInPtr      = NULL;
   RecordHeaderIn   = NULL;
@@ -232,25 +246,33 @@ TlsDecryptPacket (
     BufferInSize += (*FragmentTable)[Index].FragmentLength;
   }
 
-  //
-  // Allocate buffer for processing data
-  //
-  BufferIn = AllocateZeroPool (BufferInSize);
-  if (BufferIn == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ERROR;
-  }
+  if (*FragmentCount == 1) {
+    //
+    // The records of a single fragment are processed in place.
+    //
+    BufferIn = (*FragmentTable)[0].FragmentBuffer;
+  } else {
+    //
+    // Allocate buffer for processing data
+    //
+    BufferInPool = AllocatePool (BufferInSize);
+    if (BufferInPool == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto ERROR;
+    }
 
-  //
-  // Copy all TLS plain record header and payload to BufferIn
-  //
-  for (Index = 0; Index < *FragmentCount; Index++) {
-    CopyMem (
-      (BufferIn + BytesCopied),
-      (*FragmentTable)[Index].FragmentBuffer,
-      (*FragmentTable)[Index].FragmentLength
-      );
-    BytesCopied += (*FragmentTable)[Index].FragmentLength;
+    //
+    // Copy all TLS plain record header and payload to BufferIn
+    //
+    BufferIn = BufferInPool;
+    for (Index = 0; Index < *FragmentCount; Index++) {
+      CopyMem (
+        (BufferIn + BytesCopied),
+        (*FragmentTable)[Index].FragmentBuffer,
+        (*FragmentTable)[Index].FragmentLength
+        );
+      BytesCopied += (*FragmentTable)[Index].FragmentLength;
+    }
   }
 
   //
@@ -265,13 +287,23 @@ TlsDecryptPacket (
     }
 
     BufferInPtr += TLS_RECORD_HEADER_LENGTH + NTOHS (RecordHeaderIn->Length);
+    if ((UINTN)BufferInPtr > (UINTN)BufferIn + BufferInSize) {
+      //
+      // The last record is truncated, it doesn't fit in the output buffer.
+      //
+      Status = EFI_INVALID_PARAMETER;
+      goto ERROR;
+    }
+
     RecordCount++;
   }
 
   //
-  // Allocate enough buffer to hold TLS Plaintext.
+  // Allocate enough buffer to hold TLS Plaintext. The plain text of a record
+  // is never longer than its cipher text, so the records fit in the size
+  // of the input.
   //
-  BufferOut = AllocateZeroPool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH));
+  BufferOut = AllocatePool (MAX (BufferInSize, 1));
   if (BufferOut == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto ERROR;
@@ -295,7 +327,11 @@ TlsDecryptPacket (
     }
 
     Ret = 0;
-    Ret = TlsRead (TlsInstance->TlsConn, (UINT8 *)(TempRecordHeader + 1), TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH);
+    Ret = TlsRead (
+            TlsInstance->TlsConn,
+            (UINT8 *)(TempRecordHeader + 1),
+            MIN (TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH, BufferInSize - BufferOutSize - TLS_RECORD_HEADER_LENGTH)
+            );
 
     if (Ret > 0) {
       ThisPlainMessageSize = (UINT16)Ret;
@@ -316,8 +352,10 @@ TlsDecryptPacket (
     TempRecordHeader = (TLS_RECORD_HEADER *)((UINT8 *)TempRecordHeader + TLS_RECORD_HEADER_LENGTH + ThisPlainMessageSize);
   }
 
-  FreePool (BufferIn);
-  BufferIn = NULL;
+  if (BufferInPool != NULL) {
+    FreePool (BufferInPool);
+    BufferInPool = NULL;
+  }
 
   //
   // The caller will be responsible to handle the original fragment table
@@ -336,9 +374,9 @@ TlsDecryptPacket (
 
 ERROR:
 
-  if (BufferIn != NULL) {
-    FreePool (BufferIn);
-    BufferIn = NULL;
+  if (BufferInPool != NULL) {
+    FreePool (BufferInPool);
+    BufferInPool = NULL;
   }
 
   if (BufferOut != NULL) {
@@ -348,3 +386,306 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Remove an entry from the session cache and release it. The session
+  data holds the master secret, so it is cleared before it's freed.
+
+  @param[in]  Service             The TLS service data.
+  @param[in]  Entry               The session cache entry.
+
+**/
+VOID
+TlsSessionCacheRemove (
+  IN TLS_SERVICE              *Service,
+  IN TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  ASSERT (Entry->Signature == TLS_SESSION_CACHE_SIGNATURE);
+
+  RemoveEntryList (&Entry->Link);
+  Service->SessionCacheCount--;
+
+  ZeroMem (Entry->Data, Entry->DataSize);
+  FreePool (Entry->Data);
+  FreePool (Entry->HostName);
+  FreePool (Entry);
+}
+
+/**
+  Find the session cache entry of a host.
+
+  @param[in]  Service             The TLS service data.
+  @param[in]  HostName            The host name.
+  @param[in]  Key                 The session cache key.
+
+  @return The session cache entry, or NULL if the host has no cached session
+          with exactly that key.
+
+**/
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheFind (
+  IN TLS_SERVICE            *Service,
+  IN CHAR8                  *HostName,
+  IN TLS_SESSION_CACHE_KEY  *Key
+  )
+{
+  LIST_ENTRY               *Link;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Link, &Service->SessionCache) {
+    Entry = NET_LIST_USER_STRUCT_S (Link, TLS_SESSION_CACHE_ENTRY, Link, TLS_SESSION_CACHE_SIGNATURE);
+    if ((AsciiStrCmp (Entry->HostName, HostName) == 0) &&
+        (CompareMem (&Entry->Key, Key, sizeof (TLS_SESSION_CACHE_KEY)) == 0))
+    {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add a configuration item of the TLS instance to the digest in its session
+  cache key. The item is digested with its tag and size, so that the digest
+  changes with every configuration that is set.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+  @param[in]  Tag                 The data type of the item.
+  @param[in]  Data                The item.
+  @param[in]  DataSize            The size of the item in bytes.
+
+**/
+VOID
+TlsSessionCacheKeyUpdate (
+  IN TLS_INSTANCE  *TlsInstance,
+  IN UINT32        Tag,
+  IN CONST VOID    *Data,
+  IN UINTN         DataSize
+  )
+{
+  UINT64  Size;
+
+  if (TlsInstance->ConfigHashContext == NULL) {
+    return;
+  }
+
+  Size = DataSize;
+  if (!Sha256Update (TlsInstance->ConfigHashContext, &Tag, sizeof (Tag)) ||
+      !Sha256Update (TlsInstance->ConfigHashContext, &Size, sizeof (Size)) ||
+      !Sha256Update (TlsInstance->ConfigHashContext, Data, DataSize))
+  {
+    //
+    // The key would no longer cover the whole configuration.
+    //
+    FreePool (TlsInstance->ConfigHashContext);
+    TlsInstance->ConfigHashContext = NULL;
+  }
+}
+
+/**
+  Take the session cache key of a client connection whose handshake starts.
+
+  @param[in, out]  TlsInstance    The pointer to the TLS instance.
+
+  @retval TRUE                    The key is in TlsInstance->SessionKey.
+  @retval FALSE                   The session of the connection can't be cached.
+
+**/
+BOOLEAN
+TlsSessionCacheGetKey (
+  IN OUT TLS_INSTANCE  *TlsInstance
+  )
+{
+  VOID     *HashContext;
+  BOOLEAN  Result;
+
+  if (TlsInstance->ConfigHashContext == NULL) {
+    return FALSE;
+  }
+
+  //
+  // Finalize a copy, the configuration digest of the instance stays open.
+  //
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return FALSE;
+  }
+
+  ZeroMem (&TlsInstance->SessionKey, sizeof (TlsInstance->SessionKey));
+  TlsInstance->SessionKey.VerifyMethod = TlsInstance->VerifyMethod;
+
+  Result = (BOOLEAN)(Sha256Duplicate (TlsInstance->ConfigHashContext, HashContext) &&
+                     Sha256Final (HashContext, TlsInstance->SessionKey.ConfigDigest));
+
+  FreePool (HashContext);
+  return Result;
+}
+
+/**
+  Save the session of a finished client connection in the session cache,
+  so that a later connection to the same host can resume it.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  EFI_STATUS               Status;
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  TLS_SESSION_CACHE_ENTRY  *OldEntry;
+  VOID                     *Data;
+  UINTN                    DataSize;
+
+  //
+  // Only the sessions of the client connections which have verified the
+  // server certificate and host name and finished the handshake are cached.
+  // A session established without the verification must never be resumed
+  // by a connection that requires it.
+  //
+  if ((TlsInstance->HostName == NULL) || (TlsInstance->TlsConn == NULL) ||
+      !TlsInstance->SessionKeyValid ||
+      ((TlsInstance->SessionKey.VerifyMethod & EFI_TLS_VERIFY_PEER) == 0) ||
+      ((TlsInstance->TlsSessionState != EfiTlsSessionDataTransferring) &&
+       (TlsInstance->TlsSessionState != EfiTlsSessionClosing)) ||
+      (TlsGetConnectionEnd (TlsInstance->TlsConn) != EfiTlsClient))
+  {
+    return;
+  }
+
+  DataSize = 0;
+  Status   = TlsGetSession (TlsInstance->TlsConn, NULL, &DataSize);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return;
+  }
+
+  Data = AllocatePool (DataSize);
+  if (Data == NULL) {
+    return;
+  }
+
+  Status = TlsGetSession (TlsInstance->TlsConn, Data, &DataSize);
+  if (EFI_ERROR (Status)) {
+    ZeroMem (Data, DataSize);
+    FreePool (Data);
+    return;
+  }
+
+  Entry = AllocateZeroPool (sizeof (TLS_SESSION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    ZeroMem (Data, DataSize);
+    FreePool (Data);
+    return;
+  }
+
+  Entry->HostName = AllocateCopyPool (AsciiStrSize (TlsInstance->HostName), TlsInstance->HostName);
+  if (Entry->HostName == NULL) {
+    FreePool (Entry);
+    ZeroMem (Data, DataSize);
+    FreePool (Data);
+    return;
+  }
+
+  Entry->Signature = TLS_SESSION_CACHE_SIGNATURE;
+  Entry->Data      = Data;
+  Entry->DataSize  = DataSize;
+  CopyMem (&Entry->Key, &TlsInstance->SessionKey, sizeof (Entry->Key));
+
+  //
+  // Replace the older session of the host and key, and evict the least
+  // recently used session when the cache is full.
+  //
+  Service  = TlsInstance->Service;
+  OldEntry = TlsSessionCacheFind (Service, Entry->HostName, &Entry->Key);
+  if (OldEntry != NULL) {
+    TlsSessionCacheRemove (Service, OldEntry);
+  } else if (Service->SessionCacheCount >= TLS_SESSION_CACHE_SIZE) {
+    TlsSessionCacheRemove (
+      Service,
+      NET_LIST_USER_STRUCT_S (Service->SessionCache.BackLink, TLS_SESSION_CACHE_ENTRY, Link, TLS_SESSION_CACHE_SIGNATURE)
+      );
+  }
+
+  InsertHeadList (&Service->SessionCache, &Entry->Link);
+  Service->SessionCacheCount++;
+}
+
+/**
+  Set the cached session of the host for resumption before the
+  ClientHello of a client connection is built.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *TlsInstance
+  )
+{
+  EFI_STATUS               Status;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  //
+  // The session can only be set once, before the handshake starts. The
+  // ClientHello may be built more than once if the caller's buffer is
+  // too small.
+  //
+  if (TlsInstance->SessionResumeTried || (TlsInstance->HostName == NULL)) {
+    return;
+  }
+
+  TlsInstance->SessionResumeTried = TRUE;
+
+  if (TlsGetConnectionEnd (TlsInstance->TlsConn) != EfiTlsClient) {
+    return;
+  }
+
+  //
+  // The configuration is complete now, the key is what the session is
+  // established with.
+  //
+  TlsInstance->SessionKeyValid = TlsSessionCacheGetKey (TlsInstance);
+  if (!TlsInstance->SessionKeyValid) {
+    return;
+  }
+
+  Entry = TlsSessionCacheFind (TlsInstance->Service, TlsInstance->HostName, &TlsInstance->SessionKey);
+  if (Entry == NULL) {
+    return;
+  }
+
+  Status = TlsSetSession (TlsInstance->TlsConn, Entry->Data, Entry->DataSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "TlsSessionCacheResume: Can't resume the session of %a - %r\n", Entry->HostName, Status));
+  }
+
+  //
+  // A session is offered at most once, as TLS 1.3 (RFC8446 appendix C.4)
+  // recommends for the tickets. The session of this connection replaces
+  // it when the connection is finished.
+  //
+  TlsSessionCacheRemove (TlsInstance->Service, Entry);
+}
+
+/**
+  Release all the sessions in the session cache.
+
+  @param[in]  Service             The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  )
+{
+  while (!IsListEmpty (&Service->SessionCache)) {
+    TlsSessionCacheRemove (
+      Service,
+      NET_LIST_USER_STRUCT_S (Service->SessionCache.ForwardLink, TLS_SESSION_CACHE_ENTRY, Link, TLS_SESSION_CACHE_SIGNATURE)
+      );
+  }
+}
@@ -86,6 +86,60 @@ TlsDecryptPacket (
   IN     UINT32                 *FragmentCount
   );
 
+/**
+  Add a configuration item of the TLS instance to the digest in its session
+  cache key. The item is digested with its tag and size, so that the digest
+  changes with every configuration that is set.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+  @param[in]  Tag                 The data type of the item.
+  @param[in]  Data                The item.
+  @param[in]  DataSize            The size of the item in bytes.
+
+**/
+VOID
+TlsSessionCacheKeyUpdate (
+  IN TLS_INSTANCE  *TlsInstance,
+  IN UINT32        Tag,
+  IN CONST VOID    *Data,
+  IN UINTN         DataSize
+  );
+
+/**
+  Save the session of a finished client connection in the session cache,
+  so that a later connection to the same host can resume it.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Set the cached session of the host for resumption before the
+  ClientHello of a client connection is built.
+
+  @param[in]  TlsInstance         The pointer to the TLS instance.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *TlsInstance
+  );
+
+/**
+  Release all the sessions in the session cache.
+
+  @param[in]  Service             The TLS service data.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  );
+
 /**
   Set TLS session data.
 
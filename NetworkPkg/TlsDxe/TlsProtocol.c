@@ -91,6 +91,10 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVersion (Instance->TlsConn, ((EFI_TLS_VERSION *)Data)->Major, ((EFI_TLS_VERSION *)Data)->Minor);
+      if (!EFI_ERROR (Status)) {
+        TlsSessionCacheKeyUpdate (Instance, EfiTlsVersion, Data, DataSize);
+      }
+
       break;
     case EfiTlsConnectionEnd:
       if (DataSize != sizeof (EFI_TLS_CONNECTION_END)) {
@@ -120,6 +124,9 @@ TlsSetSessionData (
       }
 
       Status = TlsSetCipherList (Instance->TlsConn, CipherId, CipherCount);
+      if (!EFI_ERROR (Status)) {
+        TlsSessionCacheKeyUpdate (Instance, EfiTlsCipherList, Data, DataSize);
+      }
 
       FreePool (CipherId);
       break;
@@ -152,6 +159,7 @@ TlsSetSessionData (
       }
 
       TlsSetVerify (Instance->TlsConn, *((UINT32 *)Data));
+      Instance->VerifyMethod = *((EFI_TLS_VERIFY *)Data);
       break;
     case EfiTlsVerifyHost:
       if (DataSize != sizeof (EFI_TLS_VERIFY_HOST)) {
@@ -187,7 +195,24 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
 
+      //
+      // The verified host name is the key to resume the session.
+      //
+      if (Instance->HostName != NULL) {
+        FreePool (Instance->HostName);
+      }
+
+      Instance->HostName = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      if (Instance->HostName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto ON_EXIT;
+      }
+
+      TlsSessionCacheKeyUpdate (Instance, EfiTlsVerifyHost, &TlsVerifyHost->Flags, sizeof (TlsVerifyHost->Flags));
       break;
     case EfiTlsSessionID:
       if (DataSize != sizeof (EFI_TLS_SESSION_ID)) {
@@ -484,6 +509,11 @@ TlsBuildResponsePacket (
   if ((RequestBuffer == NULL) && (RequestSize == 0)) {
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
+        //
+        // Offer the cached session of the host in the ClientHello.
+        //
+        TlsSessionCacheResume (Instance);
+
         //
         // ClientHello.
         //
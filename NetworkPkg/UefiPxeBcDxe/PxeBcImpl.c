@@ -225,6 +225,15 @@ EfiPxeBcStart (
     Private->BlockSize = (UINTN)PcdGet64 (PcdTftpBlockSize);
   }
 
+  //
+  // Start with the TFTP window size of PcdPxeTftpWindowSize, it's adapted
+  // to the server and the path by the downloads.
+  // The ceiling is the largest window size that may be probed, it drops below
+  // every window size that timed out.
+  //
+  Private->TftpWindowSize    = (UINTN)PcdGet64 (PcdPxeTftpWindowSize);
+  Private->TftpWindowCeiling = PXEBC_MTFTP_MAX_WINDOWSIZE;
+
   //
   // Create event for UdpRead/UdpWrite timeout since they are both blocking API.
   //
@@ -852,6 +861,7 @@ EfiPxeBcMtftp (
   EFI_STATUS                   Status;
   EFI_PXE_BASE_CODE_IP_FILTER  IpFilter;
   UINTN                        WindowSize;
+  UINT64                       RequestSize;
 
   if ((This == NULL) ||
       (Filename == NULL) ||
@@ -878,9 +888,17 @@ EfiPxeBcMtftp (
   Mode    = Private->PxeBc.Mode;
 
   //
-  // Get PcdPxeTftpWindowSize.
+  // Use the window size learned from the previous downloads.
   //
-  WindowSize = (UINTN)PcdGet64 (PcdPxeTftpWindowSize);
+  WindowSize = Private->TftpWindowSize;
+
+  //
+  // Negotiate the block size derived from the MTU if the caller doesn't
+  // request one, the default of 512 bytes takes many more round trips.
+  //
+  if ((BlockSize == NULL) && (Operation != EFI_PXE_BASE_CODE_TFTP_WRITE_FILE)) {
+    BlockSize = &Private->BlockSize;
+  }
 
   if (Mode->UsingIpv6) {
     if (!NetIp6IsValidUnicast (&ServerIp->v6)) {
@@ -948,16 +966,46 @@ EfiPxeBcMtftp (
       //
       // Send TFTP request to read file.
       //
-      Status = PxeBcTftpReadFile (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferPtr,
-                 BufferSize,
-                 DontUseBuffer
-                 );
+      RequestSize = *BufferSize;
+      Status      = PxeBcTftpReadFile (
+                      Private,
+                      Config,
+                      Filename,
+                      BlockSize,
+                      (WindowSize > 1) ? &WindowSize : NULL,
+                      BufferPtr,
+                      BufferSize,
+                      DontUseBuffer
+                      );
+
+      if ((Status == EFI_TIMEOUT) && (WindowSize > 1)) {
+        //
+        // The server or the path drops the bursts of this window size.
+        // Never probe it again, halve the window and try once more.
+        //
+        Private->TftpWindowCeiling = MIN (Private->TftpWindowCeiling, WindowSize - 1);
+        WindowSize                 = WindowSize / 2;
+        Private->TftpWindowSize    = WindowSize;
+        *BufferSize                = RequestSize;
+        Status                     = PxeBcTftpReadFile (
+                                       Private,
+                                       Config,
+                                       Filename,
+                                       BlockSize,
+                                       (WindowSize > 1) ? &WindowSize : NULL,
+                                       BufferPtr,
+                                       BufferSize,
+                                       DontUseBuffer
+                                       );
+      }
+
+      if (!EFI_ERROR (Status) && (WindowSize > 1) && (WindowSize < Private->TftpWindowCeiling)) {
+        //
+        // The window was received without a timeout, probe a larger one
+        // with the next download, but stay below the sizes that timed out.
+        //
+        Private->TftpWindowSize = MIN (WindowSize * 2, Private->TftpWindowCeiling);
+      }
 
       break;
 
@@ -67,6 +67,7 @@ typedef struct _PXEBC_VIRTUAL_NIC       PXEBC_VIRTUAL_NIC;
 #define PXEBC_DAD_ADDITIONAL_DELAY  30000000   // 3 seconds
 #define PXEBC_MTFTP_TIMEOUT         4
 #define PXEBC_MTFTP_RETRIES         6
+#define PXEBC_MTFTP_MAX_WINDOWSIZE  64
 #define PXEBC_DHCP_RETRIES          4          // refers to mPxeDhcpTimeout, also by PXE2.1 spec.
 #define PXEBC_MENU_MAX_NUM          24
 #define PXEBC_OFFER_MAX_NUM         16
@@ -180,6 +181,8 @@ struct _PXEBC_PRIVATE_DATA {
   UINT8                                        *BootFileName;
   UINTN                                        BootFileSize;
   UINTN                                        BlockSize;
+  UINTN                                        TftpWindowSize;
+  UINTN                                        TftpWindowCeiling;
 
   PXEBC_DHCP_PACKET_CACHE                      ProxyOffer;
   PXEBC_DHCP_PACKET_CACHE                      DhcpAck;
@@ -207,6 +207,9 @@ VirtioNetSnpPopulate (
   Dev->Snp.Receive        = &VirtioNetReceive;
   Dev->Snp.Mode           = &Dev->Snm;
 
+  Dev->SnpBatch.Transmit  = &VirtioNetTransmitBatch;
+  Dev->SnpBatch.GetStatus = &VirtioNetGetStatusBatch;
+
   Dev->Snm.State           = EfiSimpleNetworkStopped;
   Dev->Snm.HwAddressSize   = SIZE_OF_VNET (Mac);
   Dev->Snm.MediaHeaderSize = SIZE_OF_VNET (Mac) +       // dst MAC
@@ -531,6 +534,8 @@ VirtioNetDriverBindingStart (
                   &Dev->MacHandle,
                   &gEfiSimpleNetworkProtocolGuid,
                   &Dev->Snp,
+                  &gEdkiiSimpleNetworkBatchProtocolGuid,
+                  &Dev->SnpBatch,
                   &gEfiDevicePathProtocolGuid,
                   Dev->MacDevicePath,
                   NULL
@@ -562,6 +567,8 @@ UninstallMultiple:
          Dev->MacHandle,
          &gEfiDevicePathProtocolGuid,
          Dev->MacDevicePath,
+         &gEdkiiSimpleNetworkBatchProtocolGuid,
+         &Dev->SnpBatch,
          &gEfiSimpleNetworkProtocolGuid,
          &Dev->Snp,
          NULL
@@ -675,6 +682,8 @@ VirtioNetDriverBindingStop (
              Dev->MacHandle,
              &gEfiDevicePathProtocolGuid,
              Dev->MacDevicePath,
+             &gEdkiiSimpleNetworkBatchProtocolGuid,
+             &Dev->SnpBatch,
              &gEfiSimpleNetworkProtocolGuid,
              &Dev->Snp,
              NULL
@@ -16,56 +16,43 @@
 #include "VirtioNet.h"
 
 /**
-  Reads the current interrupt status and recycled transmit buffer status from
-  a network interface.
+  Reads the current interrupt status and recycles transmit buffers, the
+  common part of VirtioNetGetStatus() and VirtioNetGetStatusBatch().
 
-  @param  This            The protocol instance pointer.
-  @param  InterruptStatus A pointer to the bit mask of the currently active
-                          interrupts If this is NULL, the interrupt status will
-                          not be read from the device. If this is not NULL, the
-                          interrupt status will be read from the device. When
-                          the  interrupt status is read, it will also be
-                          cleared. Clearing the transmit  interrupt does not
-                          empty the recycled transmit buffer array.
-  @param  TxBuf           Recycled transmit buffer address. The network
-                          interface will not transmit if its internal recycled
-                          transmit buffer array is full. Reading the transmit
-                          buffer does not clear the transmit interrupt. If this
-                          is NULL, then the transmit buffer status will not be
-                          read. If there are no transmit buffers to recycle and
-                          TxBuf is not NULL, * TxBuf will be set to NULL.
+  @param[in]      Dev              The VNET_DEV of the network interface.
+  @param[out]     InterruptStatus  See VirtioNetGetStatus().
+  @param[in, out] TxBufCount       On input, the number of entries in TxBuf,
+                                   0 if the transmit buffer status is not to
+                                   be read. On output, the number of recycled
+                                   transmit buffers returned.
+  @param[out]     TxBuf            The recycled transmit buffer addresses.
 
   @retval EFI_SUCCESS           The status of the network interface was
                                 retrieved.
   @retval EFI_NOT_STARTED       The network interface has not been started.
-  @retval EFI_INVALID_PARAMETER One or more of the parameters has an
-                                unsupported value.
   @retval EFI_DEVICE_ERROR      The command could not be sent to the network
                                 interface.
-  @retval EFI_UNSUPPORTED       This function is not supported by the network
-                                interface.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-VirtioNetGetStatus (
-  IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
-  OUT UINT32                      *InterruptStatus OPTIONAL,
-  OUT VOID                        **TxBuf OPTIONAL
+VirtioNetGetStatusCommon (
+  IN     VNET_DEV  *Dev,
+  OUT    UINT32    *InterruptStatus OPTIONAL,
+  IN OUT UINTN     *TxBufCount,
+  OUT    VOID      **TxBuf OPTIONAL
   )
 {
-  VNET_DEV              *Dev;
   EFI_TPL               OldTpl;
   EFI_STATUS            Status;
   UINT16                RxCurUsed;
   UINT16                TxCurUsed;
+  UINTN                 TxBufMax;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
 
-  if (This == NULL) {
-    return EFI_INVALID_PARAMETER;
-  }
+  TxBufMax    = *TxBufCount;
+  *TxBufCount = 0;
 
-  Dev    = VIRTIO_NET_FROM_SNP (This);
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
   switch (Dev->Snm.State) {
     case EfiSimpleNetworkStopped:
@@ -117,54 +104,52 @@ VirtioNetGetStatus (
     }
   }
 
-  if (TxBuf != NULL) {
-    if (Dev->TxLastUsed == TxCurUsed) {
-      *TxBuf = NULL;
-    } else {
-      UINT16  UsedElemIdx;
-      UINT32  DescIdx;
+  while ((*TxBufCount < TxBufMax) && (Dev->TxLastUsed != TxCurUsed)) {
+    UINT16  UsedElemIdx;
+    UINT32  DescIdx;
 
-      //
-      // fetch the first descriptor among those that the hypervisor reports
-      // completed
-      //
-      ASSERT (Dev->TxCurPending > 0);
-      ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
+    //
+    // fetch the first descriptor among those that the hypervisor reports
+    // completed
+    //
+    ASSERT (Dev->TxCurPending > 0);
+    ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
 
-      UsedElemIdx = Dev->TxLastUsed++ % Dev->TxRing.QueueSize;
-      DescIdx     = Dev->TxRing.Used.UsedElem[UsedElemIdx].Id;
-      ASSERT (DescIdx < (UINT32)(2 * Dev->TxMaxPending - 1));
+    UsedElemIdx = Dev->TxLastUsed++ % Dev->TxRing.QueueSize;
+    DescIdx     = Dev->TxRing.Used.UsedElem[UsedElemIdx].Id;
+    ASSERT (DescIdx < (UINT32)(2 * Dev->TxMaxPending - 1));
 
-      //
-      // get the device address that has been enqueued for the caller's
-      // transmit buffer
-      //
-      DeviceAddress = Dev->TxRing.Desc[DescIdx + 1].Addr;
+    //
+    // get the device address that has been enqueued for the caller's
+    // transmit buffer
+    //
+    DeviceAddress = Dev->TxRing.Desc[DescIdx + 1].Addr;
 
-      //
-      // now this descriptor can be used again to enqueue a transmit buffer
-      //
-      Dev->TxFreeStack[--Dev->TxCurPending] = (UINT16)DescIdx;
+    //
+    // now this descriptor can be used again to enqueue a transmit buffer
+    //
+    Dev->TxFreeStack[--Dev->TxCurPending] = (UINT16)DescIdx;
 
+    //
+    // Unmap the device address and perform the reverse mapping to find the
+    // caller buffer address.
+    //
+    Status = VirtioNetUnmapTxBuf (
+               Dev,
+               &TxBuf[*TxBufCount],
+               DeviceAddress
+               );
+    if (EFI_ERROR (Status)) {
       //
-      // Unmap the device address and perform the reverse mapping to find the
-      // caller buffer address.
+      // VirtioNetUnmapTxBuf should never fail, if we have reached here
+      // that means our internal state has been corrupted
       //
-      Status = VirtioNetUnmapTxBuf (
-                 Dev,
-                 TxBuf,
-                 DeviceAddress
-                 );
-      if (EFI_ERROR (Status)) {
-        //
-        // VirtioNetUnmapTxBuf should never fail, if we have reached here
-        // that means our internal state has been corrupted
-        //
-        ASSERT (FALSE);
-        Status = EFI_DEVICE_ERROR;
-        goto Exit;
-      }
+      ASSERT (FALSE);
+      Status = EFI_DEVICE_ERROR;
+      goto Exit;
     }
+
+    (*TxBufCount)++;
   }
 
   Status = EFI_SUCCESS;
@@ -173,3 +158,106 @@ Exit:
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
+
+/**
+  Reads the current interrupt status and recycled transmit buffer status from
+  a network interface.
+
+  @param  This            The protocol instance pointer.
+  @param  InterruptStatus A pointer to the bit mask of the currently active
+                          interrupts If this is NULL, the interrupt status will
+                          not be read from the device. If this is not NULL, the
+                          interrupt status will be read from the device. When
+                          the  interrupt status is read, it will also be
+                          cleared. Clearing the transmit  interrupt does not
+                          empty the recycled transmit buffer array.
+  @param  TxBuf           Recycled transmit buffer address. The network
+                          interface will not transmit if its internal recycled
+                          transmit buffer array is full. Reading the transmit
+                          buffer does not clear the transmit interrupt. If this
+                          is NULL, then the transmit buffer status will not be
+                          read. If there are no transmit buffers to recycle and
+                          TxBuf is not NULL, * TxBuf will be set to NULL.
+
+  @retval EFI_SUCCESS           The status of the network interface was
+                                retrieved.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an
+                                unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network
+                                interface.
+  @retval EFI_UNSUPPORTED       This function is not supported by the network
+                                interface.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetGetStatus (
+  IN EFI_SIMPLE_NETWORK_PROTOCOL  *This,
+  OUT UINT32                      *InterruptStatus OPTIONAL,
+  OUT VOID                        **TxBuf OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       TxBufCount;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  TxBufCount = (TxBuf != NULL) ? 1 : 0;
+  Status     = VirtioNetGetStatusCommon (
+                 VIRTIO_NET_FROM_SNP (This),
+                 InterruptStatus,
+                 &TxBufCount,
+                 TxBuf
+                 );
+  if (!EFI_ERROR (Status) && (TxBuf != NULL) && (TxBufCount == 0)) {
+    *TxBuf = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Reads the current interrupt status and several recycled transmit buffers
+  from a network interface.
+
+  @param[in]      This             The protocol instance pointer.
+  @param[out]     InterruptStatus  See VirtioNetGetStatus().
+  @param[in, out] TxBufCount       On input, the number of entries in TxBuf.
+                                   On output, the number of recycled transmit
+                                   buffers returned.
+  @param[out]     TxBuf            The recycled transmit buffer addresses.
+
+  @retval EFI_SUCCESS           The status of the network interface was
+                                retrieved.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an
+                                unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network
+                                interface.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetGetStatusBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  OUT    UINT32                               *InterruptStatus OPTIONAL,
+  IN OUT UINTN                                *TxBufCount,
+  OUT    VOID                                 **TxBuf
+  )
+{
+  if ((This == NULL) || (TxBufCount == NULL) || (*TxBufCount == 0) ||
+      (TxBuf == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return VirtioNetGetStatusCommon (
+           VIRTIO_NET_FROM_SNP_BATCH (This),
+           InterruptStatus,
+           TxBufCount,
+           TxBuf
+           );
+}
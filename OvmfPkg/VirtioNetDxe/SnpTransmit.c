@@ -15,6 +15,153 @@
 
 #include "VirtioNet.h"
 
+/**
+  Places a packet in the transmit ring of the device, without making it
+  available to the device yet.
+
+  The parameters and the return values are the same as those of
+  VirtioNetTransmit(), except for AvailIdx.
+
+  @param[in]      Dev         The VNET_DEV of the network interface.
+  @param[in]      HeaderSize  See VirtioNetTransmit().
+  @param[in]      BufferSize  See VirtioNetTransmit().
+  @param[in]      Buffer      See VirtioNetTransmit().
+  @param[in]      SrcAddr     See VirtioNetTransmit().
+  @param[in]      DestAddr    See VirtioNetTransmit().
+  @param[in]      Protocol    See VirtioNetTransmit().
+  @param[in, out] AvailIdx    The available index to use for the packet, it
+                              is incremented when the packet is placed.
+
+**/
+STATIC
+EFI_STATUS
+VirtioNetQueueTxPacket (
+  IN     VNET_DEV         *Dev,
+  IN     UINTN            HeaderSize,
+  IN     UINTN            BufferSize,
+  IN OUT VOID             *Buffer,
+  IN     EFI_MAC_ADDRESS  *SrcAddr  OPTIONAL,
+  IN     EFI_MAC_ADDRESS  *DestAddr OPTIONAL,
+  IN     UINT16           *Protocol OPTIONAL,
+  IN OUT UINT16           *AvailIdx
+  )
+{
+  EFI_STATUS            Status;
+  UINT16                DescIdx;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+
+  if ((BufferSize == 0) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (BufferSize < Dev->Snm.MediaHeaderSize) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  if (BufferSize > Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // check if we have room for transmission
+  //
+  ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
+  if (Dev->TxCurPending == Dev->TxMaxPending) {
+    return EFI_NOT_READY;
+  }
+
+  //
+  // the caller may want us to fill in the media header:
+  // dst MAC, src MAC, Ethertype
+  //
+  if (HeaderSize != 0) {
+    UINT8  *Ptr;
+
+    if ((HeaderSize != Dev->Snm.MediaHeaderSize) ||
+        (DestAddr == NULL) || (Protocol == NULL))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Ptr = Buffer;
+    ASSERT (SIZE_OF_VNET (Mac) <= sizeof (EFI_MAC_ADDRESS));
+
+    CopyMem (Ptr, DestAddr, SIZE_OF_VNET (Mac));
+    Ptr += SIZE_OF_VNET (Mac);
+
+    CopyMem (
+      Ptr,
+      (SrcAddr == NULL) ? &Dev->Snm.CurrentAddress : SrcAddr,
+      SIZE_OF_VNET (Mac)
+      );
+    Ptr += SIZE_OF_VNET (Mac);
+
+    *Ptr++ = (UINT8)(*Protocol >> 8);
+    *Ptr++ = (UINT8)*Protocol;
+
+    ASSERT ((UINTN)(Ptr - (UINT8 *)Buffer) == Dev->Snm.MediaHeaderSize);
+  }
+
+  //
+  // Map the transmit buffer system physical address to device address.
+  //
+  Status = VirtioNetMapTxBuf (
+             Dev,
+             Buffer,
+             BufferSize,
+             &DeviceAddress
+             );
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  //
+  DescIdx                            = Dev->TxFreeStack[Dev->TxCurPending++];
+  Dev->TxRing.Desc[DescIdx + 1].Addr = DeviceAddress;
+  Dev->TxRing.Desc[DescIdx + 1].Len  = (UINT32)BufferSize;
+
+  Dev->TxRing.Avail.Ring[(*AvailIdx)++ % Dev->TxRing.QueueSize] = DescIdx;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Makes the packets placed in the transmit ring available to the device,
+  and notifies the device.
+
+  @param[in]  Dev       The VNET_DEV of the network interface.
+  @param[in]  AvailIdx  The available index after the last packet placed.
+
+  @retval EFI_SUCCESS       The packets were made available to the device.
+  @retval EFI_DEVICE_ERROR  The device could not be notified.
+
+**/
+STATIC
+EFI_STATUS
+VirtioNetKickTx (
+  IN VNET_DEV  *Dev,
+  IN UINT16    AvailIdx
+  )
+{
+  MemoryFence ();
+  *Dev->TxRing.Avail.Idx = AvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying The Device: the device sets
+  // VRING_USED_F_NO_NOTIFY while it is processing the ring, and it will
+  // find the new buffers without a notification. Skipping the notification
+  // saves a VM exit per packet under load.
+  //
+  MemoryFence ();
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+}
+
 /**
   Places a packet in the transmit queue of a network interface.
 
@@ -66,12 +213,10 @@ VirtioNetTransmit (
   IN UINT16                       *Protocol OPTIONAL
   )
 {
-  VNET_DEV              *Dev;
-  EFI_TPL               OldTpl;
-  EFI_STATUS            Status;
-  UINT16                DescIdx;
-  UINT16                AvailIdx;
-  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  UINT16      AvailIdx;
 
   if ((This == NULL) || (BufferSize == 0) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -90,93 +235,122 @@ VirtioNetTransmit (
       break;
   }
 
-  if (BufferSize < Dev->Snm.MediaHeaderSize) {
-    Status = EFI_BUFFER_TOO_SMALL;
-    goto Exit;
-  }
-
-  if (BufferSize > Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize) {
-    Status = EFI_INVALID_PARAMETER;
-    goto Exit;
-  }
-
   //
-  // check if we have room for transmission
+  // the available index is never written by the host, we can read it back
+  // without a barrier
   //
-  ASSERT (Dev->TxCurPending <= Dev->TxMaxPending);
-  if (Dev->TxCurPending == Dev->TxMaxPending) {
-    Status = EFI_NOT_READY;
+  AvailIdx = *Dev->TxRing.Avail.Idx;
+
+  Status = VirtioNetQueueTxPacket (
+             Dev,
+             HeaderSize,
+             BufferSize,
+             Buffer,
+             SrcAddr,
+             DestAddr,
+             Protocol,
+             &AvailIdx
+             );
+  if (EFI_ERROR (Status)) {
     goto Exit;
   }
 
-  //
-  // the caller may want us to fill in the media header:
-  // dst MAC, src MAC, Ethertype
-  //
-  if (HeaderSize != 0) {
-    UINT8  *Ptr;
+  Status = VirtioNetKickTx (Dev, AvailIdx);
 
-    if ((HeaderSize != Dev->Snm.MediaHeaderSize) ||
-        (DestAddr == NULL) || (Protocol == NULL))
-    {
-      Status = EFI_INVALID_PARAMETER;
-      goto Exit;
-    }
+Exit:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
 
-    Ptr = Buffer;
-    ASSERT (SIZE_OF_VNET (Mac) <= sizeof (EFI_MAC_ADDRESS));
+/**
+  Places packets in the transmit queue of a network interface, and notifies
+  the device once for all of them.
 
-    CopyMem (Ptr, DestAddr, SIZE_OF_VNET (Mac));
-    Ptr += SIZE_OF_VNET (Mac);
+  @param[in]      This         The protocol instance pointer.
+  @param[in, out] PacketCount  On input, the number of packets in Packets. On
+                               output, the number of packets placed on the
+                               transmit queue.
+  @param[in]      Packets      The packets to transmit, see
+                               VirtioNetTransmit() for their fields.
 
-    CopyMem (
-      Ptr,
-      (SrcAddr == NULL) ? &Dev->Snm.CurrentAddress : SrcAddr,
-      SIZE_OF_VNET (Mac)
-      );
-    Ptr += SIZE_OF_VNET (Mac);
+  @retval EFI_SUCCESS           All the packets were placed on the transmit
+                                queue.
+  @retval EFI_NOT_STARTED       The network interface has not been started.
+  @retval EFI_NOT_READY         The transmit queue is full, *PacketCount
+                                packets were placed.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an
+                                unsupported value.
+  @retval Others                The error returned by VirtioNetTransmit() for
+                                the packet at index *PacketCount.
 
-    *Ptr++ = (UINT8)(*Protocol >> 8);
-    *Ptr++ = (UINT8)*Protocol;
+**/
+EFI_STATUS
+EFIAPI
+VirtioNetTransmitBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  IN OUT UINTN                                *PacketCount,
+  IN     EDKII_SIMPLE_NETWORK_TX_PACKET       *Packets
+  )
+{
+  VNET_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+  EFI_STATUS  KickStatus;
+  UINTN       Index;
+  UINT16      AvailIdx;
 
-    ASSERT ((UINTN)(Ptr - (UINT8 *)Buffer) == Dev->Snm.MediaHeaderSize);
+  if ((This == NULL) || (PacketCount == NULL) || (*PacketCount == 0) ||
+      (Packets == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Map the transmit buffer system physical address to device address.
-  //
-  Status = VirtioNetMapTxBuf (
-             Dev,
-             Buffer,
-             BufferSize,
-             &DeviceAddress
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto Exit;
+  Dev    = VIRTIO_NET_FROM_SNP_BATCH (This);
+  Index  = 0;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  switch (Dev->Snm.State) {
+    case EfiSimpleNetworkStopped:
+      Status = EFI_NOT_STARTED;
+      goto Exit;
+    case EfiSimpleNetworkStarted:
+      Status = EFI_DEVICE_ERROR;
+      goto Exit;
+    default:
+      break;
   }
 
-  //
-  // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
-  //
-  DescIdx                            = Dev->TxFreeStack[Dev->TxCurPending++];
-  Dev->TxRing.Desc[DescIdx + 1].Addr = DeviceAddress;
-  Dev->TxRing.Desc[DescIdx + 1].Len  = (UINT32)BufferSize;
+  AvailIdx = *Dev->TxRing.Avail.Idx;
+  Status   = EFI_SUCCESS;
+  while (Index < *PacketCount) {
+    Status = VirtioNetQueueTxPacket (
+               Dev,
+               Packets[Index].HeaderSize,
+               Packets[Index].BufferSize,
+               Packets[Index].Buffer,
+               Packets[Index].SrcAddr,
+               Packets[Index].DestAddr,
+               Packets[Index].Protocol,
+               &AvailIdx
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Index++;
+  }
 
   //
-  // the available index is never written by the host, we can read it back
-  // without a barrier
+  // the packets placed before a failure are transmitted as well
   //
-  AvailIdx                                                   = *Dev->TxRing.Avail.Idx;
-  Dev->TxRing.Avail.Ring[AvailIdx++ % Dev->TxRing.QueueSize] = DescIdx;
-
-  MemoryFence ();
-  *Dev->TxRing.Avail.Idx = AvailIdx;
-
-  MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  if (Index > 0) {
+    KickStatus = VirtioNetKickTx (Dev, AvailIdx);
+    if (!EFI_ERROR (Status)) {
+      Status = KickStatus;
+    }
+  }
 
 Exit:
+  *PacketCount = Index;
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
@@ -20,6 +20,7 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/SimpleNetwork.h>
+#include <Protocol/SimpleNetworkBatch.h>
 #include <Library/OrderedCollectionLib.h>
 
 #define VNET_SIG  SIGNATURE_32 ('V', 'N', 'E', 'T')
@@ -77,6 +78,8 @@ typedef struct {
   EFI_DEVICE_PATH_PROTOCOL       *MacDevicePath; // VirtioNetDriverBindingStart
   EFI_HANDLE                     MacHandle;      // VirtioNetDriverBindingStart
 
+  EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL    SnpBatch; // VirtioNetSnpPopulate
+
   VRING                          RxRing;          // VirtioNetInitRing
   VOID                           *RxRingMap;      // VirtioRingMap and
                                                   // VirtioNetInitRing
@@ -111,6 +114,9 @@ typedef struct {
 #define VIRTIO_NET_FROM_SNP(SnpPointer) \
         CR (SnpPointer, VNET_DEV, Snp, VNET_SIG)
 
+#define VIRTIO_NET_FROM_SNP_BATCH(SnpBatchPointer) \
+        CR (SnpBatchPointer, VNET_DEV, SnpBatch, VNET_SIG)
+
 #define VIRTIO_CFG_WRITE(Dev, Field, Value)  ((Dev)->VirtIo->WriteDevice (  \
                                                 (Dev)->VirtIo,              \
                                                 OFFSET_OF_VNET (Field),     \
@@ -240,6 +246,26 @@ VirtioNetTransmit (
   IN UINT16                       *Protocol OPTIONAL
   );
 
+//
+// member functions implementing the EDKII Simple Network Batch Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioNetGetStatusBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  OUT    UINT32                               *InterruptStatus OPTIONAL,
+  IN OUT UINTN                                *TxBufCount,
+  OUT    VOID                                 **TxBuf
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioNetTransmitBatch (
+  IN     EDKII_SIMPLE_NETWORK_BATCH_PROTOCOL  *This,
+  IN OUT UINTN                                *PacketCount,
+  IN     EDKII_SIMPLE_NETWORK_TX_PACKET       *Packets
+  );
+
 EFI_STATUS
 EFIAPI
 VirtioNetReceive (